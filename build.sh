@@ -38,6 +38,18 @@ function directory_check {
    fi
 }
 
+# Koo: Every LLVM tree compiles its own copy of a codec header against the codec objects
+#      built from protobuf_def; a stale copy lays out FixupRecord differently
+function header_check {
+   if cmp -s $PROTODEF_DIR/$1 $2/include/llvm/Support/$1
+   then
+      echo "Codec Header: $2/include/llvm/Support/$1"
+   else
+      echo "The header differs from $PROTODEF_DIR/$1: $2/include/llvm/Support/$1 (Terminating...)"
+      exit 1
+   fi
+}
+
 echo
 echo =============================================
 echo "A. Checking environment settings..."
@@ -52,6 +64,12 @@ directory_check Binutils $BINUTILS_DIR
 directory_check Gold $NEWGOLD_DIR
 directory_check LLVM $LLVM_DIR
 
+for TREE in llvm-3.9.0 llvm-6.0.0 llvm-9.0.0
+do
+   header_check shuffleInfoWriter.h $TOOLCHAIN_ROOT/$TREE
+done
+header_check shuffleInfoReader.h $TOOLCHAIN_ROOT/llvm-9.0.0
+
 # Check the number of CPUs
 NO_CPUS=$(expr `cat /proc/cpuinfo | awk '/^processor/{print $3}' | tail -1` + 1)
 echo "Number of CPUs:" $NO_CPUS
@@ -86,7 +104,7 @@ fi
 
 function compile_protobuf {
    cd $1
-   ./configure
+   ./configure --with-pic
    make -j$2
    sudo make install
    sudo ldconfig
@@ -109,7 +127,7 @@ function compile_binutils {
 
 function compile_gold {
    cd $1
-   ./configure --enable-gold --enable-plugins=yes
+   ./configure --enable-gold --enable-plugins=yes --with-gold-ldadd="$3"
    make -j$2
 } 
 
@@ -131,24 +149,30 @@ SHUFFLEINFO="shuffleInfo.so"
 CC_HDR="shuffleInfo.pb.h"
 PROTO_C="shuffleInfo.pb.cc"
 PROTO_PY="shuffleInfo_pb2.py"
-
-LIB1="/usr/lib"
-LIB2="/usr/local/lib"
+READER_C="shuffleInfoReader.cc"
+WRITER_C="shuffleInfoWriter.cc"
+CODEC_LIB="libshuffleInfo.a"
+CODEC_OBJS="$PROTODEF_DIR/shuffleInfo.pb.o $PROTODEF_DIR/shuffleInfoReader.o $PROTODEF_DIR/shuffleInfoWriter.o"
+PROTOBUF_LITE_LIB="/usr/local/lib/libprotobuf-lite.a"
 
 cd $PROTODEF_DIR
 protoc --proto_path=$PROTODEF_DIR --cpp_out=. $PROTODEF_DIR/$PROTO
 protoc --proto_path=$PROTODEF_DIR --python_out=. $PROTODEF_DIR/$PROTO
-c++ -fPIC -shared $PROTODEF_DIR/$PROTO_C -o $PROTODEF_DIR/$SHUFFLEINFO `pkg-config --cflags --libs protobuf`
+c++ -fPIC -shared $PROTODEF_DIR/$PROTO_C $PROTODEF_DIR/$READER_C $PROTODEF_DIR/$WRITER_C -o $PROTODEF_DIR/$SHUFFLEINFO `pkg-config --cflags --libs protobuf-lite`
+
+# Koo: ccr and ld link the codec statically (libshuffleInfo.a + libprotobuf-lite.a), thus neither
+#      resolves shuffleInfo.so at startup; without the static initializer, the default messages
+#      are only set up by the first object that emits (or reads) a .rand section
+c++ -fPIC -O2 -DGOOGLE_PROTOBUF_NO_STATIC_INITIALIZER -c $PROTODEF_DIR/$PROTO_C -o $PROTODEF_DIR/shuffleInfo.pb.o `pkg-config --cflags protobuf-lite`
+c++ -fPIC -O2 -DGOOGLE_PROTOBUF_NO_STATIC_INITIALIZER -c $PROTODEF_DIR/$READER_C -o $PROTODEF_DIR/shuffleInfoReader.o `pkg-config --cflags protobuf-lite`
+c++ -fPIC -O2 -DGOOGLE_PROTOBUF_NO_STATIC_INITIALIZER -c $PROTODEF_DIR/$WRITER_C -o $PROTODEF_DIR/shuffleInfoWriter.o `pkg-config --cflags protobuf-lite`
+rm -f $PROTODEF_DIR/$CODEC_LIB
+ar rcs $PROTODEF_DIR/$CODEC_LIB $CODEC_OBJS
 
 USER=`whoami`
 chmod 755 $PROTODEF_DIR/$SHUFFLEINFO
 chown $USER:$USER $PROTODEF_DIR/$SHUFFLEINFO $PROTODEF_DIR/$PROTO_C $PROTODEF_DIR/$PROTO_PY
 
-# Deploy the shared object (FIXME: Duplicate files)
-sudo cp $PROTODEF_DIR/$SHUFFLEINFO $LIB1/$SHUFFLEINFO
-sudo cp $PROTODEF_DIR/$SHUFFLEINFO $LIB2/$SHUFFLEINFO
-sudo cp $PROTODEF_DIR/$SHUFFLEINFO $LIB2/lib$SHUFFLEINFO
-
 echo
 echo =============================================
 echo "D. Compiling the binutils and gold linker..."
@@ -156,10 +180,11 @@ echo =============================================
 echo
 compile_binutils $BINUTILS_DIR $NO_CPUS
 
-# Deploy the shared object for gold
+# Deploy the static codec for gold
 cp $PROTODEF_DIR/$CC_HDR $NEWGOLD_DIR/$CC_HDR
-cp $PROTODEF_DIR/$SHUFFLEINFO $NEWGOLD_DIR/lib$SHUFFLEINFO
-compile_gold $NEWGOLD_DIR $NO_CPUS
+rm -f $NEWGOLD_DIR/lib$SHUFFLEINFO
+cp $PROTODEF_DIR/$CODEC_LIB $NEWGOLD_DIR/$CODEC_LIB
+compile_gold $NEWGOLD_DIR $NO_CPUS "$PROTODEF_DIR/$CODEC_LIB $PROTOBUF_LITE_LIB"
 
 echo
 echo =============================================
@@ -170,20 +195,13 @@ echo
 cd $LLVM_DIR
 mkdir $LLVM_DIR/build
 cd $LLVM_DIR/build
-cmake -DCMAKE_EXE_LINKER_FLAGS_DEBUG="-I/usr/local/include -L/usr/local/lib -lprotobuf -lpthread" -DLLVM_ENABLE_RTTI=ON -DLLVM_BINUTILS_INCDIR=$BINUTILS_DIR/include ..
+cmake -DCMAKE_CXX_STANDARD_LIBRARIES="$PROTOBUF_LITE_LIB -lpthread" -DLLVM_ENABLE_RTTI=ON -DLLVM_BINUTILS_INCDIR=$BINUTILS_DIR/include ..
 
 MODIFIED_LINK1="$LLVM_DIR/build/lib/MC/CMakeFiles/LLVMMC.dir/link.txt"
-MODIFIED_LINK2="$LLVM_DIR/build/tools/lto/CMakeFiles/LTO.dir/link.txt"
-MODIFIED_LINK3="$LLVM_DIR/build/tools/clang/tools/libclang/CMakeFiles/libclang.dir/link.txt"
-MODIFIED_LINK4="$LLVM_DIR/build/tools/clang/tools/c-index-test/CMakeFiles/c-index-test.dir/link.txt"
-
-# Adding /usr/lib/shuffleInfo.so
-sed -i '/LLVMMC.dir/s/$/\ \/usr\/lib\/shuffleInfo\.so/' $MODIFIED_LINK1
 
-# Adding -I/usr/local/include -L/usr/local/lib -lprotobuf
-sed -i 's/$/\-I\/usr\/local\/include\ \-L\/usr\/local\/lib\ \-lprotobuf/' $MODIFIED_LINK2 
-sed -i 's/$/\-I\/usr\/local\/include\ \-L\/usr\/local\/lib\ \-lprotobuf/' $MODIFIED_LINK3 
-sed -i 's/$/\-I\/usr\/local\/include\ \-L\/usr\/local\/lib\ \-lprotobuf/' $MODIFIED_LINK4 
+# Archiving the codec objects into libLLVMMC.a; every tool and shared library of LLVM links
+# libprotobuf-lite.a via CMAKE_CXX_STANDARD_LIBRARIES
+sed -i "/LLVMMC.dir/s|$| $CODEC_OBJS|" $MODIFIED_LINK1
 
 # Deploy the protobuf for LLVM 
 cp $PROTODEF_DIR/$CC_HDR $LLVM_DIR/include/llvm/Support/$CC_HDR
@@ -1390,6 +1390,9 @@ void AsmPrinter::EmitJumpTableInfo() {
   const DataLayout &DL = MF->getDataLayout();
   const MachineJumpTableInfo *MJTI = MF->getJumpTableInfo();
   if (!MJTI) return;
+
+  // Koo - Record the final tables for the metadata, once per function
+  MF->RecordMachineJumpTableInfo(MJTI);
   
   // Koo [Note] Seems that the JT can be emitted in the code section? 
   if (MJTI->getEntryKind() == MachineJumpTableInfo::EK_Inline) {
@@ -252,10 +252,11 @@ void MachineFunction::RenumberBlocks(MachineBasicBlock *MBB) {
   MBBNumbering.resize(BlockNo);
 }
 
-// Koo - As optimization goes, MJTI might keep being updated from the followings
-//        a) MachineFunctionPass::SelectionDAGISel::X86DAGToDAGISel::runOnMachineFunction() 
-//        b) MachineFunctionPass::BranchFolderPass::runOnMachineFunction() 
-void MachineFunction::RecordMachineJumpTableInfo(MachineJumpTableInfo *MJTI) {
+// Koo - Called once per function from AsmPrinter::EmitJumpTableInfo(), thus the
+//       tables are recorded as emitted, after every pass that rewrites them
+//       (e.g., branch folding, tail duplication and block placement)
+void MachineFunction::RecordMachineJumpTableInfo(
+    const MachineJumpTableInfo *MJTI) const {
   const std::vector<MachineJumpTableEntry> &JT = MJTI->getJumpTables();
   
   if (!JT.empty()) {
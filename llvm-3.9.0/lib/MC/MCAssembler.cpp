@@ -36,6 +36,7 @@
 #include "llvm/MC/MCObjectFileInfo.h"
 #include "llvm/MC/MCInst.h"
 #include "llvm/Support/shuffleInfo.pb.h"
+#include "llvm/Support/shuffleInfoWriter.h"
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -867,14 +868,10 @@ int getFixupSectionId(std::string secName) {
 }
 
 ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* getFixupTuple(ShuffleInfo::ReorderInfo_FixupInfo* FI, std::string secName) {
-  switch (getFixupSectionId(secName)) {
-    case 0: return FI->add_text();
-    case 1: return FI->add_rodata();
-    case 2: return FI->add_data();
-    case 3: return FI->add_datarel();
-    case 4: return FI->add_initarray();
-    default: llvm_unreachable("[CCR-Error] No such section to collect fixups!");
-  }
+  // The lookup sections are the first fixup lists of ShuffleInfo (FL_Text, ...)
+  if (ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* T = ShuffleInfo::AddFixupTuple(FI, getFixupSectionId(secName)))
+    return T;
+  llvm_unreachable("[CCR-Error] No such section to collect fixups!");
 }
 
 void setFixups(std::list<std::tuple<unsigned, unsigned, bool, std::string, std::string, bool, std::string, unsigned, unsigned>> Fixups,
@@ -887,20 +884,17 @@ void setFixups(std::list<std::tuple<unsigned, unsigned, bool, std::string, std::
     ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* pFixupTuple = getFixupTuple(fixupInfo, secName);
     std::tie(FixupOffset, FixupSize, FixupisRela, FixupParentID, \
              SymbolRefFixupName, isNewSection, sectionName, numJTEntries, JTEntrySize) = *F;
-    pFixupTuple->set_offset(FixupOffset);
-    pFixupTuple->set_deref_sz(FixupSize);
-    pFixupTuple->set_is_rela(FixupisRela);
+    // Koo: The shared encoder writes the fields of the record (see shuffleInfoWriter.h);
+    //      the section goes by its name in this version
+    ShuffleInfo::FixupRecord FR;
+    FR.Offset = FixupOffset;
+    FR.DerefSize = FixupSize;
+    FR.IsRela = FixupisRela;
+    FR.IsNewSection = isNewSection;
+    FR.NumJTEntries = numJTEntries;
+    FR.JTEntrySize = JTEntrySize;
+    ShuffleInfo::SetFixupTuple(pFixupTuple, FR, FR.Offset);
     pFixupTuple->set_section_name(sectionName);
-    if (isNewSection) 
-      pFixupTuple->set_type(4); // let linker know if there are multiple .text sections
-    else
-      pFixupTuple->set_type(0); // c2c, c2d, d2c, d2d default=0; should be updated by linker
-  
-    // The following jump table information is fixups in .text for JT entry update only (pic/pie)
-    if (numJTEntries > 0) {
-       pFixupTuple->set_num_jt_entries(numJTEntries);
-       pFixupTuple->set_jt_entry_sz(JTEntrySize);
-    }
   }
 }
 
@@ -175,12 +175,6 @@ namespace {
       // Reset the subtarget each time through.
       Subtarget = &MF.getSubtarget<X86Subtarget>();
       SelectionDAGISel::runOnMachineFunction(MF);
-      
-      // Koo - Overriden from lib/CodeGen/BranchFolding.cpp
-      MachineJumpTableInfo *MJTI = MF.getJumpTableInfo();
-      if (MJTI)
-        MF.RecordMachineJumpTableInfo(MJTI);
-      
       return true;
     }
 
@@ -426,7 +426,7 @@ public:
   MachineJumpTableInfo *getOrCreateJumpTableInfo(unsigned JTEntryKind);
 
   // Koo
-  void RecordMachineJumpTableInfo(MachineJumpTableInfo *MJTI);
+  void RecordMachineJumpTableInfo(const MachineJumpTableInfo *MJTI) const;
   mutable std::map<std::string, bool> canMBBFallThrough;
   
   /// getConstantPool - Return the constant pool object for the current
@@ -23,10 +23,9 @@
 #include <google/protobuf/arenastring.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/metadata.h>
-#include <google/protobuf/message.h>
+#include <google/protobuf/message_lite.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
-#include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
 namespace ShuffleInfo {
 class ReorderInfo;
@@ -35,12 +34,21 @@ extern ReorderInfoDefaultTypeInternal _ReorderInfo_default_instance_;
 class ReorderInfo_BinaryInfo;
 class ReorderInfo_BinaryInfoDefaultTypeInternal;
 extern ReorderInfo_BinaryInfoDefaultTypeInternal _ReorderInfo_BinaryInfo_default_instance_;
+class ReorderInfo_CallSiteColumns;
+class ReorderInfo_CallSiteColumnsDefaultTypeInternal;
+extern ReorderInfo_CallSiteColumnsDefaultTypeInternal _ReorderInfo_CallSiteColumns_default_instance_;
+class ReorderInfo_FixupColumns;
+class ReorderInfo_FixupColumnsDefaultTypeInternal;
+extern ReorderInfo_FixupColumnsDefaultTypeInternal _ReorderInfo_FixupColumns_default_instance_;
 class ReorderInfo_FixupInfo;
 class ReorderInfo_FixupInfoDefaultTypeInternal;
 extern ReorderInfo_FixupInfoDefaultTypeInternal _ReorderInfo_FixupInfo_default_instance_;
 class ReorderInfo_FixupInfo_FixupTuple;
 class ReorderInfo_FixupInfo_FixupTupleDefaultTypeInternal;
 extern ReorderInfo_FixupInfo_FixupTupleDefaultTypeInternal _ReorderInfo_FixupInfo_FixupTuple_default_instance_;
+class ReorderInfo_LayoutColumns;
+class ReorderInfo_LayoutColumnsDefaultTypeInternal;
+extern ReorderInfo_LayoutColumnsDefaultTypeInternal _ReorderInfo_LayoutColumns_default_instance_;
 class ReorderInfo_LayoutInfo;
 class ReorderInfo_LayoutInfoDefaultTypeInternal;
 extern ReorderInfo_LayoutInfoDefaultTypeInternal _ReorderInfo_LayoutInfo_default_instance_;
@@ -57,7 +65,7 @@ void protobuf_InitDefaults_shuffleInfo_2eproto();
 
 // ===================================================================
 
-class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.BinaryInfo) */ {
+class ReorderInfo_BinaryInfo : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.BinaryInfo) */ {
  public:
   ReorderInfo_BinaryInfo();
   virtual ~ReorderInfo_BinaryInfo();
@@ -69,15 +77,20 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
     return *this;
   }
 
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+  inline const ::std::string& unknown_fields() const {
     return _internal_metadata_.unknown_fields();
   }
 
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+  inline ::std::string* mutable_unknown_fields() {
     return _internal_metadata_.mutable_unknown_fields();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
   static const ReorderInfo_BinaryInfo& default_instance();
 
   static inline const ReorderInfo_BinaryInfo* internal_default_instance() {
@@ -85,6 +98,7 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
                &_ReorderInfo_BinaryInfo_default_instance_);
   }
 
+  void UnsafeArenaSwap(ReorderInfo_BinaryInfo* other);
   void Swap(ReorderInfo_BinaryInfo* other);
 
   // implements Message ----------------------------------------------
@@ -92,8 +106,8 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
   inline ReorderInfo_BinaryInfo* New() const PROTOBUF_FINAL { return New(NULL); }
 
   ReorderInfo_BinaryInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
-  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
   void CopyFrom(const ReorderInfo_BinaryInfo& from);
   void MergeFrom(const ReorderInfo_BinaryInfo& from);
   void Clear() PROTOBUF_FINAL;
@@ -104,53 +118,53 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
       ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output)
-      const PROTOBUF_FINAL {
-    return InternalSerializeWithCachedSizesToArray(false, output);
-  }
+  void DiscardUnknownFields();
   int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
-  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void SetCachedSize(int size) const;
   void InternalSwap(ReorderInfo_BinaryInfo* other);
+  protected:
+  explicit ReorderInfo_BinaryInfo(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
   private:
   inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
+    return _internal_metadata_.arena();
   }
   inline void* MaybeArenaPtr() const {
-    return NULL;
+    return _internal_metadata_.raw_arena_ptr();
   }
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
 
   // nested types ----------------------------------------------------
 
   // accessors -------------------------------------------------------
 
-  // optional uint32 rand_obj_offset = 1;
+  // optional uint64 rand_obj_offset = 1;
   bool has_rand_obj_offset() const;
   void clear_rand_obj_offset();
   static const int kRandObjOffsetFieldNumber = 1;
-  ::google::protobuf::uint32 rand_obj_offset() const;
-  void set_rand_obj_offset(::google::protobuf::uint32 value);
+  ::google::protobuf::uint64 rand_obj_offset() const;
+  void set_rand_obj_offset(::google::protobuf::uint64 value);
 
-  // optional uint32 main_addr_offset = 2;
+  // optional uint64 main_addr_offset = 2;
   bool has_main_addr_offset() const;
   void clear_main_addr_offset();
   static const int kMainAddrOffsetFieldNumber = 2;
-  ::google::protobuf::uint32 main_addr_offset() const;
-  void set_main_addr_offset(::google::protobuf::uint32 value);
+  ::google::protobuf::uint64 main_addr_offset() const;
+  void set_main_addr_offset(::google::protobuf::uint64 value);
 
-  // optional uint32 obj_sz = 3;
+  // optional uint64 obj_sz = 3;
   bool has_obj_sz() const;
   void clear_obj_sz();
   static const int kObjSzFieldNumber = 3;
-  ::google::protobuf::uint32 obj_sz() const;
-  void set_obj_sz(::google::protobuf::uint32 value);
+  ::google::protobuf::uint64 obj_sz() const;
+  void set_obj_sz(::google::protobuf::uint64 value);
 
   // optional uint32 src_type = 4;
   bool has_src_type() const;
@@ -159,6 +173,41 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
   ::google::protobuf::uint32 src_type() const;
   void set_src_type(::google::protobuf::uint32 value);
 
+  // optional uint32 fixup_offset_encoding = 5;
+  bool has_fixup_offset_encoding() const;
+  void clear_fixup_offset_encoding();
+  static const int kFixupOffsetEncodingFieldNumber = 5;
+  ::google::protobuf::uint32 fixup_offset_encoding() const;
+  void set_fixup_offset_encoding(::google::protobuf::uint32 value);
+
+  // optional uint32 format_version = 6;
+  bool has_format_version() const;
+  void clear_format_version();
+  static const int kFormatVersionFieldNumber = 6;
+  ::google::protobuf::uint32 format_version() const;
+  void set_format_version(::google::protobuf::uint32 value);
+
+  // optional bool eh_info = 7;
+  bool has_eh_info() const;
+  void clear_eh_info();
+  static const int kEhInfoFieldNumber = 7;
+  bool eh_info() const;
+  void set_eh_info(bool value);
+
+  // optional bool fixups_from_relocs = 8;
+  bool has_fixups_from_relocs() const;
+  void clear_fixups_from_relocs();
+  static const int kFixupsFromRelocsFieldNumber = 8;
+  bool fixups_from_relocs() const;
+  void set_fixups_from_relocs(bool value);
+
+  // optional bool data_fixups = 9;
+  bool has_data_fixups() const;
+  void clear_data_fixups();
+  static const int kDataFixupsFieldNumber = 9;
+  bool data_fixups() const;
+  void set_data_fixups(bool value);
+
   // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.BinaryInfo)
  private:
   void set_has_rand_obj_offset();
@@ -169,14 +218,32 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
   void clear_has_obj_sz();
   void set_has_src_type();
   void clear_has_src_type();
-
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  void set_has_fixup_offset_encoding();
+  void clear_has_fixup_offset_encoding();
+  void set_has_format_version();
+  void clear_has_format_version();
+  void set_has_eh_info();
+  void clear_has_eh_info();
+  void set_has_fixups_from_relocs();
+  void clear_has_fixups_from_relocs();
+  void set_has_data_fixups();
+  void clear_has_data_fixups();
+
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
-  ::google::protobuf::uint32 rand_obj_offset_;
-  ::google::protobuf::uint32 main_addr_offset_;
-  ::google::protobuf::uint32 obj_sz_;
+  ::google::protobuf::uint64 rand_obj_offset_;
+  ::google::protobuf::uint64 main_addr_offset_;
+  ::google::protobuf::uint64 obj_sz_;
   ::google::protobuf::uint32 src_type_;
+  ::google::protobuf::uint32 fixup_offset_encoding_;
+  ::google::protobuf::uint32 format_version_;
+  bool eh_info_;
+  bool fixups_from_relocs_;
+  bool data_fixups_;
   friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
   friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
   friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
@@ -185,7 +252,7 @@ class ReorderInfo_BinaryInfo : public ::google::protobuf::Message /* @@protoc_in
 };
 // -------------------------------------------------------------------
 
-class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.LayoutInfo) */ {
+class ReorderInfo_LayoutInfo : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.LayoutInfo) */ {
  public:
   ReorderInfo_LayoutInfo();
   virtual ~ReorderInfo_LayoutInfo();
@@ -197,15 +264,20 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
     return *this;
   }
 
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+  inline const ::std::string& unknown_fields() const {
     return _internal_metadata_.unknown_fields();
   }
 
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+  inline ::std::string* mutable_unknown_fields() {
     return _internal_metadata_.mutable_unknown_fields();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
   static const ReorderInfo_LayoutInfo& default_instance();
 
   static inline const ReorderInfo_LayoutInfo* internal_default_instance() {
@@ -213,6 +285,7 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
                &_ReorderInfo_LayoutInfo_default_instance_);
   }
 
+  void UnsafeArenaSwap(ReorderInfo_LayoutInfo* other);
   void Swap(ReorderInfo_LayoutInfo* other);
 
   // implements Message ----------------------------------------------
@@ -220,8 +293,8 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
   inline ReorderInfo_LayoutInfo* New() const PROTOBUF_FINAL { return New(NULL); }
 
   ReorderInfo_LayoutInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
-  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
   void CopyFrom(const ReorderInfo_LayoutInfo& from);
   void MergeFrom(const ReorderInfo_LayoutInfo& from);
   void Clear() PROTOBUF_FINAL;
@@ -232,28 +305,28 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
       ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output)
-      const PROTOBUF_FINAL {
-    return InternalSerializeWithCachedSizesToArray(false, output);
-  }
+  void DiscardUnknownFields();
   int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
-  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void SetCachedSize(int size) const;
   void InternalSwap(ReorderInfo_LayoutInfo* other);
+  protected:
+  explicit ReorderInfo_LayoutInfo(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
   private:
   inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
+    return _internal_metadata_.arena();
   }
   inline void* MaybeArenaPtr() const {
-    return NULL;
+    return _internal_metadata_.raw_arena_ptr();
   }
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
 
   // nested types ----------------------------------------------------
 
@@ -293,14 +366,84 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
   static const int kSectionNameFieldNumber = 5;
   const ::std::string& section_name() const;
   void set_section_name(const ::std::string& value);
-  #if LANG_CXX11
-  void set_section_name(::std::string&& value);
-  #endif
   void set_section_name(const char* value);
   void set_section_name(const char* value, size_t size);
   ::std::string* mutable_section_name();
   ::std::string* release_section_name();
   void set_allocated_section_name(::std::string* section_name);
+  ::std::string* unsafe_arena_release_section_name();
+  void unsafe_arena_set_allocated_section_name(
+      ::std::string* section_name);
+
+  // optional uint32 section_idx = 6;
+  bool has_section_idx() const;
+  void clear_section_idx();
+  static const int kSectionIdxFieldNumber = 6;
+  ::google::protobuf::uint32 section_idx() const;
+  void set_section_idx(::google::protobuf::uint32 value);
+
+  // optional uint32 hotness = 7;
+  bool has_hotness() const;
+  void clear_hotness();
+  static const int kHotnessFieldNumber = 7;
+  ::google::protobuf::uint32 hotness() const;
+  void set_hotness(::google::protobuf::uint32 value);
+
+  // optional uint32 padding_sz = 8;
+  bool has_padding_sz() const;
+  void clear_padding_sz();
+  static const int kPaddingSzFieldNumber = 8;
+  ::google::protobuf::uint32 padding_sz() const;
+  void set_padding_sz(::google::protobuf::uint32 value);
+
+  // optional uint32 align_log2 = 9;
+  bool has_align_log2() const;
+  void clear_align_log2();
+  static const int kAlignLog2FieldNumber = 9;
+  ::google::protobuf::uint32 align_log2() const;
+  void set_align_log2(::google::protobuf::uint32 value);
+
+  // optional bool loop_header = 10;
+  bool has_loop_header() const;
+  void clear_loop_header();
+  static const int kLoopHeaderFieldNumber = 10;
+  bool loop_header() const;
+  void set_loop_header(bool value);
+
+  // optional bool pinned = 11;
+  bool has_pinned() const;
+  void clear_pinned();
+  static const int kPinnedFieldNumber = 11;
+  bool pinned() const;
+  void set_pinned(bool value);
+
+  // optional bool chain_start = 12;
+  bool has_chain_start() const;
+  void clear_chain_start();
+  static const int kChainStartFieldNumber = 12;
+  bool chain_start() const;
+  void set_chain_start(bool value);
+
+  // optional uint32 edge_prob = 13;
+  bool has_edge_prob() const;
+  void clear_edge_prob();
+  static const int kEdgeProbFieldNumber = 13;
+  ::google::protobuf::uint32 edge_prob() const;
+  void set_edge_prob(::google::protobuf::uint32 value);
+
+  // optional uint32 term = 14;
+  bool has_term() const;
+  void clear_term();
+  static const int kTermFieldNumber = 14;
+  ::google::protobuf::uint32 term() const;
+  void set_term(::google::protobuf::uint32 value);
+
+  // optional uint32 boundary = 15;
+  bool has_boundary() const;
+  void clear_boundary();
+  static const int kBoundaryFieldNumber = 15;
+  ::google::protobuf::uint32 boundary() const;
+  void set_boundary(::google::protobuf::uint32 value);
 
   // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.LayoutInfo)
  private:
@@ -314,15 +457,48 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
   void clear_has_bb_fallthrough();
   void set_has_section_name();
   void clear_has_section_name();
-
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  void set_has_section_idx();
+  void clear_has_section_idx();
+  void set_has_hotness();
+  void clear_has_hotness();
+  void set_has_padding_sz();
+  void clear_has_padding_sz();
+  void set_has_align_log2();
+  void clear_has_align_log2();
+  void set_has_loop_header();
+  void clear_has_loop_header();
+  void set_has_pinned();
+  void clear_has_pinned();
+  void set_has_chain_start();
+  void clear_has_chain_start();
+  void set_has_edge_prob();
+  void clear_has_edge_prob();
+  void set_has_term();
+  void clear_has_term();
+  void set_has_boundary();
+  void clear_has_boundary();
+
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
   ::google::protobuf::internal::ArenaStringPtr section_name_;
   ::google::protobuf::uint32 bb_size_;
   ::google::protobuf::uint32 type_;
   ::google::protobuf::uint32 num_fixups_;
+  ::google::protobuf::uint32 section_idx_;
+  ::google::protobuf::uint32 hotness_;
+  ::google::protobuf::uint32 padding_sz_;
+  ::google::protobuf::uint32 align_log2_;
   bool bb_fallthrough_;
+  bool loop_header_;
+  bool pinned_;
+  bool chain_start_;
+  ::google::protobuf::uint32 edge_prob_;
+  ::google::protobuf::uint32 term_;
+  ::google::protobuf::uint32 boundary_;
   friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
   friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
   friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
@@ -331,7 +507,7 @@ class ReorderInfo_LayoutInfo : public ::google::protobuf::Message /* @@protoc_in
 };
 // -------------------------------------------------------------------
 
-class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple) */ {
+class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple) */ {
  public:
   ReorderInfo_FixupInfo_FixupTuple();
   virtual ~ReorderInfo_FixupInfo_FixupTuple();
@@ -343,15 +519,20 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
     return *this;
   }
 
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+  inline const ::std::string& unknown_fields() const {
     return _internal_metadata_.unknown_fields();
   }
 
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+  inline ::std::string* mutable_unknown_fields() {
     return _internal_metadata_.mutable_unknown_fields();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
   static const ReorderInfo_FixupInfo_FixupTuple& default_instance();
 
   static inline const ReorderInfo_FixupInfo_FixupTuple* internal_default_instance() {
@@ -359,6 +540,7 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
                &_ReorderInfo_FixupInfo_FixupTuple_default_instance_);
   }
 
+  void UnsafeArenaSwap(ReorderInfo_FixupInfo_FixupTuple* other);
   void Swap(ReorderInfo_FixupInfo_FixupTuple* other);
 
   // implements Message ----------------------------------------------
@@ -366,8 +548,8 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
   inline ReorderInfo_FixupInfo_FixupTuple* New() const PROTOBUF_FINAL { return New(NULL); }
 
   ReorderInfo_FixupInfo_FixupTuple* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
-  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
   void CopyFrom(const ReorderInfo_FixupInfo_FixupTuple& from);
   void MergeFrom(const ReorderInfo_FixupInfo_FixupTuple& from);
   void Clear() PROTOBUF_FINAL;
@@ -378,39 +560,39 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
       ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output)
-      const PROTOBUF_FINAL {
-    return InternalSerializeWithCachedSizesToArray(false, output);
-  }
+  void DiscardUnknownFields();
   int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
-  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void SetCachedSize(int size) const;
   void InternalSwap(ReorderInfo_FixupInfo_FixupTuple* other);
+  protected:
+  explicit ReorderInfo_FixupInfo_FixupTuple(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
   private:
   inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
+    return _internal_metadata_.arena();
   }
   inline void* MaybeArenaPtr() const {
-    return NULL;
+    return _internal_metadata_.raw_arena_ptr();
   }
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
 
   // nested types ----------------------------------------------------
 
   // accessors -------------------------------------------------------
 
-  // required uint32 offset = 1;
+  // required uint64 offset = 1;
   bool has_offset() const;
   void clear_offset();
   static const int kOffsetFieldNumber = 1;
-  ::google::protobuf::uint32 offset() const;
-  void set_offset(::google::protobuf::uint32 value);
+  ::google::protobuf::uint64 offset() const;
+  void set_offset(::google::protobuf::uint64 value);
 
   // required uint32 deref_sz = 2;
   bool has_deref_sz() const;
@@ -439,14 +621,14 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
   static const int kSectionNameFieldNumber = 5;
   const ::std::string& section_name() const;
   void set_section_name(const ::std::string& value);
-  #if LANG_CXX11
-  void set_section_name(::std::string&& value);
-  #endif
   void set_section_name(const char* value);
   void set_section_name(const char* value, size_t size);
   ::std::string* mutable_section_name();
   ::std::string* release_section_name();
   void set_allocated_section_name(::std::string* section_name);
+  ::std::string* unsafe_arena_release_section_name();
+  void unsafe_arena_set_allocated_section_name(
+      ::std::string* section_name);
 
   // optional uint32 num_jt_entries = 6;
   bool has_num_jt_entries() const;
@@ -462,6 +644,120 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
   ::google::protobuf::uint32 jt_entry_sz() const;
   void set_jt_entry_sz(::google::protobuf::uint32 value);
 
+  // optional uint32 section_idx = 8;
+  bool has_section_idx() const;
+  void clear_section_idx();
+  static const int kSectionIdxFieldNumber = 8;
+  ::google::protobuf::uint32 section_idx() const;
+  void set_section_idx(::google::protobuf::uint32 value);
+
+  // optional uint32 relax_short_sz = 9;
+  bool has_relax_short_sz() const;
+  void clear_relax_short_sz();
+  static const int kRelaxShortSzFieldNumber = 9;
+  ::google::protobuf::uint32 relax_short_sz() const;
+  void set_relax_short_sz(::google::protobuf::uint32 value);
+
+  // optional bytes relax_long_form = 10;
+  bool has_relax_long_form() const;
+  void clear_relax_long_form();
+  static const int kRelaxLongFormFieldNumber = 10;
+  const ::std::string& relax_long_form() const;
+  void set_relax_long_form(const ::std::string& value);
+  void set_relax_long_form(const char* value);
+  void set_relax_long_form(const void* value, size_t size);
+  ::std::string* mutable_relax_long_form();
+  ::std::string* release_relax_long_form();
+  void set_allocated_relax_long_form(::std::string* relax_long_form);
+  ::std::string* unsafe_arena_release_relax_long_form();
+  void unsafe_arena_set_allocated_relax_long_form(
+      ::std::string* relax_long_form);
+
+  // optional uint32 relax_fixup_offset = 11;
+  bool has_relax_fixup_offset() const;
+  void clear_relax_fixup_offset();
+  static const int kRelaxFixupOffsetFieldNumber = 11;
+  ::google::protobuf::uint32 relax_fixup_offset() const;
+  void set_relax_fixup_offset(::google::protobuf::uint32 value);
+
+  // optional uint32 target = 12;
+  bool has_target() const;
+  void clear_target();
+  static const int kTargetFieldNumber = 12;
+  ::google::protobuf::uint32 target() const;
+  void set_target(::google::protobuf::uint32 value);
+
+  // optional uint32 reach_log2 = 13;
+  bool has_reach_log2() const;
+  void clear_reach_log2();
+  static const int kReachLog2FieldNumber = 13;
+  ::google::protobuf::uint32 reach_log2() const;
+  void set_reach_log2(::google::protobuf::uint32 value);
+
+  // optional uint32 ref_class = 14;
+  bool has_ref_class() const;
+  void clear_ref_class();
+  static const int kRefClassFieldNumber = 14;
+  ::google::protobuf::uint32 ref_class() const;
+  void set_ref_class(::google::protobuf::uint32 value);
+
+  // optional bool jt_func_rel = 15;
+  bool has_jt_func_rel() const;
+  void clear_jt_func_rel();
+  static const int kJtFuncRelFieldNumber = 15;
+  bool jt_func_rel() const;
+  void set_jt_func_rel(bool value);
+
+  // optional uint32 scope = 16;
+  bool has_scope() const;
+  void clear_scope();
+  static const int kScopeFieldNumber = 16;
+  ::google::protobuf::uint32 scope() const;
+  void set_scope(::google::protobuf::uint32 value);
+
+  // optional uint32 pair_delta = 17;
+  bool has_pair_delta() const;
+  void clear_pair_delta();
+  static const int kPairDeltaFieldNumber = 17;
+  ::google::protobuf::uint32 pair_delta() const;
+  void set_pair_delta(::google::protobuf::uint32 value);
+
+  // optional uint32 shrink_long_sz = 18;
+  bool has_shrink_long_sz() const;
+  void clear_shrink_long_sz();
+  static const int kShrinkLongSzFieldNumber = 18;
+  ::google::protobuf::uint32 shrink_long_sz() const;
+  void set_shrink_long_sz(::google::protobuf::uint32 value);
+
+  // optional bytes shrink_short_form = 19;
+  bool has_shrink_short_form() const;
+  void clear_shrink_short_form();
+  static const int kShrinkShortFormFieldNumber = 19;
+  const ::std::string& shrink_short_form() const;
+  void set_shrink_short_form(const ::std::string& value);
+  void set_shrink_short_form(const char* value);
+  void set_shrink_short_form(const void* value, size_t size);
+  ::std::string* mutable_shrink_short_form();
+  ::std::string* release_shrink_short_form();
+  void set_allocated_shrink_short_form(::std::string* shrink_short_form);
+  ::std::string* unsafe_arena_release_shrink_short_form();
+  void unsafe_arena_set_allocated_shrink_short_form(
+      ::std::string* shrink_short_form);
+
+  // optional uint32 reloc_idx = 20;
+  bool has_reloc_idx() const;
+  void clear_reloc_idx();
+  static const int kRelocIdxFieldNumber = 20;
+  ::google::protobuf::uint32 reloc_idx() const;
+  void set_reloc_idx(::google::protobuf::uint32 value);
+
+  // optional uint32 got_relax = 21;
+  bool has_got_relax() const;
+  void clear_got_relax();
+  static const int kGotRelaxFieldNumber = 21;
+  ::google::protobuf::uint32 got_relax() const;
+  void set_got_relax(::google::protobuf::uint32 value);
+
   // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple)
  private:
   void set_has_offset();
@@ -478,20 +774,65 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
   void clear_has_num_jt_entries();
   void set_has_jt_entry_sz();
   void clear_has_jt_entry_sz();
+  void set_has_section_idx();
+  void clear_has_section_idx();
+  void set_has_relax_short_sz();
+  void clear_has_relax_short_sz();
+  void set_has_relax_long_form();
+  void clear_has_relax_long_form();
+  void set_has_relax_fixup_offset();
+  void clear_has_relax_fixup_offset();
+  void set_has_target();
+  void clear_has_target();
+  void set_has_reach_log2();
+  void clear_has_reach_log2();
+  void set_has_ref_class();
+  void clear_has_ref_class();
+  void set_has_jt_func_rel();
+  void clear_has_jt_func_rel();
+  void set_has_scope();
+  void clear_has_scope();
+  void set_has_pair_delta();
+  void clear_has_pair_delta();
+  void set_has_shrink_long_sz();
+  void clear_has_shrink_long_sz();
+  void set_has_shrink_short_form();
+  void clear_has_shrink_short_form();
+  void set_has_reloc_idx();
+  void clear_has_reloc_idx();
+  void set_has_got_relax();
+  void clear_has_got_relax();
 
   // helper for ByteSizeLong()
   size_t RequiredFieldsByteSizeFallback() const;
 
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
   ::google::protobuf::internal::ArenaStringPtr section_name_;
-  ::google::protobuf::uint32 offset_;
+  ::google::protobuf::internal::ArenaStringPtr relax_long_form_;
+  ::google::protobuf::internal::ArenaStringPtr shrink_short_form_;
+  ::google::protobuf::uint64 offset_;
   ::google::protobuf::uint32 deref_sz_;
-  bool is_rela_;
   ::google::protobuf::uint32 type_;
   ::google::protobuf::uint32 num_jt_entries_;
   ::google::protobuf::uint32 jt_entry_sz_;
+  ::google::protobuf::uint32 section_idx_;
+  ::google::protobuf::uint32 relax_short_sz_;
+  bool is_rela_;
+  bool jt_func_rel_;
+  ::google::protobuf::uint32 relax_fixup_offset_;
+  ::google::protobuf::uint32 target_;
+  ::google::protobuf::uint32 reach_log2_;
+  ::google::protobuf::uint32 ref_class_;
+  ::google::protobuf::uint32 scope_;
+  ::google::protobuf::uint32 pair_delta_;
+  ::google::protobuf::uint32 shrink_long_sz_;
+  ::google::protobuf::uint32 reloc_idx_;
+  ::google::protobuf::uint32 got_relax_;
   friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
   friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
   friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
@@ -500,7 +841,7 @@ class ReorderInfo_FixupInfo_FixupTuple : public ::google::protobuf::Message /* @
 };
 // -------------------------------------------------------------------
 
-class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.FixupInfo) */ {
+class ReorderInfo_FixupInfo : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.FixupInfo) */ {
  public:
   ReorderInfo_FixupInfo();
   virtual ~ReorderInfo_FixupInfo();
@@ -512,15 +853,20 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
     return *this;
   }
 
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+  inline const ::std::string& unknown_fields() const {
     return _internal_metadata_.unknown_fields();
   }
 
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+  inline ::std::string* mutable_unknown_fields() {
     return _internal_metadata_.mutable_unknown_fields();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
   static const ReorderInfo_FixupInfo& default_instance();
 
   static inline const ReorderInfo_FixupInfo* internal_default_instance() {
@@ -528,6 +874,7 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
                &_ReorderInfo_FixupInfo_default_instance_);
   }
 
+  void UnsafeArenaSwap(ReorderInfo_FixupInfo* other);
   void Swap(ReorderInfo_FixupInfo* other);
 
   // implements Message ----------------------------------------------
@@ -535,8 +882,8 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
   inline ReorderInfo_FixupInfo* New() const PROTOBUF_FINAL { return New(NULL); }
 
   ReorderInfo_FixupInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
-  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
   void CopyFrom(const ReorderInfo_FixupInfo& from);
   void MergeFrom(const ReorderInfo_FixupInfo& from);
   void Clear() PROTOBUF_FINAL;
@@ -547,28 +894,28 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
       ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output)
-      const PROTOBUF_FINAL {
-    return InternalSerializeWithCachedSizesToArray(false, output);
-  }
+  void DiscardUnknownFields();
   int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
-  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void SetCachedSize(int size) const;
   void InternalSwap(ReorderInfo_FixupInfo* other);
+  protected:
+  explicit ReorderInfo_FixupInfo(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
   private:
   inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
+    return _internal_metadata_.arena();
   }
   inline void* MaybeArenaPtr() const {
-    return NULL;
+    return _internal_metadata_.raw_arena_ptr();
   }
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
 
   // nested types ----------------------------------------------------
 
@@ -636,10 +983,85 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
   const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
       initarray() const;
 
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple finiarray = 6;
+  int finiarray_size() const;
+  void clear_finiarray();
+  static const int kFiniarrayFieldNumber = 6;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& finiarray(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* mutable_finiarray(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* add_finiarray();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+      mutable_finiarray();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+      finiarray() const;
+
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple tdata = 7;
+  int tdata_size() const;
+  void clear_tdata();
+  static const int kTdataFieldNumber = 7;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& tdata(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* mutable_tdata(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* add_tdata();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+      mutable_tdata();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+      tdata() const;
+
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple xray = 8;
+  int xray_size() const;
+  void clear_xray();
+  static const int kXrayFieldNumber = 8;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& xray(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* mutable_xray(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* add_xray();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+      mutable_xray();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+      xray() const;
+
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple patchable = 9;
+  int patchable_size() const;
+  void clear_patchable();
+  static const int kPatchableFieldNumber = 9;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& patchable(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* mutable_patchable(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* add_patchable();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+      mutable_patchable();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+      patchable() const;
+
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple jumptable = 10;
+  int jumptable_size() const;
+  void clear_jumptable();
+  static const int kJumptableFieldNumber = 10;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& jumptable(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* mutable_jumptable(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* add_jumptable();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+      mutable_jumptable();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+      jumptable() const;
+
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple custom = 11;
+  int custom_size() const;
+  void clear_custom();
+  static const int kCustomFieldNumber = 11;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& custom(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* mutable_custom(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* add_custom();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+      mutable_custom();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+      custom() const;
+
   // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.FixupInfo)
  private:
 
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
   ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > text_;
@@ -647,6 +1069,12 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
   ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > data_;
   ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > datarel_;
   ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > initarray_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > finiarray_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > tdata_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > xray_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > patchable_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > jumptable_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple > custom_;
   friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
   friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
   friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
@@ -655,45 +1083,51 @@ class ReorderInfo_FixupInfo : public ::google::protobuf::Message /* @@protoc_ins
 };
 // -------------------------------------------------------------------
 
-class ReorderInfo_SourceInfo : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.SourceInfo) */ {
+class ReorderInfo_LayoutColumns : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.LayoutColumns) */ {
  public:
-  ReorderInfo_SourceInfo();
-  virtual ~ReorderInfo_SourceInfo();
+  ReorderInfo_LayoutColumns();
+  virtual ~ReorderInfo_LayoutColumns();
 
-  ReorderInfo_SourceInfo(const ReorderInfo_SourceInfo& from);
+  ReorderInfo_LayoutColumns(const ReorderInfo_LayoutColumns& from);
 
-  inline ReorderInfo_SourceInfo& operator=(const ReorderInfo_SourceInfo& from) {
+  inline ReorderInfo_LayoutColumns& operator=(const ReorderInfo_LayoutColumns& from) {
     CopyFrom(from);
     return *this;
   }
 
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+  inline const ::std::string& unknown_fields() const {
     return _internal_metadata_.unknown_fields();
   }
 
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+  inline ::std::string* mutable_unknown_fields() {
     return _internal_metadata_.mutable_unknown_fields();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
-  static const ReorderInfo_SourceInfo& default_instance();
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
+  static const ReorderInfo_LayoutColumns& default_instance();
 
-  static inline const ReorderInfo_SourceInfo* internal_default_instance() {
-    return reinterpret_cast<const ReorderInfo_SourceInfo*>(
-               &_ReorderInfo_SourceInfo_default_instance_);
+  static inline const ReorderInfo_LayoutColumns* internal_default_instance() {
+    return reinterpret_cast<const ReorderInfo_LayoutColumns*>(
+               &_ReorderInfo_LayoutColumns_default_instance_);
   }
 
-  void Swap(ReorderInfo_SourceInfo* other);
+  void UnsafeArenaSwap(ReorderInfo_LayoutColumns* other);
+  void Swap(ReorderInfo_LayoutColumns* other);
 
   // implements Message ----------------------------------------------
 
-  inline ReorderInfo_SourceInfo* New() const PROTOBUF_FINAL { return New(NULL); }
+  inline ReorderInfo_LayoutColumns* New() const PROTOBUF_FINAL { return New(NULL); }
 
-  ReorderInfo_SourceInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
-  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void CopyFrom(const ReorderInfo_SourceInfo& from);
-  void MergeFrom(const ReorderInfo_SourceInfo& from);
+  ReorderInfo_LayoutColumns* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
+  void CopyFrom(const ReorderInfo_LayoutColumns& from);
+  void MergeFrom(const ReorderInfo_LayoutColumns& from);
   void Clear() PROTOBUF_FINAL;
   bool IsInitialized() const PROTOBUF_FINAL;
 
@@ -702,52 +1136,280 @@ class ReorderInfo_SourceInfo : public ::google::protobuf::Message /* @@protoc_in
       ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output)
-      const PROTOBUF_FINAL {
-    return InternalSerializeWithCachedSizesToArray(false, output);
-  }
+  void DiscardUnknownFields();
   int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
-  void SetCachedSize(int size) const PROTOBUF_FINAL;
-  void InternalSwap(ReorderInfo_SourceInfo* other);
+  void SetCachedSize(int size) const;
+  void InternalSwap(ReorderInfo_LayoutColumns* other);
+  protected:
+  explicit ReorderInfo_LayoutColumns(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
   private:
   inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
+    return _internal_metadata_.arena();
   }
   inline void* MaybeArenaPtr() const {
-    return NULL;
+    return _internal_metadata_.raw_arena_ptr();
   }
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
 
   // nested types ----------------------------------------------------
 
   // accessors -------------------------------------------------------
 
-  // repeated uint32 src_type = 1;
-  int src_type_size() const;
-  void clear_src_type();
-  static const int kSrcTypeFieldNumber = 1;
-  ::google::protobuf::uint32 src_type(int index) const;
-  void set_src_type(int index, ::google::protobuf::uint32 value);
-  void add_src_type(::google::protobuf::uint32 value);
+  // repeated uint32 bb_size = 1 [packed = true];
+  int bb_size_size() const;
+  void clear_bb_size();
+  static const int kBbSizeFieldNumber = 1;
+  ::google::protobuf::uint32 bb_size(int index) const;
+  void set_bb_size(int index, ::google::protobuf::uint32 value);
+  void add_bb_size(::google::protobuf::uint32 value);
   const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
-      src_type() const;
+      bb_size() const;
   ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
-      mutable_src_type();
+      mutable_bb_size();
+
+  // repeated uint64 type_bits = 2 [packed = true];
+  int type_bits_size() const;
+  void clear_type_bits();
+  static const int kTypeBitsFieldNumber = 2;
+  ::google::protobuf::uint64 type_bits(int index) const;
+  void set_type_bits(int index, ::google::protobuf::uint64 value);
+  void add_type_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      type_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_type_bits();
+
+  // repeated uint64 fallthrough_bits = 3 [packed = true];
+  int fallthrough_bits_size() const;
+  void clear_fallthrough_bits();
+  static const int kFallthroughBitsFieldNumber = 3;
+  ::google::protobuf::uint64 fallthrough_bits(int index) const;
+  void set_fallthrough_bits(int index, ::google::protobuf::uint64 value);
+  void add_fallthrough_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      fallthrough_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_fallthrough_bits();
+
+  // repeated uint32 num_fixups = 4 [packed = true];
+  int num_fixups_size() const;
+  void clear_num_fixups();
+  static const int kNumFixupsFieldNumber = 4;
+  ::google::protobuf::uint32 num_fixups(int index) const;
+  void set_num_fixups(int index, ::google::protobuf::uint32 value);
+  void add_num_fixups(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      num_fixups() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_num_fixups();
+
+  // repeated uint32 section_idx = 5 [packed = true];
+  int section_idx_size() const;
+  void clear_section_idx();
+  static const int kSectionIdxFieldNumber = 5;
+  ::google::protobuf::uint32 section_idx(int index) const;
+  void set_section_idx(int index, ::google::protobuf::uint32 value);
+  void add_section_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      section_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_section_idx();
+
+  // repeated uint64 hotness_bits = 6 [packed = true];
+  int hotness_bits_size() const;
+  void clear_hotness_bits();
+  static const int kHotnessBitsFieldNumber = 6;
+  ::google::protobuf::uint64 hotness_bits(int index) const;
+  void set_hotness_bits(int index, ::google::protobuf::uint64 value);
+  void add_hotness_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      hotness_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_hotness_bits();
+
+  // repeated uint32 padding_sz = 7 [packed = true];
+  int padding_sz_size() const;
+  void clear_padding_sz();
+  static const int kPaddingSzFieldNumber = 7;
+  ::google::protobuf::uint32 padding_sz(int index) const;
+  void set_padding_sz(int index, ::google::protobuf::uint32 value);
+  void add_padding_sz(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      padding_sz() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_padding_sz();
+
+  // repeated uint64 align_bits = 8 [packed = true];
+  int align_bits_size() const;
+  void clear_align_bits();
+  static const int kAlignBitsFieldNumber = 8;
+  ::google::protobuf::uint64 align_bits(int index) const;
+  void set_align_bits(int index, ::google::protobuf::uint64 value);
+  void add_align_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      align_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_align_bits();
+
+  // repeated uint64 loop_header_bits = 9 [packed = true];
+  int loop_header_bits_size() const;
+  void clear_loop_header_bits();
+  static const int kLoopHeaderBitsFieldNumber = 9;
+  ::google::protobuf::uint64 loop_header_bits(int index) const;
+  void set_loop_header_bits(int index, ::google::protobuf::uint64 value);
+  void add_loop_header_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      loop_header_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_loop_header_bits();
+
+  // repeated uint64 cfi_bits = 10 [packed = true];
+  int cfi_bits_size() const;
+  void clear_cfi_bits();
+  static const int kCfiBitsFieldNumber = 10;
+  ::google::protobuf::uint64 cfi_bits(int index) const;
+  void set_cfi_bits(int index, ::google::protobuf::uint64 value);
+  void add_cfi_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      cfi_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_cfi_bits();
+
+  // repeated uint64 pinned_bits = 11 [packed = true];
+  int pinned_bits_size() const;
+  void clear_pinned_bits();
+  static const int kPinnedBitsFieldNumber = 11;
+  ::google::protobuf::uint64 pinned_bits(int index) const;
+  void set_pinned_bits(int index, ::google::protobuf::uint64 value);
+  void add_pinned_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      pinned_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_pinned_bits();
+
+  // repeated uint64 chain_start_bits = 12 [packed = true];
+  int chain_start_bits_size() const;
+  void clear_chain_start_bits();
+  static const int kChainStartBitsFieldNumber = 12;
+  ::google::protobuf::uint64 chain_start_bits(int index) const;
+  void set_chain_start_bits(int index, ::google::protobuf::uint64 value);
+  void add_chain_start_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      chain_start_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_chain_start_bits();
+
+  // repeated uint64 edge_prob_bits = 13 [packed = true];
+  int edge_prob_bits_size() const;
+  void clear_edge_prob_bits();
+  static const int kEdgeProbBitsFieldNumber = 13;
+  ::google::protobuf::uint64 edge_prob_bits(int index) const;
+  void set_edge_prob_bits(int index, ::google::protobuf::uint64 value);
+  void add_edge_prob_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      edge_prob_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_edge_prob_bits();
+
+  // repeated fixed64 function_name_hash = 14 [packed = true];
+  int function_name_hash_size() const;
+  void clear_function_name_hash();
+  static const int kFunctionNameHashFieldNumber = 14;
+  ::google::protobuf::uint64 function_name_hash(int index) const;
+  void set_function_name_hash(int index, ::google::protobuf::uint64 value);
+  void add_function_name_hash(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      function_name_hash() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_function_name_hash();
+
+  // repeated fixed64 function_content_hash = 15 [packed = true];
+  int function_content_hash_size() const;
+  void clear_function_content_hash();
+  static const int kFunctionContentHashFieldNumber = 15;
+  ::google::protobuf::uint64 function_content_hash(int index) const;
+  void set_function_content_hash(int index, ::google::protobuf::uint64 value);
+  void add_function_content_hash(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      function_content_hash() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_function_content_hash();
+
+  // repeated uint64 term_bits = 16 [packed = true];
+  int term_bits_size() const;
+  void clear_term_bits();
+  static const int kTermBitsFieldNumber = 16;
+  ::google::protobuf::uint64 term_bits(int index) const;
+  void set_term_bits(int index, ::google::protobuf::uint64 value);
+  void add_term_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      term_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_term_bits();
+
+  // repeated uint32 boundary = 17 [packed = true];
+  int boundary_size() const;
+  void clear_boundary();
+  static const int kBoundaryFieldNumber = 17;
+  ::google::protobuf::uint32 boundary(int index) const;
+  void set_boundary(int index, ::google::protobuf::uint32 value);
+  void add_boundary(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      boundary() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_boundary();
 
-  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.SourceInfo)
+  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.LayoutColumns)
  private:
 
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
-  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > src_type_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > bb_size_;
+  mutable int _bb_size_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > type_bits_;
+  mutable int _type_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > fallthrough_bits_;
+  mutable int _fallthrough_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > num_fixups_;
+  mutable int _num_fixups_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > section_idx_;
+  mutable int _section_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > hotness_bits_;
+  mutable int _hotness_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > padding_sz_;
+  mutable int _padding_sz_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > align_bits_;
+  mutable int _align_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > loop_header_bits_;
+  mutable int _loop_header_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > cfi_bits_;
+  mutable int _cfi_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > pinned_bits_;
+  mutable int _pinned_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > chain_start_bits_;
+  mutable int _chain_start_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > edge_prob_bits_;
+  mutable int _edge_prob_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > function_name_hash_;
+  mutable int _function_name_hash_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > function_content_hash_;
+  mutable int _function_content_hash_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > term_bits_;
+  mutable int _term_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > boundary_;
+  mutable int _boundary_cached_byte_size_;
   friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
   friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
   friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
@@ -756,45 +1418,51 @@ class ReorderInfo_SourceInfo : public ::google::protobuf::Message /* @@protoc_in
 };
 // -------------------------------------------------------------------
 
-class ReorderInfo : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo) */ {
+class ReorderInfo_FixupColumns : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.FixupColumns) */ {
  public:
-  ReorderInfo();
-  virtual ~ReorderInfo();
+  ReorderInfo_FixupColumns();
+  virtual ~ReorderInfo_FixupColumns();
 
-  ReorderInfo(const ReorderInfo& from);
+  ReorderInfo_FixupColumns(const ReorderInfo_FixupColumns& from);
 
-  inline ReorderInfo& operator=(const ReorderInfo& from) {
+  inline ReorderInfo_FixupColumns& operator=(const ReorderInfo_FixupColumns& from) {
     CopyFrom(from);
     return *this;
   }
 
-  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+  inline const ::std::string& unknown_fields() const {
     return _internal_metadata_.unknown_fields();
   }
 
-  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+  inline ::std::string* mutable_unknown_fields() {
     return _internal_metadata_.mutable_unknown_fields();
   }
 
-  static const ::google::protobuf::Descriptor* descriptor();
-  static const ReorderInfo& default_instance();
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
+  static const ReorderInfo_FixupColumns& default_instance();
 
-  static inline const ReorderInfo* internal_default_instance() {
-    return reinterpret_cast<const ReorderInfo*>(
-               &_ReorderInfo_default_instance_);
+  static inline const ReorderInfo_FixupColumns* internal_default_instance() {
+    return reinterpret_cast<const ReorderInfo_FixupColumns*>(
+               &_ReorderInfo_FixupColumns_default_instance_);
   }
 
-  void Swap(ReorderInfo* other);
+  void UnsafeArenaSwap(ReorderInfo_FixupColumns* other);
+  void Swap(ReorderInfo_FixupColumns* other);
 
   // implements Message ----------------------------------------------
 
-  inline ReorderInfo* New() const PROTOBUF_FINAL { return New(NULL); }
+  inline ReorderInfo_FixupColumns* New() const PROTOBUF_FINAL { return New(NULL); }
 
-  ReorderInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
-  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
-  void CopyFrom(const ReorderInfo& from);
-  void MergeFrom(const ReorderInfo& from);
+  ReorderInfo_FixupColumns* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
+  void CopyFrom(const ReorderInfo_FixupColumns& from);
+  void MergeFrom(const ReorderInfo_FixupColumns& from);
   void Clear() PROTOBUF_FINAL;
   bool IsInitialized() const PROTOBUF_FINAL;
 
@@ -803,728 +1471,4252 @@ class ReorderInfo : public ::google::protobuf::Message /* @@protoc_insertion_poi
       ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
-      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
-  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output)
-      const PROTOBUF_FINAL {
-    return InternalSerializeWithCachedSizesToArray(false, output);
-  }
+  void DiscardUnknownFields();
   int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
-  void SetCachedSize(int size) const PROTOBUF_FINAL;
-  void InternalSwap(ReorderInfo* other);
+  void SetCachedSize(int size) const;
+  void InternalSwap(ReorderInfo_FixupColumns* other);
+  protected:
+  explicit ReorderInfo_FixupColumns(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
   private:
   inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
-    return NULL;
+    return _internal_metadata_.arena();
   }
   inline void* MaybeArenaPtr() const {
-    return NULL;
+    return _internal_metadata_.raw_arena_ptr();
   }
   public:
 
-  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
 
   // nested types ----------------------------------------------------
 
-  typedef ReorderInfo_BinaryInfo BinaryInfo;
-  typedef ReorderInfo_LayoutInfo LayoutInfo;
-  typedef ReorderInfo_FixupInfo FixupInfo;
-  typedef ReorderInfo_SourceInfo SourceInfo;
-
   // accessors -------------------------------------------------------
 
-  // optional .ShuffleInfo.ReorderInfo.BinaryInfo bin = 1;
-  bool has_bin() const;
-  void clear_bin();
-  static const int kBinFieldNumber = 1;
-  const ::ShuffleInfo::ReorderInfo_BinaryInfo& bin() const;
-  ::ShuffleInfo::ReorderInfo_BinaryInfo* mutable_bin();
-  ::ShuffleInfo::ReorderInfo_BinaryInfo* release_bin();
-  void set_allocated_bin(::ShuffleInfo::ReorderInfo_BinaryInfo* bin);
-
-  // repeated .ShuffleInfo.ReorderInfo.LayoutInfo layout = 2;
-  int layout_size() const;
-  void clear_layout();
-  static const int kLayoutFieldNumber = 2;
-  const ::ShuffleInfo::ReorderInfo_LayoutInfo& layout(int index) const;
-  ::ShuffleInfo::ReorderInfo_LayoutInfo* mutable_layout(int index);
-  ::ShuffleInfo::ReorderInfo_LayoutInfo* add_layout();
-  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_LayoutInfo >*
-      mutable_layout();
-  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_LayoutInfo >&
-      layout() const;
-
-  // repeated .ShuffleInfo.ReorderInfo.FixupInfo fixup = 3;
-  int fixup_size() const;
-  void clear_fixup();
-  static const int kFixupFieldNumber = 3;
-  const ::ShuffleInfo::ReorderInfo_FixupInfo& fixup(int index) const;
-  ::ShuffleInfo::ReorderInfo_FixupInfo* mutable_fixup(int index);
-  ::ShuffleInfo::ReorderInfo_FixupInfo* add_fixup();
-  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo >*
-      mutable_fixup();
-  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo >&
-      fixup() const;
+  // repeated sint64 offset_delta = 1 [packed = true];
+  int offset_delta_size() const;
+  void clear_offset_delta();
+  static const int kOffsetDeltaFieldNumber = 1;
+  ::google::protobuf::int64 offset_delta(int index) const;
+  void set_offset_delta(int index, ::google::protobuf::int64 value);
+  void add_offset_delta(::google::protobuf::int64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+      offset_delta() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+      mutable_offset_delta();
+
+  // repeated uint32 deref_sz = 2 [packed = true];
+  int deref_sz_size() const;
+  void clear_deref_sz();
+  static const int kDerefSzFieldNumber = 2;
+  ::google::protobuf::uint32 deref_sz(int index) const;
+  void set_deref_sz(int index, ::google::protobuf::uint32 value);
+  void add_deref_sz(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      deref_sz() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_deref_sz();
+
+  // repeated uint64 is_rela_bits = 3 [packed = true];
+  int is_rela_bits_size() const;
+  void clear_is_rela_bits();
+  static const int kIsRelaBitsFieldNumber = 3;
+  ::google::protobuf::uint64 is_rela_bits(int index) const;
+  void set_is_rela_bits(int index, ::google::protobuf::uint64 value);
+  void add_is_rela_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      is_rela_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_is_rela_bits();
+
+  // repeated uint64 new_section_bits = 4 [packed = true];
+  int new_section_bits_size() const;
+  void clear_new_section_bits();
+  static const int kNewSectionBitsFieldNumber = 4;
+  ::google::protobuf::uint64 new_section_bits(int index) const;
+  void set_new_section_bits(int index, ::google::protobuf::uint64 value);
+  void add_new_section_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      new_section_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_new_section_bits();
+
+  // repeated uint32 section_idx = 5 [packed = true];
+  int section_idx_size() const;
+  void clear_section_idx();
+  static const int kSectionIdxFieldNumber = 5;
+  ::google::protobuf::uint32 section_idx(int index) const;
+  void set_section_idx(int index, ::google::protobuf::uint32 value);
+  void add_section_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      section_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_section_idx();
+
+  // repeated uint32 jt_fixup_idx = 6 [packed = true];
+  int jt_fixup_idx_size() const;
+  void clear_jt_fixup_idx();
+  static const int kJtFixupIdxFieldNumber = 6;
+  ::google::protobuf::uint32 jt_fixup_idx(int index) const;
+  void set_jt_fixup_idx(int index, ::google::protobuf::uint32 value);
+  void add_jt_fixup_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      jt_fixup_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_jt_fixup_idx();
 
-  // optional .ShuffleInfo.ReorderInfo.SourceInfo source = 4;
-  bool has_source() const;
-  void clear_source();
-  static const int kSourceFieldNumber = 4;
-  const ::ShuffleInfo::ReorderInfo_SourceInfo& source() const;
-  ::ShuffleInfo::ReorderInfo_SourceInfo* mutable_source();
-  ::ShuffleInfo::ReorderInfo_SourceInfo* release_source();
-  void set_allocated_source(::ShuffleInfo::ReorderInfo_SourceInfo* source);
+  // repeated uint32 num_jt_entries = 7 [packed = true];
+  int num_jt_entries_size() const;
+  void clear_num_jt_entries();
+  static const int kNumJtEntriesFieldNumber = 7;
+  ::google::protobuf::uint32 num_jt_entries(int index) const;
+  void set_num_jt_entries(int index, ::google::protobuf::uint32 value);
+  void add_num_jt_entries(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      num_jt_entries() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_num_jt_entries();
 
-  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo)
+  // repeated uint32 jt_entry_sz = 8 [packed = true];
+  int jt_entry_sz_size() const;
+  void clear_jt_entry_sz();
+  static const int kJtEntrySzFieldNumber = 8;
+  ::google::protobuf::uint32 jt_entry_sz(int index) const;
+  void set_jt_entry_sz(int index, ::google::protobuf::uint32 value);
+  void add_jt_entry_sz(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      jt_entry_sz() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_jt_entry_sz();
+
+  // repeated uint32 relax_fixup_idx = 9 [packed = true];
+  int relax_fixup_idx_size() const;
+  void clear_relax_fixup_idx();
+  static const int kRelaxFixupIdxFieldNumber = 9;
+  ::google::protobuf::uint32 relax_fixup_idx(int index) const;
+  void set_relax_fixup_idx(int index, ::google::protobuf::uint32 value);
+  void add_relax_fixup_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      relax_fixup_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_relax_fixup_idx();
+
+  // repeated uint32 relax_short_sz = 10 [packed = true];
+  int relax_short_sz_size() const;
+  void clear_relax_short_sz();
+  static const int kRelaxShortSzFieldNumber = 10;
+  ::google::protobuf::uint32 relax_short_sz(int index) const;
+  void set_relax_short_sz(int index, ::google::protobuf::uint32 value);
+  void add_relax_short_sz(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      relax_short_sz() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_relax_short_sz();
+
+  // repeated bytes relax_long_form = 11;
+  int relax_long_form_size() const;
+  void clear_relax_long_form();
+  static const int kRelaxLongFormFieldNumber = 11;
+  const ::std::string& relax_long_form(int index) const;
+  ::std::string* mutable_relax_long_form(int index);
+  void set_relax_long_form(int index, const ::std::string& value);
+  void set_relax_long_form(int index, const char* value);
+  void set_relax_long_form(int index, const void* value, size_t size);
+  ::std::string* add_relax_long_form();
+  void add_relax_long_form(const ::std::string& value);
+  void add_relax_long_form(const char* value);
+  void add_relax_long_form(const void* value, size_t size);
+  const ::google::protobuf::RepeatedPtrField< ::std::string>& relax_long_form() const;
+  ::google::protobuf::RepeatedPtrField< ::std::string>* mutable_relax_long_form();
+
+  // repeated uint32 relax_fixup_offset = 12 [packed = true];
+  int relax_fixup_offset_size() const;
+  void clear_relax_fixup_offset();
+  static const int kRelaxFixupOffsetFieldNumber = 12;
+  ::google::protobuf::uint32 relax_fixup_offset(int index) const;
+  void set_relax_fixup_offset(int index, ::google::protobuf::uint32 value);
+  void add_relax_fixup_offset(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      relax_fixup_offset() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_relax_fixup_offset();
+
+  // repeated uint64 target_bits = 13 [packed = true];
+  int target_bits_size() const;
+  void clear_target_bits();
+  static const int kTargetBitsFieldNumber = 13;
+  ::google::protobuf::uint64 target_bits(int index) const;
+  void set_target_bits(int index, ::google::protobuf::uint64 value);
+  void add_target_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      target_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_target_bits();
+
+  // repeated uint32 reach_fixup_idx = 14 [packed = true];
+  int reach_fixup_idx_size() const;
+  void clear_reach_fixup_idx();
+  static const int kReachFixupIdxFieldNumber = 14;
+  ::google::protobuf::uint32 reach_fixup_idx(int index) const;
+  void set_reach_fixup_idx(int index, ::google::protobuf::uint32 value);
+  void add_reach_fixup_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      reach_fixup_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_reach_fixup_idx();
+
+  // repeated uint32 reach_log2 = 15 [packed = true];
+  int reach_log2_size() const;
+  void clear_reach_log2();
+  static const int kReachLog2FieldNumber = 15;
+  ::google::protobuf::uint32 reach_log2(int index) const;
+  void set_reach_log2(int index, ::google::protobuf::uint32 value);
+  void add_reach_log2(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      reach_log2() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_reach_log2();
+
+  // repeated uint64 ref_class_bits = 16 [packed = true];
+  int ref_class_bits_size() const;
+  void clear_ref_class_bits();
+  static const int kRefClassBitsFieldNumber = 16;
+  ::google::protobuf::uint64 ref_class_bits(int index) const;
+  void set_ref_class_bits(int index, ::google::protobuf::uint64 value);
+  void add_ref_class_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      ref_class_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_ref_class_bits();
+
+  // repeated uint64 jt_func_rel_bits = 17 [packed = true];
+  int jt_func_rel_bits_size() const;
+  void clear_jt_func_rel_bits();
+  static const int kJtFuncRelBitsFieldNumber = 17;
+  ::google::protobuf::uint64 jt_func_rel_bits(int index) const;
+  void set_jt_func_rel_bits(int index, ::google::protobuf::uint64 value);
+  void add_jt_func_rel_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      jt_func_rel_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_jt_func_rel_bits();
+
+  // repeated uint64 scope_bits = 18 [packed = true];
+  int scope_bits_size() const;
+  void clear_scope_bits();
+  static const int kScopeBitsFieldNumber = 18;
+  ::google::protobuf::uint64 scope_bits(int index) const;
+  void set_scope_bits(int index, ::google::protobuf::uint64 value);
+  void add_scope_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      scope_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_scope_bits();
+
+  // repeated uint32 pair_fixup_idx = 19 [packed = true];
+  int pair_fixup_idx_size() const;
+  void clear_pair_fixup_idx();
+  static const int kPairFixupIdxFieldNumber = 19;
+  ::google::protobuf::uint32 pair_fixup_idx(int index) const;
+  void set_pair_fixup_idx(int index, ::google::protobuf::uint32 value);
+  void add_pair_fixup_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      pair_fixup_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_pair_fixup_idx();
+
+  // repeated uint32 pair_delta = 20 [packed = true];
+  int pair_delta_size() const;
+  void clear_pair_delta();
+  static const int kPairDeltaFieldNumber = 20;
+  ::google::protobuf::uint32 pair_delta(int index) const;
+  void set_pair_delta(int index, ::google::protobuf::uint32 value);
+  void add_pair_delta(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      pair_delta() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_pair_delta();
+
+  // repeated uint32 shrink_fixup_idx = 21 [packed = true];
+  int shrink_fixup_idx_size() const;
+  void clear_shrink_fixup_idx();
+  static const int kShrinkFixupIdxFieldNumber = 21;
+  ::google::protobuf::uint32 shrink_fixup_idx(int index) const;
+  void set_shrink_fixup_idx(int index, ::google::protobuf::uint32 value);
+  void add_shrink_fixup_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      shrink_fixup_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_shrink_fixup_idx();
+
+  // repeated uint32 shrink_long_sz = 22 [packed = true];
+  int shrink_long_sz_size() const;
+  void clear_shrink_long_sz();
+  static const int kShrinkLongSzFieldNumber = 22;
+  ::google::protobuf::uint32 shrink_long_sz(int index) const;
+  void set_shrink_long_sz(int index, ::google::protobuf::uint32 value);
+  void add_shrink_long_sz(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      shrink_long_sz() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_shrink_long_sz();
+
+  // repeated bytes shrink_short_form = 23;
+  int shrink_short_form_size() const;
+  void clear_shrink_short_form();
+  static const int kShrinkShortFormFieldNumber = 23;
+  const ::std::string& shrink_short_form(int index) const;
+  ::std::string* mutable_shrink_short_form(int index);
+  void set_shrink_short_form(int index, const ::std::string& value);
+  void set_shrink_short_form(int index, const char* value);
+  void set_shrink_short_form(int index, const void* value, size_t size);
+  ::std::string* add_shrink_short_form();
+  void add_shrink_short_form(const ::std::string& value);
+  void add_shrink_short_form(const char* value);
+  void add_shrink_short_form(const void* value, size_t size);
+  const ::google::protobuf::RepeatedPtrField< ::std::string>& shrink_short_form() const;
+  ::google::protobuf::RepeatedPtrField< ::std::string>* mutable_shrink_short_form();
+
+  // repeated uint32 reloc_delta = 24 [packed = true];
+  int reloc_delta_size() const;
+  void clear_reloc_delta();
+  static const int kRelocDeltaFieldNumber = 24;
+  ::google::protobuf::uint32 reloc_delta(int index) const;
+  void set_reloc_delta(int index, ::google::protobuf::uint32 value);
+  void add_reloc_delta(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      reloc_delta() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_reloc_delta();
+
+  // repeated uint64 got_relax_bits = 25 [packed = true];
+  int got_relax_bits_size() const;
+  void clear_got_relax_bits();
+  static const int kGotRelaxBitsFieldNumber = 25;
+  ::google::protobuf::uint64 got_relax_bits(int index) const;
+  void set_got_relax_bits(int index, ::google::protobuf::uint64 value);
+  void add_got_relax_bits(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      got_relax_bits() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_got_relax_bits();
+
+  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.FixupColumns)
  private:
-  void set_has_bin();
-  void clear_has_bin();
-  void set_has_source();
-  void clear_has_source();
 
-  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
-  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_LayoutInfo > layout_;
-  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo > fixup_;
-  ::ShuffleInfo::ReorderInfo_BinaryInfo* bin_;
-  ::ShuffleInfo::ReorderInfo_SourceInfo* source_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::int64 > offset_delta_;
+  mutable int _offset_delta_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > deref_sz_;
+  mutable int _deref_sz_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > is_rela_bits_;
+  mutable int _is_rela_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > new_section_bits_;
+  mutable int _new_section_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > section_idx_;
+  mutable int _section_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > jt_fixup_idx_;
+  mutable int _jt_fixup_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > num_jt_entries_;
+  mutable int _num_jt_entries_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > jt_entry_sz_;
+  mutable int _jt_entry_sz_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > relax_fixup_idx_;
+  mutable int _relax_fixup_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > relax_short_sz_;
+  mutable int _relax_short_sz_cached_byte_size_;
+  ::google::protobuf::RepeatedPtrField< ::std::string> relax_long_form_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > relax_fixup_offset_;
+  mutable int _relax_fixup_offset_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > target_bits_;
+  mutable int _target_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > reach_fixup_idx_;
+  mutable int _reach_fixup_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > reach_log2_;
+  mutable int _reach_log2_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > ref_class_bits_;
+  mutable int _ref_class_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > jt_func_rel_bits_;
+  mutable int _jt_func_rel_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > scope_bits_;
+  mutable int _scope_bits_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > pair_fixup_idx_;
+  mutable int _pair_fixup_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > pair_delta_;
+  mutable int _pair_delta_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > shrink_fixup_idx_;
+  mutable int _shrink_fixup_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > shrink_long_sz_;
+  mutable int _shrink_long_sz_cached_byte_size_;
+  ::google::protobuf::RepeatedPtrField< ::std::string> shrink_short_form_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > reloc_delta_;
+  mutable int _reloc_delta_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > got_relax_bits_;
+  mutable int _got_relax_bits_cached_byte_size_;
   friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
   friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
   friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
   friend void protobuf_ShutdownFile_shuffleInfo_2eproto();
 
 };
-// ===================================================================
+// -------------------------------------------------------------------
 
+class ReorderInfo_CallSiteColumns : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.CallSiteColumns) */ {
+ public:
+  ReorderInfo_CallSiteColumns();
+  virtual ~ReorderInfo_CallSiteColumns();
 
-// ===================================================================
+  ReorderInfo_CallSiteColumns(const ReorderInfo_CallSiteColumns& from);
 
-#if !PROTOBUF_INLINE_NOT_IN_HEADERS
-// ReorderInfo_BinaryInfo
+  inline ReorderInfo_CallSiteColumns& operator=(const ReorderInfo_CallSiteColumns& from) {
+    CopyFrom(from);
+    return *this;
+  }
 
-// optional uint32 rand_obj_offset = 1;
-inline bool ReorderInfo_BinaryInfo::has_rand_obj_offset() const {
-  return (_has_bits_[0] & 0x00000001u) != 0;
-}
-inline void ReorderInfo_BinaryInfo::set_has_rand_obj_offset() {
-  _has_bits_[0] |= 0x00000001u;
-}
-inline void ReorderInfo_BinaryInfo::clear_has_rand_obj_offset() {
-  _has_bits_[0] &= ~0x00000001u;
-}
-inline void ReorderInfo_BinaryInfo::clear_rand_obj_offset() {
-  rand_obj_offset_ = 0u;
-  clear_has_rand_obj_offset();
-}
-inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::rand_obj_offset() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.rand_obj_offset)
-  return rand_obj_offset_;
-}
-inline void ReorderInfo_BinaryInfo::set_rand_obj_offset(::google::protobuf::uint32 value) {
-  set_has_rand_obj_offset();
-  rand_obj_offset_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.rand_obj_offset)
-}
+  inline const ::std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
 
-// optional uint32 main_addr_offset = 2;
-inline bool ReorderInfo_BinaryInfo::has_main_addr_offset() const {
-  return (_has_bits_[0] & 0x00000002u) != 0;
-}
-inline void ReorderInfo_BinaryInfo::set_has_main_addr_offset() {
-  _has_bits_[0] |= 0x00000002u;
-}
-inline void ReorderInfo_BinaryInfo::clear_has_main_addr_offset() {
-  _has_bits_[0] &= ~0x00000002u;
-}
-inline void ReorderInfo_BinaryInfo::clear_main_addr_offset() {
-  main_addr_offset_ = 0u;
-  clear_has_main_addr_offset();
-}
-inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::main_addr_offset() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.main_addr_offset)
-  return main_addr_offset_;
-}
-inline void ReorderInfo_BinaryInfo::set_main_addr_offset(::google::protobuf::uint32 value) {
-  set_has_main_addr_offset();
-  main_addr_offset_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.main_addr_offset)
-}
+  inline ::std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
 
-// optional uint32 obj_sz = 3;
-inline bool ReorderInfo_BinaryInfo::has_obj_sz() const {
-  return (_has_bits_[0] & 0x00000004u) != 0;
-}
-inline void ReorderInfo_BinaryInfo::set_has_obj_sz() {
-  _has_bits_[0] |= 0x00000004u;
-}
-inline void ReorderInfo_BinaryInfo::clear_has_obj_sz() {
-  _has_bits_[0] &= ~0x00000004u;
-}
-inline void ReorderInfo_BinaryInfo::clear_obj_sz() {
-  obj_sz_ = 0u;
-  clear_has_obj_sz();
-}
-inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::obj_sz() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.obj_sz)
-  return obj_sz_;
-}
-inline void ReorderInfo_BinaryInfo::set_obj_sz(::google::protobuf::uint32 value) {
-  set_has_obj_sz();
-  obj_sz_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.obj_sz)
-}
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
+  static const ReorderInfo_CallSiteColumns& default_instance();
 
-// optional uint32 src_type = 4;
-inline bool ReorderInfo_BinaryInfo::has_src_type() const {
-  return (_has_bits_[0] & 0x00000008u) != 0;
+  static inline const ReorderInfo_CallSiteColumns* internal_default_instance() {
+    return reinterpret_cast<const ReorderInfo_CallSiteColumns*>(
+               &_ReorderInfo_CallSiteColumns_default_instance_);
+  }
+
+  void UnsafeArenaSwap(ReorderInfo_CallSiteColumns* other);
+  void Swap(ReorderInfo_CallSiteColumns* other);
+
+  // implements Message ----------------------------------------------
+
+  inline ReorderInfo_CallSiteColumns* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  ReorderInfo_CallSiteColumns* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
+  void CopyFrom(const ReorderInfo_CallSiteColumns& from);
+  void MergeFrom(const ReorderInfo_CallSiteColumns& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  void DiscardUnknownFields();
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(ReorderInfo_CallSiteColumns* other);
+  protected:
+  explicit ReorderInfo_CallSiteColumns(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated uint64 function_offset = 1 [packed = true];
+  int function_offset_size() const;
+  void clear_function_offset();
+  static const int kFunctionOffsetFieldNumber = 1;
+  ::google::protobuf::uint64 function_offset(int index) const;
+  void set_function_offset(int index, ::google::protobuf::uint64 value);
+  void add_function_offset(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      function_offset() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_function_offset();
+
+  // repeated uint32 function_section_idx = 2 [packed = true];
+  int function_section_idx_size() const;
+  void clear_function_section_idx();
+  static const int kFunctionSectionIdxFieldNumber = 2;
+  ::google::protobuf::uint32 function_section_idx(int index) const;
+  void set_function_section_idx(int index, ::google::protobuf::uint32 value);
+  void add_function_section_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      function_section_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_function_section_idx();
+
+  // repeated uint64 table_offset = 3 [packed = true];
+  int table_offset_size() const;
+  void clear_table_offset();
+  static const int kTableOffsetFieldNumber = 3;
+  ::google::protobuf::uint64 table_offset(int index) const;
+  void set_table_offset(int index, ::google::protobuf::uint64 value);
+  void add_table_offset(::google::protobuf::uint64 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+      table_offset() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+      mutable_table_offset();
+
+  // repeated uint32 table_section_idx = 4 [packed = true];
+  int table_section_idx_size() const;
+  void clear_table_section_idx();
+  static const int kTableSectionIdxFieldNumber = 4;
+  ::google::protobuf::uint32 table_section_idx(int index) const;
+  void set_table_section_idx(int index, ::google::protobuf::uint32 value);
+  void add_table_section_idx(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      table_section_idx() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_table_section_idx();
+
+  // repeated uint32 num_records = 5 [packed = true];
+  int num_records_size() const;
+  void clear_num_records();
+  static const int kNumRecordsFieldNumber = 5;
+  ::google::protobuf::uint32 num_records(int index) const;
+  void set_num_records(int index, ::google::protobuf::uint32 value);
+  void add_num_records(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      num_records() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_num_records();
+
+  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.CallSiteColumns)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::google::protobuf::internal::HasBits<1> _has_bits_;
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > function_offset_;
+  mutable int _function_offset_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > function_section_idx_;
+  mutable int _function_section_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint64 > table_offset_;
+  mutable int _table_offset_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > table_section_idx_;
+  mutable int _table_section_idx_cached_byte_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > num_records_;
+  mutable int _num_records_cached_byte_size_;
+  friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
+  friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
+  friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
+  friend void protobuf_ShutdownFile_shuffleInfo_2eproto();
+
+};
+// -------------------------------------------------------------------
+
+class ReorderInfo_SourceInfo : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo.SourceInfo) */ {
+ public:
+  ReorderInfo_SourceInfo();
+  virtual ~ReorderInfo_SourceInfo();
+
+  ReorderInfo_SourceInfo(const ReorderInfo_SourceInfo& from);
+
+  inline ReorderInfo_SourceInfo& operator=(const ReorderInfo_SourceInfo& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+
+  inline ::std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
+  static const ReorderInfo_SourceInfo& default_instance();
+
+  static inline const ReorderInfo_SourceInfo* internal_default_instance() {
+    return reinterpret_cast<const ReorderInfo_SourceInfo*>(
+               &_ReorderInfo_SourceInfo_default_instance_);
+  }
+
+  void UnsafeArenaSwap(ReorderInfo_SourceInfo* other);
+  void Swap(ReorderInfo_SourceInfo* other);
+
+  // implements Message ----------------------------------------------
+
+  inline ReorderInfo_SourceInfo* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  ReorderInfo_SourceInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
+  void CopyFrom(const ReorderInfo_SourceInfo& from);
+  void MergeFrom(const ReorderInfo_SourceInfo& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  void DiscardUnknownFields();
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(ReorderInfo_SourceInfo* other);
+  protected:
+  explicit ReorderInfo_SourceInfo(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated uint32 src_type = 1;
+  int src_type_size() const;
+  void clear_src_type();
+  static const int kSrcTypeFieldNumber = 1;
+  ::google::protobuf::uint32 src_type(int index) const;
+  void set_src_type(int index, ::google::protobuf::uint32 value);
+  void add_src_type(::google::protobuf::uint32 value);
+  const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+      src_type() const;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+      mutable_src_type();
+
+  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo.SourceInfo)
+ private:
+
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::google::protobuf::internal::HasBits<1> _has_bits_;
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedField< ::google::protobuf::uint32 > src_type_;
+  friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
+  friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
+  friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
+  friend void protobuf_ShutdownFile_shuffleInfo_2eproto();
+
+};
+// -------------------------------------------------------------------
+
+class ReorderInfo : public ::google::protobuf::MessageLite /* @@protoc_insertion_point(class_definition:ShuffleInfo.ReorderInfo) */ {
+ public:
+  ReorderInfo();
+  virtual ~ReorderInfo();
+
+  ReorderInfo(const ReorderInfo& from);
+
+  inline ReorderInfo& operator=(const ReorderInfo& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+
+  inline ::std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  inline ::google::protobuf::Arena* GetArena() const PROTOBUF_FINAL {
+    return GetArenaNoVirtual();
+  }
+  inline void* GetMaybeArenaPointer() const PROTOBUF_FINAL {
+    return MaybeArenaPtr();
+  }
+  static const ReorderInfo& default_instance();
+
+  static inline const ReorderInfo* internal_default_instance() {
+    return reinterpret_cast<const ReorderInfo*>(
+               &_ReorderInfo_default_instance_);
+  }
+
+  void UnsafeArenaSwap(ReorderInfo* other);
+  void Swap(ReorderInfo* other);
+
+  // implements Message ----------------------------------------------
+
+  inline ReorderInfo* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  ReorderInfo* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CheckTypeAndMergeFrom(const ::google::protobuf::MessageLite& from)
+    PROTOBUF_FINAL;
+  void CopyFrom(const ReorderInfo& from);
+  void MergeFrom(const ReorderInfo& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  void DiscardUnknownFields();
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(ReorderInfo* other);
+  protected:
+  explicit ReorderInfo(::google::protobuf::Arena* arena);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::google::protobuf::Arena* arena);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return _internal_metadata_.arena();
+  }
+  inline void* MaybeArenaPtr() const {
+    return _internal_metadata_.raw_arena_ptr();
+  }
+  public:
+
+  ::std::string GetTypeName() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  typedef ReorderInfo_BinaryInfo BinaryInfo;
+  typedef ReorderInfo_LayoutInfo LayoutInfo;
+  typedef ReorderInfo_FixupInfo FixupInfo;
+  typedef ReorderInfo_LayoutColumns LayoutColumns;
+  typedef ReorderInfo_FixupColumns FixupColumns;
+  typedef ReorderInfo_CallSiteColumns CallSiteColumns;
+  typedef ReorderInfo_SourceInfo SourceInfo;
+
+  // accessors -------------------------------------------------------
+
+  // optional .ShuffleInfo.ReorderInfo.BinaryInfo bin = 1;
+  bool has_bin() const;
+  void clear_bin();
+  static const int kBinFieldNumber = 1;
+  private:
+  void _slow_mutable_bin();
+  void _slow_set_allocated_bin(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_BinaryInfo** bin);
+  ::ShuffleInfo::ReorderInfo_BinaryInfo* _slow_release_bin();
+  public:
+  const ::ShuffleInfo::ReorderInfo_BinaryInfo& bin() const;
+  ::ShuffleInfo::ReorderInfo_BinaryInfo* mutable_bin();
+  ::ShuffleInfo::ReorderInfo_BinaryInfo* release_bin();
+  void set_allocated_bin(::ShuffleInfo::ReorderInfo_BinaryInfo* bin);
+  ::ShuffleInfo::ReorderInfo_BinaryInfo* unsafe_arena_release_bin();
+  void unsafe_arena_set_allocated_bin(
+      ::ShuffleInfo::ReorderInfo_BinaryInfo* bin);
+
+  // repeated .ShuffleInfo.ReorderInfo.LayoutInfo layout = 2;
+  int layout_size() const;
+  void clear_layout();
+  static const int kLayoutFieldNumber = 2;
+  const ::ShuffleInfo::ReorderInfo_LayoutInfo& layout(int index) const;
+  ::ShuffleInfo::ReorderInfo_LayoutInfo* mutable_layout(int index);
+  ::ShuffleInfo::ReorderInfo_LayoutInfo* add_layout();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_LayoutInfo >*
+      mutable_layout();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_LayoutInfo >&
+      layout() const;
+
+  // repeated .ShuffleInfo.ReorderInfo.FixupInfo fixup = 3;
+  int fixup_size() const;
+  void clear_fixup();
+  static const int kFixupFieldNumber = 3;
+  const ::ShuffleInfo::ReorderInfo_FixupInfo& fixup(int index) const;
+  ::ShuffleInfo::ReorderInfo_FixupInfo* mutable_fixup(int index);
+  ::ShuffleInfo::ReorderInfo_FixupInfo* add_fixup();
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo >*
+      mutable_fixup();
+  const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo >&
+      fixup() const;
+
+  // optional .ShuffleInfo.ReorderInfo.SourceInfo source = 4;
+  bool has_source() const;
+  void clear_source();
+  static const int kSourceFieldNumber = 4;
+  private:
+  void _slow_mutable_source();
+  void _slow_set_allocated_source(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_SourceInfo** source);
+  ::ShuffleInfo::ReorderInfo_SourceInfo* _slow_release_source();
+  public:
+  const ::ShuffleInfo::ReorderInfo_SourceInfo& source() const;
+  ::ShuffleInfo::ReorderInfo_SourceInfo* mutable_source();
+  ::ShuffleInfo::ReorderInfo_SourceInfo* release_source();
+  void set_allocated_source(::ShuffleInfo::ReorderInfo_SourceInfo* source);
+  ::ShuffleInfo::ReorderInfo_SourceInfo* unsafe_arena_release_source();
+  void unsafe_arena_set_allocated_source(
+      ::ShuffleInfo::ReorderInfo_SourceInfo* source);
+
+  // repeated string section_names = 5;
+  int section_names_size() const;
+  void clear_section_names();
+  static const int kSectionNamesFieldNumber = 5;
+  const ::std::string& section_names(int index) const;
+  ::std::string* mutable_section_names(int index);
+  void set_section_names(int index, const ::std::string& value);
+  void set_section_names(int index, const char* value);
+  void set_section_names(int index, const char* value, size_t size);
+  ::std::string* add_section_names();
+  void add_section_names(const ::std::string& value);
+  void add_section_names(const char* value);
+  void add_section_names(const char* value, size_t size);
+  const ::google::protobuf::RepeatedPtrField< ::std::string>& section_names() const;
+  ::google::protobuf::RepeatedPtrField< ::std::string>* mutable_section_names();
+
+  // optional .ShuffleInfo.ReorderInfo.LayoutColumns layout_columns = 6;
+  bool has_layout_columns() const;
+  void clear_layout_columns();
+  static const int kLayoutColumnsFieldNumber = 6;
+  private:
+  void _slow_mutable_layout_columns();
+  void _slow_set_allocated_layout_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_LayoutColumns** layout_columns);
+  ::ShuffleInfo::ReorderInfo_LayoutColumns* _slow_release_layout_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_LayoutColumns& layout_columns() const;
+  ::ShuffleInfo::ReorderInfo_LayoutColumns* mutable_layout_columns();
+  ::ShuffleInfo::ReorderInfo_LayoutColumns* release_layout_columns();
+  void set_allocated_layout_columns(::ShuffleInfo::ReorderInfo_LayoutColumns* layout_columns);
+  ::ShuffleInfo::ReorderInfo_LayoutColumns* unsafe_arena_release_layout_columns();
+  void unsafe_arena_set_allocated_layout_columns(
+      ::ShuffleInfo::ReorderInfo_LayoutColumns* layout_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns text_fixup_columns = 7;
+  bool has_text_fixup_columns() const;
+  void clear_text_fixup_columns();
+  static const int kTextFixupColumnsFieldNumber = 7;
+  private:
+  void _slow_mutable_text_fixup_columns();
+  void _slow_set_allocated_text_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** text_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_text_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& text_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_text_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_text_fixup_columns();
+  void set_allocated_text_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* text_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_text_fixup_columns();
+  void unsafe_arena_set_allocated_text_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* text_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns rodata_fixup_columns = 8;
+  bool has_rodata_fixup_columns() const;
+  void clear_rodata_fixup_columns();
+  static const int kRodataFixupColumnsFieldNumber = 8;
+  private:
+  void _slow_mutable_rodata_fixup_columns();
+  void _slow_set_allocated_rodata_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** rodata_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_rodata_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& rodata_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_rodata_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_rodata_fixup_columns();
+  void set_allocated_rodata_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* rodata_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_rodata_fixup_columns();
+  void unsafe_arena_set_allocated_rodata_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* rodata_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns data_fixup_columns = 9;
+  bool has_data_fixup_columns() const;
+  void clear_data_fixup_columns();
+  static const int kDataFixupColumnsFieldNumber = 9;
+  private:
+  void _slow_mutable_data_fixup_columns();
+  void _slow_set_allocated_data_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** data_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_data_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& data_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_data_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_data_fixup_columns();
+  void set_allocated_data_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* data_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_data_fixup_columns();
+  void unsafe_arena_set_allocated_data_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* data_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns datarel_fixup_columns = 10;
+  bool has_datarel_fixup_columns() const;
+  void clear_datarel_fixup_columns();
+  static const int kDatarelFixupColumnsFieldNumber = 10;
+  private:
+  void _slow_mutable_datarel_fixup_columns();
+  void _slow_set_allocated_datarel_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** datarel_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_datarel_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& datarel_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_datarel_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_datarel_fixup_columns();
+  void set_allocated_datarel_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* datarel_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_datarel_fixup_columns();
+  void unsafe_arena_set_allocated_datarel_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* datarel_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns initarray_fixup_columns = 11;
+  bool has_initarray_fixup_columns() const;
+  void clear_initarray_fixup_columns();
+  static const int kInitarrayFixupColumnsFieldNumber = 11;
+  private:
+  void _slow_mutable_initarray_fixup_columns();
+  void _slow_set_allocated_initarray_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** initarray_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_initarray_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& initarray_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_initarray_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_initarray_fixup_columns();
+  void set_allocated_initarray_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* initarray_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_initarray_fixup_columns();
+  void unsafe_arena_set_allocated_initarray_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* initarray_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns finiarray_fixup_columns = 12;
+  bool has_finiarray_fixup_columns() const;
+  void clear_finiarray_fixup_columns();
+  static const int kFiniarrayFixupColumnsFieldNumber = 12;
+  private:
+  void _slow_mutable_finiarray_fixup_columns();
+  void _slow_set_allocated_finiarray_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** finiarray_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_finiarray_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& finiarray_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_finiarray_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_finiarray_fixup_columns();
+  void set_allocated_finiarray_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* finiarray_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_finiarray_fixup_columns();
+  void unsafe_arena_set_allocated_finiarray_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* finiarray_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns tdata_fixup_columns = 13;
+  bool has_tdata_fixup_columns() const;
+  void clear_tdata_fixup_columns();
+  static const int kTdataFixupColumnsFieldNumber = 13;
+  private:
+  void _slow_mutable_tdata_fixup_columns();
+  void _slow_set_allocated_tdata_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** tdata_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_tdata_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& tdata_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_tdata_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_tdata_fixup_columns();
+  void set_allocated_tdata_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* tdata_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_tdata_fixup_columns();
+  void unsafe_arena_set_allocated_tdata_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* tdata_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.CallSiteColumns call_site_columns = 14;
+  bool has_call_site_columns() const;
+  void clear_call_site_columns();
+  static const int kCallSiteColumnsFieldNumber = 14;
+  private:
+  void _slow_mutable_call_site_columns();
+  void _slow_set_allocated_call_site_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_CallSiteColumns** call_site_columns);
+  ::ShuffleInfo::ReorderInfo_CallSiteColumns* _slow_release_call_site_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_CallSiteColumns& call_site_columns() const;
+  ::ShuffleInfo::ReorderInfo_CallSiteColumns* mutable_call_site_columns();
+  ::ShuffleInfo::ReorderInfo_CallSiteColumns* release_call_site_columns();
+  void set_allocated_call_site_columns(::ShuffleInfo::ReorderInfo_CallSiteColumns* call_site_columns);
+  ::ShuffleInfo::ReorderInfo_CallSiteColumns* unsafe_arena_release_call_site_columns();
+  void unsafe_arena_set_allocated_call_site_columns(
+      ::ShuffleInfo::ReorderInfo_CallSiteColumns* call_site_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns xray_fixup_columns = 15;
+  bool has_xray_fixup_columns() const;
+  void clear_xray_fixup_columns();
+  static const int kXrayFixupColumnsFieldNumber = 15;
+  private:
+  void _slow_mutable_xray_fixup_columns();
+  void _slow_set_allocated_xray_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** xray_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_xray_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& xray_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_xray_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_xray_fixup_columns();
+  void set_allocated_xray_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* xray_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_xray_fixup_columns();
+  void unsafe_arena_set_allocated_xray_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* xray_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns patchable_fixup_columns = 16;
+  bool has_patchable_fixup_columns() const;
+  void clear_patchable_fixup_columns();
+  static const int kPatchableFixupColumnsFieldNumber = 16;
+  private:
+  void _slow_mutable_patchable_fixup_columns();
+  void _slow_set_allocated_patchable_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** patchable_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_patchable_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& patchable_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_patchable_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_patchable_fixup_columns();
+  void set_allocated_patchable_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* patchable_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_patchable_fixup_columns();
+  void unsafe_arena_set_allocated_patchable_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* patchable_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns jumptable_fixup_columns = 17;
+  bool has_jumptable_fixup_columns() const;
+  void clear_jumptable_fixup_columns();
+  static const int kJumptableFixupColumnsFieldNumber = 17;
+  private:
+  void _slow_mutable_jumptable_fixup_columns();
+  void _slow_set_allocated_jumptable_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** jumptable_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_jumptable_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& jumptable_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_jumptable_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_jumptable_fixup_columns();
+  void set_allocated_jumptable_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* jumptable_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_jumptable_fixup_columns();
+  void unsafe_arena_set_allocated_jumptable_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* jumptable_fixup_columns);
+
+  // optional .ShuffleInfo.ReorderInfo.FixupColumns custom_fixup_columns = 18;
+  bool has_custom_fixup_columns() const;
+  void clear_custom_fixup_columns();
+  static const int kCustomFixupColumnsFieldNumber = 18;
+  private:
+  void _slow_mutable_custom_fixup_columns();
+  void _slow_set_allocated_custom_fixup_columns(
+      ::google::protobuf::Arena* message_arena, ::ShuffleInfo::ReorderInfo_FixupColumns** custom_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* _slow_release_custom_fixup_columns();
+  public:
+  const ::ShuffleInfo::ReorderInfo_FixupColumns& custom_fixup_columns() const;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* mutable_custom_fixup_columns();
+  ::ShuffleInfo::ReorderInfo_FixupColumns* release_custom_fixup_columns();
+  void set_allocated_custom_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* custom_fixup_columns);
+  ::ShuffleInfo::ReorderInfo_FixupColumns* unsafe_arena_release_custom_fixup_columns();
+  void unsafe_arena_set_allocated_custom_fixup_columns(
+      ::ShuffleInfo::ReorderInfo_FixupColumns* custom_fixup_columns);
+
+  // @@protoc_insertion_point(class_scope:ShuffleInfo.ReorderInfo)
+ private:
+  void set_has_bin();
+  void clear_has_bin();
+  void set_has_source();
+  void clear_has_source();
+  void set_has_layout_columns();
+  void clear_has_layout_columns();
+  void set_has_text_fixup_columns();
+  void clear_has_text_fixup_columns();
+  void set_has_rodata_fixup_columns();
+  void clear_has_rodata_fixup_columns();
+  void set_has_data_fixup_columns();
+  void clear_has_data_fixup_columns();
+  void set_has_datarel_fixup_columns();
+  void clear_has_datarel_fixup_columns();
+  void set_has_initarray_fixup_columns();
+  void clear_has_initarray_fixup_columns();
+  void set_has_finiarray_fixup_columns();
+  void clear_has_finiarray_fixup_columns();
+  void set_has_tdata_fixup_columns();
+  void clear_has_tdata_fixup_columns();
+  void set_has_call_site_columns();
+  void clear_has_call_site_columns();
+  void set_has_xray_fixup_columns();
+  void clear_has_xray_fixup_columns();
+  void set_has_patchable_fixup_columns();
+  void clear_has_patchable_fixup_columns();
+  void set_has_jumptable_fixup_columns();
+  void clear_has_jumptable_fixup_columns();
+  void set_has_custom_fixup_columns();
+  void clear_has_custom_fixup_columns();
+
+  ::google::protobuf::internal::InternalMetadataWithArenaLite _internal_metadata_;
+  friend class ::google::protobuf::Arena;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::google::protobuf::internal::HasBits<1> _has_bits_;
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_LayoutInfo > layout_;
+  ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo > fixup_;
+  ::google::protobuf::RepeatedPtrField< ::std::string> section_names_;
+  ::ShuffleInfo::ReorderInfo_BinaryInfo* bin_;
+  ::ShuffleInfo::ReorderInfo_SourceInfo* source_;
+  ::ShuffleInfo::ReorderInfo_LayoutColumns* layout_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* text_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* rodata_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* data_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* datarel_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* initarray_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* finiarray_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* tdata_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_CallSiteColumns* call_site_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* xray_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* patchable_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* jumptable_fixup_columns_;
+  ::ShuffleInfo::ReorderInfo_FixupColumns* custom_fixup_columns_;
+  friend void  protobuf_InitDefaults_shuffleInfo_2eproto_impl();
+  friend void  protobuf_AddDesc_shuffleInfo_2eproto_impl();
+  friend const ::google::protobuf::uint32* protobuf_Offsets_shuffleInfo_2eproto();
+  friend void protobuf_ShutdownFile_shuffleInfo_2eproto();
+
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#if !PROTOBUF_INLINE_NOT_IN_HEADERS
+// ReorderInfo_BinaryInfo
+
+// optional uint64 rand_obj_offset = 1;
+inline bool ReorderInfo_BinaryInfo::has_rand_obj_offset() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_rand_obj_offset() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_rand_obj_offset() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void ReorderInfo_BinaryInfo::clear_rand_obj_offset() {
+  rand_obj_offset_ = GOOGLE_ULONGLONG(0);
+  clear_has_rand_obj_offset();
+}
+inline ::google::protobuf::uint64 ReorderInfo_BinaryInfo::rand_obj_offset() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.rand_obj_offset)
+  return rand_obj_offset_;
+}
+inline void ReorderInfo_BinaryInfo::set_rand_obj_offset(::google::protobuf::uint64 value) {
+  set_has_rand_obj_offset();
+  rand_obj_offset_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.rand_obj_offset)
+}
+
+// optional uint64 main_addr_offset = 2;
+inline bool ReorderInfo_BinaryInfo::has_main_addr_offset() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_main_addr_offset() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_main_addr_offset() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void ReorderInfo_BinaryInfo::clear_main_addr_offset() {
+  main_addr_offset_ = GOOGLE_ULONGLONG(0);
+  clear_has_main_addr_offset();
+}
+inline ::google::protobuf::uint64 ReorderInfo_BinaryInfo::main_addr_offset() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.main_addr_offset)
+  return main_addr_offset_;
+}
+inline void ReorderInfo_BinaryInfo::set_main_addr_offset(::google::protobuf::uint64 value) {
+  set_has_main_addr_offset();
+  main_addr_offset_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.main_addr_offset)
+}
+
+// optional uint64 obj_sz = 3;
+inline bool ReorderInfo_BinaryInfo::has_obj_sz() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_obj_sz() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_obj_sz() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void ReorderInfo_BinaryInfo::clear_obj_sz() {
+  obj_sz_ = GOOGLE_ULONGLONG(0);
+  clear_has_obj_sz();
+}
+inline ::google::protobuf::uint64 ReorderInfo_BinaryInfo::obj_sz() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.obj_sz)
+  return obj_sz_;
+}
+inline void ReorderInfo_BinaryInfo::set_obj_sz(::google::protobuf::uint64 value) {
+  set_has_obj_sz();
+  obj_sz_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.obj_sz)
+}
+
+// optional uint32 src_type = 4;
+inline bool ReorderInfo_BinaryInfo::has_src_type() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_src_type() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_src_type() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void ReorderInfo_BinaryInfo::clear_src_type() {
+  src_type_ = 0u;
+  clear_has_src_type();
+}
+inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::src_type() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.src_type)
+  return src_type_;
+}
+inline void ReorderInfo_BinaryInfo::set_src_type(::google::protobuf::uint32 value) {
+  set_has_src_type();
+  src_type_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.src_type)
+}
+
+// optional uint32 fixup_offset_encoding = 5;
+inline bool ReorderInfo_BinaryInfo::has_fixup_offset_encoding() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_fixup_offset_encoding() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_fixup_offset_encoding() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void ReorderInfo_BinaryInfo::clear_fixup_offset_encoding() {
+  fixup_offset_encoding_ = 0u;
+  clear_has_fixup_offset_encoding();
+}
+inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::fixup_offset_encoding() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.fixup_offset_encoding)
+  return fixup_offset_encoding_;
+}
+inline void ReorderInfo_BinaryInfo::set_fixup_offset_encoding(::google::protobuf::uint32 value) {
+  set_has_fixup_offset_encoding();
+  fixup_offset_encoding_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.fixup_offset_encoding)
+}
+
+// optional uint32 format_version = 6;
+inline bool ReorderInfo_BinaryInfo::has_format_version() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_format_version() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_format_version() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void ReorderInfo_BinaryInfo::clear_format_version() {
+  format_version_ = 0u;
+  clear_has_format_version();
+}
+inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::format_version() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.format_version)
+  return format_version_;
+}
+inline void ReorderInfo_BinaryInfo::set_format_version(::google::protobuf::uint32 value) {
+  set_has_format_version();
+  format_version_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.format_version)
+}
+
+// optional bool eh_info = 7;
+inline bool ReorderInfo_BinaryInfo::has_eh_info() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_eh_info() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_eh_info() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void ReorderInfo_BinaryInfo::clear_eh_info() {
+  eh_info_ = false;
+  clear_has_eh_info();
+}
+inline bool ReorderInfo_BinaryInfo::eh_info() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.eh_info)
+  return eh_info_;
+}
+inline void ReorderInfo_BinaryInfo::set_eh_info(bool value) {
+  set_has_eh_info();
+  eh_info_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.eh_info)
+}
+
+// optional bool fixups_from_relocs = 8;
+inline bool ReorderInfo_BinaryInfo::has_fixups_from_relocs() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_fixups_from_relocs() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_fixups_from_relocs() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void ReorderInfo_BinaryInfo::clear_fixups_from_relocs() {
+  fixups_from_relocs_ = false;
+  clear_has_fixups_from_relocs();
+}
+inline bool ReorderInfo_BinaryInfo::fixups_from_relocs() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.fixups_from_relocs)
+  return fixups_from_relocs_;
+}
+inline void ReorderInfo_BinaryInfo::set_fixups_from_relocs(bool value) {
+  set_has_fixups_from_relocs();
+  fixups_from_relocs_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.fixups_from_relocs)
+}
+
+// optional bool data_fixups = 9;
+inline bool ReorderInfo_BinaryInfo::has_data_fixups() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void ReorderInfo_BinaryInfo::set_has_data_fixups() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void ReorderInfo_BinaryInfo::clear_has_data_fixups() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void ReorderInfo_BinaryInfo::clear_data_fixups() {
+  data_fixups_ = false;
+  clear_has_data_fixups();
+}
+inline bool ReorderInfo_BinaryInfo::data_fixups() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.data_fixups)
+  return data_fixups_;
+}
+inline void ReorderInfo_BinaryInfo::set_data_fixups(bool value) {
+  set_has_data_fixups();
+  data_fixups_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.data_fixups)
+}
+
+// -------------------------------------------------------------------
+
+// ReorderInfo_LayoutInfo
+
+// optional uint32 bb_size = 1;
+inline bool ReorderInfo_LayoutInfo::has_bb_size() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_bb_size() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_bb_size() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void ReorderInfo_LayoutInfo::clear_bb_size() {
+  bb_size_ = 0u;
+  clear_has_bb_size();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::bb_size() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.bb_size)
+  return bb_size_;
+}
+inline void ReorderInfo_LayoutInfo::set_bb_size(::google::protobuf::uint32 value) {
+  set_has_bb_size();
+  bb_size_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.bb_size)
+}
+
+// optional uint32 type = 2;
+inline bool ReorderInfo_LayoutInfo::has_type() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_type() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_type() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void ReorderInfo_LayoutInfo::clear_type() {
+  type_ = 0u;
+  clear_has_type();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::type() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.type)
+  return type_;
+}
+inline void ReorderInfo_LayoutInfo::set_type(::google::protobuf::uint32 value) {
+  set_has_type();
+  type_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.type)
+}
+
+// optional uint32 num_fixups = 3;
+inline bool ReorderInfo_LayoutInfo::has_num_fixups() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_num_fixups() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_num_fixups() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void ReorderInfo_LayoutInfo::clear_num_fixups() {
+  num_fixups_ = 0u;
+  clear_has_num_fixups();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::num_fixups() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.num_fixups)
+  return num_fixups_;
+}
+inline void ReorderInfo_LayoutInfo::set_num_fixups(::google::protobuf::uint32 value) {
+  set_has_num_fixups();
+  num_fixups_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.num_fixups)
+}
+
+// optional bool bb_fallthrough = 4;
+inline bool ReorderInfo_LayoutInfo::has_bb_fallthrough() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_bb_fallthrough() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_bb_fallthrough() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void ReorderInfo_LayoutInfo::clear_bb_fallthrough() {
+  bb_fallthrough_ = false;
+  clear_has_bb_fallthrough();
+}
+inline bool ReorderInfo_LayoutInfo::bb_fallthrough() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.bb_fallthrough)
+  return bb_fallthrough_;
+}
+inline void ReorderInfo_LayoutInfo::set_bb_fallthrough(bool value) {
+  set_has_bb_fallthrough();
+  bb_fallthrough_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.bb_fallthrough)
+}
+
+// optional string section_name = 5;
+inline bool ReorderInfo_LayoutInfo::has_section_name() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_section_name() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_section_name() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void ReorderInfo_LayoutInfo::clear_section_name() {
+  section_name_.ClearToEmpty(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+  clear_has_section_name();
+}
+inline const ::std::string& ReorderInfo_LayoutInfo::section_name() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+  return section_name_.Get();
+}
+inline void ReorderInfo_LayoutInfo::set_section_name(const ::std::string& value) {
+  set_has_section_name();
+  section_name_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+}
+inline void ReorderInfo_LayoutInfo::set_section_name(const char* value) {
+  set_has_section_name();
+  section_name_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value),
+              GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+}
+inline void ReorderInfo_LayoutInfo::set_section_name(const char* value,
+    size_t size) {
+  set_has_section_name();
+  section_name_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(
+      reinterpret_cast<const char*>(value), size), GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+}
+inline ::std::string* ReorderInfo_LayoutInfo::mutable_section_name() {
+  set_has_section_name();
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+  return section_name_.Mutable(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_LayoutInfo::release_section_name() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+  clear_has_section_name();
+  return section_name_.Release(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_LayoutInfo::unsafe_arena_release_section_name() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  clear_has_section_name();
+  return section_name_.UnsafeArenaRelease(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      GetArenaNoVirtual());
+}
+inline void ReorderInfo_LayoutInfo::set_allocated_section_name(::std::string* section_name) {
+  if (section_name != NULL) {
+    set_has_section_name();
+  } else {
+    clear_has_section_name();
+  }
+  section_name_.SetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), section_name,
+      GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+}
+inline void ReorderInfo_LayoutInfo::unsafe_arena_set_allocated_section_name(
+    ::std::string* section_name) {
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  if (section_name != NULL) {
+    set_has_section_name();
+  } else {
+    clear_has_section_name();
+  }
+  section_name_.UnsafeArenaSetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      section_name, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+}
+
+// optional uint32 section_idx = 6;
+inline bool ReorderInfo_LayoutInfo::has_section_idx() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_section_idx() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_section_idx() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void ReorderInfo_LayoutInfo::clear_section_idx() {
+  section_idx_ = 0u;
+  clear_has_section_idx();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::section_idx() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.section_idx)
+  return section_idx_;
+}
+inline void ReorderInfo_LayoutInfo::set_section_idx(::google::protobuf::uint32 value) {
+  set_has_section_idx();
+  section_idx_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.section_idx)
+}
+
+// optional uint32 hotness = 7;
+inline bool ReorderInfo_LayoutInfo::has_hotness() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_hotness() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_hotness() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void ReorderInfo_LayoutInfo::clear_hotness() {
+  hotness_ = 0u;
+  clear_has_hotness();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::hotness() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.hotness)
+  return hotness_;
+}
+inline void ReorderInfo_LayoutInfo::set_hotness(::google::protobuf::uint32 value) {
+  set_has_hotness();
+  hotness_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.hotness)
+}
+
+// optional uint32 padding_sz = 8;
+inline bool ReorderInfo_LayoutInfo::has_padding_sz() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_padding_sz() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_padding_sz() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void ReorderInfo_LayoutInfo::clear_padding_sz() {
+  padding_sz_ = 0u;
+  clear_has_padding_sz();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::padding_sz() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.padding_sz)
+  return padding_sz_;
+}
+inline void ReorderInfo_LayoutInfo::set_padding_sz(::google::protobuf::uint32 value) {
+  set_has_padding_sz();
+  padding_sz_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.padding_sz)
+}
+
+// optional uint32 align_log2 = 9;
+inline bool ReorderInfo_LayoutInfo::has_align_log2() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_align_log2() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_align_log2() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void ReorderInfo_LayoutInfo::clear_align_log2() {
+  align_log2_ = 0u;
+  clear_has_align_log2();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::align_log2() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.align_log2)
+  return align_log2_;
+}
+inline void ReorderInfo_LayoutInfo::set_align_log2(::google::protobuf::uint32 value) {
+  set_has_align_log2();
+  align_log2_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.align_log2)
+}
+
+// optional bool loop_header = 10;
+inline bool ReorderInfo_LayoutInfo::has_loop_header() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_loop_header() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_loop_header() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void ReorderInfo_LayoutInfo::clear_loop_header() {
+  loop_header_ = false;
+  clear_has_loop_header();
+}
+inline bool ReorderInfo_LayoutInfo::loop_header() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.loop_header)
+  return loop_header_;
+}
+inline void ReorderInfo_LayoutInfo::set_loop_header(bool value) {
+  set_has_loop_header();
+  loop_header_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.loop_header)
+}
+
+// optional bool pinned = 11;
+inline bool ReorderInfo_LayoutInfo::has_pinned() const {
+  return (_has_bits_[0] & 0x00000400u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_pinned() {
+  _has_bits_[0] |= 0x00000400u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_pinned() {
+  _has_bits_[0] &= ~0x00000400u;
+}
+inline void ReorderInfo_LayoutInfo::clear_pinned() {
+  pinned_ = false;
+  clear_has_pinned();
+}
+inline bool ReorderInfo_LayoutInfo::pinned() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.pinned)
+  return pinned_;
+}
+inline void ReorderInfo_LayoutInfo::set_pinned(bool value) {
+  set_has_pinned();
+  pinned_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.pinned)
+}
+
+// optional bool chain_start = 12;
+inline bool ReorderInfo_LayoutInfo::has_chain_start() const {
+  return (_has_bits_[0] & 0x00000800u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_chain_start() {
+  _has_bits_[0] |= 0x00000800u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_chain_start() {
+  _has_bits_[0] &= ~0x00000800u;
+}
+inline void ReorderInfo_LayoutInfo::clear_chain_start() {
+  chain_start_ = false;
+  clear_has_chain_start();
+}
+inline bool ReorderInfo_LayoutInfo::chain_start() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.chain_start)
+  return chain_start_;
+}
+inline void ReorderInfo_LayoutInfo::set_chain_start(bool value) {
+  set_has_chain_start();
+  chain_start_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.chain_start)
+}
+
+// optional uint32 edge_prob = 13;
+inline bool ReorderInfo_LayoutInfo::has_edge_prob() const {
+  return (_has_bits_[0] & 0x00001000u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_edge_prob() {
+  _has_bits_[0] |= 0x00001000u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_edge_prob() {
+  _has_bits_[0] &= ~0x00001000u;
+}
+inline void ReorderInfo_LayoutInfo::clear_edge_prob() {
+  edge_prob_ = 0u;
+  clear_has_edge_prob();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::edge_prob() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.edge_prob)
+  return edge_prob_;
+}
+inline void ReorderInfo_LayoutInfo::set_edge_prob(::google::protobuf::uint32 value) {
+  set_has_edge_prob();
+  edge_prob_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.edge_prob)
+}
+
+// optional uint32 term = 14;
+inline bool ReorderInfo_LayoutInfo::has_term() const {
+  return (_has_bits_[0] & 0x00002000u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_term() {
+  _has_bits_[0] |= 0x00002000u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_term() {
+  _has_bits_[0] &= ~0x00002000u;
+}
+inline void ReorderInfo_LayoutInfo::clear_term() {
+  term_ = 0u;
+  clear_has_term();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::term() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.term)
+  return term_;
+}
+inline void ReorderInfo_LayoutInfo::set_term(::google::protobuf::uint32 value) {
+  set_has_term();
+  term_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.term)
+}
+
+// optional uint32 boundary = 15;
+inline bool ReorderInfo_LayoutInfo::has_boundary() const {
+  return (_has_bits_[0] & 0x00004000u) != 0;
+}
+inline void ReorderInfo_LayoutInfo::set_has_boundary() {
+  _has_bits_[0] |= 0x00004000u;
+}
+inline void ReorderInfo_LayoutInfo::clear_has_boundary() {
+  _has_bits_[0] &= ~0x00004000u;
+}
+inline void ReorderInfo_LayoutInfo::clear_boundary() {
+  boundary_ = 0u;
+  clear_has_boundary();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::boundary() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.boundary)
+  return boundary_;
+}
+inline void ReorderInfo_LayoutInfo::set_boundary(::google::protobuf::uint32 value) {
+  set_has_boundary();
+  boundary_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.boundary)
+}
+
+// -------------------------------------------------------------------
+
+// ReorderInfo_FixupInfo_FixupTuple
+
+// required uint64 offset = 1;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_offset() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_offset() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_offset() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_offset() {
+  offset_ = GOOGLE_ULONGLONG(0);
+  clear_has_offset();
+}
+inline ::google::protobuf::uint64 ReorderInfo_FixupInfo_FixupTuple::offset() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.offset)
+  return offset_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_offset(::google::protobuf::uint64 value) {
+  set_has_offset();
+  offset_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.offset)
+}
+
+// required uint32 deref_sz = 2;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_deref_sz() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_deref_sz() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_deref_sz() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_deref_sz() {
+  deref_sz_ = 0u;
+  clear_has_deref_sz();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::deref_sz() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.deref_sz)
+  return deref_sz_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_deref_sz(::google::protobuf::uint32 value) {
+  set_has_deref_sz();
+  deref_sz_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.deref_sz)
+}
+
+// required bool is_rela = 3;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_is_rela() const {
+  return (_has_bits_[0] & 0x00000400u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_is_rela() {
+  _has_bits_[0] |= 0x00000400u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_is_rela() {
+  _has_bits_[0] &= ~0x00000400u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_is_rela() {
+  is_rela_ = false;
+  clear_has_is_rela();
+}
+inline bool ReorderInfo_FixupInfo_FixupTuple::is_rela() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.is_rela)
+  return is_rela_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_is_rela(bool value) {
+  set_has_is_rela();
+  is_rela_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.is_rela)
+}
+
+// optional uint32 type = 4;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_type() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_type() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_type() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_type() {
+  type_ = 0u;
+  clear_has_type();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::type() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.type)
+  return type_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_type(::google::protobuf::uint32 value) {
+  set_has_type();
+  type_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.type)
+}
+
+// optional string section_name = 5;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_section_name() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_section_name() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_section_name() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_section_name() {
+  section_name_.ClearToEmpty(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+  clear_has_section_name();
+}
+inline const ::std::string& ReorderInfo_FixupInfo_FixupTuple::section_name() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+  return section_name_.Get();
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(const ::std::string& value) {
+  set_has_section_name();
+  section_name_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(const char* value) {
+  set_has_section_name();
+  section_name_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value),
+              GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(const char* value,
+    size_t size) {
+  set_has_section_name();
+  section_name_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(
+      reinterpret_cast<const char*>(value), size), GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::mutable_section_name() {
+  set_has_section_name();
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+  return section_name_.Mutable(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::release_section_name() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+  clear_has_section_name();
+  return section_name_.Release(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::unsafe_arena_release_section_name() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  clear_has_section_name();
+  return section_name_.UnsafeArenaRelease(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      GetArenaNoVirtual());
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_allocated_section_name(::std::string* section_name) {
+  if (section_name != NULL) {
+    set_has_section_name();
+  } else {
+    clear_has_section_name();
+  }
+  section_name_.SetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), section_name,
+      GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::unsafe_arena_set_allocated_section_name(
+    ::std::string* section_name) {
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  if (section_name != NULL) {
+    set_has_section_name();
+  } else {
+    clear_has_section_name();
+  }
+  section_name_.UnsafeArenaSetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      section_name, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+}
+
+// optional uint32 num_jt_entries = 6;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_num_jt_entries() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_num_jt_entries() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_num_jt_entries() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_num_jt_entries() {
+  num_jt_entries_ = 0u;
+  clear_has_num_jt_entries();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::num_jt_entries() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.num_jt_entries)
+  return num_jt_entries_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_num_jt_entries(::google::protobuf::uint32 value) {
+  set_has_num_jt_entries();
+  num_jt_entries_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.num_jt_entries)
+}
+
+// optional uint32 jt_entry_sz = 7;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_jt_entry_sz() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_jt_entry_sz() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_jt_entry_sz() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_jt_entry_sz() {
+  jt_entry_sz_ = 0u;
+  clear_has_jt_entry_sz();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::jt_entry_sz() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.jt_entry_sz)
+  return jt_entry_sz_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_jt_entry_sz(::google::protobuf::uint32 value) {
+  set_has_jt_entry_sz();
+  jt_entry_sz_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.jt_entry_sz)
+}
+
+// optional uint32 section_idx = 8;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_section_idx() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_section_idx() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_section_idx() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_section_idx() {
+  section_idx_ = 0u;
+  clear_has_section_idx();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::section_idx() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_idx)
+  return section_idx_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_section_idx(::google::protobuf::uint32 value) {
+  set_has_section_idx();
+  section_idx_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_idx)
+}
+
+// optional uint32 relax_short_sz = 9;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_relax_short_sz() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_relax_short_sz() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_relax_short_sz() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_relax_short_sz() {
+  relax_short_sz_ = 0u;
+  clear_has_relax_short_sz();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::relax_short_sz() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_short_sz)
+  return relax_short_sz_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_relax_short_sz(::google::protobuf::uint32 value) {
+  set_has_relax_short_sz();
+  relax_short_sz_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_short_sz)
+}
+
+// optional bytes relax_long_form = 10;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_relax_long_form() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_relax_long_form() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_relax_long_form() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_relax_long_form() {
+  relax_long_form_.ClearToEmpty(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+  clear_has_relax_long_form();
+}
+inline const ::std::string& ReorderInfo_FixupInfo_FixupTuple::relax_long_form() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+  return relax_long_form_.Get();
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_relax_long_form(const ::std::string& value) {
+  set_has_relax_long_form();
+  relax_long_form_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_relax_long_form(const char* value) {
+  set_has_relax_long_form();
+  relax_long_form_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value),
+              GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_relax_long_form(const void* value,
+    size_t size) {
+  set_has_relax_long_form();
+  relax_long_form_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(
+      reinterpret_cast<const char*>(value), size), GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::mutable_relax_long_form() {
+  set_has_relax_long_form();
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+  return relax_long_form_.Mutable(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::release_relax_long_form() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+  clear_has_relax_long_form();
+  return relax_long_form_.Release(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::unsafe_arena_release_relax_long_form() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  clear_has_relax_long_form();
+  return relax_long_form_.UnsafeArenaRelease(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      GetArenaNoVirtual());
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_allocated_relax_long_form(::std::string* relax_long_form) {
+  if (relax_long_form != NULL) {
+    set_has_relax_long_form();
+  } else {
+    clear_has_relax_long_form();
+  }
+  relax_long_form_.SetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), relax_long_form,
+      GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::unsafe_arena_set_allocated_relax_long_form(
+    ::std::string* relax_long_form) {
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  if (relax_long_form != NULL) {
+    set_has_relax_long_form();
+  } else {
+    clear_has_relax_long_form();
+  }
+  relax_long_form_.UnsafeArenaSetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      relax_long_form, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_long_form)
+}
+
+// optional uint32 relax_fixup_offset = 11;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_relax_fixup_offset() const {
+  return (_has_bits_[0] & 0x00001000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_relax_fixup_offset() {
+  _has_bits_[0] |= 0x00001000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_relax_fixup_offset() {
+  _has_bits_[0] &= ~0x00001000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_relax_fixup_offset() {
+  relax_fixup_offset_ = 0u;
+  clear_has_relax_fixup_offset();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::relax_fixup_offset() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_fixup_offset)
+  return relax_fixup_offset_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_relax_fixup_offset(::google::protobuf::uint32 value) {
+  set_has_relax_fixup_offset();
+  relax_fixup_offset_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.relax_fixup_offset)
+}
+
+// optional uint32 target = 12;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_target() const {
+  return (_has_bits_[0] & 0x00002000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_target() {
+  _has_bits_[0] |= 0x00002000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_target() {
+  _has_bits_[0] &= ~0x00002000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_target() {
+  target_ = 0u;
+  clear_has_target();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::target() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.target)
+  return target_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_target(::google::protobuf::uint32 value) {
+  set_has_target();
+  target_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.target)
+}
+
+// optional uint32 reach_log2 = 13;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_reach_log2() const {
+  return (_has_bits_[0] & 0x00004000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_reach_log2() {
+  _has_bits_[0] |= 0x00004000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_reach_log2() {
+  _has_bits_[0] &= ~0x00004000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_reach_log2() {
+  reach_log2_ = 0u;
+  clear_has_reach_log2();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::reach_log2() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.reach_log2)
+  return reach_log2_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_reach_log2(::google::protobuf::uint32 value) {
+  set_has_reach_log2();
+  reach_log2_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.reach_log2)
+}
+
+// optional uint32 ref_class = 14;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_ref_class() const {
+  return (_has_bits_[0] & 0x00008000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_ref_class() {
+  _has_bits_[0] |= 0x00008000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_ref_class() {
+  _has_bits_[0] &= ~0x00008000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_ref_class() {
+  ref_class_ = 0u;
+  clear_has_ref_class();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::ref_class() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.ref_class)
+  return ref_class_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_ref_class(::google::protobuf::uint32 value) {
+  set_has_ref_class();
+  ref_class_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.ref_class)
+}
+
+// optional bool jt_func_rel = 15;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_jt_func_rel() const {
+  return (_has_bits_[0] & 0x00000800u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_jt_func_rel() {
+  _has_bits_[0] |= 0x00000800u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_jt_func_rel() {
+  _has_bits_[0] &= ~0x00000800u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_jt_func_rel() {
+  jt_func_rel_ = false;
+  clear_has_jt_func_rel();
+}
+inline bool ReorderInfo_FixupInfo_FixupTuple::jt_func_rel() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.jt_func_rel)
+  return jt_func_rel_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_jt_func_rel(bool value) {
+  set_has_jt_func_rel();
+  jt_func_rel_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.jt_func_rel)
+}
+
+// optional uint32 scope = 16;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_scope() const {
+  return (_has_bits_[0] & 0x00010000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_scope() {
+  _has_bits_[0] |= 0x00010000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_scope() {
+  _has_bits_[0] &= ~0x00010000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_scope() {
+  scope_ = 0u;
+  clear_has_scope();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::scope() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.scope)
+  return scope_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_scope(::google::protobuf::uint32 value) {
+  set_has_scope();
+  scope_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.scope)
+}
+
+// optional uint32 pair_delta = 17;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_pair_delta() const {
+  return (_has_bits_[0] & 0x00020000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_pair_delta() {
+  _has_bits_[0] |= 0x00020000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_pair_delta() {
+  _has_bits_[0] &= ~0x00020000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_pair_delta() {
+  pair_delta_ = 0u;
+  clear_has_pair_delta();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::pair_delta() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.pair_delta)
+  return pair_delta_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_pair_delta(::google::protobuf::uint32 value) {
+  set_has_pair_delta();
+  pair_delta_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.pair_delta)
+}
+
+// optional uint32 shrink_long_sz = 18;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_shrink_long_sz() const {
+  return (_has_bits_[0] & 0x00040000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_shrink_long_sz() {
+  _has_bits_[0] |= 0x00040000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_shrink_long_sz() {
+  _has_bits_[0] &= ~0x00040000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_shrink_long_sz() {
+  shrink_long_sz_ = 0u;
+  clear_has_shrink_long_sz();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::shrink_long_sz() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_long_sz)
+  return shrink_long_sz_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_shrink_long_sz(::google::protobuf::uint32 value) {
+  set_has_shrink_long_sz();
+  shrink_long_sz_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_long_sz)
+}
+
+// optional bytes shrink_short_form = 19;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_shrink_short_form() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_shrink_short_form() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_shrink_short_form() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_shrink_short_form() {
+  shrink_short_form_.ClearToEmpty(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+  clear_has_shrink_short_form();
+}
+inline const ::std::string& ReorderInfo_FixupInfo_FixupTuple::shrink_short_form() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+  return shrink_short_form_.Get();
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_shrink_short_form(const ::std::string& value) {
+  set_has_shrink_short_form();
+  shrink_short_form_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_shrink_short_form(const char* value) {
+  set_has_shrink_short_form();
+  shrink_short_form_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value),
+              GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_shrink_short_form(const void* value,
+    size_t size) {
+  set_has_shrink_short_form();
+  shrink_short_form_.Set(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(
+      reinterpret_cast<const char*>(value), size), GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::mutable_shrink_short_form() {
+  set_has_shrink_short_form();
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+  return shrink_short_form_.Mutable(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::release_shrink_short_form() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+  clear_has_shrink_short_form();
+  return shrink_short_form_.Release(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), GetArenaNoVirtual());
+}
+inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::unsafe_arena_release_shrink_short_form() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  clear_has_shrink_short_form();
+  return shrink_short_form_.UnsafeArenaRelease(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      GetArenaNoVirtual());
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_allocated_shrink_short_form(::std::string* shrink_short_form) {
+  if (shrink_short_form != NULL) {
+    set_has_shrink_short_form();
+  } else {
+    clear_has_shrink_short_form();
+  }
+  shrink_short_form_.SetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), shrink_short_form,
+      GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::unsafe_arena_set_allocated_shrink_short_form(
+    ::std::string* shrink_short_form) {
+  GOOGLE_DCHECK(GetArenaNoVirtual() != NULL);
+  if (shrink_short_form != NULL) {
+    set_has_shrink_short_form();
+  } else {
+    clear_has_shrink_short_form();
+  }
+  shrink_short_form_.UnsafeArenaSetAllocated(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      shrink_short_form, GetArenaNoVirtual());
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.shrink_short_form)
+}
+
+// optional uint32 reloc_idx = 20;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_reloc_idx() const {
+  return (_has_bits_[0] & 0x00080000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_reloc_idx() {
+  _has_bits_[0] |= 0x00080000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_reloc_idx() {
+  _has_bits_[0] &= ~0x00080000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_reloc_idx() {
+  reloc_idx_ = 0u;
+  clear_has_reloc_idx();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::reloc_idx() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.reloc_idx)
+  return reloc_idx_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_reloc_idx(::google::protobuf::uint32 value) {
+  set_has_reloc_idx();
+  reloc_idx_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.reloc_idx)
+}
+
+// optional uint32 got_relax = 21;
+inline bool ReorderInfo_FixupInfo_FixupTuple::has_got_relax() const {
+  return (_has_bits_[0] & 0x00100000u) != 0;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_has_got_relax() {
+  _has_bits_[0] |= 0x00100000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_got_relax() {
+  _has_bits_[0] &= ~0x00100000u;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::clear_got_relax() {
+  got_relax_ = 0u;
+  clear_has_got_relax();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::got_relax() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.got_relax)
+  return got_relax_;
+}
+inline void ReorderInfo_FixupInfo_FixupTuple::set_got_relax(::google::protobuf::uint32 value) {
+  set_has_got_relax();
+  got_relax_ = value;
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.got_relax)
+}
+
+// -------------------------------------------------------------------
+
+// ReorderInfo_FixupInfo
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple text = 1;
+inline int ReorderInfo_FixupInfo::text_size() const {
+  return text_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_text() {
+  text_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::text(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.text)
+  return text_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_text(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.text)
+  return text_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_text() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.text)
+  return text_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_text() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.text)
+  return &text_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::text() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.text)
+  return text_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple rodata = 2;
+inline int ReorderInfo_FixupInfo::rodata_size() const {
+  return rodata_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_rodata() {
+  rodata_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::rodata(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
+  return rodata_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_rodata(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
+  return rodata_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_rodata() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
+  return rodata_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_rodata() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
+  return &rodata_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::rodata() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
+  return rodata_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple data = 3;
+inline int ReorderInfo_FixupInfo::data_size() const {
+  return data_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_data() {
+  data_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::data(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.data)
+  return data_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_data(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.data)
+  return data_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_data() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.data)
+  return data_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_data() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.data)
+  return &data_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::data() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.data)
+  return data_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple datarel = 4;
+inline int ReorderInfo_FixupInfo::datarel_size() const {
+  return datarel_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_datarel() {
+  datarel_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::datarel(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
+  return datarel_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_datarel(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
+  return datarel_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_datarel() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
+  return datarel_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_datarel() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
+  return &datarel_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::datarel() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
+  return datarel_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple initarray = 5;
+inline int ReorderInfo_FixupInfo::initarray_size() const {
+  return initarray_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_initarray() {
+  initarray_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::initarray(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
+  return initarray_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_initarray(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
+  return initarray_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_initarray() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
+  return initarray_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_initarray() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
+  return &initarray_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::initarray() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
+  return initarray_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple finiarray = 6;
+inline int ReorderInfo_FixupInfo::finiarray_size() const {
+  return finiarray_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_finiarray() {
+  finiarray_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::finiarray(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.finiarray)
+  return finiarray_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_finiarray(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.finiarray)
+  return finiarray_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_finiarray() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.finiarray)
+  return finiarray_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_finiarray() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.finiarray)
+  return &finiarray_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::finiarray() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.finiarray)
+  return finiarray_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple tdata = 7;
+inline int ReorderInfo_FixupInfo::tdata_size() const {
+  return tdata_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_tdata() {
+  tdata_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::tdata(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.tdata)
+  return tdata_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_tdata(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.tdata)
+  return tdata_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_tdata() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.tdata)
+  return tdata_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_tdata() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.tdata)
+  return &tdata_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::tdata() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.tdata)
+  return tdata_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple xray = 8;
+inline int ReorderInfo_FixupInfo::xray_size() const {
+  return xray_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_xray() {
+  xray_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::xray(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.xray)
+  return xray_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_xray(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.xray)
+  return xray_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_xray() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.xray)
+  return xray_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_xray() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.xray)
+  return &xray_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::xray() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.xray)
+  return xray_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple patchable = 9;
+inline int ReorderInfo_FixupInfo::patchable_size() const {
+  return patchable_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_patchable() {
+  patchable_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::patchable(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.patchable)
+  return patchable_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_patchable(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.patchable)
+  return patchable_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_patchable() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.patchable)
+  return patchable_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_patchable() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.patchable)
+  return &patchable_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::patchable() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.patchable)
+  return patchable_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple jumptable = 10;
+inline int ReorderInfo_FixupInfo::jumptable_size() const {
+  return jumptable_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_jumptable() {
+  jumptable_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::jumptable(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.jumptable)
+  return jumptable_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_jumptable(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.jumptable)
+  return jumptable_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_jumptable() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.jumptable)
+  return jumptable_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_jumptable() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.jumptable)
+  return &jumptable_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::jumptable() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.jumptable)
+  return jumptable_;
+}
+
+// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple custom = 11;
+inline int ReorderInfo_FixupInfo::custom_size() const {
+  return custom_.size();
+}
+inline void ReorderInfo_FixupInfo::clear_custom() {
+  custom_.Clear();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::custom(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.custom)
+  return custom_.Get(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_custom(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.custom)
+  return custom_.Mutable(index);
+}
+inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_custom() {
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.custom)
+  return custom_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
+ReorderInfo_FixupInfo::mutable_custom() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.custom)
+  return &custom_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
+ReorderInfo_FixupInfo::custom() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.custom)
+  return custom_;
+}
+
+// -------------------------------------------------------------------
+
+// ReorderInfo_LayoutColumns
+
+// repeated uint32 bb_size = 1 [packed = true];
+inline int ReorderInfo_LayoutColumns::bb_size_size() const {
+  return bb_size_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_bb_size() {
+  bb_size_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutColumns::bb_size(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.bb_size)
+  return bb_size_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_bb_size(int index, ::google::protobuf::uint32 value) {
+  bb_size_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.bb_size)
+}
+inline void ReorderInfo_LayoutColumns::add_bb_size(::google::protobuf::uint32 value) {
+  bb_size_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.bb_size)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_LayoutColumns::bb_size() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.bb_size)
+  return bb_size_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_LayoutColumns::mutable_bb_size() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.bb_size)
+  return &bb_size_;
+}
+
+// repeated uint64 type_bits = 2 [packed = true];
+inline int ReorderInfo_LayoutColumns::type_bits_size() const {
+  return type_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_type_bits() {
+  type_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::type_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.type_bits)
+  return type_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_type_bits(int index, ::google::protobuf::uint64 value) {
+  type_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.type_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_type_bits(::google::protobuf::uint64 value) {
+  type_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.type_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::type_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.type_bits)
+  return type_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_type_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.type_bits)
+  return &type_bits_;
+}
+
+// repeated uint64 fallthrough_bits = 3 [packed = true];
+inline int ReorderInfo_LayoutColumns::fallthrough_bits_size() const {
+  return fallthrough_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_fallthrough_bits() {
+  fallthrough_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::fallthrough_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.fallthrough_bits)
+  return fallthrough_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_fallthrough_bits(int index, ::google::protobuf::uint64 value) {
+  fallthrough_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.fallthrough_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_fallthrough_bits(::google::protobuf::uint64 value) {
+  fallthrough_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.fallthrough_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::fallthrough_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.fallthrough_bits)
+  return fallthrough_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_fallthrough_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.fallthrough_bits)
+  return &fallthrough_bits_;
+}
+
+// repeated uint32 num_fixups = 4 [packed = true];
+inline int ReorderInfo_LayoutColumns::num_fixups_size() const {
+  return num_fixups_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_num_fixups() {
+  num_fixups_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutColumns::num_fixups(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.num_fixups)
+  return num_fixups_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_num_fixups(int index, ::google::protobuf::uint32 value) {
+  num_fixups_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.num_fixups)
+}
+inline void ReorderInfo_LayoutColumns::add_num_fixups(::google::protobuf::uint32 value) {
+  num_fixups_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.num_fixups)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_LayoutColumns::num_fixups() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.num_fixups)
+  return num_fixups_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_LayoutColumns::mutable_num_fixups() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.num_fixups)
+  return &num_fixups_;
+}
+
+// repeated uint32 section_idx = 5 [packed = true];
+inline int ReorderInfo_LayoutColumns::section_idx_size() const {
+  return section_idx_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_section_idx() {
+  section_idx_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutColumns::section_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.section_idx)
+  return section_idx_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_section_idx(int index, ::google::protobuf::uint32 value) {
+  section_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.section_idx)
+}
+inline void ReorderInfo_LayoutColumns::add_section_idx(::google::protobuf::uint32 value) {
+  section_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.section_idx)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_LayoutColumns::section_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.section_idx)
+  return section_idx_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_LayoutColumns::mutable_section_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.section_idx)
+  return &section_idx_;
+}
+
+// repeated uint64 hotness_bits = 6 [packed = true];
+inline int ReorderInfo_LayoutColumns::hotness_bits_size() const {
+  return hotness_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_hotness_bits() {
+  hotness_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::hotness_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.hotness_bits)
+  return hotness_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_hotness_bits(int index, ::google::protobuf::uint64 value) {
+  hotness_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.hotness_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_hotness_bits(::google::protobuf::uint64 value) {
+  hotness_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.hotness_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::hotness_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.hotness_bits)
+  return hotness_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_hotness_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.hotness_bits)
+  return &hotness_bits_;
+}
+
+// repeated uint32 padding_sz = 7 [packed = true];
+inline int ReorderInfo_LayoutColumns::padding_sz_size() const {
+  return padding_sz_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_padding_sz() {
+  padding_sz_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_LayoutColumns::padding_sz(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.padding_sz)
+  return padding_sz_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_padding_sz(int index, ::google::protobuf::uint32 value) {
+  padding_sz_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.padding_sz)
+}
+inline void ReorderInfo_LayoutColumns::add_padding_sz(::google::protobuf::uint32 value) {
+  padding_sz_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.padding_sz)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_LayoutColumns::padding_sz() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.padding_sz)
+  return padding_sz_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_LayoutColumns::mutable_padding_sz() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.padding_sz)
+  return &padding_sz_;
+}
+
+// repeated uint64 align_bits = 8 [packed = true];
+inline int ReorderInfo_LayoutColumns::align_bits_size() const {
+  return align_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_align_bits() {
+  align_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::align_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.align_bits)
+  return align_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_align_bits(int index, ::google::protobuf::uint64 value) {
+  align_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.align_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_align_bits(::google::protobuf::uint64 value) {
+  align_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.align_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::align_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.align_bits)
+  return align_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_align_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.align_bits)
+  return &align_bits_;
+}
+
+// repeated uint64 loop_header_bits = 9 [packed = true];
+inline int ReorderInfo_LayoutColumns::loop_header_bits_size() const {
+  return loop_header_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_loop_header_bits() {
+  loop_header_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::loop_header_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.loop_header_bits)
+  return loop_header_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_loop_header_bits(int index, ::google::protobuf::uint64 value) {
+  loop_header_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.loop_header_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_loop_header_bits(::google::protobuf::uint64 value) {
+  loop_header_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.loop_header_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::loop_header_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.loop_header_bits)
+  return loop_header_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_loop_header_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.loop_header_bits)
+  return &loop_header_bits_;
+}
+
+// repeated uint64 cfi_bits = 10 [packed = true];
+inline int ReorderInfo_LayoutColumns::cfi_bits_size() const {
+  return cfi_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_cfi_bits() {
+  cfi_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::cfi_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.cfi_bits)
+  return cfi_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_cfi_bits(int index, ::google::protobuf::uint64 value) {
+  cfi_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.cfi_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_cfi_bits(::google::protobuf::uint64 value) {
+  cfi_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.cfi_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::cfi_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.cfi_bits)
+  return cfi_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_cfi_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.cfi_bits)
+  return &cfi_bits_;
+}
+
+// repeated uint64 pinned_bits = 11 [packed = true];
+inline int ReorderInfo_LayoutColumns::pinned_bits_size() const {
+  return pinned_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_pinned_bits() {
+  pinned_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::pinned_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.pinned_bits)
+  return pinned_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_pinned_bits(int index, ::google::protobuf::uint64 value) {
+  pinned_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.pinned_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_pinned_bits(::google::protobuf::uint64 value) {
+  pinned_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.pinned_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::pinned_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.pinned_bits)
+  return pinned_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_pinned_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.pinned_bits)
+  return &pinned_bits_;
+}
+
+// repeated uint64 chain_start_bits = 12 [packed = true];
+inline int ReorderInfo_LayoutColumns::chain_start_bits_size() const {
+  return chain_start_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_chain_start_bits() {
+  chain_start_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::chain_start_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.chain_start_bits)
+  return chain_start_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_chain_start_bits(int index, ::google::protobuf::uint64 value) {
+  chain_start_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.chain_start_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_chain_start_bits(::google::protobuf::uint64 value) {
+  chain_start_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.chain_start_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::chain_start_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.chain_start_bits)
+  return chain_start_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_chain_start_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.chain_start_bits)
+  return &chain_start_bits_;
+}
+
+// repeated uint64 edge_prob_bits = 13 [packed = true];
+inline int ReorderInfo_LayoutColumns::edge_prob_bits_size() const {
+  return edge_prob_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_edge_prob_bits() {
+  edge_prob_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::edge_prob_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.edge_prob_bits)
+  return edge_prob_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_edge_prob_bits(int index, ::google::protobuf::uint64 value) {
+  edge_prob_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.edge_prob_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_edge_prob_bits(::google::protobuf::uint64 value) {
+  edge_prob_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.edge_prob_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::edge_prob_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.edge_prob_bits)
+  return edge_prob_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_edge_prob_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.edge_prob_bits)
+  return &edge_prob_bits_;
+}
+
+// repeated fixed64 function_name_hash = 14 [packed = true];
+inline int ReorderInfo_LayoutColumns::function_name_hash_size() const {
+  return function_name_hash_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_function_name_hash() {
+  function_name_hash_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::function_name_hash(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.function_name_hash)
+  return function_name_hash_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_function_name_hash(int index, ::google::protobuf::uint64 value) {
+  function_name_hash_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.function_name_hash)
+}
+inline void ReorderInfo_LayoutColumns::add_function_name_hash(::google::protobuf::uint64 value) {
+  function_name_hash_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.function_name_hash)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::function_name_hash() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.function_name_hash)
+  return function_name_hash_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_function_name_hash() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.function_name_hash)
+  return &function_name_hash_;
+}
+
+// repeated fixed64 function_content_hash = 15 [packed = true];
+inline int ReorderInfo_LayoutColumns::function_content_hash_size() const {
+  return function_content_hash_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_function_content_hash() {
+  function_content_hash_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::function_content_hash(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.function_content_hash)
+  return function_content_hash_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_function_content_hash(int index, ::google::protobuf::uint64 value) {
+  function_content_hash_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.function_content_hash)
+}
+inline void ReorderInfo_LayoutColumns::add_function_content_hash(::google::protobuf::uint64 value) {
+  function_content_hash_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.function_content_hash)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::function_content_hash() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.function_content_hash)
+  return function_content_hash_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_function_content_hash() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.function_content_hash)
+  return &function_content_hash_;
+}
+
+// repeated uint64 term_bits = 16 [packed = true];
+inline int ReorderInfo_LayoutColumns::term_bits_size() const {
+  return term_bits_.size();
+}
+inline void ReorderInfo_LayoutColumns::clear_term_bits() {
+  term_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_LayoutColumns::term_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.term_bits)
+  return term_bits_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_term_bits(int index, ::google::protobuf::uint64 value) {
+  term_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.term_bits)
+}
+inline void ReorderInfo_LayoutColumns::add_term_bits(::google::protobuf::uint64 value) {
+  term_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.term_bits)
 }
-inline void ReorderInfo_BinaryInfo::set_has_src_type() {
-  _has_bits_[0] |= 0x00000008u;
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_LayoutColumns::term_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.term_bits)
+  return term_bits_;
 }
-inline void ReorderInfo_BinaryInfo::clear_has_src_type() {
-  _has_bits_[0] &= ~0x00000008u;
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_LayoutColumns::mutable_term_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.term_bits)
+  return &term_bits_;
 }
-inline void ReorderInfo_BinaryInfo::clear_src_type() {
-  src_type_ = 0u;
-  clear_has_src_type();
+
+// repeated uint32 boundary = 17 [packed = true];
+inline int ReorderInfo_LayoutColumns::boundary_size() const {
+  return boundary_.size();
 }
-inline ::google::protobuf::uint32 ReorderInfo_BinaryInfo::src_type() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.BinaryInfo.src_type)
-  return src_type_;
+inline void ReorderInfo_LayoutColumns::clear_boundary() {
+  boundary_.Clear();
 }
-inline void ReorderInfo_BinaryInfo::set_src_type(::google::protobuf::uint32 value) {
-  set_has_src_type();
-  src_type_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.BinaryInfo.src_type)
+inline ::google::protobuf::uint32 ReorderInfo_LayoutColumns::boundary(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutColumns.boundary)
+  return boundary_.Get(index);
+}
+inline void ReorderInfo_LayoutColumns::set_boundary(int index, ::google::protobuf::uint32 value) {
+  boundary_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutColumns.boundary)
+}
+inline void ReorderInfo_LayoutColumns::add_boundary(::google::protobuf::uint32 value) {
+  boundary_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.LayoutColumns.boundary)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_LayoutColumns::boundary() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.LayoutColumns.boundary)
+  return boundary_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_LayoutColumns::mutable_boundary() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.LayoutColumns.boundary)
+  return &boundary_;
 }
 
 // -------------------------------------------------------------------
 
-// ReorderInfo_LayoutInfo
+// ReorderInfo_FixupColumns
 
-// optional uint32 bb_size = 1;
-inline bool ReorderInfo_LayoutInfo::has_bb_size() const {
-  return (_has_bits_[0] & 0x00000002u) != 0;
+// repeated sint64 offset_delta = 1 [packed = true];
+inline int ReorderInfo_FixupColumns::offset_delta_size() const {
+  return offset_delta_.size();
 }
-inline void ReorderInfo_LayoutInfo::set_has_bb_size() {
-  _has_bits_[0] |= 0x00000002u;
+inline void ReorderInfo_FixupColumns::clear_offset_delta() {
+  offset_delta_.Clear();
 }
-inline void ReorderInfo_LayoutInfo::clear_has_bb_size() {
-  _has_bits_[0] &= ~0x00000002u;
+inline ::google::protobuf::int64 ReorderInfo_FixupColumns::offset_delta(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.offset_delta)
+  return offset_delta_.Get(index);
 }
-inline void ReorderInfo_LayoutInfo::clear_bb_size() {
-  bb_size_ = 0u;
-  clear_has_bb_size();
+inline void ReorderInfo_FixupColumns::set_offset_delta(int index, ::google::protobuf::int64 value) {
+  offset_delta_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.offset_delta)
 }
-inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::bb_size() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.bb_size)
-  return bb_size_;
+inline void ReorderInfo_FixupColumns::add_offset_delta(::google::protobuf::int64 value) {
+  offset_delta_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.offset_delta)
 }
-inline void ReorderInfo_LayoutInfo::set_bb_size(::google::protobuf::uint32 value) {
-  set_has_bb_size();
-  bb_size_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.bb_size)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::int64 >&
+ReorderInfo_FixupColumns::offset_delta() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.offset_delta)
+  return offset_delta_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::int64 >*
+ReorderInfo_FixupColumns::mutable_offset_delta() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.offset_delta)
+  return &offset_delta_;
 }
 
-// optional uint32 type = 2;
-inline bool ReorderInfo_LayoutInfo::has_type() const {
-  return (_has_bits_[0] & 0x00000004u) != 0;
+// repeated uint32 deref_sz = 2 [packed = true];
+inline int ReorderInfo_FixupColumns::deref_sz_size() const {
+  return deref_sz_.size();
 }
-inline void ReorderInfo_LayoutInfo::set_has_type() {
-  _has_bits_[0] |= 0x00000004u;
+inline void ReorderInfo_FixupColumns::clear_deref_sz() {
+  deref_sz_.Clear();
 }
-inline void ReorderInfo_LayoutInfo::clear_has_type() {
-  _has_bits_[0] &= ~0x00000004u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::deref_sz(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.deref_sz)
+  return deref_sz_.Get(index);
 }
-inline void ReorderInfo_LayoutInfo::clear_type() {
-  type_ = 0u;
-  clear_has_type();
+inline void ReorderInfo_FixupColumns::set_deref_sz(int index, ::google::protobuf::uint32 value) {
+  deref_sz_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.deref_sz)
 }
-inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::type() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.type)
-  return type_;
+inline void ReorderInfo_FixupColumns::add_deref_sz(::google::protobuf::uint32 value) {
+  deref_sz_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.deref_sz)
 }
-inline void ReorderInfo_LayoutInfo::set_type(::google::protobuf::uint32 value) {
-  set_has_type();
-  type_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.type)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::deref_sz() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.deref_sz)
+  return deref_sz_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_deref_sz() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.deref_sz)
+  return &deref_sz_;
 }
 
-// optional uint32 num_fixups = 3;
-inline bool ReorderInfo_LayoutInfo::has_num_fixups() const {
-  return (_has_bits_[0] & 0x00000008u) != 0;
+// repeated uint64 is_rela_bits = 3 [packed = true];
+inline int ReorderInfo_FixupColumns::is_rela_bits_size() const {
+  return is_rela_bits_.size();
 }
-inline void ReorderInfo_LayoutInfo::set_has_num_fixups() {
-  _has_bits_[0] |= 0x00000008u;
+inline void ReorderInfo_FixupColumns::clear_is_rela_bits() {
+  is_rela_bits_.Clear();
 }
-inline void ReorderInfo_LayoutInfo::clear_has_num_fixups() {
-  _has_bits_[0] &= ~0x00000008u;
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::is_rela_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.is_rela_bits)
+  return is_rela_bits_.Get(index);
 }
-inline void ReorderInfo_LayoutInfo::clear_num_fixups() {
-  num_fixups_ = 0u;
-  clear_has_num_fixups();
+inline void ReorderInfo_FixupColumns::set_is_rela_bits(int index, ::google::protobuf::uint64 value) {
+  is_rela_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.is_rela_bits)
 }
-inline ::google::protobuf::uint32 ReorderInfo_LayoutInfo::num_fixups() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.num_fixups)
-  return num_fixups_;
+inline void ReorderInfo_FixupColumns::add_is_rela_bits(::google::protobuf::uint64 value) {
+  is_rela_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.is_rela_bits)
 }
-inline void ReorderInfo_LayoutInfo::set_num_fixups(::google::protobuf::uint32 value) {
-  set_has_num_fixups();
-  num_fixups_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.num_fixups)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::is_rela_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.is_rela_bits)
+  return is_rela_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_is_rela_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.is_rela_bits)
+  return &is_rela_bits_;
 }
 
-// optional bool bb_fallthrough = 4;
-inline bool ReorderInfo_LayoutInfo::has_bb_fallthrough() const {
-  return (_has_bits_[0] & 0x00000010u) != 0;
+// repeated uint64 new_section_bits = 4 [packed = true];
+inline int ReorderInfo_FixupColumns::new_section_bits_size() const {
+  return new_section_bits_.size();
 }
-inline void ReorderInfo_LayoutInfo::set_has_bb_fallthrough() {
-  _has_bits_[0] |= 0x00000010u;
+inline void ReorderInfo_FixupColumns::clear_new_section_bits() {
+  new_section_bits_.Clear();
 }
-inline void ReorderInfo_LayoutInfo::clear_has_bb_fallthrough() {
-  _has_bits_[0] &= ~0x00000010u;
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::new_section_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.new_section_bits)
+  return new_section_bits_.Get(index);
 }
-inline void ReorderInfo_LayoutInfo::clear_bb_fallthrough() {
-  bb_fallthrough_ = false;
-  clear_has_bb_fallthrough();
+inline void ReorderInfo_FixupColumns::set_new_section_bits(int index, ::google::protobuf::uint64 value) {
+  new_section_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.new_section_bits)
 }
-inline bool ReorderInfo_LayoutInfo::bb_fallthrough() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.bb_fallthrough)
-  return bb_fallthrough_;
+inline void ReorderInfo_FixupColumns::add_new_section_bits(::google::protobuf::uint64 value) {
+  new_section_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.new_section_bits)
 }
-inline void ReorderInfo_LayoutInfo::set_bb_fallthrough(bool value) {
-  set_has_bb_fallthrough();
-  bb_fallthrough_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.bb_fallthrough)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::new_section_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.new_section_bits)
+  return new_section_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_new_section_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.new_section_bits)
+  return &new_section_bits_;
 }
 
-// optional string section_name = 5;
-inline bool ReorderInfo_LayoutInfo::has_section_name() const {
-  return (_has_bits_[0] & 0x00000001u) != 0;
+// repeated uint32 section_idx = 5 [packed = true];
+inline int ReorderInfo_FixupColumns::section_idx_size() const {
+  return section_idx_.size();
 }
-inline void ReorderInfo_LayoutInfo::set_has_section_name() {
-  _has_bits_[0] |= 0x00000001u;
+inline void ReorderInfo_FixupColumns::clear_section_idx() {
+  section_idx_.Clear();
 }
-inline void ReorderInfo_LayoutInfo::clear_has_section_name() {
-  _has_bits_[0] &= ~0x00000001u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::section_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.section_idx)
+  return section_idx_.Get(index);
 }
-inline void ReorderInfo_LayoutInfo::clear_section_name() {
-  section_name_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  clear_has_section_name();
+inline void ReorderInfo_FixupColumns::set_section_idx(int index, ::google::protobuf::uint32 value) {
+  section_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.section_idx)
 }
-inline const ::std::string& ReorderInfo_LayoutInfo::section_name() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
-  return section_name_.GetNoArena();
+inline void ReorderInfo_FixupColumns::add_section_idx(::google::protobuf::uint32 value) {
+  section_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.section_idx)
 }
-inline void ReorderInfo_LayoutInfo::set_section_name(const ::std::string& value) {
-  set_has_section_name();
-  section_name_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::section_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.section_idx)
+  return section_idx_;
 }
-#if LANG_CXX11
-inline void ReorderInfo_LayoutInfo::set_section_name(::std::string&& value) {
-  set_has_section_name();
-  section_name_.SetNoArena(
-    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
-  // @@protoc_insertion_point(field_set_rvalue:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_section_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.section_idx)
+  return &section_idx_;
 }
-#endif
-inline void ReorderInfo_LayoutInfo::set_section_name(const char* value) {
-  set_has_section_name();
-  section_name_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
-  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+
+// repeated uint32 jt_fixup_idx = 6 [packed = true];
+inline int ReorderInfo_FixupColumns::jt_fixup_idx_size() const {
+  return jt_fixup_idx_.size();
 }
-inline void ReorderInfo_LayoutInfo::set_section_name(const char* value, size_t size) {
-  set_has_section_name();
-  section_name_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-      ::std::string(reinterpret_cast<const char*>(value), size));
-  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+inline void ReorderInfo_FixupColumns::clear_jt_fixup_idx() {
+  jt_fixup_idx_.Clear();
 }
-inline ::std::string* ReorderInfo_LayoutInfo::mutable_section_name() {
-  set_has_section_name();
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
-  return section_name_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::jt_fixup_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.jt_fixup_idx)
+  return jt_fixup_idx_.Get(index);
 }
-inline ::std::string* ReorderInfo_LayoutInfo::release_section_name() {
-  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
-  clear_has_section_name();
-  return section_name_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void ReorderInfo_FixupColumns::set_jt_fixup_idx(int index, ::google::protobuf::uint32 value) {
+  jt_fixup_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.jt_fixup_idx)
 }
-inline void ReorderInfo_LayoutInfo::set_allocated_section_name(::std::string* section_name) {
-  if (section_name != NULL) {
-    set_has_section_name();
-  } else {
-    clear_has_section_name();
-  }
-  section_name_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), section_name);
-  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.LayoutInfo.section_name)
+inline void ReorderInfo_FixupColumns::add_jt_fixup_idx(::google::protobuf::uint32 value) {
+  jt_fixup_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.jt_fixup_idx)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::jt_fixup_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.jt_fixup_idx)
+  return jt_fixup_idx_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_jt_fixup_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.jt_fixup_idx)
+  return &jt_fixup_idx_;
+}
+
+// repeated uint32 num_jt_entries = 7 [packed = true];
+inline int ReorderInfo_FixupColumns::num_jt_entries_size() const {
+  return num_jt_entries_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_num_jt_entries() {
+  num_jt_entries_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::num_jt_entries(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.num_jt_entries)
+  return num_jt_entries_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_num_jt_entries(int index, ::google::protobuf::uint32 value) {
+  num_jt_entries_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.num_jt_entries)
+}
+inline void ReorderInfo_FixupColumns::add_num_jt_entries(::google::protobuf::uint32 value) {
+  num_jt_entries_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.num_jt_entries)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::num_jt_entries() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.num_jt_entries)
+  return num_jt_entries_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_num_jt_entries() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.num_jt_entries)
+  return &num_jt_entries_;
+}
+
+// repeated uint32 jt_entry_sz = 8 [packed = true];
+inline int ReorderInfo_FixupColumns::jt_entry_sz_size() const {
+  return jt_entry_sz_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_jt_entry_sz() {
+  jt_entry_sz_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::jt_entry_sz(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.jt_entry_sz)
+  return jt_entry_sz_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_jt_entry_sz(int index, ::google::protobuf::uint32 value) {
+  jt_entry_sz_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.jt_entry_sz)
+}
+inline void ReorderInfo_FixupColumns::add_jt_entry_sz(::google::protobuf::uint32 value) {
+  jt_entry_sz_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.jt_entry_sz)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::jt_entry_sz() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.jt_entry_sz)
+  return jt_entry_sz_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_jt_entry_sz() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.jt_entry_sz)
+  return &jt_entry_sz_;
+}
+
+// repeated uint32 relax_fixup_idx = 9 [packed = true];
+inline int ReorderInfo_FixupColumns::relax_fixup_idx_size() const {
+  return relax_fixup_idx_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_relax_fixup_idx() {
+  relax_fixup_idx_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::relax_fixup_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_idx)
+  return relax_fixup_idx_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_relax_fixup_idx(int index, ::google::protobuf::uint32 value) {
+  relax_fixup_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_idx)
+}
+inline void ReorderInfo_FixupColumns::add_relax_fixup_idx(::google::protobuf::uint32 value) {
+  relax_fixup_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_idx)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::relax_fixup_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_idx)
+  return relax_fixup_idx_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_relax_fixup_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_idx)
+  return &relax_fixup_idx_;
+}
+
+// repeated uint32 relax_short_sz = 10 [packed = true];
+inline int ReorderInfo_FixupColumns::relax_short_sz_size() const {
+  return relax_short_sz_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_relax_short_sz() {
+  relax_short_sz_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::relax_short_sz(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.relax_short_sz)
+  return relax_short_sz_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_relax_short_sz(int index, ::google::protobuf::uint32 value) {
+  relax_short_sz_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.relax_short_sz)
+}
+inline void ReorderInfo_FixupColumns::add_relax_short_sz(::google::protobuf::uint32 value) {
+  relax_short_sz_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.relax_short_sz)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::relax_short_sz() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_short_sz)
+  return relax_short_sz_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_relax_short_sz() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_short_sz)
+  return &relax_short_sz_;
+}
+
+// repeated bytes relax_long_form = 11;
+inline int ReorderInfo_FixupColumns::relax_long_form_size() const {
+  return relax_long_form_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_relax_long_form() {
+  relax_long_form_.Clear();
+}
+inline const ::std::string& ReorderInfo_FixupColumns::relax_long_form(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+  return relax_long_form_.Get(index);
+}
+inline ::std::string* ReorderInfo_FixupColumns::mutable_relax_long_form(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+  return relax_long_form_.Mutable(index);
+}
+inline void ReorderInfo_FixupColumns::set_relax_long_form(int index, const ::std::string& value) {
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+  relax_long_form_.Mutable(index)->assign(value);
+}
+inline void ReorderInfo_FixupColumns::set_relax_long_form(int index, const char* value) {
+  relax_long_form_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+}
+inline void ReorderInfo_FixupColumns::set_relax_long_form(int index, const void* value, size_t size) {
+  relax_long_form_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+}
+inline ::std::string* ReorderInfo_FixupColumns::add_relax_long_form() {
+  // @@protoc_insertion_point(field_add_mutable:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+  return relax_long_form_.Add();
+}
+inline void ReorderInfo_FixupColumns::add_relax_long_form(const ::std::string& value) {
+  relax_long_form_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+}
+inline void ReorderInfo_FixupColumns::add_relax_long_form(const char* value) {
+  relax_long_form_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+}
+inline void ReorderInfo_FixupColumns::add_relax_long_form(const void* value, size_t size) {
+  relax_long_form_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+}
+inline const ::google::protobuf::RepeatedPtrField< ::std::string>&
+ReorderInfo_FixupColumns::relax_long_form() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+  return relax_long_form_;
+}
+inline ::google::protobuf::RepeatedPtrField< ::std::string>*
+ReorderInfo_FixupColumns::mutable_relax_long_form() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_long_form)
+  return &relax_long_form_;
+}
+
+// repeated uint32 relax_fixup_offset = 12 [packed = true];
+inline int ReorderInfo_FixupColumns::relax_fixup_offset_size() const {
+  return relax_fixup_offset_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_relax_fixup_offset() {
+  relax_fixup_offset_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::relax_fixup_offset(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_offset)
+  return relax_fixup_offset_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_relax_fixup_offset(int index, ::google::protobuf::uint32 value) {
+  relax_fixup_offset_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_offset)
+}
+inline void ReorderInfo_FixupColumns::add_relax_fixup_offset(::google::protobuf::uint32 value) {
+  relax_fixup_offset_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_offset)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::relax_fixup_offset() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_offset)
+  return relax_fixup_offset_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_relax_fixup_offset() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.relax_fixup_offset)
+  return &relax_fixup_offset_;
+}
+
+// repeated uint64 target_bits = 13 [packed = true];
+inline int ReorderInfo_FixupColumns::target_bits_size() const {
+  return target_bits_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_target_bits() {
+  target_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::target_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.target_bits)
+  return target_bits_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_target_bits(int index, ::google::protobuf::uint64 value) {
+  target_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.target_bits)
+}
+inline void ReorderInfo_FixupColumns::add_target_bits(::google::protobuf::uint64 value) {
+  target_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.target_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::target_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.target_bits)
+  return target_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_target_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.target_bits)
+  return &target_bits_;
+}
+
+// repeated uint32 reach_fixup_idx = 14 [packed = true];
+inline int ReorderInfo_FixupColumns::reach_fixup_idx_size() const {
+  return reach_fixup_idx_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_reach_fixup_idx() {
+  reach_fixup_idx_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::reach_fixup_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.reach_fixup_idx)
+  return reach_fixup_idx_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_reach_fixup_idx(int index, ::google::protobuf::uint32 value) {
+  reach_fixup_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.reach_fixup_idx)
+}
+inline void ReorderInfo_FixupColumns::add_reach_fixup_idx(::google::protobuf::uint32 value) {
+  reach_fixup_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.reach_fixup_idx)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::reach_fixup_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.reach_fixup_idx)
+  return reach_fixup_idx_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_reach_fixup_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.reach_fixup_idx)
+  return &reach_fixup_idx_;
+}
+
+// repeated uint32 reach_log2 = 15 [packed = true];
+inline int ReorderInfo_FixupColumns::reach_log2_size() const {
+  return reach_log2_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_reach_log2() {
+  reach_log2_.Clear();
+}
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::reach_log2(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.reach_log2)
+  return reach_log2_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_reach_log2(int index, ::google::protobuf::uint32 value) {
+  reach_log2_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.reach_log2)
+}
+inline void ReorderInfo_FixupColumns::add_reach_log2(::google::protobuf::uint32 value) {
+  reach_log2_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.reach_log2)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::reach_log2() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.reach_log2)
+  return reach_log2_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_reach_log2() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.reach_log2)
+  return &reach_log2_;
+}
+
+// repeated uint64 ref_class_bits = 16 [packed = true];
+inline int ReorderInfo_FixupColumns::ref_class_bits_size() const {
+  return ref_class_bits_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_ref_class_bits() {
+  ref_class_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::ref_class_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.ref_class_bits)
+  return ref_class_bits_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_ref_class_bits(int index, ::google::protobuf::uint64 value) {
+  ref_class_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.ref_class_bits)
+}
+inline void ReorderInfo_FixupColumns::add_ref_class_bits(::google::protobuf::uint64 value) {
+  ref_class_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.ref_class_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::ref_class_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.ref_class_bits)
+  return ref_class_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_ref_class_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.ref_class_bits)
+  return &ref_class_bits_;
+}
+
+// repeated uint64 jt_func_rel_bits = 17 [packed = true];
+inline int ReorderInfo_FixupColumns::jt_func_rel_bits_size() const {
+  return jt_func_rel_bits_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_jt_func_rel_bits() {
+  jt_func_rel_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::jt_func_rel_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.jt_func_rel_bits)
+  return jt_func_rel_bits_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_jt_func_rel_bits(int index, ::google::protobuf::uint64 value) {
+  jt_func_rel_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.jt_func_rel_bits)
+}
+inline void ReorderInfo_FixupColumns::add_jt_func_rel_bits(::google::protobuf::uint64 value) {
+  jt_func_rel_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.jt_func_rel_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::jt_func_rel_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.jt_func_rel_bits)
+  return jt_func_rel_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_jt_func_rel_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.jt_func_rel_bits)
+  return &jt_func_rel_bits_;
+}
+
+// repeated uint64 scope_bits = 18 [packed = true];
+inline int ReorderInfo_FixupColumns::scope_bits_size() const {
+  return scope_bits_.size();
+}
+inline void ReorderInfo_FixupColumns::clear_scope_bits() {
+  scope_bits_.Clear();
+}
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::scope_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.scope_bits)
+  return scope_bits_.Get(index);
+}
+inline void ReorderInfo_FixupColumns::set_scope_bits(int index, ::google::protobuf::uint64 value) {
+  scope_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.scope_bits)
+}
+inline void ReorderInfo_FixupColumns::add_scope_bits(::google::protobuf::uint64 value) {
+  scope_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.scope_bits)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::scope_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.scope_bits)
+  return scope_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_scope_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.scope_bits)
+  return &scope_bits_;
 }
 
-// -------------------------------------------------------------------
-
-// ReorderInfo_FixupInfo_FixupTuple
-
-// required uint32 offset = 1;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_offset() const {
-  return (_has_bits_[0] & 0x00000002u) != 0;
+// repeated uint32 pair_fixup_idx = 19 [packed = true];
+inline int ReorderInfo_FixupColumns::pair_fixup_idx_size() const {
+  return pair_fixup_idx_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_offset() {
-  _has_bits_[0] |= 0x00000002u;
+inline void ReorderInfo_FixupColumns::clear_pair_fixup_idx() {
+  pair_fixup_idx_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_offset() {
-  _has_bits_[0] &= ~0x00000002u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::pair_fixup_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.pair_fixup_idx)
+  return pair_fixup_idx_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_offset() {
-  offset_ = 0u;
-  clear_has_offset();
+inline void ReorderInfo_FixupColumns::set_pair_fixup_idx(int index, ::google::protobuf::uint32 value) {
+  pair_fixup_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.pair_fixup_idx)
 }
-inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::offset() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.offset)
-  return offset_;
+inline void ReorderInfo_FixupColumns::add_pair_fixup_idx(::google::protobuf::uint32 value) {
+  pair_fixup_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.pair_fixup_idx)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_offset(::google::protobuf::uint32 value) {
-  set_has_offset();
-  offset_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.offset)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::pair_fixup_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.pair_fixup_idx)
+  return pair_fixup_idx_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_pair_fixup_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.pair_fixup_idx)
+  return &pair_fixup_idx_;
 }
 
-// required uint32 deref_sz = 2;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_deref_sz() const {
-  return (_has_bits_[0] & 0x00000004u) != 0;
+// repeated uint32 pair_delta = 20 [packed = true];
+inline int ReorderInfo_FixupColumns::pair_delta_size() const {
+  return pair_delta_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_deref_sz() {
-  _has_bits_[0] |= 0x00000004u;
+inline void ReorderInfo_FixupColumns::clear_pair_delta() {
+  pair_delta_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_deref_sz() {
-  _has_bits_[0] &= ~0x00000004u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::pair_delta(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.pair_delta)
+  return pair_delta_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_deref_sz() {
-  deref_sz_ = 0u;
-  clear_has_deref_sz();
+inline void ReorderInfo_FixupColumns::set_pair_delta(int index, ::google::protobuf::uint32 value) {
+  pair_delta_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.pair_delta)
 }
-inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::deref_sz() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.deref_sz)
-  return deref_sz_;
+inline void ReorderInfo_FixupColumns::add_pair_delta(::google::protobuf::uint32 value) {
+  pair_delta_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.pair_delta)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_deref_sz(::google::protobuf::uint32 value) {
-  set_has_deref_sz();
-  deref_sz_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.deref_sz)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::pair_delta() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.pair_delta)
+  return pair_delta_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_pair_delta() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.pair_delta)
+  return &pair_delta_;
 }
 
-// required bool is_rela = 3;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_is_rela() const {
-  return (_has_bits_[0] & 0x00000008u) != 0;
+// repeated uint32 shrink_fixup_idx = 21 [packed = true];
+inline int ReorderInfo_FixupColumns::shrink_fixup_idx_size() const {
+  return shrink_fixup_idx_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_is_rela() {
-  _has_bits_[0] |= 0x00000008u;
+inline void ReorderInfo_FixupColumns::clear_shrink_fixup_idx() {
+  shrink_fixup_idx_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_is_rela() {
-  _has_bits_[0] &= ~0x00000008u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::shrink_fixup_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.shrink_fixup_idx)
+  return shrink_fixup_idx_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_is_rela() {
-  is_rela_ = false;
-  clear_has_is_rela();
+inline void ReorderInfo_FixupColumns::set_shrink_fixup_idx(int index, ::google::protobuf::uint32 value) {
+  shrink_fixup_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.shrink_fixup_idx)
 }
-inline bool ReorderInfo_FixupInfo_FixupTuple::is_rela() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.is_rela)
-  return is_rela_;
+inline void ReorderInfo_FixupColumns::add_shrink_fixup_idx(::google::protobuf::uint32 value) {
+  shrink_fixup_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.shrink_fixup_idx)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_is_rela(bool value) {
-  set_has_is_rela();
-  is_rela_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.is_rela)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::shrink_fixup_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.shrink_fixup_idx)
+  return shrink_fixup_idx_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_shrink_fixup_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.shrink_fixup_idx)
+  return &shrink_fixup_idx_;
 }
 
-// optional uint32 type = 4;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_type() const {
-  return (_has_bits_[0] & 0x00000010u) != 0;
+// repeated uint32 shrink_long_sz = 22 [packed = true];
+inline int ReorderInfo_FixupColumns::shrink_long_sz_size() const {
+  return shrink_long_sz_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_type() {
-  _has_bits_[0] |= 0x00000010u;
+inline void ReorderInfo_FixupColumns::clear_shrink_long_sz() {
+  shrink_long_sz_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_type() {
-  _has_bits_[0] &= ~0x00000010u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::shrink_long_sz(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.shrink_long_sz)
+  return shrink_long_sz_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_type() {
-  type_ = 0u;
-  clear_has_type();
+inline void ReorderInfo_FixupColumns::set_shrink_long_sz(int index, ::google::protobuf::uint32 value) {
+  shrink_long_sz_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.shrink_long_sz)
 }
-inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::type() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.type)
-  return type_;
+inline void ReorderInfo_FixupColumns::add_shrink_long_sz(::google::protobuf::uint32 value) {
+  shrink_long_sz_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.shrink_long_sz)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_type(::google::protobuf::uint32 value) {
-  set_has_type();
-  type_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.type)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::shrink_long_sz() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.shrink_long_sz)
+  return shrink_long_sz_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_shrink_long_sz() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.shrink_long_sz)
+  return &shrink_long_sz_;
 }
 
-// optional string section_name = 5;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_section_name() const {
-  return (_has_bits_[0] & 0x00000001u) != 0;
+// repeated bytes shrink_short_form = 23;
+inline int ReorderInfo_FixupColumns::shrink_short_form_size() const {
+  return shrink_short_form_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_section_name() {
-  _has_bits_[0] |= 0x00000001u;
+inline void ReorderInfo_FixupColumns::clear_shrink_short_form() {
+  shrink_short_form_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_section_name() {
-  _has_bits_[0] &= ~0x00000001u;
+inline const ::std::string& ReorderInfo_FixupColumns::shrink_short_form(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
+  return shrink_short_form_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_section_name() {
-  section_name_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  clear_has_section_name();
+inline ::std::string* ReorderInfo_FixupColumns::mutable_shrink_short_form(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
+  return shrink_short_form_.Mutable(index);
 }
-inline const ::std::string& ReorderInfo_FixupInfo_FixupTuple::section_name() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
-  return section_name_.GetNoArena();
+inline void ReorderInfo_FixupColumns::set_shrink_short_form(int index, const ::std::string& value) {
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
+  shrink_short_form_.Mutable(index)->assign(value);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(const ::std::string& value) {
-  set_has_section_name();
-  section_name_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+inline void ReorderInfo_FixupColumns::set_shrink_short_form(int index, const char* value) {
+  shrink_short_form_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
 }
-#if LANG_CXX11
-inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(::std::string&& value) {
-  set_has_section_name();
-  section_name_.SetNoArena(
-    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
-  // @@protoc_insertion_point(field_set_rvalue:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+inline void ReorderInfo_FixupColumns::set_shrink_short_form(int index, const void* value, size_t size) {
+  shrink_short_form_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
 }
-#endif
-inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(const char* value) {
-  set_has_section_name();
-  section_name_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
-  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+inline ::std::string* ReorderInfo_FixupColumns::add_shrink_short_form() {
+  // @@protoc_insertion_point(field_add_mutable:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
+  return shrink_short_form_.Add();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_section_name(const char* value, size_t size) {
-  set_has_section_name();
-  section_name_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
-      ::std::string(reinterpret_cast<const char*>(value), size));
-  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+inline void ReorderInfo_FixupColumns::add_shrink_short_form(const ::std::string& value) {
+  shrink_short_form_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
 }
-inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::mutable_section_name() {
-  set_has_section_name();
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
-  return section_name_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void ReorderInfo_FixupColumns::add_shrink_short_form(const char* value) {
+  shrink_short_form_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
 }
-inline ::std::string* ReorderInfo_FixupInfo_FixupTuple::release_section_name() {
-  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
-  clear_has_section_name();
-  return section_name_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+inline void ReorderInfo_FixupColumns::add_shrink_short_form(const void* value, size_t size) {
+  shrink_short_form_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_allocated_section_name(::std::string* section_name) {
-  if (section_name != NULL) {
-    set_has_section_name();
-  } else {
-    clear_has_section_name();
-  }
-  section_name_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), section_name);
-  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.section_name)
+inline const ::google::protobuf::RepeatedPtrField< ::std::string>&
+ReorderInfo_FixupColumns::shrink_short_form() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
+  return shrink_short_form_;
+}
+inline ::google::protobuf::RepeatedPtrField< ::std::string>*
+ReorderInfo_FixupColumns::mutable_shrink_short_form() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.shrink_short_form)
+  return &shrink_short_form_;
 }
 
-// optional uint32 num_jt_entries = 6;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_num_jt_entries() const {
-  return (_has_bits_[0] & 0x00000020u) != 0;
+// repeated uint32 reloc_delta = 24 [packed = true];
+inline int ReorderInfo_FixupColumns::reloc_delta_size() const {
+  return reloc_delta_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_num_jt_entries() {
-  _has_bits_[0] |= 0x00000020u;
+inline void ReorderInfo_FixupColumns::clear_reloc_delta() {
+  reloc_delta_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_num_jt_entries() {
-  _has_bits_[0] &= ~0x00000020u;
+inline ::google::protobuf::uint32 ReorderInfo_FixupColumns::reloc_delta(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.reloc_delta)
+  return reloc_delta_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_num_jt_entries() {
-  num_jt_entries_ = 0u;
-  clear_has_num_jt_entries();
+inline void ReorderInfo_FixupColumns::set_reloc_delta(int index, ::google::protobuf::uint32 value) {
+  reloc_delta_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.reloc_delta)
 }
-inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::num_jt_entries() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.num_jt_entries)
-  return num_jt_entries_;
+inline void ReorderInfo_FixupColumns::add_reloc_delta(::google::protobuf::uint32 value) {
+  reloc_delta_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.reloc_delta)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_num_jt_entries(::google::protobuf::uint32 value) {
-  set_has_num_jt_entries();
-  num_jt_entries_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.num_jt_entries)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_FixupColumns::reloc_delta() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.reloc_delta)
+  return reloc_delta_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_FixupColumns::mutable_reloc_delta() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.reloc_delta)
+  return &reloc_delta_;
 }
 
-// optional uint32 jt_entry_sz = 7;
-inline bool ReorderInfo_FixupInfo_FixupTuple::has_jt_entry_sz() const {
-  return (_has_bits_[0] & 0x00000040u) != 0;
+// repeated uint64 got_relax_bits = 25 [packed = true];
+inline int ReorderInfo_FixupColumns::got_relax_bits_size() const {
+  return got_relax_bits_.size();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_has_jt_entry_sz() {
-  _has_bits_[0] |= 0x00000040u;
+inline void ReorderInfo_FixupColumns::clear_got_relax_bits() {
+  got_relax_bits_.Clear();
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_has_jt_entry_sz() {
-  _has_bits_[0] &= ~0x00000040u;
+inline ::google::protobuf::uint64 ReorderInfo_FixupColumns::got_relax_bits(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupColumns.got_relax_bits)
+  return got_relax_bits_.Get(index);
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::clear_jt_entry_sz() {
-  jt_entry_sz_ = 0u;
-  clear_has_jt_entry_sz();
+inline void ReorderInfo_FixupColumns::set_got_relax_bits(int index, ::google::protobuf::uint64 value) {
+  got_relax_bits_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupColumns.got_relax_bits)
 }
-inline ::google::protobuf::uint32 ReorderInfo_FixupInfo_FixupTuple::jt_entry_sz() const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.jt_entry_sz)
-  return jt_entry_sz_;
+inline void ReorderInfo_FixupColumns::add_got_relax_bits(::google::protobuf::uint64 value) {
+  got_relax_bits_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupColumns.got_relax_bits)
 }
-inline void ReorderInfo_FixupInfo_FixupTuple::set_jt_entry_sz(::google::protobuf::uint32 value) {
-  set_has_jt_entry_sz();
-  jt_entry_sz_ = value;
-  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple.jt_entry_sz)
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_FixupColumns::got_relax_bits() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupColumns.got_relax_bits)
+  return got_relax_bits_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_FixupColumns::mutable_got_relax_bits() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupColumns.got_relax_bits)
+  return &got_relax_bits_;
 }
 
 // -------------------------------------------------------------------
 
-// ReorderInfo_FixupInfo
+// ReorderInfo_CallSiteColumns
 
-// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple text = 1;
-inline int ReorderInfo_FixupInfo::text_size() const {
-  return text_.size();
+// repeated uint64 function_offset = 1 [packed = true];
+inline int ReorderInfo_CallSiteColumns::function_offset_size() const {
+  return function_offset_.size();
 }
-inline void ReorderInfo_FixupInfo::clear_text() {
-  text_.Clear();
+inline void ReorderInfo_CallSiteColumns::clear_function_offset() {
+  function_offset_.Clear();
 }
-inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::text(int index) const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.text)
-  return text_.Get(index);
+inline ::google::protobuf::uint64 ReorderInfo_CallSiteColumns::function_offset(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.CallSiteColumns.function_offset)
+  return function_offset_.Get(index);
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_text(int index) {
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.text)
-  return text_.Mutable(index);
+inline void ReorderInfo_CallSiteColumns::set_function_offset(int index, ::google::protobuf::uint64 value) {
+  function_offset_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.CallSiteColumns.function_offset)
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_text() {
-  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.text)
-  return text_.Add();
+inline void ReorderInfo_CallSiteColumns::add_function_offset(::google::protobuf::uint64 value) {
+  function_offset_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.CallSiteColumns.function_offset)
 }
-inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
-ReorderInfo_FixupInfo::mutable_text() {
-  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.text)
-  return &text_;
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_CallSiteColumns::function_offset() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.CallSiteColumns.function_offset)
+  return function_offset_;
 }
-inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
-ReorderInfo_FixupInfo::text() const {
-  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.text)
-  return text_;
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_CallSiteColumns::mutable_function_offset() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.CallSiteColumns.function_offset)
+  return &function_offset_;
 }
 
-// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple rodata = 2;
-inline int ReorderInfo_FixupInfo::rodata_size() const {
-  return rodata_.size();
+// repeated uint32 function_section_idx = 2 [packed = true];
+inline int ReorderInfo_CallSiteColumns::function_section_idx_size() const {
+  return function_section_idx_.size();
 }
-inline void ReorderInfo_FixupInfo::clear_rodata() {
-  rodata_.Clear();
+inline void ReorderInfo_CallSiteColumns::clear_function_section_idx() {
+  function_section_idx_.Clear();
 }
-inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::rodata(int index) const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
-  return rodata_.Get(index);
+inline ::google::protobuf::uint32 ReorderInfo_CallSiteColumns::function_section_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.CallSiteColumns.function_section_idx)
+  return function_section_idx_.Get(index);
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_rodata(int index) {
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
-  return rodata_.Mutable(index);
+inline void ReorderInfo_CallSiteColumns::set_function_section_idx(int index, ::google::protobuf::uint32 value) {
+  function_section_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.CallSiteColumns.function_section_idx)
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_rodata() {
-  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
-  return rodata_.Add();
+inline void ReorderInfo_CallSiteColumns::add_function_section_idx(::google::protobuf::uint32 value) {
+  function_section_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.CallSiteColumns.function_section_idx)
 }
-inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
-ReorderInfo_FixupInfo::mutable_rodata() {
-  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
-  return &rodata_;
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_CallSiteColumns::function_section_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.CallSiteColumns.function_section_idx)
+  return function_section_idx_;
 }
-inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
-ReorderInfo_FixupInfo::rodata() const {
-  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.rodata)
-  return rodata_;
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_CallSiteColumns::mutable_function_section_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.CallSiteColumns.function_section_idx)
+  return &function_section_idx_;
 }
 
-// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple data = 3;
-inline int ReorderInfo_FixupInfo::data_size() const {
-  return data_.size();
+// repeated uint64 table_offset = 3 [packed = true];
+inline int ReorderInfo_CallSiteColumns::table_offset_size() const {
+  return table_offset_.size();
 }
-inline void ReorderInfo_FixupInfo::clear_data() {
-  data_.Clear();
+inline void ReorderInfo_CallSiteColumns::clear_table_offset() {
+  table_offset_.Clear();
 }
-inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::data(int index) const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.data)
-  return data_.Get(index);
+inline ::google::protobuf::uint64 ReorderInfo_CallSiteColumns::table_offset(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.CallSiteColumns.table_offset)
+  return table_offset_.Get(index);
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_data(int index) {
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.data)
-  return data_.Mutable(index);
+inline void ReorderInfo_CallSiteColumns::set_table_offset(int index, ::google::protobuf::uint64 value) {
+  table_offset_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.CallSiteColumns.table_offset)
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_data() {
-  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.data)
-  return data_.Add();
+inline void ReorderInfo_CallSiteColumns::add_table_offset(::google::protobuf::uint64 value) {
+  table_offset_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.CallSiteColumns.table_offset)
 }
-inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
-ReorderInfo_FixupInfo::mutable_data() {
-  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.data)
-  return &data_;
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >&
+ReorderInfo_CallSiteColumns::table_offset() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.CallSiteColumns.table_offset)
+  return table_offset_;
 }
-inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
-ReorderInfo_FixupInfo::data() const {
-  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.data)
-  return data_;
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint64 >*
+ReorderInfo_CallSiteColumns::mutable_table_offset() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.CallSiteColumns.table_offset)
+  return &table_offset_;
 }
 
-// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple datarel = 4;
-inline int ReorderInfo_FixupInfo::datarel_size() const {
-  return datarel_.size();
+// repeated uint32 table_section_idx = 4 [packed = true];
+inline int ReorderInfo_CallSiteColumns::table_section_idx_size() const {
+  return table_section_idx_.size();
 }
-inline void ReorderInfo_FixupInfo::clear_datarel() {
-  datarel_.Clear();
+inline void ReorderInfo_CallSiteColumns::clear_table_section_idx() {
+  table_section_idx_.Clear();
 }
-inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::datarel(int index) const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
-  return datarel_.Get(index);
+inline ::google::protobuf::uint32 ReorderInfo_CallSiteColumns::table_section_idx(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.CallSiteColumns.table_section_idx)
+  return table_section_idx_.Get(index);
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_datarel(int index) {
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
-  return datarel_.Mutable(index);
+inline void ReorderInfo_CallSiteColumns::set_table_section_idx(int index, ::google::protobuf::uint32 value) {
+  table_section_idx_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.CallSiteColumns.table_section_idx)
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_datarel() {
-  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
-  return datarel_.Add();
+inline void ReorderInfo_CallSiteColumns::add_table_section_idx(::google::protobuf::uint32 value) {
+  table_section_idx_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.CallSiteColumns.table_section_idx)
 }
-inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
-ReorderInfo_FixupInfo::mutable_datarel() {
-  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
-  return &datarel_;
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_CallSiteColumns::table_section_idx() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.CallSiteColumns.table_section_idx)
+  return table_section_idx_;
 }
-inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
-ReorderInfo_FixupInfo::datarel() const {
-  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.datarel)
-  return datarel_;
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_CallSiteColumns::mutable_table_section_idx() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.CallSiteColumns.table_section_idx)
+  return &table_section_idx_;
 }
 
-// repeated .ShuffleInfo.ReorderInfo.FixupInfo.FixupTuple initarray = 5;
-inline int ReorderInfo_FixupInfo::initarray_size() const {
-  return initarray_.size();
-}
-inline void ReorderInfo_FixupInfo::clear_initarray() {
-  initarray_.Clear();
-}
-inline const ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple& ReorderInfo_FixupInfo::initarray(int index) const {
-  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
-  return initarray_.Get(index);
+// repeated uint32 num_records = 5 [packed = true];
+inline int ReorderInfo_CallSiteColumns::num_records_size() const {
+  return num_records_.size();
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::mutable_initarray(int index) {
-  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
-  return initarray_.Mutable(index);
+inline void ReorderInfo_CallSiteColumns::clear_num_records() {
+  num_records_.Clear();
 }
-inline ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* ReorderInfo_FixupInfo::add_initarray() {
-  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
-  return initarray_.Add();
+inline ::google::protobuf::uint32 ReorderInfo_CallSiteColumns::num_records(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.CallSiteColumns.num_records)
+  return num_records_.Get(index);
 }
-inline ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >*
-ReorderInfo_FixupInfo::mutable_initarray() {
-  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
-  return &initarray_;
+inline void ReorderInfo_CallSiteColumns::set_num_records(int index, ::google::protobuf::uint32 value) {
+  num_records_.Set(index, value);
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.CallSiteColumns.num_records)
 }
-inline const ::google::protobuf::RepeatedPtrField< ::ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple >&
-ReorderInfo_FixupInfo::initarray() const {
-  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.FixupInfo.initarray)
-  return initarray_;
+inline void ReorderInfo_CallSiteColumns::add_num_records(::google::protobuf::uint32 value) {
+  num_records_.Add(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.CallSiteColumns.num_records)
+}
+inline const ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >&
+ReorderInfo_CallSiteColumns::num_records() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.CallSiteColumns.num_records)
+  return num_records_;
+}
+inline ::google::protobuf::RepeatedField< ::google::protobuf::uint32 >*
+ReorderInfo_CallSiteColumns::mutable_num_records() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.CallSiteColumns.num_records)
+  return &num_records_;
 }
 
 // -------------------------------------------------------------------
@@ -1587,7 +5779,7 @@ inline const ::ShuffleInfo::ReorderInfo_BinaryInfo& ReorderInfo::bin() const {
 inline ::ShuffleInfo::ReorderInfo_BinaryInfo* ReorderInfo::mutable_bin() {
   set_has_bin();
   if (bin_ == NULL) {
-    bin_ = new ::ShuffleInfo::ReorderInfo_BinaryInfo;
+    _slow_mutable_bin();
   }
   // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.bin)
   return bin_;
@@ -1595,12 +5787,22 @@ inline ::ShuffleInfo::ReorderInfo_BinaryInfo* ReorderInfo::mutable_bin() {
 inline ::ShuffleInfo::ReorderInfo_BinaryInfo* ReorderInfo::release_bin() {
   // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.bin)
   clear_has_bin();
-  ::ShuffleInfo::ReorderInfo_BinaryInfo* temp = bin_;
-  bin_ = NULL;
-  return temp;
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_bin();
+  } else {
+    ::ShuffleInfo::ReorderInfo_BinaryInfo* temp = bin_;
+    bin_ = NULL;
+    return temp;
+  }
 }
-inline void ReorderInfo::set_allocated_bin(::ShuffleInfo::ReorderInfo_BinaryInfo* bin) {
-  delete bin_;
+inline  void ReorderInfo::set_allocated_bin(::ShuffleInfo::ReorderInfo_BinaryInfo* bin) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete bin_;
+  }
+  if (bin != NULL) {
+    _slow_set_allocated_bin(message_arena, &bin);
+  }
   bin_ = bin;
   if (bin) {
     set_has_bin();
@@ -1692,7 +5894,7 @@ inline const ::ShuffleInfo::ReorderInfo_SourceInfo& ReorderInfo::source() const
 inline ::ShuffleInfo::ReorderInfo_SourceInfo* ReorderInfo::mutable_source() {
   set_has_source();
   if (source_ == NULL) {
-    source_ = new ::ShuffleInfo::ReorderInfo_SourceInfo;
+    _slow_mutable_source();
   }
   // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.source)
   return source_;
@@ -1700,12 +5902,22 @@ inline ::ShuffleInfo::ReorderInfo_SourceInfo* ReorderInfo::mutable_source() {
 inline ::ShuffleInfo::ReorderInfo_SourceInfo* ReorderInfo::release_source() {
   // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.source)
   clear_has_source();
-  ::ShuffleInfo::ReorderInfo_SourceInfo* temp = source_;
-  source_ = NULL;
-  return temp;
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_source();
+  } else {
+    ::ShuffleInfo::ReorderInfo_SourceInfo* temp = source_;
+    source_ = NULL;
+    return temp;
+  }
 }
-inline void ReorderInfo::set_allocated_source(::ShuffleInfo::ReorderInfo_SourceInfo* source) {
-  delete source_;
+inline  void ReorderInfo::set_allocated_source(::ShuffleInfo::ReorderInfo_SourceInfo* source) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete source_;
+  }
+  if (source != NULL) {
+    _slow_set_allocated_source(message_arena, &source);
+  }
   source_ = source;
   if (source) {
     set_has_source();
@@ -1715,6 +5927,776 @@ inline void ReorderInfo::set_allocated_source(::ShuffleInfo::ReorderInfo_SourceI
   // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.source)
 }
 
+// repeated string section_names = 5;
+inline int ReorderInfo::section_names_size() const {
+  return section_names_.size();
+}
+inline void ReorderInfo::clear_section_names() {
+  section_names_.Clear();
+}
+inline const ::std::string& ReorderInfo::section_names(int index) const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.section_names)
+  return section_names_.Get(index);
+}
+inline ::std::string* ReorderInfo::mutable_section_names(int index) {
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.section_names)
+  return section_names_.Mutable(index);
+}
+inline void ReorderInfo::set_section_names(int index, const ::std::string& value) {
+  // @@protoc_insertion_point(field_set:ShuffleInfo.ReorderInfo.section_names)
+  section_names_.Mutable(index)->assign(value);
+}
+inline void ReorderInfo::set_section_names(int index, const char* value) {
+  section_names_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:ShuffleInfo.ReorderInfo.section_names)
+}
+inline void ReorderInfo::set_section_names(int index, const char* value, size_t size) {
+  section_names_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:ShuffleInfo.ReorderInfo.section_names)
+}
+inline ::std::string* ReorderInfo::add_section_names() {
+  // @@protoc_insertion_point(field_add_mutable:ShuffleInfo.ReorderInfo.section_names)
+  return section_names_.Add();
+}
+inline void ReorderInfo::add_section_names(const ::std::string& value) {
+  section_names_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:ShuffleInfo.ReorderInfo.section_names)
+}
+inline void ReorderInfo::add_section_names(const char* value) {
+  section_names_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:ShuffleInfo.ReorderInfo.section_names)
+}
+inline void ReorderInfo::add_section_names(const char* value, size_t size) {
+  section_names_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:ShuffleInfo.ReorderInfo.section_names)
+}
+inline const ::google::protobuf::RepeatedPtrField< ::std::string>&
+ReorderInfo::section_names() const {
+  // @@protoc_insertion_point(field_list:ShuffleInfo.ReorderInfo.section_names)
+  return section_names_;
+}
+inline ::google::protobuf::RepeatedPtrField< ::std::string>*
+ReorderInfo::mutable_section_names() {
+  // @@protoc_insertion_point(field_mutable_list:ShuffleInfo.ReorderInfo.section_names)
+  return &section_names_;
+}
+
+// optional .ShuffleInfo.ReorderInfo.LayoutColumns layout_columns = 6;
+inline bool ReorderInfo::has_layout_columns() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void ReorderInfo::set_has_layout_columns() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void ReorderInfo::clear_has_layout_columns() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void ReorderInfo::clear_layout_columns() {
+  if (layout_columns_ != NULL) layout_columns_->::ShuffleInfo::ReorderInfo_LayoutColumns::Clear();
+  clear_has_layout_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_LayoutColumns& ReorderInfo::layout_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.layout_columns)
+  return layout_columns_ != NULL ? *layout_columns_
+                         : *::ShuffleInfo::ReorderInfo_LayoutColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_LayoutColumns* ReorderInfo::mutable_layout_columns() {
+  set_has_layout_columns();
+  if (layout_columns_ == NULL) {
+    _slow_mutable_layout_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.layout_columns)
+  return layout_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_LayoutColumns* ReorderInfo::release_layout_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.layout_columns)
+  clear_has_layout_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_layout_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_LayoutColumns* temp = layout_columns_;
+    layout_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_layout_columns(::ShuffleInfo::ReorderInfo_LayoutColumns* layout_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete layout_columns_;
+  }
+  if (layout_columns != NULL) {
+    _slow_set_allocated_layout_columns(message_arena, &layout_columns);
+  }
+  layout_columns_ = layout_columns;
+  if (layout_columns) {
+    set_has_layout_columns();
+  } else {
+    clear_has_layout_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.layout_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns text_fixup_columns = 7;
+inline bool ReorderInfo::has_text_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
+inline void ReorderInfo::set_has_text_fixup_columns() {
+  _has_bits_[0] |= 0x00000008u;
+}
+inline void ReorderInfo::clear_has_text_fixup_columns() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline void ReorderInfo::clear_text_fixup_columns() {
+  if (text_fixup_columns_ != NULL) text_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_text_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::text_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.text_fixup_columns)
+  return text_fixup_columns_ != NULL ? *text_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_text_fixup_columns() {
+  set_has_text_fixup_columns();
+  if (text_fixup_columns_ == NULL) {
+    _slow_mutable_text_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.text_fixup_columns)
+  return text_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_text_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.text_fixup_columns)
+  clear_has_text_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_text_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = text_fixup_columns_;
+    text_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_text_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* text_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete text_fixup_columns_;
+  }
+  if (text_fixup_columns != NULL) {
+    _slow_set_allocated_text_fixup_columns(message_arena, &text_fixup_columns);
+  }
+  text_fixup_columns_ = text_fixup_columns;
+  if (text_fixup_columns) {
+    set_has_text_fixup_columns();
+  } else {
+    clear_has_text_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.text_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns rodata_fixup_columns = 8;
+inline bool ReorderInfo::has_rodata_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+inline void ReorderInfo::set_has_rodata_fixup_columns() {
+  _has_bits_[0] |= 0x00000010u;
+}
+inline void ReorderInfo::clear_has_rodata_fixup_columns() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline void ReorderInfo::clear_rodata_fixup_columns() {
+  if (rodata_fixup_columns_ != NULL) rodata_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_rodata_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::rodata_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.rodata_fixup_columns)
+  return rodata_fixup_columns_ != NULL ? *rodata_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_rodata_fixup_columns() {
+  set_has_rodata_fixup_columns();
+  if (rodata_fixup_columns_ == NULL) {
+    _slow_mutable_rodata_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.rodata_fixup_columns)
+  return rodata_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_rodata_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.rodata_fixup_columns)
+  clear_has_rodata_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_rodata_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = rodata_fixup_columns_;
+    rodata_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_rodata_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* rodata_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete rodata_fixup_columns_;
+  }
+  if (rodata_fixup_columns != NULL) {
+    _slow_set_allocated_rodata_fixup_columns(message_arena, &rodata_fixup_columns);
+  }
+  rodata_fixup_columns_ = rodata_fixup_columns;
+  if (rodata_fixup_columns) {
+    set_has_rodata_fixup_columns();
+  } else {
+    clear_has_rodata_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.rodata_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns data_fixup_columns = 9;
+inline bool ReorderInfo::has_data_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+inline void ReorderInfo::set_has_data_fixup_columns() {
+  _has_bits_[0] |= 0x00000020u;
+}
+inline void ReorderInfo::clear_has_data_fixup_columns() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline void ReorderInfo::clear_data_fixup_columns() {
+  if (data_fixup_columns_ != NULL) data_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_data_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::data_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.data_fixup_columns)
+  return data_fixup_columns_ != NULL ? *data_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_data_fixup_columns() {
+  set_has_data_fixup_columns();
+  if (data_fixup_columns_ == NULL) {
+    _slow_mutable_data_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.data_fixup_columns)
+  return data_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_data_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.data_fixup_columns)
+  clear_has_data_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_data_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = data_fixup_columns_;
+    data_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_data_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* data_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete data_fixup_columns_;
+  }
+  if (data_fixup_columns != NULL) {
+    _slow_set_allocated_data_fixup_columns(message_arena, &data_fixup_columns);
+  }
+  data_fixup_columns_ = data_fixup_columns;
+  if (data_fixup_columns) {
+    set_has_data_fixup_columns();
+  } else {
+    clear_has_data_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.data_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns datarel_fixup_columns = 10;
+inline bool ReorderInfo::has_datarel_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+inline void ReorderInfo::set_has_datarel_fixup_columns() {
+  _has_bits_[0] |= 0x00000040u;
+}
+inline void ReorderInfo::clear_has_datarel_fixup_columns() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline void ReorderInfo::clear_datarel_fixup_columns() {
+  if (datarel_fixup_columns_ != NULL) datarel_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_datarel_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::datarel_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.datarel_fixup_columns)
+  return datarel_fixup_columns_ != NULL ? *datarel_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_datarel_fixup_columns() {
+  set_has_datarel_fixup_columns();
+  if (datarel_fixup_columns_ == NULL) {
+    _slow_mutable_datarel_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.datarel_fixup_columns)
+  return datarel_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_datarel_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.datarel_fixup_columns)
+  clear_has_datarel_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_datarel_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = datarel_fixup_columns_;
+    datarel_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_datarel_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* datarel_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete datarel_fixup_columns_;
+  }
+  if (datarel_fixup_columns != NULL) {
+    _slow_set_allocated_datarel_fixup_columns(message_arena, &datarel_fixup_columns);
+  }
+  datarel_fixup_columns_ = datarel_fixup_columns;
+  if (datarel_fixup_columns) {
+    set_has_datarel_fixup_columns();
+  } else {
+    clear_has_datarel_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.datarel_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns initarray_fixup_columns = 11;
+inline bool ReorderInfo::has_initarray_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void ReorderInfo::set_has_initarray_fixup_columns() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void ReorderInfo::clear_has_initarray_fixup_columns() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void ReorderInfo::clear_initarray_fixup_columns() {
+  if (initarray_fixup_columns_ != NULL) initarray_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_initarray_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::initarray_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.initarray_fixup_columns)
+  return initarray_fixup_columns_ != NULL ? *initarray_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_initarray_fixup_columns() {
+  set_has_initarray_fixup_columns();
+  if (initarray_fixup_columns_ == NULL) {
+    _slow_mutable_initarray_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.initarray_fixup_columns)
+  return initarray_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_initarray_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.initarray_fixup_columns)
+  clear_has_initarray_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_initarray_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = initarray_fixup_columns_;
+    initarray_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_initarray_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* initarray_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete initarray_fixup_columns_;
+  }
+  if (initarray_fixup_columns != NULL) {
+    _slow_set_allocated_initarray_fixup_columns(message_arena, &initarray_fixup_columns);
+  }
+  initarray_fixup_columns_ = initarray_fixup_columns;
+  if (initarray_fixup_columns) {
+    set_has_initarray_fixup_columns();
+  } else {
+    clear_has_initarray_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.initarray_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns finiarray_fixup_columns = 12;
+inline bool ReorderInfo::has_finiarray_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+inline void ReorderInfo::set_has_finiarray_fixup_columns() {
+  _has_bits_[0] |= 0x00000100u;
+}
+inline void ReorderInfo::clear_has_finiarray_fixup_columns() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline void ReorderInfo::clear_finiarray_fixup_columns() {
+  if (finiarray_fixup_columns_ != NULL) finiarray_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_finiarray_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::finiarray_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.finiarray_fixup_columns)
+  return finiarray_fixup_columns_ != NULL ? *finiarray_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_finiarray_fixup_columns() {
+  set_has_finiarray_fixup_columns();
+  if (finiarray_fixup_columns_ == NULL) {
+    _slow_mutable_finiarray_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.finiarray_fixup_columns)
+  return finiarray_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_finiarray_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.finiarray_fixup_columns)
+  clear_has_finiarray_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_finiarray_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = finiarray_fixup_columns_;
+    finiarray_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_finiarray_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* finiarray_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete finiarray_fixup_columns_;
+  }
+  if (finiarray_fixup_columns != NULL) {
+    _slow_set_allocated_finiarray_fixup_columns(message_arena, &finiarray_fixup_columns);
+  }
+  finiarray_fixup_columns_ = finiarray_fixup_columns;
+  if (finiarray_fixup_columns) {
+    set_has_finiarray_fixup_columns();
+  } else {
+    clear_has_finiarray_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.finiarray_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns tdata_fixup_columns = 13;
+inline bool ReorderInfo::has_tdata_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000200u) != 0;
+}
+inline void ReorderInfo::set_has_tdata_fixup_columns() {
+  _has_bits_[0] |= 0x00000200u;
+}
+inline void ReorderInfo::clear_has_tdata_fixup_columns() {
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline void ReorderInfo::clear_tdata_fixup_columns() {
+  if (tdata_fixup_columns_ != NULL) tdata_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_tdata_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::tdata_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.tdata_fixup_columns)
+  return tdata_fixup_columns_ != NULL ? *tdata_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_tdata_fixup_columns() {
+  set_has_tdata_fixup_columns();
+  if (tdata_fixup_columns_ == NULL) {
+    _slow_mutable_tdata_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.tdata_fixup_columns)
+  return tdata_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_tdata_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.tdata_fixup_columns)
+  clear_has_tdata_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_tdata_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = tdata_fixup_columns_;
+    tdata_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_tdata_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* tdata_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete tdata_fixup_columns_;
+  }
+  if (tdata_fixup_columns != NULL) {
+    _slow_set_allocated_tdata_fixup_columns(message_arena, &tdata_fixup_columns);
+  }
+  tdata_fixup_columns_ = tdata_fixup_columns;
+  if (tdata_fixup_columns) {
+    set_has_tdata_fixup_columns();
+  } else {
+    clear_has_tdata_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.tdata_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.CallSiteColumns call_site_columns = 14;
+inline bool ReorderInfo::has_call_site_columns() const {
+  return (_has_bits_[0] & 0x00000400u) != 0;
+}
+inline void ReorderInfo::set_has_call_site_columns() {
+  _has_bits_[0] |= 0x00000400u;
+}
+inline void ReorderInfo::clear_has_call_site_columns() {
+  _has_bits_[0] &= ~0x00000400u;
+}
+inline void ReorderInfo::clear_call_site_columns() {
+  if (call_site_columns_ != NULL) call_site_columns_->::ShuffleInfo::ReorderInfo_CallSiteColumns::Clear();
+  clear_has_call_site_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_CallSiteColumns& ReorderInfo::call_site_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.call_site_columns)
+  return call_site_columns_ != NULL ? *call_site_columns_
+                         : *::ShuffleInfo::ReorderInfo_CallSiteColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_CallSiteColumns* ReorderInfo::mutable_call_site_columns() {
+  set_has_call_site_columns();
+  if (call_site_columns_ == NULL) {
+    _slow_mutable_call_site_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.call_site_columns)
+  return call_site_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_CallSiteColumns* ReorderInfo::release_call_site_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.call_site_columns)
+  clear_has_call_site_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_call_site_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_CallSiteColumns* temp = call_site_columns_;
+    call_site_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_call_site_columns(::ShuffleInfo::ReorderInfo_CallSiteColumns* call_site_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete call_site_columns_;
+  }
+  if (call_site_columns != NULL) {
+    _slow_set_allocated_call_site_columns(message_arena, &call_site_columns);
+  }
+  call_site_columns_ = call_site_columns;
+  if (call_site_columns) {
+    set_has_call_site_columns();
+  } else {
+    clear_has_call_site_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.call_site_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns xray_fixup_columns = 15;
+inline bool ReorderInfo::has_xray_fixup_columns() const {
+  return (_has_bits_[0] & 0x00000800u) != 0;
+}
+inline void ReorderInfo::set_has_xray_fixup_columns() {
+  _has_bits_[0] |= 0x00000800u;
+}
+inline void ReorderInfo::clear_has_xray_fixup_columns() {
+  _has_bits_[0] &= ~0x00000800u;
+}
+inline void ReorderInfo::clear_xray_fixup_columns() {
+  if (xray_fixup_columns_ != NULL) xray_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_xray_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::xray_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.xray_fixup_columns)
+  return xray_fixup_columns_ != NULL ? *xray_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_xray_fixup_columns() {
+  set_has_xray_fixup_columns();
+  if (xray_fixup_columns_ == NULL) {
+    _slow_mutable_xray_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.xray_fixup_columns)
+  return xray_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_xray_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.xray_fixup_columns)
+  clear_has_xray_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_xray_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = xray_fixup_columns_;
+    xray_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_xray_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* xray_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete xray_fixup_columns_;
+  }
+  if (xray_fixup_columns != NULL) {
+    _slow_set_allocated_xray_fixup_columns(message_arena, &xray_fixup_columns);
+  }
+  xray_fixup_columns_ = xray_fixup_columns;
+  if (xray_fixup_columns) {
+    set_has_xray_fixup_columns();
+  } else {
+    clear_has_xray_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.xray_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns patchable_fixup_columns = 16;
+inline bool ReorderInfo::has_patchable_fixup_columns() const {
+  return (_has_bits_[0] & 0x00001000u) != 0;
+}
+inline void ReorderInfo::set_has_patchable_fixup_columns() {
+  _has_bits_[0] |= 0x00001000u;
+}
+inline void ReorderInfo::clear_has_patchable_fixup_columns() {
+  _has_bits_[0] &= ~0x00001000u;
+}
+inline void ReorderInfo::clear_patchable_fixup_columns() {
+  if (patchable_fixup_columns_ != NULL) patchable_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_patchable_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::patchable_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.patchable_fixup_columns)
+  return patchable_fixup_columns_ != NULL ? *patchable_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_patchable_fixup_columns() {
+  set_has_patchable_fixup_columns();
+  if (patchable_fixup_columns_ == NULL) {
+    _slow_mutable_patchable_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.patchable_fixup_columns)
+  return patchable_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_patchable_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.patchable_fixup_columns)
+  clear_has_patchable_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_patchable_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = patchable_fixup_columns_;
+    patchable_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_patchable_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* patchable_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete patchable_fixup_columns_;
+  }
+  if (patchable_fixup_columns != NULL) {
+    _slow_set_allocated_patchable_fixup_columns(message_arena, &patchable_fixup_columns);
+  }
+  patchable_fixup_columns_ = patchable_fixup_columns;
+  if (patchable_fixup_columns) {
+    set_has_patchable_fixup_columns();
+  } else {
+    clear_has_patchable_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.patchable_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns jumptable_fixup_columns = 17;
+inline bool ReorderInfo::has_jumptable_fixup_columns() const {
+  return (_has_bits_[0] & 0x00002000u) != 0;
+}
+inline void ReorderInfo::set_has_jumptable_fixup_columns() {
+  _has_bits_[0] |= 0x00002000u;
+}
+inline void ReorderInfo::clear_has_jumptable_fixup_columns() {
+  _has_bits_[0] &= ~0x00002000u;
+}
+inline void ReorderInfo::clear_jumptable_fixup_columns() {
+  if (jumptable_fixup_columns_ != NULL) jumptable_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_jumptable_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::jumptable_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.jumptable_fixup_columns)
+  return jumptable_fixup_columns_ != NULL ? *jumptable_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_jumptable_fixup_columns() {
+  set_has_jumptable_fixup_columns();
+  if (jumptable_fixup_columns_ == NULL) {
+    _slow_mutable_jumptable_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.jumptable_fixup_columns)
+  return jumptable_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_jumptable_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.jumptable_fixup_columns)
+  clear_has_jumptable_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_jumptable_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = jumptable_fixup_columns_;
+    jumptable_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_jumptable_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* jumptable_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete jumptable_fixup_columns_;
+  }
+  if (jumptable_fixup_columns != NULL) {
+    _slow_set_allocated_jumptable_fixup_columns(message_arena, &jumptable_fixup_columns);
+  }
+  jumptable_fixup_columns_ = jumptable_fixup_columns;
+  if (jumptable_fixup_columns) {
+    set_has_jumptable_fixup_columns();
+  } else {
+    clear_has_jumptable_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.jumptable_fixup_columns)
+}
+
+// optional .ShuffleInfo.ReorderInfo.FixupColumns custom_fixup_columns = 18;
+inline bool ReorderInfo::has_custom_fixup_columns() const {
+  return (_has_bits_[0] & 0x00004000u) != 0;
+}
+inline void ReorderInfo::set_has_custom_fixup_columns() {
+  _has_bits_[0] |= 0x00004000u;
+}
+inline void ReorderInfo::clear_has_custom_fixup_columns() {
+  _has_bits_[0] &= ~0x00004000u;
+}
+inline void ReorderInfo::clear_custom_fixup_columns() {
+  if (custom_fixup_columns_ != NULL) custom_fixup_columns_->::ShuffleInfo::ReorderInfo_FixupColumns::Clear();
+  clear_has_custom_fixup_columns();
+}
+inline const ::ShuffleInfo::ReorderInfo_FixupColumns& ReorderInfo::custom_fixup_columns() const {
+  // @@protoc_insertion_point(field_get:ShuffleInfo.ReorderInfo.custom_fixup_columns)
+  return custom_fixup_columns_ != NULL ? *custom_fixup_columns_
+                         : *::ShuffleInfo::ReorderInfo_FixupColumns::internal_default_instance();
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::mutable_custom_fixup_columns() {
+  set_has_custom_fixup_columns();
+  if (custom_fixup_columns_ == NULL) {
+    _slow_mutable_custom_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_mutable:ShuffleInfo.ReorderInfo.custom_fixup_columns)
+  return custom_fixup_columns_;
+}
+inline ::ShuffleInfo::ReorderInfo_FixupColumns* ReorderInfo::release_custom_fixup_columns() {
+  // @@protoc_insertion_point(field_release:ShuffleInfo.ReorderInfo.custom_fixup_columns)
+  clear_has_custom_fixup_columns();
+  if (GetArenaNoVirtual() != NULL) {
+    return _slow_release_custom_fixup_columns();
+  } else {
+    ::ShuffleInfo::ReorderInfo_FixupColumns* temp = custom_fixup_columns_;
+    custom_fixup_columns_ = NULL;
+    return temp;
+  }
+}
+inline  void ReorderInfo::set_allocated_custom_fixup_columns(::ShuffleInfo::ReorderInfo_FixupColumns* custom_fixup_columns) {
+  ::google::protobuf::Arena* message_arena = GetArenaNoVirtual();
+  if (message_arena == NULL) {
+    delete custom_fixup_columns_;
+  }
+  if (custom_fixup_columns != NULL) {
+    _slow_set_allocated_custom_fixup_columns(message_arena, &custom_fixup_columns);
+  }
+  custom_fixup_columns_ = custom_fixup_columns;
+  if (custom_fixup_columns) {
+    set_has_custom_fixup_columns();
+  } else {
+    clear_has_custom_fixup_columns();
+  }
+  // @@protoc_insertion_point(field_set_allocated:ShuffleInfo.ReorderInfo.custom_fixup_columns)
+}
+
 #endif  // !PROTOBUF_INLINE_NOT_IN_HEADERS
 // -------------------------------------------------------------------
 
@@ -1726,6 +6708,12 @@ inline void ReorderInfo::set_allocated_source(::ShuffleInfo::ReorderInfo_SourceI
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -0,0 +1,127 @@
+// Koo: The encoder of the fixups of a ReorderInfo (the .rand section), shared
+// by the assemblers of every LLVM tree (3.9, 6.0 and 9.0), which link it from
+// libshuffleInfo.a along with the generated messages. An assembler collects the
+// fixups as FixupRecord (or a type derived from it) and hands them over to the
+// v1 tuples (SetFixupTuple()) or to the v2 columns (FixupColumnsWriter); what
+// an assembler collects and how is left to the hooks of its own tree.
+//
+// The header has no protobuf dependency, thus the record types of the trees
+// may derive from FixupRecord; the messages are only declared.
+
+#ifndef SHUFFLEINFO_WRITER_H
+#define SHUFFLEINFO_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ShuffleInfo {
+
+class ReorderInfo;
+class ReorderInfo_FixupInfo;
+class ReorderInfo_FixupInfo_FixupTuple;
+class ReorderInfo_FixupColumns;
+
+// The fixup lists of a ReorderInfo, in the order of the FixupInfo fields (and
+// of the *_fixup_columns ones)
+enum FixupList {
+  FL_Text = 0,
+  FL_Rodata,
+  FL_Data,
+  FL_DataRel, // .data.rel.ro(.local)
+  FL_InitArray,
+  FL_FiniArray,
+  FL_TData,
+  FL_XRay,
+  FL_PatchableEntries,
+  FL_JumpTable,
+  FL_Custom,
+  NumFixupLists
+};
+
+// What the encoder writes of a fixup. TargetKind, RefClass, Scope and GOTRelax
+// hold the values of the target, ref_class, scope and got_relax fields; the
+// fields left at 0 (or false) are not written. The section of a fixup is
+// written by the caller: a section_idx into the section names, or a
+// section_name (v1 of LLVM 3.9/6.0).
+struct FixupRecord {
+  uint64_t Offset;
+  uint32_t SectionIdx;
+  uint32_t NumJTEntries;
+  uint32_t RelocIdx;   // 1 + its relocation index in its section (0: resolved)
+  uint8_t DerefSize;
+  uint8_t JTEntrySize;
+  uint8_t ReachLog2;
+  uint8_t TargetKind;  // 0: unknown, 1: code, 2: data
+  uint8_t RefClass;    // 0: direct, 1: PLT, 2: GOT, 3: TLS
+  uint8_t Scope;       // 0: external, 1: intra-object, 2: intra-function
+  uint8_t PairDelta;
+  uint8_t GOTRelax;    // 0: not relaxable, 1: GOTPCRELX, 2: REX_GOTPCRELX
+  bool JTFunctionRelative;
+  bool IsRela;
+  bool IsNewSection;
+
+  // A short branch left unrelaxed, with its long form (RelaxShortSize > 0)
+  uint8_t RelaxShortSize;
+  uint8_t RelaxLongSize;
+  uint8_t RelaxFixupOffset;
+  uint8_t RelaxLongForm[7];
+
+  // A long branch relaxed by the assembler, with its short form
+  // (ShrinkLongSize > 0)
+  uint8_t ShrinkLongSize;
+  uint8_t ShrinkShortSize;
+  uint8_t ShrinkShortForm[6];
+
+  FixupRecord()
+      : Offset(0), SectionIdx(0), NumJTEntries(0), RelocIdx(0), DerefSize(0),
+        JTEntrySize(0), ReachLog2(0), TargetKind(0), RefClass(0), Scope(0),
+        PairDelta(0), GOTRelax(0), JTFunctionRelative(false), IsRela(false),
+        IsNewSection(false), RelaxShortSize(0), RelaxLongSize(0),
+        RelaxFixupOffset(0), RelaxLongForm(), ShrinkLongSize(0),
+        ShrinkShortSize(0), ShrinkShortForm() {}
+};
+
+// A new tuple of the list List of FixupInfo, or NULL if there is no such list
+ReorderInfo_FixupInfo_FixupTuple *AddFixupTuple(ReorderInfo_FixupInfo *FI,
+                                                unsigned List);
+
+// The columns of the list List of ReorderInfo, or NULL if there is none
+ReorderInfo_FixupColumns *MutableFixupColumns(ReorderInfo *RI, unsigned List);
+
+// Write F but its section to the v1 tuple T, at Offset (F.Offset, or its
+// delta from the previous fixup modulo 2^32)
+void SetFixupTuple(ReorderInfo_FixupInfo_FixupTuple *T, const FixupRecord &F,
+                   uint64_t Offset);
+
+// Append a Width-bit Value for the Idx-th element to the packed bitfield
+// column Bits (a RepeatedField<uint64>), 64 / Width elements a word
+template <typename WordsT>
+void AppendBits(WordsT *Bits, unsigned Idx, uint64_t Value, unsigned Width) {
+  unsigned PerWord = 64 / Width;
+  if (Idx % PerWord == 0)
+    Bits->Add(0);
+  *Bits->Mutable(Bits->size() - 1) |= Value << ((Idx % PerWord) * Width);
+}
+
+// Append the fixups of a list to its v2 columns one at a time, thus a chunk
+// that only takes some of them needs no copy of the records it takes
+class FixupColumnsWriter {
+  ReorderInfo_FixupColumns *Columns;
+  int64_t PrevOffset;
+  unsigned Idx;
+  unsigned ScopeIdx;     // Fixups in the scope column
+  unsigned GOTRelaxIdx;  // ... and in the GOT relaxation column
+  bool RelocIndices;     // The column of them is written
+  uint32_t PrevRelocIdx; // Of the latest fixup with a relocation in its section
+
+public:
+  // NumFixups is a hint that reserves the columns of every fixup
+  FixupColumnsWriter(ReorderInfo_FixupColumns *Columns, size_t NumFixups,
+                     bool RelocIndices);
+
+  void Add(const FixupRecord &F);
+};
+
+} // namespace ShuffleInfo
+
+#endif // SHUFFLEINFO_WRITER_H
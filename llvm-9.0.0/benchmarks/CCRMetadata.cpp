@@ -0,0 +1,287 @@
+//===- CCRMetadata.cpp - Benchmarks of the CCR metadata path --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Microbenchmarks of the collection (updateByteCounter), serialization
+// (serializeReorderInfo, by assembling with and without a .rand section) and
+// parsing of the CCR reordering information, on synthetic x86-64 assembly,
+// and of the heap of a process that assembles object after object.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCReorderInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/RandChunk.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/shuffleInfoReader.h"
+
+using namespace llvm;
+
+static const char *const TripleName = "x86_64-unknown-linux-gnu";
+
+// A switch-heavy function per iteration: a jump table in .rodata, calls, and
+// short branches that the assembler relaxes
+static std::string makeAssembly(unsigned NumFuncs) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  for (unsigned F = 0; F != NumFuncs; ++F) {
+    OS << "\t.text\n\t.globl f" << F << "\n\t.type f" << F << ",@function\n"
+       << "f" << F << ":\n"
+       << "\tcmpl $3, %edi\n\tja .Lf" << F << "_def\n"
+       << "\tmovl %edi, %eax\n\tjmpq *.Lf" << F << "_jt(,%rax,8)\n";
+    for (unsigned C = 0; C != 4; ++C)
+      OS << ".Lf" << F << "_c" << C << ":\n\tmovl $" << C << ", %eax\n"
+         << "\ttestl %esi, %esi\n\tjne .Lf" << F << "_def\n\tretq\n";
+    OS << ".Lf" << F << "_def:\n\tcallq f" << (F + 1) % NumFuncs << "\n"
+       << "\tleaq .Lf" << F << "_jt(%rip), %rcx\n\txorl %eax, %eax\n\tretq\n"
+       << "\t.size f" << F << ", .-f" << F << "\n"
+       << "\t.section .rodata\n\t.p2align 3\n.Lf" << F << "_jt:\n";
+    for (unsigned C = 0; C != 4; ++C)
+      OS << "\t.quad .Lf" << F << "_c" << C << "\n";
+  }
+  return OS.str();
+}
+
+namespace {
+// Assembles into ELF objects the way cc1as does (see cc1as_main.cpp). As a
+// compile server reuses its TargetMachine, the target objects and the
+// MCContext serve every assembly; the context is reset in between, thus it
+// is all that holds the CCR metadata of an object.
+class Assembler {
+  const Target *T = nullptr;
+  SourceMgr SrcMgr;
+  std::unique_ptr<MCRegisterInfo> MRI;
+  std::unique_ptr<MCAsmInfo> MAI;
+  MCObjectFileInfo MOFI;
+  std::unique_ptr<MCContext> Ctx;
+  std::unique_ptr<MCInstrInfo> MCII;
+  std::unique_ptr<MCSubtargetInfo> STI;
+
+public:
+  Assembler(StringRef Asm, unsigned RandFormat) {
+    std::string Error;
+    T = TargetRegistry::lookupTarget(TripleName, Error);
+    if (!T)
+      return;
+    SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm, "bench.s"),
+                              SMLoc());
+    MRI.reset(T->createMCRegInfo(TripleName));
+    MAI.reset(T->createMCAsmInfo(*MRI, TripleName));
+    MAI->RandFormatVersion = RandFormat;
+    Ctx.reset(new MCContext(MAI.get(), MRI.get(), &MOFI, &SrcMgr));
+    MCII.reset(T->createMCInstrInfo());
+    STI.reset(T->createMCSubtargetInfo(TripleName, "", ""));
+  }
+
+  bool run(bool WithRand, SmallVectorImpl<char> &Out) {
+    if (!T)
+      return false;
+    Ctx->reset();
+    MOFI.InitMCObjectFileInfo(Triple(TripleName), /*PIC=*/false, *Ctx);
+    Ctx->getReorderInfo().isAssemFile = true;
+    MCTargetOptions Options;
+
+    Out.clear();
+    raw_svector_ostream OS(Out);
+    std::unique_ptr<MCAsmBackend> MAB(
+        T->createMCAsmBackend(*STI, *MRI, Options));
+    std::unique_ptr<MCObjectWriter> OW = MAB->createObjectWriter(OS);
+    std::unique_ptr<MCCodeEmitter> CE(
+        T->createMCCodeEmitter(*MCII, *MRI, *Ctx));
+    std::unique_ptr<MCStreamer> Str(T->createMCObjectStreamer(
+        Triple(TripleName), *Ctx, std::move(MAB), std::move(OW),
+        std::move(CE), *STI, /*RelaxAll=*/false,
+        /*IncrementalLinkerCompatible=*/false,
+        /*DWARFMustBeAtTheEnd=*/true));
+    Str->InitSections(/*NoExecStack=*/false);
+    if (WithRand)
+      Str->EmitRand();
+    Str->setUseAssemblerInfoForParsing(true);
+
+    std::unique_ptr<MCAsmParser> Parser(
+        createMCAsmParser(SrcMgr, *Ctx, *Str, *MAI));
+    std::unique_ptr<MCTargetAsmParser> TAP(
+        T->createMCAsmParser(*STI, *Parser, *MCII, Options));
+    if (!TAP)
+      return false;
+    Parser->setTargetParser(*TAP);
+    return !Parser->Run(/*NoInitialTextSection=*/false);
+  }
+};
+} // end anonymous namespace
+
+static bool assemble(StringRef Asm, bool WithRand, unsigned RandFormat,
+                     SmallVectorImpl<char> &Out) {
+  return Assembler(Asm, RandFormat).run(WithRand, Out);
+}
+
+static bool initTarget(benchmark::State &State) {
+  static bool Initialized = [] {
+    InitializeAllTargetInfos();
+    InitializeAllTargetMCs();
+    InitializeAllAsmParsers();
+    return true;
+  }();
+  (void)Initialized;
+
+  std::string Error;
+  if (TargetRegistry::lookupTarget(TripleName, Error))
+    return true;
+  State.SkipWithError("the X86 target is not built");
+  return false;
+}
+
+// The per-MBB bookkeeping of every emitted instruction (16 MBBs a function)
+static void BM_UpdateByteCounter(benchmark::State &State) {
+  unsigned NumFuncs = State.range(0);
+  for (auto _ : State) {
+    MCReorderInfo RI;
+    for (unsigned F = 0; F != NumFuncs; ++F)
+      for (unsigned B = 0; B != 16; ++B)
+        RI.updateByteCounter(MCMBBKey(F, B), 4, B & 1, /*isAlign=*/false);
+    benchmark::DoNotOptimize(RI.MachineBasicBlocks.size());
+  }
+  State.SetItemsProcessed(State.iterations() * NumFuncs * 16);
+}
+BENCHMARK(BM_UpdateByteCounter)->Range(64, 16 << 10);
+
+// Assembling without a .rand section still collects the metadata, thus the
+// difference to BM_AssembleWithRand is the cost of serializeReorderInfo() and
+// writing the section out (arguments: functions, wire format)
+static void BM_AssembleWithoutRand(benchmark::State &State) {
+  if (!initTarget(State))
+    return;
+  std::string Asm = makeAssembly(State.range(0));
+  SmallString<0> Obj;
+  for (auto _ : State)
+    if (!assemble(Asm, /*WithRand=*/false, 1, Obj))
+      State.SkipWithError("failed to assemble");
+  State.SetBytesProcessed(State.iterations() * Asm.size());
+}
+BENCHMARK(BM_AssembleWithoutRand)->Range(64, 4 << 10);
+
+static void BM_AssembleWithRand(benchmark::State &State) {
+  if (!initTarget(State))
+    return;
+  std::string Asm = makeAssembly(State.range(0));
+  SmallString<0> Obj;
+  for (auto _ : State)
+    if (!assemble(Asm, /*WithRand=*/true, State.range(1), Obj))
+      State.SkipWithError("failed to assemble");
+  State.SetBytesProcessed(State.iterations() * Asm.size());
+}
+BENCHMARK(BM_AssembleWithRand)->Ranges({{64, 4 << 10}, {1, 3}});
+
+// A compile server assembles object after object in one process: the heap
+// stays flat over 10k objects (argument: functions) as long as nothing of
+// the CCR metadata outlives the MCContext of its object
+static void BM_ReusedContext(benchmark::State &State) {
+  if (!initTarget(State))
+    return;
+  std::string Asm = makeAssembly(State.range(0));
+  Assembler A(Asm, /*RandFormat=*/2);
+  SmallString<0> Obj;
+  if (!A.run(/*WithRand=*/true, Obj)) {
+    State.SkipWithError("failed to assemble");
+    return;
+  }
+  size_t Before = sys::Process::GetMallocUsage();
+  for (auto _ : State)
+    if (!A.run(/*WithRand=*/true, Obj))
+      State.SkipWithError("failed to assemble");
+  size_t After = sys::Process::GetMallocUsage();
+  State.counters["HeapGrowth"] =
+      After > Before ? double(After - Before) : 0.0;
+  State.SetBytesProcessed(State.iterations() * Asm.size());
+}
+BENCHMARK(BM_ReusedContext)->Arg(64)->Iterations(10000);
+
+// Decode the .rand section of an object as the randomizer does (arguments:
+// functions, wire format)
+static void BM_ParseRand(benchmark::State &State) {
+  if (!initTarget(State))
+    return;
+  SmallString<0> Obj;
+  if (!assemble(makeAssembly(State.range(0)), /*WithRand=*/true,
+                State.range(1), Obj)) {
+    State.SkipWithError("failed to assemble");
+    return;
+  }
+
+  Expected<std::unique_ptr<object::ObjectFile>> File =
+      object::ObjectFile::createObjectFile(
+          MemoryBufferRef(StringRef(Obj.data(), Obj.size()), "bench.o"));
+  if (!File) {
+    consumeError(File.takeError());
+    State.SkipWithError("failed to read the object");
+    return;
+  }
+  StringRef Contents;
+  for (const object::SectionRef &Sec : (*File)->sections()) {
+    StringRef Name;
+    if (!Sec.getName(Name) && Name == ".rand") {
+      Expected<StringRef> C = Sec.getContents();
+      if (!C) {
+        consumeError(C.takeError());
+        break;
+      }
+      Contents = *C;
+      break;
+    }
+  }
+  if (Contents.empty()) {
+    State.SkipWithError("no .rand section");
+    return;
+  }
+
+  ArrayRef<uint8_t> Data(reinterpret_cast<const uint8_t *>(Contents.data()),
+                         Contents.size());
+  for (auto _ : State) {
+    google::protobuf::Arena Arena;
+    if (!object::isRandChunked(Data)) {
+      benchmark::DoNotOptimize(
+          ShuffleInfo::ParseReorderInfo(Data.data(), Data.size(), &Arena));
+      continue;
+    }
+    Expected<std::vector<object::RandChunkRef>> Chunks =
+        object::readRandChunks(Data);
+    if (!Chunks) {
+      consumeError(Chunks.takeError());
+      State.SkipWithError("bad .rand chunks");
+      break;
+    }
+    for (const object::RandChunkRef &C : *Chunks) {
+      ArrayRef<uint8_t> Payload = C.getPayload();
+      benchmark::DoNotOptimize(ShuffleInfo::ParseReorderInfo(
+          Payload.data(), Payload.size(), &Arena));
+    }
+  }
+  State.SetBytesProcessed(State.iterations() * Data.size());
+}
+BENCHMARK(BM_ParseRand)->Ranges({{64, 4 << 10}, {1, 3}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,104 @@
+/* Inline assembly: the bytes of every blob (instructions and data directives)
+ * are attributed to the MBB of the asm statement, and the blobs may define
+ * their own local labels and branches. */
+
+#include <stdint.h>
+
+static inline uint64_t rdtsc(void) {
+  uint32_t lo, hi;
+  __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static inline uint32_t popcount_loop(uint32_t x) {
+  uint32_t n;
+  __asm__("xorl %0, %0\n\t"
+          "1:\n\t"
+          "testl %1, %1\n\t"
+          "jz 2f\n\t"
+          "leal -1(%1), %%ecx\n\t"
+          "andl %%ecx, %1\n\t"
+          "incl %0\n\t"
+          "jmp 1b\n\t"
+          "2:"
+          : "=&r"(n), "+r"(x)
+          :
+          : "ecx", "cc");
+  return n;
+}
+
+static inline uint64_t bswap64(uint64_t x) {
+  __asm__("bswapq %0" : "+r"(x));
+  return x;
+}
+
+static inline void cpuid(uint32_t leaf, uint32_t *a, uint32_t *b, uint32_t *c,
+                         uint32_t *d) {
+  __asm__ __volatile__("cpuid"
+                       : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d)
+                       : "a"(leaf), "c"(0));
+}
+
+static inline uint32_t magic(void) {
+  uint32_t v;
+  /* Data in code, which the metadata counts in the enclosing BBL */
+  __asm__("call 1f\n\t"
+          ".byte 0xde, 0xad, 0xbe, 0xef\n\t"
+          "1: popq %%rax\n\t"
+          "movl (%%rax), %0"
+          : "=r"(v)
+          :
+          : "rax");
+  return v;
+}
+
+static inline uint64_t mulhi(uint64_t a, uint64_t b) {
+  uint64_t hi, lo;
+  __asm__("mulq %3" : "=a"(lo), "=d"(hi) : "a"(a), "rm"(b) : "cc");
+  (void)lo;
+  return hi;
+}
+
+static inline void spin_pause(unsigned n) {
+  while (n--)
+    __asm__ __volatile__("pause" ::: "memory");
+}
+
+__asm__(".text\n"
+        ".globl asm_sum\n"
+        ".type asm_sum,@function\n"
+        "asm_sum:\n"
+        "  xorl %eax, %eax\n"
+        "  testq %rsi, %rsi\n"
+        "  jz 2f\n"
+        "1:\n"
+        "  addl (%rdi), %eax\n"
+        "  addq $4, %rdi\n"
+        "  decq %rsi\n"
+        "  jnz 1b\n"
+        "2:\n"
+        "  ret\n"
+        ".size asm_sum, .-asm_sum\n");
+
+extern uint32_t asm_sum(const uint32_t *p, uint64_t n);
+
+#define REPEAT4(X) X(0) X(1) X(2) X(3)
+#define KERNEL(N)                                                              \
+  uint64_t kernel##N(uint64_t x) {                                             \
+    uint32_t a, b, c, d;                                                       \
+    cpuid(N, &a, &b, &c, &d);                                                  \
+    x ^= bswap64(x + a) + mulhi(x, 0x9e3779b97f4a7c15ULL + N);                 \
+    x += popcount_loop((uint32_t)x ^ b) + magic();                             \
+    spin_pause(c & 3);                                                         \
+    return x ^ rdtsc() ^ d;                                                    \
+  }
+REPEAT4(KERNEL)
+
+int main(void) {
+  uint32_t data[64];
+  for (unsigned i = 0; i < 64; ++i)
+    data[i] = popcount_loop(i * 2654435761u);
+  uint64_t x = asm_sum(data, 64);
+  x = kernel0(x) + kernel1(x) + kernel2(x) + kernel3(x);
+  return (int)(x & 1);
+}
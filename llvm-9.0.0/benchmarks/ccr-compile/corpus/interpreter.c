@@ -0,0 +1,172 @@
+/* A bytecode interpreter: one large switch (a jump table per dispatch) and
+ * many short BBLs, the worst case for the per-BBL and per-fixup metadata. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+enum Op {
+  OP_HALT, OP_PUSH, OP_POP, OP_DUP, OP_SWAP, OP_OVER, OP_ROT,
+  OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_NEG, OP_INC, OP_DEC,
+  OP_AND, OP_OR, OP_XOR, OP_NOT, OP_SHL, OP_SHR, OP_SAR,
+  OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE,
+  OP_JMP, OP_JZ, OP_JNZ, OP_CALL, OP_RET,
+  OP_LOAD, OP_STORE, OP_LOADI, OP_STOREI,
+  OP_MIN, OP_MAX, OP_ABS, OP_SQR, OP_PRINT, OP_NOP,
+  NUM_OPS
+};
+
+#define STACK_SIZE 256
+#define MEM_SIZE 1024
+
+struct VM {
+  int64_t stack[STACK_SIZE];
+  int64_t mem[MEM_SIZE];
+  uint32_t calls[STACK_SIZE];
+  int sp, csp;
+  uint32_t pc;
+  uint64_t steps;
+};
+
+static int64_t run(struct VM *vm, const int32_t *code, uint32_t len) {
+  int64_t a, b;
+  while (vm->pc < len) {
+    int32_t insn = code[vm->pc++];
+    vm->steps++;
+    switch (insn & 0xff) {
+    case OP_HALT: return vm->sp ? vm->stack[vm->sp - 1] : 0;
+    case OP_PUSH: vm->stack[vm->sp++] = insn >> 8; break;
+    case OP_POP: vm->sp--; break;
+    case OP_DUP: vm->stack[vm->sp] = vm->stack[vm->sp - 1]; vm->sp++; break;
+    case OP_SWAP:
+      a = vm->stack[vm->sp - 1];
+      vm->stack[vm->sp - 1] = vm->stack[vm->sp - 2];
+      vm->stack[vm->sp - 2] = a;
+      break;
+    case OP_OVER: vm->stack[vm->sp] = vm->stack[vm->sp - 2]; vm->sp++; break;
+    case OP_ROT:
+      a = vm->stack[vm->sp - 3];
+      vm->stack[vm->sp - 3] = vm->stack[vm->sp - 2];
+      vm->stack[vm->sp - 2] = vm->stack[vm->sp - 1];
+      vm->stack[vm->sp - 1] = a;
+      break;
+#define BINOP(OP, EXPR)                                                        \
+    case OP:                                                                   \
+      b = vm->stack[--vm->sp];                                                 \
+      a = vm->stack[vm->sp - 1];                                               \
+      vm->stack[vm->sp - 1] = (EXPR);                                          \
+      break;
+    BINOP(OP_ADD, a + b)
+    BINOP(OP_SUB, a - b)
+    BINOP(OP_MUL, a * b)
+    BINOP(OP_DIV, b ? a / b : 0)
+    BINOP(OP_MOD, b ? a % b : 0)
+    BINOP(OP_AND, a & b)
+    BINOP(OP_OR, a | b)
+    BINOP(OP_XOR, a ^ b)
+    BINOP(OP_SHL, (int64_t)((uint64_t)a << (b & 63)))
+    BINOP(OP_SHR, (int64_t)((uint64_t)a >> (b & 63)))
+    BINOP(OP_SAR, a >> (b & 63))
+    BINOP(OP_EQ, a == b)
+    BINOP(OP_NE, a != b)
+    BINOP(OP_LT, a < b)
+    BINOP(OP_LE, a <= b)
+    BINOP(OP_GT, a > b)
+    BINOP(OP_GE, a >= b)
+    BINOP(OP_MIN, a < b ? a : b)
+    BINOP(OP_MAX, a > b ? a : b)
+#undef BINOP
+    case OP_NEG: vm->stack[vm->sp - 1] = -vm->stack[vm->sp - 1]; break;
+    case OP_INC: vm->stack[vm->sp - 1]++; break;
+    case OP_DEC: vm->stack[vm->sp - 1]--; break;
+    case OP_NOT: vm->stack[vm->sp - 1] = ~vm->stack[vm->sp - 1]; break;
+    case OP_ABS:
+      if (vm->stack[vm->sp - 1] < 0)
+        vm->stack[vm->sp - 1] = -vm->stack[vm->sp - 1];
+      break;
+    case OP_SQR: vm->stack[vm->sp - 1] *= vm->stack[vm->sp - 1]; break;
+    case OP_JMP: vm->pc = insn >> 8; break;
+    case OP_JZ: if (!vm->stack[--vm->sp]) vm->pc = insn >> 8; break;
+    case OP_JNZ: if (vm->stack[--vm->sp]) vm->pc = insn >> 8; break;
+    case OP_CALL: vm->calls[vm->csp++] = vm->pc; vm->pc = insn >> 8; break;
+    case OP_RET:
+      if (!vm->csp)
+        return vm->stack[vm->sp - 1];
+      vm->pc = vm->calls[--vm->csp];
+      break;
+    case OP_LOAD: vm->stack[vm->sp++] = vm->mem[(insn >> 8) % MEM_SIZE]; break;
+    case OP_STORE: vm->mem[(insn >> 8) % MEM_SIZE] = vm->stack[--vm->sp]; break;
+    case OP_LOADI:
+      vm->stack[vm->sp - 1] =
+          vm->mem[(uint64_t)vm->stack[vm->sp - 1] % MEM_SIZE];
+      break;
+    case OP_STOREI:
+      a = vm->stack[--vm->sp];
+      vm->mem[(uint64_t)vm->stack[--vm->sp] % MEM_SIZE] = a;
+      break;
+    case OP_PRINT: printf("%lld\n", (long long)vm->stack[--vm->sp]); break;
+    case OP_NOP: break;
+    default:
+      fprintf(stderr, "bad opcode %d at %u\n", insn & 0xff, vm->pc - 1);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static const char *op_name(enum Op op) {
+  switch (op) {
+  case OP_HALT: return "halt";   case OP_PUSH: return "push";
+  case OP_POP: return "pop";     case OP_DUP: return "dup";
+  case OP_SWAP: return "swap";   case OP_OVER: return "over";
+  case OP_ROT: return "rot";     case OP_ADD: return "add";
+  case OP_SUB: return "sub";     case OP_MUL: return "mul";
+  case OP_DIV: return "div";     case OP_MOD: return "mod";
+  case OP_NEG: return "neg";     case OP_INC: return "inc";
+  case OP_DEC: return "dec";     case OP_AND: return "and";
+  case OP_OR: return "or";       case OP_XOR: return "xor";
+  case OP_NOT: return "not";     case OP_SHL: return "shl";
+  case OP_SHR: return "shr";     case OP_SAR: return "sar";
+  case OP_EQ: return "eq";       case OP_NE: return "ne";
+  case OP_LT: return "lt";       case OP_LE: return "le";
+  case OP_GT: return "gt";       case OP_GE: return "ge";
+  case OP_JMP: return "jmp";     case OP_JZ: return "jz";
+  case OP_JNZ: return "jnz";     case OP_CALL: return "call";
+  case OP_RET: return "ret";     case OP_LOAD: return "load";
+  case OP_STORE: return "store"; case OP_LOADI: return "loadi";
+  case OP_STOREI: return "storei"; case OP_MIN: return "min";
+  case OP_MAX: return "max";     case OP_ABS: return "abs";
+  case OP_SQR: return "sqr";     case OP_PRINT: return "print";
+  case OP_NOP: return "nop";     case NUM_OPS: break;
+  }
+  return "?";
+}
+
+void disassemble(const int32_t *code, uint32_t len) {
+  for (uint32_t i = 0; i < len; ++i)
+    printf("%4u: %-6s %d\n", i, op_name((enum Op)(code[i] & 0xff)),
+           code[i] >> 8);
+}
+
+#define I(op, arg) ((int32_t)(((arg) << 8) | (op)))
+
+int main(int argc, char **argv) {
+  /* sum of squares below argc * 1000 */
+  const int32_t code[] = {
+      I(OP_PUSH, 0), I(OP_STORE, 0),             /* sum = 0 */
+      I(OP_PUSH, 0), I(OP_STORE, 1),             /* i = 0 */
+      I(OP_LOAD, 1), I(OP_LOAD, 2), I(OP_LT, 0), /* 4: i < n */
+      I(OP_JZ, 17),
+      I(OP_LOAD, 1), I(OP_SQR, 0), I(OP_LOAD, 0), I(OP_ADD, 0),
+      I(OP_STORE, 0),
+      I(OP_LOAD, 1), I(OP_INC, 0), I(OP_STORE, 1), I(OP_JMP, 4),
+      I(OP_LOAD, 0), I(OP_PRINT, 0), I(OP_HALT, 0),
+  };
+  struct VM vm;
+  memset(&vm, 0, sizeof(vm));
+  vm.mem[2] = argc * 1000;
+  if (argc > 2)
+    disassemble(code, sizeof(code) / sizeof(code[0]));
+  (void)argv;
+  return (int)run(&vm, code, sizeof(code) / sizeof(code[0])) & 1;
+}
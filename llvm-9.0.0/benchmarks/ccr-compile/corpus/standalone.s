@@ -0,0 +1,102 @@
+# A standalone assembly file: the BBLs are split at the terminators by the
+# assembler (there are no MBBs), with data in code and a jump table.
+
+	.text
+	.globl	dispatch
+	.type	dispatch,@function
+	.p2align	4
+dispatch:
+	cmpl	$7, %edi
+	ja	.Ldefault
+	movl	%edi, %eax
+	leaq	.Ltable(%rip), %rcx
+	movslq	(%rcx,%rax,4), %rax
+	addq	%rcx, %rax
+	jmpq	*%rax
+.Lcase0:
+	movl	$10, %eax
+	retq
+.Lcase1:
+	leal	(%rsi,%rsi,2), %eax
+	retq
+.Lcase2:
+	movl	%esi, %eax
+	shll	$4, %eax
+	retq
+.Lcase3:
+	movl	%esi, %eax
+	negl	%eax
+	retq
+.Lcase4:
+	xorl	%eax, %eax
+	testl	%esi, %esi
+	sete	%al
+	retq
+.Lcase5:
+	callq	checksum
+	retq
+.Lcase6:
+	movl	%esi, %eax
+	imull	%esi, %eax
+	retq
+.Lcase7:
+	jmp	.Lloop_entry
+.Ldefault:
+	movl	$-1, %eax
+	retq
+.Lloop_entry:
+	xorl	%eax, %eax
+	movl	%esi, %ecx
+	.p2align	4
+.Lloop:
+	testl	%ecx, %ecx
+	je	.Lloop_done
+	addl	%ecx, %eax
+	decl	%ecx
+	jmp	.Lloop
+.Lloop_done:
+	retq
+	.size	dispatch, .-dispatch
+
+	.section	.rodata
+	.p2align	2
+.Ltable:
+	.long	.Lcase0-.Ltable
+	.long	.Lcase1-.Ltable
+	.long	.Lcase2-.Ltable
+	.long	.Lcase3-.Ltable
+	.long	.Lcase4-.Ltable
+	.long	.Lcase5-.Ltable
+	.long	.Lcase6-.Ltable
+	.long	.Lcase7-.Ltable
+
+	.text
+	.globl	checksum
+	.type	checksum,@function
+	.p2align	4
+checksum:
+	leaq	.Lblob(%rip), %rdx
+	xorl	%eax, %eax
+	movl	$16, %ecx
+.Lsum:
+	movzbl	(%rdx), %r8d
+	addl	%r8d, %eax
+	roll	$5, %eax
+	incq	%rdx
+	decl	%ecx
+	jnz	.Lsum
+	retq
+.Lblob:
+	.byte	0x43, 0x43, 0x52, 0x00, 0x01, 0x02, 0x03, 0x04
+	.byte	0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c
+	.size	checksum, .-checksum
+
+	.data
+	.globl	handlers
+	.p2align	3
+handlers:
+	.quad	dispatch
+	.quad	checksum
+	.size	handlers, 16
+
+	.section	.note.GNU-stack,"",@progbits
@@ -0,0 +1,131 @@
+// A template-heavy TU: many instantiations (each in a COMDAT group with a
+// .rand of its own in format 3), inlined lambdas and a few vtables.
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <unsigned N> struct Fib {
+  static constexpr unsigned long long value = Fib<N - 1>::value + Fib<N - 2>::value;
+};
+template <> struct Fib<0> { static constexpr unsigned long long value = 0; };
+template <> struct Fib<1> { static constexpr unsigned long long value = 1; };
+
+template <typename T, unsigned N> struct Unroll {
+  template <typename F> static void apply(std::vector<T> &V, F Fn) {
+    Unroll<T, N - 1>::apply(V, Fn);
+    if (N - 1 < V.size())
+      V[N - 1] = Fn(V[N - 1], Fib<N % 40>::value);
+  }
+};
+template <typename T> struct Unroll<T, 0> {
+  template <typename F> static void apply(std::vector<T> &, F) {}
+};
+
+struct Shape {
+  virtual ~Shape() = default;
+  virtual double area() const = 0;
+  virtual std::string name() const = 0;
+};
+
+template <typename T> struct Square : Shape {
+  T Side;
+  explicit Square(T S) : Side(S) {}
+  double area() const override { return double(Side) * double(Side); }
+  std::string name() const override { return "square"; }
+};
+
+template <typename T> struct Rect : Shape {
+  T W, H;
+  Rect(T W, T H) : W(W), H(H) {}
+  double area() const override { return double(W) * double(H); }
+  std::string name() const override { return "rect"; }
+};
+
+template <typename K, typename V>
+std::map<V, std::vector<K>> invert(const std::unordered_map<K, V> &M) {
+  std::map<V, std::vector<K>> R;
+  for (const auto &KV : M)
+    R[KV.second].push_back(KV.first);
+  for (auto &KV : R)
+    std::sort(KV.second.begin(), KV.second.end());
+  return R;
+}
+
+template <typename... Ts> struct Record {
+  std::tuple<Ts...> Fields;
+  template <std::size_t... Is>
+  std::size_t hashImpl(std::index_sequence<Is...>) const {
+    std::size_t H = 0;
+    using Expand = int[];
+    (void)Expand{0, (H = H * 31 + std::hash<Ts>()(std::get<Is>(Fields)), 0)...};
+    return H;
+  }
+  std::size_t hash() const { return hashImpl(std::index_sequence_for<Ts...>()); }
+  bool operator<(const Record &O) const { return Fields < O.Fields; }
+};
+
+template <typename T> double sumAreas(unsigned N) {
+  std::vector<std::unique_ptr<Shape>> Shapes;
+  for (unsigned I = 0; I != N; ++I) {
+    if (I % 2)
+      Shapes.emplace_back(new Square<T>(T(I)));
+    else
+      Shapes.emplace_back(new Rect<T>(T(I), T(I + 1)));
+  }
+  double Sum = 0;
+  for (const auto &S : Shapes)
+    Sum += S->area() + S->name().size();
+  return Sum;
+}
+
+template <typename T> std::vector<T> transform(unsigned N) {
+  std::vector<T> V(N);
+  for (unsigned I = 0; I != N; ++I)
+    V[I] = T(I);
+  Unroll<T, 64>::apply(V, [](T X, unsigned long long F) { return X + T(F % 97); });
+  std::stable_sort(V.begin(), V.end(), std::greater<T>());
+  return V;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **) {
+  unsigned N = unsigned(argc) * 100;
+  double R = sumAreas<int>(N) + sumAreas<long>(N) + sumAreas<float>(N) +
+             sumAreas<double>(N) + sumAreas<short>(N) + sumAreas<char>(N);
+  R += transform<int>(N).front() + transform<long>(N).front() +
+       transform<float>(N).front() + transform<double>(N).front() +
+       transform<unsigned>(N).front() + transform<short>(N).front();
+
+  std::unordered_map<std::string, int> M;
+  for (unsigned I = 0; I != N; ++I)
+    M[std::to_string(I)] = int(I % 7);
+  R += invert(M).size();
+  std::unordered_map<int, std::string> M2;
+  for (unsigned I = 0; I != N; ++I)
+    M2[int(I)] = std::to_string(I % 5);
+  R += invert(M2).size();
+
+  std::vector<Record<int, std::string, double>> Records;
+  std::vector<Record<long, char, unsigned, std::string>> Records2;
+  for (unsigned I = 0; I != N; ++I) {
+    Records.push_back({std::make_tuple(int(I), std::to_string(I), I * 0.5)});
+    Records2.push_back({std::make_tuple(long(I), char(I), I, std::string(I % 3, 'x'))});
+  }
+  std::sort(Records.begin(), Records.end());
+  std::sort(Records2.begin(), Records2.end());
+  for (const auto &Rec : Records)
+    R += Rec.hash() % 3;
+  for (const auto &Rec : Records2)
+    R += Rec.hash() % 5;
+  return int(R) & 1;
+}
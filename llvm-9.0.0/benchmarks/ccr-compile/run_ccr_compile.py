@@ -0,0 +1,126 @@
+#!/usr/bin/env python
+"""Compare the compile-time overhead of the CCR toolchain with a stock clang.
+
+Every file of the corpus is compiled (-c) by both compilers a few times; the
+report lists the best wall time, the peak RSS and the object size of each,
+along with the size of the .rand sections in the CCR objects.
+
+  run_ccr_compile.py --ccr build/bin/clang --stock /usr/bin/clang-9
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import struct
+import subprocess
+import sys
+import time
+
+CORPUS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'corpus')
+
+# (file, extra flags): a switch-heavy interpreter, a template-heavy C++ TU,
+# inline assembly, and a standalone assembly file
+CORPUS = [
+    ('interpreter.c', ['-O2']),
+    ('templates.cpp', ['-O2', '-std=c++14']),
+    ('inline_asm.c', ['-O2']),
+    ('standalone.s', []),
+]
+
+
+def rand_size(path):
+    """Return the total size of the .rand sections of an ELF64 object."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4:5] != b'\x02':
+        return 0
+    shoff, = struct.unpack_from('<Q', data, 0x28)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x3a)
+
+    def header(i):
+        # sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size
+        return struct.unpack_from('<IIQQQQ', data, shoff + i * shentsize)
+
+    strtab_off = header(shstrndx)[4]
+    total = 0
+    for i in range(shnum):
+        name_off, _, _, _, _, size = header(i)
+        end = data.index(b'\0', strtab_off + name_off)
+        if data[strtab_off + name_off:end] == b'.rand':
+            total += size
+    return total
+
+
+def compile_once(compiler, src, flags, obj):
+    """Return the wall time (s) and the peak RSS (KB) of one compilation."""
+    cmd = [compiler, '-c', src, '-o', obj] + flags
+    start = time.time()
+    proc = subprocess.Popen(cmd)
+    _, status, usage = os.wait4(proc.pid, 0)
+    elapsed = time.time() - start
+    if status != 0:
+        sys.exit('error: %s failed' % ' '.join(cmd))
+    # On Linux, the usage of the child includes its own (waited) children,
+    # thus ru_maxrss is the peak of the driver and cc1 alike
+    return elapsed, usage.ru_maxrss
+
+
+def measure(compiler, src, flags, obj, runs):
+    best_time, peak_rss = None, 0
+    for _ in range(runs):
+        elapsed, rss = compile_once(compiler, src, flags, obj)
+        best_time = elapsed if best_time is None else min(best_time, elapsed)
+        peak_rss = max(peak_rss, rss)
+    return {
+        'time_s': best_time,
+        'peak_rss_kb': peak_rss,
+        'obj_size': os.path.getsize(obj),
+        'rand_size': rand_size(obj),
+    }
+
+
+def delta(ccr, stock):
+    return (ccr - stock) * 100.0 / stock if stock else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--ccr', required=True, help='the CCR clang')
+    parser.add_argument('--stock', required=True, help='a stock clang')
+    parser.add_argument('--runs', type=int, default=5,
+                        help='compilations per file (the best time counts)')
+    parser.add_argument('--work-dir', default='ccr-compile',
+                        help='where the objects go')
+    parser.add_argument('--json', help='write the report as JSON as well')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.work_dir):
+        os.makedirs(args.work_dir)
+
+    report = []
+    print('%-16s %9s %9s %9s %9s %10s' % ('file', 'time', 'rss', 'obj',
+                                          'rand(B)', 'rand/obj'))
+    for name, flags in CORPUS:
+        src = os.path.join(CORPUS_DIR, name)
+        base = os.path.join(args.work_dir, os.path.splitext(name)[0])
+        # The metadata is opt-in unless the compiler is invoked as ccr
+        ccr = measure(args.ccr, src, flags + ['-fccr-metadata'],
+                      base + '.ccr.o', args.runs)
+        stock = measure(args.stock, src, flags, base + '.stock.o', args.runs)
+        report.append({'file': name, 'ccr': ccr, 'stock': stock})
+        print('%-16s %+8.1f%% %+8.1f%% %+8.1f%% %9d %9.1f%%' % (
+            name, delta(ccr['time_s'], stock['time_s']),
+            delta(ccr['peak_rss_kb'], stock['peak_rss_kb']),
+            delta(ccr['obj_size'], stock['obj_size']), ccr['rand_size'],
+            ccr['rand_size'] * 100.0 / ccr['obj_size']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(report, f, indent=2)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,181 @@
+#!/usr/bin/env python
+"""Measure the cost of merging the CCR metadata when linking a large corpus.
+
+A synthetic corpus (see utils/ccr/gen_ccr_corpus.py) is linked by the CCR
+linker flow a few times as it is, and as many times with the .rand sections
+stripped from copies of its objects. The difference of the two is the cost of
+merging the metadata; the report lists the best wall time, the CPU time (user
+and system) and the peak RSS of both, along with the size of the merged .rand.
+
+  run_ccr_link.py --cc build/bin/clang --ld binutils-2.27/gold/ld-new \\
+      --objcopy build/bin/llvm-objcopy --objects 10000
+
+An existing corpus (--corpus, the --out-dir of gen_ccr_corpus.py) is linked
+as it is rather than generated again.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import struct
+import subprocess
+import sys
+import time
+from multiprocessing import cpu_count
+from multiprocessing.pool import ThreadPool
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                os.pardir, os.pardir, 'utils', 'ccr'))
+import gen_ccr_corpus  # noqa: E402
+
+REPORT_VERSION = 1
+
+
+def rand_sections(path):
+    """Return the (name, size) of the .rand sections (and of their relocation
+    sections) of an ELF64 file."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4:5] != b'\x02':
+        return []
+    shoff, = struct.unpack_from('<Q', data, 0x28)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x3a)
+
+    def header(i):
+        # sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size
+        return struct.unpack_from('<IIQQQQ', data, shoff + i * shentsize)
+
+    strtab_off = header(shstrndx)[4]
+    sections = []
+    for i in range(shnum):
+        name_off, _, _, _, _, size = header(i)
+        end = data.index(b'\0', strtab_off + name_off)
+        name = data[strtab_off + name_off:end].decode()
+        if name.startswith(('.rand', '.rela.rand')):
+            sections.append((name, size))
+    return sections
+
+
+def rand_size(path):
+    return sum(size for name, size in rand_sections(path)
+               if name.startswith('.rand'))
+
+
+def strip_rand(objcopy, objects, out_dir, jobs):
+    """Copy the objects into out_dir without their .rand sections."""
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+    tasks = []
+    for obj in objects:
+        out = os.path.join(out_dir, os.path.basename(obj))
+        # The per-section .rand sections are named after their sections
+        tasks.append([objcopy] +
+                     ['--remove-section=' + name
+                      for name, _ in rand_sections(obj)] + [obj, out])
+    pool = ThreadPool(jobs)
+    try:
+        results = pool.map(subprocess.call, tasks)
+    finally:
+        pool.close()
+    for cmd, status in zip(tasks, results):
+        if status != 0:
+            sys.exit('error: %s failed' % ' '.join(cmd))
+    return [cmd[-1] for cmd in tasks]
+
+
+def link_once(cmd):
+    """Return the wall time (s), the CPU time (s) and the peak RSS (KB)."""
+    start = time.time()
+    proc = subprocess.Popen(cmd)
+    _, status, usage = os.wait4(proc.pid, 0)
+    elapsed = time.time() - start
+    if status != 0:
+        sys.exit('error: %s failed' % ' '.join(cmd))
+    # The usage of the driver includes that of the linker it has waited for
+    return elapsed, usage.ru_utime + usage.ru_stime, usage.ru_maxrss
+
+
+def measure(args, objects, out):
+    # A response file keeps the command line of 10k objects within limits
+    rsp = out + '.rsp'
+    with open(rsp, 'w') as f:
+        f.write('\n'.join(objects) + '\n')
+    cmd = [args.cc, '-fuse-ld=' + args.ld, '@' + rsp, '-o', out]
+    cmd += args.ldflags.split() if args.ldflags else []
+    best_time = best_cpu = None
+    peak_rss = 0
+    for _ in range(args.runs):
+        elapsed, cpu, rss = link_once(cmd)
+        best_time = elapsed if best_time is None else min(best_time, elapsed)
+        best_cpu = cpu if best_cpu is None else min(best_cpu, cpu)
+        peak_rss = max(peak_rss, rss)
+    return {
+        'time_s': best_time,
+        'cpu_s': best_cpu,
+        'peak_rss_kb': peak_rss,
+        'output_size': os.path.getsize(out),
+        'rand_size': rand_size(out),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--cc', required=True,
+                        help='the CCR clang (which drives the link)')
+    parser.add_argument('--ld', required=True,
+                        help='the CCR linker (i.e., the gold of binutils-2.27)')
+    parser.add_argument('--objcopy', required=True,
+                        help='an objcopy to strip the .rand sections with')
+    parser.add_argument('--ldflags', help='extra flags of the link')
+    parser.add_argument('--runs', type=int, default=3,
+                        help='links per set of objects (the best time counts)')
+    parser.add_argument('--jobs', type=int, default=cpu_count(),
+                        help='parallel compilations of the corpus')
+    parser.add_argument('--corpus', help='an existing corpus to link')
+    parser.add_argument('--work-dir', default='ccr-link',
+                        help='where the corpus and the outputs go')
+    parser.add_argument('--json', help='write the report as JSON as well')
+    gen_ccr_corpus.add_shape_arguments(parser)
+    args = parser.parse_args()
+
+    if args.corpus:
+        with open(os.path.join(args.corpus, 'manifest.json')) as f:
+            manifest = json.load(f)
+    else:
+        args.out_dir = os.path.join(args.work_dir, 'corpus')
+        manifest = gen_ccr_corpus.generate(args)
+    objects = manifest['objects']
+    stripped = strip_rand(args.objcopy, objects,
+                          os.path.join(args.work_dir, 'stripped'), args.jobs)
+
+    ccr = measure(args, objects, os.path.join(args.work_dir, 'ccr.out'))
+    base = measure(args, stripped, os.path.join(args.work_dir, 'base.out'))
+    if not ccr['rand_size']:
+        print('warning: the output has no .rand section; is %s the CCR '
+              'linker?' % args.ld, file=sys.stderr)
+
+    merge = {
+        'time_s': ccr['time_s'] - base['time_s'],
+        'cpu_s': ccr['cpu_s'] - base['cpu_s'],
+        'peak_rss_kb': ccr['peak_rss_kb'] - base['peak_rss_kb'],
+    }
+    print('%-10s %10s %10s %12s %12s' % ('link', 'time(s)', 'cpu(s)',
+                                         'rss(KB)', 'rand(B)'))
+    for name, m in (('ccr', ccr), ('stripped', base)):
+        print('%-10s %10.3f %10.3f %12d %12d' % (
+            name, m['time_s'], m['cpu_s'], m['peak_rss_kb'], m['rand_size']))
+    print('%-10s %+10.3f %+10.3f %+12d' % (
+        'merge', merge['time_s'], merge['cpu_s'], merge['peak_rss_kb']))
+
+    if args.json:
+        report = {'version': REPORT_VERSION, 'shape': manifest['shape'],
+                  'ccr': ccr, 'stripped': base, 'merge': merge}
+        with open(args.json, 'w') as f:
+            json.dump(report, f, indent=2)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
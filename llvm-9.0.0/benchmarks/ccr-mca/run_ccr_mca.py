@@ -0,0 +1,182 @@
+#!/usr/bin/env python
+"""Estimate the cost of a shuffle plan on the hot loops with llvm-mca.
+
+The binary (built with the CCR toolchain and a profile, thus with hot BBLs)
+is randomized by llvm-ccr-rand -mca-regions with --variants different seeds
+in each shuffle mode, which writes the hot BBLs of every hot function in the
+old and in the new layout as a pair of llvm-mca code regions. llvm-mca then
+estimates the cycles per iteration of both, and the report (--json) holds,
+per mode and seed, the estimate of every function and its overhead over the
+old layout, along with the distribution of the overheads:
+
+  {"version": 1, "binary": ..., "mcpu": ...,
+   "modes": {"function": {"variants": [{"seed": 1,
+                                        "functions": {"f": {"old": ...,
+                                                            "new": ...,
+                                                            "overhead_pct":
+                                                                ...},
+                                                      ...}}, ...],
+                          "summary": {"mean": ..., "p50": ..., "p99": ...,
+                                      "max": ...}},
+             "bbl": {...}}}
+
+No workload runs, thus a mode (and its seeds) is screened in seconds, before
+ccr-runtime/run_ccr_perf.py measures it for real.
+
+  run_ccr_mca.py --binary ./app --variants 20 --mcpu skylake --json mca.json
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+
+REPORT_VERSION = 1
+
+MODES = [
+    ('function', []),
+    ('bbl', ['-shuffle-bbls']),
+]
+
+REGION_RE = re.compile(r'^\[\d+\] Code Region - (.*)$')
+
+
+def percentile(values, pct):
+    """Nearest-rank percentile of a non-empty list."""
+    ordered = sorted(values)
+    rank = int(math.ceil(pct / 100.0 * len(ordered)))
+    return ordered[max(rank, 1) - 1]
+
+
+def randomize(rand_tool, binary, out, seed, flags):
+    cmd = [rand_tool, '-seed=%d' % seed, '-mca-regions', '-o', out,
+           binary] + flags
+    if subprocess.call(cmd) != 0:
+        sys.exit('error: %s failed' % ' '.join(cmd))
+    return out + '.ccrmca.s'
+
+
+def run_mca(mca_tool, mcpu, iterations, regions):
+    """Cycles per iteration of every code region of the file."""
+    cmd = [mca_tool, '-mtriple=x86_64-unknown-linux-gnu', '-mcpu=' + mcpu,
+           '-iterations=%d' % iterations, regions]
+    try:
+        output = subprocess.check_output(cmd, universal_newlines=True)
+    except subprocess.CalledProcessError:
+        sys.exit('error: %s failed' % ' '.join(cmd))
+    return parse_mca(output)
+
+
+def parse_mca(output):
+    """Parse the summary views of llvm-mca, one per code region."""
+    result = {}
+    name, iterations = None, None
+    for line in output.splitlines():
+        match = REGION_RE.match(line)
+        if match:
+            name, iterations = match.group(1).strip(), None
+            continue
+        key, _, value = line.partition(':')
+        if name is None or not value:
+            continue
+        if key == 'Iterations':
+            iterations = float(value)
+        elif key == 'Total Cycles' and iterations:
+            result[name] = float(value) / iterations
+    return result
+
+
+def compare(estimates):
+    """Pair up the <name>@old and <name>@new regions."""
+    functions = {}
+    for region, cycles in estimates.items():
+        name, _, layout = region.rpartition('@')
+        if layout == 'new' and name + '@old' in estimates:
+            old = estimates[name + '@old']
+            functions[name] = {
+                'old': old,
+                'new': cycles,
+                'overhead_pct': (cycles - old) * 100.0 / old if old else 0.0,
+            }
+    return functions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--binary', required=True,
+                        help='the CCR-built binary, with a profile')
+    parser.add_argument('--rand', default='llvm-ccr-rand',
+                        help='the randomizer')
+    parser.add_argument('--mca', default='llvm-mca')
+    parser.add_argument('--mcpu', default='skylake',
+                        help='the CPU that llvm-mca models')
+    parser.add_argument('--iterations', type=int, default=100,
+                        help='iterations llvm-mca simulates per region')
+    parser.add_argument('--variants', type=int, default=10,
+                        help='randomized variants per mode')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='seed of the first variant')
+    parser.add_argument('--modes', default=','.join(m for m, _ in MODES),
+                        help='comma-separated shuffle modes')
+    parser.add_argument('--work-dir', default='ccr-mca',
+                        help='where the variants go')
+    parser.add_argument('--json', help='write the report to this file')
+    args = parser.parse_args()
+
+    modes = [m for m in MODES if m[0] in args.modes.split(',')]
+    if not os.path.isdir(args.work_dir):
+        os.makedirs(args.work_dir)
+
+    report = {
+        'version': REPORT_VERSION,
+        'binary': args.binary,
+        'mcpu': args.mcpu,
+        'modes': {},
+    }
+    name = os.path.basename(args.binary)
+    for mode, flags in modes:
+        variants, overheads = [], []
+        for seed in range(args.seed, args.seed + args.variants):
+            out = os.path.join(args.work_dir, '%s.%s.%d' % (name, mode, seed))
+            regions = randomize(args.rand, args.binary, out, seed, flags)
+            functions = compare(run_mca(args.mca, args.mcpu, args.iterations,
+                                        regions))
+            variants.append({'seed': seed, 'functions': functions})
+            overheads += [f['overhead_pct'] for f in functions.values()]
+        summary = {}
+        if overheads:
+            summary = {
+                'mean': sum(overheads) / len(overheads),
+                'p50': percentile(overheads, 50),
+                'p99': percentile(overheads, 99),
+                'max': max(overheads),
+            }
+        report['modes'][mode] = {
+            'flags': flags,
+            'variants': variants,
+            'summary': summary,
+        }
+
+    print('%-10s %10s %10s %10s %10s' % ('mode', 'mean', 'p50', 'p99', 'max'))
+    for mode, _ in modes:
+        summary = report['modes'][mode]['summary']
+        if not summary:
+            print('%-10s (no hot functions)' % mode)
+            continue
+        print('%-10s %+9.2f%% %+9.2f%% %+9.2f%% %+9.2f%%' % (
+            mode, summary['mean'], summary['p50'], summary['p99'],
+            summary['max']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(report, f, indent=2)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,206 @@
+#!/usr/bin/env python
+"""Measure the runtime cost of randomized variants of a CCR-built workload.
+
+The workload (built with the CCR toolchain, optionally by --build-cmd) is
+randomized by llvm-ccr-rand with --variants different seeds in each shuffle
+mode (function: the default; bbl: -shuffle-bbls), and every variant as well as
+the unrandomized binary runs under `perf stat`. The report (--json) holds the
+raw samples and, per mode, the distribution of each metric and its overhead
+over the baseline, e.g. for utils/ccr/check_overhead_budget.py:
+
+  {"version": 1, "workload": [...],
+   "baseline": {"samples": [{"time_ms": ..., "itlb_misses": ...}, ...],
+                "summary": {"time_ms": {"mean": ..., "p50": ..., "p99": ...},
+                            ...}},
+   "modes": {"function": {"variants": [{"seed": 1, "samples": [...]}, ...],
+                          "summary": {...},
+                          "overhead_pct": {"time_ms": {"mean": ...,
+                                                       "p99": ...}, ...}},
+             "bbl": {...}}}
+
+  run_ccr_perf.py --binary ./app --variants 20 --runs 5 --json perf.json \\
+      -- ./app --bench
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+REPORT_VERSION = 1
+
+# perf event -> metric name in the report
+EVENTS = [
+    ('task-clock', 'time_ms'),
+    ('iTLB-load-misses', 'itlb_misses'),
+    ('L1-icache-load-misses', 'l1i_misses'),
+    ('branch-misses', 'branch_misses'),
+]
+
+MODES = [
+    ('function', []),
+    ('bbl', ['-shuffle-bbls']),
+]
+
+
+def percentile(values, pct):
+    """Nearest-rank percentile of a non-empty list."""
+    ordered = sorted(values)
+    rank = int(math.ceil(pct / 100.0 * len(ordered)))
+    return ordered[max(rank, 1) - 1]
+
+
+def summarize(samples):
+    summary = {}
+    for _, metric in EVENTS:
+        values = [s[metric] for s in samples if s.get(metric) is not None]
+        if not values:
+            continue
+        summary[metric] = {
+            'mean': sum(values) / len(values),
+            'p50': percentile(values, 50),
+            'p99': percentile(values, 99),
+            'min': min(values),
+            'max': max(values),
+        }
+    return summary
+
+
+def overhead(summary, baseline):
+    result = {}
+    for metric, stats in summary.items():
+        base = baseline.get(metric)
+        if not base:
+            continue
+        result[metric] = dict(
+            (key, (stats[key] - base[key]) * 100.0 / base[key]
+             if base[key] else 0.0)
+            for key in ('mean', 'p50', 'p99'))
+    return result
+
+
+def perf_stat(perf, binary, workload, runs):
+    """Run the workload (with binary in place of argv[0]) runs times."""
+    cmd = [binary] + workload[1:]
+    samples = []
+    for _ in range(runs):
+        with tempfile.NamedTemporaryFile(suffix='.perf') as out:
+            perf_cmd = [perf, 'stat', '-x', ',', '-o', out.name,
+                        '-e', ','.join(e for e, _ in EVENTS), '--'] + cmd
+            with open(os.devnull, 'w') as null:
+                if subprocess.call(perf_cmd, stdout=null) != 0:
+                    sys.exit('error: %s failed' % ' '.join(perf_cmd))
+            samples.append(parse_perf(out.name))
+    return samples
+
+
+def parse_perf(path):
+    """Parse the CSV output of `perf stat -x ,`."""
+    names = dict(EVENTS)
+    sample = dict((metric, None) for _, metric in EVENTS)
+    with open(path) as f:
+        for line in f:
+            fields = line.strip().split(',')
+            if len(fields) < 3 or line.startswith('#'):
+                continue
+            # value, unit, event, ...; a :u/:k modifier may follow the event
+            event = fields[2].split(':')[0]
+            if event in names and fields[0] not in ('<not counted>',
+                                                    '<not supported>'):
+                sample[names[event]] = float(fields[0])
+    return sample
+
+
+def randomize(rand_tool, binary, out, seed, flags):
+    cmd = [rand_tool, '-seed=%d' % seed, '-o', out, binary] + flags
+    if subprocess.call(cmd) != 0:
+        sys.exit('error: %s failed' % ' '.join(cmd))
+    os.chmod(out, 0o755)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        usage='%(prog)s [options] -- workload [args...]')
+    parser.add_argument('--binary', required=True,
+                        help='the CCR-built binary that the workload runs')
+    parser.add_argument('--build-cmd',
+                        help='shell command that builds --binary first')
+    parser.add_argument('--rand', default='llvm-ccr-rand',
+                        help='the randomizer')
+    parser.add_argument('--perf', default='perf')
+    parser.add_argument('--variants', type=int, default=10,
+                        help='randomized variants per mode')
+    parser.add_argument('--runs', type=int, default=3,
+                        help='runs of every variant (and of the baseline, '
+                             'times the variants)')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='seed of the first variant')
+    parser.add_argument('--modes', default=','.join(m for m, _ in MODES),
+                        help='comma-separated shuffle modes')
+    parser.add_argument('--work-dir', default='ccr-perf',
+                        help='where the variants go')
+    parser.add_argument('--json', help='write the report to this file')
+    parser.add_argument('workload', nargs=argparse.REMAINDER)
+    args = parser.parse_args()
+
+    workload = args.workload
+    if workload and workload[0] == '--':
+        workload = workload[1:]
+    if not workload:
+        workload = [args.binary]
+    modes = [m for m in MODES if m[0] in args.modes.split(',')]
+
+    if args.build_cmd and subprocess.call(args.build_cmd, shell=True) != 0:
+        sys.exit('error: the build failed')
+    if not os.path.isdir(args.work_dir):
+        os.makedirs(args.work_dir)
+
+    base_samples = perf_stat(args.perf, args.binary, workload,
+                             args.runs * max(args.variants, 1))
+    base_summary = summarize(base_samples)
+    report = {
+        'version': REPORT_VERSION,
+        'workload': workload,
+        'baseline': {'samples': base_samples, 'summary': base_summary},
+        'modes': {},
+    }
+
+    name = os.path.basename(args.binary)
+    for mode, flags in modes:
+        variants, samples = [], []
+        for seed in range(args.seed, args.seed + args.variants):
+            out = os.path.join(args.work_dir, '%s.%s.%d' % (name, mode, seed))
+            randomize(args.rand, args.binary, out, seed, flags)
+            runs = perf_stat(args.perf, out, workload, args.runs)
+            variants.append({'seed': seed, 'samples': runs})
+            samples += runs
+        summary = summarize(samples)
+        report['modes'][mode] = {
+            'flags': flags,
+            'variants': variants,
+            'summary': summary,
+            'overhead_pct': overhead(summary, base_summary),
+        }
+
+    print('%-10s %-14s %10s %10s %10s' % ('mode', 'metric', 'mean', 'p50',
+                                          'p99'))
+    for mode, _ in modes:
+        for metric, stats in sorted(report['modes'][mode]['overhead_pct']
+                                    .items()):
+            print('%-10s %-14s %+9.2f%% %+9.2f%% %+9.2f%%' % (
+                mode, metric, stats['mean'], stats['p50'], stats['p99']))
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(report, f, indent=2)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
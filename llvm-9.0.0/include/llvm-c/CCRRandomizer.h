@@ -0,0 +1,174 @@
+/*===-- llvm-c/CCRRandomizer.h - CCR Randomizer C Interface -------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+|*===----------------------------------------------------------------------===*|
+|*                                                                            *|
+|* This header provides a public interface to the randomizer of llvm-ccr-rand *|
+|* (libLLVMCCRRandomizer), for the agents that randomize many binaries in     *|
+|* process rather than running the tool once per file.                        *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef LLVM_C_CCRRANDOMIZER_H
+#define LLVM_C_CCRRANDOMIZER_H
+
+#include "llvm-c/Types.h"
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#endif /* !defined(__cplusplus) */
+
+/**
+ * @defgroup LLVMCCCRRandomizer CCR Randomizer
+ * @ingroup LLVMC
+ *
+ * A context keeps the decoded .rand sections of the binaries opened with it,
+ * thus the variants of a binary decode its metadata once. A binary is opened,
+ * planned with a seed and a mode, and randomized into a file descriptor as
+ * many times as needed; the statistics tell the last randomization.
+ *
+ * The binaries of a context may be randomized on several threads at once if
+ * the context has been created as concurrent; otherwise a randomization
+ * patches the references of its binary on the thread pool of LLVM itself.
+ *
+ * @{
+ */
+
+#define LLVM_CCR_RANDOMIZER_API_VERSION 1
+
+/**
+ * The decoded metadata of the binaries.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+typedef struct LLVMOpaqueCCRContext *LLVMCCRContextRef;
+
+/**
+ * A binary built with CCR and its plan.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+typedef struct LLVMOpaqueCCRBinary *LLVMCCRBinaryRef;
+
+/**
+ * What a randomization permutes.
+ */
+typedef enum {
+  LLVMCCRModeFunctions,   /**< The functions (and the asm objects) */
+  LLVMCCRModeBasicBlocks, /**< The BBLs within the functions as well */
+  LLVMCCRModePaddingOnly  /**< Nothing; the BBLs slide within the padding */
+} LLVMCCRMode;
+
+/**
+ * The statistics of the last randomization of a binary.
+ */
+typedef enum {
+  LLVMCCRStatUnits,              /**< Functions (or asm objects) permuted */
+  LLVMCCRStatShuffledFunctions,  /**< Functions with their BBLs permuted */
+  LLVMCCRStatInsertedJumps,      /**< Jumps added for broken fall-throughs */
+  LLVMCCRStatRelaxedBranches,    /**< Short branches grown to long ones */
+  LLVMCCRStatGrowthBytes,        /**< Bytes the relaxed branches added */
+  LLVMCCRStatSlidBasicBlocks,    /**< BBLs slid within their padding */
+  LLVMCCRStatTextSize            /**< Bytes of the randomized range */
+} LLVMCCRStat;
+
+/**
+ * Returns the API version of the library.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern uint32_t LLVMCCRRandomizerVersion(void);
+
+/**
+ * Creates a context that keeps the metadata of up to \p CacheSize binaries.
+ * \p Concurrent tells that the binaries are randomized on several threads at
+ * once.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern LLVMCCRContextRef LLVMCCRCreateContext(unsigned CacheSize,
+                                              LLVMBool Concurrent);
+
+/**
+ * Disposes of a context; its binaries must have been disposed of first.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern void LLVMCCRDisposeContext(LLVMCCRContextRef Context);
+
+/**
+ * Opens the binary at \p Path and decodes its .rand section (unless the
+ * context has it already). Returns 0 on success; otherwise \p ErrorMessage is
+ * set to a message to dispose of with LLVMCCRDisposeMessage().
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern LLVMBool LLVMCCROpenBinary(LLVMCCRContextRef Context, const char *Path,
+                                  LLVMCCRBinaryRef *OutBinary,
+                                  char **ErrorMessage);
+
+/**
+ * Disposes of a binary.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern void LLVMCCRDisposeBinary(LLVMCCRBinaryRef Binary);
+
+/**
+ * Plans the next randomizations of a binary: the layout of \p Seed in the
+ * mode \p Mode. A binary is planned as LLVMCCRModeFunctions with the seed 0
+ * when opened.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern void LLVMCCRPlan(LLVMCCRBinaryRef Binary, uint64_t Seed,
+                        LLVMCCRMode Mode);
+
+/**
+ * Writes the binary randomized by its plan to the file descriptor \p FD, at
+ * its current position. Returns 0 on success; otherwise \p ErrorMessage is set
+ * to a message to dispose of with LLVMCCRDisposeMessage().
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern LLVMBool LLVMCCRRandomizeToFD(LLVMCCRBinaryRef Binary, int FD,
+                                     char **ErrorMessage);
+
+/**
+ * Returns a statistic of the last successful randomization of a binary, or 0
+ * if there has been none.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern uint64_t LLVMCCRGetStat(LLVMCCRBinaryRef Binary, LLVMCCRStat Stat);
+
+/**
+ * Returns the entropy (in bits) of the last successful randomization of a
+ * binary: log2 of the number of layouts it could have picked.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern double LLVMCCRGetEntropyBits(LLVMCCRBinaryRef Binary);
+
+/**
+ * Disposes of an error message.
+ *
+ * \since LLVM_CCR_RANDOMIZER_API_VERSION=1
+ */
+extern void LLVMCCRDisposeMessage(char *Message);
+
+/**
+ * @} // endgroup LLVMCCCRRandomizer
+ */
+
+#ifdef __cplusplus
+}
+#endif /* !defined(__cplusplus) */
+
+#endif /* LLVM_C_CCRRANDOMIZER_H */
@@ -0,0 +1,93 @@
+//===- RandChunk.h - CCR relocatable .rand chunk structures -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A .rand section of format 3 is a sequence of relocatable chunks, one per
+// object; each COMDAT group of an object has a chunk of its own, in a .rand
+// section within the group, so that it is discarded along with the group.
+// Likewise, -ccr-rand-per-section gives every section that --gc-sections may
+// drop a chunk in a .rand linked to it (SHF_LINK_ORDER).
+// The payload of a chunk is the encoded ReorderInfo (packed columns), whose
+// offsets are relative to the concrete sections listed in the chunk.
+// A linker merges the .rand sections of its inputs by concatenating the chunks
+// and patching their headers (the output offsets) in place, without decoding
+// any payload. Every field is little endian and every chunk is 8-byte aligned:
+//
+//   ChunkHeader
+//   ChunkSection Sections[NumSections]
+//   char Names[NamesSize]            (NUL-terminated section names)
+//   uint8 Payload[PayloadSize]
+//   padding up to the next multiple of 8
+//
+// The functions that templates instantiate alike have identical payloads in
+// the chunks of their groups. The assembler keys a chunk by the shapes of its
+// functions (ShapeHash), and the linker stores a payload only once: a chunk
+// whose payload equals that of an earlier chunk has no payload of its own and
+// refers to the earlier chunk instead (PayloadRef).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_BINARYFORMAT_RANDCHUNK_H
+#define LLVM_BINARYFORMAT_RANDCHUNK_H
+
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+
+namespace llvm {
+namespace ccr {
+
+struct ChunkHeader {
+  static constexpr uint32_t MagicSignature = 0x43524343; // CCRC
+  static constexpr uint32_t CurrentVersion = 3;
+  static constexpr uint64_t NoPayloadRef = ~0ULL;
+
+  support::ulittle32_t Signature;
+  support::ulittle32_t Version;
+  support::ulittle32_t NumSections;
+  support::ulittle32_t NamesSize;
+  support::ulittle64_t PayloadSize;
+  // Patched by the linker: the offset of the first BBL from the start of the
+  // output .text, and the offset of main() (0 unless the object defines it)
+  support::ulittle64_t RandObjOffset;
+  support::ulittle64_t MainAddrOffset;
+  // The number of layout (BBL) and fixup records in the payload, so that a
+  // linker can account for the CCR overhead without decoding it
+  support::ulittle32_t NumLayouts;
+  support::ulittle32_t NumFixups;
+  // The hash of the BBLs and .text fixups of every function of the payload,
+  // relative to the start of the function; 0 if the chunk is not to be shared
+  support::ulittle64_t ShapeHash;
+  // Set by the linker: the offset (in the merged section) of the chunk whose
+  // payload this chunk shares, with a PayloadSize of 0; NoPayloadRef otherwise
+  support::ulittle64_t PayloadRef;
+};
+static_assert(sizeof(ChunkHeader) == 64, "Unexpected padding!");
+
+/// A concrete section that the BBLs and fixups of the payload refer to by
+/// index (the section_idx columns).
+struct ChunkSection {
+  /// The Base of a section that is not in the output: garbage-collected, or
+  /// folded into an identical section (--icf) whose chunk keeps the layout.
+  static constexpr uint64_t DiscardedBase = ~0ULL;
+
+  // Patched by the linker: the offset of the section in its output section
+  support::ulittle64_t Base;
+  support::ulittle32_t NameOffset; // Into Names
+  support::ulittle32_t Ordinal;    // The nth section of that name in the object
+};
+static_assert(sizeof(ChunkSection) == 16, "Unexpected padding!");
+
+inline uint64_t getChunkSize(const ChunkHeader &H) {
+  return alignTo(sizeof(ChunkHeader) + H.NumSections * sizeof(ChunkSection) +
+                     H.NamesSize + H.PayloadSize,
+                 8);
+}
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_BINARYFORMAT_RANDCHUNK_H
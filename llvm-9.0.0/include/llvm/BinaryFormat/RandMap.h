@@ -0,0 +1,189 @@
+//===- RandMap.h - CCR address translation map structures ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A randomized binary keeps the debug information (.debug_line, ...) of
+// its original layout, thus the randomizer writes a sidecar map next to it
+// (<binary>.ccrmap) from which a profiler or a symbolizer translates the
+// addresses of samples back to the original ones. The map is the sorted list
+// of the moved ranges of .text; every field is little endian:
+//
+//   MapHeader
+//   MapRange Ranges[NumRanges]       (ascending OldAddr, non-overlapping)
+//
+// The header identifies the randomized .text the map belongs to, so that the
+// stale map of a binary randomized again is never applied.
+//
+// An in-process profiler cannot read a sidecar cheaply, thus a binary linked
+// with the layout runtime (see tools/llvm-ccr-rand/CCRLayout.h) reserves an
+// allocated note (name "CCR", type NT_CCR_LAYOUT) that the randomizer fills
+// in with the same ranges, compactly and sorted by their new addresses:
+//
+//   LayoutNoteHeader
+//   LayoutNoteRange Ranges[Capacity]  (the first NumRanges are valid)
+//
+// The runtime reserves a second note (type NT_CCR_HOT_PAGES) for the pages
+// that the hot and startup code occupies in the new layout, which a cold start
+// reads ahead at once (ccr_prefetch_hot_pages()) rather than faulting them in
+// one by one across the randomized .text:
+//
+//   HotPagesNoteHeader
+//   HotPageRange Ranges[Capacity]     (ascending, the first NumRanges are valid)
+//
+// A profile converter attributes the LBR and Intel PT samples to the BBLs of
+// .rand (thus to the MBBs of the build) by the BBL address map, which the
+// randomizer writes into a non-allocated section .ccr_bb_addr_map with
+// -bb-address-map. A BBL and its function are named by their indices in
+// .rand; a function whose cold chains moved away has an entry for each of
+// its runs of consecutive BBLs. The entries are in ascending addresses:
+//
+//   BBAddrMapHeader
+//   Entries[NumEntries]:
+//     ULEB128 FunctionID
+//     ULEB128 NumBBLs
+//     NumBBLs times:
+//       SLEB128 ID delta    (from the ID of the previous BBL plus one)
+//       ULEB128 Gap         (from the end of the previous BBL, or TextAddr)
+//       ULEB128 Size
+//
+// The code that the randomizer itself put into the new layout (the entry
+// trampolines, the long forms of the relaxed branches, the copies of the
+// duplicated tails and the NOPs on a fall-through path) is listed by
+// -synthetic-sites in a non-allocated section .ccr_synthetic_sites, thus a
+// profile tells what the randomization costs at run time. A site is named by
+// the BBL of .rand it stands for and by the original address of its code (the
+// entry of the function of a trampoline, the short branch, the tail copied,
+// the end of the BBL before the padding). The sites are in ascending
+// addresses:
+//
+//   SyntheticSitesHeader
+//   Sites[NumSites]:
+//     ULEB128 Gap           (from the end of the previous site, or TextAddr)
+//     ULEB128 Size
+//     uint8   Kind          (SyntheticSiteKind)
+//     ULEB128 BBL           (ID of the BBL in .rand)
+//     ULEB128 OrigAddr
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_BINARYFORMAT_RANDMAP_H
+#define LLVM_BINARYFORMAT_RANDMAP_H
+
+#include "llvm/Support/Endian.h"
+
+namespace llvm {
+namespace ccr {
+
+struct MapHeader {
+  static constexpr uint32_t MagicSignature = 0x4d524343; // CCRM
+  static constexpr uint32_t CurrentVersion = 1;
+
+  support::ulittle32_t Signature;
+  support::ulittle32_t Version;
+  support::ulittle64_t NumRanges;
+  // The randomized .text: its address, size and the xxHash64 of its contents
+  // (0 if the layout was only planned from its seed, see -plan-only)
+  support::ulittle64_t TextAddr;
+  support::ulittle64_t TextSize;
+  support::ulittle64_t TextHash;
+};
+static_assert(sizeof(MapHeader) == 40, "Unexpected padding!");
+
+/// [OldAddr, OldAddr + Size) of the original layout is now at NewAddr. The
+/// code in between the new ranges (alignment and inserted jumps) has no
+/// original address.
+struct MapRange {
+  support::ulittle64_t OldAddr;
+  support::ulittle64_t NewAddr;
+  support::ulittle64_t Size;
+};
+static_assert(sizeof(MapRange) == 24, "Unexpected padding!");
+
+enum : uint32_t { NT_CCR_LAYOUT = 1, NT_CCR_HOT_PAGES = 2 };
+
+struct LayoutNoteHeader {
+  static constexpr uint32_t MagicSignature = 0x4c524343; // CCRL
+  static constexpr uint32_t CurrentVersion = 1;
+
+  support::ulittle32_t Signature; // 0 until the binary is randomized
+  support::ulittle32_t Version;
+  support::ulittle32_t Capacity;  // Reserved by the runtime
+  support::ulittle32_t NumRanges;
+  // The link-time address of this header (the load bias of a PIE is the
+  // difference to its address in memory) and of .text
+  support::ulittle64_t NoteAddr;
+  support::ulittle64_t TextAddr;
+};
+static_assert(sizeof(LayoutNoteHeader) == 32, "Unexpected padding!");
+
+/// [NewOffset, NewOffset + Size) of .text came from OldOffset; the code up to
+/// the next range belongs to the last byte, as in RandAddressMap.
+struct LayoutNoteRange {
+  support::ulittle32_t NewOffset;
+  support::ulittle32_t OldOffset;
+  support::ulittle32_t Size;
+};
+static_assert(sizeof(LayoutNoteRange) == 12, "Unexpected padding!");
+
+struct HotPagesNoteHeader {
+  static constexpr uint32_t MagicSignature = 0x48524343; // CCRH
+  static constexpr uint32_t CurrentVersion = 1;
+
+  support::ulittle32_t Signature; // 0 until the binary is randomized
+  support::ulittle32_t Version;
+  support::ulittle32_t Capacity;  // Reserved by the runtime
+  support::ulittle32_t NumRanges;
+  // The link-time address of this header, as in LayoutNoteHeader, and the
+  // page size the ranges were rounded to
+  support::ulittle64_t NoteAddr;
+  support::ulittle64_t PageSize;
+};
+static_assert(sizeof(HotPagesNoteHeader) == 32, "Unexpected padding!");
+
+/// [Addr, Addr + Size) of the link-time addresses, in whole pages.
+struct HotPageRange {
+  support::ulittle64_t Addr;
+  support::ulittle64_t Size;
+};
+static_assert(sizeof(HotPageRange) == 16, "Unexpected padding!");
+
+struct BBAddrMapHeader {
+  static constexpr uint32_t MagicSignature = 0x42524343; // CCRB
+  static constexpr uint32_t CurrentVersion = 1;
+  static constexpr const char *SectionName = ".ccr_bb_addr_map";
+
+  support::ulittle32_t Signature;
+  support::ulittle32_t Version;
+  support::ulittle64_t NumEntries;
+  support::ulittle64_t TextAddr;
+};
+static_assert(sizeof(BBAddrMapHeader) == 24, "Unexpected padding!");
+
+enum SyntheticSiteKind : uint8_t {
+  SSK_Trampoline = 0,    // jmp rel32 at the old entry of an exported function
+  SSK_RelaxedBranch = 1, // The long form of a short branch out of reach
+  SSK_DuplicatedTail = 2, // The copy of the BBL that a jump went to
+  SSK_Padding = 3,        // Alignment NOPs that a BBL falls through
+  NumSyntheticSiteKinds
+};
+
+struct SyntheticSitesHeader {
+  static constexpr uint32_t MagicSignature = 0x53524343; // CCRS
+  static constexpr uint32_t CurrentVersion = 1;
+  static constexpr const char *SectionName = ".ccr_synthetic_sites";
+
+  support::ulittle32_t Signature;
+  support::ulittle32_t Version;
+  support::ulittle64_t NumSites;
+  support::ulittle64_t TextAddr;
+};
+static_assert(sizeof(SyntheticSitesHeader) == 24, "Unexpected padding!");
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_BINARYFORMAT_RANDMAP_H
@@ -15,6 +15,7 @@
 #ifndef LLVM_CODEGEN_ASMPRINTER_H
 #define LLVM_CODEGEN_ASMPRINTER_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -24,6 +25,7 @@
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/MC/MCReorderInfo.h" // Koo
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/SourceMgr.h"
 #include <cstdint>
@@ -62,6 +64,7 @@ struct MCCodePaddingContext;
 class MCContext;
 class MCExpr;
 class MCInst;
+class MCInstrInfo;
 class MCSection;
 class MCStreamer;
 class MCSubtargetInfo;
@@ -132,6 +135,19 @@ private:
   /// Emit comments in assembly output if this is true.
   bool VerboseAsm;
 
+  /// Koo: The functions whose .rand costs are remarked on, by function number
+  /// (see emitRandRemarks()).
+  DenseMap<unsigned, const Function *> RandRemarkFunctions;
+
+  /// Koo: The layout of the current function is recorded as a whole (at
+  /// function granularity) rather than by MBB (see getRandMBBKey()).
+  bool CoarseRandLayout = false;
+
+  /// Koo: The MBBs of the current function that are recorded along with the
+  /// MBBs before them, by MBB number: the number of the first MBB of their
+  /// run (see collectRandRuns()).
+  DenseMap<unsigned, unsigned> RandRunHeads;
+
   static char ID;
 
 protected:
@@ -175,6 +191,9 @@ private:
   /// when necessary.
   mutable std::unique_ptr<SrcMgrDiagInfo> DiagInfo;
 
+  /// Koo: Instruction info for parsing inline assembly, shared by every blob.
+  mutable std::unique_ptr<MCInstrInfo> InlineAsmMII;
+
   /// If the target supports dwarf debug info, this pointer is non-null.
   DwarfDebug *DD = nullptr;
 
@@ -198,6 +217,14 @@ public:
   // Koo
   const MCAsmInfo *getMCAsmInfo() { return MAI; }
 
+  /// Koo: The key that the instructions of \p MBB are recorded by in the
+  /// .rand section; at function granularity every MBB has the key of the
+  /// entry MBB, and an MBB of a coalesced run that of the first MBB of it.
+  MCMBBKey getRandMBBKey(const MachineBasicBlock &MBB) const;
+
+  /// Koo: The reordering information collected for the object.
+  MCReorderInfo &getReorderInfo() const;
+
   /// Return true if assembly output should contain comments.
   bool isVerbose() const { return VerboseAsm; }
 
@@ -633,10 +660,43 @@ private:
   /// This method emits the header for the current function.
   virtual void EmitFunctionHeader();
 
+  /// Koo: Record the hotness class of every MBB of the current function from
+  /// the profile, so that the randomizer keeps hot code together.
+  void collectMBBHotness();
+
+  /// Koo: Coalesce the runs of MBBs of the current function that the
+  /// randomizer can never separate into single layout records.
+  void collectRandRuns();
+
+  /// Koo: The last MBB of the run that \p MBB begins (\p MBB if none).
+  MachineBasicBlock &getRandRunEnd(MachineBasicBlock &MBB) const;
+
+  /// Koo: Whether the cost model of -ccr-granularity=auto records the current
+  /// function as a whole: too many MBBs for its metadata, or MBBs too tiny (or
+  /// too many of them dispatched through jump tables) for their shuffling to
+  /// pay for the jumps it adds.
+  bool isCoarseRandFunction();
+
+  /// Koo: Annotate the textual assembly with what has been recorded for the
+  /// MBB keyed \p ID (-ccr-asm-directives), so that the assembler need not
+  /// split the blocks at the labels and the terminators again.
+  void emitRandBBLDirective(const MachineBasicBlock &MBB, MCMBBKey ID);
+
+  /// Koo: Begin the \p Idx-th section of the chains of the current function
+  /// (-ccr-chain-sections) with \p MBB and a CFI frame of its own, in the
+  /// state that \p CFIs (those emitted so far) have built up.
+  void switchToChainSection(const MachineBasicBlock &MBB, unsigned Idx,
+                            const MCSection *FnSection,
+                            ArrayRef<const MachineInstr *> CFIs);
+
+  /// Koo: Remark on what the .rand section of the object, and of its heaviest
+  /// functions, takes next to the code once the object has been written.
+  void emitRandRemarks();
+
   /// Emit a blob of inline asm to the output streamer.
   void
   EmitInlineAsm(StringRef Str, const MCSubtargetInfo &STI,
-                const MCTargetOptions &MCOptions, std::string parentID, // Koo
+                const MCTargetOptions &MCOptions, MCMBBKey parentID, // Koo
                 const MDNode *LocMDNode = nullptr,
                 InlineAsm::AsmDialect AsmDialect = InlineAsm::AD_ATT) const;
 
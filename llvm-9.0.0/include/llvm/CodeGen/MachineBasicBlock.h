@@ -129,6 +129,15 @@ private:
   /// Indicate that this basic block is the entry block of a cleanup funclet.
   bool IsCleanupFuncletEntry = false;
 
+  /// Koo: Indicate that the block placement started a chain of the final
+  /// layout here, i.e., the block is not the best successor of the block
+  /// placed before it (see MachineBlockPlacement::buildChain()).
+  bool IsPlacementChainStart = false;
+
+  /// Koo: Indicate that the block begins a section of its own, which holds
+  /// its placement chain (-ccr-chain-sections).
+  bool IsChainSectionStart = false;
+
   /// since getSymbol is a relatively heavy-weight operation, the symbol
   /// is only computed once and is cached.
   mutable MCSymbol *CachedMCSymbol = nullptr;
@@ -169,6 +178,17 @@ public:
   /// its label be emitted.
   void setLabelMustBeEmitted() { LabelMustBeEmitted = true; }
 
+  /// Koo: Test whether the block placement started a chain of the final
+  /// layout at this block (the entry of a placed function always does).
+  bool isPlacementChainStart() const { return IsPlacementChainStart; }
+  void setPlacementChainStart(bool V = true) { IsPlacementChainStart = V; }
+
+  /// Koo: Test whether the block begins a section of its own (see
+  /// MachineBlockPlacement::markChainSections()); no block falls through
+  /// into it.
+  bool isChainSectionStart() const { return IsChainSectionStart; }
+  void setChainSectionStart(bool V = true) { IsChainSectionStart = V; }
+
   /// Return the MachineFunction containing this basic block.
   const MachineFunction *getParent() const { return xParent; }
   MachineFunction *getParent() { return xParent; }
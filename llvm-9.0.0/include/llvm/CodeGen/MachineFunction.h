@@ -473,8 +473,7 @@ public:
   MachineJumpTableInfo *getOrCreateJumpTableInfo(unsigned JTEntryKind);
   
   // Koo
-  void RecordMachineJumpTableInfo(MachineJumpTableInfo *MJTI);
-  mutable std::map<std::string, bool> canMBBFallThrough;
+  void RecordMachineJumpTableInfo(const MachineJumpTableInfo *MJTI) const;
 
   /// getConstantPool - Return the constant pool object for the current
   /// function.
@@ -787,6 +786,10 @@ public:
   /// base.
   MCSymbol *getPICBaseSymbol() const;
 
+  // Koo - A function-local symbol at the start of the function, the base of
+  //       the function-relative jump table entries
+  MCSymbol *getJTBaseSymbol() const;
+
   /// Returns a reference to a list of cfi instructions in the function's
   /// prologue.  Used to construct frame maps for debug and exception handling
   /// comsumers.
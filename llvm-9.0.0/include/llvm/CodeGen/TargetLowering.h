@@ -1490,6 +1490,11 @@ public:
     return TM.isPositionIndependent();
   }
 
+  // Koo - Whether the (EK_LabelDifference32) jump table entries are relative
+  //       to the start of the function (MachineFunction::getJTBaseSymbol())
+  //       rather than to the table, thus hold wherever the function is moved
+  virtual bool isJumpTableFunctionRelative() const { return false; }
+
   /// If a physical register, this specifies the register that
   /// llvm.savestack/llvm.restorestack should save and restore.
   unsigned getStackPointerRegisterToSaveRestore() const {
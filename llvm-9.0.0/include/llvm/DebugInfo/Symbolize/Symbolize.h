@@ -16,6 +16,7 @@
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/RandMap.h"
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
@@ -43,6 +44,12 @@ public:
     std::vector<std::string> DsymHints;
     std::string FallbackDebugPath;
     std::string DWPName;
+    // Koo: Translate the addresses of a binary randomized by llvm-ccr-rand
+    // with its <binary>.ccrmap, as its debug info names the original layout
+    bool UseCCRAddressMaps = true;
+    // Koo: Report the code that llvm-ccr-rand inserted (.ccr_synthetic_sites)
+    // as the code it stands for, marked as the overhead of its function
+    bool UseCCRSyntheticSites = true;
   };
 
   LLVMSymbolizer() = default;
@@ -77,6 +84,24 @@ private:
   Expected<SymbolizableModule *>
   getOrCreateModuleInfo(const std::string &ModuleName);
 
+  /// Load the address translation map of a randomized binary, if any.
+  void loadCCRAddressMap(const std::string &ModuleName,
+                         const std::string &BinaryName, const ObjectFile *Obj);
+
+  /// Translate \p ModuleOffset into the original layout of the module.
+  /// Returns true if the address was moved by the randomizer.
+  bool translateCCRAddress(const std::string &ModuleName,
+                           object::SectionedAddress &ModuleOffset) const;
+
+  /// Load the code that the randomizer inserted into the module, if listed.
+  void loadCCRSyntheticSites(const std::string &ModuleName,
+                             const ObjectFile *Obj);
+
+  /// The inserted code of the module at \p ModuleOffset, if any.
+  const object::RandSyntheticSite *
+  findCCRSyntheticSite(const std::string &ModuleName,
+                       object::SectionedAddress ModuleOffset) const;
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
@@ -108,6 +133,12 @@ private:
   std::map<std::pair<std::string, std::string>, std::unique_ptr<ObjectFile>>
       ObjectForUBPathAndArch;
 
+  /// The address translation maps of the randomized modules.
+  std::map<std::string, object::RandAddressMap> CCRAddressMaps;
+
+  /// The code that the randomizer inserted into the modules that list it.
+  std::map<std::string, std::vector<object::RandSyntheticSite>> CCRSyntheticSites;
+
   Options Opts;
 };
 
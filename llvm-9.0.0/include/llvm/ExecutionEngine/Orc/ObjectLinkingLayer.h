@@ -27,6 +27,8 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
@@ -153,6 +155,24 @@ private:
   std::vector<const void *> UntrackedEHFrameAddrs;
 };
 
+/// Koo: Randomizes the function order of every object linked by the layer:
+/// before addresses are assigned, the layout-next chains of atoms in each
+/// executable section are permuted, hence JIT'd code gets a new layout at
+/// the cost of a shuffle rather than of another codegen. An atom is a whole
+/// function, thus the BBLs keep their order.
+class CCRShufflePlugin : public ObjectLinkingLayer::Plugin {
+public:
+  explicit CCRShufflePlugin(uint64_t Seed) : RNG(Seed) {}
+  void modifyPassConfig(MaterializationResponsibility &MR, const Triple &TT,
+                        jitlink::PassConfiguration &PassConfig) override;
+
+private:
+  Error shuffleAtoms(jitlink::AtomGraph &G);
+
+  std::mutex RNGMutex; // Objects may be linked concurrently
+  std::mt19937_64 RNG;
+};
+
 } // end namespace orc
 } // end namespace llvm
 
@@ -30,6 +30,7 @@
 namespace llvm {
 class StringRef;
 class LLVMContext;
+class Module;
 class TargetMachine;
 
 /// Helper to gather options relevant to the target machine creation
@@ -41,7 +42,9 @@ struct TargetMachineBuilder {
   Optional<Reloc::Model> RelocModel;
   CodeGenOpt::Level CGOptLevel = CodeGenOpt::Aggressive;
 
-  std::unique_ptr<TargetMachine> create() const;
+  /// Koo: with the CCR settings of \p M, if any (see
+  /// TargetMachine::applyCCRModuleFlags())
+  std::unique_ptr<TargetMachine> create(const Module *M = nullptr) const;
 };
 
 /// This class define an interface similar to the LTOCodeGenerator, but adapted
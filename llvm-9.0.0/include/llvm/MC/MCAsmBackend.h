@@ -118,6 +118,17 @@ public:
   //      All backend but x86 does not employee it (or implemented locally)
   //      PPCMachO and X86MachO might rewrite the following function
   virtual unsigned getFixupKindLog2Size(unsigned Kind) const = 0;
+
+  // Koo: Log2 of the reach (+/-) of a PC-relative fixup kind in bytes, where the
+  //      encoding limits it below the bytes that the fixup dereferences
+  //      (i.e., +/-128 MB = 27 for an AArch64 b/bl); 0 if not limited
+  virtual unsigned getFixupKindReachLog2(unsigned Kind) const { return 0; }
+
+  // Koo: Whether a GOTPCREL fixup kind lets the linker relax its instruction into
+  //      a direct reference (i.e., call *foo@GOTPCREL(%rip) into addr32 call foo,
+  //      or a mov into a lea): 1 for R_X86_64_GOTPCRELX, 2 for REX_GOTPCRELX
+  //      (whose mov, test and binop may become immediates as well); 0 if not
+  virtual unsigned getFixupKindGOTRelax(unsigned Kind) const { return 0; }
   
   /// Check whether the given target requires emitting differences of two
   /// symbols as a set of relocations.
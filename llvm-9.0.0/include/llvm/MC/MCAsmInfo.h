@@ -17,6 +17,7 @@
 
 #include "llvm/ADT/StringRef.h"
 #include "llvm/MC/MCDirectives.h"
+#include "llvm/MC/MCReorderInfo.h"
 #include "llvm/MC/MCTargetOptions.h"
 #include <vector>
 
@@ -32,6 +33,7 @@ class MCContext;
 class MCCFIInstruction;
 class MCExpr;
 class MCSection;
+class MCSectionELF;
 class MCStreamer;
 class MCSubtargetInfo;
 class MCSymbol;
@@ -401,58 +403,75 @@ public:
   /// Get the code pointer size in bytes.
   unsigned getCodePointerSize() const { return CodePointerSize; }
   
-  // Koo: Essential bookkeeping information for reordering in the future (installation time)
-  // (a) MachineBasicBlocks (map)
-  //    * MFID_MBBID: <size, offset, # of fixups within MBB, alignments, type, sectionName>
-  //    - The type field represents when the block is the end of MF or Object where MBB = 0, MF = 1, and Obj = 2
-  //    - The sectionOrdinal field is for C++ only; it tells current BBL belongs to which section!
-  mutable std::map<std::string, std::tuple<unsigned, unsigned, unsigned, unsigned, unsigned, std::string>> MachineBasicBlocks;
-  //    * MFID: fallThrough-ability
-  mutable std::map<std::string, bool> canMBBFallThrough;
-  //    * MachineFunctionID: size
-  mutable std::map<unsigned, unsigned> MachineFunctionSizes;
-  //    - The order of the ID in a binary should be maintained layout because it might be non-sequential.
-  mutable std::list<std::string> MBBLayoutOrder;
-
-  // (b) Fixups (list)
-  //    * <offset, size, isRela, parentID, SymbolRefFixupName, isNewSection, secName, numJTEntries, JTEntrySz>
-  //    - The last two elements are jump table information for FixupsText only,
-  //      which allows for updating the jump table entries (relative values) with pic/pie-enabled.
-  mutable std::list<std::tuple<unsigned, unsigned, bool, std::string, std::string, bool, std::string, unsigned, unsigned>> 
-          FixupsText, FixupsRodata, FixupsData, FixupsDataRel, FixupsInitArray; 
-  //    - FixupsEhframe, FixupsExceptTable; (Not needed any more as a randomizer directly handles them later on)
-  //    - Keep track of the latest ID when parent ID is unavailable
-  mutable std::string latestParentID;
-
-  // (c) Others
-  //     The following method helps full-assembly file (*.s) identify functions and basic blocks
-  //     that inherently lacks their boundaries because neither MF nor MBB has been constructed.
-  mutable bool isAssemFile = false;
-  mutable bool hasInlineAssembly = false;
-  mutable std::string prevOpcode;
-  mutable unsigned assemFuncNo = 0xffffffff;
-  mutable unsigned assemBBLNo = 0;
-  mutable unsigned specialCntPriorToFunc = 0;
-
-    // Update emittedBytes from either DataFragment, RelaxableFragment or AlignFragment
-  void updateByteCounter(std::string id, unsigned emittedBytes, unsigned numFixups, \
-                         bool isAlign, bool isInline) const {
-    // std::string id = std::to_string(fnid) + "_" + std::to_string(bbid);
-    // Create the tuple for the MBB
-    if (MachineBasicBlocks.count(id) == 0) {
-      MachineBasicBlocks[id] = std::make_tuple(0, 0, 0, 0, 0, "");
-    }
-
-    // Otherwise update MBB tuples
-    std::get<0>(MachineBasicBlocks[id]) += emittedBytes; // Acutal size in MBB
-    std::get<2>(MachineBasicBlocks[id]) += numFixups;    // Number of Fixups in MBB
-    if (isAlign)
-      std::get<3>(MachineBasicBlocks[id]) += emittedBytes;  // Count NOPs in MBB
-
-    // If inlined, add the bytes in the next MBB instead of current one
-    if (isInline)
-      std::get<0>(MachineBasicBlocks[latestParentID]) -= emittedBytes;
+  // Koo: The settings of the reordering information (.rand); what is collected for
+  //      an object lives in the MCReorderInfo of its MCContext
+  //     Collect and emit the reordering information at all (-ccr-metadata, clang -fccr-metadata);
+  //     every hook of the code generator and of MC is skipped otherwise
+  bool RandMetadata = false;
+  //     Compression of the .rand section (-ccr-compress-rand); fixup offsets are delta-encoded if any
+  DebugCompressionType CompressRandSection = DebugCompressionType::None;
+  //     Wire format of the .rand section (-ccr-rand-format): 1 = per-BBL/per-fixup messages, 2 = packed columns,
+  //     3 = packed columns in a relocatable chunk (see llvm/BinaryFormat/RandChunk.h)
+  unsigned RandFormatVersion = 1;
+  //     Keep the fixups of data sections that refer to data (-ccr-keep-data-fixups); only d2c
+  //     (and unknown) fixups of data sections are emitted otherwise
+  bool KeepDataFixups = false;
+  //     Emit the metadata of every garbage-collectible section in a .rand linked to it
+  //     (-ccr-rand-per-section, format 3 only); see hasLinkedRandSection()
+  bool RandPerSection = false;
+  bool hasLinkedRandSection(const MCSectionELF &Sec) const;
+  //     Describe the CFI and the LSDA call sites by BBL (-ccr-eh-info, format 3 only); see
+  //     emitsRandEHInfo()
+  bool RandEHInfo = false;
+  bool emitsRandEHInfo() const {
+    return RandMetadata && RandEHInfo && RandFormatVersion >= 3;
   }
+  //     Record the layout by function rather than by MBB (-ccr-granularity=function);
+  //     see AsmPrinter::getRandMBBKey()
+  unsigned RandGranularity = MCMBBInfo::GranularityBBL;
+  bool hasRandFunctionGranularity() const {
+    return RandGranularity == MCMBBInfo::GranularityFunction;
+  }
+  //     Pick the granularity of every function without a ccr_granularity attribute by its
+  //     shape (-ccr-granularity=auto); see AsmPrinter::isCoarseRandFunction()
+  bool RandAutoGranularity = false;
+  //     The cost model of -ccr-granularity=auto: a function is recorded as a whole if it has
+  //     more than RandAutoMaxMBBs MBBs, or at least RandAutoMinMBBs MBBs of fewer than
+  //     RandAutoMinMBBInsts instructions on average or with RandAutoJumpTableDensity (percent)
+  //     jump table entries per MBB; the profile (if RandAutoHotness) halves RandAutoMinMBBs
+  //     for a hot function and leaves a cold one to RandAutoMaxMBBs only
+  unsigned RandAutoMaxMBBs = 0;
+  unsigned RandAutoMinMBBs = 0;
+  unsigned RandAutoMinMBBInsts = 0;
+  unsigned RandAutoJumpTableDensity = 0;
+  bool RandAutoHotness = false;
+  //     Annotate the textual assembly with a .ccr_bbl directive per recorded MBB
+  //     (-ccr-asm-directives), which the assembler reads back (see MCRandBBLFlags)
+  bool RandAsmDirectives = false;
+  //     Record the hash of the instructions of every function next to the hash of its symbol
+  //     name (-ccr-function-hashes, format 2 or 3); see AsmPrinter::EmitFunctionBody()
+  bool RandFunctionHashes = false;
+  //     Permute the functions of the module and the cold chains of every function with this
+  //     seed at build time (-ccr-compile-seed, 0 = off); see AsmPrinter::doInitialization() and
+  //     MachineBlockPlacement::shuffleColdChains()
+  uint64_t RandCompileSeed = 0;
+  //     Emit the block chains of every function (but the entry one) into sections of their own
+  //     (-ccr-chain-sections); see MachineBlockPlacement::markChainSections()
+  bool RandChainSections = false;
+  //     Leave out the fixups that the object relocates but those that the relocations cannot
+  //     tell (-ccr-omit-relocated-fixups); see BinaryInfo.fixups_from_relocs
+  bool OmitRelocatedFixups = false;
+  //     Record the runs of MBBs that the randomizer cannot separate as single BBLs
+  //     (-ccr-coalesce-mbbs); see AsmPrinter::collectRandRuns()
+  bool RandCoalesceMBBs = false;
+  //     The -ccr-* settings (and the revision of the collected information) as a key,
+  //     which tells apart objects whose .rand sections differ (i.e., in the ThinLTO cache)
+  static std::string getRandSettingsKey();
+  //     The -ccr-* settings that the IR records for the LTO backends (see
+  //     TargetMachine::addCCRModuleFlags()), and the settings it records over them
+  static void getRandOptions(MCTargetOptions &Options);
+  void setRandOptions(const MCTargetOptions &Options);
+
 
   /// Get the callee-saved register stack slot
   /// size in bytes.
@@ -41,6 +41,7 @@ class MCCodeEmitter;
 class MCFragment;
 class MCObjectWriter;
 class MCSection;
+class MCSectionELF;
 class MCValue;
 
 // FIXME: This really doesn't belong here. See comments below.
@@ -116,9 +117,6 @@ private:
   std::vector<IndirectSymbolData> IndirectSymbols;
 
   std::vector<DataRegionData> DataRegions;
-  
-  // Koo: the variable holds the name of the temporary file during compilation
-  std::string reorderTmpFile;
 
   /// The list of linker options to propagate into the object file.
   std::vector<std::vector<std::string>> LinkerOptions;
@@ -257,10 +255,8 @@ public:
   void setIsThumbFunc(const MCSymbol *Func) { ThumbFuncs.insert(Func); }
   
   // Koo
-  void setObjTmpName(std::string tmpFileName) { reorderTmpFile = tmpFileName; }
-  std::string getObjTmpName() const { return reorderTmpFile; }
-  std::string WriteRandInfo(const MCAsmLayout &Layout) const;
-  void writeReorderInfo(std::string fileName, ShuffleInfo::ReorderInfo* ri) const;
+  void WriteRandInfo(raw_ostream &OS, const MCAsmLayout &Layout,
+                     const MCSectionELF *Rand = nullptr) const;
 
   /// ELF e_header flags
   unsigned getELFHeaderEFlags() const { return ELFHeaderEFlags; }
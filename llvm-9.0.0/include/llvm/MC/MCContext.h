@@ -44,6 +44,7 @@ namespace llvm {
   class MCLabel;
   class MCObjectFileInfo;
   class MCRegisterInfo;
+  class MCReorderInfo;
   class MCSection;
   class MCSectionCOFF;
   class MCSectionELF;
@@ -81,6 +82,9 @@ namespace llvm {
 
     std::unique_ptr<CodeViewContext> CVContext;
 
+    /// Koo: The reordering information (.rand) collected for the object.
+    std::unique_ptr<MCReorderInfo> ReorderInfo;
+
     /// Allocator object used for creating machine code objects.
     ///
     /// We use a bump pointer allocator to avoid the need to track all allocated
@@ -297,6 +301,10 @@ namespace llvm {
 
     CodeViewContext &getCVContext();
 
+    /// Koo: The reordering information of the object being built; unlike the
+    /// MCAsmInfo of the target, it is never shared by two compilations.
+    MCReorderInfo &getReorderInfo();
+
     void setAllowTemporaryLabels(bool Value) { AllowTemporaryLabels = Value; }
     void setUseNamesOnTempLabels(bool Value) { UseNamesOnTempLabels = Value; }
 
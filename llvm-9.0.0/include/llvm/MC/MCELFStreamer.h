@@ -45,7 +45,6 @@ public:
   
   // Koo
   void EmitRand() override;
-  void setObjTmpName(std::string tmpFileName) override;
   
   void EmitAssemblerFlag(MCAssemblerFlag Flag) override;
   void EmitThumbFunc(MCSymbol *Func) override;
@@ -10,13 +10,12 @@
 #define LLVM_MC_MCFIXUP_H
 
 #include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCReorderInfo.h" // Koo
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/SMLoc.h"
 #include <cassert>
 
-#include <string> // Koo
-
 namespace llvm {
 class MCExpr;
 
@@ -89,10 +88,10 @@ class MCFixup {
   /// The source location which gave rise to the fixup, if any.
   SMLoc Loc;
   
-  // Koo
-  std::string FixupParentID;
-  bool isJumpTableRef = false;
-  std::string SymbolRefFixupName;
+  // Koo: Handles into MCReorderInfo::MBBHandles and MCReorderInfo::JTHandles, which
+  //      keep MCFixup small and trivially copyable
+  MCMBBHandle FixupParentID;
+  MCJTHandle JumpTableRef;
   
 public:
   static MCFixup create(uint32_t Offset, const MCExpr *Value,
@@ -134,12 +133,11 @@ public:
   void setOffset(uint32_t Value) { Offset = Value; }
   
   // Koo
-  std::string getFixupParentID() const { return FixupParentID; }
-  void setFixupParentID(std::string Value) { FixupParentID = Value; }
-  bool getIsJumpTableRef() const { return isJumpTableRef; }
-  void setIsJumpTableRef(bool V) { isJumpTableRef = V; }
-  std::string getSymbolRefFixupName() const { return SymbolRefFixupName; }
-  void setSymbolRefFixupName(std::string FN) { SymbolRefFixupName = FN; }
+  MCMBBHandle getFixupParentID() const { return FixupParentID; }
+  void setFixupParentID(MCMBBHandle Value) { FixupParentID = Value; }
+  bool getIsJumpTableRef() const { return JumpTableRef.isValid(); }
+  MCJTHandle getJumpTableRef() const { return JumpTableRef; }
+  void setJumpTableRef(MCJTHandle JT) { JumpTableRef = JT; }
 
   const MCExpr *getValue() const { return Value; }
 
@@ -22,8 +22,8 @@
 #include <utility>
 
 // Koo
-#include <string> 
-#include <list>
+#include "llvm/MC/MCReorderInfo.h"
+#include <string>
 
 namespace llvm {
 
@@ -79,7 +79,7 @@ private:
   uint64_t Offset;
   
   // Koo
-  std::list<std::string> MBBIDs;
+  MCMBBRunList MBBIDs;
   /// @}
 
 protected:
@@ -119,13 +119,8 @@ public:
   
   // Koo
   uint64_t getOffset() { return Offset; }
-  const std::list<std::string> getAllMBBs() const {return MBBIDs; }
-  void addMachineBasicBlockTag(std::string T) { 
-    for (auto it=MBBIDs.begin(); it!=MBBIDs.end(); ++it)
-      if (T.compare(*it) == 0)
-        return;
-    MBBIDs.push_back(T); 
-  }
+  const MCMBBRunList &getAllMBBs() const { return MBBIDs; }
+  void addMachineBasicBlockTag(MCMBBKey T) { MBBIDs.push_back(T); }
 
   void dump() const;
 };
@@ -256,15 +251,15 @@ public:
 ///
 class MCDataFragment : public MCEncodedFragmentWithFixups<32, 4> {
 protected:
-  std::string ParentID;
+  MCMBBKey ParentID;
   
 public:
   MCDataFragment(MCSection *Sec = nullptr)
       : MCEncodedFragmentWithFixups<32, 4>(FT_Data, false, Sec) {}
 
   // Koo: Check out the last parentID in MCAssembler
-  void setLastParentTag(std::string P) { ParentID = P; }
-  const std::string getLastParentTag() const { return ParentID; }
+  void setLastParentTag(MCMBBKey P) { ParentID = P; }
+  MCMBBKey getLastParentTag() const { return ParentID; }
   
   static bool classof(const MCFragment *F) {
     return F->getKind() == MCFragment::FT_Data;
@@ -294,11 +289,10 @@ class MCRelaxableFragment : public MCEncodedFragmentWithFixups<8, 1> {
 
   /// Inst - The instruction this is a fragment for.
   MCInst Inst;
-  
-  // Koo - The alreadyRelaxedBytes and fixupCtr contain the current relaxed info.
-  //       These values can be re-evaluated
-  unsigned alreadyRelaxedBytes = 0;
-  unsigned fixupCtr = 0;
+
+  /// Koo: The encoding of the instruction before the assembler first relaxed
+  /// it (empty if it never was), for the CCR reordering information.
+  SmallString<8> ShortForm;
 
 public:
   MCRelaxableFragment(const MCInst &Inst, const MCSubtargetInfo &STI,
@@ -308,12 +302,9 @@ public:
 
   const MCInst &getInst() const { return Inst; }
   void setInst(const MCInst &Value) { Inst = Value; }
-  
-  // Koo
-  unsigned getRelaxedBytes() { return alreadyRelaxedBytes; }
-  void setRelaxedBytes(unsigned RB) { alreadyRelaxedBytes = RB; }
-  unsigned getFixup() { return fixupCtr; }
-  void setFixup(unsigned F) { fixupCtr = F; }
+
+  StringRef getShortForm() const { return ShortForm; }
+  void setShortForm(StringRef Code) { ShortForm = Code; }
 
   static bool classof(const MCFragment *F) {
     return F->getKind() == MCFragment::FT_Relaxable;
@@ -17,6 +17,7 @@
 
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/MC/MCReorderInfo.h" // Koo
 #include "llvm/Support/SMLoc.h"
 #include <cassert>
 #include <cstddef>
@@ -163,9 +164,7 @@ class MCInst {
   SmallVector<MCOperand, 8> Operands;
   
   // Koo
-  mutable unsigned byteCtr = 0;
-  mutable unsigned fixupCtr = 0;
-  std::string ParentID;
+  MCMBBHandle ParentID; // Into MCReorderInfo::MBBHandles
   
   // These flags could be used to pass some info from one target subcomponent
   // to another, for example, from disassembler to asm printer. The values of
@@ -206,15 +205,9 @@ public:
     return Operands.insert(I, Op);
   }
 
-  // Koo: Use the followings when RelaxableFragment ends up not with being relaxed
-  void setByteCtr(unsigned numBytes) const { byteCtr = numBytes; }
-  unsigned getByteCtr() const { return byteCtr; }
-  void setFixupCtr(unsigned numFixups) const { fixupCtr = numFixups; }
-  unsigned getFixupCtr() const { return fixupCtr; }
-
-  // Koo: Set the parent ID of this MCInst: "MFID_MBBID"
-  void setParent(std::string P) { ParentID = P; }
-  const std::string getParent() const { return ParentID; }
+  // Koo: Set the parent ID of this MCInst: <MFID, MBBID>
+  void setParent(MCMBBHandle P) { ParentID = P; }
+  MCMBBHandle getParent() const { return ParentID; }
 
   void print(raw_ostream &OS) const;
   void dump() const;
@@ -15,6 +15,7 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCReorderInfo.h"
 #include "llvm/MC/MCSymbol.h"
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/VersionTuple.h"
@@ -185,6 +186,7 @@ protected:
   MCSection *MergeableConst32Section;
   
   MCSection *RandSection; // Koo (.rand)
+  mutable DenseMap<const MCSymbol *, unsigned> RandUniquing;
 
   // MachO specific sections.
 
@@ -244,18 +246,6 @@ public:
     return CompactUnwindDwarfEHFrameOnly;
   }
 
-  // Koo - Contains all JumpTables whose entries consist of the target MFs and MBBs
-  //<MachineFunctionIdx_JumpTableIdx> - <(EntryKind, EntrySize, Entries[MFID_MBBID])>
-  mutable std::map<std::string, std::tuple<unsigned, unsigned, std::list<std::string>>> JumpTableTargets;
-
-  std::map<std::string, std::tuple<unsigned, unsigned, std::list<std::string>>> \
-        getJumpTableTargets() const { return JumpTableTargets; }
-
-  void updateJumpTableTargets(std::string Key, unsigned EntryKind, unsigned EntrySize, \
-                              std::list<std::string> JTEntries) const {
-    JumpTableTargets[Key] = std::make_tuple(EntryKind, EntrySize, JTEntries);
-  }
-
   MCSection *getTextSection() const { return TextSection; }
   MCSection *getDataSection() const { return DataSection; }
   MCSection *getBSSSection() const { return BSSSection; }
@@ -341,6 +331,10 @@ public:
 
   MCSection *getStackSizesSection(const MCSection &TextSec) const;
 
+  /// Koo: The .rand section that carries the CCR metadata of \p Sec alone,
+  /// linked to it (see MCAsmInfo::hasLinkedRandSection()).
+  MCSection *getLinkedRandSection(const MCSection &Sec) const;
+
   // ELF specific sections.
   MCSection *getDataRelROSection() const { return DataRelROSection; }
   const MCSection *getMergeableConst4Section() const {
@@ -111,7 +111,6 @@ public:
   
   // Koo
   void EmitRand() override;
-  void setObjTmpName(std::string tmpFileName) override;
   
   void EmitAssignment(MCSymbol *Symbol, const MCExpr *Value) override;
   void EmitValueImpl(const MCExpr *Value, unsigned Size,
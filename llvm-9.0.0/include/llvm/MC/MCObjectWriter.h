@@ -9,6 +9,7 @@
 #ifndef LLVM_MC_MCOBJECTWRITER_H
 #define LLVM_MC_MCOBJECTWRITER_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
@@ -24,6 +25,7 @@ class MCAsmLayout;
 class MCAssembler;
 class MCFixup;
 class MCFragment;
+class MCSection;
 class MCSymbol;
 class MCSymbolRefExpr;
 class MCValue;
@@ -70,6 +72,14 @@ public:
                                 const MCFixup &Fixup, MCValue Target,
                                 uint64_t &FixedValue) = 0;
 
+  /// Koo: Return the number of relocations recorded for \p Sec so far, which are
+  /// written in that order, thus the next one recorded gets this index in its
+  /// relocation section (see MCFixupRecord::RelocIdx); None if the writer does
+  /// not keep the order.
+  virtual Optional<uint64_t> getNumRelocations(const MCSection &Sec) const {
+    return None;
+  }
+
   /// Check whether the difference (A - B) between two symbol references is
   /// fully resolved.
   ///
@@ -360,6 +360,9 @@ public:
 
   const MCSubtargetInfo &getSTI() const;
 
+  // Koo: Classify the matched instructions (i.e., BBL terminators in assembly)
+  const MCInstrInfo &getMII() const { return MII; }
+
   const FeatureBitset& getAvailableFeatures() const {
     return AvailableFeatures;
   }
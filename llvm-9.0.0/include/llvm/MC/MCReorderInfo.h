@@ -0,0 +1,779 @@
+//===- llvm/MC/MCReorderInfo.h - CCR basic block bookkeeping ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Compact bookkeeping types for the reordering information (.rand) that
+// the CCR toolchain collects while lowering and assembling a translation unit.
+// A machine basic block is identified by its (MFID, MBBID) pair, packed in a
+// single 64-bit key so that it can travel along with MCInst, MCFixup and
+// MCFragment without any heap allocation.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_MC_MCREORDERINFO_H
+#define LLVM_MC_MCREORDERINFO_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/shuffleInfoWriter.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+
+class MCRelaxableFragment;
+class MCSection;
+class MCSymbol;
+class raw_ostream;
+
+/// Packed (MFID, MBBID) pair that identifies a basic block within an object.
+/// The default-constructed key is invalid and stands for "no parent".
+class MCMBBKey {
+  uint64_t Raw = ~0ULL;
+
+  explicit MCMBBKey(uint64_t R) : Raw(R) {}
+
+public:
+  MCMBBKey() = default;
+  MCMBBKey(unsigned MFID, unsigned MBBID)
+      : Raw((uint64_t(MFID) << 32) | uint64_t(MBBID)) {}
+
+  /// Module-level inline assembly has no parent function (was "9999_0").
+  static MCMBBKey getModuleInlineAsm() { return MCMBBKey(9999, 0); }
+
+  bool isValid() const { return Raw != ~0ULL; }
+  unsigned getMFID() const { return unsigned(Raw >> 32); }
+  unsigned getMBBID() const { return unsigned(Raw); }
+  uint64_t getRawValue() const { return Raw; }
+
+  /// Human-readable "MFID_MBBID" form for the ccr-metadata debug output.
+  std::string str() const {
+    if (!isValid())
+      return "";
+    return std::to_string(getMFID()) + "_" + std::to_string(getMBBID());
+  }
+
+  bool operator==(const MCMBBKey &RHS) const { return Raw == RHS.Raw; }
+  bool operator!=(const MCMBBKey &RHS) const { return Raw != RHS.Raw; }
+  bool operator<(const MCMBBKey &RHS) const { return Raw < RHS.Raw; }
+};
+
+raw_ostream &operator<<(raw_ostream &OS, const MCMBBKey &Key);
+
+/// Basic blocks that own the bytes of a fragment, in emission order. The
+/// blocks of a fragment are mostly consecutive, thus they are kept as runs of
+/// (MFID, MBBID .. MBBID + Length - 1); the first run is stored inline, so a
+/// fragment does not allocate unless its blocks are scattered. A block is
+/// appended in O(1): only a repetition of the last block is ignored, which
+/// is how instructions of the same block arrive.
+class MCMBBRunList {
+  struct Run {
+    MCMBBKey First;
+    unsigned Length;
+  };
+  Run Head = {MCMBBKey(), 0};
+  std::unique_ptr<std::vector<Run>> Tail; // Runs after the first one
+
+  const Run &getRun(unsigned Idx) const {
+    return Idx == 0 ? Head : (*Tail)[Idx - 1];
+  }
+  unsigned getNumRuns() const {
+    return Head.Length == 0 ? 0 : 1 + (Tail ? Tail->size() : 0);
+  }
+
+public:
+  class const_iterator {
+    const MCMBBRunList *List;
+    unsigned RunIdx, Pos;
+
+  public:
+    const_iterator(const MCMBBRunList *List, unsigned RunIdx, unsigned Pos)
+        : List(List), RunIdx(RunIdx), Pos(Pos) {}
+
+    MCMBBKey operator*() const {
+      const Run &R = List->getRun(RunIdx);
+      return Pos == 0 ? R.First
+                      : MCMBBKey(R.First.getMFID(), R.First.getMBBID() + Pos);
+    }
+    const_iterator &operator++() {
+      if (++Pos == List->getRun(RunIdx).Length) {
+        ++RunIdx;
+        Pos = 0;
+      }
+      return *this;
+    }
+    bool operator==(const const_iterator &RHS) const {
+      return RunIdx == RHS.RunIdx && Pos == RHS.Pos;
+    }
+    bool operator!=(const const_iterator &RHS) const { return !(*this == RHS); }
+  };
+
+  const_iterator begin() const { return const_iterator(this, 0, 0); }
+  const_iterator end() const { return const_iterator(this, getNumRuns(), 0); }
+  bool empty() const { return Head.Length == 0; }
+
+  void push_back(MCMBBKey Key) {
+    Run &Last = Tail ? Tail->back() : Head;
+    if (Last.Length > 0) {
+      MCMBBKey LastKey = *const_iterator(this, getNumRuns() - 1, Last.Length - 1);
+      if (Key == LastKey)
+        return;
+      if (Key.isValid() && LastKey.isValid() &&
+          Key.getMFID() == LastKey.getMFID() &&
+          Key.getMBBID() == LastKey.getMBBID() + 1) {
+        Last.Length++;
+        return;
+      }
+    }
+    if (Head.Length == 0) {
+      Head = {Key, 1};
+      return;
+    }
+    if (!Tail)
+      Tail.reset(new std::vector<Run>());
+    Tail->push_back({Key, 1});
+  }
+};
+
+/// Packed (MFID, JTI) pair that identifies a jump table (.LJTI<MFID>_<JTI>).
+class MCJTKey {
+  uint64_t Raw = ~0ULL;
+
+public:
+  MCJTKey() = default;
+  MCJTKey(unsigned MFID, unsigned JTI)
+      : Raw((uint64_t(MFID) << 32) | uint64_t(JTI)) {}
+
+  bool isValid() const { return Raw != ~0ULL; }
+  unsigned getMFID() const { return unsigned(Raw >> 32); }
+  unsigned getJTI() const { return unsigned(Raw); }
+  uint64_t getRawValue() const { return Raw; }
+
+  bool operator==(const MCJTKey &RHS) const { return Raw == RHS.Raw; }
+  bool operator!=(const MCJTKey &RHS) const { return Raw != RHS.Raw; }
+  bool operator<(const MCJTKey &RHS) const { return Raw < RHS.Raw; }
+};
+
+raw_ostream &operator<<(raw_ostream &OS, const MCJTKey &Key);
+
+/// 32-bit handle of a key interned in an MCKeyTable. MCInst and MCFixup are
+/// copied around on every emitted instruction, thus they carry the handle
+/// instead of the key itself; the default-constructed handle is invalid.
+template <typename KeyT> class MCKeyHandle {
+  uint32_t Raw = ~0U;
+
+public:
+  MCKeyHandle() = default;
+  explicit MCKeyHandle(uint32_t Idx) : Raw(Idx) {}
+
+  bool isValid() const { return Raw != ~0U; }
+  uint32_t getIndex() const { return Raw; }
+
+  bool operator==(const MCKeyHandle &RHS) const { return Raw == RHS.Raw; }
+  bool operator!=(const MCKeyHandle &RHS) const { return Raw != RHS.Raw; }
+};
+
+using MCMBBHandle = MCKeyHandle<MCMBBKey>;
+using MCJTHandle = MCKeyHandle<MCJTKey>;
+
+/// Side table that maps handles back to their keys. Consecutive instructions
+/// mostly share their parent, so the last interned key is cached. Functions
+/// are emitted one after another, thus the index only holds the keys of the
+/// current function: the handles of the earlier ones stay valid, and a key
+/// that shows up again (i.e., latestParentID) merely gets another handle.
+template <typename KeyT> class MCKeyTable {
+  std::vector<KeyT> Keys;
+  DenseMap<uint64_t, uint32_t> Index;
+  KeyT LastKey;
+  MCKeyHandle<KeyT> LastHandle;
+
+public:
+  /// Return the handle of \p Key, adding it to the table if necessary.
+  MCKeyHandle<KeyT> intern(KeyT Key) {
+    if (!Key.isValid())
+      return MCKeyHandle<KeyT>();
+    if (Key == LastKey)
+      return LastHandle;
+    if (LastKey.isValid() && Key.getMFID() != LastKey.getMFID())
+      Index.clear();
+    auto It = Index.insert(std::make_pair(Key.getRawValue(), uint32_t(Keys.size())));
+    if (It.second)
+      Keys.push_back(Key);
+    LastKey = Key;
+    LastHandle = MCKeyHandle<KeyT>(It.first->second);
+    return LastHandle;
+  }
+
+  KeyT lookup(MCKeyHandle<KeyT> Handle) const {
+    return Handle.isValid() ? Keys[Handle.getIndex()] : KeyT();
+  }
+
+  unsigned size() const { return Keys.size(); }
+
+  void clear() {
+    Keys.clear();
+    Index.clear();
+    LastKey = KeyT();
+    LastHandle = MCKeyHandle<KeyT>();
+  }
+
+  /// Free the table once no handle is looked up any more.
+  void release() {
+    clear();
+    Keys.shrink_to_fit();
+    Index.shrink_and_clear();
+  }
+};
+
+/// Jump table entries: the MBB numbers (within the MF) of the targets.
+/// FunctionRelative entries are offsets from the start of the MF rather than
+/// from the table (see TargetLowering::isJumpTableFunctionRelative()).
+struct MCJumpTableInfo {
+  unsigned EntryKind = 0;
+  unsigned EntrySize = 0;
+  bool FunctionRelative = false;
+  std::vector<unsigned> Entries;
+};
+
+/// Per-MBB reordering information.
+///   - Type represents whether the block is the end of MF or Object
+///     where MBB = 0, MF = 1, and Obj = 2
+///   - SectionIdx is for C++ only; it tells current BBL belongs to which section
+///     (an index into MCSectionNameTable, or NoSection until the BBL is placed)
+///   - Hotness is the class of the block by the profile (if any),
+///     where unknown = 0, hot = 1, and cold = 2
+///   - Alignments counts the padding (NOPs) at the end of the block, which
+///     aligns the next one; AlignLog2 is the alignment of the block itself
+///     (including the function alignment for an entry block)
+///   - HasCFI tells that the block holds CFI instructions (-ccr-eh-info)
+///   - ChainStart tells that MachineBlockPlacement began a chain at the block,
+///     and LayoutEdgeProb is the probability (in 15ths) of the edge from the
+///     block into the next one in the layout
+///   - BoundaryLog2 tells that a padding fragment (MCCodePadder) keeps the
+///     instruction of BoundarySize bytes at BoundaryOffset (in its section)
+///     clear of the 2^BoundaryLog2-byte boundaries; 0 if none
+/// The small fields are bytes, as every MBB of the object has an entry until
+/// its .rand section is written.
+struct MCMBBInfo {
+  static const unsigned NoSection = ~0U;
+  static const unsigned HotnessUnknown = 0, HotnessHot = 1, HotnessCold = 2;
+  // How finely the randomizer may move a function ("ccr-granularity")
+  static const unsigned GranularityBBL = 0, GranularityFunction = 1,
+                        GranularityNone = 2;
+  // The kind of the last instruction of the MBB (see setMBBTermKind()); a
+  // parsed one (inline or standalone assembly) is of none
+  static const unsigned TermNone = 0, TermJump = 1, TermCondBranch = 2,
+                        TermReturn = 3, TermIndirect = 4;
+
+  uint64_t Offset = 0;
+  unsigned Size = 0;
+  unsigned NumFixups = 0;
+  unsigned Alignments = 0;
+  unsigned SectionIdx = NoSection;
+  uint8_t AlignLog2 = 0;
+  uint8_t Type = 0;
+  uint8_t Hotness = HotnessUnknown;
+  uint8_t LayoutEdgeProb = 0;
+  uint8_t TermSize = 0; // Of the last instruction, final once laid out
+  uint8_t TermKind = TermNone;
+  unsigned InternalBoundaries = 0; // Of the MBBs coalesced into the record
+  uint8_t BoundarySize = 0;
+  uint8_t BoundaryLog2 = 0;
+  uint64_t BoundaryOffset = 0;
+  const MCRelaxableFragment *TermFragment = nullptr; // If it is relaxable
+  bool FallThrough = false;
+  bool IsLoopHeader = false;
+  bool HasCFI = false;
+  bool Pinned = false; // Of a function at GranularityNone
+  bool ChainStart = false;
+  bool Exists = false; // The slot is populated
+
+  bool hasSection() const { return SectionIdx != NoSection; }
+};
+
+/// Flags of the .ccr_bbl directive, which carries the MCMBBInfo of a block
+/// through textual assembly (-ccr-asm-directives):
+///   .ccr_bbl MFID, MBBID, flags, align_log2, edge_prob
+namespace MCRandBBLFlags {
+enum : unsigned {
+  FallThrough = 1 << 0,
+  LoopHeader = 1 << 1,
+  Hot = 1 << 2,
+  Cold = 1 << 3,
+  ChainStart = 1 << 4,
+  InlineAsm = 1 << 5,             // The block holds inline assembly
+  GranularityFunction = 1 << 6,   // Of the function ("ccr-granularity")
+  GranularityNone = 1 << 7,
+  All = (1 << 8) - 1
+};
+} // end namespace MCRandBBLFlags
+
+/// The call-site table of the LSDA of a function (-ccr-eh-info): Records is
+/// the label of its first call-site record, in the LSDA section. The offsets
+/// and the section indices are resolved once the layout is final.
+struct MCCallSiteTable {
+  unsigned MFID = 0;
+  const MCSymbol *Records = nullptr;
+  unsigned NumRecords = 0;
+  uint64_t FunctionOffset = 0;
+  unsigned FunctionSectionIdx = MCMBBInfo::NoSection;
+  uint64_t TableOffset = 0;
+  unsigned TableSectionIdx = MCMBBInfo::NoSection;
+
+  bool isResolved() const {
+    return FunctionSectionIdx != MCMBBInfo::NoSection &&
+           TableSectionIdx != MCMBBInfo::NoSection;
+  }
+};
+
+/// Interned section names; records refer to a section by its small index.
+/// The table is serialized as ReorderInfo.section_names in the .rand section.
+/// A concrete section (i.e., one .text.<function> among several sections of
+/// the same name in different groups) may also be given an index of its own.
+class MCSectionNameTable {
+  std::vector<std::string> Names;
+  StringMap<unsigned> Index;
+  DenseMap<const void *, unsigned> SectionIndex; // By MCSection
+  std::vector<bool> Claimed; // The index belongs to a concrete section
+  std::vector<const MCSection *> Sections; // The concrete section of an index
+
+public:
+  /// Return the index of \p Name, adding it to the table if necessary.
+  unsigned intern(StringRef Name) {
+    auto It = Index.insert(std::make_pair(Name, unsigned(Names.size())));
+    if (It.second)
+      Names.push_back(Name.str());
+    return It.first->second;
+  }
+
+  /// Return the index of the concrete section \p Sec named \p Name; the
+  /// first section of a name shares its index with intern(Name).
+  unsigned intern(const MCSection *Sec, StringRef Name) {
+    auto It = SectionIndex.find(Sec);
+    if (It != SectionIndex.end())
+      return It->second;
+    unsigned Idx = intern(Name);
+    if (Claimed.size() < Names.size())
+      Claimed.resize(Names.size(), false);
+    if (Claimed[Idx]) {
+      Idx = Names.size();
+      Names.push_back(Name.str());
+      Claimed.push_back(false);
+    }
+    Claimed[Idx] = true;
+    SectionIndex[Sec] = Idx;
+    if (Sections.size() <= Idx)
+      Sections.resize(Idx + 1, nullptr);
+    Sections[Idx] = Sec;
+    return Idx;
+  }
+
+  StringRef getName(unsigned Idx) const { return Names[Idx]; }
+  /// Return the concrete section of \p Idx (null if it has been interned by
+  /// its name only).
+  const MCSection *getSection(unsigned Idx) const {
+    return Idx < Sections.size() ? Sections[Idx] : nullptr;
+  }
+  const std::vector<std::string> &getNames() const { return Names; }
+  unsigned size() const { return Names.size(); }
+
+  void clear() {
+    Names.clear();
+    Index.clear();
+    SectionIndex.clear();
+    Claimed.clear();
+    Sections.clear();
+  }
+};
+
+/// Sections whose fixups are collected in the .rand section, in the order of
+/// the fixup lists of the ReorderInfo message. The class of a section is
+/// resolved once by its name prefix (see getFixupSectionKind()).
+enum MCFixupSectionKind : uint8_t {
+  FSK_Text = 0,
+  FSK_Rodata,
+  FSK_Data,
+  FSK_DataRel,   // .data.rel.ro(.local); not to be confused with .data.rel
+  FSK_InitArray,
+  FSK_FiniArray,
+  FSK_TData,
+  FSK_XRay,      // xray_instr_map (-fxray-instrument), whose sleds move with .text
+  FSK_PatchableEntries, // __patchable_function_entries (-fpatchable-function-entry)
+  FSK_JumpTable, // __jump_table of the user-space static keys
+  FSK_Custom,    // The sections of -ccr-fixup-section=<name>
+  NumFixupSectionKinds,
+  FSK_None = NumFixupSectionKinds, // Fixups are not needed (i.e., .debug_*)
+  FSK_Unknown                      // Not classified yet
+};
+static_assert(unsigned(NumFixupSectionKinds) ==
+                  unsigned(ShuffleInfo::NumFixupLists),
+              "the fixup lists of ShuffleInfo are out of sync");
+
+/// Classify a section by its name (i.e., .text.unlikely is FSK_Text).
+MCFixupSectionKind getFixupSectionKind(StringRef SectionName);
+
+/// The sections of -ccr-fixup-section, joined by ',' (the part of
+/// MCAsmInfo::getRandSettingsKey() that they contribute).
+std::string getCustomFixupSectionsKey();
+
+/// The short name of the fixup list of \p Kind (i.e., "data.rel.ro").
+StringRef getFixupSectionKindName(MCFixupSectionKind Kind);
+
+/// What a fixup refers to, judged by the section of its target symbol(s);
+/// together with the list of the fixup, this tells c2c, c2d, d2c and d2d.
+enum MCFixupTargetKind : uint8_t {
+  FTK_Unknown = 0, // Not known in this object (i.e., an undefined symbol)
+  FTK_Code,
+  FTK_Data         // Including a plain constant
+};
+
+/// How a fixup refers to its target, by the variant kind of its symbol; the
+/// value of a TLS fixup (or a GOT-relative one) is never a code address itself.
+enum MCFixupRefClass : uint8_t {
+  FRC_Direct = 0,
+  FRC_PLT,         // foo@PLT (a direct call once the linker binds it locally)
+  FRC_GOT,         // foo@GOTPCREL, foo@GOT, foo@GOTOFF
+  FRC_TLS          // foo@TLSGD, foo@GOTTPOFF, foo@TPOFF, foo@TLSDESC, ...
+};
+
+/// How far the target of a .text fixup is from the fixup itself. The value of
+/// an intra-function one (a resolved PC-relative branch or load within its own
+/// function) only changes if the BBLs of the function move apart.
+enum MCFixupScope : uint8_t {
+  FSC_External = 0,  // Not defined in this object (or not known)
+  FSC_IntraObject,
+  FSC_IntraFunction
+};
+
+/// Per-fixup reordering information (trivially copyable).
+///   - NumJTEntries and JTEntrySize are jump table information for .text only,
+///     which allows for updating the jump table entries (relative values) with pic/pie-enabled.
+///     JTFunctionRelative entries are relative to the start of the function instead
+///   - IsNewSection tells the linker that there are multiple sections of the kind:
+///     it marks the first fixup of every concrete section (SectionIdx) but the first one
+///   - TargetKind lets the randomizer skip the fixups that never refer to code
+///   - ReachLog2 limits how far a PC-relative fixup reaches (see MCAsmBackend)
+///   - RefClass tells PLT-, GOT- and TLS-relative fixups of PIC code apart
+///   - GOTRelax marks a GOTPCREL reference that the linker may relax into a
+///     direct one (see MCAsmBackend::getFixupKindGOTRelax()), thus the
+///     randomizer tells a relaxed instruction by its bytes and keeps it direct
+///   - Scope tells the intra-function fixups, which the randomizer may leave alone
+///     where their functions move as a whole (see MCFixupScope)
+///   - PairDelta links the low half of a split immediate (i.e., sym@toc@l of PPC64)
+///     to its high adjusted half (sym@toc@ha) PairDelta fixups back in its list,
+///     as the carry of the low half goes to the high one; 0 if it has none
+///   - RelocIdx tells the relocation that the ELF writer has recorded for an
+///     unresolved fixup: 1 + its index in the relocation section of the section
+///     of the fixup, thus a linker finds it at once rather than by its offset.
+///     A resolved fixup refers to its own section (or it is a distance).
+///   - RelaxShortSize marks a short branch that remained unrelaxed, with the
+///     long form of a zero displacement at RelaxFixupOffset, so that the
+///     randomizer can relax it when its target moves out of range (up to the
+///     6 bytes of an x86 jcc rel32)
+///   - ShrinkLongSize marks a long branch that the assembler relaxed, with the
+///     short form of a zero rel8 displacement at its end, so that the
+///     randomizer can shrink it back when its target comes within reach
+/// The encoded fields are those of ShuffleInfo::FixupRecord (shared by the
+/// assemblers of every tree, see shuffleInfoWriter.h), in which TargetKind,
+/// RefClass and Scope are bytes of MCFixupTargetKind, MCFixupRefClass and
+/// MCFixupScope; SectionIdx is an index into MCSectionNameTable, and DerefSize
+/// is log2 of the size. An object holds a record for every fixup of its code
+/// and data until its .rand section is written, thus the fields that always
+/// fit in a byte are bytes (72 bytes a record rather than 96).
+struct MCFixupRecord : ShuffleInfo::FixupRecord {
+  MCMBBKey ParentID;
+  MCJTKey JumpTableRef;
+};
+
+/// The identity of a function that holds across builds: the function number
+/// (MFID) is its order in the module, which any other change upsets, whereas
+/// its symbol name persists and survives the link (unlike a symbol-table
+/// index). The content hash (-ccr-function-hashes) covers its instructions, so
+/// that a profile or a layout recorded for an older build is known to be stale.
+struct MCFunctionIdentity {
+  uint64_t NameHash = 0;    // xxHash64 of the symbol name; 0 if none
+  uint64_t ContentHash = 0; // 0 if not recorded
+};
+
+/// What the reordering information of a function (or of a whole object) takes
+/// in .rand next to its code, for the remarks of AsmPrinter. The bytes of a
+/// function are estimated from the encoded sizes of its BBLs and .text fixups;
+/// the fixups of data sections and the section names only count for the object.
+struct MCRandCost {
+  uint64_t CodeBytes = 0;
+  uint64_t LayoutBytes = 0;
+  uint64_t FixupBytes = 0;
+  uint64_t StringBytes = 0;
+
+  uint64_t getRandBytes() const { return LayoutBytes + FixupBytes + StringBytes; }
+};
+
+/// Flat table of MCMBBInfo indexed by function number and then block number.
+/// MBB numbers are dense within a function, and functions are (mostly) emitted
+/// in increasing order, so a lookup is a cached slot check plus a vector index.
+class MCMBBTable {
+  std::vector<std::vector<MCMBBInfo>> Functions;
+  DenseMap<unsigned, unsigned> FunctionSlots;
+  MCMBBInfo Unowned; // Bytes emitted without any parent ID
+  unsigned NumBlocks = 0;
+  mutable unsigned LastMFID = ~0U;
+  mutable unsigned LastSlot = 0;
+
+  std::vector<MCMBBInfo> *getFunction(unsigned MFID, bool Create);
+
+public:
+  /// Return the entry for \p Key, creating it if necessary.
+  MCMBBInfo &operator[](MCMBBKey Key);
+
+  /// Return the entry for \p Key if it has been created, or null.
+  const MCMBBInfo *lookup(MCMBBKey Key) const;
+
+  bool count(MCMBBKey Key) const { return lookup(Key) != nullptr; }
+
+  /// Number of populated basic blocks.
+  unsigned size() const { return NumBlocks; }
+
+  void clear();
+};
+
+/// Koo: Essential bookkeeping information for reordering in the future
+/// (installation time), collected for an object while it is lowered and
+/// assembled (or parsed) and serialized into its .rand section by MCAssembler.
+/// The reordering information is owned by the MCContext of the object, thus
+/// the compilations that share a target (and its MCAsmInfo) may run at once.
+class MCReorderInfo {
+public:
+  // (a) MachineBasicBlocks (flat table indexed by MFID and then MBBID)
+  //    * <MFID, MBBID>: <size, offset, # of fixups within MBB, alignments, type, sectionName, fallThrough>
+  //    - The type field represents when the block is the end of MF or Object where MBB = 0, MF = 1, and Obj = 2
+  //    - The sectionName field is for C++ only; it tells current BBL belongs to which section!
+  //    - The fallThrough field keeps fallThrough-ability of the MBB
+  MCMBBTable MachineBasicBlocks;
+  //    * MachineFunctionID: size
+  std::map<unsigned, unsigned> MachineFunctionSizes;
+  //    * MachineFunctionID: granularity (MCMBBInfo::Granularity*), of the coarser MFs only
+  std::map<unsigned, unsigned> MachineFunctionGranularities;
+  //    * MachineFunctionID: identity across builds (see MCFunctionIdentity)
+  std::map<unsigned, MCFunctionIdentity> MachineFunctionIdentities;
+  //    - The order of the ID in a binary should be maintained layout because it might be non-sequential.
+  std::vector<MCMBBKey> MBBLayoutOrder;
+
+  // (b) Fixups (contiguous vectors of MCFixupRecord)
+  //    * <offset, size, isRela, parentID, JumpTableRef, isNewSection, secIdx, numJTEntries, JTEntrySz>
+  //    - The last two elements are jump table information for Fixups[FSK_Text] only,
+  //      which allows for updating the jump table entries (relative values) with pic/pie-enabled.
+  //    - One list per MCFixupSectionKind (.text, .rodata, .data, .data.rel.ro,
+  //      .init_array, .fini_array, .tdata and the optional ones of FSK_XRay on)
+  //    - The section name of each fixup (and MBB) is interned in SectionNames
+  std::vector<MCFixupRecord> Fixups[NumFixupSectionKinds];
+  MCSectionNameTable SectionNames;
+  //    - FixupsEhframe, FixupsExceptTable; (Not needed any more as a randomizer directly handles them later on)
+  //    - The call-site tables of the LSDAs (-ccr-eh-info), which the randomizer rewrites
+  //      by the new layout (see EHStreamer::emitExceptionTable())
+  std::vector<MCCallSiteTable> CallSiteTables;
+  //    - Keep track of the latest ID when parent ID is unavailable
+  MCMBBKey latestParentID;
+  //    - The instructions emitted so far, which tells the AsmPrinter whether an MI
+  //      has emitted the last instruction of its MBB (see setMBBTermKind())
+  unsigned numEmittedInsts = 0;
+  //    - MCInst and MCFixup carry 32-bit handles of their MBB and jump table,
+  //      which are resolved to the keys through these tables
+  MCKeyTable<MCMBBKey> MBBHandles;
+  MCKeyTable<MCJTKey> JTHandles;
+  //    - All JumpTables whose entries consist of the target MFs and MBBs
+  //      <MachineFunctionIdx, JumpTableIdx> - <(EntryKind, EntrySize, FunctionRelative, Entries[MBBID])>
+  std::map<MCJTKey, MCJumpTableInfo> JumpTableTargets;
+
+  // (c) Others
+  //     The following method helps full-assembly file (*.s) identify functions and basic blocks
+  //     that inherently lacks their boundaries because neither MF nor MBB has been constructed.
+  bool isAssemFile = false;
+  bool hasInlineAssembly = false;
+  //     MachineBlockPlacement marked its chains (see setMBBPlacement())
+  bool hasPlacementChains = false;
+  //     The object writer has told the relocation of every unresolved fixup
+  //     (see MCFixupRecord::RelocIdx)
+  bool hasRelocIndices = false;
+  unsigned assemFuncNo = 0xffffffff;
+  unsigned assemBBLNo = 0;
+  //     - A terminator ends the current BBL (the next bytes begin a new one);
+  //       a label begins a new BBL unless no byte has been emitted in the current one
+  bool assemBBLEnded = false;
+  bool assemBBLEmpty = true;
+  //     - The compiler has told the BBLs by .ccr_bbl directives (see beginAssemDirectiveBBL()),
+  //       thus they are taken as they are rather than split at labels and terminators
+  bool hasAssemBBLDirectives = false;
+  unsigned specialCntPriorToFunc = 0;
+  //     - The symbol of the latest .type @function, which names the next function begun
+  std::string pendingAssemFunctionName;
+  //     The cost of the metadata by function (MFID) and for the whole object, collected by
+  //     serializeReorderInfo() if remarks ask for it (see AsmPrinter::emitRandRemarks())
+  bool CollectRandCosts = false;
+  std::map<unsigned, MCRandCost> RandFunctionCosts;
+  MCRandCost RandObjectCost;
+
+  // Update emittedBytes from either DataFragment, RelaxableFragment or AlignFragment
+  void updateByteCounter(MCMBBKey id, unsigned emittedBytes, unsigned numFixups,
+                         bool isAlign) {
+    // Create the entry for the MBB if it does not exist, otherwise update it
+    MCMBBInfo &MBB = MachineBasicBlocks[id];
+    MBB.Size += emittedBytes;         // Acutal size in MBB
+    MBB.NumFixups += numFixups;       // Number of Fixups in MBB
+    if (isAlign)
+      MBB.Alignments += emittedBytes; // Count NOPs in MBB
+  }
+
+  // Record an instruction emitted into the MBB, the last one so far: of size bytes,
+  // or in a relaxable fragment whose size is final once laid out (see MCAssembler::layout())
+  void updateTerminator(MCMBBKey id, unsigned size, const MCRelaxableFragment *RF) {
+    MCMBBInfo &MBB = MachineBasicBlocks[id];
+    MBB.TermSize = size;
+    MBB.TermKind = MCMBBInfo::TermNone;
+    MBB.TermFragment = RF;
+    numEmittedInsts++;
+  }
+
+  // Record the kind of the MBB's last instruction that an MI has just emitted
+  // (see AsmPrinter::EmitFunctionBody())
+  void setMBBTermKind(MCMBBKey id, unsigned kind) {
+    MachineBasicBlocks[id].TermKind = kind;
+  }
+
+  // Record the fallThrough-ability of the MBB (see AsmPrinter::EmitFunctionBody())
+  void setMBBFallThrough(MCMBBKey id, bool canFallThrough) {
+    MachineBasicBlocks[id].FallThrough = canFallThrough;
+  }
+
+  // Record the alignment that the MBB starts with (see AsmPrinter::EmitFunctionBody())
+  void setMBBAlignment(MCMBBKey id, unsigned alignLog2, bool isLoopHeader) {
+    MCMBBInfo &MBB = MachineBasicBlocks[id];
+    MBB.AlignLog2 = alignLog2;
+    MBB.IsLoopHeader = isLoopHeader;
+  }
+
+  // Record that an MBB has been coalesced into the record of the MBB
+  // (see AsmPrinter::collectRandRuns())
+  void addMBBInternalBoundary(MCMBBKey id) {
+    MachineBasicBlocks[id].InternalBoundaries++;
+  }
+
+  // Record that the MBB holds a CFI instruction (see AsmPrinter::EmitFunctionBody())
+  void setMBBHasCFI(MCMBBKey id) {
+    MachineBasicBlocks[id].HasCFI = true;
+  }
+
+  // Record the placement chain the MBB is in (see AsmPrinter::EmitFunctionBody());
+  // the object has no placement information unless some chain has been recorded
+  void setMBBPlacement(MCMBBKey id, bool chainStart, unsigned edgeProb) {
+    MCMBBInfo &MBB = MachineBasicBlocks[id];
+    MBB.ChainStart = chainStart;
+    MBB.LayoutEdgeProb = edgeProb;
+    hasPlacementChains |= chainStart;
+  }
+
+  // Record the "ccr-granularity" of the function MFID (see AsmPrinter::EmitFunctionBody())
+  void setMFGranularity(unsigned MFID, unsigned granularity) {
+    if (granularity != MCMBBInfo::GranularityBBL)
+      MachineFunctionGranularities[MFID] = granularity;
+  }
+
+  // Record the symbol name of the function MFID (see AsmPrinter::EmitFunctionBody())
+  void setMFName(unsigned MFID, StringRef name);
+
+  // Record the hash of the instructions of the function MFID (-ccr-function-hashes)
+  void setMFContentHash(unsigned MFID, uint64_t contentHash) {
+    MachineFunctionIdentities[MFID].ContentHash = contentHash;
+  }
+
+  // Record the call-site table of the LSDA of the function MFID (see EHStreamer)
+  void addCallSiteTable(unsigned MFID, const MCSymbol *records, unsigned numRecords) {
+    MCCallSiteTable Table;
+    Table.MFID = MFID;
+    Table.Records = records;
+    Table.NumRecords = numRecords;
+    CallSiteTables.push_back(Table);
+  }
+
+  // Record the entries of a jump table as emitted (see MachineFunction::RecordMachineJumpTableInfo())
+  void updateJumpTableTargets(MCJTKey key, unsigned entryKind, unsigned entrySize,
+                              bool functionRelative, std::vector<unsigned> entries) {
+    MCJumpTableInfo &JT = JumpTableTargets[key];
+    JT.EntryKind = entryKind;
+    JT.EntrySize = entrySize;
+    JT.FunctionRelative = functionRelative;
+    JT.Entries = std::move(entries);
+  }
+
+  const MCJumpTableInfo *lookupJumpTable(MCJTKey key) const {
+    auto It = JumpTableTargets.find(key);
+    return It == JumpTableTargets.end() ? nullptr : &It->second;
+  }
+
+  // Record the hotness class of the MBB (see AsmPrinter::collectMBBHotness())
+  void setMBBHotness(MCMBBKey id, unsigned hotness) {
+    MachineBasicBlocks[id].Hotness = hotness;
+  }
+
+  // Assembly file only: a function (.type @function) begins with an empty BBL;
+  // with .ccr_bbl directives, its symbol names the function of the next one
+  void beginAssemFunction(StringRef name) {
+    pendingAssemFunctionName = name;
+    if (hasAssemBBLDirectives)
+      return;
+    assemFuncNo++;
+    setMFName(assemFuncNo, name);
+    assemBBLNo = 0;
+    assemBBLEnded = false;
+    assemBBLEmpty = true;
+  }
+
+  // Assembly file only: a label is a potential branch target
+  void beginAssemBBL() {
+    if (hasAssemBBLDirectives)
+      return;
+    if (!assemBBLEmpty) {
+      assemBBLNo++;
+      assemBBLEmpty = true;
+    }
+    assemBBLEnded = false;
+  }
+
+  // Assembly file only: the BBL that the bytes about to be emitted belong to
+  MCMBBKey getAssemBBL() {
+    if (assemFuncNo == 0xffffffff)
+      assemFuncNo = 0;
+    if (assemBBLEnded) {
+      assemBBLNo++;
+      assemBBLEnded = false;
+    }
+    assemBBLEmpty = false;
+    return MCMBBKey(assemFuncNo, assemBBLNo);
+  }
+
+  // Assembly file only: the last instruction of a BBL decides its fallThrough-ability
+  // (see AsmParser::parseStatement())
+  void endAssemInstruction(bool isTerminator, bool canFallThrough) {
+    if (hasAssemBBLDirectives)
+      return;
+    setMBBFallThrough(MCMBBKey(assemFuncNo, assemBBLNo), canFallThrough);
+    assemBBLEnded = isTerminator;
+  }
+
+  // Assembly file only: the bytes from here on belong to the block of a .ccr_bbl
+  // directive, with the information the compiler has recorded for it
+  // (see ELFAsmParser::ParseDirectiveCCRBBL())
+  void beginAssemDirectiveBBL(MCMBBKey id, unsigned flags, unsigned alignLog2,
+                              unsigned edgeProb);
+};
+
+} // end namespace llvm
+
+#endif // LLVM_MC_MCREORDERINFO_H
@@ -14,6 +14,7 @@
 #define LLVM_MC_MCSECTIONELF_H
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/MC/MCReorderInfo.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCSymbolELF.h"
 #include "llvm/MC/SectionKind.h"
@@ -47,6 +48,10 @@ class MCSectionELF final : public MCSection {
   /// sh_info for SHF_LINK_ORDER (can be null).
   const MCSymbol *AssociatedSymbol;
 
+  /// Koo: The CCR fixup list that this section contributes to, which is
+  /// resolved from the section name on first use.
+  mutable MCFixupSectionKind FixupKind = FSK_Unknown;
+
 private:
   friend class MCContext;
 
@@ -60,7 +65,10 @@ private:
       Group->setIsSignature();
   }
 
-  void setSectionName(StringRef Name) { SectionName = Name; }
+  void setSectionName(StringRef Name) {
+    SectionName = Name;
+    FixupKind = FSK_Unknown;
+  }
 
 public:
   /// Decides whether a '.section' directive should be printed before the
@@ -83,6 +91,12 @@ public:
   bool isUnique() const { return UniqueID != ~0U; }
   unsigned getUniqueID() const { return UniqueID; }
 
+  MCFixupSectionKind getFixupSectionKind() const {
+    if (FixupKind == FSK_Unknown)
+      FixupKind = llvm::getFixupSectionKind(SectionName);
+    return FixupKind;
+  }
+
   const MCSection *getAssociatedSection() const { return &AssociatedSymbol->getSection(); }
   const MCSymbol *getAssociatedSymbol() const { return AssociatedSymbol; }
 
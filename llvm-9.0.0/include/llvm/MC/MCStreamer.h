@@ -438,7 +438,11 @@ public:
 
   // Koo
   virtual void EmitRand() {}
-  virtual void setObjTmpName(std::string tmpFileName) {}
+  /// The .ccr_bbl directive: the bytes that follow belong to the basic block
+  /// MBBID of the function MFID (see MCRandBBLFlags). An object streamer has
+  /// the information recorded already, thus only the text is annotated.
+  virtual void EmitCCRBasicBlock(unsigned MFID, unsigned MBBID, unsigned Flags,
+                                 unsigned AlignLog2, unsigned EdgeProb) {}
   
   virtual void EmitEHSymAttributes(const MCSymbol *Symbol, MCSymbol *EHSymbol);
 
@@ -54,6 +54,17 @@ public:
   /// Preserve Comments in Assembly.
   bool PreserveAsmComments : 1;
 
+  /// Koo: Collect and emit the CCR reordering information (-fccr-metadata).
+  bool CCRMetadata : 1;
+
+  /// Koo: The CCR settings that the IR records ("ccr-*" module flags, see
+  /// TargetMachine::applyCCRModuleFlags()) over the -ccr-* options, 0 if
+  /// unset: the granularity (1 = function, 2 = auto, 3 = bbl), the format of
+  /// .rand, and the relocated fixups omitted (1) or kept (2).
+  unsigned CCRGranularity = 0;
+  unsigned CCRRandFormat = 0;
+  unsigned CCRRelocatedFixups = 0;
+
   int DwarfVersion = 0;
 
   std::string ABIName;
@@ -0,0 +1,168 @@
+//===- RandChunk.h - Relocatable CCR .rand chunks ---------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Reading and merging the .rand sections of format 3 (see
+// llvm/BinaryFormat/RandChunk.h). A linker merges its inputs with
+// mergeRandSections(): the chunks are copied verbatim and only their headers
+// are patched, thus no payload is ever decoded (or re-encoded) at link time.
+// A payload that has been stored already is left out (see PayloadRef). An
+// incremental link appends to the merged section with updateRandSection().
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_OBJECT_RANDCHUNK_H
+#define LLVM_OBJECT_RANDCHUNK_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/BinaryFormat/RandChunk.h"
+#include "llvm/Support/Error.h"
+#include <chrono>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+
+namespace object {
+
+/// A view of a single (validated) chunk in a .rand section.
+class RandChunkRef {
+  ArrayRef<uint8_t> Data;
+  ArrayRef<uint8_t> SharedPayload; // Of the chunk at PayloadRef, if any
+
+public:
+  explicit RandChunkRef(ArrayRef<uint8_t> Data,
+                        ArrayRef<uint8_t> SharedPayload = None)
+      : Data(Data), SharedPayload(SharedPayload) {}
+
+  const ccr::ChunkHeader &getHeader() const {
+    return *reinterpret_cast<const ccr::ChunkHeader *>(Data.data());
+  }
+
+  ArrayRef<ccr::ChunkSection> getSections() const {
+    return {reinterpret_cast<const ccr::ChunkSection *>(
+                Data.data() + sizeof(ccr::ChunkHeader)),
+            getHeader().NumSections};
+  }
+
+  StringRef getNames() const {
+    const uint8_t *Names = Data.data() + sizeof(ccr::ChunkHeader) +
+                           getHeader().NumSections * sizeof(ccr::ChunkSection);
+    return {reinterpret_cast<const char *>(Names), getHeader().NamesSize};
+  }
+
+  /// Return the name of \p Section, which belongs to this chunk.
+  StringRef getSectionName(const ccr::ChunkSection &Section) const {
+    return getNames().drop_front(Section.NameOffset).split('\0').first;
+  }
+
+  /// Return true if the payload is that of an earlier chunk (PayloadRef).
+  bool hasSharedPayload() const {
+    return getHeader().PayloadRef != ccr::ChunkHeader::NoPayloadRef;
+  }
+
+  /// The encoded ReorderInfo message.
+  ArrayRef<uint8_t> getPayload() const {
+    if (hasSharedPayload())
+      return SharedPayload;
+    return getOwnPayload();
+  }
+
+  /// The payload stored in this chunk, which is empty if it is shared.
+  ArrayRef<uint8_t> getOwnPayload() const {
+    return Data.slice(sizeof(ccr::ChunkHeader) +
+                          getHeader().NumSections * sizeof(ccr::ChunkSection) +
+                          getHeader().NamesSize,
+                      getHeader().PayloadSize);
+  }
+
+  /// The whole chunk, including its padding.
+  ArrayRef<uint8_t> getData() const { return Data; }
+};
+
+/// Return true if \p Contents (an uncompressed .rand section) is a sequence of
+/// chunks rather than a single encoded ReorderInfo message.
+bool isRandChunked(ArrayRef<uint8_t> Contents);
+
+/// Split \p Contents into its chunks without decoding any payload. A shared
+/// payload has to be that of an earlier chunk of \p Contents.
+Expected<std::vector<RandChunkRef>> readRandChunks(ArrayRef<uint8_t> Contents);
+
+/// Called for every chunk of the merged section to fill in its header: the
+/// chunk comes from Inputs[InputIdx], and \p Names are its section names.
+/// The chunks of different inputs are patched concurrently (those of a single
+/// input in order), thus the patcher may only read shared linker state.
+/// A section that is not in the output, i.e., one folded by --icf, gets
+/// ccr::ChunkSection::DiscardedBase; its metadata is then ignored.
+using RandChunkPatcher =
+    function_ref<Error(unsigned InputIdx, ccr::ChunkHeader &Header,
+                       MutableArrayRef<ccr::ChunkSection> Sections,
+                       StringRef Names)>;
+
+/// The CCR overhead of one input of mergeRandSections().
+struct RandMergeStats {
+  uint64_t RandSize = 0; // Bytes of the (uncompressed) .rand section
+  uint64_t NumChunks = 0;
+  uint64_t SharedBytes = 0; // Of the payloads stored by an earlier chunk
+  uint64_t NumLayouts = 0; // Layout (BBL) records
+  uint64_t NumFixups = 0;
+  std::chrono::nanoseconds MergeTime{0}; // Copying and patching the input
+};
+
+/// Return the size of the merged .rand section of \p Inputs, of which every
+/// payload is stored once. A malformed input counts as it is.
+uint64_t getMergedRandSize(ArrayRef<ArrayRef<uint8_t>> Inputs);
+
+/// Return the offset of the chunks of every input in the merged .rand section
+/// of \p Inputs, followed by its size. A linker records them for the next
+/// incremental link (see updateRandSection()).
+std::vector<uint64_t> getMergedRandOffsets(ArrayRef<ArrayRef<uint8_t>> Inputs);
+
+/// Concatenate the (uncompressed) .rand sections \p Inputs in order into
+/// \p Out, whose size has to be getMergedRandSize(Inputs) (i.e., the output
+/// section in the mapped output file), patching the header of every chunk
+/// with \p Patch. A chunk whose payload (of the same ShapeHash) has been
+/// stored by an earlier chunk is copied without it and refers to that chunk.
+/// Inputs are copied and patched in parallel; if several fail, the error of
+/// the first one is returned. If \p Stats is given (one entry per input), it
+/// is filled with the overhead of every input.
+Error mergeRandSections(ArrayRef<ArrayRef<uint8_t>> Inputs,
+                        RandChunkPatcher Patch, MutableArrayRef<uint8_t> Out,
+                        MutableArrayRef<RandMergeStats> Stats = None);
+
+/// As above, resizing \p Out to fit the merged section.
+Error mergeRandSections(ArrayRef<ArrayRef<uint8_t>> Inputs,
+                        RandChunkPatcher Patch, std::vector<uint8_t> &Out,
+                        MutableArrayRef<RandMergeStats> Stats = None);
+
+/// Update the merged .rand section of an incremental link (e.g., gold
+/// --incremental) rather than merging all its inputs again. The chunks in the
+/// byte ranges \p Removed, i.e., those of the replaced inputs, are left in
+/// place with their sections discarded, thus no other chunk moves and no
+/// header outside of them is patched again; they take space until the next
+/// full link. The chunks of \p Added are appended to \p Merged as
+/// mergeRandSections() does, sharing the payloads stored in it already.
+/// Return the offset of every added input in the updated section, followed by
+/// its size.
+Expected<std::vector<uint64_t>>
+updateRandSection(std::vector<uint8_t> &Merged,
+                  ArrayRef<std::pair<uint64_t, uint64_t>> Removed,
+                  ArrayRef<ArrayRef<uint8_t>> Added, RandChunkPatcher Patch,
+                  MutableArrayRef<RandMergeStats> Stats = None);
+
+/// Write the overhead report of a merge as JSON, one object per input named
+/// after \p InputNames, which parallels \p Stats. A linker emits it on request
+/// (e.g., --ccr-report=<file>) to find the objects that contribute the most.
+void writeRandMergeReport(raw_ostream &OS, ArrayRef<StringRef> InputNames,
+                          ArrayRef<RandMergeStats> Stats);
+
+} // end namespace object
+} // end namespace llvm
+
+#endif // LLVM_OBJECT_RANDCHUNK_H
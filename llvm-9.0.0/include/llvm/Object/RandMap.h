@@ -0,0 +1,141 @@
+//===- RandMap.h - CCR address translation maps -----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Writing and reading the address translation map of a randomized binary
+// (see llvm/BinaryFormat/RandMap.h). The randomizer writes it with
+// writeRandAddressMap(); a symbolizer translates the sampled (new) addresses
+// into the original ones with RandAddressMap::getOriginalAddress(), and a
+// profile canonicalizer its fall-through ranges with getOriginalRanges().
+// The BBL address map is written with writeRandBBAddrMap() and read back with
+// readRandBBAddrMap(), and the synthetic sites with writeRandSyntheticSites()
+// and readRandSyntheticSites().
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_OBJECT_RANDMAP_H
+#define LLVM_OBJECT_RANDMAP_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/BinaryFormat/RandMap.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+
+namespace object {
+
+struct RandAddressRange {
+  uint64_t OldAddr;
+  uint64_t NewAddr;
+  uint64_t Size;
+};
+
+/// Sort \p Ranges by their old addresses and merge the adjacent ones that
+/// moved alike, dropping the empty ones.
+std::vector<RandAddressRange>
+mergeRandAddressRanges(std::vector<RandAddressRange> Ranges);
+
+/// Write the map of the randomized \p Text at \p TextAddr. \p Ranges may be
+/// in any order; the adjacent ranges that moved alike are merged.
+void writeRandAddressMap(raw_ostream &OS, uint64_t TextAddr,
+                         ArrayRef<uint8_t> Text,
+                         std::vector<RandAddressRange> Ranges);
+
+/// Write the map of a layout planned from its seed alone, whose \p TextSize
+/// bytes of .text have never been written (thus the map has no hash).
+void writeRandAddressMap(raw_ostream &OS, uint64_t TextAddr, uint64_t TextSize,
+                         std::vector<RandAddressRange> Ranges);
+
+class RandAddressMap {
+  uint64_t TextAddr = 0, TextSize = 0, TextHash = 0;
+  std::vector<RandAddressRange> ByOld;
+  std::vector<RandAddressRange> ByNew;
+
+public:
+  /// Parse (and validate) the contents of a map file.
+  static Expected<RandAddressMap> create(ArrayRef<uint8_t> Data);
+
+  /// Return true if the map belongs to the (randomized) \p Text at \p Addr;
+  /// a map without a hash (of a planned layout) by the address and size only.
+  bool matches(uint64_t Addr, ArrayRef<uint8_t> Text) const;
+
+  /// Translate an address of the randomized binary into the original layout.
+  /// The padding and the jumps the randomizer inserted after a range belong
+  /// to its last byte. Addresses outside the randomized code yield None.
+  Optional<uint64_t> getOriginalAddress(uint64_t NewAddr) const;
+
+  /// Translate an address of the original layout into the randomized one.
+  Optional<uint64_t> getNewAddress(uint64_t OldAddr) const;
+
+  /// Translate the randomized code [NewBegin, NewEnd] (both included, as a
+  /// fall-through range of a profile) into the original pieces it came from,
+  /// in the order of the randomized layout; the padding and the jumps the
+  /// randomizer inserted are left out. Returns false, with no pieces, if
+  /// either end is outside the randomized code.
+  bool getOriginalRanges(
+      uint64_t NewBegin, uint64_t NewEnd,
+      SmallVectorImpl<std::pair<uint64_t, uint64_t>> &Pieces) const;
+
+  ArrayRef<RandAddressRange> ranges() const { return ByOld; }
+};
+
+struct RandBBLAddress {
+  uint64_t ID;   // Index of the BBL in .rand
+  uint64_t Addr;
+  uint64_t Size;
+};
+
+/// A run of consecutive BBLs of a function (see the BBL address map).
+struct RandBBAddrEntry {
+  uint64_t FunctionID; // Index of the function in .rand
+  std::vector<RandBBLAddress> BBLs;
+};
+
+/// Write the BBL address map of \p Entries, which are in ascending addresses
+/// past \p TextAddr and do not overlap.
+void writeRandBBAddrMap(raw_ostream &OS, uint64_t TextAddr,
+                        ArrayRef<RandBBAddrEntry> Entries);
+
+/// Parse (and validate) the contents of a BBL address map section.
+Expected<std::vector<RandBBAddrEntry>>
+readRandBBAddrMap(ArrayRef<uint8_t> Data);
+
+/// Code that the randomizer put into the new layout (see the synthetic sites).
+struct RandSyntheticSite {
+  uint64_t Addr;
+  uint64_t Size;
+  ccr::SyntheticSiteKind Kind;
+  uint64_t BBL;      // ID of the BBL in .rand that it stands for
+  uint64_t OrigAddr; // What its code stands for in the original layout
+};
+
+/// Name of a site kind, as the symbolizer and llvm-readobj tell it.
+StringRef getRandSyntheticSiteKindName(ccr::SyntheticSiteKind Kind);
+
+/// Write the synthetic sites \p Sites, which are in ascending addresses past
+/// \p TextAddr and do not overlap.
+void writeRandSyntheticSites(raw_ostream &OS, uint64_t TextAddr,
+                             ArrayRef<RandSyntheticSite> Sites);
+
+/// Parse (and validate) the contents of a synthetic sites section.
+Expected<std::vector<RandSyntheticSite>>
+readRandSyntheticSites(ArrayRef<uint8_t> Data);
+
+/// The site of \p Sites (as read) that holds \p Addr, if any.
+const RandSyntheticSite *findRandSyntheticSite(ArrayRef<RandSyntheticSite> Sites,
+                                               uint64_t Addr);
+
+} // end namespace object
+} // end namespace llvm
+
+#endif // LLVM_OBJECT_RANDMAP_H
@@ -41,6 +41,20 @@ Error uncompress(StringRef InputBuffer,
 
 uint32_t crc32(StringRef Buffer);
 
+/// Deflate \p InputBuffer (smaller than 4 GiB) onto \p CompressedBuffer as a
+/// piece of a raw deflate stream: it ends on a byte boundary and refers to
+/// no piece before it, thus the pieces of a buffer can be compressed
+/// concurrently and concatenated, between a zlib header and the adler32 of
+/// the whole buffer. Only the \p Last piece ends the stream.
+Error compressPiece(StringRef InputBuffer,
+                    SmallVectorImpl<char> &CompressedBuffer, bool Last,
+                    int Level = DefaultCompression);
+
+uint32_t adler32(StringRef Buffer);
+
+/// The adler32 of two buffers in a row, from theirs and the size of the second.
+uint32_t adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Size2);
+
 }  // End of namespace zlib
 
 } // End of namespace llvm
@@ -18,8 +18,13 @@ extern TimeTraceProfiler *TimeTraceProfilerInstance;
 
 /// Initialize the time trace profiler.
 /// This sets up the global \p TimeTraceProfilerInstance
-/// variable to be the profiler instance.
-void timeTraceProfilerInitialize();
+/// variable to be the profiler instance. The trace tells the process by
+/// \p ProcName.
+///
+/// Koo: The sections of every thread go to a lane of their own (the thread
+///      that initialized the profiler has the first one), thus the sections
+///      may be begun and ended on the workers of a thread pool too.
+void timeTraceProfilerInitialize(StringRef ProcName = "clang");
 
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
@@ -0,0 +1,44 @@
+//===- llvm/Support/X86Nops.h - Long NOPs of x86 code -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The long NOPs that X86AsmBackend::writeNopData pads x86 code with. The
+// CCR randomizer re-materializes the alignment of the BBLs at their new places
+// (and recognizes the padding recorded in .rand) with the very same ones.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_X86NOPS_H
+#define LLVM_SUPPORT_X86NOPS_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include <cstdint>
+
+namespace llvm {
+namespace X86 {
+
+/// The longest NOP that decodes efficiently on most CPUs
+const unsigned DefaultMaxNopLength = 10;
+
+/// The NOP of \p Length bytes (1 to 15; the ones beyond 10 bytes repeat the
+/// 0x66 prefix).
+ArrayRef<uint8_t> getNop(unsigned Length);
+
+/// Fill [\p P, \p P + \p Count) with as many \p MaxNopLength byte NOPs as fit,
+/// then one of the remaining length. A \p MaxNopLength of 1 (for the CPUs
+/// without long NOPs) writes single-byte ones.
+void writeNops(uint8_t *P, uint64_t Count,
+               unsigned MaxNopLength = DefaultMaxNopLength);
+
+/// Length of the NOP at the start of \p Bytes (any form getNop() returns, with
+/// any 0x66 and 0x2e prefixes), or 0 if the bytes start with anything else.
+unsigned getNopLength(ArrayRef<uint8_t> Bytes);
+
+} // end namespace X86
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_X86NOPS_H
@@ -0,0 +1,34 @@
+// Koo: Readers of a serialized ReorderInfo (the .rand section) for the
+// consumers of shuffleInfo.so (the randomizer, the dumper, the benchmarks).
+// ParseFromString() copies its input and allocates every submessage on the
+// heap; these parse the (mapped) section bytes in place instead, with the
+// messages on an Arena that is released at once.
+//
+// The section names are read without a copy by ReadSectionNames(): the
+// protobuf 3.1 runtime ignores [ctype = STRING_PIECE], thus the views are
+// taken from the wire format directly.
+
+#ifndef SHUFFLEINFO_READER_H
+#define SHUFFLEINFO_READER_H
+
+#include "shuffleInfo.pb.h"
+#include <google/protobuf/arena.h>
+#include <google/protobuf/stubs/stringpiece.h>
+#include <cstddef>
+#include <vector>
+
+namespace ShuffleInfo {
+
+// Parse the ReorderInfo at [Data, Data + Size) onto Arena, which owns the
+// result; returns NULL if the message is malformed. Data is not retained.
+ReorderInfo *ParseReorderInfo(const void *Data, size_t Size,
+                              ::google::protobuf::Arena *Arena);
+
+// Views of ReorderInfo.section_names into [Data, Data + Size), in order;
+// the other fields are skipped. Returns false if the message is malformed.
+bool ReadSectionNames(const void *Data, size_t Size,
+                      std::vector< ::google::protobuf::StringPiece> *Names);
+
+} // namespace ShuffleInfo
+
+#endif // SHUFFLEINFO_READER_H
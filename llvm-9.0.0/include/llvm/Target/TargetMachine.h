@@ -33,6 +33,8 @@ class MCInstrInfo;
 class MCRegisterInfo;
 class MCSubtargetInfo;
 class MCSymbol;
+class MCTargetOptions;
+class Module;
 class raw_pwrite_stream;
 class PassManagerBuilder;
 struct PerFunctionMIParsingState;
@@ -185,6 +187,16 @@ public:
   // from TargetMachine.
   void resetTargetOptions(const Function &F) const;
 
+  /// Koo: Record the CCR settings of \p Options (see
+  /// MCAsmInfo::getRandOptions()) in the module flags of \p M, which a merged
+  /// module takes the largest of: the finest granularity, the latest format
+  /// and the relocated fixups kept if any module keeps them.
+  static void addCCRModuleFlags(Module &M, const MCTargetOptions &Options);
+
+  /// Koo: Take the CCR settings that the module flags of \p M record into
+  /// \p Options, for the LTO backends to emit .rand as the compiler would.
+  static void applyCCRModuleFlags(const Module &M, TargetOptions &Options);
+
   /// Return target specific asm information.
   const MCAsmInfo *getMCAsmInfo() const { return AsmInfo.get(); }
 
@@ -31,6 +31,7 @@
 #include "llvm/Analysis/ConstantFolding.h"
 #include "llvm/Analysis/EHPersonalities.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/BinaryFormat/ELF.h"
@@ -38,6 +39,8 @@
 #include "llvm/CodeGen/GCMetadataPrinter.h"
 #include "llvm/CodeGen/GCStrategy.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
+#include "llvm/CodeGen/MachineBranchProbabilityInfo.h"
 #include "llvm/CodeGen/MachineConstantPool.h"
 #include "llvm/CodeGen/MachineDominators.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
@@ -87,6 +90,7 @@
 #include "llvm/MC/MCDwarf.h"
 #include "llvm/MC/MCExpr.h"
 #include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrInfo.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCSectionCOFF.h"
 #include "llvm/MC/MCSectionELF.h"
@@ -109,8 +113,10 @@
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
@@ -121,6 +127,7 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
@@ -142,6 +149,23 @@ static const char *const CodeViewLineTablesGroupDescription =
   "CodeView Line Tables";
 
 STATISTIC(EmittedInsts, "Number of machine instrs printed");
+STATISTIC(RandMBBs, "Number of MBBs whose layout is recorded for CCR"); // Koo
+STATISTIC(RandCoalescedMBBs,
+          "Number of MBBs recorded along with the MBBs before them"); // Koo
+STATISTIC(RandAutoCoarseFunctions,
+          "Number of functions recorded as a whole by -ccr-granularity=auto"); // Koo
+
+// Koo
+static const char *const RandTimerName = "emit_rand";
+static const char *const RandTimerDescription = "CCR .rand Section Emission";
+static const char *const RandGroupName = "ccr";
+static const char *const RandGroupDescription = "CCR Metadata";
+
+static cl::opt<unsigned> CCRRandRemarksTop(
+    "ccr-rand-remarks-top", cl::Hidden,
+    cl::desc("Number of the functions with the most CCR metadata (.rand) to "
+             "remark on (-pass-remarks-analysis=asm-printer)"),
+    cl::init(10));
 
 static cl::opt<bool> EnableRemarksSection(
     "remarks-section",
@@ -252,9 +276,32 @@ void AsmPrinter::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequired<GCModuleInfo>();
 }
 
+// Koo: -ccr-compile-seed permutes the functions of the module before any of
+//      them is generated, thus the object comes out randomized, and so does its
+//      .rand section. The functions pinned by ccr_granularity("none") keep
+//      their places.
+static void shuffleFunctions(Module &M, uint64_t Seed) {
+  SmallVector<Function *, 64> Order;
+  SmallVector<unsigned, 64> Movable; // Into Order
+  for (Function &F : M) {
+    if (!F.isDeclaration() &&
+        F.getFnAttribute("ccr-granularity").getValueAsString() != "none")
+      Movable.push_back(Order.size());
+    Order.push_back(&F);
+  }
+  std::mt19937_64 Rng(Seed ^ xxHash64(M.getModuleIdentifier()));
+  for (unsigned N = Movable.size(); N > 1; --N)
+    std::swap(Order[Movable[N - 1]], Order[Movable[Rng() % N]]);
+  for (Function *F : Order)
+    M.getFunctionList().splice(M.end(), M.getFunctionList(), F->getIterator());
+}
+
 bool AsmPrinter::doInitialization(Module &M) {
   MMI = getAnalysisIfAvailable<MachineModuleInfo>();
 
+  if (MAI->RandCompileSeed)
+    shuffleFunctions(M, MAI->RandCompileSeed);
+
   // Initialize TargetLoweringObjectFile.
   const_cast<TargetLoweringObjectFile&>(getObjFileLowering())
     .Initialize(OutContext, TM);
@@ -304,7 +351,8 @@ bool AsmPrinter::doInitialization(Module &M) {
 	
 	// Koo: Set MFID_MBBID as 9999_0 in case of module-level inline asm (special case)
     EmitInlineAsm(M.getModuleInlineAsm()+"\n",
-                  OutContext.getSubtargetCopy(*STI), TM.Options.MCOptions, "9999_0");
+                  OutContext.getSubtargetCopy(*STI), TM.Options.MCOptions,
+                  MCMBBKey::getModuleInlineAsm());
     OutStreamer->AddComment("End of file scope inline assembly");
     OutStreamer->AddBlankLine();
   }
@@ -704,6 +752,11 @@ void AsmPrinter::EmitFunctionHeader() {
   // do their wild and crazy things as required.
   EmitFunctionEntryLabel();
 
+  // Koo - The base of the function-relative jump table entries
+  if (MF->getJumpTableInfo() &&
+      MF->getSubtarget().getTargetLowering()->isJumpTableFunctionRelative())
+    OutStreamer->EmitLabel(MF->getJTBaseSymbol());
+
   // If the function had address-taken blocks that got deleted, then we have
   // references to the dangling symbols.  Emit them at the start of the function
   // so that we don't get references to undefined symbols.
@@ -957,6 +1010,15 @@ void AsmPrinter::emitCFIInstruction(const MachineInstr &MI) {
       MBB->getReverseIterator() == MBB->getParent()->rbegin())
     return;
 
+  // Koo: The CFI of a BBL ties it to its place (-ccr-eh-info); one that ends
+  //      the MBB takes effect at the start of the next one
+  if (MAI->RandMetadata) {
+    MCReorderInfo &RI = getReorderInfo();
+    RI.setMBBHasCFI(getRandMBBKey(*MBB));
+    if (I == MBB->instr_end())
+      RI.setMBBHasCFI(getRandMBBKey(*std::next(MBB->getIterator())));
+  }
+
   const std::vector<MCCFIInstruction> &Instrs = MF->getFrameInstructions();
   unsigned CFIIndex = MI.getOperand(0).getCFIIndex();
   const MCCFIInstruction &CFI = Instrs[CFIIndex];
@@ -1011,6 +1073,333 @@ static bool needFuncLabelsForEHOrDebugInfo(const MachineFunction &MF,
       classifyEHPersonality(MF.getFunction().getPersonalityFn()));
 }
 
+MCMBBKey AsmPrinter::getRandMBBKey(const MachineBasicBlock &MBB) const {
+  const MachineFunction &Fn = *MBB.getParent();
+  if (CoarseRandLayout)
+    return MCMBBKey(Fn.getFunctionNumber(), Fn.front().getNumber());
+  auto Head = RandRunHeads.find(MBB.getNumber());
+  return MCMBBKey(Fn.getFunctionNumber(), Head != RandRunHeads.end()
+                                              ? Head->second
+                                              : MBB.getNumber());
+}
+
+MCReorderInfo &AsmPrinter::getReorderInfo() const {
+  return OutContext.getReorderInfo();
+}
+
+// Koo: The probability of the edge from MBB into the next MBB of the layout
+//      in 15ths (rounded), or 0 if the next MBB is not a successor of MBB
+static unsigned getLayoutEdgeProb(const MachineBranchProbabilityInfo &MBPI,
+                                  const MachineBasicBlock &MBB) {
+  auto Next = std::next(MBB.getIterator());
+  if (Next == MBB.getParent()->end() || !MBB.isSuccessor(&*Next))
+    return 0;
+  BranchProbability Prob = MBPI.getEdgeProbability(&MBB, &*Next);
+  if (Prob.isUnknown())
+    return 0;
+  return (uint64_t(Prob.getNumerator()) * 15 + Prob.getDenominator() / 2) /
+         Prob.getDenominator();
+}
+
+// Koo: Condense an instruction into words for the content hash of its function
+//      (-ccr-function-hashes): the opcode and the operands, where an MBB goes by
+//      its number and a global or a symbol by its name, thus the hash holds
+//      wherever the function lands and whatever else the module holds. The
+//      labels and the debug and CFI instructions are not code.
+static void appendRandInstructionWords(const MachineInstr &MI,
+                                       SmallVectorImpl<uint64_t> &Words) {
+  if (MI.isDebugInstr() || MI.isCFIInstruction() || MI.isLabel() ||
+      MI.isImplicitDef() || MI.isKill())
+    return;
+  Words.push_back(uint64_t(MI.getOpcode()) << 32 | MI.getNumOperands());
+  for (const MachineOperand &MO : MI.operands()) {
+    uint64_t Kind = uint64_t(MO.getType()) << 56 |
+                    uint64_t(MO.getTargetFlags()) << 24;
+    switch (MO.getType()) {
+    case MachineOperand::MO_Register:
+      Words.push_back(Kind | MO.getSubReg() << 1 | MO.isDef());
+      Words.push_back(MO.getReg());
+      break;
+    case MachineOperand::MO_Immediate:
+      Words.push_back(Kind);
+      Words.push_back(MO.getImm());
+      break;
+    case MachineOperand::MO_CImmediate:
+      Words.push_back(Kind | MO.getCImm()->getBitWidth());
+      Words.push_back(MO.getCImm()->getValue().getLimitedValue());
+      break;
+    case MachineOperand::MO_FPImmediate:
+      Words.push_back(Kind);
+      Words.push_back(MO.getFPImm()->getValueAPF().bitcastToAPInt()
+                          .getLimitedValue());
+      break;
+    case MachineOperand::MO_MachineBasicBlock:
+      Words.push_back(Kind | MO.getMBB()->getNumber());
+      break;
+    case MachineOperand::MO_FrameIndex:
+      Words.push_back(Kind | uint32_t(MO.getIndex()));
+      break;
+    case MachineOperand::MO_ConstantPoolIndex:
+    case MachineOperand::MO_TargetIndex:
+    case MachineOperand::MO_JumpTableIndex:
+      Words.push_back(Kind | uint32_t(MO.getIndex()));
+      Words.push_back(MO.getOffset());
+      break;
+    case MachineOperand::MO_ExternalSymbol:
+      Words.push_back(Kind);
+      Words.push_back(xxHash64(MO.getSymbolName()));
+      Words.push_back(MO.getOffset());
+      break;
+    case MachineOperand::MO_GlobalAddress:
+      Words.push_back(Kind);
+      Words.push_back(xxHash64(MO.getGlobal()->getName()));
+      Words.push_back(MO.getOffset());
+      break;
+    case MachineOperand::MO_BlockAddress:
+      Words.push_back(Kind);
+      Words.push_back(xxHash64(MO.getBlockAddress()->getFunction()->getName()));
+      Words.push_back(MO.getOffset());
+      break;
+    case MachineOperand::MO_MCSymbol:
+      // A temporary label is numbered in the order of the whole module
+      Words.push_back(Kind);
+      if (!MO.getMCSymbol()->isTemporary())
+        Words.push_back(xxHash64(MO.getMCSymbol()->getName()));
+      break;
+    case MachineOperand::MO_IntrinsicID:
+      Words.push_back(Kind | MO.getIntrinsicID());
+      break;
+    case MachineOperand::MO_Predicate:
+      Words.push_back(Kind | MO.getPredicate());
+      break;
+    default: // Register masks and live-outs, metadata, CFI
+      Words.push_back(Kind);
+      break;
+    }
+  }
+}
+
+// Koo: The kind of branch that MI is (see MCMBBInfo::TermNone); a tail call
+//      counts as a jump, or as an indirect branch unless it names its callee
+static unsigned getRandTermKind(const MachineInstr &MI) {
+  if (MI.isConditionalBranch())
+    return MCMBBInfo::TermCondBranch;
+  if (MI.isIndirectBranch())
+    return MCMBBInfo::TermIndirect;
+  if (MI.isReturn() && MI.isCall()) {
+    const MachineOperand &Callee = MI.getOperand(0);
+    return Callee.isGlobal() || Callee.isSymbol() || Callee.isMCSymbol()
+               ? MCMBBInfo::TermJump
+               : MCMBBInfo::TermIndirect;
+  }
+  if (MI.isReturn())
+    return MCMBBInfo::TermReturn;
+  if (MI.isUnconditionalBranch())
+    return MCMBBInfo::TermJump;
+  return MCMBBInfo::TermNone;
+}
+
+// Koo: Tell the assembler what has been recorded for the MBB (see
+//      MCRandBBLFlags); a coarse record falls through as the last MBB does
+void AsmPrinter::emitRandBBLDirective(const MachineBasicBlock &MBB,
+                                      MCMBBKey ID) {
+  MCReorderInfo &RI = getReorderInfo();
+  const MCMBBInfo &Info = RI.MachineBasicBlocks[ID];
+  bool FallThrough =
+      CoarseRandLayout ? MF->back().canFallThrough() : Info.FallThrough;
+  unsigned Flags = 0;
+  if (FallThrough)
+    Flags |= MCRandBBLFlags::FallThrough;
+  if (Info.IsLoopHeader)
+    Flags |= MCRandBBLFlags::LoopHeader;
+  if (Info.Hotness == MCMBBInfo::HotnessHot)
+    Flags |= MCRandBBLFlags::Hot;
+  else if (Info.Hotness == MCMBBInfo::HotnessCold)
+    Flags |= MCRandBBLFlags::Cold;
+  if (Info.ChainStart)
+    Flags |= MCRandBBLFlags::ChainStart;
+  auto InlineAsm = [](const MachineInstr &MI) { return MI.isInlineAsm(); };
+  if (CoarseRandLayout ? any_of(*MF, [&](const MachineBasicBlock &B) {
+                           return any_of(B, InlineAsm);
+                         })
+                       : any_of(MBB, InlineAsm))
+    Flags |= MCRandBBLFlags::InlineAsm;
+  auto G = RI.MachineFunctionGranularities.find(ID.getMFID());
+  if (G != RI.MachineFunctionGranularities.end())
+    Flags |= G->second == MCMBBInfo::GranularityNone
+                 ? MCRandBBLFlags::GranularityNone
+                 : MCRandBBLFlags::GranularityFunction;
+  OutStreamer->EmitCCRBasicBlock(ID.getMFID(), ID.getMBBID(), Flags,
+                                 std::min<unsigned>(Info.AlignLog2, 15),
+                                 Info.LayoutEdgeProb);
+}
+
+// Koo: CodeGenPrepare has already placed a profiled function in .text.hot or
+//      .text.unlikely by its entry count; the block counts (if available)
+//      refine the class of each MBB, i.e., the cold paths of a hot function.
+void AsmPrinter::collectMBBHotness() {
+  unsigned FuncHotness = MCMBBInfo::HotnessUnknown;
+  if (Optional<StringRef> Prefix = MF->getFunction().getSectionPrefix()) {
+    if (*Prefix == "hot")
+      FuncHotness = MCMBBInfo::HotnessHot;
+    else if (*Prefix == "unlikely")
+      FuncHotness = MCMBBInfo::HotnessCold;
+  }
+
+  auto *PSIWrapper = getAnalysisIfAvailable<ProfileSummaryInfoWrapperPass>();
+  ProfileSummaryInfo *PSI = PSIWrapper ? &PSIWrapper->getPSI() : nullptr;
+
+  // A single record tells the hotness of the whole function by its entry count
+  if (CoarseRandLayout) {
+    if (PSI && PSI->hasProfileSummary() && FuncHotness == MCMBBInfo::HotnessUnknown)
+      FuncHotness = PSI->isFunctionEntryHot(&MF->getFunction())
+                        ? MCMBBInfo::HotnessHot
+                        : PSI->isFunctionEntryCold(&MF->getFunction())
+                              ? MCMBBInfo::HotnessCold
+                              : MCMBBInfo::HotnessUnknown;
+    getReorderInfo().setMBBHotness(getRandMBBKey(MF->front()), FuncHotness);
+    return;
+  }
+
+  auto *MBPI = getAnalysisIfAvailable<MachineBranchProbabilityInfo>();
+
+  // Compute the block frequencies on the fly if they are unavailable
+  const MachineBlockFrequencyInfo *MBFI = nullptr;
+  MachineDominatorTree LocalMDT;
+  MachineLoopInfo LocalMLI;
+  MachineBlockFrequencyInfo LocalMBFI;
+  if (PSI && PSI->hasProfileSummary()) {
+    MBFI = getAnalysisIfAvailable<MachineBlockFrequencyInfo>();
+    if (!MBFI && MBPI) {
+      LocalMDT.getBase().recalculate(*MF);
+      LocalMLI.getBase().analyze(LocalMDT.getBase());
+      LocalMBFI.calculate(*MF, *MBPI, LocalMLI);
+      MBFI = &LocalMBFI;
+    }
+  }
+
+  // A run of MBBs (see collectRandRuns()) is cut where its hotness changes,
+  // thus the randomizer may still split the cold MBBs off
+  unsigned RunHead = 0, RunOrigHead = 0, RunHotness = 0;
+  for (const MachineBasicBlock &MBB : *MF) {
+    if (MBB.empty())
+      continue;
+    unsigned Hotness = FuncHotness;
+    if (MBFI)
+      if (Optional<uint64_t> Count = MBFI->getBlockProfileCount(&MBB))
+        Hotness = PSI->isHotCount(*Count)    ? MCMBBInfo::HotnessHot
+                  : PSI->isColdCount(*Count) ? MCMBBInfo::HotnessCold
+                                             : MCMBBInfo::HotnessUnknown;
+    auto Head = RandRunHeads.find(MBB.getNumber());
+    if (Head != RandRunHeads.end()) {
+      if (Head->second == RunOrigHead && Hotness == RunHotness) {
+        Head->second = RunHead;
+        continue;
+      }
+      RunOrigHead = Head->second;
+      RandRunHeads.erase(Head);
+    } else {
+      RunOrigHead = MBB.getNumber();
+    }
+    RunHead = MBB.getNumber();
+    RunHotness = Hotness;
+    getReorderInfo().setMBBHotness(getRandMBBKey(MBB), Hotness);
+  }
+}
+
+// Koo: An MBB that the MBB before it falls into, and that nothing else enters
+//      (no other predecessor, jump table or address taken), never moves apart
+//      from it, thus the run of such MBBs is recorded as one layout record
+//      under the key of its first MBB: the per-MBB records and the work of the
+//      randomizer on them are saved, while the diversity stays. An aligned MBB,
+//      the start of a placement chain (or of a chain section) and inline
+//      assembly begin a record of their own, as does a CFI instruction, which
+//      ties its BBL to its place with -ccr-eh-info.
+void AsmPrinter::collectRandRuns() {
+  SmallPtrSet<const MachineBasicBlock *, 32> JTTargets;
+  if (const MachineJumpTableInfo *JTI = MF->getJumpTableInfo())
+    for (const MachineJumpTableEntry &JT : JTI->getJumpTables())
+      JTTargets.insert(JT.MBBs.begin(), JT.MBBs.end());
+  bool EHInfo = MAI->emitsRandEHInfo();
+  auto StartsRecord = [&](const MachineInstr &MI) {
+    return MI.isInlineAsm() || (EHInfo && MI.isCFIInstruction());
+  };
+
+  MachineBasicBlock *Prev = nullptr;
+  unsigned Head = 0;
+  for (MachineBasicBlock &MBB : *MF) {
+    bool Joins = Prev && !MBB.empty() && MBB.pred_size() == 1 &&
+                 *MBB.pred_begin() == Prev && Prev->canFallThrough() &&
+                 MBB.getAlignment() == 0 && !MBB.hasAddressTaken() &&
+                 !MBB.isEHPad() && !MBB.isChainSectionStart() &&
+                 !MBB.isPlacementChainStart() && !JTTargets.count(&MBB) &&
+                 none_of(MBB, StartsRecord);
+    if (Joins)
+      RandRunHeads[MBB.getNumber()] = Head;
+    else
+      Head = MBB.getNumber();
+    Prev = MBB.empty() ? nullptr : &MBB;
+  }
+}
+
+MachineBasicBlock &AsmPrinter::getRandRunEnd(MachineBasicBlock &MBB) const {
+  MachineBasicBlock *End = &MBB;
+  for (auto It = std::next(MBB.getIterator()); It != MF->end(); ++It) {
+    auto Head = RandRunHeads.find(It->getNumber());
+    if (Head == RandRunHeads.end() || Head->second != unsigned(MBB.getNumber()))
+      break;
+    End = &*It;
+  }
+  return *End;
+}
+
+// Koo: The cost model weighs what the MBBs of a function cost in .rand against
+//      what shuffling them buys: the instructions stand for the bytes (which
+//      are unknown until the assembler lays them out), and the jump table
+//      entries for the dispatched cases. The profile only shifts the thresholds,
+//      as the jumps that shuffling adds cost in the hot functions alone.
+bool AsmPrinter::isCoarseRandFunction() {
+  unsigned NumMBBs = 0, NumInsts = 0;
+  for (const MachineBasicBlock &MBB : *MF) {
+    if (MBB.empty())
+      continue;
+    ++NumMBBs;
+    for (const MachineInstr &MI : MBB)
+      if (!MI.isPosition() && !MI.isImplicitDef() && !MI.isKill() &&
+          !MI.isDebugInstr())
+        ++NumInsts;
+  }
+  if (NumMBBs > MAI->RandAutoMaxMBBs)
+    return true;
+
+  unsigned MinMBBs = MAI->RandAutoMinMBBs;
+  if (MAI->RandAutoHotness) {
+    const Function &F = MF->getFunction();
+    auto *PSIWrapper = getAnalysisIfAvailable<ProfileSummaryInfoWrapperPass>();
+    ProfileSummaryInfo *PSI = PSIWrapper ? &PSIWrapper->getPSI() : nullptr;
+    bool HasProfile = PSI && PSI->hasProfileSummary();
+    Optional<StringRef> Prefix = F.getSectionPrefix();
+    if ((Prefix && *Prefix == "unlikely") ||
+        (HasProfile && PSI->isFunctionEntryCold(&F)))
+      return false;
+    if ((Prefix && *Prefix == "hot") ||
+        (HasProfile && PSI->isFunctionEntryHot(&F)))
+      MinMBBs /= 2;
+  }
+  if (NumMBBs == 0 || NumMBBs < MinMBBs)
+    return false;
+
+  if (NumInsts < uint64_t(NumMBBs) * MAI->RandAutoMinMBBInsts)
+    return true;
+  unsigned NumJTEntries = 0;
+  if (const MachineJumpTableInfo *JTI = MF->getJumpTableInfo())
+    for (const MachineJumpTableEntry &JT : JTI->getJumpTables())
+      NumJTEntries += JT.MBBs.size();
+  return MAI->RandAutoJumpTableDensity &&
+         uint64_t(NumJTEntries) * 100 >=
+             uint64_t(NumMBBs) * MAI->RandAutoJumpTableDensity;
+}
+
 /// EmitFunctionBody - This method emits the body and trailer for a
 /// function.
 void AsmPrinter::EmitFunctionBody() {
@@ -1039,13 +1428,117 @@ void AsmPrinter::EmitFunctionBody() {
     }
   }
 
+  // Koo: ccr_granularity("function" | "none") folds the MBBs of the function
+  //      into a single layout record (see coarsenReorderLayout() in MCAssembler),
+  //      and so does -ccr-granularity=function for every function (and
+  //      -ccr-granularity=auto for those its cost model picks): the MBBs then
+  //      share the key of the entry MBB, thus no per-MBB bookkeeping is done.
+  //      Nothing at all is recorded without -fccr-metadata.
+  bool RandMetadata = MAI->RandMetadata;
+  MCReorderInfo &RI = getReorderInfo();
+  CoarseRandLayout = MAI->hasRandFunctionGranularity();
+  Attribute Granularity = RandMetadata
+                              ? MF->getFunction().getFnAttribute("ccr-granularity")
+                              : Attribute();
+  if (Granularity.isStringAttribute()) {
+    StringRef Value = Granularity.getValueAsString();
+    if (Value == "function")
+      RI.setMFGranularity(MF->getFunctionNumber(),
+                          MCMBBInfo::GranularityFunction);
+    else if (Value == "none")
+      RI.setMFGranularity(MF->getFunctionNumber(), MCMBBInfo::GranularityNone);
+    CoarseRandLayout |= Value == "function" || Value == "none";
+  } else if (RandMetadata && MAI->RandAutoGranularity && isCoarseRandFunction()) {
+    ++RandAutoCoarseFunctions;
+    RI.setMFGranularity(MF->getFunctionNumber(), MCMBBInfo::GranularityFunction);
+    CoarseRandLayout = true;
+  }
+
+  // Koo: The function is known across builds by its symbol (and its instructions)
+  if (RandMetadata)
+    RI.setMFName(MF->getFunctionNumber(), CurrentFnSym->getName());
+  bool HashRandContent = RandMetadata && MAI->RandFunctionHashes;
+  SmallVector<uint64_t, 256> RandContentWords;
+
+  // Koo: Coalesce the runs of MBBs, and classify the MBBs as hot or cold with
+  //      the profile (if any)
+  RandRunHeads.clear();
+  if (RandMetadata && !CoarseRandLayout && MAI->RandCoalesceMBBs)
+    collectRandRuns();
+  if (RandMetadata && (MF->getFunction().hasProfileData() ||
+                       MF->getFunction().getSectionPrefix()))
+    collectMBBHotness();
+
+  // Koo: Loop headers are told apart for the alignment of the MBBs below
+  const MachineLoopInfo *LoopInfo = nullptr;
+  const MachineBranchProbabilityInfo *MBPI = nullptr;
+  if (RandMetadata) {
+    LoopInfo = isVerbose() ? MLI : getAnalysisIfAvailable<MachineLoopInfo>();
+    MBPI = getAnalysisIfAvailable<MachineBranchProbabilityInfo>();
+  }
+  bool RecordedAlignment = false;
+
+  // Koo: The symbol of the function covers its entry chain only if the other
+  //      chains go to sections of their own (-ccr-chain-sections)
+  const MCSection *FnSection = OutStreamer->getCurrentSectionOnly();
+  MCSymbol *EntryChainEnd = nullptr;
+  unsigned NumChainSections = 0;
+  SmallVector<const MachineInstr *, 16> EmittedCFIs;
+
   // Print out code for the function.
   bool HasAnyRealCode = false;
   int NumInstsInFunction = 0;
   for (auto &MBB : *MF) {
+    if (MBB.isChainSectionStart()) {
+      if (!EntryChainEnd) {
+        EntryChainEnd = createTempSymbol("func_end");
+        OutStreamer->EmitLabel(EntryChainEnd);
+      }
+      switchToChainSection(MBB, ++NumChainSections, FnSection, EmittedCFIs);
+    }
+
     // Print a label for the basic block.
     EmitBasicBlockStart(MBB);
+
+    // Koo: Collect the fallThrough-ability of the MBB here once,
+    //      which reflects the final block layout of the MF
+    //      and the alignment it starts with, so that the randomizer can
+    //      re-align the block wherever it moves (the function alignment
+    //      belongs to the entry block), along with the chains that
+    //      MachineBlockPlacement has built (if it ran). A coarse record
+    //      starts with the first non-empty MBB and falls through as the last
+    //      MBB does (see below), and so does the record of a run of MBBs.
+    if (RandMetadata && RandRunHeads.count(MBB.getNumber())) {
+      ++RandCoalescedMBBs;
+      MCMBBKey ID = getRandMBBKey(MBB);
+      RI.addMBBInternalBoundary(ID);
+      RI.setMBBTermKind(ID, MCMBBInfo::TermNone);
+    } else if (RandMetadata && !MBB.empty() &&
+               !(CoarseRandLayout && RecordedAlignment)) {
+      ++RandMBBs;
+      MCMBBKey ID = getRandMBBKey(MBB);
+      if (!CoarseRandLayout) {
+        MachineBasicBlock &RunEnd = getRandRunEnd(MBB);
+        RI.setMBBFallThrough(ID, RunEnd.canFallThrough());
+        if (MBPI && MF->front().isPlacementChainStart())
+          RI.setMBBPlacement(ID, MBB.isPlacementChainStart(),
+                             getLayoutEdgeProb(*MBPI, RunEnd));
+      }
+      unsigned AlignLog2 = MBB.getAlignment();
+      if (&MBB == &MF->front() || CoarseRandLayout)
+        AlignLog2 = std::max(AlignLog2, MF->getAlignment());
+      RI.setMBBAlignment(ID, AlignLog2,
+                         LoopInfo && LoopInfo->isLoopHeader(&MBB));
+      RecordedAlignment = true;
+      if (MAI->RandAsmDirectives)
+        emitRandBBLDirective(MBB, ID);
+    }
+    if (HashRandContent)
+      RandContentWords.push_back(~uint64_t(MBB.getNumber()));
     for (auto &MI : MBB) {
+      if (HashRandContent)
+        appendRandInstructionWords(MI, RandContentWords);
+
       // Print the assembly for the instruction.
       if (!MI.isPosition() && !MI.isImplicitDef() && !MI.isKill() &&
           !MI.isDebugInstr()) {
@@ -1069,9 +1562,12 @@ void AsmPrinter::EmitFunctionBody() {
       if (isVerbose())
         emitComments(MI, OutStreamer->GetCommentOS());
 
+      unsigned RandInstsBefore = RandMetadata ? RI.numEmittedInsts : 0;
       switch (MI.getOpcode()) {
       case TargetOpcode::CFI_INSTRUCTION:
         emitCFIInstruction(MI);
+        if (MAI->RandChainSections)
+          EmittedCFIs.push_back(&MI);
         break;
       case TargetOpcode::LOCAL_ESCAPE:
         emitFrameAlloc(MI);
@@ -1108,6 +1604,13 @@ void AsmPrinter::EmitFunctionBody() {
         break;
       }
 
+      // Koo: The streamer has recorded the size of the last instruction of the
+      //      MBB; its kind is told by the MI that emitted it (a branch expanded
+      //      into several instructions ends with the branch)
+      if (RandMetadata && MI.isTerminator() &&
+          RI.numEmittedInsts != RandInstsBefore)
+        RI.setMBBTermKind(getRandMBBKey(MBB), getRandTermKind(MI));
+
       // If there is a post-instruction symbol, emit a label for it here.
       if (MCSymbol *S = MI.getPostInstrSymbol())
         OutStreamer->EmitLabel(S);
@@ -1125,6 +1628,16 @@ void AsmPrinter::EmitFunctionBody() {
     EmitBasicBlockEnd(MBB);
   }
 
+  // Koo: A coarse record ends with the last MBB of the function
+  if (CoarseRandLayout && RecordedAlignment)
+    RI.setMBBFallThrough(getRandMBBKey(MF->front()),
+                         MF->back().canFallThrough());
+  if (HashRandContent)
+    RI.setMFContentHash(
+        MF->getFunctionNumber(),
+        xxHash64(StringRef(reinterpret_cast<const char *>(RandContentWords.data()),
+                           RandContentWords.size() * sizeof(uint64_t))));
+
   EmittedInsts += NumInstsInFunction;
   MachineOptimizationRemarkAnalysis R(DEBUG_TYPE, "InstructionCount",
                                       MF->getFunction().getSubprogram(),
@@ -1133,6 +1646,12 @@ void AsmPrinter::EmitFunctionBody() {
     << " instructions in function";
   ORE->emit(R);
 
+  // Koo: Let the assembler account the .rand bytes of this function as well
+  if (RandMetadata && ORE->allowExtraAnalysis(DEBUG_TYPE)) {
+    RI.CollectRandCosts = true;
+    RandRemarkFunctions[MF->getFunctionNumber()] = &MF->getFunction();
+  }
+
   // If the function is empty and the object file uses .subsections_via_symbols,
   // then we need to emit *something* to the function body to prevent the
   // labels from collapsing together.  Just emit a noop.
@@ -1169,8 +1688,10 @@ void AsmPrinter::EmitFunctionBody() {
   // Emit target-specific gunk after the function body.
   EmitFunctionBodyEnd();
 
-  if (needFuncLabelsForEHOrDebugInfo(*MF, MMI) ||
-      MAI->hasDotTypeDotSizeDirective()) {
+  if (EntryChainEnd) {
+    CurrentFnEnd = EntryChainEnd;
+  } else if (needFuncLabelsForEHOrDebugInfo(*MF, MMI) ||
+             MAI->hasDotTypeDotSizeDirective()) {
     // Create a symbol for the end of function.
     CurrentFnEnd = createTempSymbol("func_end");
     OutStreamer->EmitLabel(CurrentFnEnd);
@@ -1548,7 +2069,12 @@ bool AsmPrinter::doFinalization(Module &M) {
   EmitModuleIdents(M);
   
   // Koo: Emit the .rand section
-  OutStreamer->EmitRand();
+  if (MAI->RandMetadata) {
+    NamedRegionTimer T(RandTimerName, RandTimerDescription, RandGroupName,
+                       RandGroupDescription, TimePassesIsEnabled);
+    TimeTraceScope TimeScope("CCREmitRand", StringRef(""));
+    OutStreamer->EmitRand();
+  }
 
   // Emit bytes for llvm.commandline metadata.
   EmitModuleCommandLines(M);
@@ -1664,14 +2190,11 @@ bool AsmPrinter::doFinalization(Module &M) {
   // Allow the target to emit any magic that it wants at the end of the file,
   // after everything else has gone out.
   EmitEndOfAsmFile(M);
-  
-  // Koo: store temporary object file name to generate metadata
-  //      it ends up with residing in the current module M for MCAssembler class
-  OutStreamer->setObjTmpName(M.getTmpObjFile());
 
   MMI = nullptr;
 
   OutStreamer->Finish();
+  emitRandRemarks();
   OutStreamer->reset();
   OwnedMLI.reset();
   OwnedMDT.reset();
@@ -1679,6 +2202,68 @@ bool AsmPrinter::doFinalization(Module &M) {
   return false;
 }
 
+// Koo: The remarks name the functions with the most metadata (-ccr-rand-remarks-top),
+//      so that they can be told apart in opt-viewer or llvm-opt-report; the one on
+//      the object is attached to the heaviest function
+void AsmPrinter::emitRandRemarks() {
+  std::vector<std::pair<const Function *, MCRandCost>> Costs;
+  MCReorderInfo &RI = getReorderInfo();
+  for (const auto &Entry : RI.RandFunctionCosts) {
+    auto It = RandRemarkFunctions.find(Entry.first);
+    if (It != RandRemarkFunctions.end())
+      Costs.emplace_back(It->second, Entry.second);
+  }
+  MCRandCost Object = RI.RandObjectCost;
+  RI.RandFunctionCosts.clear();
+  RI.RandObjectCost = MCRandCost();
+  RI.CollectRandCosts = false;
+  RandRemarkFunctions.clear();
+  if (Costs.empty())
+    return;
+
+  size_t NumTop = std::min<size_t>(Costs.size(), CCRRandRemarksTop);
+  std::partial_sort(Costs.begin(), Costs.begin() + NumTop, Costs.end(),
+                    [](const std::pair<const Function *, MCRandCost> &A,
+                       const std::pair<const Function *, MCRandCost> &B) {
+                      return A.second.getRandBytes() > B.second.getRandBytes();
+                    });
+  uint64_t TopBytes = 0;
+  for (size_t I = 0; I != NumTop; ++I)
+    TopBytes += Costs[I].second.getRandBytes();
+
+  const Function &Heaviest = *Costs.front().first;
+  OptimizationRemarkEmitter ObjectORE(&Heaviest);
+  ObjectORE.emit([&]() {
+    return OptimizationRemarkAnalysis(DEBUG_TYPE, "CCRMetadataObject",
+                                      Heaviest.getSubprogram(),
+                                      &Heaviest.getEntryBlock())
+           << ore::NV("RandBytes", Object.getRandBytes())
+           << " bytes of CCR metadata in the object ("
+           << ore::NV("LayoutBytes", Object.LayoutBytes) << " layout, "
+           << ore::NV("FixupBytes", Object.FixupBytes) << " fixup and "
+           << ore::NV("StringBytes", Object.StringBytes) << " string bytes) for "
+           << ore::NV("CodeBytes", Object.CodeBytes) << " bytes of code; the "
+           << ore::NV("NumFunctions", (unsigned)NumTop)
+           << " heaviest functions take "
+           << ore::NV("TopRandBytes", TopBytes) << " bytes";
+  });
+
+  for (size_t I = 0; I != NumTop; ++I) {
+    const Function &F = *Costs[I].first;
+    const MCRandCost &Cost = Costs[I].second;
+    OptimizationRemarkEmitter FunctionORE(&F);
+    FunctionORE.emit([&]() {
+      return OptimizationRemarkAnalysis(DEBUG_TYPE, "CCRMetadata",
+                                        F.getSubprogram(), &F.getEntryBlock())
+             << ore::NV("RandBytes", Cost.getRandBytes())
+             << " bytes of CCR metadata ("
+             << ore::NV("LayoutBytes", Cost.LayoutBytes) << " layout and "
+             << ore::NV("FixupBytes", Cost.FixupBytes) << " fixup bytes) for "
+             << ore::NV("CodeBytes", Cost.CodeBytes) << " bytes of code";
+    });
+  }
+}
+
 MCSymbol *AsmPrinter::getCurExceptionSym() {
   if (!CurExceptionSym)
     CurExceptionSym = createTempSymbol("exception");
@@ -1803,6 +2388,11 @@ void AsmPrinter::EmitJumpTableInfo() {
   const DataLayout &DL = MF->getDataLayout();
   const MachineJumpTableInfo *MJTI = MF->getJumpTableInfo();
   if (!MJTI) return;
+
+  // Koo - Record the final tables for the metadata, once per function
+  if (MAI->RandMetadata)
+    MF->RecordMachineJumpTableInfo(MJTI);
+
   if (MJTI->getEntryKind() == MachineJumpTableInfo::EK_Inline) return;
   const std::vector<MachineJumpTableEntry> &JT = MJTI->getJumpTables();
   if (JT.empty()) return;
@@ -2935,6 +3525,39 @@ void AsmPrinter::setupCodePaddingContext(const MachineBasicBlock &MBB,
       MBB.pred_size() > 0 && !isBlockOnlyReachableByFallthrough(&MBB);
 }
 
+// Koo: The section of a chain is named after the section of its function, and
+//      belongs to its COMDAT group (if any); a local symbol names its code. A
+//      CFI frame covers a single section, thus the frame of the previous chain
+//      ends here, and the new one begins in the state that the CFI
+//      instructions before the chain have built up, as the unwinder would
+//      have read it out of the original layout.
+void AsmPrinter::switchToChainSection(const MachineBasicBlock &MBB,
+                                      unsigned Idx, const MCSection *FnSection,
+                                      ArrayRef<const MachineInstr *> CFIs) {
+  const auto *FnSec = cast<MCSectionELF>(FnSection);
+  SmallString<64> Name(FnSec->getSectionName());
+  if (Name == ".text")
+    raw_svector_ostream(Name) << '.' << CurrentFnSym->getName();
+  raw_svector_ostream(Name) << '.' << Idx;
+  const MCSymbolELF *Group = FnSec->getGroup();
+  MCSection *Sec = OutContext.getELFSection(
+      Name, ELF::SHT_PROGBITS, FnSec->getFlags() & ~ELF::SHF_GROUP, 0,
+      Group ? Group->getName() : "");
+
+  for (const HandlerInfo &HI : Handlers)
+    HI.Handler->endFragment();
+  OutStreamer->SwitchSection(Sec);
+  MCSymbol *Sym = OutContext.getOrCreateSymbol(CurrentFnSym->getName() +
+                                               ".ccr." + Twine(Idx));
+  OutStreamer->EmitSymbolAttribute(Sym, MCSA_ELF_TypeFunction);
+  OutStreamer->EmitLabel(Sym);
+  for (const HandlerInfo &HI : Handlers)
+    HI.Handler->beginFragment(
+        &MBB, [](AsmPrinter *Asm) { return Asm->getCurExceptionSym(); });
+  for (const MachineInstr *MI : CFIs)
+    emitCFIInstruction(*MI);
+}
+
 /// EmitBasicBlockStart - This method prints the label for the specified
 /// MachineBasicBlock, an alignment (if present) and a comment describing
 /// it if appropriate.
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/CodeGen/AsmPrinter.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
@@ -42,6 +43,9 @@ using namespace llvm;
 
 #define DEBUG_TYPE "asm-printer"
 
+STATISTIC(RandInlineAsmBlobs, "Number of inline asm blobs whose bytes are "
+                              "attributed to their MBBs for CCR"); // Koo
+
 /// srcMgrDiagHandler - This callback is invoked when the SourceMgr for an
 /// inline asm has an error in it.  diagInfo is a pointer to the SrcMgrDiagInfo
 /// struct above.
@@ -111,7 +115,7 @@ unsigned AsmPrinter::addInlineAsmDiagBuffer(StringRef AsmStr,
 
 /// EmitInlineAsm - Emit a blob of inline asm to the output streamer.
 void AsmPrinter::EmitInlineAsm(StringRef Str, const MCSubtargetInfo &STI,
-                               const MCTargetOptions &MCOptions, std::string parentID, // Koo
+                               const MCTargetOptions &MCOptions, MCMBBKey parentID, // Koo
                                const MDNode *LocMDNode,
                                InlineAsm::AsmDialect Dialect) const {
   assert(!Str.empty() && "Can't emit empty inline asm block");
@@ -149,9 +153,11 @@ void AsmPrinter::EmitInlineAsm(StringRef Str, const MCSubtargetInfo &STI,
   // and not have a MachineFunction to initialize the TargetInstrInfo from and
   // we only need MCInstrInfo for asm parsing. We create one unconditionally
   // because it's not subtarget dependent.
-  std::unique_ptr<MCInstrInfo> MII(TM.getTarget().createMCInstrInfo());
+  // Koo: ... and the same one serves every blob of the module
+  if (!InlineAsmMII)
+    InlineAsmMII.reset(TM.getTarget().createMCInstrInfo());
   std::unique_ptr<MCTargetAsmParser> TAP(TM.getTarget().createMCAsmParser(
-      STI, *Parser, *MII, MCOptions));
+      STI, *Parser, *InlineAsmMII, MCOptions));
   if (!TAP)
     report_fatal_error("Inline asm not supported by this streamer because"
                        " we don't have an asm parser for this target\n");
@@ -165,11 +171,16 @@ void AsmPrinter::EmitInlineAsm(StringRef Str, const MCSubtargetInfo &STI,
   emitInlineAsmStart();
   // Don't implicitly switch to the text section before the asm.
   
-  // Koo [Note] Here sets # of byteCtr/fixupCtr in STI (MCSubtargetInfo) and
-  //            sets ParentID in MCInst (MatchAndEmitATTInstruction and MatchAndEmitIntelInstruction)
-  //            Make sure TAP's getSTI() should be updated before entering Parser->Run()!
-  (&TAP->getSTI())->setParentID(parentID);
-  MCAI->hasInlineAssembly = true;
+  // Koo [Note] The parsed instructions carry no parent; the streamer gives them
+  //            (and the data directives, i.e., .byte) the latest parent, and
+  //            counts the bytes (and fixups) of the blob in that MBB directly as
+  //            they go to its fragments. The shared MCSubtargetInfo is left alone.
+  if (MAI->RandMetadata) {
+    MCReorderInfo &RI = getReorderInfo();
+    RI.latestParentID = parentID;
+    RI.hasInlineAssembly = true;
+    ++RandInlineAsmBlobs;
+  }
   
   int Res = Parser->Run(/*NoInitialTextSection*/ true,
                         /*NoFinalize*/ true);
@@ -570,12 +581,12 @@ void AsmPrinter::EmitInlineAsm(const MachineInstr *MI) const {
 
   // Koo [Note] This function does X86AsmPrinter::EmitInstruction() for inline assembly!
   //            Let's apply the same logic for inline assembly as well
-  const MachineBasicBlock *MBB = MI->getParent();
-  unsigned MBBID = MBB->getNumber();
-  unsigned MFID = MBB->getParent()->getFunctionNumber();
-  std::string parentID = std::to_string(MFID) + "_" + std::to_string(MBBID);
-  if (parentID.length() == 0)
-    parentID = MAI->latestParentID;
+  MCMBBKey parentID;
+  if (MAI->RandMetadata) {
+    parentID = getRandMBBKey(*MI->getParent());
+    if (!parentID.isValid())
+      parentID = getReorderInfo().latestParentID;
+  }
 
   // Koo [Note]
   // The parentID tag will be stored in MatchAndEmitATTInstruction() and MatchAndEmitIntelInstruction()
@@ -584,13 +595,6 @@ void AsmPrinter::EmitInlineAsm(const MachineInstr *MI) const {
   EmitInlineAsm(OS.str(), getSubtargetInfo(), TM.Options.MCOptions, parentID, LocMD,
                 MI->getInlineAsmDialect());
 
-  MAI->updateByteCounter(parentID, getSubtargetInfo().getByteCtr(), /*numFixups=*/ 0, \
-                          /*isAlign=*/ false, /*isInline=*/ true);
-
-  // Koo [Note] Simple hack: both MF and MAI can be accessible, thus update fallThrough here.
-  if (MAI->canMBBFallThrough.count(parentID) == 0)
-     MAI->canMBBFallThrough[parentID] = MF->canMBBFallThrough[parentID];
- 
   // Emit the #NOAPP end marker.  This has to happen even if verbose-asm isn't
   // enabled, so we use emitRawComment.
   OutStreamer->emitRawComment(MAI->getInlineAsmEnd());
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "EHStreamer.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/ADT/iterator_range.h"
@@ -324,6 +325,51 @@ computeCallSiteTable(SmallVectorImpl<CallSiteEntry> &CallSites,
   }
 }
 
+/// Koo: A randomized function keeps its fall-through chains together, thus a
+/// range is split at every MBB that begins a chain. Such an MBB has its label
+/// emitted unless it is unreachable; the randomizer checks the rest of the
+/// ranges against its layout.
+void EHStreamer::splitCallSitesAtBlocks(
+    SmallVectorImpl<CallSiteEntry> &CallSites) {
+  // Number the EH labels and the chain heads in the order of their addresses;
+  // 0 is the start of the function
+  DenseMap<const MCSymbol *, unsigned> Positions;
+  SmallVector<MCSymbol *, 16> Heads;
+  SmallVector<unsigned, 16> HeadPositions;
+  unsigned Pos = 1;
+  MachineBasicBlock *Prev = nullptr;
+  for (auto &MBB : *Asm->MF) {
+    if (Prev && !Prev->canFallThrough() && MBB.getSymbol()->isDefined()) {
+      Heads.push_back(MBB.getSymbol());
+      HeadPositions.push_back(Pos++);
+    }
+    for (const auto &MI : MBB)
+      if (MI.isEHLabel())
+        Positions[MI.getOperand(0).getMCSymbol()] = Pos++;
+    if (!MBB.empty())
+      Prev = &MBB;
+  }
+  if (Heads.empty())
+    return;
+
+  SmallVector<CallSiteEntry, 64> Split;
+  for (const CallSiteEntry &Site : CallSites) {
+    unsigned Begin = Site.BeginLabel ? Positions.lookup(Site.BeginLabel) : 0;
+    unsigned End = Site.EndLabel ? Positions.lookup(Site.EndLabel) : Pos;
+    CallSiteEntry Part = Site;
+    for (auto It = std::upper_bound(HeadPositions.begin(), HeadPositions.end(),
+                                    Begin);
+         It != HeadPositions.end() && *It < End; ++It) {
+      Part.EndLabel = Heads[It - HeadPositions.begin()];
+      Split.push_back(Part);
+      Part.BeginLabel = Part.EndLabel;
+    }
+    Part.EndLabel = Site.EndLabel;
+    Split.push_back(Part);
+  }
+  CallSites.swap(Split);
+}
+
 /// Emit landing pads and actions.
 ///
 /// The general organization of the table is complex, but the basic concepts are
@@ -377,12 +423,25 @@ MCSymbol *EHStreamer::emitExceptionTable() {
 
   bool IsSJLJ = Asm->MAI->getExceptionHandlingType() == ExceptionHandling::SjLj;
   bool IsWasm = Asm->MAI->getExceptionHandlingType() == ExceptionHandling::Wasm;
-  unsigned CallSiteEncoding =
-      IsSJLJ ? dwarf::DW_EH_PE_udata4 : dwarf::DW_EH_PE_uleb128;
   bool HaveTTData = !TypeInfos.empty() || !FilterIds.empty();
 
   // Type infos.
   MCSection *LSDASection = Asm->getObjFileLowering().getLSDASection();
+
+  // Koo: The records that the randomizer rewrites have fixed-size fields, and
+  //      no try-range spans code that it may move apart (-ccr-eh-info)
+  bool RandEHInfo =
+      !IsSJLJ && !IsWasm && LSDASection && Asm->MAI->emitsRandEHInfo();
+  if (RandEHInfo)
+    splitCallSitesAtBlocks(CallSites);
+  unsigned CallSiteEncoding = IsSJLJ || RandEHInfo ? dwarf::DW_EH_PE_udata4
+                                                   : dwarf::DW_EH_PE_uleb128;
+  auto EmitCallSiteOffset = [&](const MCSymbol *Hi, const MCSymbol *Lo) {
+    if (RandEHInfo)
+      Asm->EmitLabelDifference(Hi, Lo, 4);
+    else
+      Asm->EmitLabelDifferenceAsULEB128(Hi, Lo);
+  };
   unsigned TTypeEncoding;
 
   if (!HaveTTData) {
@@ -523,24 +582,26 @@ MCSymbol *EHStreamer::emitExceptionTable() {
       // Offset of the call site relative to the start of the procedure.
       if (VerboseAsm)
         Asm->OutStreamer->AddComment(">> Call Site " + Twine(++Entry) + " <<");
-      Asm->EmitLabelDifferenceAsULEB128(BeginLabel, EHFuncBeginSym);
+      EmitCallSiteOffset(BeginLabel, EHFuncBeginSym);
       if (VerboseAsm)
         Asm->OutStreamer->AddComment(Twine("  Call between ") +
                                      BeginLabel->getName() + " and " +
                                      EndLabel->getName());
-      Asm->EmitLabelDifferenceAsULEB128(EndLabel, BeginLabel);
+      EmitCallSiteOffset(EndLabel, BeginLabel);
 
       // Offset of the landing pad relative to the start of the procedure.
       if (!S.LPad) {
         if (VerboseAsm)
           Asm->OutStreamer->AddComment("    has no landing pad");
-        Asm->EmitULEB128(0);
+        if (RandEHInfo)
+          Asm->emitInt32(0);
+        else
+          Asm->EmitULEB128(0);
       } else {
         if (VerboseAsm)
           Asm->OutStreamer->AddComment(Twine("    jumps to ") +
                                        S.LPad->LandingPadLabel->getName());
-        Asm->EmitLabelDifferenceAsULEB128(S.LPad->LandingPadLabel,
-                                          EHFuncBeginSym);
+        EmitCallSiteOffset(S.LPad->LandingPadLabel, EHFuncBeginSym);
       }
 
       // Offset of the first associated action record, relative to the start of
@@ -555,6 +616,11 @@ MCSymbol *EHStreamer::emitExceptionTable() {
       }
       Asm->EmitULEB128(S.Action);
     }
+
+    // Koo: Let the randomizer find the records of this function
+    if (RandEHInfo && !CallSites.empty())
+      Asm->getReorderInfo().addCallSiteTable(Asm->getFunctionNumber(),
+                                             CstBeginLabel, CallSites.size());
   }
   Asm->OutStreamer->EmitLabel(CstEndLabel);
 
@@ -89,6 +89,10 @@ protected:
       const SmallVectorImpl<const LandingPadInfo *> &LandingPads,
       const SmallVectorImpl<unsigned> &FirstActions);
 
+  /// Koo: Split the try-ranges at the MBBs that are not entered by falling
+  /// through, which the randomizer may move apart (-ccr-eh-info).
+  void splitCallSitesAtBlocks(SmallVectorImpl<CallSiteEntry> &CallSites);
+
   /// Emit landing pads and actions.
   ///
   /// The general organization of the table is complex, but the basic concepts
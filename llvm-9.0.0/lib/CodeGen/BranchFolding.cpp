@@ -133,12 +133,6 @@ bool BranchFolderPass::runOnMachineFunction(MachineFunction &MF) {
   bool madeChange = Folder.OptimizeFunction(MF, MF.getSubtarget().getInstrInfo(),
                                  MF.getSubtarget().getRegisterInfo(),
                                  getAnalysisIfAvailable<MachineModuleInfo>());
-  
-  // Koo - The final JTInfo, which could be overriden
-  //       For example lib/Target/X86/X86ISelDAGToDAG.cpp for x86
-  MachineJumpTableInfo *MJTI = MF.getJumpTableInfo();
-  if (MJTI)
-    MF.RecordMachineJumpTableInfo(MJTI);  
   return madeChange;
 }
 
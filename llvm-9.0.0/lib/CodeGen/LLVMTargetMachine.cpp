@@ -65,6 +65,10 @@ void LLVMTargetMachine::initAsmInfo() {
 
   TmpAsmInfo->setCompressDebugSections(Options.CompressDebugSections);
 
+  // Koo: Either -fccr-metadata or -ccr-metadata turns the CCR hooks on, and
+  //      the settings of the IR (in LTO) override the -ccr-* options
+  TmpAsmInfo->setRandOptions(Options.MCOptions);
+
   TmpAsmInfo->setRelaxELFRelocations(Options.RelaxELFRelocations);
 
   if (Options.ExceptionModel != ExceptionHandling::None)
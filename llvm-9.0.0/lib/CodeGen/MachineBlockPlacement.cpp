@@ -48,6 +48,7 @@
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/Function.h"
+#include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/BlockFrequency.h"
@@ -57,12 +58,14 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Target/TargetMachine.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -73,6 +76,7 @@ using namespace llvm;
 #define DEBUG_TYPE "block-placement"
 
 STATISTIC(NumCondBranches, "Number of conditional branches");
+STATISTIC(NumChainSections, "Number of block chains in sections of their own");
 STATISTIC(NumUncondBranches, "Number of unconditional branches");
 STATISTIC(CondBranchTakenFreq,
           "Potential frequency of taking conditional branches");
@@ -468,8 +472,10 @@ class MachineBlockPlacement : public MachineFunctionPass {
       BlockChain &LoopChain, const MachineLoop &L,
       const BlockFilterSet &LoopBlockSet);
   void buildCFGChains();
+  void shuffleColdChains(BlockChain &FunctionChain);
   void optimizeBranches();
   void alignBlocks();
+  void markChainSections();
   /// Returns true if a block should be tail-duplicated to increase fallthrough
   /// opportunities.
   bool shouldTailDuplicate(MachineBasicBlock *BB);
@@ -1709,6 +1715,9 @@ void MachineBlockPlacement::buildChain(
     // after this block.
     auto Result = selectBestSuccessor(BB, Chain, BlockFilter);
     MachineBasicBlock* BestSucc = Result.BB;
+    // Koo: The function chain breaks the hot path where no successor is
+    //      viable; the randomizer may move the chain that begins there
+    bool BreaksChain = !BestSucc && !BlockFilter;
     bool ShouldTailDup = Result.ShouldTailDup;
     if (allowTailDupPlacement())
       ShouldTailDup |= (BestSucc && shouldTailDuplicate(BestSucc));
@@ -1749,6 +1758,8 @@ void MachineBlockPlacement::buildChain(
     LLVM_DEBUG(dbgs() << "Merging from " << getBlockName(BB) << " to "
                       << getBlockName(BestSucc) << "\n");
     markChainSuccessors(SuccChain, LoopHeaderBB, BlockFilter);
+    if (BreaksChain)
+      BestSucc->setPlacementChainStart();
     Chain.merge(BestSucc, &SuccChain);
     BB = *std::prev(Chain.end());
   }
@@ -2418,8 +2429,14 @@ void MachineBlockPlacement::buildCFGChains() {
   for (MachineBasicBlock &MBB : *F)
     fillWorkLists(&MBB, UpdatedPreds);
 
+  // Koo: Only the chains of this placement are recorded (see buildChain())
+  for (MachineBasicBlock &MBB : *F)
+    MBB.setPlacementChainStart(false);
+  F->front().setPlacementChainStart();
+
   BlockChain &FunctionChain = *BlockToChain[&F->front()];
   buildChain(&F->front(), FunctionChain);
+  shuffleColdChains(FunctionChain);
 
 #ifndef NDEBUG
   using FunctionBlockSetType = SmallPtrSet<MachineBasicBlock *, 16>;
@@ -2518,6 +2535,89 @@ void MachineBlockPlacement::buildCFGChains() {
   EHPadWorkList.clear();
 }
 
+// Koo: -ccr-compile-seed diversifies the layout at build time. The chains that
+//      the function chain has been built from begin where no successor was
+//      worth falling through to (see buildChain()), thus they can be reordered
+//      without losing a fall-through. Only the chains whose heads run at most
+//      1/LoopToColdBlockRatio as often as the entry are permuted, among the
+//      places of the cold chains: the hot path stays where it has been laid out.
+// Koo: -ccr-chain-sections hands the reordering of the chains over to the
+//      linker: every chain but the entry one begins a section of its own (see
+//      AsmPrinter::EmitFunctionBody()), thus the fall-throughs into the chains
+//      become explicit jumps. The EH tables and the debug information describe
+//      a function within a single section, thus the functions with landing
+//      pads, a personality or a DISubprogram stay whole, and so do the pinned
+//      ones (ccr_granularity("none")). A block whose branch cannot be analyzed
+//      keeps the chain after it in its section.
+void MachineBlockPlacement::markChainSections() {
+  const Function &Fn = F->getFunction();
+  if (!F->getTarget().getMCAsmInfo()->RandChainSections ||
+      !F->getTarget().getTargetTriple().isOSBinFormatELF() ||
+      Fn.hasPersonalityFn() || Fn.getSubprogram() ||
+      Fn.getFnAttribute("ccr-granularity").getValueAsString() == "none" ||
+      any_of(*F, [](const MachineBasicBlock &MBB) { return MBB.isEHPad(); }))
+    return;
+
+  for (auto It = std::next(F->begin()), E = F->end(); It != E; ++It) {
+    MachineBasicBlock &MBB = *It, &Prev = *std::prev(It);
+    if (!MBB.isPlacementChainStart())
+      continue;
+    if (Prev.canFallThrough()) {
+      MachineBasicBlock *TBB = nullptr, *FBB = nullptr;
+      SmallVector<MachineOperand, 4> Cond;
+      if (TII->analyzeBranch(Prev, TBB, FBB, Cond))
+        continue;
+      DebugLoc DL = Prev.findBranchDebugLoc();
+      TII->removeBranch(Prev);
+      if (TBB)
+        TII->insertBranch(Prev, TBB, &MBB, Cond, DL);
+      else
+        TII->insertBranch(Prev, &MBB, nullptr, Cond, DL);
+    }
+    MBB.setChainSectionStart();
+    ++NumChainSections;
+  }
+}
+
+void MachineBlockPlacement::shuffleColdChains(BlockChain &FunctionChain) {
+  uint64_t Seed = F->getTarget().getMCAsmInfo()->RandCompileSeed;
+  if (!Seed)
+    return;
+
+  // The chains as [begin, end) ranges of the function chain
+  SmallVector<std::pair<unsigned, unsigned>, 16> Chains;
+  unsigned Idx = 0;
+  for (MachineBasicBlock *MBB : FunctionChain) {
+    if (!Idx || MBB->isPlacementChainStart())
+      Chains.push_back({Idx, Idx});
+    Chains.back().second = ++Idx;
+  }
+  SmallVector<MachineBasicBlock *, 64> Blocks(FunctionChain.begin(),
+                                              FunctionChain.end());
+  SmallVector<unsigned, 16> ColdChains;
+  uint64_t EntryFreq = MBFI->getEntryFreq();
+  for (unsigned I = 1, E = Chains.size(); I != E; ++I) // The entry one stays
+    if (MBFI->getBlockFreq(Blocks[Chains[I].first]).getFrequency() *
+            LoopToColdBlockRatio <=
+        EntryFreq)
+      ColdChains.push_back(I);
+  if (ColdChains.size() < 2)
+    return;
+
+  // Seeded by the function as well, thus independent of the order of the module
+  std::mt19937_64 Rng(Seed ^ xxHash64(F->getName()));
+  SmallVector<std::pair<unsigned, unsigned>, 16> Order(Chains.begin(),
+                                                       Chains.end());
+  for (unsigned N = ColdChains.size(); N > 1; --N)
+    std::swap(Order[ColdChains[N - 1]], Order[ColdChains[Rng() % N]]);
+  BlockChain::iterator Out = FunctionChain.begin();
+  for (const auto &Range : Order)
+    Out = std::copy(Blocks.begin() + Range.first, Blocks.begin() + Range.second,
+                    Out);
+  LLVM_DEBUG(dbgs() << "Shuffled " << ColdChains.size() << " cold chains of "
+                    << F->getName() << "\n");
+}
+
 void MachineBlockPlacement::optimizeBranches() {
   BlockChain &FunctionChain = *BlockToChain[&F->front()];
   SmallVector<MachineOperand, 4> Cond; // For AnalyzeBranch.
@@ -2871,6 +2971,7 @@ bool MachineBlockPlacement::runOnMachineFunction(MachineFunction &MF) {
 
   optimizeBranches();
   alignBlocks();
+  markChainSections();
 
   BlockToChain.clear();
   ComputedEdges.clear();
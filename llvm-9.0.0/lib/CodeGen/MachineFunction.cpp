@@ -75,7 +75,7 @@
 #include <vector>
 
 //Koo
-#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCReorderInfo.h"
 #include <map> 
 #include <tuple>
 #include <string>
@@ -327,36 +327,37 @@ void MachineFunction::RenumberBlocks(MachineBasicBlock *MBB) {
   MBBNumbering.resize(BlockNo);
 }
 
-// Koo - As optimization goes, MJTI might keep being updated from the followings
-//        a) MachineFunctionPass::SelectionDAGISel::X86DAGToDAGISel::runOnMachineFunction() 
-//        b) MachineFunctionPass::BranchFolderPass::runOnMachineFunction() 
-void MachineFunction::RecordMachineJumpTableInfo(MachineJumpTableInfo *MJTI) {
+// Koo - Called once per function from AsmPrinter::EmitJumpTableInfo(), thus the
+//       tables are recorded as emitted, after every pass that rewrites them
+//       (e.g., branch folding, tail duplication and block placement)
+void MachineFunction::RecordMachineJumpTableInfo(
+    const MachineJumpTableInfo *MJTI) const {
   const std::vector<MachineJumpTableEntry> &JT = MJTI->getJumpTables();
 
   if (!JT.empty()) {
-    const MachineModuleInfo &MMI = this->getMMI();
-    const MCObjectFileInfo* MOFI = MMI.getMCObjectFileInfo();
-
-    if (!MOFI) return;
+    MCReorderInfo &RI = getContext().getReorderInfo();
 
     // Walk through all Jump Tables in this Machine Function
     for (unsigned JTI = 0, e = JT.size(); JTI != e; ++JTI) {
       const std::vector<MachineBasicBlock*> &JTBBs = JT[JTI].MBBs;
       unsigned MFID = this->getFunctionNumber();
 
-      // Key: <MachineFunctionIdx_JumpTableIdx>
-      std::string MJTKey = std::to_string(MFID) + "_" + std::to_string(JTI); 
-      std::list<std::string> JTEntries;
+      // Key: <MachineFunctionIdx, JumpTableIdx>
+      MCJTKey MJTKey(MFID, JTI);
+      std::vector<unsigned> JTEntries;
+      JTEntries.reserve(JTBBs.size());
       // Walk through all Jump Table Entries (MBBs) to get targets
-      for (unsigned ii = 0, ee = JTBBs.size(); ii != ee; ++ii) {
-        unsigned MBBID = JTBBs[ii]->getNumber();
-        JTEntries.push_back(std::to_string(MFID) + "_" + std::to_string(MBBID));
-      }
+      for (unsigned ii = 0, ee = JTBBs.size(); ii != ee; ++ii)
+        JTEntries.push_back(JTBBs[ii]->getNumber());
 
-      // Value: <(EntryKind, EntrySize, Entries[MFID_MBBID])>
+      // Value: <(EntryKind, EntrySize, FunctionRelative, Entries[MBBID])>
       unsigned EntryKind = MJTI->getEntryKind();
       unsigned EntrySize = MJTI->getEntrySize(this->getDataLayout());
-      MOFI->updateJumpTableTargets(MJTKey, EntryKind, EntrySize, JTEntries);
+      bool FunctionRelative =
+          EntryKind == MachineJumpTableInfo::EK_LabelDifference32 &&
+          getSubtarget().getTargetLowering()->isJumpTableFunctionRelative();
+      RI.updateJumpTableTargets(MJTKey, EntryKind, EntrySize, FunctionRelative,
+                                std::move(JTEntries));
     }
   }
 }
@@ -650,6 +651,13 @@ MCSymbol *MachineFunction::getPICBaseSymbol() const {
                                Twine(getFunctionNumber()) + "$pb");
 }
 
+// Koo
+MCSymbol *MachineFunction::getJTBaseSymbol() const {
+  const DataLayout &DL = getDataLayout();
+  return Ctx.getOrCreateSymbol(Twine(DL.getPrivateGlobalPrefix()) + "JTB" +
+                               Twine(getFunctionNumber()));
+}
+
 /// \name Exception Handling
 /// \{
 
@@ -24,6 +24,9 @@
 
 using namespace llvm;
 
+// Koo: Every partition is compiled by a TargetMachine (and MCAsmInfo) of its
+//      own, thus the function numbers that key the CCR metadata restart per
+//      partition and each partition emits a self-contained .rand section.
 static void codegen(Module *M, llvm::raw_pwrite_stream &OS,
                     function_ref<std::unique_ptr<TargetMachine>()> TMFactory,
                     TargetMachine::CodeGenFileType FileType) {
@@ -420,6 +420,10 @@ SDValue TargetLowering::getPICJumpTableRelocBase(SDValue Table,
 const MCExpr *
 TargetLowering::getPICJumpTableRelocBaseExpr(const MachineFunction *MF,
                                              unsigned JTI,MCContext &Ctx) const{
+  // Koo - Or the label at the start of the function
+  if (isJumpTableFunctionRelative())
+    return MCSymbolRefExpr::create(MF->getJTBaseSymbol(), Ctx);
+
   // The normal PIC reloc base is the label at the start of the jump table.
   return MCSymbolRefExpr::create(MF->getJTISymbol(JTI, Ctx), Ctx);
 }
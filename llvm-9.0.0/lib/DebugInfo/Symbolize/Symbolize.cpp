@@ -31,6 +31,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -51,6 +52,15 @@
 namespace llvm {
 namespace symbolize {
 
+// Koo: A profile post-processor adds up the samples of the inserted code of a
+//      function by the suffix of its name
+static void markCCRSyntheticSite(DILineInfo &LineInfo,
+                                 const object::RandSyntheticSite &Site) {
+  LineInfo.FunctionName += " [ccr-overhead:";
+  LineInfo.FunctionName += object::getRandSyntheticSiteKindName(Site.Kind);
+  LineInfo.FunctionName += "]";
+}
+
 Expected<DILineInfo>
 LLVMSymbolizer::symbolizeCode(const std::string &ModuleName,
                               object::SectionedAddress ModuleOffset) {
@@ -70,10 +80,20 @@ LLVMSymbolizer::symbolizeCode(const std::string &ModuleName,
   if (Opts.RelativeAddresses)
     ModuleOffset.Address += Info->getModulePreferredBase();
 
+  // The symbols of a randomized binary were moved along with the code, thus
+  // only the debug info names the original address; the code the randomizer
+  // inserted names the original code it stands for
+  const object::RandSyntheticSite *Site =
+      findCCRSyntheticSite(ModuleName, ModuleOffset);
+  if (Site)
+    ModuleOffset.Address = Site->OrigAddr;
+  bool Translated = Site || translateCCRAddress(ModuleName, ModuleOffset);
   DILineInfo LineInfo = Info->symbolizeCode(ModuleOffset, Opts.PrintFunctions,
-                                            Opts.UseSymbolTable);
+                                            Opts.UseSymbolTable && !Translated);
   if (Opts.Demangle)
     LineInfo.FunctionName = DemangleName(LineInfo.FunctionName, Info);
+  if (Site)
+    markCCRSyntheticSite(LineInfo, *Site);
   return LineInfo;
 }
 
@@ -96,14 +116,24 @@ LLVMSymbolizer::symbolizeInlinedCode(const std::string &ModuleName,
   if (Opts.RelativeAddresses)
     ModuleOffset.Address += Info->getModulePreferredBase();
 
+  const object::RandSyntheticSite *Site =
+      findCCRSyntheticSite(ModuleName, ModuleOffset);
+  if (Site)
+    ModuleOffset.Address = Site->OrigAddr;
+  bool Translated = Site || translateCCRAddress(ModuleName, ModuleOffset);
   DIInliningInfo InlinedContext = Info->symbolizeInlinedCode(
-      ModuleOffset, Opts.PrintFunctions, Opts.UseSymbolTable);
+      ModuleOffset, Opts.PrintFunctions, Opts.UseSymbolTable && !Translated);
   if (Opts.Demangle) {
     for (int i = 0, n = InlinedContext.getNumberOfFrames(); i < n; i++) {
       auto *Frame = InlinedContext.getMutableFrame(i);
       Frame->FunctionName = DemangleName(Frame->FunctionName, Info);
     }
   }
+  // The outermost frame is the function the inserted code is in
+  if (Site && InlinedContext.getNumberOfFrames())
+    markCCRSyntheticSite(
+        *InlinedContext.getMutableFrame(InlinedContext.getNumberOfFrames() - 1),
+        *Site);
   return InlinedContext;
 }
 
@@ -138,6 +168,93 @@ void LLVMSymbolizer::flush() {
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  CCRAddressMaps.clear();
+  CCRSyntheticSites.clear();
+}
+
+void LLVMSymbolizer::loadCCRAddressMap(const std::string &ModuleName,
+                                       const std::string &BinaryName,
+                                       const ObjectFile *Obj) {
+  if (!Opts.UseCCRAddressMaps || !Obj->isELF())
+    return;
+  std::string MapPath = BinaryName + ".ccrmap";
+  if (!sys::fs::exists(MapPath))
+    return;
+
+  auto Warn = [&](const Twine &Msg) {
+    errs() << "Warning: ignoring CCR address map \"" << MapPath << "\": "
+           << Msg << ".\n";
+  };
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+      MemoryBuffer::getFile(MapPath, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return Warn(BufOrErr.getError().message());
+  Expected<object::RandAddressMap> MapOrErr = object::RandAddressMap::create(
+      arrayRefFromStringRef((*BufOrErr)->getBuffer()));
+  if (!MapOrErr)
+    return Warn(toString(MapOrErr.takeError()));
+
+  // A binary randomized again (or rebuilt) leaves a stale map behind
+  for (const SectionRef &Sec : Obj->sections()) {
+    StringRef Name;
+    if (Sec.getName(Name) || Name != ".text")
+      continue;
+    Expected<StringRef> Contents = Sec.getContents();
+    if (!Contents)
+      return Warn(toString(Contents.takeError()));
+    if (!MapOrErr->matches(Sec.getAddress(), arrayRefFromStringRef(*Contents)))
+      return Warn("it does not match .text of the binary");
+    CCRAddressMaps.insert(std::make_pair(ModuleName, std::move(*MapOrErr)));
+    return;
+  }
+  Warn("the binary has no .text");
+}
+
+void LLVMSymbolizer::loadCCRSyntheticSites(const std::string &ModuleName,
+                                           const ObjectFile *Obj) {
+  if (!Opts.UseCCRSyntheticSites || !Obj->isELF())
+    return;
+  for (const SectionRef &Sec : Obj->sections()) {
+    StringRef Name;
+    if (Sec.getName(Name) || Name != ccr::SyntheticSitesHeader::SectionName)
+      continue;
+    auto Warn = [&](const Twine &Msg) {
+      errs() << "Warning: ignoring the CCR synthetic sites of \""
+             << Obj->getFileName() << "\": " << Msg << ".\n";
+    };
+    Expected<StringRef> Contents = Sec.getContents();
+    if (!Contents)
+      return Warn(toString(Contents.takeError()));
+    Expected<std::vector<object::RandSyntheticSite>> SitesOrErr =
+        object::readRandSyntheticSites(arrayRefFromStringRef(*Contents));
+    if (!SitesOrErr)
+      return Warn(toString(SitesOrErr.takeError()));
+    CCRSyntheticSites.insert(std::make_pair(ModuleName, std::move(*SitesOrErr)));
+    return;
+  }
+}
+
+const object::RandSyntheticSite *LLVMSymbolizer::findCCRSyntheticSite(
+    const std::string &ModuleName,
+    object::SectionedAddress ModuleOffset) const {
+  auto It = CCRSyntheticSites.find(ModuleName);
+  if (It == CCRSyntheticSites.end())
+    return nullptr;
+  return object::findRandSyntheticSite(It->second, ModuleOffset.Address);
+}
+
+bool LLVMSymbolizer::translateCCRAddress(
+    const std::string &ModuleName,
+    object::SectionedAddress &ModuleOffset) const {
+  auto It = CCRAddressMaps.find(ModuleName);
+  if (It == CCRAddressMaps.end())
+    return false;
+  Optional<uint64_t> Addr = It->second.getOriginalAddress(ModuleOffset.Address);
+  if (!Addr)
+    return false;
+  ModuleOffset.Address = *Addr;
+  return true;
 }
 
 namespace {
@@ -426,6 +543,8 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
         DWARFContext::create(*Objects.second, nullptr,
                              DWARFContext::defaultErrorHandler, Opts.DWPName);
   assert(Context);
+  loadCCRAddressMap(ModuleName, BinaryName, Objects.first);
+  loadCCRSyntheticSites(ModuleName, Objects.first);
   auto InfoOrErr =
       SymbolizableObjectFile::create(Objects.first, std::move(Context));
   std::unique_ptr<SymbolizableModule> SymMod;
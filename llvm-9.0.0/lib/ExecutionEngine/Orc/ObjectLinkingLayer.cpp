@@ -8,8 +8,10 @@
 
 #include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ExecutionEngine/JITLink/EHFrameSupport.h"
+#include "llvm/Support/Debug.h"
 
 #include <vector>
 
@@ -475,5 +477,51 @@ Error LocalEHFrameRegistrationPlugin::notifyRemovingAllModules() {
   return Err;
 }
 
+void CCRShufflePlugin::modifyPassConfig(MaterializationResponsibility &MR,
+                                        const Triple &TT,
+                                        PassConfiguration &PassConfig) {
+  // After pruning, as only the live atoms take up room
+  PassConfig.PostPrunePasses.push_back(
+      [this](AtomGraph &G) { return shuffleAtoms(G); });
+}
+
+// The JITLinker lays out the chains of a section by the addresses of their
+// heads, therefore a permutation of those addresses is a new layout
+Error CCRShufflePlugin::shuffleAtoms(AtomGraph &G) {
+  for (auto &S : G.sections()) {
+    if (!(S.getProtectionFlags() & sys::Memory::MF_EXEC) || S.isZeroFill())
+      continue;
+
+    DenseSet<DefinedAtom *> Followers;
+    for (auto *DA : S.atoms())
+      if (DA->hasLayoutNext())
+        Followers.insert(&DA->getLayoutNext());
+    std::vector<DefinedAtom *> Heads;
+    for (auto *DA : S.atoms())
+      if (!Followers.count(DA))
+        Heads.push_back(DA);
+    if (Heads.size() < 2)
+      continue;
+
+    // The set iterates in pointer order; sort for a reproducible shuffle
+    llvm::sort(Heads, [](const DefinedAtom *LHS, const DefinedAtom *RHS) {
+      return LHS->getAddress() < RHS->getAddress();
+    });
+    std::vector<JITTargetAddress> Addrs;
+    for (auto *DA : Heads)
+      Addrs.push_back(DA->getAddress());
+    {
+      std::lock_guard<std::mutex> Lock(RNGMutex);
+      std::shuffle(Heads.begin(), Heads.end(), RNG);
+    }
+    for (size_t I = 0, E = Heads.size(); I != E; ++I)
+      Heads[I]->setAddress(Addrs[I]);
+
+    LLVM_DEBUG(dbgs() << "CCR: shuffled " << Heads.size()
+                      << " atom chains of section " << S.getName() << "\n");
+  }
+  return Error::success();
+}
+
 } // End namespace orc.
 } // End namespace llvm.
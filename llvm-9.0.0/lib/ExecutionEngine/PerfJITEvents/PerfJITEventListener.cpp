@@ -19,6 +19,7 @@
 #include "llvm/Config/config.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
+#include "llvm/ExecutionEngine/PerfJITRecords.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolSize.h"
 #include "llvm/Support/Debug.h"
@@ -46,16 +47,6 @@ namespace {
 // language identifier (XXX: should we generate something better from debug
 // info?)
 #define JIT_LANG "llvm-IR"
-#define LLVM_PERF_JIT_MAGIC                                                    \
-  ((uint32_t)'J' << 24 | (uint32_t)'i' << 16 | (uint32_t)'T' << 8 |            \
-   (uint32_t)'D')
-#define LLVM_PERF_JIT_VERSION 1
-
-// bit 0: set if the jitdump file is using an architecture-specific timestamp
-// clock source
-#define JITDUMP_FLAGS_ARCH_TIMESTAMP (1ULL << 0)
-
-struct LLVMPerfJitHeader;
 
 class PerfJITEventListener : public JITEventListener {
 public:
@@ -104,61 +95,8 @@ private:
   uint64_t CodeGeneration = 1;
 };
 
-// The following are POD struct definitions from the perf jit specification
-
-enum LLVMPerfJitRecordType {
-  JIT_CODE_LOAD = 0,
-  JIT_CODE_MOVE = 1, // not emitted, code isn't moved
-  JIT_CODE_DEBUG_INFO = 2,
-  JIT_CODE_CLOSE = 3,          // not emitted, unnecessary
-  JIT_CODE_UNWINDING_INFO = 4, // not emitted
-
-  JIT_CODE_MAX
-};
-
-struct LLVMPerfJitHeader {
-  uint32_t Magic;     // characters "JiTD"
-  uint32_t Version;   // header version
-  uint32_t TotalSize; // total size of header
-  uint32_t ElfMach;   // elf mach target
-  uint32_t Pad1;      // reserved
-  uint32_t Pid;
-  uint64_t Timestamp; // timestamp
-  uint64_t Flags;     // flags
-};
-
-// record prefix (mandatory in each record)
-struct LLVMPerfJitRecordPrefix {
-  uint32_t Id; // record type identifier
-  uint32_t TotalSize;
-  uint64_t Timestamp;
-};
-
-struct LLVMPerfJitRecordCodeLoad {
-  LLVMPerfJitRecordPrefix Prefix;
-
-  uint32_t Pid;
-  uint32_t Tid;
-  uint64_t Vma;
-  uint64_t CodeAddr;
-  uint64_t CodeSize;
-  uint64_t CodeIndex;
-};
-
-struct LLVMPerfJitDebugEntry {
-  uint64_t Addr;
-  int Lineno;  // source line number starting at 1
-  int Discrim; // column discriminator, 0 is default
-  // followed by null terminated filename, \xff\0 if same as previous entry
-};
-
-struct LLVMPerfJitRecordDebugInfo {
-  LLVMPerfJitRecordPrefix Prefix;
-
-  uint64_t CodeAddr;
-  uint64_t NrEntry;
-  // followed by NrEntry LLVMPerfJitDebugEntry records
-};
+// The POD struct definitions from the perf jit specification are in
+// llvm/ExecutionEngine/PerfJITRecords.h
 
 static inline uint64_t timespec_to_ns(const struct timespec *ts) {
   const uint64_t NanoSecPerSec = 1000000000;
@@ -28,6 +28,7 @@
 #include "llvm/LTO/LTOBackend.h"
 #include "llvm/LTO/SummaryBasedOptimizations.h"
 #include "llvm/Linker/IRMover.h"
+#include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ManagedStatic.h"
@@ -138,6 +139,9 @@ void llvm::computeLTOCacheKey(
   AddUnsigned(Conf.Freestanding);
   AddString(Conf.OptPipeline);
   AddString(Conf.AAPipeline);
+  // Koo: The CCR settings shape the .rand section of the cached object
+  AddString(MCAsmInfo::getRandSettingsKey());
+  AddUnsigned(Conf.Options.MCOptions.CCRMetadata);
   AddString(Conf.OverrideTriple);
   AddString(Conf.DefaultTriple);
   AddString(Conf.DwoDir);
@@ -143,8 +143,12 @@ createTargetMachine(Config &Conf, const Target *TheTarget, Module &M) {
   else
     CodeModel = M.getCodeModel();
 
+  // Koo: The CCR settings of the compile, even if the link does not tell them
+  TargetOptions Options = Conf.Options;
+  TargetMachine::applyCCRModuleFlags(M, Options);
+
   return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
-      TheTriple, Conf.CPU, Features.getString(), Conf.Options, RelocModel,
+      TheTriple, Conf.CPU, Features.getString(), Options, RelocModel,
       CodeModel, Conf.CGOptLevel));
 }
 
@@ -375,6 +379,10 @@ void splitCodeGen(Config &C, TargetMachine *TM, AddStreamFn AddStream,
                 report_fatal_error("Failed to read bitcode");
               std::unique_ptr<Module> MPartInCtx = std::move(MOrErr.get());
 
+              // Koo: A TargetMachine per partition gives each partition an
+              //      MCAsmInfo of its own; the CCR metadata (keyed by function
+              //      numbers that restart per partition) never mixes across
+              //      partitions, and every partition object has its own .rand
               std::unique_ptr<TargetMachine> TM =
                   createTargetMachine(C, T, *MPartInCtx);
 
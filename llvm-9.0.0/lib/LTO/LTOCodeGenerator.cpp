@@ -368,8 +368,11 @@ bool LTOCodeGenerator::determineTarget() {
 }
 
 std::unique_ptr<TargetMachine> LTOCodeGenerator::createTargetMachine() {
+  // Koo: The CCR settings of the compile, even if the link does not tell them
+  TargetOptions TMOptions = Options;
+  TargetMachine::applyCCRModuleFlags(*MergedModule, TMOptions);
   return std::unique_ptr<TargetMachine>(MArch->createTargetMachine(
-      TripleStr, MCpu, FeatureStr, Options, RelocModel, None, CGOptLevel));
+      TripleStr, MCpu, FeatureStr, TMOptions, RelocModel, None, CGOptLevel));
 }
 
 // If a linkonce global is present in the MustPreserveSymbols, we need to make
@@ -48,11 +48,14 @@
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SwapByteOrder.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
@@ -71,6 +74,12 @@ using SectionIndexMapTy = DenseMap<const MCSectionELF *, uint32_t>;
 class ELFObjectWriter;
 struct ELFWriter;
 
+// Koo: The contents of .rand, encoded (and compressed) apart from the writer
+struct RandSectionData {
+  SmallVector<char, 0> Uncompressed;
+  SmallVector<char, 0> Compressed; // Empty unless -ccr-compress-rand took
+};
+
 bool isDwoSection(const MCSectionELF &Sec) {
   return Sec.getSectionName().endswith(".dwo");
 }
@@ -149,6 +158,11 @@ struct ELFWriter {
 
   // Sections in the order they are to be output in the section table.
   std::vector<const MCSectionELF *> SectionTable;
+
+  // Koo: .rand, encoded on a helper thread while the sections before it are
+  //      written (see writeObject())
+  const MCSectionELF *AsyncRandSection = nullptr;
+  std::future<RandSectionData> AsyncRand;
   unsigned addToSectionTable(const MCSectionELF *Sec);
 
   // TargetObjectWriter wrappers.
@@ -270,6 +284,14 @@ public:
                         const MCFragment *Fragment, const MCFixup &Fixup,
                         MCValue Target, uint64_t &FixedValue) override;
 
+  // Koo: MIPS sorts its relocations when they are written (see sortRelocs())
+  Optional<uint64_t> getNumRelocations(const MCSection &Sec) const override {
+    if (TargetObjectWriter->getEMachine() == ELF::EM_MIPS)
+      return None;
+    auto It = Relocations.find(cast<MCSectionELF>(&Sec));
+    return It == Relocations.end() ? 0 : It->second.size();
+  }
+
   void executePostLayoutBinding(MCAssembler &Asm,
                                 const MCAsmLayout &Layout) override;
 
@@ -843,21 +865,54 @@ bool ELFWriter::maybeWriteCompression(
   return true;
 }
 
+static RandSectionData encodeRandSection(const MCAssembler &Asm,
+                                         const MCAsmLayout &Layout,
+                                         const MCSectionELF &Section) {
+  RandSectionData Data;
+  raw_svector_ostream VecOS(Data.Uncompressed);
+  Asm.WriteRandInfo(VecOS, Layout, &Section);
+  if (Asm.getContext().getAsmInfo()->CompressRandSection !=
+          DebugCompressionType::None &&
+      zlib::isAvailable()) {
+    if (Error E = zlib::compress(
+            StringRef(Data.Uncompressed.data(), Data.Uncompressed.size()),
+            Data.Compressed)) {
+      consumeError(std::move(E));
+      Data.Compressed.clear();
+    }
+  }
+  return Data;
+}
+
 void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
                                  const MCAsmLayout &Layout) {
   MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
   StringRef SectionName = Section.getSectionName();
   
+  auto &MC = Asm.getContext();
+  const auto &MAI = MC.getAsmInfo();
+
   // Koo: process the special section (.rand) to store the information for transformation
   if (SectionName.startswith(".rand")) {
-	std::string randContents = Asm.WriteRandInfo(Layout);
-	W.OS << randContents;
+    RandSectionData Data = &Section == AsyncRandSection
+                               ? AsyncRand.get()
+                               : encodeRandSection(Asm, Layout, Section);
+
+    // Same as the zlib style of debug section compression below:
+    // Elf_Chdr followed by the compressed metadata with SHF_COMPRESSED set
+    if (Data.Compressed.empty() ||
+        !maybeWriteCompression(Data.Uncompressed.size(), Data.Compressed,
+                               /*ZLibStyle=*/true, Sec.getAlignment())) {
+      W.OS << Data.Uncompressed;
+      return;
+    }
+
+    Section.setFlags(Section.getFlags() | ELF::SHF_COMPRESSED);
+    Section.setAlignment(is64Bit() ? 8 : 4);
+    W.OS << Data.Compressed;
     return;
   }
 
-  auto &MC = Asm.getContext();
-  const auto &MAI = MC.getAsmInfo();
-
   // Compressing debug_frame requires handling alignment fragments which is
   // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
   // for writing to arbitrary buffers) for little benefit.
@@ -1089,6 +1144,27 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
 
   std::map<const MCSymbol *, std::vector<const MCSectionELF *>> GroupMembers;
 
+  // Koo: The metadata is final after layout, thus .rand is encoded (and
+  //      compressed) on a helper thread while the sections before it are
+  //      written, and spliced in at its place. The encoder only reads the
+  //      layout and the MCReorderInfo; the time-trace profiler is not
+  //      thread-safe, hence it keeps the encoder on the writer thread.
+  for (MCSection &Sec : Asm) {
+    MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
+    if (Mode == DwoOnly || isDwoSection(Section) ||
+        !Section.getSectionName().startswith(".rand"))
+      continue;
+    AsyncRandSection = &Section;
+    AsyncRand = std::async(
+        llvm_is_multithreaded() && !timeTraceProfilerEnabled()
+            ? std::launch::async
+            : std::launch::deferred,
+        [&Asm, &Layout, &Section] {
+          return encodeRandSection(Asm, Layout, Section);
+        });
+    break;
+  }
+
   // Write out the ELF header ...
   writeHeader(Asm);
 
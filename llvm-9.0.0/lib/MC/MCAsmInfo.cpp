@@ -15,6 +15,7 @@
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCSectionELF.h"
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/Support/CommandLine.h"
 
@@ -28,6 +29,216 @@ static cl::opt<DefaultOnOff> DwarfExtendedLoc(
                clEnumVal(Enable, "Enabled"), clEnumVal(Disable, "Disabled")),
     cl::init(Default));
 
+// Koo: Emit the .rand section as SHF_COMPRESSED
+static cl::opt<DebugCompressionType> CCRCompressRand(
+    "ccr-compress-rand", cl::Hidden,
+    cl::desc("Compress the CCR reordering information (.rand) section."),
+    cl::values(clEnumValN(DebugCompressionType::None, "none", "No compression"),
+               clEnumValN(DebugCompressionType::Z, "zlib",
+                          "Use zlib compression (SHF_COMPRESSED)")),
+    cl::init(DebugCompressionType::None));
+
+// Koo: Nothing is collected for a build that is never randomized
+static cl::opt<bool> CCRMetadata(
+    "ccr-metadata", cl::Hidden,
+    cl::desc("Collect and emit the CCR reordering information (.rand) of "
+             "the object (clang -fccr-metadata)."),
+    cl::init(false));
+
+// Koo: Wire format of the .rand section (v1 keeps the old consumers working)
+static cl::opt<unsigned> CCRRandFormat(
+    "ccr-rand-format", cl::Hidden,
+    cl::desc("Wire format of the CCR reordering information (.rand): "
+             "1 = per-BBL/per-fixup messages, 2 = packed columns, "
+             "3 = packed columns in a relocatable chunk (merged by the "
+             "linker without decoding)."),
+    cl::init(1));
+
+// Koo: Emit d2d fixups as well (the randomizer never patches them)
+static cl::opt<bool> CCRKeepDataFixups(
+    "ccr-keep-data-fixups", cl::Hidden,
+    cl::desc("Emit the fixups of data sections that refer to data in the CCR "
+             "reordering information (.rand)."),
+    cl::init(false));
+
+// Koo: Give every garbage-collectible section its own .rand (format 3)
+static cl::opt<bool> CCRRandPerSection(
+    "ccr-rand-per-section", cl::Hidden,
+    cl::desc("Emit the CCR reordering information of each function or data "
+             "section in a .rand section linked to it (SHF_LINK_ORDER), so "
+             "that --gc-sections drops it along with the section. Requires "
+             "-ccr-rand-format=3."),
+    cl::init(false));
+
+// Koo: Tell the randomizer where the CFI and the LSDA call sites are (format 3)
+static cl::opt<bool> CCREHInfo(
+    "ccr-eh-info", cl::Hidden,
+    cl::desc("Describe the CFI instructions and the LSDA call-site tables by "
+             "BBL in the CCR reordering information (.rand), so that the "
+             "randomizer rewrites the exception tables of the functions whose "
+             "BBLs it shuffles. Requires -ccr-rand-format=3."),
+    cl::init(false));
+
+// Koo: Record the layout by function only; function-level shuffling needs no more
+enum CCRGranularityKind { CCRBBL, CCRFunction, CCRAuto };
+static cl::opt<CCRGranularityKind> CCRGranularity(
+    "ccr-granularity", cl::Hidden,
+    cl::desc("Granularity of the layout in the CCR reordering information "
+             "(.rand)."),
+    cl::values(clEnumValN(CCRBBL, "bbl", "A record per basic block (the default)"),
+               clEnumValN(CCRFunction, "function",
+                          "A record per function, for function-level "
+                          "shuffling only (without the fixups within "
+                          "a function)"),
+               clEnumValN(CCRAuto, "auto",
+                          "A record per function for the functions that "
+                          "the cost model finds too fine-grained (see "
+                          "-ccr-auto-granularity-*), a record per basic "
+                          "block for the others")),
+    cl::init(CCRBBL));
+
+// Koo: The cost model of -ccr-granularity=auto; a giant dispatcher, a state machine
+//      or a generated parser has thousands of tiny MBBs, whose records bloat .rand
+//      and whose shuffling breaks as many fall-throughs
+static cl::opt<unsigned> CCRAutoMaxMBBs(
+    "ccr-auto-granularity-max-mbbs", cl::Hidden,
+    cl::desc("Record a function with more basic blocks than this as a whole "
+             "(-ccr-granularity=auto)."),
+    cl::init(2000));
+
+static cl::opt<unsigned> CCRAutoMinMBBs(
+    "ccr-auto-granularity-min-mbbs", cl::Hidden,
+    cl::desc("Basic blocks a function needs before its average block size "
+             "or its jump table density is considered "
+             "(-ccr-granularity=auto)."),
+    cl::init(128));
+
+static cl::opt<unsigned> CCRAutoMinMBBInsts(
+    "ccr-auto-granularity-min-mbb-insts", cl::Hidden,
+    cl::desc("Record a function whose basic blocks have fewer instructions "
+             "than this on average as a whole (-ccr-granularity=auto)."),
+    cl::init(3));
+
+static cl::opt<unsigned> CCRAutoJumpTableDensity(
+    "ccr-auto-granularity-jump-table-density", cl::Hidden,
+    cl::desc("Record a function with this many jump table entries per 100 "
+             "basic blocks as a whole (-ccr-granularity=auto, 0 = off)."),
+    cl::init(50));
+
+static cl::opt<bool> CCRAutoHotness(
+    "ccr-auto-granularity-hotness", cl::Hidden,
+    cl::desc("Let the profile (if any) weigh in: a hot function is "
+             "considered with half the basic blocks, a cold one by its "
+             "number of basic blocks only (-ccr-granularity=auto)."),
+    cl::init(true));
+
+// Koo: Let the assembly (-S, -save-temps) tell the BBLs to the assembler
+static cl::opt<bool> CCRAsmDirectives(
+    "ccr-asm-directives", cl::Hidden,
+    cl::desc("Annotate the textual assembly with a .ccr_bbl directive per "
+             "basic block, so that the integrated assembler records the "
+             "blocks of the compiler in the CCR reordering information "
+             "(.rand) rather than splitting them at labels and terminators."),
+    cl::init(false));
+
+// Koo: A function of .rand is known by the hash of its symbol name in any case;
+//      the hash of its instructions tells whether a profile or a layout of
+//      another build still holds for it
+static cl::opt<bool> CCRFunctionHashes(
+    "ccr-function-hashes", cl::Hidden,
+    cl::desc("Record the hash of the instructions of every function in the "
+             "CCR reordering information (.rand), next to the hash of its "
+             "symbol name (format 2 or 3)."),
+    cl::init(false));
+
+// Koo: Diversify the layout at build time; the randomizer may shuffle further
+static cl::opt<uint64_t> CCRCompileSeed(
+    "ccr-compile-seed", cl::Hidden,
+    cl::desc("Permute the functions of every module and the cold block chains "
+             "of every function with this seed as they are compiled, thus the "
+             "objects come out randomized (0 = off)."),
+    cl::init(0));
+
+// Koo: Reorder the block chains at link time instead of rewriting the binary
+static cl::opt<bool> CCRChainSections(
+    "ccr-chain-sections", cl::Hidden,
+    cl::desc("Emit every block chain of MachineBlockPlacement but the entry "
+             "one into a section of its own (.text.<function>.<n>), with "
+             "explicit jumps at the chain boundaries, thus the linker may "
+             "reorder the chains."),
+    cl::init(false));
+
+// Koo: Leave to the linker what the relocations of the object tell anyway
+static cl::opt<bool> CCROmitRelocatedFixups(
+    "ccr-omit-relocated-fixups", cl::Hidden,
+    cl::desc("Leave out of the CCR reordering information (.rand) the fixups "
+             "that the object relocates (i.e., the calls to other sections "
+             "and the absolute pointers), which the linker synthesizes from "
+             "the relocations it processes anyway."),
+    cl::init(false));
+
+// Koo: An MBB that only its fall-through enters moves with the MBB before it anyway
+static cl::opt<bool> CCRCoalesceMBBs(
+    "ccr-coalesce-mbbs", cl::Hidden,
+    cl::desc("Record a run of basic blocks that fall into one another, where "
+             "nothing else enters any but the first, as a single basic block "
+             "in the CCR reordering information (.rand)."),
+    cl::init(true));
+
+// Koo: Bump whenever the reordering information of an object changes for the
+//      same settings, so that no cached object carries an outdated .rand section
+static const unsigned CCRMetadataRevision = 10;
+
+std::string MCAsmInfo::getRandSettingsKey() {
+  std::string AutoGranularityKey;
+  if (CCRGranularity == CCRAuto)
+    AutoGranularityKey = (".auto" + Twine(CCRAutoMaxMBBs) + "." +
+                          Twine(CCRAutoMinMBBs) + "." + Twine(CCRAutoMinMBBInsts) +
+                          "." + Twine(CCRAutoJumpTableDensity) + "." +
+                          Twine(unsigned(CCRAutoHotness)))
+                             .str();
+  return ("ccr." + Twine(CCRMetadataRevision) +
+          ".metadata" + Twine(unsigned(CCRMetadata)) +
+          ".format" + Twine(CCRRandFormat) +
+          ".compress" + Twine(unsigned(DebugCompressionType(CCRCompressRand))) +
+          ".keep-data-fixups" + Twine(unsigned(CCRKeepDataFixups)) +
+          ".per-section" + Twine(unsigned(CCRRandPerSection)) +
+          ".eh-info" + Twine(unsigned(CCREHInfo)) +
+          ".granularity" + Twine(unsigned(CCRGranularity)) +
+          AutoGranularityKey +
+          ".function-hashes" + Twine(unsigned(CCRFunctionHashes)) +
+          ".compile-seed" + Twine(uint64_t(CCRCompileSeed)) +
+          ".chain-sections" + Twine(unsigned(CCRChainSections)) +
+          ".omit-relocated-fixups" + Twine(unsigned(CCROmitRelocatedFixups)) +
+          ".coalesce-mbbs" + Twine(unsigned(CCRCoalesceMBBs)) +
+          ".fixup-sections" + getCustomFixupSectionsKey())
+      .str();
+}
+
+void MCAsmInfo::getRandOptions(MCTargetOptions &Options) {
+  Options.CCRMetadata = Options.CCRMetadata || CCRMetadata;
+  Options.CCRGranularity = CCRGranularity == CCRFunction ? 1
+                           : CCRGranularity == CCRAuto   ? 2
+                                                         : 3;
+  Options.CCRRandFormat = CCRRandFormat;
+  Options.CCRRelocatedFixups = CCROmitRelocatedFixups ? 1 : 2;
+}
+
+void MCAsmInfo::setRandOptions(const MCTargetOptions &Options) {
+  if (Options.CCRMetadata)
+    RandMetadata = true;
+  if (Options.CCRGranularity) {
+    RandGranularity = Options.CCRGranularity == 1
+                          ? MCMBBInfo::GranularityFunction
+                          : MCMBBInfo::GranularityBBL;
+    RandAutoGranularity = Options.CCRGranularity == 2;
+  }
+  if (Options.CCRRandFormat)
+    RandFormatVersion = Options.CCRRandFormat;
+  if (Options.CCRRelocatedFixups)
+    OmitRelocatedFixups = Options.CCRRelocatedFixups == 1;
+}
+
 MCAsmInfo::MCAsmInfo() {
   SeparatorString = ";";
   CommentString = "#";
@@ -51,6 +262,26 @@ MCAsmInfo::MCAsmInfo() {
   WeakDirective = "\t.weak\t";
   if (DwarfExtendedLoc != Default)
     SupportsExtendedDwarfLocDirective = DwarfExtendedLoc == Enable;
+  RandMetadata = CCRMetadata;
+  CompressRandSection = CCRCompressRand;
+  RandFormatVersion = CCRRandFormat;
+  KeepDataFixups = CCRKeepDataFixups;
+  RandPerSection = CCRRandPerSection;
+  RandEHInfo = CCREHInfo;
+  RandGranularity = CCRGranularity == CCRFunction ? MCMBBInfo::GranularityFunction
+                                                  : MCMBBInfo::GranularityBBL;
+  RandAutoGranularity = CCRGranularity == CCRAuto;
+  RandAutoMaxMBBs = CCRAutoMaxMBBs;
+  RandAutoMinMBBs = CCRAutoMinMBBs;
+  RandAutoMinMBBInsts = CCRAutoMinMBBInsts;
+  RandAutoJumpTableDensity = CCRAutoJumpTableDensity;
+  RandAutoHotness = CCRAutoHotness;
+  RandAsmDirectives = CCRAsmDirectives;
+  RandFunctionHashes = CCRFunctionHashes;
+  RandCompileSeed = CCRCompileSeed;
+  RandChainSections = CCRChainSections;
+  OmitRelocatedFixups = CCROmitRelocatedFixups;
+  RandCoalesceMBBs = CCRCoalesceMBBs;
 
   // FIXME: Clang's logic should be synced with the logic used to initialize
   //        this member and the two implementations should be merged.
@@ -70,6 +301,23 @@ MCAsmInfo::MCAsmInfo() {
 
 MCAsmInfo::~MCAsmInfo() = default;
 
+// Koo: A section other than the default one of its kind (i.e., .text.foo of
+//      -ffunction-sections or .rodata.bar of -fdata-sections) may be collected
+//      by the linker; the init/fini arrays never are
+bool MCAsmInfo::hasLinkedRandSection(const MCSectionELF &Sec) const {
+  if (!RandPerSection || RandFormatVersion < 3)
+    return false;
+  MCFixupSectionKind Kind = Sec.getFixupSectionKind();
+  if (Kind >= NumFixupSectionKinds || Kind == FSK_InitArray ||
+      Kind == FSK_FiniArray)
+    return false;
+  // The sections from xray_instr_map on have no default one of their kind
+  if (Kind >= FSK_XRay)
+    return Sec.isUnique();
+  return Sec.isUnique() ||
+         Sec.getSectionName() != ("." + getFixupSectionKindName(Kind)).str();
+}
+
 void MCAsmInfo::addInitialFrameState(const MCCFIInstruction &Inst) {
   InitialFrameState.push_back(Inst);
 }
@@ -308,6 +308,9 @@ public:
   void emitCGProfileEntry(const MCSymbolRefExpr *From,
                           const MCSymbolRefExpr *To, uint64_t Count) override;
 
+  void EmitCCRBasicBlock(unsigned MFID, unsigned MBBID, unsigned Flags,
+                         unsigned AlignLog2, unsigned EdgeProb) override;
+
   void EmitInstruction(const MCInst &Inst, const MCSubtargetInfo &STI) override;
 
   void EmitBundleAlignMode(unsigned AlignPow2) override;
@@ -1735,6 +1738,14 @@ void MCAsmStreamer::emitCGProfileEntry(const MCSymbolRefExpr *From,
   EmitEOL();
 }
 
+void MCAsmStreamer::EmitCCRBasicBlock(unsigned MFID, unsigned MBBID,
+                                      unsigned Flags, unsigned AlignLog2,
+                                      unsigned EdgeProb) {
+  OS << "\t.ccr_bbl\t" << MFID << ", " << MBBID << ", " << Flags << ", "
+     << AlignLog2 << ", " << EdgeProb;
+  EmitEOL();
+}
+
 void MCAsmStreamer::AddEncodingComment(const MCInst &Inst,
                                        const MCSubtargetInfo &STI) {
   raw_ostream &OS = GetCommentOS();
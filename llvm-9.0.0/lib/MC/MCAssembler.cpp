@@ -8,11 +8,15 @@
 
 #include "llvm/MC/MCAssembler.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/RandChunk.h"
 #include "llvm/MC/MCAsmBackend.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/MC/MCAsmLayout.h"
@@ -34,8 +38,12 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -45,13 +53,14 @@
 // Koo
 #include "llvm/MC/MCObjectFileInfo.h"
 #include "llvm/Support/shuffleInfo.pb.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <iomanip>
 #include <map>
-#include <set>
 
 using namespace llvm;
 
@@ -80,6 +89,28 @@ STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
 STATISTIC(PaddingFragmentsRelaxations,
           "Number of Padding Fragments relaxations");
+// Koo: The CCR metadata, which -stats and -stats-json report in release builds too
+STATISTIC(RandBBLs, "Number of BBLs described in .rand sections");
+STATISTIC(RandTextFixups, "Number of .text fixups described in .rand sections");
+STATISTIC(RandRodataFixups, "Number of .rodata fixups described in .rand sections");
+STATISTIC(RandDataFixups, "Number of .data/.data.rel.ro/.init_array/.fini_array fixups "
+                          "described in .rand sections");
+STATISTIC(RandTLSFixups, "Number of .tdata fixups described in .rand sections");
+STATISTIC(RandXRayFixups, "Number of xray_instr_map fixups described in .rand sections");
+STATISTIC(RandOtherFixups, "Number of __patchable_function_entries/__jump_table/"
+                           "-ccr-fixup-section fixups described in .rand sections");
+STATISTIC(RandJumpTables, "Number of jump tables whose entries are described in .rand");
+STATISTIC(RandCallSiteTables, "Number of LSDA call-site tables described in .rand");
+STATISTIC(RandBytes, "Number of emitted .rand bytes (before compression)");
+STATISTIC(RandFoldedBBLs, "Number of MBBs folded into the layout record of their "
+                          "function by ccr_granularity");
+STATISTIC(RandPinnedFunctions, "Number of functions pinned by ccr_granularity");
+STATISTIC(RandIntraFunctionFixups, "Number of intra-function .text fixups left out "
+                                   "of .rand since their functions move as a whole");
+STATISTIC(RandRelocatedFixups, "Number of relocated fixups left out of .rand for the "
+                               "linker to synthesize (-ccr-omit-relocated-fixups)");
+STATISTIC(RandPreFuncBytes, "Number of data bytes ahead of the first function "
+                            "attributed to the first BBL");
 STATISTIC(PaddingFragmentsBytes,
           "Total size of all padding from adding Fragments");
 
@@ -772,31 +803,264 @@ MCAssembler::handleFixup(const MCAsmLayout &Layout, MCFragment &F,
 
 // Koo: Dump all fixups if necessary 
 //      In .text, .rodata, .data, .data.rel.ro, .eh_frame, and debugging sections
-void dumpFixups(std::list<std::tuple<unsigned, unsigned, bool, std::string, std::string, bool, std::string, unsigned, unsigned>> \
-                Fixups, std::string kind, bool isDebug) {
+static void dumpFixups(const std::vector<MCFixupRecord> &Fixups, StringRef kind, bool isDebug) {
   if (Fixups.size() > 0) {
     DEBUG_WITH_TYPE("ccr-metadata", dbgs() << " - Fixups Info (." << kind << "): " << Fixups.size() << "\n");
-    unsigned offset, size, numJTEntries, JTEntrySize;
-    bool isRel, isNewSection;
-    std::string FixupParentID, SymbolRefFixupName, sectionName;
-
-    for (auto it = Fixups.begin(); it != Fixups.end(); ++it) {
-      std::tie(offset, size, isRel, FixupParentID, SymbolRefFixupName, isNewSection, sectionName, numJTEntries, JTEntrySize) = *it;
-      char isRelTF = isRel ? 'T' : 'F';
-      if (isDebug && SymbolRefFixupName.length() > 0) {
-        errs() << "\t[" << FixupParentID << "]\t(" << offset << ", "  << size << ", " << isRelTF;
-        if (SymbolRefFixupName.length() > 0)
-          errs() << ", JT#" << SymbolRefFixupName;
+
+    for (const MCFixupRecord &F : Fixups) {
+      char isRelTF = F.IsRela ? 'T' : 'F';
+      if (isDebug && F.JumpTableRef.isValid()) {
+        errs() << "\t[" << F.ParentID << "]\t(" << F.Offset << ", "  << unsigned(F.DerefSize) << ", " << isRelTF;
+        errs() << ", JT#" << F.JumpTableRef;
         errs() << ")\n";
       }
     }
   }
 }
 
-// Koo: Helper function to separate ID into MFID and MBBID
-std::tuple<int, int> separateID(std::string ID) {
-  return std::make_tuple(std::stoi(ID.substr(0, ID.find("_"))), \
-                         std::stoi(ID.substr(ID.find("_") + 1, ID.length())));
+// Koo: Tell whether a symbol of a fixup target lives in code or data. A symbol
+//      that is not defined in this object may well be a function.
+static MCFixupTargetKind getSymbolTargetKind(const MCSymbolRefExpr *Ref) {
+  if (!Ref)
+    return FTK_Data;
+  const MCSymbol &Sym = Ref->getSymbol();
+  if (!Sym.isInSection())
+    return Sym.isAbsolute() ? FTK_Data : FTK_Unknown;
+  return Sym.getSection().getKind().isText() ? FTK_Code : FTK_Data;
+}
+
+// Koo: Classify the target (A - B + C) of a fixup; the value moves along with
+//      the code if either symbol does (i.e., .LBB0_3-.LJTI0_0 of a jump table)
+static MCFixupTargetKind getFixupTargetKind(const MCValue &Target) {
+  MCFixupTargetKind A = getSymbolTargetKind(Target.getSymA());
+  MCFixupTargetKind B = getSymbolTargetKind(Target.getSymB());
+  if (A == FTK_Code || B == FTK_Code)
+    return FTK_Code;
+  if (A == FTK_Unknown || B == FTK_Unknown)
+    return FTK_Unknown;
+  return FTK_Data;
+}
+
+// Koo: Whether the target (A - B + C) is the distance between two symbols of
+//      the same section
+static bool isIntraSectionDifference(const MCValue &Target) {
+  const MCSymbolRefExpr *A = Target.getSymA(), *B = Target.getSymB();
+  return A && B && A->getSymbol().isInSection() && B->getSymbol().isInSection() &&
+         &A->getSymbol().getSection() == &B->getSymbol().getSection();
+}
+
+// Koo: Where the target of a .text fixup lives; the intra-function ones among those
+//      in the object are told once the layout is final (see classifyTextFixupScopes())
+static MCFixupScope getFixupScope(const MCValue &Target) {
+  const MCSymbolRefExpr *Ref = Target.getSymA();
+  if (!Ref || !Ref->getSymbol().isInSection())
+    return FSC_External;
+  return FSC_IntraObject;
+}
+
+// Koo: Classify how a fixup refers to its target, which the randomizer needs for
+//      PIC code (i.e., a shared object): a TP/DTP offset is no address at all, and
+//      the value of a TLS model that refers to the GOT may be replaced by one by
+//      the linker (i.e., GD/IE to LE relaxation in an executable)
+static MCFixupRefClass getFixupRefClass(const MCValue &Target) {
+  const MCSymbolRefExpr *Ref = Target.getSymA();
+  if (!Ref)
+    return FRC_Direct;
+  switch (Ref->getKind()) {
+  case MCSymbolRefExpr::VK_PLT:
+    return FRC_PLT;
+  case MCSymbolRefExpr::VK_GOT:
+  case MCSymbolRefExpr::VK_GOTOFF:
+  case MCSymbolRefExpr::VK_GOTREL:
+  case MCSymbolRefExpr::VK_GOTPCREL:
+  // The TOC of PPC64 is its GOT, at .TOC. - 0x8000
+  case MCSymbolRefExpr::VK_PPC_GOT_LO:
+  case MCSymbolRefExpr::VK_PPC_GOT_HI:
+  case MCSymbolRefExpr::VK_PPC_GOT_HA:
+  case MCSymbolRefExpr::VK_PPC_TOCBASE:
+  case MCSymbolRefExpr::VK_PPC_TOC:
+  case MCSymbolRefExpr::VK_PPC_TOC_LO:
+  case MCSymbolRefExpr::VK_PPC_TOC_HI:
+  case MCSymbolRefExpr::VK_PPC_TOC_HA:
+    return FRC_GOT;
+  case MCSymbolRefExpr::VK_GOTTPOFF:
+  case MCSymbolRefExpr::VK_INDNTPOFF:
+  case MCSymbolRefExpr::VK_NTPOFF:
+  case MCSymbolRefExpr::VK_GOTNTPOFF:
+  case MCSymbolRefExpr::VK_TLSGD:
+  case MCSymbolRefExpr::VK_TLSLD:
+  case MCSymbolRefExpr::VK_TLSLDM:
+  case MCSymbolRefExpr::VK_TPOFF:
+  case MCSymbolRefExpr::VK_DTPOFF:
+  case MCSymbolRefExpr::VK_TLSCALL:
+  case MCSymbolRefExpr::VK_TLSDESC:
+  case MCSymbolRefExpr::VK_PPC_DTPMOD:
+  case MCSymbolRefExpr::VK_PPC_TPREL_LO:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HI:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HIGH:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HIGHA:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HIGHER:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HIGHERA:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HIGHEST:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HIGHESTA:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_LO:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HI:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HIGH:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HIGHA:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HIGHER:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HIGHERA:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HIGHEST:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HIGHESTA:
+  case MCSymbolRefExpr::VK_PPC_GOT_TPREL:
+  case MCSymbolRefExpr::VK_PPC_GOT_TPREL_LO:
+  case MCSymbolRefExpr::VK_PPC_GOT_TPREL_HI:
+  case MCSymbolRefExpr::VK_PPC_GOT_TPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_GOT_DTPREL:
+  case MCSymbolRefExpr::VK_PPC_GOT_DTPREL_LO:
+  case MCSymbolRefExpr::VK_PPC_GOT_DTPREL_HI:
+  case MCSymbolRefExpr::VK_PPC_GOT_DTPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_TLS:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSGD:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSGD_LO:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSGD_HI:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSGD_HA:
+  case MCSymbolRefExpr::VK_PPC_TLSGD:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSLD:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSLD_LO:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSLD_HI:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSLD_HA:
+  case MCSymbolRefExpr::VK_PPC_TLSLD:
+    return FRC_TLS;
+  default:
+    return FRC_Direct;
+  }
+}
+
+// Koo: The high adjusted half (@ha) that goes with the low half (@l) of a split
+//      immediate, or VK_Invalid. The @ha half takes the carry of the sign-extended
+//      @l half, thus the two are patched as one value (i.e., addis/addi of PPC64).
+static MCSymbolRefExpr::VariantKind getHighAdjustedKind(MCSymbolRefExpr::VariantKind Lo) {
+  switch (Lo) {
+  case MCSymbolRefExpr::VK_PPC_LO:           return MCSymbolRefExpr::VK_PPC_HA;
+  case MCSymbolRefExpr::VK_PPC_GOT_LO:       return MCSymbolRefExpr::VK_PPC_GOT_HA;
+  case MCSymbolRefExpr::VK_PPC_TOC_LO:       return MCSymbolRefExpr::VK_PPC_TOC_HA;
+  case MCSymbolRefExpr::VK_PPC_TPREL_LO:     return MCSymbolRefExpr::VK_PPC_TPREL_HA;
+  case MCSymbolRefExpr::VK_PPC_DTPREL_LO:    return MCSymbolRefExpr::VK_PPC_DTPREL_HA;
+  case MCSymbolRefExpr::VK_PPC_GOT_TPREL_LO: return MCSymbolRefExpr::VK_PPC_GOT_TPREL_HA;
+  case MCSymbolRefExpr::VK_PPC_GOT_DTPREL_LO: return MCSymbolRefExpr::VK_PPC_GOT_DTPREL_HA;
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSGD_LO: return MCSymbolRefExpr::VK_PPC_GOT_TLSGD_HA;
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSLD_LO: return MCSymbolRefExpr::VK_PPC_GOT_TLSLD_HA;
+  default:                                   return MCSymbolRefExpr::VK_Invalid;
+  }
+}
+
+namespace {
+// Koo: The @ha halves of a section that a later @l half may go with: one @ha
+//      (addis) often serves several @l halves (loads and stores off its result)
+class HighHalfTracker {
+  struct HighHalf {
+    MCSymbolRefExpr::VariantKind Kind;
+    const MCSymbol *SymA;
+    const MCSymbol *SymB;
+    int64_t Constant;
+    unsigned FixupIdx;
+  };
+  std::vector<HighHalf> Pending; // In ascending FixupIdx
+
+public:
+  void reset() { Pending.clear(); }
+
+  // The PairDelta of the FixupIdx-th fixup of a section list, which refers to
+  // Target; remembers it if it is a high adjusted half itself
+  uint8_t visit(const MCValue &Target, unsigned FixupIdx);
+};
+} // end anonymous namespace
+
+uint8_t HighHalfTracker::visit(const MCValue &Target, unsigned FixupIdx) {
+  const MCSymbolRefExpr *A = Target.getSymA();
+  if (!A)
+    return 0;
+  // Those too far back for a PairDelta byte never pair again
+  while (!Pending.empty() && FixupIdx - Pending.front().FixupIdx > UINT8_MAX)
+    Pending.erase(Pending.begin());
+
+  const MCSymbol *B = Target.getSymB() ? &Target.getSymB()->getSymbol() : nullptr;
+  MCSymbolRefExpr::VariantKind Hi = getHighAdjustedKind(A->getKind());
+  if (Hi != MCSymbolRefExpr::VK_Invalid) {
+    for (auto It = Pending.rbegin(), E = Pending.rend(); It != E; ++It)
+      if (It->Kind == Hi && It->SymA == &A->getSymbol() && It->SymB == B &&
+          It->Constant == Target.getConstant())
+        return FixupIdx - It->FixupIdx;
+    return 0;
+  }
+
+  switch (A->getKind()) {
+  case MCSymbolRefExpr::VK_PPC_HA:
+  case MCSymbolRefExpr::VK_PPC_GOT_HA:
+  case MCSymbolRefExpr::VK_PPC_TOC_HA:
+  case MCSymbolRefExpr::VK_PPC_TPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_DTPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_GOT_TPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_GOT_DTPREL_HA:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSGD_HA:
+  case MCSymbolRefExpr::VK_PPC_GOT_TLSLD_HA:
+    Pending.push_back({A->getKind(), &A->getSymbol(), B, Target.getConstant(), FixupIdx});
+    break;
+  default:
+    break;
+  }
+  return 0;
+}
+
+// Koo: Record the long form of a short PC-relative branch that has not been
+//      relaxed. Only a single displacement that ends the instruction in both
+//      forms (jmp/jcc rel8 -> rel32) is recorded.
+static void recordRelaxation(const MCAssembler &Asm, const MCRelaxableFragment &RF,
+                             const MCFixup &Fixup, MCFixupRecord &FR) {
+  const MCSubtargetInfo &STI = *RF.getSubtargetInfo();
+  if (!FR.IsRela || !Asm.getBackend().mayNeedRelaxation(RF.getInst(), STI))
+    return;
+
+  MCInst Relaxed;
+  Asm.getBackend().relaxInstruction(RF.getInst(), STI, Relaxed);
+  SmallVector<MCFixup, 4> Fixups;
+  SmallString<16> Code;
+  raw_svector_ostream VecOS(Code);
+  Asm.getEmitter().encodeInstruction(Relaxed, VecOS, Fixups, STI);
+
+  unsigned ShortSize = RF.getContents().size();
+  if (Fixups.size() != 1 || Code.size() <= ShortSize ||
+      Code.size() > sizeof(FR.RelaxLongForm) ||
+      Fixup.getOffset() + FR.DerefSize != ShortSize ||
+      Fixups[0].getOffset() +
+              Asm.getBackend().getFixupKindLog2Size(Fixups[0].getKind()) !=
+          Code.size())
+    return;
+
+  FR.RelaxShortSize = ShortSize;
+  FR.RelaxLongSize = Code.size();
+  FR.RelaxFixupOffset = Fixups[0].getOffset();
+  memcpy(FR.RelaxLongForm, Code.data(), Code.size());
+}
+
+// Koo: Record the short form of a long PC-relative branch that the assembler
+//      has relaxed: a rel8 displacement that ends the short instruction, and a
+//      single one that ends the long instruction (jmp/jcc rel32 -> rel8).
+static void recordShrink(const MCRelaxableFragment &RF, const MCFixup &Fixup,
+                         MCFixupRecord &FR) {
+  StringRef Short = RF.getShortForm();
+  unsigned LongSize = RF.getContents().size();
+  if (!FR.IsRela || Short.empty() || RF.getFixups().size() != 1 ||
+      FR.DerefSize != 4 || Fixup.getOffset() + FR.DerefSize != LongSize ||
+      Short.size() >= LongSize || Short.size() > sizeof(FR.ShrinkShortForm) ||
+      LongSize > UINT8_MAX)
+    return;
+
+  FR.ShrinkLongSize = LongSize;
+  FR.ShrinkShortSize = Short.size();
+  memcpy(FR.ShrinkShortForm, Short.data(), Short.size());
 }
 
 // Koo: Convert int into hex (0x00abcdef)
@@ -808,162 +1072,160 @@ std::string hexlify(T i) {
     return buf.str();
 }
 
-// Koo: Final value updates for the entire layout of both MFs and MBBs
-void updateReorderInfoValues(const MCAsmLayout &Layout) {
-  const MCAsmInfo *MAI = Layout.getAssembler().getContext().getAsmInfo();
-  const MCObjectFileInfo *MOFI = Layout.getAssembler().getContext().getObjectFileInfo();
-  std::map<std::string, std::tuple<unsigned, unsigned, std::list<std::string>>> \
-        jumpTables = MOFI->getJumpTableTargets();
-
-  // Show both MF and MBB offsets according to the final layout order
-  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\n<MF/MBB Layout Summary>\n");
-  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
-  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << " Layout\tMF_MBB_ID\tMBBSize\tAlign\tFixups\tOffset   \tMFSize\tSection\n");
+// Koo: Place the MBBs of a .text fragment in the layout order when they first show up
+//      (see MCAssembler::layout()). An MBB that has been placed already has its section,
+//      which makes the flat MBB table the visited set.
+static void placeMBB(MCReorderInfo &RI, MCMBBKey ID, unsigned sectionIdx) {
+  if (!ID.isValid()) {
+    if (RI.MachineBasicBlocks[ID].Size > 0)
+      llvm_unreachable("[CCR-Error] MCAssembler(placeMBB) - MCSomething went wrong in MCFragment: MBB size > 0 with no parentID?");
+    return;
+  }
 
-  // Deal with MFs and MBBs in a ELF code section (.text) only
-  for (MCSection &Sec : Layout.getAssembler()) {
-    MCSectionELF &ELFSec = static_cast<MCSectionELF &>(Sec);
-    std::string tmpSN, sectionName = ELFSec.getSectionName();
-    if (sectionName.find(".text") == 0) {
-      unsigned totalOffset = 0, totalFixups = 0, totalAlignSize = 0;
-      int MFID, MBBID, prevMFID = -1;
-      std::string prevID, canFallThrough;
-      unsigned MBBSize, MBBOffset, numFixups, alignSize, MBBType;
-      std::set<std::string> countedMBBs;
-
-      // Per each fragment in a .text section
-      for (MCFragment &MCF : Sec) {
-        // Here MCDataFragment has combined with the following MCRelaxableFragment or MCAlignFragment
-        // Corner case: MCDataFragment with no instruction - just skip it
-        if (isa<MCDataFragment>(MCF) && MCF.hasInstructions()) {
-
-        // Update the MBB offset and MF Size for all collected MBBs in the MF
-          for (std::string ID : MCF.getAllMBBs()) {
-            if (ID.length() == 0 && std::get<0>(MAI->MachineBasicBlocks[ID]) > 0)
-              llvm_unreachable("[CCR-Error] MCAssembler(updateReorderInfoValues) - MCSomething went wrong in MCRelaxableFragment: MBB size > 0 with no parentID?");
-
-            if (countedMBBs.find(ID) == countedMBBs.end() && ID.length() > 0) {
-              bool isStartMF = false; // check if the new MF begins
-              std::tie(MFID, MBBID) = separateID(ID);
-              std::tie(MBBSize, MBBOffset, numFixups, alignSize, MBBType, tmpSN) = MAI->MachineBasicBlocks[ID];
-
-              if (tmpSN.length() > 0) continue;
-              MAI->MBBLayoutOrder.push_back(ID);
-
-              // Handle a corner case: see handleDirectEmitDirectives() in AsmParser.cpp
-              if (MAI->specialCntPriorToFunc > 0) {
-                MAI->updateByteCounter(ID, MAI->specialCntPriorToFunc, /*numFixups=*/ 0, /*isAlign=*/ false, /*isInline=*/ false);
-                MBBSize += MAI->specialCntPriorToFunc;
-                MAI->specialCntPriorToFunc = 0;
-              }
+  MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+  if (MBB.hasSection())
+    return;
+  MBB.SectionIdx = sectionIdx;
+  RI.MBBLayoutOrder.push_back(ID);
+
+  // Handle a corner case: see handleDirectEmitDirectives() in AsmParser.cpp
+  if (RI.specialCntPriorToFunc > 0) {
+    stats::RandPreFuncBytes += RI.specialCntPriorToFunc;
+    RI.updateByteCounter(ID, RI.specialCntPriorToFunc, /*numFixups=*/ 0, /*isAlign=*/ false);
+    RI.specialCntPriorToFunc = 0;
+  }
+}
 
-              // Update the MBB offset, MF Size and section name accordingly
-              std::get<1>(MAI->MachineBasicBlocks[ID]) = totalOffset;
-              totalOffset += MBBSize;
-              totalFixups += numFixups;
-              totalAlignSize += alignSize;
-              countedMBBs.insert(ID);
-              MAI->MachineFunctionSizes[MFID] += MBBSize;
-              std::get<5>(MAI->MachineBasicBlocks[ID]) = sectionName;
-              canFallThrough = MAI->canMBBFallThrough[ID] ? "*":"";
-
-              if (MFID > prevMFID) {
-                isStartMF = true;
-                std::get<4>(MAI->MachineBasicBlocks[prevID]) = 1; // Type = End of the function
-              }
+// Koo: A function at ccr_granularity("function" | "none") moves as a whole, thus the
+//      MBBs it has in a section are folded into the first one: that record takes their
+//      bytes and fixups, and the padding after the last one as its trailing padding.
+//      The folded MBBs simply leave the layout order; their keys stay valid for the
+//      fixups and the jump tables that refer to them.
+static void coarsenReorderLayout(MCReorderInfo &RI, std::vector<unsigned> &sectionStarts) {
+  if (RI.MachineFunctionGranularities.empty())
+    return;
 
-              unsigned layoutID = MCF.getLayoutOrder();
-              if (isStartMF) 
-                DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
-              DEBUG_WITH_TYPE("ccr-metadata", dbgs() << " " << layoutID << "\t[DF " << ID << "]" << canFallThrough << "\t" << MBBSize << "B\t" \
-                     << alignSize << "B\t" << numFixups << "\t" << hexlify(totalOffset) << "\t" \
-                     << MAI->MachineFunctionSizes[MFID] << "B\t" << "(" << sectionName << ")\n");
+  std::vector<MCMBBKey> &layoutOrder = RI.MBBLayoutOrder;
+  unsigned numKept = 0, s = 0, e = layoutOrder.size();
+  bool folding = false; // Into headID, the first MBB of a coarse MF in this section
+  MCMBBKey headID;
+  for (unsigned i = 0; i != e; ++i) {
+    bool isNewSection = false;
+    while (s < sectionStarts.size() && sectionStarts[s] == i) {
+      sectionStarts[s++] = numKept;
+      isNewSection = true;
+    }
 
-              prevMFID = MFID;
-              prevID = ID;
-            }
-          }
-        }
+    MCMBBKey ID = layoutOrder[i];
+    if (folding && !isNewSection && ID.getMFID() == headID.getMFID()) {
+      const MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+      MCMBBInfo &Head = RI.MachineBasicBlocks[headID];
+      Head.Size += MBB.Size;
+      Head.NumFixups += MBB.NumFixups;
+      Head.Alignments = MBB.Alignments;
+      Head.FallThrough = MBB.FallThrough;
+      Head.HasCFI |= MBB.HasCFI;
+      Head.TermSize = MBB.TermSize;
+      Head.TermKind = MBB.TermKind;
+      stats::RandFoldedBBLs++;
+      continue;
+    }
 
-        // Check out MCRelaxableFragments, which have not combined with any MCDataFragment
-        // It happens when there are consecutive MCRelaxableFragment (i.e., switch/case)
-        if (isa<MCRelaxableFragment>(MCF) && MCF.hasInstructions()) {
-          MCRelaxableFragment &MCRF = static_cast<MCRelaxableFragment&>(MCF);
-          std::string ID = MCRF.getInst().getParent();
-
-          if (ID.length() == 0 && std::get<0>(MAI->MachineBasicBlocks[ID]) > 0)
-              llvm_unreachable("[CCR-Error] MCAssembler(updateReorderInfoValues) - MCSomething went wrong in MCRelaxableFragment: MBB size > 0 with no parentID?");
-
-          // If yet the ID has not been showed up along with getAllMBBs(), 
-          // it would be an independent RF that does not belong to any DF
-          if (countedMBBs.find(ID) == countedMBBs.end() && ID.length() > 0) {
-            bool isStartMF = false;
-            std::tie(MFID, MBBID) = separateID(ID);
-            std::tie(MBBSize, MBBOffset, numFixups, alignSize, MBBType, tmpSN) = MAI->MachineBasicBlocks[ID];
-
-            if (tmpSN.length() > 0) continue;
-            MAI->MBBLayoutOrder.push_back(ID);
-
-            // Update the MBB offset, MF Size and section name accordingly
-            std::get<1>(MAI->MachineBasicBlocks[ID]) = totalOffset;
-            totalOffset += MBBSize;
-            totalFixups += numFixups;
-            totalAlignSize += alignSize;
-            countedMBBs.insert(ID);
-            MAI->MachineFunctionSizes[MFID] += MBBSize;
-            std::get<5>(MAI->MachineBasicBlocks[ID]) = sectionName;
-            canFallThrough = MAI->canMBBFallThrough[ID] ? "*":"";
-
-            if (MFID > prevMFID) {
-              isStartMF = true;
-              std::get<4>(MAI->MachineBasicBlocks[prevID]) = 1; // Type = End of the function
-            }
+    auto G = RI.MachineFunctionGranularities.find(ID.getMFID());
+    folding = G != RI.MachineFunctionGranularities.end();
+    if (folding) {
+      headID = ID;
+      RI.MachineBasicBlocks[ID].Pinned = G->second == MCMBBInfo::GranularityNone;
+      if (G->second == MCMBBInfo::GranularityNone)
+        stats::RandPinnedFunctions++;
+    }
+    layoutOrder[numKept++] = ID;
+  }
+  // The (empty) sections that start past the last MBB
+  while (s < sectionStarts.size())
+    sectionStarts[s++] = numKept;
+  layoutOrder.resize(numKept);
+}
 
-            unsigned layoutID = MCF.getLayoutOrder();
-            if (isStartMF) 
-              DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
-            DEBUG_WITH_TYPE("ccr-metadata", dbgs() << " " << layoutID << "\t[DF " << ID << "]" << canFallThrough << "\t" << MBBSize << "B\t" \
-                     << alignSize << "B\t" << numFixups << "\t" << hexlify(totalOffset) << "\t" \
-                     << MAI->MachineFunctionSizes[MFID] << "B\t" << "(" << sectionName << ")\n");
+// Koo: Final value updates for the entire layout of both MFs and MBBs
+//      The sizes are final only after the fragment traversal, where the alignment that
+//      follows an MBB has been attributed to it, thus this walks MBBLayoutOrder once
+//      per .text section (starting at sectionStarts) rather than the fragments again.
+static void finalizeReorderLayout(const MCAsmLayout &Layout, ArrayRef<unsigned> sectionStarts) {
+  TimeTraceScope timeScope("CCRFinalizeLayout", StringRef(""));
+  MCReorderInfo &RI = Layout.getAssembler().getContext().getReorderInfo();
+  const std::map<MCJTKey, MCJumpTableInfo> &jumpTables = RI.JumpTableTargets;
+  const std::vector<MCMBBKey> &layoutOrder = RI.MBBLayoutOrder;
+  stats::RandJumpTables += jumpTables.size();
 
-            prevMFID = MFID;
-            prevID = ID;
-          }
-        }
-      }
+  // Show both MF and MBB offsets according to the final layout order
+  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\n<MF/MBB Layout Summary>\n");
+  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
+  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << " Layout\tMF_MBB_ID\tMBBSize\tAlign\tFixups\tOffset   \tMFSize\tSection\n");
 
-      // The last ID Type is always the end of the object
-      std::get<4>(MAI->MachineBasicBlocks[prevID]) = 2; 
-      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
-      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "Code(B)\tNOPs(B)\tMFs\tMBBs\tFixups\n");
-      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << totalOffset << "\t" << totalAlignSize << "\t" << MAI->MachineFunctionSizes.size() \
-                                             << "\t" << MAI->MachineBasicBlocks.size() << "\t" << totalFixups << "\n"); 
-      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\tLegend\n\t(*) FallThrough MBB\n  ");
+  for (unsigned s = 0, e = sectionStarts.size(); s != e; ++s) {
+    unsigned first = sectionStarts[s];
+    unsigned last = s + 1 < e ? sectionStarts[s + 1] : layoutOrder.size();
+    uint64_t totalOffset = 0;
+    unsigned totalFixups = 0, totalAlignSize = 0;
+    int prevMFID = -1;
+    MCMBBKey prevID;
+
+    for (unsigned i = first; i < last; ++i) {
+      MCMBBKey ID = layoutOrder[i];
+      unsigned MFID = ID.getMFID();
+      MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+
+      // Update the MBB offset and MF Size accordingly
+      MBB.Offset = totalOffset;
+      totalOffset += MBB.Size;
+      totalFixups += MBB.NumFixups;
+      totalAlignSize += MBB.Alignments;
+      RI.MachineFunctionSizes[MFID] += MBB.Size;
+
+      bool isStartMF = (int)MFID > prevMFID; // check if the new MF begins
+      if (isStartMF)
+        RI.MachineBasicBlocks[prevID].Type = 1; // Type = End of the function
+
+      if (isStartMF)
+        DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
+      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << " " << i << "\t[DF " << ID << "]" << (MBB.FallThrough ? "*":"") \
+                     << (MBB.InternalBoundaries ? "+" + std::to_string(MBB.InternalBoundaries) : std::string()) << "\t" << MBB.Size << "B\t" \
+                     << MBB.Alignments << "B\t" << MBB.NumFixups << "\t" << hexlify(totalOffset) << "\t" \
+                     << RI.MachineFunctionSizes[MFID] << "B\t" << "(" << RI.SectionNames.getName(MBB.SectionIdx) << ")\n");
+
+      prevMFID = MFID;
+      prevID = ID;
     }
-  }
 
+    // The last ID Type is always the end of the object
+    RI.MachineBasicBlocks[prevID].Type = 2; 
+    DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "----------------------------------------------------------------------------------\n");
+    DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "Code(B)\tNOPs(B)\tMFs\tMBBs\tFixups\n");
+    DEBUG_WITH_TYPE("ccr-metadata", dbgs() << totalOffset << "\t" << totalAlignSize << "\t" << RI.MachineFunctionSizes.size() \
+                                           << "\t" << RI.MachineBasicBlocks.size() << "\t" << totalFixups << "\n"); 
+    DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\tLegend\n\t(*) FallThrough MBB\n\t(+N) N MBBs coalesced into the MBB\n  ");
+  }
   // Dump if there is any CFI-generated JT
   if (jumpTables.size() > 0) {
     DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\n<Jump Tables Summary>\n");
     unsigned totalEntries = 0;
-    for(auto it = jumpTables.begin(); it != jumpTables.end(); ++it) {
-      int JTI, MFID, MFID2, MBBID;
-      unsigned entryKind, entrySize;
-      std::list<std::string> JTEntries;
-
-      std::tie(MFID, JTI) = separateID(it->first);
-      std::tie(entryKind, entrySize, JTEntries) = it->second;
-
-      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "[JT@Function#" << MFID << "_" << JTI << "] " << "(Kind: " \
-                      << entryKind << ", " << JTEntries.size() << " Entries of " << entrySize << "B each)\n");
-
-      for (std::string JTE : JTEntries) {
-        std::tie(MFID2, MBBID) = separateID(JTE);
+    for (const auto &JT : jumpTables) {
+      unsigned MFID = JT.first.getMFID();
+      const MCJumpTableInfo &JTInfo = JT.second;
+
+      DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "[JT@Function#" << JT.first << "] " << "(Kind: " \
+                      << JTInfo.EntryKind << ", " << JTInfo.Entries.size() << " Entries of " \
+                      << JTInfo.EntrySize << "B each" \
+                      << (JTInfo.FunctionRelative ? ", function-relative" : "") << ")\n");
+
+      // All JT entries point to the MBBs within the same MF
+      for (unsigned MBBID : JTInfo.Entries) {
+        MCMBBKey JTE(MFID, MBBID);
+        const MCMBBInfo *MBB = RI.MachineBasicBlocks.lookup(JTE);
         totalEntries++;
-        if (MFID != MFID2)
-          errs() << "[CCR-Error] MCAssembler::updateReorderInfoValues - JT Entry points to the outside of MF! \n";
         DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\t[" << JTE << "]\t" << \
-                        hexlify(std::get<1>(MAI->MachineBasicBlocks[JTE])) << "\n");
+                        hexlify(MBB ? MBB->Offset : 0) << "\n");
       }
     }
 
@@ -971,103 +1233,607 @@ void updateReorderInfoValues(const MCAsmLayout &Layout) {
   }
 }
 
-// Koo: These sections contain the fixups that we want to handle
-static const char* fixupLookupSections[] = 
-{
-    ".text",
-    ".rodata",
-    ".data",
-    ".data.rel.ro",
-    ".init_array",
+namespace {
+// Koo: A resolved PC-relative .text fixup into its own section, whose scope is told
+//      by the layout records that hold it and its target
+struct IntraSectionFixup {
+  unsigned FixupIdx;   // Into RI.Fixups[FSK_Text]
+  unsigned SectionNum; // Into the starts of the .text sections in MBBLayoutOrder
+  uint64_t TargetOffset;
 };
+} // end anonymous namespace
+
+// Koo: Whether a relocated fixup tells nothing but what its relocation does, so
+//      that the linker may synthesize it (-ccr-omit-relocated-fixups): neither a
+//      jump table nor a relaxable or shrinkable branch, nor either half of a pair
+static bool isSynthesizableFixup(const MCFixupRecord &F, bool isHighHalf) {
+  return F.RelocIdx > 0 && F.NumJTEntries == 0 && F.RelaxShortSize == 0 &&
+         F.ShrinkLongSize == 0 && F.PairDelta == 0 && !isHighHalf;
+}
+
+// Koo: The high halves of the pairs in \p fixups (see MCFixupRecord::PairDelta)
+static std::vector<bool> findHighHalves(ArrayRef<MCFixupRecord> fixups) {
+  std::vector<bool> highHalves(fixups.size());
+  for (unsigned i = 0, e = fixups.size(); i != e; ++i)
+    if (fixups[i].PairDelta > 0)
+      highHalves[i - fixups[i].PairDelta] = true;
+  return highHalves;
+}
+
+// Koo: Remove the \p dropped fixups from their list. The first fixup of every
+//      section but the first one still tells the linker so, and a low half still
+//      finds its high half (which is never dropped)
+static void compactFixups(std::vector<MCFixupRecord> &fixups,
+                          const std::vector<bool> &dropped) {
+  std::vector<unsigned> keptIdx(fixups.size());
+  unsigned numKept = 0;
+  for (unsigned i = 0, e = fixups.size(); i != e; ++i) {
+    keptIdx[i] = numKept;
+    if (dropped[i])
+      continue;
+    fixups[numKept] = fixups[i];
+    fixups[numKept].IsNewSection =
+        numKept > 0 && fixups[numKept].SectionIdx != fixups[numKept - 1].SectionIdx;
+    if (fixups[i].PairDelta > 0)
+      fixups[numKept].PairDelta = numKept - keptIdx[i - fixups[i].PairDelta];
+    numKept++;
+  }
+  fixups.resize(numKept);
+}
+
+// Koo: Leave the relocated fixups of the data sections to the linker
+//      (-ccr-omit-relocated-fixups); those of .text go along with the intra-function
+//      ones (see classifyTextFixupScopes()), as their BBLs count them. The special
+//      lists (XRay sleds, patchable entries, static keys and custom sections) are
+//      always kept whole.
+static void omitRelocatedDataFixups(MCReorderInfo &RI) {
+  for (unsigned K = FSK_Rodata; K <= FSK_TData; ++K) {
+    std::vector<MCFixupRecord> &fixups = RI.Fixups[K];
+    std::vector<bool> highHalves = findHighHalves(fixups);
+    std::vector<bool> dropped(fixups.size());
+    unsigned numDropped = 0;
+    for (unsigned i = 0, e = fixups.size(); i != e; ++i)
+      if (isSynthesizableFixup(fixups[i], highHalves[i])) {
+        dropped[i] = true;
+        numDropped++;
+      }
+    if (numDropped == 0)
+      continue;
+    stats::RandRelocatedFixups += numDropped;
+    compactFixups(fixups, dropped);
+  }
+}
 
+// Koo: Tag the intra-function .text fixups once the offsets of the MBBs are final.
+//      A function that moves as a whole (-ccr-granularity=function or its
+//      ccr_granularity attribute) is one layout record, within which no distance
+//      ever changes, thus the fixups within the record are left out of .rand.
+//      The only exception is a record that holds an unrelaxed short branch out of
+//      it: the randomizer may relax that branch, which grows the record. A long
+//      branch of a record whose fixups are left out is never shrunk instead
+//      (\p shrinkable are those recorded, whatever their targets).
+//      The \p relocated fixups (-ccr-omit-relocated-fixups) are left out as well
+//      unless the relocations cannot tell them (see isSynthesizableFixup()).
+static void classifyTextFixupScopes(MCReorderInfo &RI, bool coarseLayout,
+                                    ArrayRef<unsigned> sectionStarts,
+                                    ArrayRef<IntraSectionFixup> candidates,
+                                    ArrayRef<IntraSectionFixup> shrinkable,
+                                    ArrayRef<IntraSectionFixup> relocated) {
+  std::vector<MCFixupRecord> &fixups = RI.Fixups[FSK_Text];
+  const std::vector<MCMBBKey> &layoutOrder = RI.MBBLayoutOrder;
+
+  // The layout record (into MBBLayoutOrder) at offset of the s-th section, or -1
+  auto findRecord = [&](unsigned s, uint64_t offset) -> int {
+    auto first = layoutOrder.begin() + sectionStarts[s];
+    auto last = s + 1 < sectionStarts.size() ? layoutOrder.begin() + sectionStarts[s + 1]
+                                             : layoutOrder.end();
+    auto It = std::upper_bound(first, last, offset, [&](uint64_t O, MCMBBKey ID) {
+      return O < RI.MachineBasicBlocks[ID].Offset;
+    });
+    if (It == first)
+      return -1;
+    --It;
+    const MCMBBInfo &MBB = RI.MachineBasicBlocks[*It];
+    if (offset >= uint64_t(MBB.Offset) + MBB.Size)
+      return -1;
+    return It - layoutOrder.begin();
+  };
+
+  std::vector<std::pair<int, int>> records(candidates.size()); // Of the fixup and its target
+  DenseSet<int> growable;
+  for (unsigned i = 0, e = candidates.size(); i != e; ++i) {
+    const IntraSectionFixup &C = candidates[i];
+    MCFixupRecord &F = fixups[C.FixupIdx];
+    records[i] = {findRecord(C.SectionNum, F.Offset), findRecord(C.SectionNum, C.TargetOffset)};
+    int owner = records[i].first, target = records[i].second;
+    if (owner >= 0 && target >= 0 &&
+        layoutOrder[owner].getMFID() == layoutOrder[target].getMFID())
+      F.Scope = FSC_IntraFunction;
+    if (F.RelaxShortSize > 0 && owner != target)
+      growable.insert(owner);
+  }
+
+  std::vector<bool> dropped(fixups.size());
+  DenseSet<int> droppedIn; // The records
+  unsigned numDropped = 0;
+  for (unsigned i = 0, e = candidates.size(); i != e; ++i) {
+    const MCFixupRecord &F = fixups[candidates[i].FixupIdx];
+    int owner = records[i].first;
+    if (F.Scope != FSC_IntraFunction || owner != records[i].second || F.NumJTEntries > 0 ||
+        growable.count(owner))
+      continue;
+    MCMBBKey ID = layoutOrder[owner];
+    if (!coarseLayout && !RI.MachineFunctionGranularities.count(ID.getMFID()))
+      continue;
+    MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+    if (MBB.NumFixups > 0)
+      MBB.NumFixups--;
+    dropped[candidates[i].FixupIdx] = true;
+    droppedIn.insert(owner);
+    numDropped++;
+  }
+  stats::RandIntraFunctionFixups += numDropped;
+
+  // A relocated fixup leaves the branches of its record as they are
+  std::vector<bool> highHalves = findHighHalves(fixups);
+  unsigned numRelocated = 0;
+  for (const IntraSectionFixup &R : relocated) {
+    const MCFixupRecord &F = fixups[R.FixupIdx];
+    if (dropped[R.FixupIdx] || !isSynthesizableFixup(F, highHalves[R.FixupIdx]))
+      continue;
+    int owner = findRecord(R.SectionNum, F.Offset);
+    if (owner >= 0) {
+      MCMBBInfo &MBB = RI.MachineBasicBlocks[layoutOrder[owner]];
+      if (MBB.NumFixups > 0)
+        MBB.NumFixups--;
+    }
+    dropped[R.FixupIdx] = true;
+    numRelocated++;
+  }
+  stats::RandRelocatedFixups += numRelocated;
+  if (numDropped + numRelocated == 0)
+    return;
+  for (const IntraSectionFixup &S : shrinkable) {
+    MCFixupRecord &F = fixups[S.FixupIdx];
+    if (droppedIn.count(findRecord(S.SectionNum, F.Offset)))
+      F.ShrinkLongSize = F.ShrinkShortSize = 0;
+  }
+
+  compactFixups(fixups, dropped);
+}
+
+// Koo: The call-site tables (-ccr-eh-info) begin at their functions, whose entry
+//      MBBs have been placed by finalizeReorderLayout() above; the LSDA section is
+//      named in the section table as any other section that the metadata refers to
+static void resolveCallSiteTables(const MCAsmLayout &Layout) {
+  MCReorderInfo &RI = Layout.getAssembler().getContext().getReorderInfo();
+  if (RI.CallSiteTables.empty())
+    return;
+
+  DenseMap<unsigned, const MCMBBInfo *> entries; // The first MBB of every MF
+  for (MCMBBKey ID : RI.MBBLayoutOrder)
+    entries.insert(std::make_pair(ID.getMFID(), RI.MachineBasicBlocks.lookup(ID)));
+
+  for (MCCallSiteTable &T : RI.CallSiteTables) {
+    const MCMBBInfo *entry = entries.lookup(T.MFID);
+    if (!entry || !entry->hasSection() || !T.Records->isInSection())
+      continue;
+    const MCSection &LSDASec = T.Records->getSection();
+    T.FunctionOffset = entry->Offset;
+    T.FunctionSectionIdx = entry->SectionIdx;
+    T.TableOffset = Layout.getSymbolOffset(*T.Records);
+    T.TableSectionIdx = RI.SectionNames.intern(
+        &LSDASec, static_cast<const MCSectionELF &>(LSDASec).getSectionName());
+  }
+}
 
 // Koo: Helper functions for serializeReorderInfo()
-int getFixupSectionId(std::string secName) {
-    for (size_t i = 0; i < sizeof(fixupLookupSections)/sizeof(*fixupLookupSections); ++i)
-        if (secName.compare(fixupLookupSections[i]) == 0)
-            return i;
-    return -1;
+//      The fixup list (v1) and the fixup columns (v2) of each MCFixupSectionKind
+//      are written by the encoder of ShuffleInfo (see shuffleInfoWriter.h)
+static ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple*
+addFixupTuple(ShuffleInfo::ReorderInfo_FixupInfo* FI, MCFixupSectionKind Kind) {
+  if (ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* T = ShuffleInfo::AddFixupTuple(FI, Kind))
+    return T;
+  llvm_unreachable("[CCR-Error] ShuffleInfo::addFixupTuple - No such section to collect fixups!");
+}
+
+static ShuffleInfo::ReorderInfo_FixupColumns*
+getFixupColumns(ShuffleInfo::ReorderInfo* RI, MCFixupSectionKind Kind) {
+  if (ShuffleInfo::ReorderInfo_FixupColumns* C = ShuffleInfo::MutableFixupColumns(RI, Kind))
+    return C;
+  llvm_unreachable("[CCR-Error] ShuffleInfo::getFixupColumns - No such section to collect fixups!");
+}
+
+static void setFixups(const std::vector<MCFixupRecord> &Fixups,
+                      ShuffleInfo::ReorderInfo_FixupInfo* fixupInfo, MCFixupSectionKind Kind,
+                      bool deltaOffsets) {
+  uint32_t prevOffset = 0;
+  for (const MCFixupRecord &F : Fixups) {
+    ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* pFixupTuple = addFixupTuple(fixupInfo, Kind);
+    // Deltas between consecutive fixups are small and repetitive, thus compress well;
+    // they wrap around modulo 2^32 as the readers of v1 always did
+    ShuffleInfo::SetFixupTuple(pFixupTuple, F,
+                               deltaOffsets ? uint32_t(F.Offset - prevOffset) : F.Offset);
+    pFixupTuple->set_section_idx(F.SectionIdx);
+    prevOffset = F.Offset;
+  }
+}
+
+// Koo: The last instruction of the MBB (see LayoutInfo.term): its size | its kind << 4,
+//      or none if it takes more bytes than the field tells
+static unsigned getTermBits(const MCMBBInfo &MBB) {
+  return MBB.TermSize < 16 ? MBB.TermSize | MBB.TermKind << 4 : 0;
+}
+
+// Koo: The padded instruction of the MBB (see LayoutInfo.boundary): its size | log2 << 4 |
+//      its offset in the MBB << 8, or 0 if there is none (or it does not fit)
+static unsigned getBoundaryBits(const MCMBBInfo &MBB) {
+  uint64_t offset = MBB.BoundaryOffset - MBB.Offset;
+  if (!MBB.BoundaryLog2 || MBB.BoundarySize >= 16 || MBB.BoundaryOffset < MBB.Offset ||
+      offset + MBB.BoundarySize > MBB.Size || offset >= (1U << 24))
+    return 0;
+  return MBB.BoundarySize | MBB.BoundaryLog2 << 4 | unsigned(offset) << 8;
+}
+
+// Koo: MCCodePadder keeps the windows of its policies to itself; those of x86 are the
+//      32-byte lines of the decoded instruction cache
+static const unsigned PaddingBoundaryLog2 = 5;
+
+// Koo: The packed bitfield columns of the layout (v2)
+using ShuffleInfo::AppendBits;
+
+// Append the fixups one at a time, thus a chunk that only takes some of them
+// (see RandSectionFilter) needs no copy of the records it takes
+using ShuffleInfo::FixupColumnsWriter;
+
+static void setFixupColumns(const std::vector<MCFixupRecord> &Fixups,
+                            ShuffleInfo::ReorderInfo_FixupColumns* columns,
+                            bool relocIndices) {
+  FixupColumnsWriter writer(columns, Fixups.size(), relocIndices);
+  for (const MCFixupRecord &F : Fixups)
+    writer.Add(F);
 }
 
-ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* getFixupTuple(ShuffleInfo::ReorderInfo_FixupInfo* FI, std::string secName) {
-  switch (getFixupSectionId(secName)) {
-    case 0: return FI->add_text();
-    case 1: return FI->add_rodata();
-    case 2: return FI->add_data();
-    case 3: return FI->add_datarel();
-    case 4: return FI->add_initarray();
-    default: llvm_unreachable("[CCR-Error] ShuffleInfo::getFixupTuple - No such section to collect fixups!");
+// Koo: The sections whose metadata goes to a single .rand section. With relocatable
+//      chunks (format 3), each COMDAT group has a .rand of its own (see EmitRand()),
+//      and so does each section of -ccr-rand-per-section (linked to the section),
+//      thus the metadata of a discarded copy goes away along with its code. The indices
+//      are renumbered so that a chunk only names (and gets patched for) its own sections.
+namespace {
+class RandSectionFilter {
+  std::vector<int> LocalIdx;      // By the index into MCSectionNameTable; -1 if left out
+  std::vector<unsigned> Included; // The table index of every local index
+
+  static bool isOwnedBy(const MCAsmInfo *MAI, const MCSection *Sec,
+                        const MCSectionELF &Rand) {
+    if (Rand.getFlags() & ELF::SHF_LINK_ORDER)
+      return Sec == Rand.getAssociatedSection();
+    if (!Sec)
+      return !Rand.getGroup();
+    const MCSectionELF &ELFSec = static_cast<const MCSectionELF &>(*Sec);
+    return !MAI->hasLinkedRandSection(ELFSec) && ELFSec.getGroup() == Rand.getGroup();
+  }
+
+public:
+  RandSectionFilter(const MCAsmInfo *MAI, const MCReorderInfo &RI,
+                    const MCSectionELF *Rand) {
+    const MCSectionNameTable &Table = RI.SectionNames;
+    LocalIdx.resize(Table.size(), -1);
+    for (unsigned Idx = 0, E = Table.size(); Idx != E; ++Idx) {
+      if (Rand && MAI->RandFormatVersion >= 3 &&
+          !isOwnedBy(MAI, Table.getSection(Idx), *Rand))
+        continue;
+      LocalIdx[Idx] = Included.size();
+      Included.push_back(Idx);
+    }
+
+    // The LSDA section is shared by all groups, thus a chunk also names it for
+    // the call-site tables of its functions
+    for (const MCCallSiteTable &T : RI.CallSiteTables) {
+      if (T.isResolved() && contains(T.FunctionSectionIdx) &&
+          !contains(T.TableSectionIdx)) {
+        LocalIdx[T.TableSectionIdx] = Included.size();
+        Included.push_back(T.TableSectionIdx);
+      }
+    }
+  }
+
+  bool contains(unsigned Idx) const {
+    return Idx < LocalIdx.size() && LocalIdx[Idx] >= 0;
+  }
+  unsigned getLocal(unsigned Idx) const { return LocalIdx[Idx]; }
+  bool isIdentity() const { return Included.size() == LocalIdx.size(); }
+  ArrayRef<unsigned> getIncluded() const { return Included; }
+
+  // Pass the fixups of the included sections with local section indices to \p Fn,
+  // one at a time; IsNewSection marks the first fixup of every concrete section
+  // but the first one as before
+  void forEachFixup(const std::vector<MCFixupRecord> &Fixups,
+                    function_ref<void(const MCFixupRecord &)> Fn) const {
+    unsigned prevIdx = MCMBBInfo::NoSection;
+    for (const MCFixupRecord &F : Fixups) {
+      if (!contains(F.SectionIdx))
+        continue;
+      MCFixupRecord R = F;
+      R.SectionIdx = getLocal(F.SectionIdx);
+      R.IsNewSection = prevIdx != MCMBBInfo::NoSection && prevIdx != R.SectionIdx;
+      prevIdx = R.SectionIdx;
+      Fn(R);
+    }
+  }
+};
+} // end anonymous namespace
+
+// Koo: Account what every function takes in ri (see MCRandCost); a record of v1 costs its
+//      encoded size along with its tag and length, and a row of the packed columns the
+//      varints of its values plus its bits
+static uint64_t getFieldBytes(uint64_t Size) { return 1 + getULEB128Size(Size) + Size; }
+
+static void collectRandCosts(const MCAsmInfo *MAI, MCReorderInfo &RI,
+                             const RandSectionFilter &sections,
+                             const ShuffleInfo::ReorderInfo *ri) {
+  bool packedColumns = MAI->RandFormatVersion >= 2;
+  MCRandCost &Object = RI.RandObjectCost;
+  std::map<unsigned, uint64_t> layoutBits; // Of the bitfield columns, by MFID
+  int numLayouts = 0;
+  for (MCMBBKey ID : RI.MBBLayoutOrder) {
+    const MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+    if (!sections.contains(MBB.SectionIdx))
+      continue;
+    MCRandCost &Cost = RI.RandFunctionCosts[ID.getMFID()];
+    Cost.CodeBytes += MBB.Size;
+    Object.CodeBytes += MBB.Size;
+    if (packedColumns) {
+      Cost.LayoutBytes += getULEB128Size(MBB.Size) + getULEB128Size(MBB.NumFixups) +
+                          getULEB128Size(MBB.Alignments);
+      if (unsigned sectionIdx = sections.getLocal(MBB.SectionIdx))
+        Cost.LayoutBytes += getULEB128Size(sectionIdx);
+      layoutBits[ID.getMFID()] += 2 + 1 + 2 + 4 + 1;
+    } else {
+      Cost.LayoutBytes += getFieldBytes(ri->layout(numLayouts).ByteSizeLong());
+    }
+    numLayouts++;
   }
+  for (const auto &Bits : layoutBits)
+    RI.RandFunctionCosts[Bits.first].LayoutBytes += (Bits.second + 7) / 8;
+
+  // Only the .text fixups belong to a function for sure
+  int64_t prevOffset = 0;
+  unsigned idx = 0, numTextFixups = 0;
+  for (const MCFixupRecord &F : RI.Fixups[FSK_Text]) {
+    if (!sections.contains(F.SectionIdx))
+      continue;
+    uint64_t Bytes;
+    if (packedColumns) {
+      int64_t delta = (int64_t)F.Offset - prevOffset;
+      Bytes = getULEB128Size((uint64_t)(delta << 1) ^ (uint64_t)(delta >> 63)) +
+              getULEB128Size(F.DerefSize) + getULEB128Size(sections.getLocal(F.SectionIdx)) +
+              1; // 6 bits
+      if (F.NumJTEntries > 0)
+        Bytes += getULEB128Size(idx) + getULEB128Size(F.NumJTEntries) +
+                 getULEB128Size(F.JTEntrySize);
+      if (F.ReachLog2 > 0)
+        Bytes += getULEB128Size(idx) + 1;
+      if (F.RelaxShortSize > 0)
+        Bytes += getULEB128Size(idx) + 1 + getFieldBytes(F.RelaxLongSize) + 1;
+      if (F.ShrinkLongSize > 0)
+        Bytes += getULEB128Size(idx) + 1 + getFieldBytes(F.ShrinkShortSize);
+      prevOffset = F.Offset;
+      idx++;
+    } else {
+      Bytes = getFieldBytes(ri->fixup(0).text(numTextFixups).ByteSizeLong());
+    }
+    numTextFixups++;
+    if (F.ParentID.isValid())
+      RI.RandFunctionCosts[F.ParentID.getMFID()].FixupBytes += Bytes;
+  }
+
+  // The object as it is encoded
+  if (packedColumns)
+    Object.LayoutBytes += getFieldBytes(ri->layout_columns().ByteSizeLong());
+  for (const ShuffleInfo::ReorderInfo_LayoutInfo &L : ri->layout())
+    Object.LayoutBytes += getFieldBytes(L.ByteSizeLong());
+  for (const ShuffleInfo::ReorderInfo_FixupInfo &FI : ri->fixup())
+    Object.FixupBytes += getFieldBytes(FI.ByteSizeLong());
+  for (const ShuffleInfo::ReorderInfo_FixupColumns *C :
+       {&ri->text_fixup_columns(), &ri->rodata_fixup_columns(), &ri->data_fixup_columns(),
+        &ri->datarel_fixup_columns(), &ri->initarray_fixup_columns(),
+        &ri->finiarray_fixup_columns(), &ri->tdata_fixup_columns()})
+    if (packedColumns)
+      Object.FixupBytes += getFieldBytes(C->ByteSizeLong());
+  for (const std::string &Name : ri->section_names())
+    Object.StringBytes += getFieldBytes(Name.size());
 }
 
-void setFixups(std::list<std::tuple<unsigned, unsigned, bool, std::string, std::string, bool, std::string, unsigned, unsigned>> Fixups,
-               ShuffleInfo::ReorderInfo_FixupInfo* fixupInfo, std::string secName) {
-  unsigned FixupOffset, FixupSize, FixupisRela, numJTEntries, JTEntrySize;
-  std::string sectionName, FixupParentID, SymbolRefFixupName;
-  bool isNewSection;
-
-  for (auto F = Fixups.begin(); F != Fixups.end(); ++F) {
-    ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple* pFixupTuple = getFixupTuple(fixupInfo, secName);
-    std::tie(FixupOffset, FixupSize, FixupisRela, FixupParentID, \
-             SymbolRefFixupName, isNewSection, sectionName, numJTEntries, JTEntrySize) = *F;
-    pFixupTuple->set_offset(FixupOffset);
-    pFixupTuple->set_deref_sz(FixupSize);
-    pFixupTuple->set_is_rela(FixupisRela);
-    pFixupTuple->set_section_name(sectionName);
-    if (isNewSection) 
-      pFixupTuple->set_type(4); // let linker know if there are multiple .text sections
-    else
-      pFixupTuple->set_type(0); // c2c, c2d, d2c, d2d default=0; should be updated by linker
-
-    // The following jump table information is fixups in .text for JT entry update only (pic/pie)
-    if (numJTEntries > 0) {
-       pFixupTuple->set_num_jt_entries(numJTEntries);
-       pFixupTuple->set_jt_entry_sz(JTEntrySize);
+// Koo: The shape of a function is what its metadata holds: the BBLs and the .text fixups,
+//      relative to the start of the function. The instances of a template are alike
+//      in every object, thus so are their chunks (one per COMDAT group), which are
+//      keyed by the shapes of their functions for the linker to store a payload once
+static uint64_t hashFunctionShapes(MCReorderInfo &RI, const RandSectionFilter &sections) {
+  std::vector<unsigned> functions; // In layout order
+  DenseMap<unsigned, std::pair<uint64_t, SmallVector<uint64_t, 32>>> shapes; // By MFID: start, words
+  for (MCMBBKey ID : RI.MBBLayoutOrder) {
+    const MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+    if (!sections.contains(MBB.SectionIdx))
+      continue;
+    auto It = shapes.find(ID.getMFID());
+    if (It == shapes.end()) {
+      functions.push_back(ID.getMFID());
+      It = shapes.insert({ID.getMFID(), {MBB.Offset, {}}}).first;
     }
+    SmallVectorImpl<uint64_t> &words = It->second.second;
+    words.append({MBB.Offset - It->second.first, MBB.Size, MBB.NumFixups, MBB.Alignments,
+                  MBB.AlignLog2, MBB.Type, MBB.Hotness,
+                  uint64_t(MBB.FallThrough) | MBB.IsLoopHeader << 1 | MBB.HasCFI << 2 |
+                      MBB.Pinned << 3 | MBB.ChainStart << 4,
+                  MBB.LayoutEdgeProb, getTermBits(MBB), getBoundaryBits(MBB)});
   }
+  for (const MCFixupRecord &F : RI.Fixups[FSK_Text]) {
+    auto It = shapes.find(F.ParentID.getMFID());
+    if (!sections.contains(F.SectionIdx) || It == shapes.end())
+      continue;
+    It->second.second.append({F.Offset - It->second.first, F.DerefSize, F.NumJTEntries,
+                              F.JTEntrySize,
+                              uint64_t(F.IsRela) | F.JTFunctionRelative << 1 |
+                                  F.GOTRelax << 2,
+                              uint64_t(F.TargetKind), uint64_t(F.RefClass),
+                              uint64_t(F.Scope), F.ReachLog2, F.PairDelta,
+                              F.RelaxShortSize, F.RelaxLongSize, F.RelaxFixupOffset,
+                              F.ShrinkLongSize});
+  }
+
+  SmallVector<uint64_t, 16> hashes;
+  for (unsigned MFID : functions) {
+    const SmallVectorImpl<uint64_t> &words = shapes[MFID].second;
+    hashes.push_back(xxHash64(StringRef(reinterpret_cast<const char *>(words.data()),
+                                        words.size() * sizeof(uint64_t))));
+  }
+  return xxHash64(StringRef(reinterpret_cast<const char *>(hashes.data()),
+                            hashes.size() * sizeof(uint64_t)));
 }
 
-// Koo: Serialize all information for future reordering, which has been stored in MCAsmInfo
-void serializeReorderInfo(ShuffleInfo::ReorderInfo* ri, const MCAsmLayout &Layout) {
+// Koo: Serialize all information for future reordering, which has been stored in MCReorderInfo
+//      Only the metadata of the sections that belong to Rand goes to a chunk of format 3,
+//      and the shapes of its functions are returned (see hashFunctionShapes()); 0 otherwise
+//      The bytes are a function of the assembled code alone, for the build caches
+//      that key objects by their contents: the records go in the layout order,
+//      refer to sections and functions by interned indices, and never carry a
+//      pointer, a path, a time or the order of a hash table, whatever the host,
+//      the run or the -j level (see WriteRandInfo() for the encoder)
+uint64_t serializeReorderInfo(ShuffleInfo::ReorderInfo* ri, const MCAsmLayout &Layout,
+                              const MCSectionELF *Rand) {
+  TimeTraceScope timeScope("CCRSerializeReorderInfo", StringRef(""));
+
   // Set the binary information for reordering
   ShuffleInfo::ReorderInfo_BinaryInfo* binaryInfo = ri->mutable_bin();
   binaryInfo->set_rand_obj_offset(0x0);     // Should be updated at linking time
   binaryInfo->set_main_addr_offset(0x0);    // Should be updated at linking time
 
   const MCAsmInfo *MAI = Layout.getAssembler().getContext().getAsmInfo();
+  MCReorderInfo &RI = Layout.getAssembler().getContext().getReorderInfo();
 
   // Identify this object file has been compiled from:
   //    obj_type = 0: a general source file (i.e., *.c, *.cc, *.cpp, ...)
   //    obj_type = 1: a source file that contains inline assembly
   //    obj_type = 2: standalone assembly file (i.e., *.s, *.S, ...)
-  if (MAI->isAssemFile)
-    binaryInfo->set_src_type(2);
-  else if (MAI->hasInlineAssembly)
+  //    obj_type = 3: standalone assembly file whose BBLs have been split at the
+  //                  terminators by their instruction descriptors (see AsmParser)
+  //    The assembly of the compiler with .ccr_bbl directives (-ccr-asm-directives)
+  //    is as good as its source file.
+  if (RI.isAssemFile && !RI.hasAssemBBLDirectives)
+    binaryInfo->set_src_type(3);
+  else if (RI.hasInlineAssembly)
     binaryInfo->set_src_type(1);
   else
     binaryInfo->set_src_type(0);
 
-  updateReorderInfoValues(Layout);
+  // Delta-encode the fixup offsets only when the section is going to be compressed,
+  // and none of them is past the 4GB the 32-bit deltas of v1 can reach
+  bool deltaOffsets = MAI->CompressRandSection != DebugCompressionType::None;
+  for (unsigned K = 0; K < NumFixupSectionKinds && deltaOffsets; ++K)
+    for (const MCFixupRecord &F : RI.Fixups[K])
+      if (F.Offset > UINT32_MAX) {
+        deltaOffsets = false;
+        break;
+      }
+  binaryInfo->set_fixup_offset_encoding(deltaOffsets ? 1 : 0);
+
+  // The packed columns (v2) replace both layout and fixup submessages
+  bool packedColumns = MAI->RandFormatVersion >= 2;
+  binaryInfo->set_format_version(packedColumns ? 2 : 1);
+  RandSectionFilter sections(MAI, RI, Rand);
 
   // Set the layout of both Machine Functions and Machine Basic Blocks with protobuf definition
-  std::string sectionName;
-  unsigned MBBSize, MBBoffset, numFixups, alignSize, MBBtype;
-  unsigned objSz = 0, numFuncs = 0, numBBs = 0;
-  int MFID, MBBID, prevMFID = 0;
-
-  for (auto MBBI = MAI->MBBLayoutOrder.begin(); MBBI != MAI->MBBLayoutOrder.end(); ++MBBI) {
-    ShuffleInfo::ReorderInfo_LayoutInfo* layoutInfo = ri->add_layout();
-    std::string ID = *MBBI;
-    std::tie(MFID, MBBID) = separateID(ID);
-    std::tie(MBBSize, MBBoffset, numFixups, alignSize, MBBtype, sectionName) = MAI->MachineBasicBlocks[ID];
-    bool MBBFallThrough = MAI->canMBBFallThrough[ID];
-
-    layoutInfo->set_bb_size(MBBSize);
-    layoutInfo->set_type(MBBtype);
-    layoutInfo->set_num_fixups(numFixups);
-    layoutInfo->set_bb_fallthrough(MBBFallThrough);
-    layoutInfo->set_section_name(sectionName);
+  uint64_t objSz = 0;
+  unsigned numFuncs = 0, numBBs = 0;
+  unsigned MFID = 0, prevMFID = 0, numLayouts = 0, lastType = 0;
+  std::vector<unsigned> identities; // The MFID of every function
+  ShuffleInfo::ReorderInfo_LayoutColumns* layoutColumns =
+      packedColumns ? ri->mutable_layout_columns() : nullptr;
+  // The pinned functions (ccr_granularity("none")) are rare, thus so is their column
+  bool anyPinned = false;
+  for (const auto &G : RI.MachineFunctionGranularities)
+    anyPinned |= G.second == MCMBBInfo::GranularityNone;
+  // So are the padded instructions (MCCodePadder), which only x86 has
+  bool anyBoundary = false;
+  for (MCMBBKey ID : RI.MBBLayoutOrder)
+    anyBoundary |= getBoundaryBits(RI.MachineBasicBlocks[ID]) != 0;
+
+  if (layoutColumns && sections.isIdentity()) {
+    layoutColumns->mutable_bb_size()->Reserve(RI.MBBLayoutOrder.size());
+    layoutColumns->mutable_padding_sz()->Reserve(RI.MBBLayoutOrder.size());
+    layoutColumns->mutable_num_fixups()->Reserve(RI.MBBLayoutOrder.size());
+  }
+  // Koo: A BBL past the end of section_idx is in the first section, thus the column
+  //      stops at the last BBL of another one (and a chunk per section has none)
+  unsigned firstSectionRun = 0;
+  for (MCMBBKey ID : RI.MBBLayoutOrder) {
+    const MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+    if (!sections.contains(MBB.SectionIdx))
+      continue;
+    unsigned MBBSize = MBB.Size;
+    unsigned sectionIdx = sections.getLocal(MBB.SectionIdx);
+    MFID = ID.getMFID();
+
+    if (layoutColumns) {
+      layoutColumns->add_bb_size(MBBSize);
+      AppendBits(layoutColumns->mutable_type_bits(), numLayouts, MBB.Type, 2);
+      AppendBits(layoutColumns->mutable_fallthrough_bits(), numLayouts, MBB.FallThrough, 1);
+      AppendBits(layoutColumns->mutable_hotness_bits(), numLayouts, MBB.Hotness, 2);
+      layoutColumns->add_padding_sz(MBB.Alignments);
+      AppendBits(layoutColumns->mutable_align_bits(), numLayouts, std::min<unsigned>(MBB.AlignLog2, 15), 4);
+      AppendBits(layoutColumns->mutable_loop_header_bits(), numLayouts, MBB.IsLoopHeader, 1);
+      if (MAI->emitsRandEHInfo())
+        AppendBits(layoutColumns->mutable_cfi_bits(), numLayouts, MBB.HasCFI, 1);
+      if (anyPinned)
+        AppendBits(layoutColumns->mutable_pinned_bits(), numLayouts, MBB.Pinned, 1);
+      if (RI.hasPlacementChains) {
+        AppendBits(layoutColumns->mutable_chain_start_bits(), numLayouts, MBB.ChainStart, 1);
+        AppendBits(layoutColumns->mutable_edge_prob_bits(), numLayouts, MBB.LayoutEdgeProb, 4);
+      }
+      AppendBits(layoutColumns->mutable_term_bits(), numLayouts, getTermBits(MBB), 8);
+      if (anyBoundary)
+        layoutColumns->add_boundary(getBoundaryBits(MBB));
+      layoutColumns->add_num_fixups(MBB.NumFixups);
+      if (sectionIdx == 0) {
+        firstSectionRun++;
+      } else {
+        for (; firstSectionRun; firstSectionRun--)
+          layoutColumns->add_section_idx(0);
+        layoutColumns->add_section_idx(sectionIdx);
+      }
+    } else {
+      ShuffleInfo::ReorderInfo_LayoutInfo* layoutInfo = ri->add_layout();
+      layoutInfo->set_bb_size(MBBSize);
+      layoutInfo->set_type(MBB.Type);
+      layoutInfo->set_num_fixups(MBB.NumFixups);
+      layoutInfo->set_bb_fallthrough(MBB.FallThrough);
+      if (MBB.Hotness != MCMBBInfo::HotnessUnknown)
+        layoutInfo->set_hotness(MBB.Hotness);
+      if (MBB.Alignments)
+        layoutInfo->set_padding_sz(MBB.Alignments);
+      if (MBB.AlignLog2)
+        layoutInfo->set_align_log2(MBB.AlignLog2);
+      if (MBB.IsLoopHeader)
+        layoutInfo->set_loop_header(true);
+      if (MBB.Pinned)
+        layoutInfo->set_pinned(true);
+      if (MBB.ChainStart)
+        layoutInfo->set_chain_start(true);
+      if (MBB.LayoutEdgeProb)
+        layoutInfo->set_edge_prob(MBB.LayoutEdgeProb);
+      if (unsigned term = getTermBits(MBB))
+        layoutInfo->set_term(term);
+      if (unsigned boundary = getBoundaryBits(MBB))
+        layoutInfo->set_boundary(boundary);
+      if (MBB.hasSection())
+        layoutInfo->set_section_idx(sectionIdx);
+    }
+    numLayouts++;
+    // The randomizer ends a function at the end of MF or of the object
+    if (layoutColumns && MBB.Type != 0)
+      identities.push_back(MFID);
+    lastType = MBB.Type;
 
     if (MFID > prevMFID) {
       numFuncs++;
@@ -1080,22 +1846,100 @@ void serializeReorderInfo(ShuffleInfo::ReorderInfo* ri, const MCAsmLayout &Layou
   }
 
   binaryInfo->set_obj_sz(objSz);
+  stats::RandBBLs += numLayouts;
+
+  // Koo: The identities of the functions, in layout order (see MCFunctionIdentity);
+  //      their content hashes only if recorded (-ccr-function-hashes)
+  if (numLayouts && lastType == 0)
+    identities.push_back(MFID);
+  if (layoutColumns && !RI.MachineFunctionIdentities.empty()) {
+    for (unsigned ID : identities) {
+      auto It = RI.MachineFunctionIdentities.find(ID);
+      MCFunctionIdentity identity;
+      if (It != RI.MachineFunctionIdentities.end())
+        identity = It->second;
+      layoutColumns->add_function_name_hash(identity.NameHash);
+      if (MAI->RandFunctionHashes)
+        layoutColumns->add_function_content_hash(identity.ContentHash);
+    }
+  }
+
+  // Set the fixup information of every kind of section (see MCFixupSectionKind)
+  unsigned numFixups[NumFixupSectionKinds];
+  if (packedColumns) {
+    for (unsigned K = 0; K < NumFixupSectionKinds; ++K) {
+      // The optional columns (XRay on) are left out of the objects without them
+      numFixups[K] = 0;
+      if (K >= FSK_XRay && RI.Fixups[K].empty())
+        continue;
+      ShuffleInfo::ReorderInfo_FixupColumns* columns = getFixupColumns(ri, MCFixupSectionKind(K));
+      if (sections.isIdentity()) {
+        setFixupColumns(RI.Fixups[K], columns, RI.hasRelocIndices);
+      } else {
+        FixupColumnsWriter writer(columns, 0, RI.hasRelocIndices);
+        sections.forEachFixup(RI.Fixups[K],
+                              [&](const MCFixupRecord &F) { writer.Add(F); });
+      }
+      numFixups[K] = columns->deref_sz_size();
+    }
+  } else {
+    ShuffleInfo::ReorderInfo_FixupInfo* fixupInfo = ri->add_fixup();
+    for (unsigned K = 0; K < NumFixupSectionKinds; ++K) {
+      setFixups(RI.Fixups[K], fixupInfo, MCFixupSectionKind(K), deltaOffsets);
+      numFixups[K] = RI.Fixups[K].size();
+    }
+  }
+  stats::RandTextFixups += numFixups[FSK_Text];
+  stats::RandRodataFixups += numFixups[FSK_Rodata];
+  stats::RandDataFixups += numFixups[FSK_Data] + numFixups[FSK_DataRel] +
+                           numFixups[FSK_InitArray] + numFixups[FSK_FiniArray];
+  stats::RandTLSFixups += numFixups[FSK_TData];
+  stats::RandXRayFixups += numFixups[FSK_XRay];
+  stats::RandOtherFixups += numFixups[FSK_PatchableEntries] +
+                            numFixups[FSK_JumpTable] + numFixups[FSK_Custom];
+
+  // Koo: The linker has to add the fixups of the relocations of the object
+  if (MAI->OmitRelocatedFixups && RI.hasRelocIndices)
+    binaryInfo->set_fixups_from_relocs(true);
+
+  // Koo: The data objects can move only if no reference to them is left out
+  if (MAI->KeepDataFixups)
+    binaryInfo->set_data_fixups(true);
+
+  // Koo: The call-site tables of the functions in this (chunk of the) object
+  if (MAI->emitsRandEHInfo()) {
+    binaryInfo->set_eh_info(true);
+    ShuffleInfo::ReorderInfo_CallSiteColumns* callSites = ri->mutable_call_site_columns();
+    for (const MCCallSiteTable &T : RI.CallSiteTables) {
+      if (!T.isResolved() || !sections.contains(T.FunctionSectionIdx))
+        continue;
+      callSites->add_function_offset(T.FunctionOffset);
+      callSites->add_function_section_idx(sections.getLocal(T.FunctionSectionIdx));
+      callSites->add_table_offset(T.TableOffset);
+      callSites->add_table_section_idx(sections.getLocal(T.TableSectionIdx));
+      callSites->add_num_records(T.NumRecords);
+    }
+    stats::RandCallSiteTables += callSites->num_records_size();
+  }
 
-  // Set the fixup information (.text, .rodata, .data, .data.rel.ro and .init_array)
-  ShuffleInfo::ReorderInfo_FixupInfo* fixupInfo = ri->add_fixup();
-  setFixups(MAI->FixupsText, fixupInfo, ".text");
-  setFixups(MAI->FixupsRodata, fixupInfo, ".rodata");
-  setFixups(MAI->FixupsData, fixupInfo, ".data");
-  setFixups(MAI->FixupsDataRel, fixupInfo, ".data.rel.ro");
-  setFixups(MAI->FixupsInitArray, fixupInfo, ".init_array");
+  // Emit the section string table that both layouts and fixups refer to
+  for (unsigned Idx : sections.getIncluded())
+    ri->add_section_names(RI.SectionNames.getName(Idx));
+
+  if (RI.CollectRandCosts)
+    collectRandCosts(MAI, RI, sections, ri);
+
+  uint64_t shapeHash =
+      MAI->RandFormatVersion >= 3 ? hashFunctionShapes(RI, sections) : 0;
+  if (!sections.isIdentity())
+    return shapeHash;
 
   // Show the fixup information for each section
   DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "\n<Fixups Summary>\n");
-  dumpFixups(MAI->FixupsText, "text", /*isDebug*/ false);
-  dumpFixups(MAI->FixupsRodata, "rodata", false);
-  dumpFixups(MAI->FixupsData, "data", false);
-  dumpFixups(MAI->FixupsDataRel, "data.rel.ro", false);
-  dumpFixups(MAI->FixupsInitArray, "init_array", false);
+  for (unsigned K = 0; K < NumFixupSectionKinds; ++K)
+    dumpFixups(RI.Fixups[K], getFixupSectionKindName(MCFixupSectionKind(K)),
+               /*isDebug*/ false);
+  return shapeHash;
 }
 
 void MCAssembler::layout(MCAsmLayout &Layout) {
@@ -1147,18 +1991,38 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
 
   // Koo - Collect what we need once layout has been finalized
   const MCAsmInfo *MAI = Layout.getAssembler().getContext().getAsmInfo();
+  MCReorderInfo &RI = Layout.getAssembler().getContext().getReorderInfo();
   const MCObjectFileInfo *MOFI = Layout.getAssembler().getContext().getObjectFileInfo();
-  bool isNewTextSection = false, isNewRodataSection = false;
-  bool isNewDataSection = false, isNewDataRelSection = false, isNewInitSection = false;
-  unsigned textSecCtr = 0, rodataSecCtr = 0, dataSecCtr = 0, dataRelSecCtr = 0, initSecCtr = 0;
-  unsigned prevLayoutOrder;
+  bool isELF = MOFI->getObjectFileType() == llvm::MCObjectFileInfo::IsELF;
+  // Nothing is collected (and no section is taken for an ELF one) without -fccr-metadata
+  bool collectRand = MAI->RandMetadata && isELF;
+  std::vector<unsigned> MBBSectionStarts; // Where each .text section begins in MBBLayoutOrder
+  std::vector<IntraSectionFixup> intraSectionFixups;
+  std::vector<IntraSectionFixup> shrinkableFixups; // No TargetOffset
+  std::vector<IntraSectionFixup> relocatedFixups;  // No TargetOffset
+  HighHalfTracker highHalves;
+  // The fixups are collected while they are applied, thus the scope covers both
+  TimeTraceScope fixupScope("CCRCollectFixups", StringRef(""));
   
   // Evaluate and apply the fixups, generating relocation entries as necessary.
   for (MCSection &Sec : *this) {
 	// Koo
-    MCSectionELF &ELFSec = static_cast<MCSectionELF &>(Sec);
-    std::string secName = ELFSec.getSectionName();
-    unsigned layoutOrder = ELFSec.getLayoutOrder();
+    MCFixupSectionKind fixupKind = collectRand
+        ? static_cast<MCSectionELF &>(Sec).getFixupSectionKind()
+        : FSK_None;
+    bool isTextSection = fixupKind == FSK_Text;
+
+    // The fixups of a section go to the list of its kind (if any). Every concrete
+    // section has an index of its own, thus the fixups of -ffunction-sections and
+    // -fdata-sections layouts are grouped by section as they are collected.
+    std::vector<MCFixupRecord> *fixupList =
+        fixupKind < NumFixupSectionKinds ? &RI.Fixups[fixupKind] : nullptr;
+    unsigned secIdx = fixupList ? RI.SectionNames.intern(
+        &Sec, static_cast<MCSectionELF &>(Sec).getSectionName()) : MCMBBInfo::NoSection;
+    bool isNewSection = fixupList && !fixupList->empty();
+    highHalves.reset();
+    if (isTextSection)
+      MBBSectionStarts.push_back(RI.MBBLayoutOrder.size());
 	
     for (MCFragment &Frag : Sec) {
       // Data and relaxable fragments both have fixups.  So only process
@@ -1178,19 +2042,61 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
       if (isa<MCRelaxableFragment>(&Frag) && Frag.hasInstructions())
         prevFrag = static_cast<MCRelaxableFragment*>(&Frag);
 
-      // Update alignment size to reflect to the size of MF and MBB
-      if (MOFI->getObjectFileType() == llvm::MCObjectFileInfo::IsELF && \
-         secName.find(".text") == 0 && (isa<MCAlignFragment>(&Frag)) && fragOffset > 0) {
+      // Koo - A padding fragment (MCCodePadder) before an instruction keeps it clear of
+      //       a boundary: its NOPs are of the MBB of the instruction, which the
+      //       randomizer keeps clear at its new address as well (see getBoundaryBits())
+      auto *paddingFrag = dyn_cast<MCPaddingFragment>(&Frag);
+      uint64_t padSize = paddingFrag && isELF && isTextSection
+                             ? computeFragmentSize(Layout, Frag) : 0;
+      MCMBBKey paddedID;
+      if (padSize && paddingFrag->isInstructionInitialized())
+        paddedID = RI.MBBHandles.lookup(paddingFrag->getInst().getParent());
+      if (paddedID.isValid()) {
+        RI.updateByteCounter(paddedID, padSize, 0, /*isAlign=*/ false);
+        MCMBBInfo &MBB = RI.MachineBasicBlocks[paddedID];
+        MBB.BoundaryOffset = fragOffset + padSize;
+        MBB.BoundarySize = paddingFrag->getInstSize();
+        MBB.BoundaryLog2 = PaddingBoundaryLog2;
+      }
+
+      // Update alignment size to reflect to the size of MF and MBB; a padding
+      // fragment of no known instruction pads as an alignment
+      if (isELF && isTextSection && fragOffset > 0 &&
+          (isa<MCAlignFragment>(&Frag) || (padSize && !paddedID.isValid()))) {
          // Push this alignment to the previous MBB and the MF that the MBB belongs to
          unsigned alignSize;
-         std::string ID;
+         MCMBBKey ID;
          if (isa<MCDataFragment>(*prevFrag))
            ID = static_cast<MCDataFragment*>(prevFrag)->getLastParentTag();
          if (isa<MCRelaxableFragment>(*prevFrag))
-           ID = static_cast<MCRelaxableFragment*>(prevFrag)->getInst().getParent();
+           ID = RI.MBBHandles.lookup(
+               static_cast<MCRelaxableFragment*>(prevFrag)->getInst().getParent());
 
          alignSize = computeFragmentSize(Layout, Frag);
-         MAI->updateByteCounter(ID, alignSize, 0, /*isAlign=*/ true, /*isInline=*/ false);
+         RI.updateByteCounter(ID, alignSize, 0, /*isAlign=*/ true);
+      }
+
+      // Koo - Place the MBBs in the layout order as their fragments show up.
+      //       An MCRelaxableFragment may not have combined with any MCDataFragment
+      //       (i.e., consecutive relaxable fragments of a switch/case).
+      if (isTextSection && Frag.hasInstructions()) {
+        if (isa<MCDataFragment>(&Frag))
+          for (MCMBBKey ID : Frag.getAllMBBs())
+            placeMBB(RI, ID, secIdx);
+        else if (auto *RF = dyn_cast<MCRelaxableFragment>(&Frag)) {
+          MCMBBKey ID = RI.MBBHandles.lookup(RF->getInst().getParent());
+          placeMBB(RI, ID, secIdx);
+
+          // The size of a relaxable fragment is final only after the relaxation
+          // has converged, thus its bytes (relaxed or not) are counted here at once
+          if (ID.isValid()) {
+            uint64_t RFSize = computeFragmentSize(Layout, *RF);
+            RI.updateByteCounter(ID, RFSize, RF->getFixups().size(), /*isAlign=*/ false);
+            MCMBBInfo &MBB = RI.MachineBasicBlocks[ID];
+            if (MBB.TermFragment == RF)
+              MBB.TermSize = RFSize;
+          }
+        }
       }
 	  
       if (isa<MCEncodedFragment>(&Frag) &&
@@ -1232,119 +2138,236 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
         bool IsResolved;
 		bool IsPCRel; // Koo
 		
+        // Koo: The index that the relocation of the fixup (if any) gets
+        Optional<uint64_t> numRelocs =
+            fixupList ? getWriter().getNumRelocations(Sec) : None;
         MCValue Target;
         std::tie(Target, FixedValue, IsResolved, IsPCRel) = // Koo
             handleFixup(Layout, Frag, Fixup);
         getBackend().applyFixup(*this, Fixup, Target, Contents, FixedValue,
                                 IsResolved, STI);
 		
-		// Koo: Collect fixups here (ELF format only)
-        if (MOFI->getObjectFileType() == llvm::MCObjectFileInfo::IsELF) {
-            unsigned offset = fragOffset + Fixup.getOffset();
-            unsigned derefSize = getBackend().getFixupKindLog2Size(Fixup.getKind());
-            unsigned jtEntryKind = 0, jtEntrySize = 0, numJTEntries = 0;
-            std::map<std::string, std::tuple<unsigned, unsigned, std::list<std::string>>> JTs = MOFI->getJumpTableTargets();
-            std::string fixupParentID = Fixup.getFixupParentID();
-            std::string SymbolRefFixupName = Fixup.getSymbolRefFixupName();
-            std::list<std::string> JTEs; // contains all target(MFID_MBBID) in the JT
-
-            // The following handles multiple sections in C++
-            if (secName.find(".text") == 0) {
-              if (textSecCtr == 0) {
-                prevLayoutOrder = layoutOrder;
-                textSecCtr++;
-              }
-              else {
-                isNewTextSection = (layoutOrder == prevLayoutOrder) ? false:true;
-                if (isNewTextSection) textSecCtr++;
-                prevLayoutOrder = layoutOrder;
-              }
-              if (Fixup.getIsJumpTableRef()) {
-                std::tie(jtEntryKind, jtEntrySize, JTEs) = JTs[Fixup.getSymbolRefFixupName()];
-                numJTEntries = JTEs.size();
-              }
-              MAI->FixupsText.push_back(std::make_tuple(offset, derefSize, IsPCRel, \
-                   fixupParentID, SymbolRefFixupName, isNewTextSection, secName, numJTEntries, jtEntrySize));
-            }
+		// Koo: Collect fixups here (ELF format only); debug_* sections are not needed
+        if (isELF && fixupList) {
+          // A d2d fixup never changes by reordering, thus it is left out unless asked for;
+          // every fixup in .text is kept because a PC-relative c2d one moves with its BBL
+          MCFixupTargetKind targetKind = getFixupTargetKind(Target);
+          if (!isTextSection && targetKind == FTK_Data && !MAI->KeepDataFixups)
+            continue;
+          // Nor is a resolved difference of two symbols in one section, which is a distance
+          // rather than an address; that of a function-relative jump table entry
+          // (.LBB0_3-.LJTB0) is patched along with its table by the randomizer
+          if (!isTextSection && IsResolved && isIntraSectionDifference(Target))
+            continue;
+
+          MCFixupRecord FR;
+          FR.Offset = fragOffset + Fixup.getOffset();
+          FR.DerefSize = getBackend().getFixupKindLog2Size(Fixup.getKind());
+          // An unresolved difference from a symbol of its own section is PC-relative
+          // too, as the ELF writer relocates it (i.e., the TOC setup of a PPC64
+          // global entry point, (.TOC.-.Lfunc_gep0)@ha/@l)
+          FR.IsRela = IsPCRel || (isTextSection && !IsResolved && Target.getSymB() &&
+                                  Target.getSymB()->getSymbol().isInSection() &&
+                                  &Target.getSymB()->getSymbol().getSection() == &Sec);
+          FR.ReachLog2 = IsPCRel ? getBackend().getFixupKindReachLog2(Fixup.getKind()) : 0;
+          FR.ParentID = RI.MBBHandles.lookup(Fixup.getFixupParentID());
+          FR.JumpTableRef = RI.JTHandles.lookup(Fixup.getJumpTableRef());
+          FR.SectionIdx = secIdx;
+          FR.TargetKind = targetKind;
+          FR.RefClass = getFixupRefClass(Target);
+          // The linker may relax a GOTPCRELX reference into a direct one, which the
+          // randomizer keeps rather than reading its bytes as a GOT load
+          if (isTextSection && !IsResolved && MAI->canRelaxRelocations() &&
+              Target.getSymA() &&
+              Target.getSymA()->getKind() == MCSymbolRefExpr::VK_GOTPCREL)
+            FR.GOTRelax = getBackend().getFixupKindGOTRelax(Fixup.getKind());
+          FR.PairDelta = highHalves.visit(Target, fixupList->size());
+          RI.hasRelocIndices = numRelocs.hasValue();
+          if (numRelocs && !IsResolved &&
+              getWriter().getNumRelocations(Sec).getValue() > *numRelocs)
+            FR.RelocIdx = *numRelocs + 1;
+
+          // A resolved PC-relative fixup into its own section may be intra-function
+          if (isTextSection) {
+            FR.Scope = getFixupScope(Target);
+            const MCSymbolRefExpr *A = Target.getSymA();
+            if (IsResolved && IsPCRel && A && !Target.getSymB() &&
+                A->getSymbol().isInSection() && &A->getSymbol().getSection() == &Sec)
+              intraSectionFixups.push_back(
+                  {unsigned(fixupList->size()), unsigned(MBBSectionStarts.size() - 1),
+                   Layout.getSymbolOffset(A->getSymbol())});
+          }
 
-            else if (secName.find(".rodata") == 0) {
-              if (rodataSecCtr == 0) {
-                prevLayoutOrder = layoutOrder;
-                rodataSecCtr++;
-              }
-              else {
-                isNewRodataSection = (layoutOrder == prevLayoutOrder) ? false:true;
-                if (isNewRodataSection) rodataSecCtr++;
-                prevLayoutOrder = layoutOrder;
-              }
-              MAI->FixupsRodata.push_back(std::make_tuple(offset, derefSize, IsPCRel, \
-                   fixupParentID, SymbolRefFixupName, isNewRodataSection, secName, numJTEntries, jtEntrySize));
-            }
+          // Let the linker know that the first fixup of another section of the kind begins here
+          FR.IsNewSection = isNewSection;
+          isNewSection = false;
 
-            else if (secName.find(".data") == 0) {
-              // The following special section could be generated to support RELRO option
-              // "When gcc sees a variable which is constant but requires a dynamic relocation, 
-              // it puts it into a section named .data.rel.ro"
-              if (secName.find(".data.rel.ro") == 0) {
-                if (dataRelSecCtr == 0) {
-                  prevLayoutOrder = layoutOrder;
-                  dataRelSecCtr++;
-                }
-                else {
-                  isNewDataRelSection = (layoutOrder == prevLayoutOrder) ? false:true;
-                  if (isNewDataRelSection) dataRelSecCtr++;
-                  prevLayoutOrder = layoutOrder;
-                }
-                MAI->FixupsDataRel.push_back(std::make_tuple(offset, derefSize, IsPCRel, \
-                     fixupParentID, SymbolRefFixupName, isNewDataRelSection, secName, numJTEntries, jtEntrySize));
-              }
-
-              else {
-                if (dataSecCtr == 0) {
-                  prevLayoutOrder = layoutOrder;
-                  dataSecCtr++;
-                }
-                else {
-                  isNewDataSection =  (layoutOrder == prevLayoutOrder) ? false:true;
-                  if (isNewDataSection) dataSecCtr++;
-                  prevLayoutOrder = layoutOrder;
-                }
-                MAI->FixupsData.push_back(std::make_tuple(offset, derefSize, IsPCRel, \
-                     fixupParentID, SymbolRefFixupName, isNewDataSection, secName, numJTEntries, jtEntrySize));
+          if (isTextSection) {
+            if (Fixup.getIsJumpTableRef()) {
+              if (const MCJumpTableInfo *JT = RI.lookupJumpTable(FR.JumpTableRef)) {
+                FR.JTEntrySize = JT->EntrySize;
+                FR.NumJTEntries = JT->Entries.size();
+                FR.JTFunctionRelative = JT->FunctionRelative;
               }
             }
-
-            else if (secName.find(".init_array") == 0) {
-              if (initSecCtr == 0) {
-                prevLayoutOrder = layoutOrder;
-                initSecCtr++;
-              }
-              else {
-                isNewInitSection = (layoutOrder == prevLayoutOrder) ? false:true;
-                if (isNewInitSection) initSecCtr++;
-                prevLayoutOrder = layoutOrder;
-              }
-              MAI->FixupsInitArray.push_back(std::make_tuple(offset, derefSize, IsPCRel, \
-                   fixupParentID, SymbolRefFixupName, isNewInitSection, secName, numJTEntries, jtEntrySize));
+            if (auto *RF = dyn_cast<MCRelaxableFragment>(&Frag)) {
+              recordRelaxation(*this, *RF, Fixup, FR);
+              recordShrink(*RF, Fixup, FR);
+              if (FR.ShrinkLongSize > 0)
+                shrinkableFixups.push_back({unsigned(fixupList->size()),
+                                            unsigned(MBBSectionStarts.size() - 1), 0});
             }
-
-            // else // debug_* sections
+          }
+          if (isTextSection && FR.RelocIdx > 0 && MAI->OmitRelocatedFixups)
+            relocatedFixups.push_back({unsigned(fixupList->size()),
+                                       unsigned(MBBSectionStarts.size() - 1), 0});
+          fixupList->push_back(FR);
         }
       }
     }
   }
+
+  // Koo - Offsets and sizes of the MFs/MBBs are final now
+  if (collectRand) {
+    coarsenReorderLayout(RI, MBBSectionStarts);
+    finalizeReorderLayout(Layout, MBBSectionStarts);
+    classifyTextFixupScopes(RI, MAI->hasRandFunctionGranularity(), MBBSectionStarts,
+                            intraSectionFixups, shrinkableFixups, relocatedFixups);
+    if (MAI->OmitRelocatedFixups)
+      omitRelocatedDataFixups(RI);
+    resolveCallSiteTables(Layout);
+
+    // Every fixup and jump table has been resolved to its MBB by now, thus
+    // only the records that go to .rand are kept until it is written
+    RI.MBBHandles.release();
+    RI.JTHandles.release();
+    RI.JumpTableTargets.clear();
+  }
+}
+
+namespace {
+// Koo: The protobuf library is set up once per process and torn down by llvm_shutdown(),
+//      so that any number of objects (i.e., LTO codegen partitions or ThinLTO backend
+//      threads) can emit their own .rand section in the same process.
+struct ProtobufLibraryLifetime {
+  ProtobufLibraryLifetime() { GOOGLE_PROTOBUF_VERIFY_VERSION; }
+  ~ProtobufLibraryLifetime() { google::protobuf::ShutdownProtobufLibrary(); }
+};
+
+// Koo: Feed the protobuf encoder straight into the object file stream
+class RawOstreamCopyingOutputStream : public google::protobuf::io::CopyingOutputStream {
+  raw_ostream &OS;
+
+public:
+  explicit RawOstreamCopyingOutputStream(raw_ostream &OS) : OS(OS) {}
+
+  bool Write(const void *Buffer, int Size) override {
+    OS.write(static_cast<const char *>(Buffer), Size);
+    return true; // raw_ostream reports write errors on its own
+  }
+};
+} // end anonymous namespace
+
+static ManagedStatic<ProtobufLibraryLifetime> ProtobufLibrary;
+
+// Koo: Move the section string table of reorder_info into a chunk header (see
+//      llvm/BinaryFormat/RandChunk.h), followed by the section entries and names;
+//      the linker fills in the output offsets (Base, RandObjOffset, MainAddrOffset)
+//      Return the size of the padding that has to follow the payload
+static uint64_t writeRandChunkHeader(raw_ostream &OS,
+                                     ShuffleInfo::ReorderInfo *reorder_info,
+                                     uint64_t shapeHash) {
+  std::vector<ccr::ChunkSection> Sections;
+  std::string Names;
+  StringMap<unsigned> NumSeen; // The ordinal of the next section of a name
+  for (const std::string &Name : reorder_info->section_names()) {
+    ccr::ChunkSection CS;
+    CS.Base = 0;
+    CS.NameOffset = Names.size();
+    CS.Ordinal = NumSeen[Name]++;
+    Sections.push_back(CS);
+    Names += Name;
+    Names.push_back('\0');
+  }
+  reorder_info->clear_section_names();
+
+  ccr::ChunkHeader H;
+  H.Signature = ccr::ChunkHeader::MagicSignature;
+  H.Version = ccr::ChunkHeader::CurrentVersion;
+  H.NumSections = Sections.size();
+  H.NamesSize = Names.size();
+  H.PayloadSize = reorder_info->ByteSizeLong(); // Cached for the serializer
+  H.RandObjOffset = 0;
+  H.MainAddrOffset = 0;
+  H.NumLayouts = reorder_info->layout_size() +
+                 reorder_info->layout_columns().bb_size_size();
+  uint64_t numFixups = 0;
+  for (const ShuffleInfo::ReorderInfo_FixupInfo &FI : reorder_info->fixup())
+    numFixups += FI.text_size() + FI.rodata_size() + FI.data_size() +
+                 FI.datarel_size() + FI.initarray_size() + FI.finiarray_size() +
+                 FI.tdata_size();
+  for (const ShuffleInfo::ReorderInfo_FixupColumns *C :
+       {&reorder_info->text_fixup_columns(), &reorder_info->rodata_fixup_columns(),
+        &reorder_info->data_fixup_columns(), &reorder_info->datarel_fixup_columns(),
+        &reorder_info->initarray_fixup_columns(),
+        &reorder_info->finiarray_fixup_columns(),
+        &reorder_info->tdata_fixup_columns()})
+    numFixups += C->deref_sz_size();
+  H.NumFixups = numFixups;
+  H.ShapeHash = shapeHash;
+  H.PayloadRef = ccr::ChunkHeader::NoPayloadRef;
+
+  OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+  OS.write(reinterpret_cast<const char *>(Sections.data()),
+           Sections.size() * sizeof(ccr::ChunkSection));
+  OS << Names;
+  return ccr::getChunkSize(H) - (sizeof(H) + H.NumSections * sizeof(ccr::ChunkSection) +
+                                 H.NamesSize + H.PayloadSize);
 }
 
 // Koo: Serialize reorder_info data with Google's protocol buffer format, calling by
 //      ELFObjectWriter::writeSectionData() from writeObject()@ELFObjectWriter.cpp
-std::string MCAssembler::WriteRandInfo(const MCAsmLayout &Layout) const {
-  ShuffleInfo::ReorderInfo reorder_info;
-  serializeReorderInfo(&reorder_info, Layout);
-  std::string randContents;
-
-  if (!reorder_info.SerializeToString(&randContents)) {
-    errs() << "[CCR-Error] MCAssembler::WriteRandInfo - Failed to serialize the shuffling information to .rand section! \n";
+//      The encoded message is streamed into OS without an intermediate std::string
+void MCAssembler::WriteRandInfo(raw_ostream &OS, const MCAsmLayout &Layout,
+                                const MCSectionELF *Rand) const {
+  // Thread-safe one-time initialization; everything below only touches
+  // this assembler's own context and a local arena
+  (void)*ProtobufLibrary;
+  uint64_t startOffset = OS.tell();
+
+  // Build the whole message tree on an arena so that the per-BBL/per-fixup
+  // messages cost a handful of bulk allocations, all released at once
+  google::protobuf::ArenaOptions arenaOptions;
+  arenaOptions.start_block_size = 64 * 1024;
+  arenaOptions.max_block_size = 1024 * 1024;
+  google::protobuf::Arena arena(arenaOptions);
+  ShuffleInfo::ReorderInfo* reorder_info =
+      google::protobuf::Arena::CreateMessage<ShuffleInfo::ReorderInfo>(&arena);
+  uint64_t shapeHash = serializeReorderInfo(reorder_info, Layout, Rand);
+
+  // Koo: A relocatable chunk (format 3) carries the concrete sections in its header,
+  //      which the linker patches in place while concatenating the chunks
+  const MCAsmInfo *MAI = getContext().getAsmInfo();
+  uint64_t chunkPadding = 0;
+  if (MAI->RandFormatVersion >= 3)
+    chunkPadding = writeRandChunkHeader(OS, reorder_info, shapeHash);
+
+  // The adaptor only holds a small block buffer; the message sizes are
+  // computed (and cached) up front by the encoder
+  // The deterministic mode pins the order of the map fields, should any be added
+  RawOstreamCopyingOutputStream copyingStream(OS);
+  google::protobuf::io::CopyingOutputStreamAdaptor outputStream(&copyingStream);
+  {
+    google::protobuf::io::CodedOutputStream codedStream(&outputStream);
+    codedStream.SetSerializationDeterministic(true);
+    if (!reorder_info->SerializeToCodedStream(&codedStream)) {
+      errs() << "[CCR-Error] MCAssembler::WriteRandInfo - Failed to serialize the shuffling information to .rand section! \n";
+    }
   }
+  outputStream.Flush();
+
+  OS.write_zeros(chunkPadding);
+  stats::RandBytes += OS.tell() - startOffset;
 
   // Koo: MCObjectWriter has been reshaped: writeBytes() is gone; thus
   // 	  https://reviews.llvm.org/D47043 (as of Aug. 2019)
@@ -1353,14 +2376,14 @@ std::string MCAssembler::WriteRandInfo(const MCAsmLayout &Layout) const {
   //OW.writeBytes(randContents);
   //MCObjectWriter *Writer = getWriterPtr();
   
-  std::string objFileName(Layout.getAssembler().getContext().getMainFileName());
-
-  if (objFileName.length() == 0)
-    objFileName = getObjTmpName();
-
-  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "Successfully wrote the metadata in a .rand section for " << objFileName << "\n");
-  google::protobuf::ShutdownProtobufLibrary();
-  return randContents;
+  // Koo: The object is streamed to wherever it goes (a pipe, the memory), thus
+  //      the metadata is reported by the source file (.file) rather than by
+  //      the name of the object.
+  StringRef sourceName = getContext().getMainFileName();
+  if (sourceName.empty() && !FileNames.empty())
+    sourceName = FileNames.front();
+
+  DEBUG_WITH_TYPE("ccr-metadata", dbgs() << "Successfully wrote the metadata in a .rand section for " << sourceName << "\n");
 }
 
 void MCAssembler::Finish() {
@@ -1408,33 +2431,8 @@ bool MCAssembler::relaxInstruction(MCAsmLayout &Layout,
                                    MCRelaxableFragment &F) {
   assert(getEmitterPtr() &&
          "Expected CodeEmitter defined for relaxInstruction");
-		 
-  // Koo
-  // Whether or not the instruction has been relaxed
-  // The RelaxableFragment must be counted as the emitted bytes
-  const MCAsmInfo *MAI = Layout.getAssembler().getContext().getAsmInfo();
-  std::string ID = F.getInst().getParent();
-  unsigned relaxedBytes = F.getRelaxedBytes();
-  unsigned fixupCtr = F.getFixup();
-  
-  if (!fragmentNeedsRelaxation(&F, Layout)) {
-    // [Case 1] Unrelaxed instruction
-    if (ID.length() > 0) {
-      unsigned curBytes = F.getInst().getByteCtr();
-      if (relaxedBytes < curBytes) {
-        // RelaxableFragment always contains relaxedBytes and fixupCtr variable 
-        // for the adjustment in case of re-evaluation (simple hack but tricky)
-        MAI->updateByteCounter(ID, curBytes - relaxedBytes, 1 - fixupCtr, 
-                              /*isAlign=*/ false, /*isInline=*/ false);
-        F.setRelaxedBytes(curBytes);
-        F.setFixup(1);
-
-        // If this fixup points to Jump Table Symbol, update it.
-        F.getFixups()[0].setFixupParentID(ID);
-      }
-    }
+  if (!fragmentNeedsRelaxation(&F, Layout))
     return false;
-  }
 
   ++stats::RelaxedInstructions;
 
@@ -1455,22 +2453,25 @@ bool MCAssembler::relaxInstruction(MCAsmLayout &Layout,
   raw_svector_ostream VecOS(Code);
   getEmitter().encodeInstruction(Relaxed, VecOS, Fixups, *F.getSubtargetInfo());
 
+  // Koo: The short form is kept for the randomizer to shrink the branch back
+  //      (see recordShrink()), if its only fixup is the displacement at its end
+  if (getContext().getAsmInfo()->RandMetadata && F.getShortForm().empty() &&
+      F.getFixups().size() == 1 &&
+      F.getFixups()[0].getOffset() +
+              getBackend().getFixupKindLog2Size(F.getFixups()[0].getKind()) ==
+          F.getContents().size())
+    F.setShortForm(StringRef(F.getContents().data(), F.getContents().size()));
+
+  // Koo: The relaxed instruction (and its fixups) stays in the same MBB; the
+  //      MBB size is taken from the final fragment size once layout has converged
+  Relaxed.setParent(F.getInst().getParent());
+  for (MCFixup &Fixup : Fixups)
+    Fixup.setFixupParentID(Relaxed.getParent());
+
   // Update the fragment.
   F.setInst(Relaxed);
   F.getContents() = Code;
   F.getFixups() = Fixups;
-  
-  // Koo [Case 2] Relaxed instruction: 
-  // The only relaxations X86 does is from a 1byte pcrel to a 4byte pcrel
-  // Note: The relaxable fragment could be re-evaluated multiple times for relaxation
-  //       Thus update it only if the relaxable fragment has not been relaxed previously 
-  if (relaxedBytes < Code.size() && ID.length() > 0) {
-    MAI->updateByteCounter(ID, Code.size() - relaxedBytes, 1 - fixupCtr, \
-                           /*isAlign=*/ false, /*isInline=*/ false);
-    F.setRelaxedBytes(Code.size());
-    F.setFixup(1);
-    F.getFixups()[0].setFixupParentID(ID);
-  }
 
   return true;
 }
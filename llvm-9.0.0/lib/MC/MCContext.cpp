@@ -22,6 +22,7 @@
 #include "llvm/MC/MCFragment.h"
 #include "llvm/MC/MCLabel.h"
 #include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCReorderInfo.h"
 #include "llvm/MC/MCSectionCOFF.h"
 #include "llvm/MC/MCSectionELF.h"
 #include "llvm/MC/MCSectionMachO.h"
@@ -102,6 +103,7 @@ void MCContext::reset() {
   CurrentDwarfLoc = MCDwarfLoc(0, 0, 0, DWARF2_FLAG_IS_STMT, 0, 0);
 
   CVContext.reset();
+  ReorderInfo.reset();
 
   MachOUniquingMap.clear();
   ELFUniquingMap.clear();
@@ -645,6 +647,12 @@ CodeViewContext &MCContext::getCVContext() {
   return *CVContext.get();
 }
 
+MCReorderInfo &MCContext::getReorderInfo() {
+  if (!ReorderInfo)
+    ReorderInfo.reset(new MCReorderInfo);
+  return *ReorderInfo;
+}
+
 //===----------------------------------------------------------------------===//
 // Error Reporting
 //===----------------------------------------------------------------------===//
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/MC/MCELFStreamer.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/BinaryFormat/ELF.h"
@@ -362,16 +363,38 @@ void MCELFStreamer::EmitValueToAlignment(unsigned ByteAlignment,
 
 // Koo
 void MCELFStreamer::EmitRand() {
-  MCSection *Rand = getAssembler().getContext().getELFSection(
+  MCContext &Ctx = getAssembler().getContext();
+  if (!Ctx.getAsmInfo()->RandMetadata)
+    return;
+  MCSection *Rand = Ctx.getELFSection(
       ".rand", ELF::SHT_PROGBITS, ELF::SHF_STRINGS, 1, "");
   PushSection();
   SwitchSection(Rand);
-  PopSection();
-}
 
-// Koo
-void MCELFStreamer::setObjTmpName(std::string tmpFileName) {
-  getAssembler().setObjTmpName(tmpFileName);
+  // Koo: With relocatable chunks (format 3), each COMDAT group that holds CCR
+  //      metadata gets a .rand of its own in the group; the linker keeps (or
+  //      discards) it along with the code of the group. A section that may be
+  //      garbage-collected gets a .rand linked to it (-ccr-rand-per-section).
+  const MCAsmInfo *MAI = Ctx.getAsmInfo();
+  if (MAI->RandFormatVersion >= 3) {
+    SmallVector<MCSection *, 8> Rands;
+    SmallPtrSet<const MCSymbolELF *, 8> Seen;
+    for (MCSection &Sec : getAssembler()) {
+      auto &ELFSec = static_cast<MCSectionELF &>(Sec);
+      if (ELFSec.getFixupSectionKind() == FSK_None)
+        continue;
+      const MCSymbolELF *Group = ELFSec.getGroup();
+      if (MAI->hasLinkedRandSection(ELFSec))
+        Rands.push_back(Ctx.getObjectFileInfo()->getLinkedRandSection(ELFSec));
+      else if (Group && Seen.insert(Group).second)
+        Rands.push_back(Ctx.getELFSection(".rand", ELF::SHT_PROGBITS,
+                                          ELF::SHF_STRINGS | ELF::SHF_GROUP, 1,
+                                          Group->getName()));
+    }
+    for (MCSection *R : Rands)
+      SwitchSection(R);
+  }
+  PopSection();
 }
 
 void MCELFStreamer::emitCGProfileEntry(const MCSymbolRefExpr *From,
@@ -539,8 +562,14 @@ void MCELFStreamer::EmitInstToData(const MCInst &Inst,
   raw_svector_ostream VecOS(Code);
   Assembler.getEmitter().encodeInstruction(Inst, VecOS, Fixups, STI);
   
-  // Koo: Obtain the parent of this instruction (MFID_MBBID)
-  std::string ID = Inst.getParent();
+  // Koo: Obtain the parent of this instruction (MFID_MBBID); a parsed one (of
+  //      inline or standalone assembly) has none and belongs to the latest parent
+  MCReorderInfo &RI = Assembler.getContext().getReorderInfo();
+  bool RandMetadata = Assembler.getContext().getAsmInfo()->RandMetadata;
+  MCMBBHandle IDHandle = Inst.getParent();
+  if (RandMetadata && !IDHandle.isValid())
+    IDHandle = RI.MBBHandles.intern(RI.latestParentID);
+  MCMBBKey ID = RandMetadata ? RI.MBBHandles.lookup(IDHandle) : MCMBBKey();
 
   for (unsigned i = 0, e = Fixups.size(); i != e; ++i)
     fixSymbolsInTLSFixups(Fixups[i].getValue());
@@ -614,35 +643,28 @@ void MCELFStreamer::EmitInstToData(const MCInst &Inst,
     Fixups[i].setOffset(Fixups[i].getOffset() + DF->getContents().size());
 	
 	// Koo
-    Fixups[i].setFixupParentID(ID);
+    if (!RandMetadata) {
+      DF->getFixups().push_back(Fixups[i]);
+      continue;
+    }
+    Fixups[i].setFixupParentID(IDHandle);
     const MCExpr *FixupExpr = Fixups[i].getValue();
-    std::string SymName;
-
-    // FIXME: This is obviously not a good implementation this way but... 
-    if (FixupExpr->getKind() == MCExpr::SymbolRef || FixupExpr->getKind() == MCExpr::Binary) {
-      std::string JTPrefix = ".LJTI";
-      if (FixupExpr->getKind() == MCExpr::SymbolRef) {
-        const MCSymbolRefExpr &SRE1 = cast<MCSymbolRefExpr>(*FixupExpr);
-        const MCSymbol &Sym1 = SRE1.getSymbol();
-        SymName = Sym1.getName().str();
-      }
-
-      // This code is added because of pic/pie option
-      //    Fixup kind is "MCExpr::Binary" rather than "MCExpr::SymbolRef"
-      //    So here we evaluate BE.getLHS() instead
-      if (FixupExpr->getKind() == MCExpr::Binary) {
-        const MCBinaryExpr &BE = cast<MCBinaryExpr>(*FixupExpr);
-        if (isa<MCSymbolRefExpr>(BE.getLHS())) {
-          const MCSymbolRefExpr &SRE2 = cast<MCSymbolRefExpr>(*BE.getLHS());
-          const MCSymbol &Sym2 = SRE2.getSymbol();
-          SymName = Sym2.getName().str();
-        }
-      }
 
-      // Update the symbol reference for JT only for now.
-      if (SymName.find(JTPrefix) != std::string::npos) {
-        Fixups[i].setIsJumpTableRef(true);
-        Fixups[i].setSymbolRefFixupName(SymName.substr(JTPrefix.length(), SymName.length()));
+    // This code is added because of pic/pie option
+    //    Fixup kind is "MCExpr::Binary" rather than "MCExpr::SymbolRef"
+    //    So here we evaluate BE.getLHS() instead
+    if (const MCBinaryExpr *BE = dyn_cast<MCBinaryExpr>(FixupExpr))
+      FixupExpr = BE->getLHS();
+
+    // Update the symbol reference for JT only for now: .LJTI<MFID>_<JTI>
+    if (const MCSymbolRefExpr *SRE = dyn_cast<MCSymbolRefExpr>(FixupExpr)) {
+      StringRef SymName = SRE->getSymbol().getName();
+      if (SymName.consume_front(".LJTI")) {
+        StringRef MFStr, JTStr;
+        unsigned MFID, JTI;
+        std::tie(MFStr, JTStr) = SymName.split('_');
+        if (!MFStr.getAsInteger(10, MFID) && !JTStr.getAsInteger(10, JTI))
+          Fixups[i].setJumpTableRef(RI.JTHandles.intern(MCJTKey(MFID, JTI)));
       }
     }
 	
@@ -654,25 +676,22 @@ void MCELFStreamer::EmitInstToData(const MCInst &Inst,
   // Koo: Here combines the emitted data as MCDataFragment
   //      addMachineBasicBlockTag() keeps track of the IDs that identifies (MF+MBB) pair
   //      MCRelaxableFragment will be generating in MCObjectStreamer::EmitInstToFragment()
-  unsigned EmittedBytes = Code.size();
-  const MCAsmInfo *MAI = Assembler.getContext().getAsmInfo();
-  unsigned numFixups = Fixups.size();
-
-  // Sometimes there exists the instruction with missing parentID (!!!!)
-  // Another corner case: However, we need to update the emitted bytes anyways
-  // For example, "cld; rep; stosq\n" emits 0xFC, (0xF3, 0x48), and 0xAB respectively with no parentID
-  if (ID.length() == 0)
-    ID = MAI->latestParentID;
-
-  DF->setLastParentTag(ID);
-  DF->addMachineBasicBlockTag(ID);
-  MAI->updateByteCounter(ID, EmittedBytes, numFixups, /*isAlign=*/ false, /*isInline=*/ false);
-
-  unsigned size, offset, fixups, alignments, type;
-  std::string sectionName;
-  std::tie(size, offset, fixups, alignments, type, sectionName) = MAI->MachineBasicBlocks[ID];
-
-  MAI->latestParentID = ID;
+  if (RandMetadata) {
+    unsigned EmittedBytes = Code.size();
+    unsigned numFixups = Fixups.size();
+
+    // Sometimes there exists the instruction with missing parentID (!!!!)
+    // Another corner case: However, we need to update the emitted bytes anyways
+    // For example, "cld; rep; stosq\n" emits 0xFC, (0xF3, 0x48), and 0xAB respectively with no parentID
+    if (!ID.isValid())
+      ID = RI.latestParentID;
+
+    DF->setLastParentTag(ID);
+    DF->addMachineBasicBlockTag(ID);
+    RI.updateByteCounter(ID, EmittedBytes, numFixups, /*isAlign=*/ false);
+    RI.updateTerminator(ID, EmittedBytes, /*RF=*/ nullptr);
+    RI.latestParentID = ID;
+  }
 
   if (Assembler.isBundlingEnabled() && Assembler.getRelaxAll()) {
     if (!isBundleLocked()) {
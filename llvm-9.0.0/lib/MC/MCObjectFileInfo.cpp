@@ -859,3 +859,20 @@ MCObjectFileInfo::getStackSizesSection(const MCSection &TextSec) const {
   return Ctx->getELFSection(".stack_sizes", ELF::SHT_PROGBITS, Flags, 0,
                             GroupName, UniqueID, cast<MCSymbolELF>(Link));
 }
+
+MCSection *MCObjectFileInfo::getLinkedRandSection(const MCSection &Sec) const {
+  const MCSectionELF &ElfSec = static_cast<const MCSectionELF &>(Sec);
+  unsigned Flags = ELF::SHF_STRINGS | ELF::SHF_LINK_ORDER;
+  StringRef GroupName;
+  if (const MCSymbol *Group = ElfSec.getGroup()) {
+    GroupName = Group->getName();
+    Flags |= ELF::SHF_GROUP;
+  }
+
+  const MCSymbol *Link = Sec.getBeginSymbol();
+  auto It = RandUniquing.insert({Link, RandUniquing.size()});
+  unsigned UniqueID = It.first->second;
+
+  return Ctx->getELFSection(".rand", ELF::SHT_PROGBITS, Flags, 1, GroupName,
+                            UniqueID, cast<MCSymbolELF>(Link));
+}
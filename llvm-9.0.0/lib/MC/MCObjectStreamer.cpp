@@ -197,11 +197,6 @@ void MCObjectStreamer::EmitRand() {
     // Nothing to define here: Will define for ELF only at this time
 }
 
-// Koo
-void MCObjectStreamer::setObjTmpName(std::string tmpFileName) {
-    // Nothing to define here: Will define for ELF only at this time
-}
-
 void MCObjectStreamer::EmitValueImpl(const MCExpr *Value, unsigned Size,
                                      SMLoc Loc) {
   MCStreamer::EmitValueImpl(Value, Size, Loc);
@@ -383,15 +378,27 @@ void MCObjectStreamer::EmitInstToFragment(const MCInst &Inst,
   // during relaxation.
   MCRelaxableFragment *IF = new MCRelaxableFragment(Inst, STI);
   
-  // Koo: Process the parent of this instruction when emitting to a separate fragment
-  std::string ID = Inst.getParent();
+  // Koo: Process the parent of this instruction when emitting to a separate fragment;
+  //      a parsed instruction has none and belongs to the latest parent, which its
+  //      fragment keeps for the layout (see MCAssembler::layout())
   MCAssembler &Assembler = getAssembler();
-  const MCAsmInfo *MAI = Assembler.getContext().getAsmInfo();
-
-  if (ID.size() == 0)
-    ID = MAI->latestParentID;
-  IF->addMachineBasicBlockTag(ID);
-  MAI->latestParentID = ID;
+  bool RandMetadata = Assembler.getContext().getAsmInfo()->RandMetadata;
+  MCMBBHandle IDHandle = Inst.getParent();
+  if (RandMetadata) {
+    MCReorderInfo &RI = Assembler.getContext().getReorderInfo();
+    MCMBBKey ID = RI.MBBHandles.lookup(IDHandle);
+
+    if (!ID.isValid()) {
+      ID = RI.latestParentID;
+      IDHandle = RI.MBBHandles.intern(ID);
+      MCInst Tagged = Inst;
+      Tagged.setParent(IDHandle);
+      IF->setInst(Tagged);
+    }
+    IF->addMachineBasicBlockTag(ID);
+    RI.updateTerminator(ID, 0, IF);
+    RI.latestParentID = ID;
+  }
   
   insert(IF);
 
@@ -403,11 +410,10 @@ void MCObjectStreamer::EmitInstToFragment(const MCInst &Inst,
   
   // Koo: also see the overwritten function of the derived class; i.e. MCELFStreamer::EmitInstToData()
   // [Note] At this point MCRelaxableFragment has not been relaxed yet
-  //        Thus updateByteCounter() collect the final bytes at MCAssembler::relaxInstruction()
-  //        after it determines the need of the instruction relaxation and have it done.
-  // errs() << "MCObjectStreamer::EmitInstToData " << Code.size() << "B, STI: " << STI.getByteCtr() << "B\n";
-  IF->getInst().setByteCtr(Code.size());
-  IF->getInst().setFixupCtr(1);
+  //        Thus MCAssembler::layout() counts its final bytes once the relaxation has converged.
+  if (RandMetadata)
+    for (MCFixup &Fixup : IF->getFixups())
+      Fixup.setFixupParentID(IDHandle);
 }
 
 #ifndef NDEBUG
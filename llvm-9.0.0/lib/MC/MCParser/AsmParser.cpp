@@ -17,6 +17,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
@@ -71,6 +72,12 @@
 
 using namespace llvm;
 
+#define DEBUG_TYPE "asm-parser"
+
+// Koo
+STATISTIC(RandDirectiveBytes, "Number of data directive bytes (i.e., .byte in "
+                              "inline asm) attributed to BBLs for CCR");
+
 MCAsmParserSemaCallback::~MCAsmParserSemaCallback() = default;
 
 static cl::opt<unsigned> AsmMacroMaxNestingDepth(
@@ -1841,8 +1848,10 @@ bool AsmParser::parseStatement(ParseStatementInfo &Info,
 
     // Emit the label.
     if (!getTargetParser().isParsingInlineAsm()) {
-      // Koo: each label begins a new basic block (is this reliable?)
-      MAI.assemBBLNo++;
+      // Koo: a label may be a branch target, thus it begins a new basic block
+      MCReorderInfo &RI = Ctx.getReorderInfo();
+      if (RI.isAssemFile)
+        RI.beginAssemBBL();
       Out.EmitLabel(Sym, IDLoc);
     }
 
@@ -2262,28 +2271,25 @@ bool AsmParser::parseStatement(ParseStatementInfo &Info,
     uint64_t ErrorInfo;
 	
 	// Koo
-    if (MAI.isAssemFile) {
-      const MCSubtargetInfo &STI = getTargetParser().getSTI();
-
-      if (MAI.assemFuncNo == 0xffffffff) 
-        MAI.assemFuncNo = 0;
-
-      STI.setParentID(std::to_string(MAI.assemFuncNo) + "_" + std::to_string(MAI.assemBBLNo));
-      MAI.latestParentID = STI.getParentID();
-    }
+    MCReorderInfo &RI = Ctx.getReorderInfo();
+    if (RI.isAssemFile)
+      RI.latestParentID = RI.getAssemBBL(); // The parent of the parsed instruction
 	
     if (getTargetParser().MatchAndEmitInstruction(
             IDLoc, Info.Opcode, Info.ParsedOperands, Out, ErrorInfo,
-            getTargetParser().isParsingInlineAsm())) {
-				
-	  // Koo: if opcode starts with "j" that is part of jump family, new BBL begins
-      //      is this always reliable? any other case to count BBL?
-      if (MAI.isAssemFile && OpcodeStr.find("j") == 0) {
-        MAI.assemBBLNo++;
-        MAI.prevOpcode = OpcodeStr;
-      }
+            getTargetParser().isParsingInlineAsm()))
       return true;
-	}
+
+    // Koo: classify the matched instruction by its descriptor; any control
+    //      transfer other than a call ends the BBL, which falls through
+    //      unless the instruction is a barrier (i.e., jmp, ret, ud2)
+    if (RI.isAssemFile) {
+      const MCInstrDesc &Desc = getTargetParser().getMII().get(Info.Opcode);
+      bool isTerminator = Desc.isBranch() || Desc.isIndirectBranch() ||
+                          Desc.isReturn() || Desc.isBarrier() ||
+                          Desc.isTerminator();
+      RI.endAssemInstruction(isTerminator, !Desc.isBarrier());
+    }
   }
   return false;
 }
@@ -3072,17 +3078,30 @@ bool AsmParser::parseDirectiveValue(StringRef IDVal, unsigned Size) {
 //  ::= (.single | .double) [ expression (, expression)* ]
 void AsmParser::handleDirectEmitDirectives(unsigned sz) {
   //const MCSubtargetInfo& STI = getTargetParser().getSTI();
+  MCReorderInfo &RI = Ctx.getReorderInfo();
 
   // Control a corner case: in assembly it is possible to start with data before defining a function
-  if (MAI.assemFuncNo == 0xffffffff) {
-    MAI.specialCntPriorToFunc += sz;
+  if (RI.assemFuncNo == 0xffffffff) {
+    RI.specialCntPriorToFunc += sz;
     return;
   }
 
-  std::string parentID = (MAI.isAssemFile) ? \
-                         std::to_string(MAI.assemFuncNo) + "_" + std::to_string(MAI.assemBBLNo) : MAI.latestParentID;
-  MAI.updateByteCounter(parentID, sz, /*numFixups=*/ 0, /*isAlign=*/ false, /*isInline=*/ false);
-  MAI.latestParentID = parentID;
+  // Data in the code of an assembly file (i.e., an inline jump table) is
+  // conservatively assumed to fall through, unless the compiler has told
+  MCMBBKey parentID = RI.latestParentID;
+  if (RI.isAssemFile) {
+    MCSection *Sec = getStreamer().getCurrentSectionOnly();
+    if (Sec && Sec->getKind().isText()) {
+      parentID = RI.getAssemBBL();
+      if (!RI.hasAssemBBLDirectives)
+        RI.setMBBFallThrough(parentID, true);
+    } else {
+      parentID = MCMBBKey(RI.assemFuncNo, RI.assemBBLNo);
+    }
+  }
+  RI.updateByteCounter(parentID, sz, /*numFixups=*/ 0, /*isAlign=*/ false);
+  RI.latestParentID = parentID;
+  RandDirectiveBytes += sz;
 }
 
 static bool parseHexOcta(AsmParser &Asm, uint64_t &hi, uint64_t &lo) {
@@ -89,6 +89,7 @@ public:
       &ELFAsmParser::ParseDirectiveSymbolAttribute>(".hidden");
     addDirectiveHandler<&ELFAsmParser::ParseDirectiveSubsection>(".subsection");
     addDirectiveHandler<&ELFAsmParser::ParseDirectiveCGProfile>(".cg_profile");
+    addDirectiveHandler<&ELFAsmParser::ParseDirectiveCCRBBL>(".ccr_bbl");
   }
 
   // FIXME: Part of this logic is duplicated in the MCELFStreamer. What is
@@ -160,6 +161,7 @@ public:
   bool ParseDirectiveSymbolAttribute(StringRef, SMLoc);
   bool ParseDirectiveSubsection(StringRef, SMLoc);
   bool ParseDirectiveCGProfile(StringRef, SMLoc);
+  bool ParseDirectiveCCRBBL(StringRef, SMLoc);
 
 private:
   bool ParseSectionName(StringRef &SectionName);
@@ -744,10 +746,9 @@ bool ELFAsmParser::ParseDirectiveType(StringRef, SMLoc) {
   Lex();
 
   // Koo: Assembly file only - check ELF function type here during new symbol generation
-  if (getContext().getAsmInfo()->isAssemFile && Attr == MCSA_ELF_TypeFunction) {
-    getContext().getAsmInfo()->assemFuncNo++;
-    getContext().getAsmInfo()->assemBBLNo = 0;
-  }
+  MCReorderInfo &RI = getContext().getReorderInfo();
+  if (RI.isAssemFile && Attr == MCSA_ELF_TypeFunction)
+    RI.beginAssemFunction(Sym->getName());
   
   getStreamer().EmitSymbolAttribute(Sym, Attr);
 
@@ -910,6 +911,41 @@ bool ELFAsmParser::ParseDirectiveCGProfile(StringRef, SMLoc) {
   return false;
 }
 
+/// ParseDirectiveCCRBBL
+///  ::= .ccr_bbl mfid, mbbid, flags, align_log2, edge_prob
+bool ELFAsmParser::ParseDirectiveCCRBBL(StringRef, SMLoc) {
+  int64_t Values[5];
+  for (unsigned I = 0; I < 5; ++I) {
+    if (I) {
+      if (getLexer().isNot(AsmToken::Comma))
+        return TokError("expected a comma");
+      Lex();
+    }
+    if (getParser().parseIntToken(
+            Values[I], "expected integer in '.ccr_bbl' directive"))
+      return true;
+    if (Values[I] < 0 || Values[I] > UINT32_MAX)
+      return TokError("out of range value in '.ccr_bbl' directive");
+  }
+  if (Values[2] & ~int64_t(MCRandBBLFlags::All) || Values[3] > 15 ||
+      Values[4] > 15)
+    return TokError("invalid block information in '.ccr_bbl' directive");
+
+  if (getLexer().isNot(AsmToken::EndOfStatement))
+    return TokError("unexpected token in directive");
+  Lex();
+
+  // Koo: The blocks of the compiler replace the ones split at the labels and
+  //      the terminators of an assembly file
+  MCReorderInfo &RI = getContext().getReorderInfo();
+  if (RI.isAssemFile)
+    RI.beginAssemDirectiveBBL(MCMBBKey(Values[0], Values[1]), Values[2],
+                              Values[3], Values[4]);
+  getStreamer().EmitCCRBasicBlock(Values[0], Values[1], Values[2], Values[3],
+                                  Values[4]);
+  return false;
+}
+
 namespace llvm {
 
 MCAsmParserExtension *createELFAsmParser() {
@@ -0,0 +1,186 @@
+//===- lib/MC/MCReorderInfo.cpp - CCR basic block bookkeeping -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MC/MCReorderInfo.h"
+#include "llvm/MC/MCFixup.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/type_traits.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+
+// Fixups are copied by value on every emitted instruction; the reordering
+// information must not turn them into anything costlier than a memcpy.
+static_assert(is_trivially_copyable<MCFixup>::value,
+              "MCFixup should be trivially copyable");
+static_assert(sizeof(MCMBBHandle) == 4 && sizeof(MCJTHandle) == 4,
+              "Unexpected handle size!");
+
+raw_ostream &llvm::operator<<(raw_ostream &OS, const MCMBBKey &Key) {
+  if (Key.isValid())
+    OS << Key.getMFID() << "_" << Key.getMBBID();
+  return OS;
+}
+
+raw_ostream &llvm::operator<<(raw_ostream &OS, const MCJTKey &Key) {
+  if (Key.isValid())
+    OS << Key.getMFID() << "_" << Key.getJTI();
+  return OS;
+}
+
+// Name prefixes of the sections whose fixups are collected; a longer prefix
+// has to come before a shorter one that it extends (.data.rel.ro vs .data).
+static const struct {
+  const char *Prefix;
+  MCFixupSectionKind Kind;
+} FixupSectionPrefixes[] = {
+    {".text", FSK_Text},
+    {".rodata", FSK_Rodata},
+    {".data.rel.ro", FSK_DataRel},
+    {".data", FSK_Data},
+    {".init_array", FSK_InitArray},
+    {".fini_array", FSK_FiniArray},
+    {".tdata", FSK_TData},
+    {"xray_instr_map", FSK_XRay},
+    {"__patchable_function_entries", FSK_PatchableEntries},
+    {"__jump_table", FSK_JumpTable},
+};
+
+static const char *const FixupSectionKindNames[NumFixupSectionKinds] = {
+    "text", "rodata", "data", "data.rel.ro", "init_array", "fini_array", "tdata",
+    "xray_instr_map", "__patchable_function_entries", "__jump_table", "custom",
+};
+
+// Koo: Any other section that refers to the code (i.e., a table of handlers or
+//      hooks of the project) is told by name; its fixups go to FSK_Custom
+static cl::list<std::string> CCRFixupSections(
+    "ccr-fixup-section", cl::Hidden, cl::CommaSeparated,
+    cl::desc("Collect the fixups of the sections of this name (or of "
+             "<name>.*) in the CCR reordering information (.rand) as well, so "
+             "that the randomizer patches the code addresses in them. "
+             "Requires -ccr-rand-format=3."),
+    cl::value_desc("name"));
+
+MCFixupSectionKind llvm::getFixupSectionKind(StringRef SectionName) {
+  for (const auto &P : FixupSectionPrefixes)
+    if (SectionName.startswith(P.Prefix))
+      return P.Kind;
+  for (const std::string &Name : CCRFixupSections)
+    if (SectionName.startswith(Name) &&
+        (SectionName.size() == Name.size() || SectionName[Name.size()] == '.'))
+      return FSK_Custom;
+  return FSK_None;
+}
+
+std::string llvm::getCustomFixupSectionsKey() {
+  return join(CCRFixupSections.begin(), CCRFixupSections.end(), ",");
+}
+
+StringRef llvm::getFixupSectionKindName(MCFixupSectionKind Kind) {
+  assert(Kind < NumFixupSectionKinds && "Not a fixup list!");
+  return FixupSectionKindNames[Kind];
+}
+
+std::vector<MCMBBInfo> *MCMBBTable::getFunction(unsigned MFID, bool Create) {
+  if (MFID == LastMFID)
+    return &Functions[LastSlot];
+
+  auto It = FunctionSlots.find(MFID);
+  if (It == FunctionSlots.end()) {
+    if (!Create)
+      return nullptr;
+    // The blocks of the previous function are complete: give back the slack
+    // that growing its table by MBB numbers has left
+    if (LastMFID != ~0U)
+      Functions[LastSlot].shrink_to_fit();
+    It = FunctionSlots.insert(std::make_pair(MFID, Functions.size())).first;
+    Functions.emplace_back();
+  }
+
+  LastMFID = MFID;
+  LastSlot = It->second;
+  return &Functions[LastSlot];
+}
+
+MCMBBInfo &MCMBBTable::operator[](MCMBBKey Key) {
+  MCMBBInfo *Info = &Unowned;
+  if (Key.isValid()) {
+    std::vector<MCMBBInfo> &Blocks = *getFunction(Key.getMFID(), true);
+    unsigned MBBID = Key.getMBBID();
+    if (MBBID >= Blocks.size())
+      Blocks.resize(MBBID + 1);
+    Info = &Blocks[MBBID];
+  }
+
+  if (!Info->Exists) {
+    Info->Exists = true;
+    NumBlocks++;
+  }
+  return *Info;
+}
+
+const MCMBBInfo *MCMBBTable::lookup(MCMBBKey Key) const {
+  const MCMBBInfo *Info = &Unowned;
+  if (Key.isValid()) {
+    const std::vector<MCMBBInfo> *Blocks =
+        const_cast<MCMBBTable *>(this)->getFunction(Key.getMFID(), false);
+    if (!Blocks || Key.getMBBID() >= Blocks->size())
+      return nullptr;
+    Info = &(*Blocks)[Key.getMBBID()];
+  }
+  return Info->Exists ? Info : nullptr;
+}
+
+void MCMBBTable::clear() {
+  Functions.clear();
+  FunctionSlots.clear();
+  Unowned = MCMBBInfo();
+  NumBlocks = 0;
+  LastMFID = ~0U;
+  LastSlot = 0;
+}
+
+void MCReorderInfo::setMFName(unsigned MFID, StringRef name) {
+  if (!name.empty())
+    MachineFunctionIdentities[MFID].NameHash = xxHash64(name);
+}
+
+void MCReorderInfo::beginAssemDirectiveBBL(MCMBBKey id, unsigned flags,
+                                           unsigned alignLog2,
+                                           unsigned edgeProb) {
+  // The functions that .type has begun so far go by the numbers of the compiler
+  if (!hasAssemBBLDirectives)
+    MachineFunctionIdentities.clear();
+  hasAssemBBLDirectives = true;
+  if (!pendingAssemFunctionName.empty()) {
+    setMFName(id.getMFID(), pendingAssemFunctionName);
+    pendingAssemFunctionName.clear();
+  }
+  assemFuncNo = id.getMFID();
+  assemBBLNo = id.getMBBID();
+  assemBBLEnded = false;
+  assemBBLEmpty = true;
+  latestParentID = id;
+
+  setMBBFallThrough(id, flags & MCRandBBLFlags::FallThrough);
+  setMBBAlignment(id, alignLog2, flags & MCRandBBLFlags::LoopHeader);
+  if (flags & MCRandBBLFlags::Hot)
+    setMBBHotness(id, MCMBBInfo::HotnessHot);
+  else if (flags & MCRandBBLFlags::Cold)
+    setMBBHotness(id, MCMBBInfo::HotnessCold);
+  if (flags & MCRandBBLFlags::ChainStart || edgeProb)
+    setMBBPlacement(id, flags & MCRandBBLFlags::ChainStart, edgeProb);
+  if (flags & MCRandBBLFlags::InlineAsm)
+    hasInlineAssembly = true;
+  if (flags & MCRandBBLFlags::GranularityFunction)
+    setMFGranularity(id.getMFID(), MCMBBInfo::GranularityFunction);
+  else if (flags & MCRandBBLFlags::GranularityNone)
+    setMFGranularity(id.getMFID(), MCMBBInfo::GranularityNone);
+}
@@ -16,7 +16,8 @@ MCTargetOptions::MCTargetOptions()
       MCNoWarn(false), MCNoDeprecatedWarn(false), MCSaveTempLabels(false),
       MCUseDwarfDirectory(false), MCIncrementalLinkerCompatible(false),
       MCPIECopyRelocations(false), ShowMCEncoding(false), ShowMCInst(false),
-      AsmVerbose(false), PreserveAsmComments(true) {}
+      AsmVerbose(false), PreserveAsmComments(true),
+      CCRMetadata(false) {}
 
 StringRef MCTargetOptions::getABIName() const {
   return ABIName;
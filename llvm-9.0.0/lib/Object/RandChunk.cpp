@@ -0,0 +1,398 @@
+//===- RandChunk.cpp - Relocatable CCR .rand chunks -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Object/RandChunk.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Object/Error.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace object;
+
+static Error createError(const Twine &Msg) {
+  return make_error<StringError>(Msg, object_error::parse_failed);
+}
+
+bool object::isRandChunked(ArrayRef<uint8_t> Contents) {
+  // The signature can never start an encoded ReorderInfo message: 'C' would
+  // be the key of field #8 in the start-group wire type, which none has
+  return Contents.size() >= sizeof(ccr::ChunkHeader) &&
+         reinterpret_cast<const ccr::ChunkHeader *>(Contents.data())
+                 ->Signature == ccr::ChunkHeader::MagicSignature;
+}
+
+Expected<std::vector<RandChunkRef>>
+object::readRandChunks(ArrayRef<uint8_t> Contents) {
+  std::vector<RandChunkRef> Chunks;
+  DenseMap<uint64_t, size_t> Owners; // The chunks with a payload, by offset
+  uint64_t Offset = 0;
+  while (Offset < Contents.size()) {
+    ArrayRef<uint8_t> Rest = Contents.drop_front(Offset);
+    if (Rest.size() < sizeof(ccr::ChunkHeader))
+      return createError("truncated .rand chunk header at offset " +
+                         Twine(Offset));
+    const auto &H = *reinterpret_cast<const ccr::ChunkHeader *>(Rest.data());
+    if (H.Signature != ccr::ChunkHeader::MagicSignature)
+      return createError("bad .rand chunk signature at offset " +
+                         Twine(Offset));
+    if (H.Version != ccr::ChunkHeader::CurrentVersion)
+      return createError("unsupported .rand chunk version " +
+                         Twine(uint32_t(H.Version)));
+    // Every part has to fit in the rest of the section before they are
+    // summed, or a huge size wraps around to a small chunk
+    uint64_t Avail = Rest.size() - sizeof(ccr::ChunkHeader);
+    uint64_t SectionsSize =
+        uint64_t(H.NumSections) * sizeof(ccr::ChunkSection);
+    if (SectionsSize > Avail || H.NamesSize > Avail - SectionsSize ||
+        H.PayloadSize > Avail - SectionsSize - H.NamesSize)
+      return createError("truncated .rand chunk at offset " + Twine(Offset));
+    uint64_t Size = ccr::getChunkSize(H);
+    if (Size > Rest.size())
+      return createError("truncated .rand chunk at offset " + Twine(Offset));
+
+    RandChunkRef Chunk(Rest.take_front(Size));
+    StringRef Names = Chunk.getNames();
+    if (!Names.empty() && Names.back() != '\0')
+      return createError("unterminated section names in .rand chunk at "
+                         "offset " + Twine(Offset));
+    for (const ccr::ChunkSection &S : Chunk.getSections())
+      if (S.NameOffset >= Names.size())
+        return createError("bad section name offset in .rand chunk at "
+                           "offset " + Twine(Offset));
+
+    if (Chunk.hasSharedPayload()) {
+      auto Owner = Owners.find(H.PayloadRef);
+      if (H.PayloadSize || Owner == Owners.end())
+        return createError("bad shared payload in .rand chunk at offset " +
+                           Twine(Offset));
+      Chunk = RandChunkRef(Chunk.getData(),
+                           Chunks[Owner->second].getOwnPayload());
+    } else {
+      Owners[Offset] = Chunks.size();
+    }
+    Chunks.push_back(Chunk);
+    Offset += Size;
+  }
+  return std::move(Chunks);
+}
+
+namespace {
+// Where a chunk of an input goes in the merged section
+struct ChunkPlacement {
+  uint64_t Offset;     // Of the chunk in the merged section
+  uint64_t Size;       // Of the chunk there, without a shared payload
+  uint64_t PayloadRef; // ccr::ChunkHeader::NoPayloadRef unless shared
+  bool SharedHere;     // The payload is left out by this merge
+};
+
+// The chunks of every input and where they go in the merged section. The
+// inputs are read in parallel, but the payloads are matched in input order,
+// thus the merged section does not depend on the scheduling. Planning reads
+// the headers only, and the payloads of the shapes that have been seen before.
+// The inputs may be appended to the chunks of an earlier merge (Existing),
+// whose payloads are then shared as well.
+struct MergePlan {
+  std::vector<std::vector<RandChunkRef>> Chunks;       // By input
+  std::vector<std::vector<ChunkPlacement>> Placements; // By input
+  std::vector<uint64_t> Offsets; // Of every input in the merged section
+  std::vector<Optional<Error>> Errs;
+
+  explicit MergePlan(ArrayRef<ArrayRef<uint8_t>> Inputs,
+                     ArrayRef<RandChunkRef> Existing = None);
+};
+} // end anonymous namespace
+
+MergePlan::MergePlan(ArrayRef<ArrayRef<uint8_t>> Inputs,
+                     ArrayRef<RandChunkRef> Existing)
+    : Chunks(Inputs.size()), Placements(Inputs.size()),
+      Offsets(Inputs.size() + 1, 0), Errs(Inputs.size()) {
+  size_t N = Inputs.size();
+  parallel::for_each_n(parallel::par, (size_t)0, N, [&](size_t I) {
+    Expected<std::vector<RandChunkRef>> C = readRandChunks(Inputs[I]);
+    if (!C) {
+      Errs[I] = C.takeError();
+      return;
+    }
+    Chunks[I] = std::move(*C);
+    Errs[I] = Error::success();
+  });
+
+  // The first chunk of a payload stores it, looked up by the shape
+  DenseMap<uint64_t, SmallVector<std::pair<ArrayRef<uint8_t>, uint64_t>, 1>>
+      Stored;
+  uint64_t Out = 0;
+  for (const RandChunkRef &C : Existing) {
+    const ccr::ChunkHeader &H = C.getHeader();
+    if (!C.hasSharedPayload() && H.ShapeHash && H.PayloadSize)
+      Stored[H.ShapeHash].emplace_back(C.getOwnPayload(), Out);
+    Out += C.getData().size();
+  }
+  for (size_t I = 0; I != N; ++I) {
+    Offsets[I] = Out;
+    if (*Errs[I]) {
+      Out += Inputs[I].size();
+      continue;
+    }
+    // An input merged before (i.e., by ld -r) may share payloads already
+    DenseMap<uint64_t, uint64_t> Owners; // By the offset in the input
+    uint64_t InputOffset = 0;
+    for (const RandChunkRef &C : Chunks[I]) {
+      const ccr::ChunkHeader &H = C.getHeader();
+      ChunkPlacement P = {Out, C.getData().size(),
+                          ccr::ChunkHeader::NoPayloadRef, false};
+      if (C.hasSharedPayload()) {
+        P.PayloadRef = Owners.lookup(H.PayloadRef);
+      } else if (H.ShapeHash && H.PayloadSize) {
+        ArrayRef<uint8_t> Payload = C.getOwnPayload();
+        auto &Candidates = Stored[H.ShapeHash];
+        auto It = llvm::find_if(Candidates, [&](const auto &Candidate) {
+          return Candidate.first == Payload;
+        });
+        if (It != Candidates.end()) {
+          ccr::ChunkHeader Shared = H;
+          Shared.PayloadSize = 0;
+          P = {Out, ccr::getChunkSize(Shared), It->second, true};
+        } else {
+          Candidates.emplace_back(Payload, Out);
+        }
+      }
+      Owners[InputOffset] =
+          P.PayloadRef == ccr::ChunkHeader::NoPayloadRef ? Out : P.PayloadRef;
+      InputOffset += C.getData().size();
+      Out += P.Size;
+      Placements[I].push_back(P);
+    }
+  }
+  Offsets[N] = Out;
+}
+
+uint64_t object::getMergedRandSize(ArrayRef<ArrayRef<uint8_t>> Inputs) {
+  MergePlan Plan(Inputs);
+  for (Optional<Error> &E : Plan.Errs)
+    consumeError(std::move(*E));
+  return Plan.Offsets.back();
+}
+
+std::vector<uint64_t>
+object::getMergedRandOffsets(ArrayRef<ArrayRef<uint8_t>> Inputs) {
+  MergePlan Plan(Inputs);
+  for (Optional<Error> &E : Plan.Errs)
+    consumeError(std::move(*E));
+  return std::move(Plan.Offsets);
+}
+
+// Copy the chunks of Inputs[InputIdx] to Out (the merged section) as planned
+// and patch their headers in place; the payloads remain untouched
+static Error copyAndPatch(const MergePlan &Plan, unsigned InputIdx,
+                          ArrayRef<uint8_t> Input, RandChunkPatcher Patch,
+                          uint8_t *Out, RandMergeStats *Stats) {
+  auto Start = std::chrono::steady_clock::now();
+  const std::vector<RandChunkRef> &Chunks = Plan.Chunks[InputIdx];
+  const std::vector<ChunkPlacement> &Placements = Plan.Placements[InputIdx];
+  uint64_t SharedBytes = 0;
+  for (size_t I = 0, E = Chunks.size(); I != E; ++I) {
+    const RandChunkRef &C = Chunks[I];
+    const ChunkPlacement &P = Placements[I];
+    uint8_t *Dst = Out + P.Offset;
+    auto *H = reinterpret_cast<ccr::ChunkHeader *>(Dst);
+    if (P.SharedHere) {
+      size_t Prefix = C.getOwnPayload().data() - C.getData().data();
+      memcpy(Dst, C.getData().data(), Prefix);
+      memset(Dst + Prefix, 0, P.Size - Prefix);
+      SharedBytes += H->PayloadSize;
+      H->PayloadSize = 0;
+    } else {
+      memcpy(Dst, C.getData().data(), P.Size);
+    }
+    H->PayloadRef = P.PayloadRef;
+
+    auto *Sections =
+        reinterpret_cast<ccr::ChunkSection *>(Dst + sizeof(ccr::ChunkHeader));
+    if (Error Err = Patch(InputIdx, *H, {Sections, C.getSections().size()},
+                          C.getNames()))
+      return Err;
+  }
+
+  if (Stats) {
+    Stats->RandSize = Input.size();
+    Stats->NumChunks = Chunks.size();
+    Stats->SharedBytes = SharedBytes;
+    for (const RandChunkRef &C : Chunks) {
+      Stats->NumLayouts += C.getHeader().NumLayouts;
+      Stats->NumFixups += C.getHeader().NumFixups;
+    }
+    Stats->MergeTime = std::chrono::steady_clock::now() - Start;
+  }
+  return Error::success();
+}
+
+Error object::mergeRandSections(ArrayRef<ArrayRef<uint8_t>> Inputs,
+                                RandChunkPatcher Patch,
+                                MutableArrayRef<uint8_t> Out,
+                                MutableArrayRef<RandMergeStats> Stats) {
+  // The output position of every chunk is planned up front, thus each input
+  // can be processed on its own
+  size_t N = Inputs.size();
+  MergePlan Plan(Inputs);
+  std::vector<Optional<Error>> &Errs = Plan.Errs;
+  Error Result = Error::success();
+  if (Plan.Offsets[N] != Out.size())
+    Result = createError("the merged .rand section is " +
+                         Twine(Plan.Offsets[N]) +
+                         " bytes, but the output buffer is " +
+                         Twine(Out.size()));
+  else if (!Stats.empty() && Stats.size() != N)
+    Result = createError("expected the merge stats of " + Twine(N) +
+                         " inputs, but got " + Twine(Stats.size()));
+  if (Result) {
+    for (Optional<Error> &E : Errs)
+      consumeError(std::move(*E));
+    return Result;
+  }
+
+  parallel::for_each_n(parallel::par, (size_t)0, N, [&](size_t I) {
+    if (*Errs[I])
+      return;
+    Errs[I] = copyAndPatch(Plan, I, Inputs[I], Patch, Out.data(),
+                           Stats.empty() ? nullptr : &Stats[I]);
+  });
+
+  // Report the first failing input regardless of the scheduling
+  for (Optional<Error> &E : Errs) {
+    if (!*E)
+      continue;
+    if (Result)
+      consumeError(std::move(*E));
+    else
+      Result = std::move(*E);
+  }
+  return Result;
+}
+
+Error object::mergeRandSections(ArrayRef<ArrayRef<uint8_t>> Inputs,
+                                RandChunkPatcher Patch,
+                                std::vector<uint8_t> &Out,
+                                MutableArrayRef<RandMergeStats> Stats) {
+  Out.resize(getMergedRandSize(Inputs));
+  return mergeRandSections(Inputs, Patch, MutableArrayRef<uint8_t>(Out),
+                           Stats);
+}
+
+Expected<std::vector<uint64_t>> object::updateRandSection(
+    std::vector<uint8_t> &Merged,
+    ArrayRef<std::pair<uint64_t, uint64_t>> Removed,
+    ArrayRef<ArrayRef<uint8_t>> Added, RandChunkPatcher Patch,
+    MutableArrayRef<RandMergeStats> Stats) {
+  Expected<std::vector<RandChunkRef>> Existing = readRandChunks(Merged);
+  if (!Existing)
+    return Existing.takeError();
+  if (!Stats.empty() && Stats.size() != Added.size())
+    return createError("expected the merge stats of " + Twine(Added.size()) +
+                       " inputs, but got " + Twine(Stats.size()));
+
+  // The chunks of a replaced input stay where they are, thus no other chunk
+  // moves and every PayloadRef remains valid; their sections are discarded
+  DenseMap<uint64_t, uint64_t> Starts; // The chunk sizes, by offset
+  uint64_t Offset = 0;
+  for (const RandChunkRef &C : *Existing) {
+    Starts[Offset] = C.getData().size();
+    Offset += C.getData().size();
+  }
+  for (const std::pair<uint64_t, uint64_t> &R : Removed) {
+    for (Offset = R.first; Offset < R.second;) {
+      auto It = Starts.find(Offset);
+      if (It == Starts.end())
+        return createError("the replaced .rand range [" + Twine(R.first) +
+                           ", " + Twine(R.second) +
+                           ") does not span whole chunks");
+      const auto &H =
+          *reinterpret_cast<const ccr::ChunkHeader *>(&Merged[Offset]);
+      auto *Sections = reinterpret_cast<ccr::ChunkSection *>(
+          &Merged[Offset + sizeof(ccr::ChunkHeader)]);
+      for (unsigned I = 0; I != H.NumSections; ++I)
+        Sections[I].Base = ccr::ChunkSection::DiscardedBase;
+      Offset += It->second;
+    }
+    if (Offset != R.second)
+      return createError("the replaced .rand range [" + Twine(R.first) +
+                         ", " + Twine(R.second) +
+                         ") does not span whole chunks");
+  }
+
+  // The new inputs are planned against the payloads of the section (which
+  // must not move until then), and then copied past its end
+  size_t N = Added.size();
+  MergePlan Plan(Added, *Existing);
+  Merged.resize(Plan.Offsets[N]);
+  std::vector<Optional<Error>> &Errs = Plan.Errs;
+  parallel::for_each_n(parallel::par, (size_t)0, N, [&](size_t I) {
+    if (*Errs[I])
+      return;
+    Errs[I] = copyAndPatch(Plan, I, Added[I], Patch, Merged.data(),
+                           Stats.empty() ? nullptr : &Stats[I]);
+  });
+
+  Error Result = Error::success();
+  for (Optional<Error> &E : Errs) {
+    if (!*E)
+      continue;
+    if (Result)
+      consumeError(std::move(*E));
+    else
+      Result = std::move(*E);
+  }
+  if (Result)
+    return std::move(Result);
+  return std::move(Plan.Offsets);
+}
+
+void object::writeRandMergeReport(raw_ostream &OS,
+                                  ArrayRef<StringRef> InputNames,
+                                  ArrayRef<RandMergeStats> Stats) {
+  assert(InputNames.size() == Stats.size() && "One name per input expected");
+  RandMergeStats Total;
+  json::OStream J(OS, 2);
+  J.object([&] {
+    J.attributeArray("inputs", [&] {
+      for (size_t I = 0, E = Stats.size(); I != E; ++I) {
+        const RandMergeStats &S = Stats[I];
+        J.object([&] {
+          J.attribute("name", InputNames[I]);
+          J.attribute("rand_size", int64_t(S.RandSize));
+          J.attribute("chunks", int64_t(S.NumChunks));
+          J.attribute("shared_bytes", int64_t(S.SharedBytes));
+          J.attribute("layouts", int64_t(S.NumLayouts));
+          J.attribute("fixups", int64_t(S.NumFixups));
+          J.attribute("merge_time_us", S.MergeTime.count() / 1e3);
+        });
+        Total.RandSize += S.RandSize;
+        Total.NumChunks += S.NumChunks;
+        Total.SharedBytes += S.SharedBytes;
+        Total.NumLayouts += S.NumLayouts;
+        Total.NumFixups += S.NumFixups;
+        Total.MergeTime += S.MergeTime;
+      }
+    });
+    J.attributeObject("total", [&] {
+      J.attribute("rand_size", int64_t(Total.RandSize));
+      J.attribute("chunks", int64_t(Total.NumChunks));
+      J.attribute("shared_bytes", int64_t(Total.SharedBytes));
+      J.attribute("layouts", int64_t(Total.NumLayouts));
+      J.attribute("fixups", int64_t(Total.NumFixups));
+      // The sum over the inputs, thus the CPU time rather than the wall time
+      J.attribute("merge_time_us", Total.MergeTime.count() / 1e3);
+    });
+  });
+  OS << "\n";
+}
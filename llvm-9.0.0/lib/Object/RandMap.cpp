@@ -0,0 +1,360 @@
+//===- RandMap.cpp - CCR address translation maps -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Object/RandMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Object/Error.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace object;
+
+static Error createError(const Twine &Msg) {
+  return make_error<StringError>(Msg, object_error::parse_failed);
+}
+
+std::vector<RandAddressRange>
+object::mergeRandAddressRanges(std::vector<RandAddressRange> Ranges) {
+  llvm::sort(Ranges, [](const RandAddressRange &A, const RandAddressRange &B) {
+    return A.OldAddr < B.OldAddr;
+  });
+
+  // Most functions move as a whole, thus their BBLs collapse into one range
+  std::vector<RandAddressRange> Merged;
+  for (const RandAddressRange &R : Ranges) {
+    if (!R.Size)
+      continue;
+    if (!Merged.empty()) {
+      RandAddressRange &Last = Merged.back();
+      if (Last.OldAddr + Last.Size == R.OldAddr &&
+          Last.NewAddr + Last.Size == R.NewAddr) {
+        Last.Size += R.Size;
+        continue;
+      }
+    }
+    Merged.push_back(R);
+  }
+  return Merged;
+}
+
+static void writeMap(raw_ostream &OS, uint64_t TextAddr, uint64_t TextSize,
+                     uint64_t TextHash, std::vector<RandAddressRange> Ranges) {
+  std::vector<RandAddressRange> Merged =
+      mergeRandAddressRanges(std::move(Ranges));
+  ccr::MapHeader H;
+  H.Signature = ccr::MapHeader::MagicSignature;
+  H.Version = ccr::MapHeader::CurrentVersion;
+  H.NumRanges = Merged.size();
+  H.TextAddr = TextAddr;
+  H.TextSize = TextSize;
+  H.TextHash = TextHash;
+  OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+  for (const RandAddressRange &R : Merged) {
+    ccr::MapRange Out;
+    Out.OldAddr = R.OldAddr;
+    Out.NewAddr = R.NewAddr;
+    Out.Size = R.Size;
+    OS.write(reinterpret_cast<const char *>(&Out), sizeof(Out));
+  }
+}
+
+void object::writeRandAddressMap(raw_ostream &OS, uint64_t TextAddr,
+                                 ArrayRef<uint8_t> Text,
+                                 std::vector<RandAddressRange> Ranges) {
+  writeMap(OS, TextAddr, Text.size(), xxHash64(toStringRef(Text)),
+           std::move(Ranges));
+}
+
+void object::writeRandAddressMap(raw_ostream &OS, uint64_t TextAddr,
+                                 uint64_t TextSize,
+                                 std::vector<RandAddressRange> Ranges) {
+  writeMap(OS, TextAddr, TextSize, /*TextHash=*/0, std::move(Ranges));
+}
+
+Expected<RandAddressMap> RandAddressMap::create(ArrayRef<uint8_t> Data) {
+  if (Data.size() < sizeof(ccr::MapHeader))
+    return createError("truncated CCR address map header");
+  const auto &H = *reinterpret_cast<const ccr::MapHeader *>(Data.data());
+  if (H.Signature != ccr::MapHeader::MagicSignature)
+    return createError("bad CCR address map signature");
+  if (H.Version != ccr::MapHeader::CurrentVersion)
+    return createError("unsupported CCR address map version " +
+                       Twine(uint32_t(H.Version)));
+  uint64_t NumRanges = H.NumRanges;
+  if (NumRanges > (Data.size() - sizeof(H)) / sizeof(ccr::MapRange))
+    return createError("truncated CCR address map");
+
+  RandAddressMap Map;
+  Map.TextAddr = H.TextAddr;
+  Map.TextSize = H.TextSize;
+  Map.TextHash = H.TextHash;
+  const auto *In = reinterpret_cast<const ccr::MapRange *>(Data.data() +
+                                                           sizeof(H));
+  Map.ByOld.reserve(NumRanges);
+  for (uint64_t I = 0; I != NumRanges; ++I) {
+    RandAddressRange R = {In[I].OldAddr, In[I].NewAddr, In[I].Size};
+    if (!Map.ByOld.empty() &&
+        Map.ByOld.back().OldAddr + Map.ByOld.back().Size > R.OldAddr)
+      return createError("unsorted or overlapping range #" + Twine(I) +
+                         " in CCR address map");
+    Map.ByOld.push_back(R);
+  }
+
+  Map.ByNew = Map.ByOld;
+  llvm::sort(Map.ByNew,
+             [](const RandAddressRange &A, const RandAddressRange &B) {
+               return A.NewAddr < B.NewAddr;
+             });
+  for (size_t I = 1; I < Map.ByNew.size(); ++I)
+    if (Map.ByNew[I - 1].NewAddr + Map.ByNew[I - 1].Size > Map.ByNew[I].NewAddr)
+      return createError("overlapping new ranges in CCR address map");
+  return std::move(Map);
+}
+
+bool RandAddressMap::matches(uint64_t Addr, ArrayRef<uint8_t> Text) const {
+  return Addr == TextAddr && Text.size() == TextSize &&
+         (!TextHash || xxHash64(toStringRef(Text)) == TextHash);
+}
+
+Optional<uint64_t> RandAddressMap::getOriginalAddress(uint64_t NewAddr) const {
+  auto It = std::upper_bound(
+      ByNew.begin(), ByNew.end(), NewAddr,
+      [](uint64_t A, const RandAddressRange &R) { return A < R.NewAddr; });
+  if (It == ByNew.begin())
+    return None;
+  const RandAddressRange &R = *std::prev(It);
+  if (NewAddr < R.NewAddr + R.Size)
+    return R.OldAddr + (NewAddr - R.NewAddr);
+  // The gap up to the next range was filled in by the randomizer
+  if (It != ByNew.end())
+    return R.OldAddr + R.Size - 1;
+  return None;
+}
+
+Optional<uint64_t> RandAddressMap::getNewAddress(uint64_t OldAddr) const {
+  auto It = std::upper_bound(
+      ByOld.begin(), ByOld.end(), OldAddr,
+      [](uint64_t A, const RandAddressRange &R) { return A < R.OldAddr; });
+  if (It == ByOld.begin())
+    return None;
+  const RandAddressRange &R = *std::prev(It);
+  if (OldAddr < R.OldAddr + R.Size)
+    return R.NewAddr + (OldAddr - R.OldAddr);
+  return None;
+}
+
+bool RandAddressMap::getOriginalRanges(
+    uint64_t NewBegin, uint64_t NewEnd,
+    SmallVectorImpl<std::pair<uint64_t, uint64_t>> &Pieces) const {
+  if (NewEnd < NewBegin || !getOriginalAddress(NewBegin) ||
+      !getOriginalAddress(NewEnd))
+    return false;
+  auto It = std::upper_bound(
+      ByNew.begin(), ByNew.end(), NewBegin,
+      [](uint64_t A, const RandAddressRange &R) { return A < R.NewAddr; });
+  for (--It; It != ByNew.end() && It->NewAddr <= NewEnd; ++It) {
+    uint64_t Begin = std::max(NewBegin, It->NewAddr);
+    uint64_t End = std::min(NewEnd, It->NewAddr + It->Size - 1);
+    if (Begin <= End) // Not in the gap after the range
+      Pieces.emplace_back(It->OldAddr + (Begin - It->NewAddr),
+                          It->OldAddr + (End - It->NewAddr));
+  }
+  // Both ends are in the gaps the randomizer filled in
+  if (Pieces.empty())
+    Pieces.emplace_back(*getOriginalAddress(NewBegin),
+                        *getOriginalAddress(NewEnd));
+  return true;
+}
+
+void object::writeRandBBAddrMap(raw_ostream &OS, uint64_t TextAddr,
+                                ArrayRef<RandBBAddrEntry> Entries) {
+  ccr::BBAddrMapHeader H;
+  H.Signature = ccr::BBAddrMapHeader::MagicSignature;
+  H.Version = ccr::BBAddrMapHeader::CurrentVersion;
+  H.NumEntries = Entries.size();
+  H.TextAddr = TextAddr;
+  OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+  // Most BBLs follow the previous one with no gap, in the order of .rand
+  uint64_t End = TextAddr;
+  int64_t PrevID = -1;
+  for (const RandBBAddrEntry &E : Entries) {
+    encodeULEB128(E.FunctionID, OS);
+    encodeULEB128(E.BBLs.size(), OS);
+    for (const RandBBLAddress &BBL : E.BBLs) {
+      assert(BBL.Addr >= End && "BBLs out of order");
+      encodeSLEB128(int64_t(BBL.ID) - (PrevID + 1), OS);
+      encodeULEB128(BBL.Addr - End, OS);
+      encodeULEB128(BBL.Size, OS);
+      PrevID = BBL.ID;
+      End = BBL.Addr + BBL.Size;
+    }
+  }
+}
+
+Expected<std::vector<RandBBAddrEntry>>
+object::readRandBBAddrMap(ArrayRef<uint8_t> Data) {
+  if (Data.size() < sizeof(ccr::BBAddrMapHeader))
+    return createError("truncated CCR BBL address map header");
+  const auto &H = *reinterpret_cast<const ccr::BBAddrMapHeader *>(Data.data());
+  if (H.Signature != ccr::BBAddrMapHeader::MagicSignature)
+    return createError("bad CCR BBL address map signature");
+  if (H.Version != ccr::BBAddrMapHeader::CurrentVersion)
+    return createError("unsupported CCR BBL address map version " +
+                       Twine(uint32_t(H.Version)));
+
+  const uint8_t *P = Data.data() + sizeof(H), *DataEnd = Data.end();
+  const char *Message = nullptr;
+  auto ReadULEB = [&]() -> uint64_t {
+    unsigned N = 0;
+    uint64_t V = Message ? 0 : decodeULEB128(P, &N, DataEnd, &Message);
+    P += N;
+    return V;
+  };
+  auto ReadSLEB = [&]() -> int64_t {
+    unsigned N = 0;
+    int64_t V = Message ? 0 : decodeSLEB128(P, &N, DataEnd, &Message);
+    P += N;
+    return V;
+  };
+
+  // Every entry takes at least two bytes, thus a bogus count fails early
+  uint64_t NumEntries = H.NumEntries;
+  if (NumEntries > size_t(DataEnd - P) / 2)
+    return createError("truncated CCR BBL address map");
+  std::vector<RandBBAddrEntry> Entries(NumEntries);
+  uint64_t End = H.TextAddr;
+  int64_t PrevID = -1;
+  for (uint64_t I = 0; I != NumEntries; ++I) {
+    RandBBAddrEntry &E = Entries[I];
+    E.FunctionID = ReadULEB();
+    uint64_t NumBBLs = ReadULEB();
+    if (Message || NumBBLs > size_t(DataEnd - P) / 3)
+      return createError("truncated entry #" + Twine(I) +
+                         " in CCR BBL address map");
+    E.BBLs.reserve(NumBBLs);
+    for (uint64_t J = 0; J != NumBBLs; ++J) {
+      int64_t ID = PrevID + 1 + ReadSLEB();
+      uint64_t Addr = End + ReadULEB();
+      uint64_t Size = ReadULEB();
+      if (Message)
+        return createError("malformed entry #" + Twine(I) +
+                           " in CCR BBL address map: " + Message);
+      if (ID < 0 || Addr < End || Addr + Size < Addr)
+        return createError("bad BBL in entry #" + Twine(I) +
+                           " of CCR BBL address map");
+      E.BBLs.push_back({uint64_t(ID), Addr, Size});
+      PrevID = ID;
+      End = Addr + Size;
+    }
+  }
+  if (P != DataEnd)
+    return createError("trailing bytes in CCR BBL address map");
+  return std::move(Entries);
+}
+
+StringRef object::getRandSyntheticSiteKindName(ccr::SyntheticSiteKind Kind) {
+  switch (Kind) {
+  case ccr::SSK_Trampoline:
+    return "trampoline";
+  case ccr::SSK_RelaxedBranch:
+    return "relaxed-branch";
+  case ccr::SSK_DuplicatedTail:
+    return "duplicated-tail";
+  case ccr::SSK_Padding:
+    return "padding";
+  default:
+    return "unknown";
+  }
+}
+
+void object::writeRandSyntheticSites(raw_ostream &OS, uint64_t TextAddr,
+                                     ArrayRef<RandSyntheticSite> Sites) {
+  ccr::SyntheticSitesHeader H;
+  H.Signature = ccr::SyntheticSitesHeader::MagicSignature;
+  H.Version = ccr::SyntheticSitesHeader::CurrentVersion;
+  H.NumSites = Sites.size();
+  H.TextAddr = TextAddr;
+  OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+  uint64_t End = TextAddr;
+  for (const RandSyntheticSite &S : Sites) {
+    assert(S.Addr >= End && "Sites out of order");
+    encodeULEB128(S.Addr - End, OS);
+    encodeULEB128(S.Size, OS);
+    OS << char(S.Kind);
+    encodeULEB128(S.BBL, OS);
+    encodeULEB128(S.OrigAddr, OS);
+    End = S.Addr + S.Size;
+  }
+}
+
+Expected<std::vector<RandSyntheticSite>>
+object::readRandSyntheticSites(ArrayRef<uint8_t> Data) {
+  if (Data.size() < sizeof(ccr::SyntheticSitesHeader))
+    return createError("truncated CCR synthetic sites header");
+  const auto &H =
+      *reinterpret_cast<const ccr::SyntheticSitesHeader *>(Data.data());
+  if (H.Signature != ccr::SyntheticSitesHeader::MagicSignature)
+    return createError("bad CCR synthetic sites signature");
+  if (H.Version != ccr::SyntheticSitesHeader::CurrentVersion)
+    return createError("unsupported CCR synthetic sites version " +
+                       Twine(uint32_t(H.Version)));
+
+  const uint8_t *P = Data.data() + sizeof(H), *DataEnd = Data.end();
+  const char *Message = nullptr;
+  auto ReadULEB = [&]() -> uint64_t {
+    unsigned N = 0;
+    uint64_t V = Message ? 0 : decodeULEB128(P, &N, DataEnd, &Message);
+    P += N;
+    return V;
+  };
+
+  // Every site takes at least five bytes, thus a bogus count fails early
+  uint64_t NumSites = H.NumSites;
+  if (NumSites > size_t(DataEnd - P) / 5)
+    return createError("truncated CCR synthetic sites");
+  std::vector<RandSyntheticSite> Sites(NumSites);
+  uint64_t End = H.TextAddr;
+  for (uint64_t I = 0; I != NumSites; ++I) {
+    RandSyntheticSite &S = Sites[I];
+    S.Addr = End + ReadULEB();
+    S.Size = ReadULEB();
+    uint8_t Kind = 0;
+    if (!Message && P == DataEnd)
+      Message = "malformed uleb128, extends past end";
+    else if (!Message)
+      Kind = *P++;
+    S.Kind = ccr::SyntheticSiteKind(Kind);
+    S.BBL = ReadULEB();
+    S.OrigAddr = ReadULEB();
+    if (Message)
+      return createError("malformed site #" + Twine(I) +
+                         " in CCR synthetic sites: " + Message);
+    if (Kind >= ccr::NumSyntheticSiteKinds || S.Addr < End ||
+        S.Addr + S.Size < S.Addr)
+      return createError("bad site #" + Twine(I) + " in CCR synthetic sites");
+    End = S.Addr + S.Size;
+  }
+  if (P != DataEnd)
+    return createError("trailing bytes in CCR synthetic sites");
+  return std::move(Sites);
+}
+
+const RandSyntheticSite *
+object::findRandSyntheticSite(ArrayRef<RandSyntheticSite> Sites,
+                              uint64_t Addr) {
+  auto It = std::upper_bound(
+      Sites.begin(), Sites.end(), Addr,
+      [](uint64_t Addr, const RandSyntheticSite &S) { return Addr < S.Addr; });
+  if (It == Sites.begin() || Addr - std::prev(It)->Addr >= std::prev(It)->Size)
+    return nullptr;
+  return &*std::prev(It);
+}
@@ -85,6 +85,44 @@ uint32_t zlib::crc32(StringRef Buffer) {
   return ::crc32(0, (const Bytef *)Buffer.data(), Buffer.size());
 }
 
+Error zlib::compressPiece(StringRef InputBuffer,
+                          SmallVectorImpl<char> &CompressedBuffer, bool Last,
+                          int Level) {
+  z_stream Stream = {};
+  int Res = ::deflateInit2(&Stream, Level, Z_DEFLATED, -MAX_WBITS, 8,
+                           Z_DEFAULT_STRATEGY);
+  if (Res != Z_OK)
+    return createError(convertZlibCodeToString(Res));
+  // The bound is that of a finished stream; a sync flush adds an empty
+  // stored block instead
+  size_t Offset = CompressedBuffer.size();
+  CompressedBuffer.resize(Offset + ::deflateBound(&Stream, InputBuffer.size()) +
+                          8);
+  Stream.next_in = (Bytef *)InputBuffer.data();
+  Stream.avail_in = InputBuffer.size();
+  Stream.next_out = (Bytef *)CompressedBuffer.data() + Offset;
+  Stream.avail_out = CompressedBuffer.size() - Offset;
+  Res = ::deflate(&Stream, Last ? Z_FINISH : Z_SYNC_FLUSH);
+  size_t CompressedSize = Stream.total_out;
+  ::deflateEnd(&Stream);
+  // Tell MemorySanitizer that zlib output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented ZLib.
+  __msan_unpoison(CompressedBuffer.data() + Offset, CompressedSize);
+  CompressedBuffer.resize(Offset + CompressedSize);
+  if (Res != (Last ? Z_STREAM_END : Z_OK) || Stream.avail_in)
+    return createError(convertZlibCodeToString(Res < 0 ? Res : Z_BUF_ERROR));
+  return Error::success();
+}
+
+uint32_t zlib::adler32(StringRef Buffer) {
+  return ::adler32(::adler32(0, Z_NULL, 0), (const Bytef *)Buffer.data(),
+                   Buffer.size());
+}
+
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Size2) {
+  return ::adler32_combine(Adler1, Adler2, Size2);
+}
+
 #else
 bool zlib::isAvailable() { return false; }
 Error zlib::compress(StringRef InputBuffer,
@@ -103,4 +141,15 @@ Error zlib::uncompress(StringRef InputBuffer,
 uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
+Error zlib::compressPiece(StringRef InputBuffer,
+                          SmallVectorImpl<char> &CompressedBuffer, bool Last,
+                          int Level) {
+  llvm_unreachable("zlib::compressPiece is unavailable");
+}
+uint32_t zlib::adler32(StringRef Buffer) {
+  llvm_unreachable("zlib::adler32 is unavailable");
+}
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Size2) {
+  llvm_unreachable("zlib::adler32Combine is unavailable");
+}
 #endif
@@ -28,6 +28,10 @@
 #include <io.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 using namespace llvm;
 using namespace llvm::support::endian;
 
@@ -937,6 +941,30 @@ std::error_code create_directories(const Twine &Path, bool IgnoreExisting,
 }
 
 static std::error_code copy_file_internal(int ReadFD, int WriteFD) {
+#if defined(__linux__) && defined(SYS_copy_file_range)
+  // Koo: Let the kernel copy the data without a round trip through user space
+  // (and share the extents on file systems with reflinks). Fall back to
+  // read/write if the file systems or the kernel do not support it, which is
+  // only known before the first byte is copied.
+  bool Copied = false;
+  for (;;) {
+    ssize_t N = syscall(SYS_copy_file_range, ReadFD, nullptr, WriteFD, nullptr,
+                        (size_t)1 << 30, 0U);
+    if (N == 0)
+      return std::error_code();
+    if (N > 0) {
+      Copied = true;
+      continue;
+    }
+    if (errno == EINTR)
+      continue;
+    if (Copied || (errno != ENOSYS && errno != EXDEV && errno != EINVAL &&
+                   errno != EOPNOTSUPP && errno != EBADF))
+      return std::error_code(errno, std::generic_category());
+    break;
+  }
+#endif
+
   const size_t BufSize = 4096;
   char *Buf = new char[BufSize];
   int BytesRead = 0, BytesWritten = 0;
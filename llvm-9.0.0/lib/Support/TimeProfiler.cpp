@@ -11,12 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/Threading.h"
 #include <cassert>
 #include <chrono>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -42,6 +45,7 @@ struct Entry {
   DurationType Duration;
   std::string Name;
   std::string Detail;
+  unsigned Lane = 0;
 
   Entry(time_point<steady_clock> &&S, DurationType &&D, std::string &&N,
         std::string &&Dt)
@@ -50,19 +54,37 @@ struct Entry {
 };
 
 struct TimeTraceProfiler {
-  TimeTraceProfiler() {
+  TimeTraceProfiler(StringRef ProcName) : ProcName(ProcName) {
     StartTime = steady_clock::now();
+    getLane();
+  }
+
+  // The lane (and the stack of open sections) of the calling thread; Lock
+  // is held
+  unsigned getLane() {
+    auto Ins = Lanes.try_emplace(get_threadid(), Stacks.size());
+    if (Ins.second)
+      Stacks.emplace_back();
+    return Ins.first->second;
   }
 
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
-    Stack.emplace_back(steady_clock::now(), DurationType{}, std::move(Name),
-                       Detail());
+    std::string D = Detail();
+    auto Start = steady_clock::now();
+    std::lock_guard<std::mutex> Guard(Lock);
+    unsigned Lane = getLane();
+    Stacks[Lane].emplace_back(std::move(Start), DurationType{},
+                              std::move(Name), std::move(D));
+    Stacks[Lane].back().Lane = Lane;
   }
 
   void end() {
+    auto Now = steady_clock::now();
+    std::lock_guard<std::mutex> Guard(Lock);
+    auto &Stack = Stacks[getLane()];
     assert(!Stack.empty() && "Must call begin() first");
     auto &E = Stack.back();
-    E.Duration = steady_clock::now() - E.Start;
+    E.Duration = Now - E.Start;
 
     // Only include sections longer than TimeTraceGranularity msec.
     if (duration_cast<microseconds>(E.Duration).count() > TimeTraceGranularity)
@@ -85,7 +107,9 @@ struct TimeTraceProfiler {
   }
 
   void Write(raw_pwrite_stream &OS) {
-    assert(Stack.empty() &&
+    std::lock_guard<std::mutex> Guard(Lock);
+    assert(llvm::all_of(Stacks,
+                        [](const SmallVectorImpl<Entry> &S) { return S.empty(); }) &&
            "All profiler sections should be ended when calling Write");
     json::OStream J(OS);
     J.objectBegin();
@@ -99,7 +123,7 @@ struct TimeTraceProfiler {
 
       J.object([&]{
         J.attribute("pid", 1);
-        J.attribute("tid", 0);
+        J.attribute("tid", int64_t(E.Lane));
         J.attribute("ph", "X");
         J.attribute("ts", StartUs);
         J.attribute("dur", DurUs);
@@ -109,8 +133,8 @@ struct TimeTraceProfiler {
     }
 
     // Emit totals by section name as additional "thread" events, sorted from
-    // longest one.
-    int Tid = 1;
+    // longest one, after the lanes of the threads.
+    int Tid = Stacks.size();
     std::vector<NameAndCountAndDurationType> SortedTotals;
     SortedTotals.reserve(CountAndTotalPerName.size());
     for (const auto &E : CountAndTotalPerName)
@@ -149,24 +173,39 @@ struct TimeTraceProfiler {
       J.attribute("ts", 0);
       J.attribute("ph", "M");
       J.attribute("name", "process_name");
-      J.attributeObject("args", [&] { J.attribute("name", "clang"); });
+      J.attributeObject("args", [&] { J.attribute("name", ProcName); });
     });
+    for (unsigned Lane = 1, E = Stacks.size(); Lane < E; ++Lane)
+      J.object([&] {
+        J.attribute("cat", "");
+        J.attribute("pid", 1);
+        J.attribute("tid", int64_t(Lane));
+        J.attribute("ts", 0);
+        J.attribute("ph", "M");
+        J.attribute("name", "thread_name");
+        J.attributeObject("args", [&] {
+          J.attribute("name", "thread " + std::to_string(Lane));
+        });
+      });
 
     J.arrayEnd();
     J.attributeEnd();
     J.objectEnd();
   }
 
-  SmallVector<Entry, 16> Stack;
+  std::mutex Lock;
+  DenseMap<uint64_t, unsigned> Lanes; // By thread ID
+  std::vector<SmallVector<Entry, 16>> Stacks; // By lane
   SmallVector<Entry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
   time_point<steady_clock> StartTime;
+  std::string ProcName;
 };
 
-void timeTraceProfilerInitialize() {
+void timeTraceProfilerInitialize(StringRef ProcName) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
-  TimeTraceProfilerInstance = new TimeTraceProfiler();
+  TimeTraceProfilerInstance = new TimeTraceProfiler(ProcName);
 }
 
 void timeTraceProfilerCleanup() {
@@ -0,0 +1,82 @@
+//===- X86Nops.cpp - Long NOPs of x86 code --------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/X86Nops.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace llvm;
+
+static const uint8_t Nops[15][15] = {
+    // nop
+    {0x90},
+    // xchg %ax,%ax
+    {0x66, 0x90},
+    // nopl (%[re]ax)
+    {0x0f, 0x1f, 0x00},
+    // nopl 0(%[re]ax)
+    {0x0f, 0x1f, 0x40, 0x00},
+    // nopl 0(%[re]ax,%[re]ax,1)
+    {0x0f, 0x1f, 0x44, 0x00, 0x00},
+    // nopw 0(%[re]ax,%[re]ax,1)
+    {0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00},
+    // nopl 0L(%[re]ax)
+    {0x0f, 0x1f, 0x80, 0x00, 0x00, 0x00, 0x00},
+    // nopl 0L(%[re]ax,%[re]ax,1)
+    {0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // nopw 0L(%[re]ax,%[re]ax,1)
+    {0x66, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // nopw %cs:0L(%[re]ax,%[re]ax,1)
+    {0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // The same with more 0x66 prefixes
+    {0x66, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x66, 0x66, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x66, 0x66, 0x66, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00,
+     0x00},
+    {0x66, 0x66, 0x66, 0x66, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00,
+     0x00, 0x00},
+    {0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00,
+     0x00, 0x00, 0x00}};
+
+ArrayRef<uint8_t> X86::getNop(unsigned Length) {
+  assert(Length >= 1 && Length <= 15 && "No such NOP!");
+  return makeArrayRef(Nops[Length - 1], Length);
+}
+
+void X86::writeNops(uint8_t *P, uint64_t Count, unsigned MaxNopLength) {
+  MaxNopLength = std::min(std::max(MaxNopLength, 1U), 15U);
+  while (Count) {
+    unsigned N = std::min<uint64_t>(Count, MaxNopLength);
+    memcpy(P, Nops[N - 1], N);
+    P += N;
+    Count -= N;
+  }
+}
+
+unsigned X86::getNopLength(ArrayRef<uint8_t> Bytes) {
+  size_t I = 0, E = Bytes.size();
+  while (I != E && (Bytes[I] == 0x66 || Bytes[I] == 0x2e))
+    ++I;
+  if (I == E)
+    return 0;
+  if (Bytes[I] == 0x90)
+    return I + 1;
+  if (I + 2 >= E || Bytes[I] != 0x0f || Bytes[I + 1] != 0x1f)
+    return 0;
+  unsigned Size;
+  switch (Bytes[I + 2]) {
+  case 0x00: Size = 3; break;
+  case 0x40: Size = 4; break;
+  case 0x44: Size = 5; break;
+  case 0x80: Size = 7; break;
+  case 0x84: Size = 8; break;
+  default: return 0;
+  }
+  return I + Size > E ? 0 : I + Size;
+}
@@ -815,6 +815,13 @@ void AArch64AsmPrinter::EmitFMov0(const MachineInstr &MI) {
 #include "AArch64GenMCPseudoLowering.inc"
 
 void AArch64AsmPrinter::EmitInstruction(const MachineInstr *MI) {
+  // Koo: Pseudo expansions build their MCInsts from scratch, which the streamer
+  //      attributes to the latest parent
+  const MachineBasicBlock *MBB = MI->getParent();
+  if (MAI->RandMetadata)
+    getReorderInfo().latestParentID =
+        MCMBBKey(MBB->getParent()->getFunctionNumber(), MBB->getNumber());
+
   // Do any auto-generated pseudo lowerings.
   if (emitPseudoExpansionLowering(*OutStreamer, MI))
     return;
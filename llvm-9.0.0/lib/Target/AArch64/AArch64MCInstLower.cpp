@@ -16,9 +16,11 @@
 #include "Utils/AArch64BaseInfo.h"
 #include "llvm/CodeGen/AsmPrinter.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
+#include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineModuleInfoImpls.h"
 #include "llvm/IR/Mangler.h"
+#include "llvm/MC/MCAsmInfo.h"
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCExpr.h"
 #include "llvm/MC/MCInst.h"
@@ -312,4 +314,13 @@ void AArch64MCInstLower::Lower(const MachineInstr *MI, MCInst &OutMI) const {
     OutMI.addOperand(MCOperand::createReg(AArch64::LR));
     break;
   }
+
+  // Koo: Keep the parent MF and MBB of the instruction (MFID_MBBID), which
+  //      MCStreamer and MCAssembler do not know any more (see X86MCInstLower)
+  if (!Printer.MAI->RandMetadata)
+    return;
+  MCMBBKey ID = Printer.getRandMBBKey(*MI->getParent());
+  MCReorderInfo &RI = Ctx.getReorderInfo();
+  OutMI.setParent(RI.MBBHandles.intern(ID));
+  RI.latestParentID = ID;
 }
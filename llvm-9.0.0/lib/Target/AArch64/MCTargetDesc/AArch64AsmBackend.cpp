@@ -96,7 +96,9 @@ public:
 
   unsigned getFixupKindContainereSizeInBytes(unsigned Kind) const;
   
-  unsigned getFixupKindLog2Size(unsigned Kind) const override { return 0; } // Koo [N/A Here]
+  // Koo: The fixups of the CCR reordering information (see MCAsmBackend)
+  unsigned getFixupKindLog2Size(unsigned Kind) const override;
+  unsigned getFixupKindReachLog2(unsigned Kind) const override;
 
   bool shouldForceRelocation(const MCAssembler &Asm, const MCFixup &Fixup,
                              const MCValue &Target) override;
@@ -368,6 +370,51 @@ unsigned AArch64AsmBackend::getFixupKindContainereSizeInBytes(unsigned Kind) con
   }
 }
 
+// Koo: Bytes that a fixup dereferences; a fixup in an instruction takes the
+//      whole (little endian) instruction word to re-encode it
+unsigned AArch64AsmBackend::getFixupKindLog2Size(unsigned Kind) const {
+  switch (Kind) {
+  case FK_NONE:
+  case AArch64::fixup_aarch64_tlsdesc_call:
+    return 0;
+  case FK_Data_1:
+  case FK_PCRel_1:
+  case FK_SecRel_1:
+    return 1;
+  case FK_Data_2:
+  case FK_PCRel_2:
+  case FK_SecRel_2:
+    return 2;
+  case FK_Data_8:
+  case FK_PCRel_8:
+  case FK_SecRel_8:
+    return 8;
+  default:
+    return 4;
+  }
+}
+
+// Koo: The reach of the PC-relative fixups in instructions. An ADRP reaches
+//      +/-4 GB by pages; the :lo12: half of the pair (add_imm12 and
+//      ldst_imm12_*) is absolute, thus not limited by the distance.
+unsigned AArch64AsmBackend::getFixupKindReachLog2(unsigned Kind) const {
+  switch (Kind) {
+  case AArch64::fixup_aarch64_pcrel_branch14:
+    return 15; // tbz/tbnz: +/-32 KB
+  case AArch64::fixup_aarch64_pcrel_branch19:
+  case AArch64::fixup_aarch64_ldr_pcrel_imm19:
+  case AArch64::fixup_aarch64_pcrel_adr_imm21:
+    return 20; // b.cc/cbz/cbnz, ldr (literal) and adr: +/-1 MB
+  case AArch64::fixup_aarch64_pcrel_branch26:
+  case AArch64::fixup_aarch64_pcrel_call26:
+    return 27; // b/bl: +/-128 MB
+  case AArch64::fixup_aarch64_pcrel_adrp_imm21:
+    return 32;
+  default:
+    return 0;
+  }
+}
+
 void AArch64AsmBackend::applyFixup(const MCAssembler &Asm, const MCFixup &Fixup,
                                    const MCValue &Target,
                                    MutableArrayRef<char> Data, uint64_t Value,
@@ -193,13 +193,49 @@ public:
 
     return true;
   }
-  
-  unsigned getFixupKindLog2Size(unsigned Kind) const override { return 0; } // Koo [N/A Here]
-  
+
+  // Koo: The fixups of the CCR reordering information (see MCAsmBackend)
+  unsigned getFixupKindLog2Size(unsigned Kind) const override;
+  unsigned getFixupKindReachLog2(unsigned Kind) const override;
 };
 } // end anonymous namespace
 
 
+// Koo: Bytes that a fixup dereferences, as applyFixup() patches them: the
+//      whole instruction word of a branch, the 16-bit immediate of an @ha/@l
+//      half (with the two low bits of a DS-form one)
+unsigned PPCAsmBackend::getFixupKindLog2Size(unsigned Kind) const {
+  switch (Kind) {
+  case FK_PCRel_1:
+  case FK_SecRel_1:
+    return 1;
+  case FK_PCRel_2:
+  case FK_SecRel_2:
+    return 2;
+  case FK_PCRel_4:
+  case FK_SecRel_4:
+    return 4;
+  case FK_PCRel_8:
+  case FK_SecRel_8:
+    return 8;
+  default:
+    return getFixupKindNumBytes(Kind);
+  }
+}
+
+// Koo: The reach of the PC-relative branches; an @ha/@l pair reaches +/-2 GB
+//      as a whole, which neither half tells on its own
+unsigned PPCAsmBackend::getFixupKindReachLog2(unsigned Kind) const {
+  switch (Kind) {
+  case PPC::fixup_ppc_brcond14:
+    return 15; // bc: +/-32 KB
+  case PPC::fixup_ppc_br24:
+    return 25; // b/bl: +/-32 MB
+  default:
+    return 0;
+  }
+}
+
 // FIXME: This should be in a separate file.
 namespace {
 
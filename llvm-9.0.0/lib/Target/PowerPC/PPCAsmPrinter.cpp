@@ -497,6 +497,11 @@ void PPCAsmPrinter::EmitTlsCall(const MachineInstr *MI,
 /// the current output stream.
 ///
 void PPCAsmPrinter::EmitInstruction(const MachineInstr *MI) {
+  // Koo: The expansions below build their MCInsts from scratch, which the
+  //      streamer attributes to the latest parent
+  if (MAI->RandMetadata)
+    getReorderInfo().latestParentID = getRandMBBKey(*MI->getParent());
+
   MCInst TmpInst;
   bool isPPC64 = Subtarget->isPPC64();
   bool isDarwin = TM.getTargetTriple().isOSDarwin();
@@ -1098,6 +1103,10 @@ void PPCAsmPrinter::EmitInstruction(const MachineInstr *MI) {
 }
 
 void PPCLinuxAsmPrinter::EmitInstruction(const MachineInstr *MI) {
+  // Koo: So do the XRay sleds below (see PPCAsmPrinter::EmitInstruction())
+  if (MAI->RandMetadata)
+    getReorderInfo().latestParentID = getRandMBBKey(*MI->getParent());
+
   if (!Subtarget->isPPC64())
     return PPCAsmPrinter::EmitInstruction(MI);
 
@@ -1318,6 +1327,12 @@ void PPCLinuxAsmPrinter::EmitFunctionEntryLabel() {
 
       OutStreamer->EmitLabel(PPCFI->getTOCOffsetSymbol());
       OutStreamer->EmitValue(TOCDeltaExpr, 8);
+
+      // Koo: The offset moves along with the function, thus its first BBL
+      //      takes the bytes (see EmitFunctionBodyStart())
+      if (MAI->RandMetadata)
+        getReorderInfo().updateByteCounter(getRandMBBKey(MF->front()), 8,
+                                           /*numFixups=*/1, /*isAlign=*/false);
     }
     return AsmPrinter::EmitFunctionEntryLabel();
   }
@@ -1420,6 +1435,11 @@ void PPCLinuxAsmPrinter::EmitFunctionBodyStart() {
     // function. This matters because it affects the alignment.
     const PPCFunctionInfo *PPCFI = MF->getInfo<PPCFunctionInfo>();
 
+    // Koo: The global entry point is the start of the first BBL; the TOC
+    //      setup (an @ha/@l pair relative to it) moves along with it
+    if (MAI->RandMetadata)
+      getReorderInfo().latestParentID = getRandMBBKey(MF->front());
+
     MCSymbol *GlobalEntryLabel = PPCFI->getGlobalEPSymbol();
     OutStreamer->EmitLabel(GlobalEntryLabel);
     const MCSymbolRefExpr *GlobalEntryLabelExp =
@@ -24,8 +24,10 @@
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCExpr.h"
 #include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCReorderInfo.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
 using namespace llvm;
 
@@ -157,6 +159,15 @@ void llvm::LowerPPCMachineInstrToMCInst(const MachineInstr *MI, MCInst &OutMI,
                                           isDarwin))
       OutMI.addOperand(MCOp);
   }
+
+  // Koo: Keep the parent MF and MBB of the instruction (MFID_MBBID), which
+  //      MCStreamer and MCAssembler do not know any more (see X86MCInstLower)
+  if (!AP.MAI->RandMetadata)
+    return;
+  MCMBBKey ID = AP.getRandMBBKey(*MI->getParent());
+  MCReorderInfo &RI = AP.getReorderInfo();
+  OutMI.setParent(RI.MBBHandles.intern(ID));
+  RI.latestParentID = ID;
 }
 
 bool llvm::LowerPPCMachineOperandToMCOperand(const MachineOperand &MO,
@@ -154,6 +154,37 @@ bool RISCVAsmBackend::mayNeedRelaxation(const MCInst &Inst,
   return getRelaxedOpcode(Inst.getOpcode()) != Inst.getOpcode();
 }
 
+// Koo: Bytes that a fixup dereferences (the instruction or the auipc+jalr pair
+//      that holds it); this follows the bytes that applyFixup() patches
+unsigned RISCVAsmBackend::getFixupKindLog2Size(unsigned Kind) const {
+  const MCFixupKindInfo &Info = getFixupKindInfo(MCFixupKind(Kind));
+  return alignTo(Info.TargetOffset + Info.TargetSize, 8) / 8;
+}
+
+// Koo: The reach of the PC-relative fixups in instructions; the %pcrel_lo half
+//      of a pair is bound by its %pcrel_hi
+unsigned RISCVAsmBackend::getFixupKindReachLog2(unsigned Kind) const {
+  switch (Kind) {
+  case RISCV::fixup_riscv_rvc_branch:
+    return 8;  // c.beqz/c.bnez: +/-256 B
+  case RISCV::fixup_riscv_rvc_jump:
+    return 11; // c.j/c.jal: +/-2 KB
+  case RISCV::fixup_riscv_branch:
+    return 12; // bxx: +/-4 KB
+  case RISCV::fixup_riscv_jal:
+    return 20; // jal: +/-1 MB
+  case RISCV::fixup_riscv_pcrel_hi20:
+  case RISCV::fixup_riscv_got_hi20:
+  case RISCV::fixup_riscv_tls_got_hi20:
+  case RISCV::fixup_riscv_tls_gd_hi20:
+  case RISCV::fixup_riscv_call:
+  case RISCV::fixup_riscv_call_plt:
+    return 31; // auipc: +/-2 GB
+  default:
+    return 0;
+  }
+}
+
 bool RISCVAsmBackend::writeNopData(raw_ostream &OS, uint64_t Count) const {
   bool HasStdExtC = STI.getFeatureBits()[RISCV::FeatureStdExtC];
   unsigned MinNopLen = HasStdExtC ? 2 : 4;
@@ -141,7 +141,9 @@ public:
 
   bool writeNopData(raw_ostream &OS, uint64_t Count) const override;
   
-  unsigned getFixupKindLog2Size(unsigned Kind) const override { return 0; } // Koo [N/A Here]
+  // Koo: The fixups of the CCR reordering information (see MCAsmBackend)
+  unsigned getFixupKindLog2Size(unsigned Kind) const override;
+  unsigned getFixupKindReachLog2(unsigned Kind) const override;
 
   const MCTargetOptions &getTargetOptions() const { return TargetOptions; }
   RISCVABI::ABI getTargetABI() const { return TargetABI; }
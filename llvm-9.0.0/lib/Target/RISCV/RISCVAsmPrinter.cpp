@@ -64,6 +64,7 @@ void RISCVAsmPrinter::EmitToStreamer(MCStreamer &S, const MCInst &Inst) {
   MCInst CInst;
   bool Res = compressInst(CInst, Inst, *TM.getMCSubtargetInfo(),
                           OutStreamer->getContext());
+  CInst.setParent(Inst.getParent()); // Koo
   AsmPrinter::EmitToStreamer(*OutStreamer, Res ? CInst : Inst);
 }
 
@@ -72,6 +73,13 @@ void RISCVAsmPrinter::EmitToStreamer(MCStreamer &S, const MCInst &Inst) {
 #include "RISCVGenMCPseudoLowering.inc"
 
 void RISCVAsmPrinter::EmitInstruction(const MachineInstr *MI) {
+  // Koo: Pseudo expansions build their MCInsts from scratch, which the streamer
+  //      attributes to the latest parent
+  const MachineBasicBlock *MBB = MI->getParent();
+  if (MAI->RandMetadata)
+    getReorderInfo().latestParentID =
+        MCMBBKey(MBB->getParent()->getFunctionNumber(), MBB->getNumber());
+
   // Do any auto-generated pseudo lowerings.
   if (emitPseudoExpansionLowering(*OutStreamer, MI))
     return;
@@ -15,6 +15,7 @@
 #include "MCTargetDesc/RISCVMCExpr.h"
 #include "llvm/CodeGen/AsmPrinter.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
+#include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/MC/MCContext.h"
@@ -116,4 +117,13 @@ void llvm::LowerRISCVMachineInstrToMCInst(const MachineInstr *MI, MCInst &OutMI,
     if (LowerRISCVMachineOperandToMCOperand(MO, MCOp, AP))
       OutMI.addOperand(MCOp);
   }
+
+  // Koo: Keep the parent MF and MBB of the instruction (MFID_MBBID), which
+  //      MCStreamer and MCAssembler do not know any more (see X86MCInstLower)
+  if (!AP.MAI->RandMetadata)
+    return;
+  MCMBBKey ID = AP.getRandMBBKey(*MI->getParent());
+  MCReorderInfo &RI = AP.getReorderInfo();
+  OutMI.setParent(RI.MBBHandles.intern(ID));
+  RI.latestParentID = ID;
 }
@@ -18,6 +18,7 @@
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Mangler.h"
+#include "llvm/IR/Module.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCInstrInfo.h"
@@ -77,6 +78,38 @@ void TargetMachine::resetTargetOptions(const Function &F) const {
     Options.FPDenormalMode = DefaultOptions.FPDenormalMode;
 }
 
+void TargetMachine::addCCRModuleFlags(Module &M,
+                                      const MCTargetOptions &Options) {
+  if (!Options.CCRMetadata)
+    return;
+  M.addModuleFlag(Module::Max, "ccr-metadata", 1);
+  if (Options.CCRGranularity)
+    M.addModuleFlag(Module::Max, "ccr-granularity", Options.CCRGranularity);
+  if (Options.CCRRandFormat)
+    M.addModuleFlag(Module::Max, "ccr-rand-format", Options.CCRRandFormat);
+  if (Options.CCRRelocatedFixups)
+    M.addModuleFlag(Module::Max, "ccr-relocated-fixups",
+                    Options.CCRRelocatedFixups);
+}
+
+void TargetMachine::applyCCRModuleFlags(const Module &M,
+                                        TargetOptions &Options) {
+  auto GetFlag = [&](StringRef Key) -> unsigned {
+    if (auto *Val = mdconst::extract_or_null<ConstantInt>(M.getModuleFlag(Key)))
+      return Val->getZExtValue();
+    return 0;
+  };
+  if (!GetFlag("ccr-metadata"))
+    return;
+  Options.MCOptions.CCRMetadata = true;
+  if (unsigned Granularity = GetFlag("ccr-granularity"))
+    Options.MCOptions.CCRGranularity = Granularity;
+  if (unsigned Format = GetFlag("ccr-rand-format"))
+    Options.MCOptions.CCRRandFormat = Format;
+  if (unsigned Fixups = GetFlag("ccr-relocated-fixups"))
+    Options.MCOptions.CCRRelocatedFixups = Fixups;
+}
+
 /// Returns the code generation relocation model. The choices are static, PIC,
 /// and dynamic-no-pic.
 Reloc::Model TargetMachine::getRelocationModel() const { return RM; }
@@ -1642,9 +1642,6 @@ encodeInstruction(const MCInst &MI, raw_ostream &OS,
     abort();
   }
 #endif
-
-  // Koo: Update the actual bytes to be emitted in MCSubtargetInfo class
-  STI.setByteCtr(CurByte);
 }
 
 MCCodeEmitter *llvm::createX86MCCodeEmitter(const MCInstrInfo &MCII,
@@ -196,12 +196,6 @@ namespace {
              "OptForMinSize implies OptForSize");
 
       SelectionDAGISel::runOnMachineFunction(MF);
-	  
-	  // Koo - Overriden from lib/CodeGen/BranchFolding.cpp
-      MachineJumpTableInfo *MJTI = MF.getJumpTableInfo();
-      if (MJTI)
-        MF.RecordMachineJumpTableInfo(MJTI);
-	
       return true;
     }
 
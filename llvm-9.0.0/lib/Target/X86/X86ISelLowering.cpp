@@ -84,6 +84,14 @@ static cl::opt<bool> MulConstantOptimization(
              "SHIFT, LEA, etc."),
     cl::Hidden);
 
+// Koo
+static cl::opt<bool> CCRFunctionRelativeJumpTables(
+    "ccr-function-relative-jump-tables", cl::init(false),
+    cl::desc("Emit the jump table entries as 32-bit offsets from the start of "
+             "the function (x86-64 ELF), which the CCR randomizer needs to "
+             "patch only if the blocks of the function move"),
+    cl::Hidden);
+
 /// Call this when the user attempts to do something unsupported, like
 /// returning a double without SSE2 enabled on x86_64. This is not fatal, unlike
 /// report_fatal_error, so calling code should attempt to recover without
@@ -2139,10 +2147,30 @@ unsigned X86TargetLowering::getJumpTableEncoding() const {
   if (isPositionIndependent() && Subtarget.isPICStyleGOT())
     return MachineJumpTableInfo::EK_Custom32;
 
+  // Koo - Label differences with or without PIC
+  if (isJumpTableFunctionRelative())
+    return MachineJumpTableInfo::EK_LabelDifference32;
+
   // Otherwise, use the normal jump table encoding heuristics.
   return TargetLowering::getJumpTableEncoding();
 }
 
+bool X86TargetLowering::isJumpTableRelative() const {
+  return isJumpTableFunctionRelative() || TargetLowering::isJumpTableRelative();
+}
+
+// Koo - Every entry of a jump table in .rodata is a relocation against .text
+//       (PIC), or an absolute address, thus a d2c fixup that the randomizer
+//       patches whenever the function moves. An entry relative to the start
+//       of the function (in the same section as the blocks) is resolved by the
+//       assembler instead, and only changes if the blocks move within their
+//       function. The base is addressed the way the table is.
+bool X86TargetLowering::isJumpTableFunctionRelative() const {
+  return CCRFunctionRelativeJumpTables && Subtarget.is64Bit() &&
+         Subtarget.isTargetELF() &&
+         getTargetMachine().getCodeModel() != CodeModel::Large;
+}
+
 bool X86TargetLowering::useSoftFloat() const {
   return Subtarget.useSoftFloat();
 }
@@ -2194,6 +2222,14 @@ SDValue X86TargetLowering::getPICJumpTableRelocBase(SDValue Table,
     // same as a Register.
     return DAG.getNode(X86ISD::GlobalBaseReg, SDLoc(),
                        getPointerTy(DAG.getDataLayout()));
+
+  // Koo - The label at the start of the function
+  if (isJumpTableFunctionRelative()) {
+    MachineFunction &MF = DAG.getMachineFunction();
+    MVT PtrVT = getPointerTy(DAG.getDataLayout());
+    return DAG.getNode(getGlobalWrapperKind(), SDLoc(Table), PtrVT,
+                       DAG.getMCSymbol(MF.getJTBaseSymbol(), PtrVT));
+  }
   return Table;
 }
 
@@ -2202,8 +2238,9 @@ SDValue X86TargetLowering::getPICJumpTableRelocBase(SDValue Table,
 const MCExpr *X86TargetLowering::
 getPICJumpTableRelocBaseExpr(const MachineFunction *MF, unsigned JTI,
                              MCContext &Ctx) const {
-  // X86-64 uses RIP relative addressing based on the jump table label.
-  if (Subtarget.isPICStyleRIPRel())
+  // X86-64 uses RIP relative addressing based on the jump table label
+  // (Koo - or on the function label, with or without PIC).
+  if (Subtarget.isPICStyleRIPRel() || isJumpTableFunctionRelative())
     return TargetLowering::getPICJumpTableRelocBaseExpr(MF, JTI, Ctx);
 
   // Otherwise, the reference is relative to the PIC base.
@@ -30522,10 +30559,21 @@ X86TargetLowering::EmitSjLjDispatchBlock(MachineInstr &MI,
           .addReg(0);
       // movsx OReg64, OReg
       BuildMI(DispContBB, DL, TII->get(X86::MOVSX64rr32), OReg64).addReg(OReg);
+      // Koo - leaq .LJTB0(%rip), FReg (the base of function-relative entries)
+      unsigned EntryBase = BReg;
+      if (isJumpTableFunctionRelative()) {
+        EntryBase = MRI->createVirtualRegister(&X86::GR64RegClass);
+        BuildMI(DispContBB, DL, TII->get(X86::LEA64r), EntryBase)
+            .addReg(X86::RIP)
+            .addImm(1)
+            .addReg(0)
+            .addSym(MF->getJTBaseSymbol())
+            .addReg(0);
+      }
       // addq BReg, OReg64, TReg
       BuildMI(DispContBB, DL, TII->get(X86::ADD64rr), TReg)
           .addReg(OReg64)
-          .addReg(BReg);
+          .addReg(EntryBase);
       // jmpq *TReg
       BuildMI(DispContBB, DL, TII->get(X86::JMP64r)).addReg(TReg);
       break;
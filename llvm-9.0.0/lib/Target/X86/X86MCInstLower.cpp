@@ -2290,17 +2290,13 @@ void X86AsmPrinter::EmitInstruction(const MachineInstr *MI) {
   // Koo [Note] While converting MachineInstr into MCInst, it is essential to maintain
   //            its parent MF and MBB because MCStreamer and MCAssembler do not care 
   //            them any more semantically. After this phase, fragment and section govern.
-  const MachineBasicBlock *MBB = MI->getParent();
-  unsigned MBBID = MBB->getNumber();
-  unsigned MFID = MBB->getParent()->getFunctionNumber();
-  std::string ID = std::to_string(MFID) + "_" + std::to_string(MBBID);
-  TmpInst.setParent(ID);
-
-  // Koo [Note] Simple hack: both MF and MAI can be accessible, thus update fallThrough here.
-  const MCAsmInfo *MAI = getMCAsmInfo();
-  if (MAI->canMBBFallThrough.count(ID) == 0)
-     MAI->canMBBFallThrough[ID] = MF->canMBBFallThrough[ID];
-  MAI->latestParentID = ID;
+  //            At function granularity, the MBBs of a function share a key.
+  if (MAI->RandMetadata) {
+    MCMBBKey ID = getRandMBBKey(*MI->getParent());
+    MCReorderInfo &RI = getReorderInfo();
+    TmpInst.setParent(RI.MBBHandles.intern(ID));
+    RI.latestParentID = ID;
+  }
 
   // Stackmap shadows cannot include branch targets, so we can count the bytes
   // in a call towards the shadow, but must ensure that the no thread returns
@@ -53,12 +53,14 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ProfileSummary.h"
+#include "llvm/MC/MCAsmInfo.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Target/TargetMachine.h"
 
 using namespace clang;
 using namespace CodeGen;
@@ -602,6 +604,15 @@ void CodeGenModule::Release() {
   if (CodeGenOpts.NoPLT)
     getModule().setRtLibUseGOT();
 
+  // Koo: The CCR settings (-fccr-metadata and the -ccr-* options) go along
+  //      with the IR, for the LTO backends to emit .rand as they tell
+  {
+    llvm::MCTargetOptions CCROptions;
+    CCROptions.CCRMetadata = CodeGenOpts.CCRMetadata;
+    llvm::MCAsmInfo::getRandOptions(CCROptions);
+    llvm::TargetMachine::addCCRModuleFlags(getModule(), CCROptions);
+  }
+
   SimplifyPersonality();
 
   if (getCodeGenOpts().EmitDeclMetadata)
@@ -1588,6 +1599,13 @@ void CodeGenModule::SetLLVMFunctionAttributesForDefinition(const Decl *D,
       B.addAttribute(llvm::Attribute::MinSize);
   }
 
+  // Koo: "bbl" is what the backend does without the attribute
+  if (const auto *CA = D->getAttr<CCRGranularityAttr>())
+    if (CA->getGranularity() != CCRGranularityAttr::BBL)
+      B.addAttribute("ccr-granularity",
+                     CCRGranularityAttr::ConvertGranularityTypeToStr(
+                         CA->getGranularity()));
+
   F->addAttributes(llvm::AttributeList::FunctionIndex, B);
 
   unsigned alignment = D->getMaxAlignment() / Context.getCharWidth();
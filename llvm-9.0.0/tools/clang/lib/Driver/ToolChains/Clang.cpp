@@ -2047,6 +2047,13 @@ void Clang::DumpCompilationDatabase(Compilation &C, StringRef Filename,
   CDB << ", \"" << escape(Buf) << "\"]},\n";
 }
 
+// Koo: The CCR metadata is only collected for the builds that are randomized,
+//      i.e., by default when the driver is invoked as ccr or ccr++
+static bool shouldEmitCCRMetadata(const Driver &D, const ArgList &Args) {
+  return Args.hasFlag(options::OPT_fccr_metadata, options::OPT_fno_ccr_metadata,
+                      StringRef(D.Name).startswith("ccr"));
+}
+
 static void CollectArgsForIntegratedAssembler(Compilation &C,
                                               const ArgList &Args,
                                               ArgStringList &CmdArgs,
@@ -4419,6 +4426,9 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                    options::OPT_fno_stack_size_section, RawTriple.isPS4()))
     CmdArgs.push_back("-fstack-size-section");
 
+  if (shouldEmitCCRMetadata(D, Args))
+    CmdArgs.push_back("-fccr-metadata");
+
   CmdArgs.push_back("-ferror-limit");
   if (Arg *A = Args.getLastArg(options::OPT_ferror_limit_EQ))
     CmdArgs.push_back(A->getValue());
@@ -6170,6 +6180,9 @@ void ClangAs::ConstructJob(Compilation &C, const JobAction &JA,
   CollectArgsForIntegratedAssembler(C, Args, CmdArgs,
                                     getToolChain().getDriver());
 
+  if (shouldEmitCCRMetadata(getToolChain().getDriver(), Args))
+    CmdArgs.push_back("-fccr-metadata");
+
   Args.AddAllArgs(CmdArgs, options::OPT_mllvm);
 
   assert(Output.isFilename() && "Unexpected lipo output.");
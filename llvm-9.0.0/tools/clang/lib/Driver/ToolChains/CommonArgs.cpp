@@ -434,6 +434,11 @@ void tools::AddGoldPlugin(const ToolChain &ToolChain, const ArgList &Args,
     CmdArgs.push_back("-plugin-opt=-data-sections");
   }
 
+  // Koo: The LTO backend collects the CCR metadata of the objects it emits
+  if (Args.hasFlag(options::OPT_fccr_metadata, options::OPT_fno_ccr_metadata,
+                   StringRef(ToolChain.getDriver().Name).startswith("ccr")))
+    CmdArgs.push_back("-plugin-opt=-ccr-metadata");
+
   if (Arg *A = getLastProfileSampleUseArg(Args)) {
     StringRef FName = A->getValue();
     if (!llvm::sys::fs::exists(FName))
@@ -3205,6 +3205,25 @@ static void handleEnumExtensibilityAttr(Sema &S, Decl *D,
       AL.getAttributeSpellingListIndex()));
 }
 
+// Koo: __attribute__((ccr_granularity("none" | "function" | "bbl")))
+static void handleCCRGranularityAttr(Sema &S, Decl *D, const ParsedAttr &AL) {
+  StringRef Str;
+  SourceLocation ArgLoc;
+  if (!S.checkStringLiteralArgumentAttr(AL, 0, Str, &ArgLoc))
+    return;
+
+  CCRGranularityAttr::GranularityType Granularity;
+  if (!CCRGranularityAttr::ConvertStrToGranularityType(Str, Granularity)) {
+    S.Diag(AL.getLoc(), diag::warn_attribute_type_not_supported) << AL << Str
+                                                                 << ArgLoc;
+    return;
+  }
+
+  D->addAttr(::new (S.Context) CCRGranularityAttr(
+      AL.getRange(), S.Context, Granularity,
+      AL.getAttributeSpellingListIndex()));
+}
+
 /// Handle __attribute__((format_arg((idx)))) attribute based on
 /// http://gcc.gnu.org/onlinedocs/gcc/Function-Attributes.html
 static void handleFormatArgAttr(Sema &S, Decl *D, const ParsedAttr &AL) {
@@ -6764,6 +6783,9 @@ static void ProcessDeclAttribute(Sema &S, Scope *scope, Decl *D,
   case ParsedAttr::AT_EnumExtensibility:
     handleEnumExtensibilityAttr(S, D, AL);
     break;
+  case ParsedAttr::AT_CCRGranularity:
+    handleCCRGranularityAttr(S, D, AL);
+    break;
   case ParsedAttr::AT_Flatten:
     handleSimpleAttribute<FlattenAttr>(S, D, AL);
     break;
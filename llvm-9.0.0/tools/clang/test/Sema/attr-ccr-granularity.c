@@ -0,0 +1,11 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+
+void f1() __attribute__((ccr_granularity("none")));
+void f2() __attribute__((ccr_granularity("function")));
+void f3() __attribute__((ccr_granularity("bbl")));
+
+void f4() __attribute__((ccr_granularity("loop"))); // expected-warning{{'ccr_granularity' attribute argument not supported: loop}}
+void f5() __attribute__((ccr_granularity(1))); // expected-error{{'ccr_granularity' attribute requires a string}}
+void f6() __attribute__((ccr_granularity)); // expected-error{{'ccr_granularity' attribute takes one argument}}
+
+int var1 __attribute__((ccr_granularity("none"))); // expected-error{{'ccr_granularity' attribute only applies to functions and Objective-C methods}}
@@ -133,6 +133,7 @@ struct AssemblerInvocation {
   unsigned FatalWarnings : 1;
   unsigned IncrementalLinkerCompatible : 1;
   unsigned EmbedBitcode : 1;
+  unsigned CCRMetadata : 1; // Koo
 
   /// The name of the relocation model to use.
   std::string RelocationModel;
@@ -159,6 +160,7 @@ public:
     IncrementalLinkerCompatible = 0;
     DwarfVersion = 0;
     EmbedBitcode = 0;
+    CCRMetadata = 0;
   }
 
   static bool CreateFromArgs(AssemblerInvocation &Res,
@@ -290,6 +292,8 @@ bool AssemblerInvocation::CreateFromArgs(AssemblerInvocation &Opts,
   Opts.IncrementalLinkerCompatible =
       Args.hasArg(OPT_mincremental_linker_compatible);
   Opts.SymbolDefs = Args.getAllArgValues(OPT_defsym);
+  Opts.CCRMetadata =
+      Args.hasFlag(OPT_fccr_metadata, OPT_fno_ccr_metadata, false);
 
   // EmbedBitcode Option. If -fembed-bitcode is enabled, set the flag.
   // EmbedBitcode behaves the same for all embed options for assembly files.
@@ -358,9 +362,9 @@ static bool ExecuteAssembler(AssemblerInvocation &Opts,
   MAI->setCompressDebugSections(Opts.CompressDebugSections);
 
   MAI->setRelaxELFRelocations(Opts.RelaxELFRelocations);
-
-  // Koo: This path is only taken when assembly file (*.s) is passed (cc1_main.cpp o/w)
-  MAI->isAssemFile = true;
+  // Koo: Either -fccr-metadata or -mllvm -ccr-metadata
+  if (Opts.CCRMetadata)
+    MAI->RandMetadata = true;
 
   bool IsBinary = Opts.OutputType == AssemblerInvocation::FT_Obj;
   if (Opts.OutputPath.empty())
@@ -379,6 +383,10 @@ static bool ExecuteAssembler(AssemblerInvocation &Opts,
 
   MCContext Ctx(MAI.get(), MRI.get(), MOFI.get(), &SrcMgr);
 
+  // Koo: This path is only taken when assembly file (*.s) is passed (cc1_main.cpp o/w)
+  if (MAI->RandMetadata)
+    Ctx.getReorderInfo().isAssemFile = true;
+
   bool PIC = false;
   if (Opts.RelocationModel == "static") {
     PIC = false;
@@ -20,6 +20,7 @@
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/LTO/Caching.h"
 #include "llvm/LTO/LTO.h"
+#include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Object/Error.h"
 #include "llvm/Support/CachePruning.h"
 #include "llvm/Support/CommandLine.h"
@@ -845,6 +846,13 @@ static std::unique_ptr<LTO> createLTO(IndexWriteCallback OnIndexWrite,
   // FIXME: Check the gold version or add a new option to enable them.
   Conf.Options.RelaxELFRelocations = false;
 
+  // Koo: Every LTO partition and ThinLTO backend emits the .rand section of
+  //      its own object, which gold then merges like that of any other input.
+  //      The CCR settings of the link (-plugin-opt=-ccr-*) go to all of them,
+  //      but the ccr-* module flags of a module take over for its own task
+  //      (see TargetMachine::applyCCRModuleFlags()).
+  MCAsmInfo::getRandOptions(Conf.Options.MCOptions);
+
   // Toggle function/data sections.
   if (FunctionSections.getNumOccurrences() == 0)
     Conf.Options.FunctionSections = SplitSections;
@@ -0,0 +1,56 @@
+/*===- CCRLayout.h - Runtime layout introspection for profilers ---*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+|*===----------------------------------------------------------------------===*|
+|*                                                                            *|
+|* Koo: An in-process profiler (a heap sampler, a CPU profiler) symbolizes    *|
+|* its samples with the symbol table on disk, which describes the original    *|
+|* layout. Linking libCCRLayout reserves an allocated note that the           *|
+|* randomizer fills in with the translation map of the new layout (see        *|
+|* llvm/BinaryFormat/RandMap.h), thus a sampled PC is translated back in      *|
+|* O(log n) without a syscall, in the randomized binary and in the copies     *|
+|* that the load-time engine randomizes alike.                                *|
+|*                                                                            *|
+|* The reserved room holds CCR_LAYOUT_CAPACITY ranges (a function moved as a  *|
+|* whole is one range, a shuffled BBL is one); the library is rebuilt with a  *|
+|* larger -DCCR_LAYOUT_CAPACITY=<N> for binaries the randomizer warns about.  *|
+|*                                                                            *|
+|* A second note takes the pages of the hot and startup code in the new       *|
+|* layout, up to CCR_HOT_PAGES_CAPACITY ranges (the closest ones are merged   *|
+|* beyond that), which the startup code of a service reads ahead in a single  *|
+|* pass with ccr_prefetch_hot_pages().                                        *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_CCRLAYOUT_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_CCRLAYOUT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Nonzero if the randomizer has filled in the layout note of this binary */
+int ccr_layout_randomized(void);
+
+/* The address that \p PC, an address of this binary in memory, has in the
+ * original layout (at the same load bias). The alignment padding and the
+ * jumps the randomizer inserted belong to the last byte of the code before
+ * them; a PC outside the randomized code is returned as is. */
+uintptr_t ccr_translate_pc(uintptr_t PC);
+
+/* Ask the kernel to read the pages of the hot code of this binary ahead
+ * (madvise(MADV_WILLNEED) over each range of the note). Returns the number of
+ * bytes advised, or -1 if the randomizer has not filled in the note. */
+long ccr_prefetch_hot_pages(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LLVM_TOOLS_LLVM_CCR_RAND_CCRLAYOUT_H */
@@ -0,0 +1,187 @@
+//===- CCRRandomizer.cpp - C interface of the randomizer ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: libLLVMCCRRandomizer is the randomizer of llvm-ccr-rand behind the C
+// interface of llvm-c/CCRRandomizer.h. A context is the metadata cache of
+// -serve (see Server.h), thus the binaries opened with it decode their .rand
+// once however many variants are written.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm-c/CCRRandomizer.h"
+#include "Randomizer.h"
+#include "Server.h"
+#include "llvm/Object/Binary.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::object;
+
+namespace {
+struct CCRContext {
+  MetadataCache Metadata;
+  bool Concurrent;
+
+  CCRContext(unsigned CacheSize, bool Concurrent)
+      : Metadata(CacheSize), Concurrent(Concurrent) {}
+};
+
+struct CCRBinary {
+  std::unique_ptr<MemoryBuffer> Buffer;
+  std::unique_ptr<Binary> Bin;
+  std::shared_ptr<const RandInfo> Info;
+  RandomizerConfig Config;
+  LayoutStats Stats; // Of the last randomization
+  uint64_t GrowthBytes = 0;
+  uint64_t TextSize = 0;
+};
+} // end anonymous namespace
+
+static CCRContext *unwrap(LLVMCCRContextRef C) {
+  return reinterpret_cast<CCRContext *>(C);
+}
+static CCRBinary *unwrap(LLVMCCRBinaryRef B) {
+  return reinterpret_cast<CCRBinary *>(B);
+}
+
+static LLVMBool setError(Error E, char **ErrorMessage) {
+  std::string Message = toString(std::move(E));
+  if (ErrorMessage)
+    *ErrorMessage = strdup(Message.c_str());
+  return 1;
+}
+
+uint32_t LLVMCCRRandomizerVersion(void) {
+  return LLVM_CCR_RANDOMIZER_API_VERSION;
+}
+
+LLVMCCRContextRef LLVMCCRCreateContext(unsigned CacheSize,
+                                       LLVMBool Concurrent) {
+  return reinterpret_cast<LLVMCCRContextRef>(
+      new CCRContext(CacheSize, Concurrent));
+}
+
+void LLVMCCRDisposeContext(LLVMCCRContextRef Context) {
+  delete unwrap(Context);
+}
+
+LLVMBool LLVMCCROpenBinary(LLVMCCRContextRef Context, const char *Path,
+                           LLVMCCRBinaryRef *OutBinary, char **ErrorMessage) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+      MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return setError(
+        createFileError(Path, errorCodeToError(BufOrErr.getError())),
+        ErrorMessage);
+  auto B = llvm::make_unique<CCRBinary>();
+  B->Buffer = std::move(*BufOrErr);
+  Expected<std::unique_ptr<Binary>> BinOrErr =
+      createBinary(B->Buffer->getMemBufferRef());
+  if (!BinOrErr)
+    return setError(createFileError(Path, BinOrErr.takeError()), ErrorMessage);
+  B->Bin = std::move(*BinOrErr);
+  auto *Obj = dyn_cast<ELF64LEObjectFile>(B->Bin.get());
+  if (!Obj)
+    return setError(
+        createFileError(Path, createStringError(inconvertibleErrorCode(),
+                                                "only ELF64 little-endian "
+                                                "binaries are supported")),
+        ErrorMessage);
+
+  Expected<std::shared_ptr<const RandInfo>> InfoOrErr =
+      unwrap(Context)->Metadata.get(*Obj, {});
+  if (!InfoOrErr)
+    return setError(createFileError(Path, InfoOrErr.takeError()), ErrorMessage);
+  B->Info = std::move(*InfoOrErr);
+  // The patching of one binary only runs on the thread pool while the
+  // binaries are randomized one by one (see llvm-ccr-rand.cpp)
+  B->Config.Parallel = !unwrap(Context)->Concurrent;
+  *OutBinary = reinterpret_cast<LLVMCCRBinaryRef>(B.release());
+  return 0;
+}
+
+void LLVMCCRDisposeBinary(LLVMCCRBinaryRef Binary) { delete unwrap(Binary); }
+
+void LLVMCCRPlan(LLVMCCRBinaryRef Binary, uint64_t Seed, LLVMCCRMode Mode) {
+  RandomizerConfig &Config = unwrap(Binary)->Config;
+  Config.Seed = Seed;
+  Config.ShuffleBBLs = Mode == LLVMCCRModeBasicBlocks;
+  Config.SlidePadding = Config.PaddingOnly = Mode == LLVMCCRModePaddingOnly;
+}
+
+LLVMBool LLVMCCRRandomizeToFD(LLVMCCRBinaryRef Binary, int FD,
+                              char **ErrorMessage) {
+  CCRBinary *B = unwrap(Binary);
+  StringRef Input = B->Buffer->getBuffer();
+  std::unique_ptr<WritableMemoryBuffer> Image =
+      WritableMemoryBuffer::getNewUninitMemBuffer(
+          Input.size(), B->Buffer->getBufferIdentifier());
+  if (!Image)
+    return setError(
+        createStringError(make_error_code(std::errc::not_enough_memory),
+                          "cannot allocate the image"),
+        ErrorMessage);
+  memcpy(Image->getBufferStart(), Input.data(), Input.size());
+
+  RandomizerConfig Config = B->Config;
+  Config.Metadata = B->Info.get();
+  Randomizer R(MutableArrayRef<uint8_t>(
+                   reinterpret_cast<uint8_t *>(Image->getBufferStart()),
+                   Image->getBufferSize()),
+               Config);
+  if (Error E = R.run())
+    return setError(std::move(E), ErrorMessage);
+
+  raw_fd_ostream OS(FD, /*shouldClose=*/false);
+  OS.write(Image->getBufferStart(), Image->getBufferSize());
+  OS.flush();
+  if (OS.has_error()) {
+    std::error_code EC = OS.error();
+    OS.clear_error();
+    return setError(errorCodeToError(EC), ErrorMessage);
+  }
+
+  const Layout &L = R.getLayout();
+  B->Stats = L.getStats();
+  B->GrowthBytes = L.getTotalGrowth();
+  B->TextSize = L.getEnd() - L.getBegin();
+  return 0;
+}
+
+uint64_t LLVMCCRGetStat(LLVMCCRBinaryRef Binary, LLVMCCRStat Stat) {
+  const CCRBinary *B = unwrap(Binary);
+  switch (Stat) {
+  case LLVMCCRStatUnits:
+    return B->Stats.NumUnits;
+  case LLVMCCRStatShuffledFunctions:
+    return B->Stats.NumShuffledFunctions - B->Stats.NumRestoredFunctions;
+  case LLVMCCRStatInsertedJumps:
+    return B->Stats.NumInsertedJumps;
+  case LLVMCCRStatRelaxedBranches:
+    return B->Stats.NumRelaxedBranches;
+  case LLVMCCRStatGrowthBytes:
+    return B->GrowthBytes;
+  case LLVMCCRStatSlidBasicBlocks:
+    return B->Stats.NumSlidBBLs;
+  case LLVMCCRStatTextSize:
+    return B->TextSize;
+  }
+  return 0;
+}
+
+double LLVMCCRGetEntropyBits(LLVMCCRBinaryRef Binary) {
+  return unwrap(Binary)->Stats.EntropyBits;
+}
+
+void LLVMCCRDisposeMessage(char *Message) { free(Message); }
@@ -0,0 +1,82 @@
+/*===- CCRRerand.h - Re-randomize a running process ---------------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+|*===----------------------------------------------------------------------===*|
+|*                                                                            *|
+|* Koo: A service that runs for months keeps the layout it started with. The  *|
+|* runtime of libCCRRerand.so lays out the executable of the process anew and *|
+|* swaps its code while the process runs:                                     *|
+|*                                                                            *|
+|*  - ccr_rerand_prepare() randomizes the binary (as built, with its .rand)   *|
+|*    with the load-time engine (see LoadTime.h) on a thread of its own, and  *|
+|*    copies the read-only segments that differ into fresh mappings.          *|
+|*  - ccr_rerand_commit(), at a safepoint of the application, stops the other *|
+|*    threads with a signal. Each walks its stack with the unwinder, i.e., by *|
+|*    the .eh_frame that the randomizer regenerated for the running layout,   *|
+|*    and records the return addresses into the code. The fresh mappings are *|
+|*    moved over the loaded segments (mremap(), thus the pause does not copy  *|
+|*    the text), and the return addresses, the code pointers of the writable  *|
+|*    segments (those the fixups of .rand and the dynamic relocations tell)   *|
+|*    and the signal handlers are translated into the new layout before the   *|
+|*    threads resume.                                                         *|
+|*                                                                            *|
+|* The running layout is told by the layout note (see CCRLayout.h), which the *|
+|* binary thus links libCCRLayout for, unless it runs as built; the note of   *|
+|* the new layout takes over with the code, thus the process may re-randomize *|
+|* again. The runtime is a shared library, as its code (and the unwinder's)   *|
+|* must stay in place while the code of the executable is swapped.            *|
+|*                                                                            *|
+|* A safepoint is where no thread but the caller runs the code of the         *|
+|* executable (the others wait in a library, e.g., in a system call): a       *|
+|* thread interrupted in the code, or on a frame the unwinder cannot step     *|
+|* over, has the commit cancelled, as has a thread that does not stop within  *|
+|* the pause. The code pointers out of the image (on the heap, in registers   *|
+|* or in the frames of libraries) are not found, thus the application holds   *|
+|* none across the commit.                                                    *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_CCRRERAND_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_CCRRERAND_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A new layout of the executable, being built or ready to commit */
+struct ccr_rerand;
+
+/* Start laying out the executable of this process anew by \p Seed and \p Flags
+ * (CCR_LOAD_* of LoadTime.h), from its file \p Binary and the index \p Index
+ * of its .rand section (see RandIndex.h). Never fails; the errors are told by
+ * ccr_rerand_ready(). */
+struct ccr_rerand *ccr_rerand_prepare(const char *Binary, const char *Index,
+                                      uint64_t Seed, unsigned Flags);
+
+/* 1 once the layout is ready to commit, 0 while it is being built, and -1 if
+ * it failed (the message is printed to stderr once) or has been committed */
+int ccr_rerand_ready(struct ccr_rerand *Rerand);
+
+/* Swap the code of the executable for the new layout, stopping the other
+ * threads with \p Signal (whose handler is replaced meanwhile) for up to
+ * \p MaxPauseUs microseconds to stop. Returns 0 once swapped, 1 if the layout
+ * is not ready yet or the threads are not at a safepoint (nothing changed;
+ * retry), and -1 on an error (the message is printed to stderr). The pause,
+ * in nanoseconds, is written to \p PauseNs unless it is null. */
+int ccr_rerand_commit(struct ccr_rerand *Rerand, int Signal,
+                      unsigned MaxPauseUs, uint64_t *PauseNs);
+
+/* Wait for the build, if it runs, and free the layout */
+void ccr_rerand_free(struct ccr_rerand *Rerand);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LLVM_TOOLS_LLVM_CCR_RAND_CCRRERAND_H */
@@ -0,0 +1,96 @@
+//===- CodeDecoder.h - Decode and print the x86-64 code of .text -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The MC layer objects to decode x86-64 code with, for the tooling that
+// looks at instructions rather than at the metadata (-verify, -mca-regions).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_CODEDECODER_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_CODEDECODER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCDisassembler/MCDisassembler.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstPrinter.h"
+#include "llvm/MC/MCInstrAnalysis.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+
+namespace llvm {
+namespace ccr {
+
+static const char *const TripleName = "x86_64-unknown-linux-gnu";
+
+// A disassembler keeps no state between instructions, yet every worker gets
+// its own context.
+class CodeDecoder {
+  std::unique_ptr<const MCRegisterInfo> MRI;
+  std::unique_ptr<const MCAsmInfo> MAI;
+  std::unique_ptr<const MCSubtargetInfo> STI;
+  std::unique_ptr<const MCInstrInfo> MII;
+  std::unique_ptr<const MCInstrAnalysis> MIA;
+  MCObjectFileInfo MOFI;
+  std::unique_ptr<MCContext> Ctx;
+  std::unique_ptr<MCDisassembler> DisAsm;
+  std::unique_ptr<MCInstPrinter> Printer; // AT&T, as llvm-mca reads it
+
+public:
+  bool init(const Target &T) {
+    MRI.reset(T.createMCRegInfo(TripleName));
+    if (!MRI)
+      return false;
+    MAI.reset(T.createMCAsmInfo(*MRI, TripleName));
+    STI.reset(T.createMCSubtargetInfo(TripleName, "", ""));
+    MII.reset(T.createMCInstrInfo());
+    if (!MAI || !STI || !MII)
+      return false;
+    MIA.reset(T.createMCInstrAnalysis(MII.get()));
+    Ctx = llvm::make_unique<MCContext>(MAI.get(), MRI.get(), &MOFI);
+    MOFI.InitMCObjectFileInfo(Triple(TripleName), /*PIC=*/false, *Ctx);
+    DisAsm.reset(T.createMCDisassembler(*STI, *Ctx));
+    Printer.reset(T.createMCInstPrinter(Triple(TripleName), 0, *MAI, *MII,
+                                        *MRI));
+    return DisAsm && MIA && Printer;
+  }
+
+  /// Decode the instruction at \p Addr; its size is 0 if it is invalid.
+  uint64_t decode(ArrayRef<uint8_t> Bytes, uint64_t Addr, MCInst &Inst) const {
+    uint64_t Size;
+    if (DisAsm->getInstruction(Inst, Size, Bytes, Addr, nulls(), nulls()) !=
+        MCDisassembler::Success)
+      return 0;
+    return Size;
+  }
+
+  /// The target of a direct branch or call, if \p Inst is one.
+  bool evaluateBranch(const MCInst &Inst, uint64_t Addr, uint64_t Size,
+                      uint64_t &Target) const {
+    return MIA->isBranch(Inst) || MIA->isCall(Inst)
+               ? MIA->evaluateBranch(Inst, Addr, Size, Target)
+               : false;
+  }
+
+  /// Print \p Inst as an assembly statement (with its leading tab).
+  void print(const MCInst &Inst, raw_ostream &OS) const {
+    Printer->printInst(&Inst, OS, "", *STI);
+  }
+};
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_CODEDECODER_H
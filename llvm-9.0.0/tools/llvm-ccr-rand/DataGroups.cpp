@@ -0,0 +1,204 @@
+//===- DataGroups.cpp - Affinity groups of the data objects ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DataGroups.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+namespace {
+// The sets of -data-affinity that share a group move as one
+class AffinitySets {
+  std::vector<int> Parent;
+
+public:
+  int find(int Set) {
+    if (Set >= (int)Parent.size()) {
+      size_t Old = Parent.size();
+      Parent.resize(Set + 1);
+      for (size_t I = Old; I != Parent.size(); ++I)
+        Parent[I] = I;
+    }
+    while (Parent[Set] != Set)
+      Set = Parent[Set] = Parent[Parent[Set]];
+    return Set;
+  }
+
+  void join(int A, int B) {
+    A = find(A);
+    B = find(B);
+    Parent[std::max(A, B)] = std::min(A, B);
+  }
+};
+} // end anonymous namespace
+
+void DataGroups::addSection(uint64_t Addr, uint64_t Size, uint64_t Grain,
+                            ArrayRef<uint8_t> Contents,
+                            std::vector<DataObject> Objects,
+                            ArrayRef<uint64_t> Pinned, RandomStream &RS) {
+  uint64_t End = Addr + Size;
+  llvm::erase_if(Objects, [&](const DataObject &O) {
+    return !O.Size || O.Addr < Addr || O.Addr >= End;
+  });
+  llvm::sort(Objects, [](const DataObject &A, const DataObject &B) {
+    return A.Addr < B.Addr;
+  });
+  Stats.NumSections++;
+  Stats.NumObjects += Objects.size();
+
+  // A cut is at an aligned object after a gap of zeros that no object covers;
+  // the end of the section is one likewise
+  const uint64_t GapSize = MaxTrailingBytes + 1;
+  uint64_t CoveredEnd = Addr; // Of the objects before the cut
+  auto IsCut = [&](uint64_t At) {
+    if (At % Grain || CoveredEnd + GapSize > At)
+      return false;
+    return Contents.empty() ||
+           std::all_of(Contents.begin() + (At - GapSize - Addr),
+                       Contents.begin() + (At - Addr),
+                       [](uint8_t Byte) { return Byte == 0; });
+  };
+  std::vector<uint64_t> Cuts;
+  for (size_t I = 0, E = Objects.size(); I != E;) {
+    uint64_t At = Objects[I].Addr;
+    if (IsCut(At))
+      Cuts.push_back(At);
+    for (; I != E && Objects[I].Addr == At; ++I)
+      CoveredEnd = std::max(CoveredEnd, At + Objects[I].Size);
+  }
+  if (IsCut(End))
+    Cuts.push_back(End);
+  if (Cuts.size() < 2)
+    return;
+
+  size_t First = Groups.size();
+  for (size_t I = 0, E = Cuts.size() - 1; I != E; ++I) {
+    DataGroup G;
+    G.OldAddr = G.NewAddr = Cuts[I];
+    G.Size = Cuts[I + 1] - Cuts[I];
+    Groups.push_back(G);
+  }
+  MutableArrayRef<DataGroup> Section =
+      MutableArrayRef<DataGroup>(Groups).drop_front(First);
+  auto FindGroup = [&](uint64_t At) -> DataGroup * {
+    if (At < Cuts.front() || At >= Cuts.back())
+      return nullptr;
+    return &Section[std::upper_bound(Cuts.begin(), Cuts.end(), At) -
+                    Cuts.begin() - 1];
+  };
+  for (uint64_t At : Pinned)
+    if (DataGroup *G = FindGroup(At))
+      G->Pinned = true;
+
+  AffinitySets Sets;
+  for (const DataObject &O : Objects) {
+    DataGroup *G = O.Affinity < 0 ? nullptr : FindGroup(O.Addr);
+    if (!G)
+      continue;
+    if (G->Affinity < 0)
+      G->Affinity = O.Affinity;
+    else
+      Sets.join(G->Affinity, O.Affinity);
+  }
+  for (DataGroup &G : Section)
+    if (G.Affinity >= 0)
+      G.Affinity = Sets.find(G.Affinity);
+
+  // Koo: Between two pinned groups, the groups of the affinity sets come
+  //      first (each set in its old order), then the others, each bucket in a
+  //      random order; every group is a multiple of Grain, thus so is each
+  //      new address
+  for (size_t I = 0, E = Section.size(); I != E;) {
+    if (Section[I].Pinned) {
+      Stats.NumPinnedGroups++;
+      ++I;
+      continue;
+    }
+    size_t SegmentEnd = I;
+    while (SegmentEnd != E && !Section[SegmentEnd].Pinned)
+      ++SegmentEnd;
+    std::vector<std::vector<size_t>> Hot, Cold;
+    DenseMap<int, size_t> HotUnits; // By set
+    for (size_t G = I; G != SegmentEnd; ++G) {
+      int Set = Section[G].Affinity;
+      if (Set < 0) {
+        Cold.push_back({G});
+        continue;
+      }
+      auto Ins = HotUnits.try_emplace(Set, Hot.size());
+      if (Ins.second)
+        Hot.emplace_back();
+      Hot[Ins.first->second].push_back(G);
+      Stats.NumAffinityGroups++;
+    }
+    ccr::shuffle(Hot.begin(), Hot.end(), RS);
+    ccr::shuffle(Cold.begin(), Cold.end(), RS);
+
+    uint64_t Next = Section[I].OldAddr;
+    for (const auto *Bucket : {&Hot, &Cold})
+      for (const std::vector<size_t> &Unit : *Bucket)
+        for (size_t G : Unit) {
+          Section[G].NewAddr = Next;
+          Next += Section[G].Size;
+          if (Section[G].NewAddr != Section[G].OldAddr)
+            Stats.MovedBytes += Section[G].Size;
+        }
+    I = SegmentEnd;
+  }
+  Stats.NumGroups += Section.size();
+
+  // The end of the last group, which an address short of it translates as
+  DataGroup Tail;
+  Tail.OldAddr = Tail.NewAddr = Cuts.back();
+  Tail.Pinned = true;
+  Groups.push_back(Tail);
+  std::stable_sort(Groups.begin(), Groups.end(),
+                   [](const DataGroup &A, const DataGroup &B) {
+                     return A.OldAddr < B.OldAddr;
+                   });
+}
+
+uint64_t DataGroups::translate(uint64_t Addr) const {
+  uint64_t Key = Addr > UINT64_MAX - MaxTrailingBytes ? UINT64_MAX
+                                                      : Addr + MaxTrailingBytes;
+  auto It = std::upper_bound(Groups.begin(), Groups.end(), Key,
+                             [](uint64_t A, const DataGroup &G) {
+                               return A < G.OldAddr;
+                             });
+  if (It == Groups.begin())
+    return Addr;
+  const DataGroup &G = *std::prev(It);
+  // Short of the group by MaxTrailingBytes at most (in its gap), or in it
+  if (Addr >= G.OldAddr + G.Size)
+    return Addr;
+  return Addr - G.OldAddr + G.NewAddr;
+}
+
+void DataGroups::moveContents(uint64_t Addr,
+                              MutableArrayRef<uint8_t> Contents) const {
+  uint64_t End = Addr + Contents.size();
+  uint64_t Lo = End, Hi = Addr;
+  for (const DataGroup &G : Groups)
+    if (G.OldAddr >= Addr && G.OldAddr < End && G.NewAddr != G.OldAddr) {
+      Lo = std::min(Lo, G.OldAddr);
+      Hi = std::max(Hi, G.OldAddr + G.Size);
+    }
+  if (Lo >= Hi)
+    return;
+  // The groups in place take no part, thus the others move within [Lo, Hi)
+  std::vector<uint8_t> Old(Contents.begin() + (Lo - Addr),
+                           Contents.begin() + (Hi - Addr));
+  for (const DataGroup &G : Groups)
+    if (G.OldAddr >= Lo && G.OldAddr < Hi && G.NewAddr != G.OldAddr)
+      memcpy(Contents.data() + (G.NewAddr - Addr),
+             Old.data() + (G.OldAddr - Lo), G.Size);
+}
@@ -0,0 +1,94 @@
+//===- DataGroups.h - Affinity groups of the data objects -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: With -shuffle-data, the objects of .data and .bss move as well. One
+// object at a time would spread those that shared a cache line over many,
+// thus the unit of the permutation is an affinity group: a run of whole lines
+// (of the alignment of the section, if larger) that no object straddles, in
+// which the objects that shared a line still do. The globals that a profile
+// finds accessed together (-data-affinity) take their groups along to
+// adjacent lines at the start of the section, as the hot bucket of the code.
+//
+// The objects are those of the symbol table; the bytes no symbol names move
+// with the group around them. A group begins at an object, after at least
+// MaxTrailingBytes + 1 zero bytes that no object covers: the target of a
+// .text fixup is taken as the end of the fixup, thus that of a RIP-relative
+// operand followed by an immediate falls up to MaxTrailingBytes short of it,
+// which is translated as the group that follows. An address one past the end
+// of an object stays with the object.
+//
+// All addresses are virtual addresses of the binary.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_DATAGROUPS_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_DATAGROUPS_H
+
+#include "RandomStream.h"
+#include "llvm/ADT/ArrayRef.h"
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+
+struct DataObject {
+  uint64_t Addr = 0;
+  uint64_t Size = 0;
+  int Affinity = -1; // The set of -data-affinity that names it (-1 if none)
+};
+
+struct DataGroup {
+  uint64_t OldAddr = 0;
+  uint64_t NewAddr = 0;
+  uint64_t Size = 0; // 0: the end of the groups of a section
+  int Affinity = -1; // Of the set it moves with (-1 if none)
+  bool Pinned = false;
+};
+
+struct DataGroupStats {
+  unsigned NumSections = 0;
+  unsigned NumObjects = 0;
+  unsigned NumGroups = 0;
+  unsigned NumPinnedGroups = 0;
+  unsigned NumAffinityGroups = 0; // Moved along with a set of -data-affinity
+  uint64_t MovedBytes = 0;        // Outside the groups in place
+};
+
+class DataGroups {
+  std::vector<DataGroup> Groups; // By OldAddr
+  DataGroupStats Stats;
+
+public:
+  /// The most bytes of an immediate after a RIP-relative operand (imm32).
+  static const unsigned MaxTrailingBytes = 4;
+
+  /// Cut the section of \p Size bytes at \p Addr into the groups of its
+  /// \p Objects, at addresses aligned to \p Grain, and permute them with
+  /// draws of \p RS. \p Contents holds its bytes (none for SHT_NOBITS); a
+  /// group that holds any of the addresses \p Pinned stays in place, and the
+  /// permuted groups between two pinned ones stay between them.
+  void addSection(uint64_t Addr, uint64_t Size, uint64_t Grain,
+                  ArrayRef<uint8_t> Contents, std::vector<DataObject> Objects,
+                  ArrayRef<uint64_t> Pinned, RandomStream &RS);
+
+  /// The new address of \p Addr (itself outside the groups).
+  uint64_t translate(uint64_t Addr) const;
+
+  /// Move the groups within the \p Contents of the section at \p Addr.
+  void moveContents(uint64_t Addr, MutableArrayRef<uint8_t> Contents) const;
+
+  ArrayRef<DataGroup> groups() const { return Groups; }
+  const DataGroupStats &getStats() const { return Stats; }
+  bool empty() const { return Groups.empty(); }
+};
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_DATAGROUPS_H
@@ -0,0 +1,1144 @@
+//===- DwarfRewriter.cpp - Update the DWARF of a randomized binary --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Once the layout is final, the debug information is brought in line
+// with it, one unit at a time on the thread pool:
+//
+//  - .debug_line is regenerated: every line table is decoded by
+//    DWARFDebugLine and re-encoded by MCDwarfLineAddr, its sequences split
+//    into the runs of rows that moved alike. The header is copied verbatim.
+//  - .debug_ranges is regenerated, every list split per moved run in the same
+//    way, and .debug_aranges is rebuilt from the new ranges of the units.
+//  - .debug_info and .debug_abbrev are patched in place: addresses are
+//    translated, and a DW_AT_low_pc/DW_AT_high_pc pair whose code no longer
+//    is contiguous becomes a DW_AT_ranges of the same size, by rewriting its
+//    abbreviation (the bytes left over hold a DW_AT_description string).
+//  - The .dwo (or .dwp) of a split unit (-gsplit-dwarf) is left alone: it
+//    refers to the code by indices into .debug_addr, whose entries are
+//    translated in place, and by range lists relative to the
+//    DW_AT_GNU_ranges_base of its skeleton, which are moved along with the
+//    new lists of the skeleton and translated in place. Only the skeleton,
+//    .debug_addr and the line table are touched, thus a function of a .dwo
+//    whose code moved apart keeps its first piece.
+//
+// The regenerated sections are appended to the file; the old contents remain
+// as unreferenced bytes. Sections compressed by -gz are updated decompressed
+// and appended recompressed, in pieces on the thread pool. Location lists
+// (.debug_loc) are not updated, nor are the units of DWARF 5 (only their line
+// tables are).
+//
+//===----------------------------------------------------------------------===//
+
+#include "Randomizer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugLine.h"
+#include "llvm/DebugInfo/DWARF/DWARFDie.h"
+#include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCDwarf.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/Object/Decompressor.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/Compression.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::support;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+static const char *const TripleName = "x86_64-unknown-linux-gnu";
+
+namespace {
+using AddressRange = std::pair<uint64_t, uint64_t>; // [Begin, End)
+
+// Old addresses [Addr, End) all moved by Delta
+struct Run {
+  int64_t Delta;
+  uint64_t End;
+};
+
+class AddressTranslator {
+  std::vector<object::RandAddressRange> Ranges; // Ascending old addresses
+  uint64_t Begin, End; // The randomizable range of .text
+
+public:
+  AddressTranslator(std::vector<object::RandAddressRange> R, uint64_t Begin,
+                    uint64_t End)
+      : Ranges(std::move(R)), Begin(Begin), End(End) {
+    llvm::sort(Ranges,
+               [](const object::RandAddressRange &A,
+                  const object::RandAddressRange &B) {
+                 return A.OldAddr < B.OldAddr;
+               });
+  }
+
+  /// The run that starts at \p Addr. The bytes up to the next range (the
+  /// padding dropped by re-aligning) move along with the range before them.
+  Run getRun(uint64_t Addr) const {
+    if (Addr < Begin)
+      return {0, Begin};
+    if (Addr >= End)
+      return {0, UINT64_MAX};
+    auto It = std::upper_bound(
+        Ranges.begin(), Ranges.end(), Addr,
+        [](uint64_t A, const object::RandAddressRange &R) {
+          return A < R.OldAddr;
+        });
+    uint64_t RunEnd = It == Ranges.end() ? End : It->OldAddr;
+    if (It == Ranges.begin())
+      return {0, RunEnd};
+    const object::RandAddressRange &R = *std::prev(It);
+    return {int64_t(R.NewAddr - R.OldAddr), RunEnd};
+  }
+
+  uint64_t translate(uint64_t Addr) const { return Addr + getRun(Addr).Delta; }
+
+  /// Append the new pieces of the old [Lo, Hi), the piece of Lo first.
+  void translate(uint64_t Lo, uint64_t Hi,
+                 SmallVectorImpl<AddressRange> &Out) const {
+    while (Lo < Hi) {
+      Run R = getRun(Lo);
+      uint64_t E = std::min(Hi, R.End);
+      if (!Out.empty() && Out.back().second == Lo + R.Delta)
+        Out.back().second = E + R.Delta;
+      else
+        Out.push_back({Lo + R.Delta, E + R.Delta});
+      Lo = E;
+    }
+  }
+};
+
+// An in-place update of .debug_info
+struct Patch {
+  uint32_t Offset;
+  uint8_t Size;
+  bool IsRangesOffset; // Value is an offset into the unit's new lists
+  uint64_t Value;
+};
+
+// A DIE with DW_AT_low_pc and DW_AT_high_pc, waiting for the decision on its
+// abbreviation
+struct PCRange {
+  uint32_t LowOffset, HighOffset; // Of the attribute values
+  uint8_t LowSize, HighSize;
+  uint64_t AbbrevKey;
+  SmallVector<AddressRange, 1> NewRanges;
+  uint64_t Length; // Hi - Lo
+  bool IsUnit;     // The base address of the unit
+};
+
+struct UnitWork {
+  DWARFUnit *U = nullptr;
+  bool Unsupported = false; // DWARF 5: only its line table is rewritten
+  std::vector<Patch> Patches;
+  std::vector<PCRange> PCRanges;
+  std::vector<uint8_t> Lists; // This unit's part of the new .debug_ranges
+  std::vector<AddressRange> UnitRanges; // For .debug_aranges
+  Optional<uint32_t> StmtListOffset; // Of the DW_AT_stmt_list value
+  uint32_t LineTableOffset = 0;
+  uint64_t ListsBase = 0;
+  // A skeleton unit: the part of the old .debug_ranges from its
+  // DW_AT_GNU_ranges_base on, which goes first in Lists, and the base address
+  // of its lists (DW_AT_low_pc) before and after
+  Optional<uint32_t> RangesBaseOffset; // Of the DW_AT_GNU_ranges_base value
+  Optional<uint64_t> DWORangesBase;
+  uint64_t DWOListsSize = 0;
+  uint64_t OldBaseAddress = 0, NewBaseAddress = 0;
+  std::string Error;
+};
+
+// How a DW_AT_low_pc/DW_AT_high_pc abbreviation becomes DW_AT_ranges
+struct AbbrevConversion {
+  uint64_t SetOffset = 0;
+  uint32_t Code = 0;
+  unsigned LowIdx = 0, HighIdx = 0; // Indices of the attribute specs
+  dwarf::Form LowForm = dwarf::Form(0), HighForm = dwarf::Form(0);
+  bool NeedsRanges = false; // Some DIE no longer is contiguous
+  bool Converted = false;
+};
+
+struct DwarfStats {
+  std::atomic<unsigned> LineTables{0}, OldSequences{0}, NewSequences{0};
+  std::atomic<unsigned> Lists{0}, Converted{0}, Unfixable{0}, Unsupported{0};
+  std::atomic<unsigned> SplitUnits{0}, AddrEntries{0};
+};
+
+uint64_t getAbbrevKey(uint64_t SetOffset, uint32_t Code) {
+  return (SetOffset << 24) | Code;
+}
+} // end anonymous namespace
+
+static void appendRangeList(ArrayRef<AddressRange> Ranges,
+                            std::vector<uint8_t> &Out) {
+  // A base address selection entry frees the list from the base address of
+  // its unit, which a converted DW_AT_low_pc no longer provides
+  auto Append = [&](uint64_t V) {
+    uint8_t Bytes[8];
+    endian::write64le(Bytes, V);
+    Out.insert(Out.end(), Bytes, Bytes + 8);
+  };
+  Append(UINT64_MAX);
+  Append(0);
+  for (const AddressRange &R : Ranges)
+    if (R.first < R.second) {
+      Append(R.first);
+      Append(R.second);
+    }
+  Append(0);
+  Append(0);
+}
+
+// Collect what a unit needs: the translated addresses, the new range lists
+// and the low/high pairs whose abbreviation may have to change
+static void scanUnit(UnitWork &W, const AddressTranslator &T,
+                     DwarfStats &Stats) {
+  DWARFUnit &U = *W.U;
+  if (U.getVersion() >= 5 || U.getAddressByteSize() != 8) {
+    W.Unsupported = true;
+    Stats.Unsupported++;
+  }
+
+  uint32_t UnitDieOffset = U.getUnitDIE().getOffset();
+  for (const DWARFDebugInfoEntry &Entry : U.dies()) {
+    DWARFDie Die(&U, &Entry);
+    const DWARFAbbreviationDeclaration *Abbrev =
+        Die.getAbbreviationDeclarationPtr();
+    if (!Abbrev)
+      continue;
+    bool IsUnit = Die.getOffset() == UnitDieOffset;
+
+    Optional<DWARFAttribute> Low, High, Ranges;
+    for (const DWARFAttribute &Attr : Die.attributes()) {
+      switch (Attr.Attr) {
+      case dwarf::DW_AT_stmt_list:
+        if (IsUnit && Attr.ByteSize == 4)
+          if (Optional<uint64_t> Off = Attr.Value.getAsSectionOffset()) {
+            W.StmtListOffset = Attr.Offset;
+            W.LineTableOffset = *Off;
+          }
+        break;
+      case dwarf::DW_AT_low_pc:
+        Low = Attr;
+        break;
+      case dwarf::DW_AT_high_pc:
+        High = Attr;
+        break;
+      case dwarf::DW_AT_ranges:
+        Ranges = Attr;
+        break;
+      case dwarf::DW_AT_GNU_ranges_base:
+        if (IsUnit && Attr.ByteSize == 4 && W.DWOListsSize)
+          W.RangesBaseOffset = Attr.Offset;
+        break;
+      case dwarf::DW_AT_entry_pc:
+      case dwarf::DW_AT_call_return_pc:
+      case dwarf::DW_AT_call_pc:
+        if (!W.Unsupported && Attr.Value.getForm() == dwarf::DW_FORM_addr)
+          if (Optional<uint64_t> Addr = Attr.Value.getAsAddress())
+            W.Patches.push_back(
+                {Attr.Offset, 8, false, T.translate(*Addr)});
+        break;
+      default:
+        break;
+      }
+    }
+
+    if (Ranges || (Low && High)) {
+      Expected<DWARFAddressRangesVector> Old = Die.getAddressRanges();
+      if (!Old) {
+        W.Error = toString(Old.takeError());
+        return;
+      }
+      SmallVector<AddressRange, 4> New;
+      for (const DWARFAddressRange &R : *Old)
+        T.translate(R.LowPC, R.HighPC, New);
+      if (IsUnit)
+        W.UnitRanges.assign(New.begin(), New.end());
+      if (W.Unsupported)
+        continue;
+
+      if (Ranges) {
+        if (Ranges->ByteSize != 4 && Ranges->ByteSize != 8)
+          continue;
+        W.Patches.push_back({Ranges->Offset, uint8_t(Ranges->ByteSize), true,
+                             W.Lists.size()});
+        appendRangeList(New, W.Lists);
+        Stats.Lists++;
+        // The base address of the unit stays where it was
+        if (Low && Low->Value.getForm() == dwarf::DW_FORM_addr)
+          if (Optional<uint64_t> Addr = Low->Value.getAsAddress()) {
+            if (!IsUnit)
+              W.Patches.push_back({Low->Offset, 8, false, T.translate(*Addr)});
+            else
+              W.OldBaseAddress = W.NewBaseAddress = *Addr;
+          }
+        continue;
+      }
+
+      Optional<uint64_t> Lo = Low->Value.getAsAddress();
+      if (Low->Value.getForm() != dwarf::DW_FORM_addr || !Lo)
+        continue;
+      if (IsUnit)
+        W.OldBaseAddress = W.NewBaseAddress = *Lo; // Until finishUnit()
+      PCRange PC;
+      PC.LowOffset = Low->Offset;
+      PC.HighOffset = High->Offset;
+      PC.LowSize = Low->ByteSize;
+      PC.HighSize = High->ByteSize;
+      PC.AbbrevKey =
+          getAbbrevKey(U.getAbbreviations()->getOffset(), Abbrev->getCode());
+      PC.NewRanges.assign(New.begin(), New.end());
+      PC.Length = (*Old).empty() ? 0 : (*Old)[0].HighPC - (*Old)[0].LowPC;
+      PC.IsUnit = IsUnit;
+      W.PCRanges.push_back(std::move(PC));
+      continue;
+    }
+
+    // A label, or the base address of a unit with DW_AT_ranges
+    if (Low && !W.Unsupported && Low->Value.getForm() == dwarf::DW_FORM_addr)
+      if (Optional<uint64_t> Addr = Low->Value.getAsAddress()) {
+        if (IsUnit) {
+          W.OldBaseAddress = *Addr;
+          W.NewBaseAddress = T.translate(*Addr);
+        }
+        W.Patches.push_back({Low->Offset, 8, false, T.translate(*Addr)});
+      }
+  }
+}
+
+// Record the abbreviations with a low/high pair; done serially, as the
+// abbreviations of a unit would otherwise be looked up concurrently
+static void collectAbbrevs(DWARFUnit &U,
+                           DenseMap<uint64_t, AbbrevConversion> &Abbrevs) {
+  const DWARFAbbreviationDeclarationSet *Set = U.getAbbreviations();
+  if (!Set)
+    return;
+  uint64_t SetOffset = Set->getOffset();
+  for (const DWARFAbbreviationDeclaration &Decl : *Set) {
+    uint64_t Key = getAbbrevKey(SetOffset, Decl.getCode());
+    if (Abbrevs.count(Key))
+      continue;
+    AbbrevConversion C;
+    C.SetOffset = SetOffset;
+    C.Code = Decl.getCode();
+    bool HasLow = false, HasHigh = false;
+    unsigned Idx = 0;
+    for (const auto &Spec : Decl.attributes()) {
+      if (Spec.Attr == dwarf::DW_AT_low_pc) {
+        HasLow = true;
+        C.LowIdx = Idx;
+        C.LowForm = Spec.Form;
+      } else if (Spec.Attr == dwarf::DW_AT_high_pc) {
+        HasHigh = true;
+        C.HighIdx = Idx;
+        C.HighForm = Spec.Form;
+      }
+      ++Idx;
+    }
+    if (HasLow && HasHigh && C.LowForm == dwarf::DW_FORM_addr)
+      Abbrevs[Key] = C;
+  }
+}
+
+// Return the offsets of the attribute specs of abbreviation Code in the set
+// at SetOffset of .debug_abbrev
+static bool findAttributeSpecs(ArrayRef<uint8_t> Abbrev, uint64_t SetOffset,
+                               uint32_t Code,
+                               SmallVectorImpl<uint64_t> &SpecOffsets) {
+  const uint8_t *P = Abbrev.data() + SetOffset, *End = Abbrev.end();
+  auto ReadULEB = [&](uint64_t &V) {
+    unsigned N = 0;
+    const char *Err = nullptr;
+    V = decodeULEB128(P, &N, End, &Err);
+    P += N;
+    return !Err;
+  };
+  while (P < End) {
+    uint64_t DeclCode, Tag, Attr, Form;
+    if (!ReadULEB(DeclCode) || !DeclCode)
+      return false;
+    if (!ReadULEB(Tag) || P >= End)
+      return false;
+    ++P; // DW_CHILDREN_*
+    SpecOffsets.clear();
+    for (;;) {
+      uint64_t SpecOffset = P - Abbrev.data();
+      if (!ReadULEB(Attr) || !ReadULEB(Form))
+        return false;
+      if (!Attr && !Form)
+        break;
+      SpecOffsets.push_back(SpecOffset);
+      if (Form == dwarf::DW_FORM_implicit_const) {
+        unsigned N = 0;
+        const char *Err = nullptr;
+        decodeSLEB128(P, &N, End, &Err);
+        if (Err)
+          return false;
+        P += N;
+      }
+    }
+    if (DeclCode == Code)
+      return true;
+  }
+  return false;
+}
+
+// Whether the low/high pair of C can become DW_AT_ranges in place: the pair
+// is adjacent (the ranges offset then the filler string), or the high_pc is
+// 4 bytes (replaced by the offset, the low_pc by the filler)
+static bool canConvert(const AbbrevConversion &C) {
+  if (C.HighIdx == C.LowIdx + 1 || C.LowIdx == C.HighIdx + 1)
+    return true;
+  return C.HighForm == dwarf::DW_FORM_data4;
+}
+
+static void writeFiller(uint8_t *P, size_t Size) {
+  // A string filling Size bytes, NUL included
+  memset(P, '.', Size - 1);
+  memcpy(P, "ccr", std::min<size_t>(3, Size - 1));
+  P[Size - 1] = '\0';
+}
+
+// Translate the range lists of a .dwo in place, from the old base address of
+// its skeleton to the new one. An entry keeps its size, thus a range whose
+// code moved apart keeps its first piece.
+static void translateDWOLists(MutableArrayRef<uint8_t> Lists, uint64_t OldBase,
+                              uint64_t NewBase, const AddressTranslator &T,
+                              DwarfStats &Stats) {
+  uint64_t Old = OldBase, New = NewBase;
+  SmallVector<AddressRange, 4> Pieces;
+  for (size_t I = 0; I + 16 <= Lists.size(); I += 16) {
+    uint8_t *P = Lists.data() + I;
+    uint64_t Begin = endian::read64le(P), End = endian::read64le(P + 8);
+    if (Begin == 0 && End == 0) {
+      Old = OldBase;
+      New = NewBase;
+      continue;
+    }
+    if (Begin == UINT64_MAX) {
+      Old = End;
+      New = T.translate(End);
+      endian::write64le(P + 8, New);
+      continue;
+    }
+    if (End < Begin)
+      continue;
+    Pieces.clear();
+    T.translate(Old + Begin, Old + End, Pieces);
+    if (Pieces.size() > 1)
+      Stats.Unfixable++;
+    uint64_t NewBegin = (Pieces.empty() ? T.translate(Old + Begin)
+                                        : Pieces[0].first) - New;
+    // Neither may the entry read as the end of the list
+    if (NewBegin == 0 && End == Begin)
+      continue;
+    endian::write64le(P, NewBegin);
+    endian::write64le(P + 8, NewBegin + (End - Begin));
+  }
+}
+
+// Turn the low/high pair into a range list of its new pieces (or translate it
+// as a whole if its abbreviation is kept)
+static void finishUnit(UnitWork &W, const AddressTranslator &T,
+                       const DenseMap<uint64_t, AbbrevConversion> &Abbrevs,
+                       uint8_t *Info, DwarfStats &Stats) {
+  for (const PCRange &PC : W.PCRanges) {
+    auto It = Abbrevs.find(PC.AbbrevKey);
+    if (It == Abbrevs.end() || !It->second.Converted) {
+      if (PC.NewRanges.size() > 1)
+        Stats.Unfixable++;
+      if (PC.NewRanges.empty())
+        continue;
+      uint64_t Lo = PC.NewRanges[0].first;
+      if (PC.IsUnit)
+        W.NewBaseAddress = Lo;
+      W.Patches.push_back({PC.LowOffset, 8, false, Lo});
+      if (PC.HighSize == 8 && It != Abbrevs.end() &&
+          It->second.HighForm == dwarf::DW_FORM_addr)
+        W.Patches.push_back({PC.HighOffset, 8, false, Lo + PC.Length});
+      continue;
+    }
+
+    // The lists of a unit without DW_AT_low_pc have no base address
+    if (PC.IsUnit)
+      W.NewBaseAddress = 0;
+    const AbbrevConversion &C = It->second;
+    uint32_t ListOffset = W.Lists.size();
+    appendRangeList(PC.NewRanges, W.Lists);
+    Stats.Converted++;
+    if (C.HighIdx == C.LowIdx + 1 || C.LowIdx == C.HighIdx + 1) {
+      uint32_t First = std::min(PC.LowOffset, PC.HighOffset);
+      uint32_t Size = PC.LowSize + PC.HighSize;
+      W.Patches.push_back({First, 4, true, ListOffset});
+      writeFiller(Info + First + 4, Size - 4);
+    } else {
+      W.Patches.push_back({PC.HighOffset, 4, true, ListOffset});
+      writeFiller(Info + PC.LowOffset, PC.LowSize);
+    }
+  }
+
+  // The lists of the .dwo move to the start of the new lists of the skeleton
+  if (W.RangesBaseOffset) {
+    translateDWOLists(makeMutableArrayRef(W.Lists.data(), W.DWOListsSize),
+                      W.OldBaseAddress, W.NewBaseAddress, T, Stats);
+    W.Patches.push_back({*W.RangesBaseOffset, 4, true, 0});
+  }
+}
+
+namespace {
+// A run of rows that moved alike, i.e., a sequence of the new table
+struct NewSequence {
+  uint64_t Begin = 0, End = 0;
+  struct Entry {
+    uint64_t Addr;
+    unsigned Row;
+    bool Split; // Not the first piece of its row
+  };
+  std::vector<Entry> Rows;
+};
+} // end anonymous namespace
+
+// Re-encode a line table for the new layout; Header is the verbatim header
+// after the unit length
+static void encodeLineTable(const DWARFDebugLine::LineTable &LT,
+                            ArrayRef<uint8_t> Header,
+                            const AddressTranslator &T, MCContext &Ctx,
+                            std::vector<uint8_t> &Out, DwarfStats &Stats) {
+  const DWARFDebugLine::Prologue &P = LT.Prologue;
+  std::vector<NewSequence> Seqs;
+  for (const DWARFDebugLine::Sequence &S : LT.Sequences) {
+    if (!S.isValid())
+      continue;
+    Stats.OldSequences++;
+    size_t Cur = SIZE_MAX;
+    for (unsigned I = S.FirstRowIndex; I + 1 < S.LastRowIndex; ++I) {
+      uint64_t A = LT.Rows[I].Address.Address;
+      uint64_t B = std::max(A, LT.Rows[I + 1].Address.Address);
+      bool Split = false;
+      do {
+        Run R = T.getRun(A);
+        uint64_t E = std::min(B, R.End);
+        uint64_t NewA = A + R.Delta;
+        if (Cur == SIZE_MAX || Seqs[Cur].End != NewA) {
+          Cur = Seqs.size();
+          Seqs.emplace_back();
+          Seqs[Cur].Begin = NewA;
+        }
+        Seqs[Cur].Rows.push_back({NewA, I, Split});
+        Seqs[Cur].End = E + R.Delta;
+        Split = true;
+        A = E;
+      } while (A < B);
+    }
+  }
+  Stats.NewSequences += Seqs.size();
+
+  SmallString<0> Program;
+  raw_svector_ostream OS(Program);
+  MCDwarfLineTableParams Params;
+  Params.DWARF2LineOpcodeBase = P.OpcodeBase;
+  Params.DWARF2LineBase = P.LineBase;
+  Params.DWARF2LineRange = P.LineRange;
+  auto HasOpcode = [&](unsigned Op) { return Op < P.OpcodeBase; };
+
+  for (const NewSequence &S : Seqs) {
+    OS << char(dwarf::DW_LNS_extended_op);
+    encodeULEB128(9, OS);
+    OS << char(dwarf::DW_LNE_set_address);
+    char Addr[8];
+    endian::write64le(Addr, S.Begin);
+    OS.write(Addr, 8);
+
+    uint64_t PrevAddr = S.Begin;
+    int64_t Line = 1;
+    unsigned File = 1, Column = 0, Isa = 0;
+    bool IsStmt = P.DefaultIsStmt;
+    for (const NewSequence::Entry &E : S.Rows) {
+      const DWARFDebugLine::Row &R = LT.Rows[E.Row];
+      if (R.File != File) {
+        OS << char(dwarf::DW_LNS_set_file);
+        encodeULEB128(R.File, OS);
+        File = R.File;
+      }
+      if (R.Column != Column) {
+        OS << char(dwarf::DW_LNS_set_column);
+        encodeULEB128(R.Column, OS);
+        Column = R.Column;
+      }
+      if (R.IsStmt != IsStmt) {
+        OS << char(dwarf::DW_LNS_negate_stmt);
+        IsStmt = R.IsStmt;
+      }
+      if (R.Isa != Isa && HasOpcode(dwarf::DW_LNS_set_isa)) {
+        OS << char(dwarf::DW_LNS_set_isa);
+        encodeULEB128(R.Isa, OS);
+        Isa = R.Isa;
+      }
+      if (R.Discriminator) {
+        OS << char(dwarf::DW_LNS_extended_op);
+        encodeULEB128(1 + getULEB128Size(R.Discriminator), OS);
+        OS << char(dwarf::DW_LNE_set_discriminator);
+        encodeULEB128(R.Discriminator, OS);
+      }
+      if (!E.Split) {
+        if (R.BasicBlock)
+          OS << char(dwarf::DW_LNS_set_basic_block);
+        if (R.PrologueEnd && HasOpcode(dwarf::DW_LNS_set_prologue_end))
+          OS << char(dwarf::DW_LNS_set_prologue_end);
+        if (R.EpilogueBegin && HasOpcode(dwarf::DW_LNS_set_epilogue_begin))
+          OS << char(dwarf::DW_LNS_set_epilogue_begin);
+      }
+      MCDwarfLineAddr::Encode(Ctx, Params, int64_t(R.Line) - Line,
+                              E.Addr - PrevAddr, OS);
+      Line = R.Line;
+      PrevAddr = E.Addr;
+    }
+    MCDwarfLineAddr::Encode(Ctx, Params, INT64_MAX, S.End - PrevAddr, OS);
+  }
+
+  uint8_t Length[4];
+  endian::write32le(Length, Header.size() + Program.size());
+  Out.insert(Out.end(), Length, Length + 4);
+  Out.insert(Out.end(), Header.begin(), Header.end());
+  Out.insert(Out.end(), Program.begin(), Program.end());
+}
+
+// .debug_aranges, one set per unit with the (sorted) new ranges
+static std::vector<uint8_t> buildAranges(ArrayRef<UnitWork> Units) {
+  std::vector<uint8_t> Out;
+  auto Append = [&](uint64_t V, unsigned Size) {
+    uint8_t Bytes[8];
+    if (Size == 8)
+      endian::write64le(Bytes, V);
+    else if (Size == 4)
+      endian::write32le(Bytes, V);
+    else
+      endian::write16le(Bytes, V);
+    Out.insert(Out.end(), Bytes, Bytes + Size);
+  };
+  for (const UnitWork &W : Units) {
+    if (W.UnitRanges.empty())
+      continue;
+    std::vector<AddressRange> Ranges = W.UnitRanges;
+    llvm::sort(Ranges);
+    // Header (12 bytes) padded to twice the address size, the tuples and
+    // the terminating (0, 0)
+    Append(4 + 16 * (Ranges.size() + 1), 4);
+    Append(2, 2);
+    Append(W.U->getOffset(), 4);
+    Out.push_back(8);
+    Out.push_back(0);
+    Append(0, 4);
+    for (const AddressRange &R : Ranges) {
+      Append(R.first, 8);
+      Append(R.second - R.first, 8);
+    }
+    Append(0, 8);
+    Append(0, 8);
+  }
+  return Out;
+}
+
+Error Randomizer::rewriteDebugInfo(std::vector<NewSection> &Out) {
+  TimeTraceScope Scope("DWARF", [&] {
+    uint64_t Bytes = 0;
+    for (const Section &Sec : Sections)
+      if (StringRef(Sec.Name).startswith(".debug_"))
+        Bytes += Sec.Size;
+    return std::to_string(Bytes) + " bytes";
+  });
+  const Section *DebugInfo = findSection(".debug_info");
+  const Section *DebugAbbrev = findSection(".debug_abbrev");
+  const Section *DebugLine = findSection(".debug_line");
+  if (!DebugInfo || !DebugAbbrev)
+    return Error::success();
+
+  // Sections compressed by -gz are patched in decompressed copies, which are
+  // appended (recompressed) with the regenerated ones
+  std::vector<uint8_t> InfoCopy, AbbrevCopy;
+  auto Decompress = [&](const Section &Sec,
+                        std::vector<uint8_t> &Copy) -> Expected<uint8_t *> {
+    if (!(Sec.Flags & ELF::SHF_COMPRESSED))
+      return getContents(Sec);
+    Expected<object::Decompressor> D = object::Decompressor::create(
+        Sec.Name, toStringRef(makeArrayRef(getContents(Sec), Sec.Size)),
+        /*IsLE=*/true, /*Is64Bit=*/true);
+    if (!D)
+      return makeError("Compressed DWARF (" + Sec.Name +
+                       ") cannot be updated: " + toString(D.takeError()));
+    Copy.resize(D->getDecompressedSize());
+    if (Error E = D->decompress(makeMutableArrayRef(
+            reinterpret_cast<char *>(Copy.data()), Copy.size())))
+      return std::move(E);
+    return Copy.data();
+  };
+  Expected<uint8_t *> InfoOrErr = Decompress(*DebugInfo, InfoCopy);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  Expected<uint8_t *> AbbrevOrErr = Decompress(*DebugAbbrev, AbbrevCopy);
+  if (!AbbrevOrErr)
+    return AbbrevOrErr.takeError();
+  uint8_t *Info = *InfoOrErr, *AbbrevContents = *AbbrevOrErr;
+  size_t AbbrevSize = DebugAbbrev->Flags & ELF::SHF_COMPRESSED
+                          ? AbbrevCopy.size()
+                          : DebugAbbrev->Size;
+
+  Expected<object::ELF64LEObjectFile> ObjOrErr =
+      object::ELF64LEObjectFile::create(
+          MemoryBufferRef(toStringRef(Image), "image"));
+  if (!ObjOrErr)
+    return ObjOrErr.takeError();
+  std::unique_ptr<DWARFContext> DCtx = DWARFContext::create(*ObjOrErr);
+
+  // The line tables are encoded through an MC context (for the minimum
+  // instruction length of the target)
+  std::string Err;
+  const Target *TheTarget = TargetRegistry::lookupTarget(TripleName, Err);
+  if (!TheTarget)
+    return makeError(Err);
+  std::unique_ptr<const MCRegisterInfo> MRI(
+      TheTarget->createMCRegInfo(TripleName));
+  std::unique_ptr<const MCAsmInfo> MAI(
+      MRI ? TheTarget->createMCAsmInfo(*MRI, TripleName) : nullptr);
+  if (!MAI)
+    return makeError("No MC layer for " + Twine(TripleName));
+  MCObjectFileInfo MOFI;
+  MCContext MCCtx(MAI.get(), MRI.get(), &MOFI);
+
+  AddressTranslator T(getAddressRanges(), Text->Addr + L->getBegin(),
+                      Text->Addr + L->getEnd());
+  DwarfStats Stats;
+
+  // Everything the units share is parsed up front; the units are then
+  // processed concurrently
+  std::vector<UnitWork> Units;
+  DenseMap<uint64_t, AbbrevConversion> Abbrevs;
+  for (const auto &U : DCtx->compile_units()) {
+    if (U->getFormParams().Format != dwarf::DWARF32)
+      return makeError("DWARF64 is not supported");
+    collectAbbrevs(*U, Abbrevs);
+    UnitWork W;
+    W.U = U.get();
+    Units.push_back(std::move(W));
+  }
+
+  // The split units (-gsplit-dwarf) share .debug_addr and .debug_ranges with
+  // their .dwo. The part of .debug_ranges of a skeleton runs up to the next
+  // DW_AT_GNU_ranges_base; so does its part of .debug_addr (DWARF 4), unless
+  // the part has a header of its own (DWARF 5).
+  StringRef OldRanges = DCtx->getDWARFObj().getRangeSection().Data;
+  std::vector<uint64_t> RangesBases;
+  std::vector<std::pair<uint64_t, bool>> AddrBases; // And whether DWARF 5
+  for (UnitWork &W : Units) {
+    DWARFDie Die = W.U->getUnitDIE();
+    if (!Die || !W.U->getDWOId())
+      continue;
+    Stats.SplitUnits++;
+    if (Optional<uint64_t> Base = dwarf::toSectionOffset(
+            Die.find({dwarf::DW_AT_addr_base, dwarf::DW_AT_GNU_addr_base})))
+      AddrBases.push_back({*Base, W.U->getVersion() >= 5});
+    if (W.U->getVersion() >= 5)
+      continue;
+    if (Optional<uint64_t> Base =
+            dwarf::toSectionOffset(Die.find(dwarf::DW_AT_GNU_ranges_base)))
+      if (*Base < OldRanges.size()) {
+        W.DWORangesBase = *Base;
+        RangesBases.push_back(*Base);
+      }
+  }
+  llvm::sort(RangesBases);
+  for (UnitWork &W : Units) {
+    if (!W.DWORangesBase)
+      continue;
+    uint64_t Begin = *W.DWORangesBase;
+    auto Next = std::upper_bound(RangesBases.begin(), RangesBases.end(), Begin);
+    uint64_t End = Next == RangesBases.end() ? OldRanges.size() : *Next;
+    W.DWOListsSize = alignDown(End - Begin, 16);
+    W.Lists.assign(OldRanges.begin() + Begin,
+                   OldRanges.begin() + Begin + W.DWOListsSize);
+  }
+
+  auto ForEachUnit = [&](function_ref<void(UnitWork &)> Fn) {
+    if (Config.Parallel)
+      parallel::for_each(parallel::par, Units.begin(), Units.end(),
+                         [&](UnitWork &W) { Fn(W); });
+    else
+      for (UnitWork &W : Units)
+        Fn(W);
+  };
+  ForEachUnit([&](UnitWork &W) { scanUnit(W, T, Stats); });
+  for (const UnitWork &W : Units)
+    if (!W.Error.empty())
+      return makeError("Unit at " + Twine(W.U->getOffset()) + ": " + W.Error);
+
+  // An abbreviation changes for all of its DIEs, thus only if one of them
+  // moved apart
+  for (const UnitWork &W : Units)
+    for (const PCRange &PC : W.PCRanges)
+      if (PC.NewRanges.size() > 1)
+        Abbrevs[PC.AbbrevKey].NeedsRanges = true;
+  ArrayRef<uint8_t> AbbrevData(AbbrevContents, AbbrevSize);
+  std::vector<std::pair<uint64_t, uint8_t>> AbbrevPatches;
+  for (auto &Entry : Abbrevs) {
+    AbbrevConversion &C = Entry.second;
+    SmallVector<uint64_t, 8> Specs;
+    if (!C.NeedsRanges || !canConvert(C) ||
+        !findAttributeSpecs(AbbrevData, C.SetOffset, C.Code, Specs) ||
+        std::max(C.LowIdx, C.HighIdx) >= Specs.size())
+      continue;
+    // Every attribute and form here is encoded in a single byte
+    uint64_t LowSpec = Specs[C.LowIdx], HighSpec = Specs[C.HighIdx];
+    if (AbbrevData[LowSpec] != dwarf::DW_AT_low_pc ||
+        AbbrevData[LowSpec + 1] != C.LowForm ||
+        AbbrevData[HighSpec] != dwarf::DW_AT_high_pc ||
+        AbbrevData[HighSpec + 1] != C.HighForm || C.HighForm >= 0x80)
+      continue;
+    uint64_t RangesSpec, FillerSpec;
+    if (C.HighIdx == C.LowIdx + 1 || C.LowIdx == C.HighIdx + 1) {
+      RangesSpec = std::min(LowSpec, HighSpec);
+      FillerSpec = std::max(LowSpec, HighSpec);
+    } else {
+      RangesSpec = HighSpec;
+      FillerSpec = LowSpec;
+    }
+    AbbrevPatches.push_back({RangesSpec, dwarf::DW_AT_ranges});
+    AbbrevPatches.push_back({RangesSpec + 1, dwarf::DW_FORM_sec_offset});
+    AbbrevPatches.push_back({FillerSpec, dwarf::DW_AT_description});
+    AbbrevPatches.push_back({FillerSpec + 1, dwarf::DW_FORM_string});
+    C.Converted = true;
+  }
+
+  // The line tables, each once even if units share it
+  std::vector<uint32_t> TableOffsets;
+  for (const UnitWork &W : Units)
+    if (W.StmtListOffset)
+      TableOffsets.push_back(W.LineTableOffset);
+  llvm::sort(TableOffsets);
+  TableOffsets.erase(std::unique(TableOffsets.begin(), TableOffsets.end()),
+                     TableOffsets.end());
+  std::vector<std::vector<uint8_t>> Tables(TableOffsets.size());
+  DenseMap<uint32_t, DWARFUnit *> TableUnits;
+  for (const UnitWork &W : Units)
+    if (W.StmtListOffset)
+      TableUnits.insert({W.LineTableOffset, W.U});
+  auto RewriteTable = [&](size_t I) {
+    uint32_t Offset = TableOffsets[I];
+    DWARFUnit *U = TableUnits.lookup(Offset);
+    DWARFDataExtractor Data(DCtx->getDWARFObj(), U->getLineSection(),
+                            /*IsLittleEndian=*/true, U->getAddressByteSize());
+    DWARFDebugLine::LineTable LT;
+    uint32_t End = Offset;
+    Error E = LT.parse(Data, &End, *DCtx, U, consumeError);
+    StringRef Old = Data.getData();
+    if (E || LT.Prologue.MinInstLength != 1 || LT.Prologue.isDWARF64()) {
+      // Kept as it is: still right for the code that did not move
+      consumeError(std::move(E));
+      uint64_t Length = Offset + 4 <= Old.size()
+                            ? 4 + endian::read32le(Old.data() + Offset)
+                            : 0;
+      Length = std::min<uint64_t>(Length, Old.size() - Offset);
+      Tables[I].assign(Old.begin() + Offset, Old.begin() + Offset + Length);
+      return;
+    }
+    uint64_t ProgramOffset = Offset + 4 + 2 +
+                             (LT.Prologue.getVersion() >= 5 ? 2 : 0) + 4 +
+                             LT.Prologue.PrologueLength;
+    ArrayRef<uint8_t> Header(
+        reinterpret_cast<const uint8_t *>(Old.data()) + Offset + 4,
+        ProgramOffset - Offset - 4);
+    encodeLineTable(LT, Header, T, MCCtx, Tables[I], Stats);
+    Stats.LineTables++;
+  };
+  if (Config.Parallel)
+    parallel::for_each_n(parallel::par, (size_t)0, Tables.size(),
+                         RewriteTable);
+  else
+    for (size_t I = 0; I != Tables.size(); ++I)
+      RewriteTable(I);
+
+  // All reading is done: patch .debug_abbrev and .debug_info in place
+  for (const auto &P : AbbrevPatches)
+    AbbrevContents[P.first] = P.second;
+
+  // The addresses of the split units are entries of .debug_addr
+  const Section *DebugAddr = findSection(".debug_addr");
+  std::vector<uint8_t> AddrCopy;
+  if (DebugAddr && !AddrBases.empty()) {
+    Expected<uint8_t *> AddrOrErr = Decompress(*DebugAddr, AddrCopy);
+    if (!AddrOrErr)
+      return AddrOrErr.takeError();
+    uint8_t *Addr = *AddrOrErr;
+    uint64_t AddrSize = DebugAddr->Flags & ELF::SHF_COMPRESSED
+                            ? AddrCopy.size()
+                            : DebugAddr->Size;
+    llvm::sort(AddrBases);
+    AddrBases.erase(std::unique(AddrBases.begin(), AddrBases.end()),
+                    AddrBases.end());
+    for (size_t I = 0, E = AddrBases.size(); I != E; ++I) {
+      uint64_t Begin = AddrBases[I].first, End;
+      if (AddrBases[I].second) {
+        // unit_length, version, address_size and segment_selector_size
+        if (Begin < 8 || Begin > AddrSize)
+          continue;
+        End = Begin - 4 + endian::read32le(Addr + Begin - 8);
+      } else {
+        End = I + 1 != E ? AddrBases[I + 1].first : AddrSize;
+      }
+      for (uint64_t Entry = Begin; Entry + 8 <= std::min(End, AddrSize);
+           Entry += 8) {
+        endian::write64le(Addr + Entry,
+                          T.translate(endian::read64le(Addr + Entry)));
+        Stats.AddrEntries++;
+      }
+    }
+  }
+  ForEachUnit([&](UnitWork &W) {
+    if (!W.Unsupported)
+      finishUnit(W, T, Abbrevs, Info, Stats);
+  });
+
+  std::vector<uint8_t> NewLine;
+  DenseMap<uint32_t, uint32_t> NewTableOffsets;
+  for (size_t I = 0; I != Tables.size(); ++I) {
+    NewTableOffsets[TableOffsets[I]] = NewLine.size();
+    NewLine.insert(NewLine.end(), Tables[I].begin(), Tables[I].end());
+  }
+  std::vector<uint8_t> NewRanges;
+  for (UnitWork &W : Units) {
+    W.ListsBase = NewRanges.size();
+    NewRanges.insert(NewRanges.end(), W.Lists.begin(), W.Lists.end());
+  }
+  ForEachUnit([&](UnitWork &W) {
+    if (W.StmtListOffset)
+      endian::write32le(Info + *W.StmtListOffset,
+                        NewTableOffsets.lookup(W.LineTableOffset));
+    for (const Patch &P : W.Patches) {
+      uint64_t V = P.IsRangesOffset ? W.ListsBase + P.Value : P.Value;
+      if (P.Size == 8)
+        endian::write64le(Info + P.Offset, V);
+      else
+        endian::write32le(Info + P.Offset, V);
+    }
+  });
+
+  std::vector<NewSection> New;
+  if (DebugLine)
+    New.push_back({".debug_line", std::move(NewLine)});
+  if (!NewRanges.empty() || findSection(".debug_ranges"))
+    New.push_back({".debug_ranges", std::move(NewRanges)});
+  if (findSection(".debug_aranges"))
+    New.push_back({".debug_aranges", buildAranges(Units)});
+  if (DebugInfo->Flags & ELF::SHF_COMPRESSED)
+    New.push_back({".debug_info", std::move(InfoCopy)});
+  if (DebugAbbrev->Flags & ELF::SHF_COMPRESSED)
+    New.push_back({".debug_abbrev", std::move(AbbrevCopy)});
+  if (!AddrCopy.empty())
+    New.push_back({".debug_addr", std::move(AddrCopy)});
+  // A section is recompressed if it was compressed, a new one if .debug_info
+  // was
+  for (NewSection &Sec : New) {
+    const Section *Old = findSection(Sec.Name);
+    Sec.Compressed = (Old ? Old : DebugInfo)->Flags & ELF::SHF_COMPRESSED;
+  }
+  uint64_t UncompressedSize = 0, CompressedSize = 0;
+  for (const NewSection &Sec : New)
+    if (Sec.Compressed)
+      UncompressedSize += Sec.Data.size();
+  if (Error E = compressSections(New))
+    return E;
+  for (const NewSection &Sec : New)
+    if (Sec.Compressed)
+      CompressedSize += Sec.Data.size();
+  std::move(New.begin(), New.end(), std::back_inserter(Out));
+
+  if (Config.Verbose)
+    outs() << "DWARF: " << Stats.LineTables << " line tables ("
+           << Stats.OldSequences << " -> " << Stats.NewSequences
+           << " sequences), " << Stats.Lists << " range lists, "
+           << Stats.Converted << " low/high pairs turned into ranges ("
+           << Stats.Unfixable << " left split), " << Stats.Unsupported
+           << " DWARF 5 units skipped\n";
+  if (Config.Verbose && Stats.SplitUnits)
+    outs() << "DWARF: " << Stats.SplitUnits << " split units ("
+           << Stats.AddrEntries << " .debug_addr entries)\n";
+  if (Config.Verbose && UncompressedSize)
+    outs() << "DWARF: recompressed " << UncompressedSize << " -> "
+           << CompressedSize << " bytes\n";
+  return Error::success();
+}
+
+// Koo: A section of gigabytes is not deflated on one thread: it is cut into
+// pieces of CompressionPieceSize bytes, deflated on the thread pool each as
+// an independent part of one zlib stream (see zlib::compressPiece()), thus
+// every consumer of SHF_COMPRESSED reads it back as usual. The independent
+// pieces cost well under a percent of the compression ratio.
+static const size_t CompressionPieceSize = 1 << 20;
+
+Error Randomizer::compressSections(MutableArrayRef<NewSection> New) {
+  struct Piece {
+    unsigned Sec;
+    size_t Offset, Size;
+    SmallVector<char, 0> Deflated;
+    uint32_t Adler = 0;
+    std::string Message;
+  };
+  std::vector<Piece> Pieces;
+  for (unsigned I = 0, E = New.size(); I != E; ++I) {
+    if (!New[I].Compressed)
+      continue;
+    if (!zlib::isAvailable())
+      return makeError("Compressed DWARF (" + New[I].Name +
+                       ") cannot be updated without zlib");
+    size_t Size = New[I].Data.size();
+    for (size_t Offset = 0; Offset < Size || Offset == 0;
+         Offset += CompressionPieceSize)
+      Pieces.push_back(
+          {I, Offset, std::min(CompressionPieceSize, Size - Offset), {}, 0, ""});
+  }
+  auto CompressPiece = [&](size_t I) {
+    Piece &P = Pieces[I];
+    const std::vector<uint8_t> &Data = New[P.Sec].Data;
+    StringRef In(reinterpret_cast<const char *>(Data.data()) + P.Offset, P.Size);
+    bool Last = P.Offset + P.Size == Data.size();
+    if (Error E = zlib::compressPiece(In, P.Deflated, Last))
+      P.Message = toString(std::move(E));
+    P.Adler = zlib::adler32(In);
+  };
+  if (Config.Parallel)
+    parallel::for_each_n(parallel::par, (size_t)0, Pieces.size(),
+                         CompressPiece);
+  else
+    for (size_t I = 0; I != Pieces.size(); ++I)
+      CompressPiece(I);
+
+  // Every section becomes its Elf64_Chdr, the zlib header, its pieces and
+  // the adler32 of its contents
+  for (size_t I = 0, E = Pieces.size(); I != E;) {
+    NewSection &Sec = New[Pieces[I].Sec];
+    std::vector<uint8_t> Out(sizeof(ELF::Elf64_Chdr) + 2);
+    endian::write32le(Out.data() + offsetof(ELF::Elf64_Chdr, ch_type),
+                      ELF::ELFCOMPRESS_ZLIB);
+    endian::write64le(Out.data() + offsetof(ELF::Elf64_Chdr, ch_size),
+                      Sec.Data.size());
+    endian::write64le(Out.data() + offsetof(ELF::Elf64_Chdr, ch_addralign), 1);
+    Out[sizeof(ELF::Elf64_Chdr)] = 0x78; // Deflate, 32K window
+    Out[sizeof(ELF::Elf64_Chdr) + 1] = 0x9c; // Default level, no dictionary
+    uint32_t Adler = zlib::adler32("");
+    for (; I != E && &New[Pieces[I].Sec] == &Sec; ++I) {
+      const Piece &P = Pieces[I];
+      if (!P.Message.empty())
+        return makeError("Compressing " + Sec.Name + ": " + P.Message);
+      Out.insert(Out.end(), P.Deflated.begin(), P.Deflated.end());
+      Adler = zlib::adler32Combine(Adler, P.Adler, P.Size);
+    }
+    size_t End = Out.size();
+    Out.resize(End + 4);
+    endian::write32be(Out.data() + End, Adler);
+    Sec.Data = std::move(Out);
+  }
+  return Error::success();
+}
+
+// Koo: Non-allocated sections may live anywhere in the file, thus each new
+// section is appended and its header pointed at it. A section the binary
+// lacks gets a new header, which moves the section header table (and the
+// section names) to the end of the file as well.
+Error Randomizer::appendSections(ArrayRef<NewSection> New, uint64_t FileSize,
+                                 std::vector<FileAppend> &Appends) {
+  Expected<object::ELF64LEFile> ElfOrErr =
+      object::ELF64LEFile::create(toStringRef(Image));
+  if (!ElfOrErr)
+    return ElfOrErr.takeError();
+  const auto &Ehdr = *ElfOrErr->getHeader();
+  unsigned StrIdx = Ehdr.e_shstrndx;
+  if (Ehdr.e_shentsize != sizeof(ELF::Elf64_Shdr) || !Ehdr.e_shnum ||
+      StrIdx >= Sections.size())
+    return makeError("Unsupported section header table");
+
+  uint64_t TableSize = (uint64_t)Ehdr.e_shnum * sizeof(ELF::Elf64_Shdr);
+  std::vector<uint8_t> Table(Image.begin() + Ehdr.e_shoff,
+                             Image.begin() + Ehdr.e_shoff + TableSize);
+  const Section &StrTab = Sections[StrIdx];
+  std::vector<uint8_t> Names(getContents(StrTab),
+                             getContents(StrTab) + StrTab.Size);
+  bool NewHeaders = false;
+
+  uint64_t Offset = FileSize;
+  auto Place = [&](std::vector<uint8_t> Data) {
+    Offset = alignTo(Offset, 8);
+    Appends.push_back({Offset, std::move(Data)});
+    Offset += Appends.back().Data.size();
+    return Appends.back().Offset;
+  };
+  auto SetField = [&](unsigned Idx, size_t Field, uint64_t V) {
+    uint8_t *Shdr = Table.data() + Idx * sizeof(ELF::Elf64_Shdr);
+    if (Field == offsetof(ELF::Elf64_Shdr, sh_name) ||
+        Field == offsetof(ELF::Elf64_Shdr, sh_type))
+      endian::write32le(Shdr + Field, V);
+    else
+      endian::write64le(Shdr + Field, V);
+  };
+
+  for (const auto &Sec : New) {
+    const Section *Old = findSection(Sec.Name);
+    unsigned Idx;
+    if (Old) {
+      Idx = Old->Index;
+    } else {
+      Idx = Table.size() / sizeof(ELF::Elf64_Shdr);
+      Table.resize(Table.size() + sizeof(ELF::Elf64_Shdr));
+      SetField(Idx, offsetof(ELF::Elf64_Shdr, sh_name), Names.size());
+      SetField(Idx, offsetof(ELF::Elf64_Shdr, sh_type), ELF::SHT_PROGBITS);
+      SetField(Idx, offsetof(ELF::Elf64_Shdr, sh_addralign), 1);
+      if (Sec.Compressed)
+        SetField(Idx, offsetof(ELF::Elf64_Shdr, sh_flags),
+                 ELF::SHF_COMPRESSED);
+      Names.insert(Names.end(), Sec.Name.begin(), Sec.Name.end());
+      Names.push_back('\0');
+      NewHeaders = true;
+    }
+    SetField(Idx, offsetof(ELF::Elf64_Shdr, sh_size), Sec.Data.size());
+    SetField(Idx, offsetof(ELF::Elf64_Shdr, sh_offset), Place(Sec.Data));
+  }
+
+  if (!NewHeaders) {
+    memcpy(Image.data() + Ehdr.e_shoff, Table.data(), Table.size());
+    return Error::success();
+  }
+  if (Table.size() / sizeof(ELF::Elf64_Shdr) >= ELF::SHN_LORESERVE)
+    return makeError("Too many sections");
+  SetField(StrIdx, offsetof(ELF::Elf64_Shdr, sh_size), Names.size());
+  SetField(StrIdx, offsetof(ELF::Elf64_Shdr, sh_offset), Place(Names));
+  uint64_t TableOffset = Place(Table);
+  uint8_t *Header = Image.data();
+  endian::write64le(Header + offsetof(ELF::Elf64_Ehdr, e_shoff), TableOffset);
+  endian::write16le(Header + offsetof(ELF::Elf64_Ehdr, e_shnum),
+                    Table.size() / sizeof(ELF::Elf64_Shdr));
+  return Error::success();
+}
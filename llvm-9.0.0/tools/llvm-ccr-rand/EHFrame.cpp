@@ -0,0 +1,723 @@
+//===- EHFrame.cpp - The FDEs of the cold regions of split functions ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A split function (-split-functions) has its cold chains at the end of
+// its segment, out of the range of its FDE, and the file layout leaves no
+// room for more records in .eh_frame nor for more entries in the search
+// table of .eh_frame_hdr. The cold parts of a segment are contiguous, thus a
+// single FDE covers all of them: its CFI program moves to the row of every
+// part at its start. A split function has no CFI past its entry chain and no
+// LSDA, thus its cold part unwinds in the state that its program ends in,
+// i.e., the program without its advances.
+//
+// The FDE of a cold region takes the place of the FDEs of the functions laid
+// out right before the region, which it absorbs: each of them runs its own
+// program from its start. Every part (absorbed or cold) starts over from the
+// initial rules of the CIE, which the region remembers first and restores at
+// each part. The records after the first absorbed one move up in .eh_frame
+// (their pc-relative pointers moving along), the FDEs of the regions are
+// appended, and the search table is rebuilt.
+//
+// Where the FDEs to absorb cannot make up for the cold parts, the functions
+// of the last parts are not split.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Randomizer.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::support;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// The size of an encoded pointer; 0 if unsupported
+static unsigned getEncodedSize(uint8_t Encoding) {
+  switch (Encoding & 0x0f) {
+  case dwarf::DW_EH_PE_absptr:
+  case dwarf::DW_EH_PE_udata8:
+  case dwarf::DW_EH_PE_sdata8: return 8;
+  case dwarf::DW_EH_PE_udata4:
+  case dwarf::DW_EH_PE_sdata4: return 4;
+  default: return 0;
+  }
+}
+
+static bool isPCRel(uint8_t Encoding) {
+  return (Encoding & 0x70) == dwarf::DW_EH_PE_pcrel;
+}
+
+static int64_t readPointer(const uint8_t *P, uint8_t Encoding) {
+  if (getEncodedSize(Encoding) == 8)
+    return endian::read64le(P);
+  if ((Encoding & 0x0f) == dwarf::DW_EH_PE_sdata4)
+    return (int32_t)endian::read32le(P);
+  return endian::read32le(P);
+}
+
+static void writePointer(uint8_t *P, uint8_t Encoding, int64_t Value) {
+  if (getEncodedSize(Encoding) == 8)
+    endian::write64le(P, Value);
+  else
+    endian::write32le(P, Value);
+}
+
+// Walk the CFI program [P, End): the size of the program up to its last
+// operation other than a NOP goes to Size, the advances sum up to Advance,
+// and the other operations are appended to Ops (if any). False if an
+// operation is unknown or sets the location, or if the remembered states do
+// not balance.
+static bool decodeProgram(const uint8_t *P, const uint8_t *End,
+                          std::vector<uint8_t> *Ops, uint64_t &Size,
+                          uint64_t &Advance) {
+  const uint8_t *Begin = P;
+  int Depth = 0;
+  Size = Advance = 0;
+  while (P < End) {
+    const uint8_t *Op = P;
+    uint8_t Code = *P++;
+    bool OK = true, Keep = true;
+    auto SkipLEB = [&] {
+      unsigned N;
+      const char *Err = nullptr;
+      decodeULEB128(P, &N, End, &Err);
+      P += N;
+      return !Err;
+    };
+    auto SkipBlock = [&] {
+      unsigned N;
+      const char *Err = nullptr;
+      uint64_t Length = decodeULEB128(P, &N, End, &Err);
+      if (Err || Length > uint64_t(End - P - N))
+        return false;
+      P += N + Length;
+      return true;
+    };
+    auto AdvanceBy = [&](unsigned N) {
+      if (N > unsigned(End - P))
+        return false;
+      Advance += N == 1 ? *P : N == 2 ? endian::read16le(P)
+                                      : endian::read32le(P);
+      P += N;
+      Keep = false;
+      return true;
+    };
+
+    switch (Code & 0xc0) {
+    case dwarf::DW_CFA_advance_loc:
+      Advance += Code & 0x3f;
+      Keep = false;
+      break;
+    case dwarf::DW_CFA_offset:
+      OK = SkipLEB();
+      break;
+    case dwarf::DW_CFA_restore:
+      break;
+    default:
+      switch (Code) {
+      case dwarf::DW_CFA_nop:
+        Keep = false;
+        break;
+      case dwarf::DW_CFA_advance_loc1: OK = AdvanceBy(1); break;
+      case dwarf::DW_CFA_advance_loc2: OK = AdvanceBy(2); break;
+      case dwarf::DW_CFA_advance_loc4: OK = AdvanceBy(4); break;
+      case dwarf::DW_CFA_remember_state:
+        Depth++;
+        break;
+      case dwarf::DW_CFA_restore_state:
+        OK = Depth-- > 0;
+        break;
+      case dwarf::DW_CFA_offset_extended:
+      case dwarf::DW_CFA_register:
+      case dwarf::DW_CFA_def_cfa:
+      case dwarf::DW_CFA_offset_extended_sf:
+      case dwarf::DW_CFA_def_cfa_sf:
+      case dwarf::DW_CFA_val_offset:
+      case dwarf::DW_CFA_val_offset_sf:
+        OK = SkipLEB() && SkipLEB();
+        break;
+      case dwarf::DW_CFA_restore_extended:
+      case dwarf::DW_CFA_undefined:
+      case dwarf::DW_CFA_same_value:
+      case dwarf::DW_CFA_def_cfa_register:
+      case dwarf::DW_CFA_def_cfa_offset:
+      case dwarf::DW_CFA_def_cfa_offset_sf:
+      case dwarf::DW_CFA_GNU_args_size:
+        OK = SkipLEB();
+        break;
+      case dwarf::DW_CFA_def_cfa_expression:
+        OK = SkipBlock();
+        break;
+      case dwarf::DW_CFA_expression:
+      case dwarf::DW_CFA_val_expression:
+        OK = SkipLEB() && SkipBlock();
+        break;
+      default:
+        // DW_CFA_set_loc, DW_CFA_GNU_window_save etc.
+        OK = false;
+        break;
+      }
+    }
+    if (!OK)
+      return false;
+    if (Code != dwarf::DW_CFA_nop)
+      Size = P - Begin;
+    if (Keep && Ops)
+      Ops->insert(Ops->end(), Op, P);
+  }
+  return Depth == 0;
+}
+
+// The shortest advance_loc by Delta
+static void appendAdvance(std::vector<uint8_t> &Out, uint64_t Delta) {
+  if (!Delta)
+    return;
+  if (Delta < 0x40) {
+    Out.push_back(dwarf::DW_CFA_advance_loc | Delta);
+    return;
+  }
+  uint8_t Bytes[4];
+  unsigned N = Delta <= 0xff ? 1 : Delta <= 0xffff ? 2 : 4;
+  Out.push_back(N == 1 ? dwarf::DW_CFA_advance_loc1
+                       : N == 2 ? dwarf::DW_CFA_advance_loc2
+                                : dwarf::DW_CFA_advance_loc4);
+  endian::write32le(Bytes, Delta);
+  Out.insert(Out.end(), Bytes, Bytes + N);
+}
+
+// Parse the CIE of the record R (at Rec, up to End); false if the rest of
+// .eh_frame cannot move with it
+static bool parseCIE(const uint8_t *Rec, const uint8_t *End, EHRecord &R) {
+  const uint8_t *P = Rec + 8;
+  uint8_t Version = *P++;
+  if (Version != 1 && Version != 3)
+    return false;
+  const char *Aug = reinterpret_cast<const char *>(P);
+  size_t AugLen = strnlen(Aug, End - P);
+  if (AugLen == size_t(End - P))
+    return false;
+  P += AugLen + 1;
+
+  unsigned N;
+  const char *Err = nullptr;
+  uint64_t CodeAlign = decodeULEB128(P, &N, End, &Err);
+  P += N;
+  if (!Err) {
+    decodeSLEB128(P, &N, End, &Err);
+    P += N;
+  }
+  if (!Err && Version == 1)
+    P++;
+  else if (!Err) {
+    decodeULEB128(P, &N, End, &Err);
+    P += N;
+  }
+  if (Err || P > End)
+    return false;
+  R.UnitCodeAlign = CodeAlign == 1;
+  R.FDEEncoding = dwarf::DW_EH_PE_absptr;
+
+  if (Aug[0] == 'z') {
+    R.Augmented = true;
+    decodeULEB128(P, &N, End, &Err);
+    P += N;
+    if (Err)
+      return false;
+    for (const char *C = Aug + 1; *C; ++C) {
+      if (P >= End)
+        return false;
+      switch (*C) {
+      case 'R':
+        R.FDEEncoding = *P++;
+        break;
+      case 'L':
+        R.LSDAEncoding = *P++;
+        if (!getEncodedSize(R.LSDAEncoding) || !isPCRel(R.LSDAEncoding))
+          return false;
+        break;
+      case 'P': {
+        uint8_t Enc = *P++;
+        unsigned Size = getEncodedSize(Enc);
+        if (!Size || !isPCRel(Enc) || Size > unsigned(End - P))
+          return false;
+        R.PersonalityEncoding = Enc;
+        R.PersonalityField = P - Rec;
+        P += Size;
+        break;
+      }
+      case 'S':
+        break;
+      default:
+        return false;
+      }
+    }
+  } else if (Aug[0]) {
+    return false;
+  }
+  return getEncodedSize(R.FDEEncoding) && isPCRel(R.FDEEncoding);
+}
+
+// Parse the FDE R (of the CIE C, at Rec up to End, at the address Addr)
+static bool parseFDE(const uint8_t *Rec, const uint8_t *End, uint64_t Addr,
+                     const EHRecord &C, EHRecord &R) {
+  unsigned Size = getEncodedSize(C.FDEEncoding);
+  const uint8_t *P = Rec + 8;
+  if (2 * Size > unsigned(End - P))
+    return false;
+  R.Begin = Addr + 8 + readPointer(P, C.FDEEncoding);
+  R.Range = readPointer(P + Size, C.FDEEncoding & 0x0f);
+  P += 2 * Size;
+  if (C.Augmented) {
+    unsigned N;
+    const char *Err = nullptr;
+    uint64_t Length = decodeULEB128(P, &N, End, &Err);
+    if (Err || Length > uint64_t(End - P - N))
+      return false;
+    P += N;
+    if (C.LSDAEncoding != dwarf::DW_EH_PE_omit) {
+      if (getEncodedSize(C.LSDAEncoding) > Length)
+        return false;
+      R.LSDAField = P - Rec;
+      R.HasLSDA = readPointer(P, C.LSDAEncoding) != 0;
+    }
+    P += Length;
+  }
+  R.Program = P - Rec;
+  uint64_t ProgramSize, Advance;
+  R.Simple = !R.HasLSDA && C.UnitCodeAlign &&
+             decodeProgram(P, End, nullptr, ProgramSize, Advance);
+  return true;
+}
+
+// The search table wants a udata4 count of datarel sdata4 pairs
+static bool hasSearchTable(const Section *Hdr, const uint8_t *H) {
+  return Hdr && Hdr->Type != ELF::SHT_NOBITS && Hdr->Size >= 12 &&
+         H[2] == dwarf::DW_EH_PE_udata4 &&
+         H[3] == (dwarf::DW_EH_PE_datarel | dwarf::DW_EH_PE_sdata4) &&
+         getEncodedSize(H[1]) == 4 &&
+         12 + (uint64_t)endian::read32le(H + 8) * 8 <= Hdr->Size;
+}
+
+// Koo: Find the FDE of every function, and let the functions split whose FDE
+// the cold region can take (or all of them, if there is no .eh_frame)
+Error Randomizer::readEHRecords() {
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  std::vector<unsigned> Split;
+  const Section *EHFrame = findSection(".eh_frame");
+  if (!EHFrame || EHFrame->Type == ELF::SHT_NOBITS) {
+    for (unsigned I = 0, E = Funcs.size(); I < E; ++I)
+      Split.push_back(I);
+    L->setSplitFunctions(Split);
+    return Error::success();
+  }
+  const Section *Hdr = findSection(".eh_frame_hdr");
+  if (!Hdr || !hasSearchTable(Hdr, getContents(*Hdr))) {
+    WithColor::warning() << "no supported .eh_frame_hdr; functions not split\n";
+    return Error::success();
+  }
+
+  const uint8_t *Contents = getContents(*EHFrame);
+  DenseMap<uint64_t, unsigned> Records;
+  bool Movable = true;
+  uint64_t Off = 0;
+  while (Off + 8 <= EHFrame->Size) {
+    uint32_t Length = endian::read32le(Contents + Off);
+    if (Length == 0)
+      break;
+    if (Length == 0xffffffff || Off + 4 + Length > EHFrame->Size)
+      return makeError("Unsupported .eh_frame record at offset " + Twine::utohexstr(Off));
+    EHRecord R;
+    R.Offset = Off;
+    R.Size = 4 + Length;
+    const uint8_t *Rec = Contents + Off, *End = Rec + R.Size;
+    uint32_t ID = endian::read32le(Rec + 4);
+    if (ID == 0) {
+      Movable &= parseCIE(Rec, End, R);
+    } else {
+      auto It = Records.find(Off + 4 - ID);
+      if (It == Records.end() || EHRecords[It->second].CIE >= 0)
+        return makeError("FDE at .eh_frame+" + Twine::utohexstr(Off) + " without CIE");
+      R.CIE = It->second;
+      Movable &= parseFDE(Rec, End, EHFrame->Addr + Off, EHRecords[R.CIE], R);
+    }
+    Records[Off] = EHRecords.size();
+    EHRecords.push_back(R);
+    Off += R.Size;
+  }
+  if (!Movable) {
+    WithColor::warning() << "unsupported .eh_frame records; functions not split\n";
+    EHRecords.clear();
+    return Error::success();
+  }
+
+  // The FDEs that the search table finds
+  const uint8_t *H = getContents(*Hdr);
+  for (uint32_t I = 0, E = endian::read32le(H + 8); I < E; ++I) {
+    int32_t FDE = endian::read32le(H + 12 + I * 8 + 4);
+    auto It = Records.find(Hdr->Addr + FDE - EHFrame->Addr);
+    if (It != Records.end())
+      EHRecords[It->second].Indexed = true;
+  }
+
+  // An FDE belongs to a function if it covers exactly its code, maybe but
+  // the trailing padding; a function that any other FDE overlaps is kept
+  // whole
+  std::vector<bool> Overlapped(Funcs.size());
+  for (unsigned I = 0, E = EHRecords.size(); I < E; ++I) {
+    const EHRecord &R = EHRecords[I];
+    if (R.CIE < 0 || !R.Range || R.Begin < Text->Addr)
+      continue;
+    uint64_t Begin = R.Begin - Text->Addr;
+    int First = L->findBasicBlock(Begin);
+    if (First < 0)
+      continue;
+    const ccr::Function &F = Funcs[BBLs[First].Function];
+    const BasicBlock &Last = BBLs[F.FirstBBL + F.NumBBLs - 1];
+    uint64_t Size = Last.OldOffset + Last.Size - Begin;
+    if (F.FirstBBL == (unsigned)First && BBLs[First].OldOffset == Begin &&
+        R.Range <= Size && R.Range >= Size - Last.Padding &&
+        !FunctionFDEs.count(BBLs[First].Function)) {
+      FunctionFDEs[BBLs[First].Function] = I;
+      continue;
+    }
+    for (size_t B = First; B < BBLs.size() && BBLs[B].OldOffset < Begin + R.Range;
+         ++B)
+      Overlapped[BBLs[B].Function] = true;
+  }
+  for (unsigned I = 0, E = Funcs.size(); I < E; ++I) {
+    auto It = FunctionFDEs.find(I);
+    if (!Overlapped[I] && It != FunctionFDEs.end() &&
+        EHRecords[It->second].Simple)
+      Split.push_back(I);
+  }
+  L->setSplitFunctions(Split);
+  return Error::success();
+}
+
+// Koo: Every segment with cold parts gets a region FDE, which absorbs the
+// FDEs at the end of the segment until the records fit in .eh_frame and the
+// search table; what never fits is not split
+void Randomizer::planColdFDEs() {
+  ColdFDEs.clear();
+  if (EHRecords.empty())
+    return;
+  const Section *EHFrame = findSection(".eh_frame");
+  const Section *Hdr = findSection(".eh_frame_hdr");
+  const uint8_t *Contents = getContents(*EHFrame);
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  ArrayRef<unsigned> Order = L->functionOrder(), Ends = L->segmentEnds();
+
+  // The room left past the records (and the terminator), and in the table
+  const EHRecord &LastRecord = EHRecords.back();
+  uint64_t Used = LastRecord.Offset + LastRecord.Size;
+  if (Used + 4 <= EHFrame->Size && !endian::read32le(Contents + Used))
+    Used += 4;
+  int64_t NeedBytes = -(int64_t)(EHFrame->Size - Used);
+  const uint8_t *H = getContents(*Hdr);
+  int64_t NeedEntries = -(int64_t)((Hdr->Size - 12) / 8 - endian::read32le(H + 8));
+
+  // A part costs an advance_loc4, a restore_state and a remember_state along
+  // with its program
+  auto getProgramSize = [&](unsigned FuncIdx, bool Stripped) -> int64_t {
+    const EHRecord &R = EHRecords[FunctionFDEs.lookup(FuncIdx)];
+    const uint8_t *Rec = Contents + R.Offset;
+    std::vector<uint8_t> Ops;
+    uint64_t Size, Advance;
+    decodeProgram(Rec + R.Program, Rec + R.Size, &Ops, Size, Advance);
+    return 7 + (Stripped ? Ops.size() : Size);
+  };
+
+  struct Region {
+    ColdFDE FDE;
+    std::vector<unsigned> Parts;
+    std::vector<int64_t> PartCosts;
+    std::vector<unsigned> Candidates;
+    size_t NumAbsorbed = 0;
+    int64_t Cost = 0;
+  };
+  std::vector<Region> Regions;
+  std::vector<unsigned> Restore;
+  auto getSaving = [&](unsigned FuncIdx) {
+    return (int64_t)EHRecords[FunctionFDEs.lookup(FuncIdx)].Size -
+           getProgramSize(FuncIdx, false);
+  };
+
+  for (unsigned S = 0, Begin = 0; S < Ends.size(); Begin = Ends[S++]) {
+    Region R;
+    R.FDE.Segment = S;
+    for (unsigned P = Begin; P < Ends[S]; ++P) {
+      unsigned F = Order[P];
+      if (!Funcs[F].NumColdSlots)
+        continue;
+      int CIE = EHRecords[FunctionFDEs.lookup(F)].CIE;
+      if (R.FDE.CIE < 0)
+        R.FDE.CIE = CIE;
+      if (CIE != R.FDE.CIE) {
+        Restore.push_back(F);
+        continue;
+      }
+      R.Parts.push_back(F);
+      R.PartCosts.push_back(getProgramSize(F, true));
+      R.Cost += R.PartCosts.back();
+    }
+    if (R.Parts.empty())
+      continue;
+    for (unsigned P = Ends[S]; P-- > Begin;) {
+      auto It = FunctionFDEs.find(Order[P]);
+      if (It == FunctionFDEs.end())
+        break;
+      const EHRecord &Record = EHRecords[It->second];
+      if (!Record.Simple || !Record.Indexed || Record.CIE != R.FDE.CIE)
+        break;
+      R.Candidates.push_back(Order[P]);
+    }
+    // Length, CIE pointer, pc_begin and pc_range, the augmentation data, the
+    // first remember_state and the padding
+    const EHRecord &C = EHRecords[R.FDE.CIE];
+    R.Cost += 8 + 2 * getEncodedSize(C.FDEEncoding) + 1 + 3;
+    if (C.Augmented)
+      R.Cost += 1 + (C.LSDAEncoding != dwarf::DW_EH_PE_omit
+                         ? getEncodedSize(C.LSDAEncoding)
+                         : 0);
+    NeedBytes += R.Cost;
+    NeedEntries++;
+    Regions.push_back(std::move(R));
+  }
+
+  auto Absorb = [&](Region &R) {
+    if (R.NumAbsorbed == R.Candidates.size())
+      return false;
+    NeedBytes -= getSaving(R.Candidates[R.NumAbsorbed++]);
+    NeedEntries--;
+    return true;
+  };
+  // Every region takes the table entry of an FDE it absorbs, then as many
+  // of their bytes as the rest needs
+  for (Region &R : Regions)
+    if (NeedEntries > 0)
+      Absorb(R);
+  for (bool Progress = true; NeedBytes > 0 && Progress;) {
+    Progress = false;
+    for (Region &R : Regions)
+      if (NeedBytes > 0 && R.NumAbsorbed < R.Candidates.size() &&
+          getSaving(R.Candidates[R.NumAbsorbed]) > 0)
+        Progress |= Absorb(R);
+  }
+  // Else the last parts go back into their functions, then whole regions
+  auto Drop = [&](Region &R) {
+    NeedBytes -= R.Cost;
+    NeedEntries -= 1;
+    for (size_t I = 0; I < R.NumAbsorbed; ++I) {
+      NeedBytes += getSaving(R.Candidates[I]);
+      NeedEntries++;
+    }
+    Restore.insert(Restore.end(), R.Parts.begin(), R.Parts.end());
+    R.Parts.clear();
+    R.NumAbsorbed = 0;
+  };
+  for (size_t I = Regions.size(); (NeedBytes > 0 || NeedEntries > 0) && I--;) {
+    Region &R = Regions[I];
+    while (NeedBytes > 0 && R.Parts.size() > 1) {
+      NeedBytes -= R.PartCosts.back();
+      R.Cost -= R.PartCosts.back();
+      Restore.push_back(R.Parts.back());
+      R.Parts.pop_back();
+      R.PartCosts.pop_back();
+    }
+    if (NeedBytes > 0 || NeedEntries > 0)
+      Drop(R);
+  }
+  if (NeedBytes > 0 || NeedEntries > 0)
+    for (Region &R : Regions)
+      if (!R.Parts.empty())
+        Drop(R);
+
+  for (Region &R : Regions) {
+    if (R.Parts.empty())
+      continue;
+    R.FDE.Absorbed.assign(R.Candidates.begin(),
+                          R.Candidates.begin() + R.NumAbsorbed);
+    ColdFDEs.push_back(std::move(R.FDE));
+  }
+  if (Restore.empty())
+    return;
+  if (Config.Verbose)
+    outs() << "Kept " << Restore.size()
+           << " function(s) whole for lack of room in .eh_frame\n";
+  L->restoreBBLOrder(Restore);
+}
+
+// Koo: The FDEs of the functions pc_begin and pc_range are already patched
+// (see patchEHFrame()); the absorbed ones give way to the region FDEs
+Error Randomizer::writeColdFDEs() {
+  if (ColdFDEs.empty())
+    return Error::success();
+  const Section *EHFrame = findSection(".eh_frame");
+  const Section *Hdr = findSection(".eh_frame_hdr");
+  uint8_t *Contents = getContents(*EHFrame);
+  uint8_t *H = getContents(*Hdr);
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  ArrayRef<unsigned> Order = L->functionOrder(), Ends = L->segmentEnds();
+
+  // The parts of a region: [new begin, end) and the record of its program
+  struct Part {
+    uint64_t Begin;
+    uint64_t End;
+    unsigned Record;
+    bool Stripped;
+  };
+  std::vector<std::pair<const ColdFDE *, std::vector<Part>>> Regions;
+  std::vector<bool> Absorbed(EHRecords.size());
+  for (const ColdFDE &FDE : ColdFDEs) {
+    std::vector<Part> Parts;
+    for (auto I = FDE.Absorbed.rbegin(), E = FDE.Absorbed.rend(); I != E; ++I) {
+      std::pair<uint64_t, uint64_t> Range = L->getNewRange(*I, false);
+      Parts.push_back({Range.first, Range.second, FunctionFDEs.lookup(*I), false});
+    }
+    size_t NumAbsorbed = Parts.size();
+    for (unsigned P = FDE.Segment ? Ends[FDE.Segment - 1] : 0;
+         P < Ends[FDE.Segment]; ++P) {
+      unsigned F = Order[P];
+      if (!Funcs[F].NumColdSlots)
+        continue;
+      std::pair<uint64_t, uint64_t> Range = L->getNewRange(F, true);
+      Parts.push_back({Range.first, Range.second, FunctionFDEs.lookup(F), true});
+    }
+    // Restored since (short branches): the absorbed FDEs stay
+    if (Parts.size() == NumAbsorbed)
+      continue;
+    for (size_t I = 0; I < NumAbsorbed; ++I)
+      Absorbed[Parts[I].Record] = true;
+    std::sort(Parts.begin() + NumAbsorbed, Parts.end(),
+              [](const Part &A, const Part &B) { return A.Begin < B.Begin; });
+    Regions.push_back({&FDE, std::move(Parts)});
+  }
+  if (Regions.empty())
+    return Error::success();
+
+  // The kept records move up by the absorbed ones before them
+  const EHRecord &LastRecord = EHRecords.back();
+  uint64_t OldEnd = LastRecord.Offset + LastRecord.Size;
+  bool Terminated = OldEnd + 4 <= EHFrame->Size &&
+                    !endian::read32le(Contents + OldEnd);
+  std::vector<uint8_t> Out;
+  std::vector<uint64_t> NewOffsets(EHRecords.size());
+  std::vector<std::pair<int32_t, int32_t>> Table;
+  for (unsigned I = 0, E = EHRecords.size(); I < E; ++I) {
+    const EHRecord &R = EHRecords[I];
+    if (Absorbed[I])
+      continue;
+    uint64_t New = NewOffsets[I] = Out.size();
+    Out.insert(Out.end(), Contents + R.Offset, Contents + R.Offset + R.Size);
+    uint8_t *Rec = Out.data() + New;
+    int64_t Delta = R.Offset - New;
+    if (R.CIE < 0) {
+      if (R.PersonalityField)
+        writePointer(Rec + R.PersonalityField, R.PersonalityEncoding,
+                     readPointer(Rec + R.PersonalityField, R.PersonalityEncoding) +
+                         Delta);
+      continue;
+    }
+    const EHRecord &C = EHRecords[R.CIE];
+    endian::write32le(Rec + 4, New + 4 - NewOffsets[R.CIE]);
+    int64_t Begin = readPointer(Rec + 8, C.FDEEncoding);
+    writePointer(Rec + 8, C.FDEEncoding, Begin + Delta);
+    if (R.HasLSDA)
+      writePointer(Rec + R.LSDAField, C.LSDAEncoding,
+                   readPointer(Rec + R.LSDAField, C.LSDAEncoding) + Delta);
+    if (R.Indexed)
+      Table.push_back({(int32_t)(EHFrame->Addr + R.Offset + 8 + Begin - Hdr->Addr),
+                       (int32_t)(EHFrame->Addr + New - Hdr->Addr)});
+  }
+
+  for (const auto &Region : Regions) {
+    const EHRecord &C = EHRecords[Region.first->CIE];
+    const std::vector<Part> &Parts = Region.second;
+    uint64_t New = Out.size();
+    uint64_t Addr = EHFrame->Addr + New;
+    uint64_t Begin = Text->Addr + Parts.front().Begin;
+    unsigned Size = getEncodedSize(C.FDEEncoding);
+    int64_t PCBegin = Begin - (Addr + 8);
+    if (Size == 4 && (C.FDEEncoding & 0x0f) == dwarf::DW_EH_PE_sdata4 &&
+        !isInt<32>(PCBegin))
+      return makeError("The cold region at " + Twine::utohexstr(Begin) +
+                       " is out of the reach of .eh_frame");
+
+    uint8_t Field[8];
+    Out.resize(New + 8 + 2 * Size);
+    endian::write32le(Out.data() + New + 4, New + 4 - NewOffsets[Region.first->CIE]);
+    writePointer(Out.data() + New + 8, C.FDEEncoding, PCBegin);
+    writePointer(Out.data() + New + 8 + Size, C.FDEEncoding & 0x0f,
+                 Parts.back().End - Parts.front().Begin);
+    if (C.Augmented) {
+      unsigned LSDASize = C.LSDAEncoding != dwarf::DW_EH_PE_omit
+                              ? getEncodedSize(C.LSDAEncoding)
+                              : 0;
+      Out.push_back(LSDASize);
+      memset(Field, 0, sizeof(Field));
+      Out.insert(Out.end(), Field, Field + LSDASize);
+    }
+
+    Out.push_back(dwarf::DW_CFA_remember_state);
+    uint64_t Loc = Parts.front().Begin;
+    for (const Part &P : Parts) {
+      appendAdvance(Out, P.Begin - Loc);
+      Loc = P.Begin;
+      if (&P != &Parts.front()) {
+        Out.push_back(dwarf::DW_CFA_restore_state);
+        Out.push_back(dwarf::DW_CFA_remember_state);
+      }
+      const EHRecord &R = EHRecords[P.Record];
+      const uint8_t *Rec = Contents + R.Offset;
+      std::vector<uint8_t> Ops;
+      uint64_t ProgramSize, Advance;
+      decodeProgram(Rec + R.Program, Rec + R.Size, &Ops, ProgramSize, Advance);
+      if (P.Stripped) {
+        Out.insert(Out.end(), Ops.begin(), Ops.end());
+      } else {
+        Out.insert(Out.end(), Rec + R.Program, Rec + R.Program + ProgramSize);
+        Loc += Advance;
+      }
+    }
+    Out.resize(alignTo(Out.size(), 4), dwarf::DW_CFA_nop);
+    endian::write32le(Out.data() + New, Out.size() - New - 4);
+    Table.push_back({(int32_t)(Begin - Hdr->Addr), (int32_t)(Addr - Hdr->Addr)});
+  }
+  if (Terminated)
+    Out.resize(Out.size() + 4, 0);
+  if (Out.size() > EHFrame->Size)
+    return makeError("The cold region FDEs outgrow .eh_frame");
+  memcpy(Contents, Out.data(), Out.size());
+  memset(Contents + Out.size(), 0, EHFrame->Size - Out.size());
+
+  uint32_t OldCount = endian::read32le(H + 8);
+  if (12 + Table.size() * 8 > Hdr->Size)
+    return makeError("The cold region FDEs outgrow .eh_frame_hdr");
+  sortSearchTable(Table);
+  memset(H + 12, 0, std::max<uint64_t>(OldCount, Table.size()) * 8);
+  endian::write32le(H + 8, Table.size());
+  for (size_t I = 0; I < Table.size(); ++I) {
+    endian::write32le(H + 12 + I * 8, Table[I].first);
+    endian::write32le(H + 12 + I * 8 + 4, Table[I].second);
+  }
+  if (Config.Verbose)
+    outs() << "Wrote " << Regions.size() << " cold region FDE(s)\n";
+  return Error::success();
+}
@@ -0,0 +1,1046 @@
+//===- Layout.cpp - Function/BBL layout of a CCR-annotated binary ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Layout.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/TimeProfiler.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+Layout::Layout(const RandInfo &Info, bool ShuffleBBLs, bool HotColdBuckets,
+               bool PlacementChains)
+    : HotColdBuckets(HotColdBuckets), PlacementChains(PlacementChains) {
+  Begin = End = Info.RandObjOffset;
+  BBLs.resize(Info.BasicBlocks.size());
+
+  Function CurFunc;
+  bool AnyHot = false, AllCold = true, Pinned = false;
+  // The CFI rows of a function refer to its original layout, thus only the
+  // entry chain (which never moves) may hold CFI instructions
+  bool InEntryChain = true, MovableCFI = false;
+  ObjectRange CurObj;
+  CurObj.SourceType = Info.getSourceType(0);
+
+  for (unsigned I = 0, E = Info.BasicBlocks.size(); I != E; ++I) {
+    const BasicBlockInfo &BI = Info.BasicBlocks[I];
+    BasicBlock &BBL = BBLs[I];
+    BBL.OldOffset = BBL.NewOffset = End;
+    BBL.Size = BI.Size;
+    BBL.FallThrough = BI.FallThrough;
+    BBL.Hotness = BI.Hotness;
+    BBL.Padding = BI.PaddingSize;
+    BBL.AlignLog2 = BI.AlignLog2;
+    BBL.LoopHeader = BI.LoopHeader;
+    BBL.ChainStart = BI.ChainStart;
+    BBL.EdgeProb = BI.EdgeProb;
+    BBL.TermSize = BI.TermSize;
+    BBL.TermKind = BI.TermKind;
+    BBL.BoundarySize = BI.BoundarySize;
+    BBL.BoundaryLog2 = BI.BoundaryLog2;
+    BBL.BoundaryOffset = BI.BoundaryOffset;
+    MaxAlignLog2 = std::max<unsigned>(MaxAlignLog2, BI.AlignLog2);
+    BBL.Function = Functions.size();
+    End += BI.Size;
+    CurFunc.NumBBLs++;
+    AnyHot |= BI.Hotness == HOT_Hot;
+    AllCold &= BI.Hotness == HOT_Cold;
+    Pinned |= BI.Pinned;
+    MovableCFI |= BI.HasCFI && !InEntryChain;
+    InEntryChain &= BI.FallThrough;
+
+    // Both the end of MF and the end of object close the current function
+    if (BI.Type == BBT_Block && I + 1 != E)
+      continue;
+
+    CurFunc.Object = Objects.size();
+    CurFunc.Hotness = AnyHot ? HOT_Hot : AllCold ? HOT_Cold : HOT_Unknown;
+    AnyHot = false;
+    AllCold = true;
+    CurFunc.Pinned = Pinned;
+    Pinned = false;
+    // The placement marks the entry of every function that it has laid out
+    CurFunc.PlacementChains = BBLs[CurFunc.FirstBBL].ChainStart;
+    CurFunc.SectionClass = Info.BasicBlocks[CurFunc.FirstBBL].SectionClass;
+    FunctionIdentity ID = Info.getFunctionID(Functions.size());
+    CurFunc.StableID = ID.NameHash ? ID.NameHash : ID.ContentHash;
+    CurFunc.Splittable = CurFunc.NumBBLs > 1 && !MovableCFI &&
+                         !CurFunc.Pinned &&
+                         (CurObj.SourceType == SRC_Source ||
+                          CurObj.SourceType == SRC_AsmBlocks);
+    CurFunc.ShuffleBBLs = ShuffleBBLs && CurFunc.Splittable;
+    // Koo: A BBL may slide within the padding after it unless it is aligned
+    // itself (or holds an instruction padded clear of a boundary), or CFI rows
+    // from it on tell places within the function; asm objects may tell the
+    // distances between their BBLs anywhere
+    bool SlideSource = !CurFunc.Pinned && (CurObj.SourceType == SRC_Source ||
+                                           CurObj.SourceType == SRC_AsmBlocks);
+    for (unsigned J = I + 1; SlideSource && J-- != CurFunc.FirstBBL;) {
+      if (Info.BasicBlocks[J].HasCFI)
+        break;
+      BBLs[J].Slidable = !BBLs[J].AlignLog2 && !BBLs[J].BoundaryLog2;
+    }
+    InEntryChain = true;
+    MovableCFI = false;
+    Functions.push_back(CurFunc);
+    CurObj.NumFunctions++;
+    CurFunc = Function();
+    CurFunc.FirstBBL = I + 1;
+
+    if (BI.Type == BBT_ObjectEnd || I + 1 == E) {
+      Objects.push_back(CurObj);
+      CurObj = ObjectRange();
+      CurObj.FirstFunction = Functions.size();
+      CurObj.SourceType = Info.getSourceType(Objects.size());
+    }
+  }
+
+  FunctionOrder.resize(Functions.size());
+  for (unsigned I = 0, E = Functions.size(); I != E; ++I)
+    FunctionOrder[I] = I;
+  SegmentEnds.assign(1, Functions.size());
+  BBLOrder.resize(BBLs.size());
+  for (unsigned I = 0, E = BBLs.size(); I != E; ++I)
+    BBLOrder[I] = I;
+
+  std::vector<uint64_t> Starts(BBLs.size());
+  for (unsigned I = 0, E = BBLs.size(); I != E; ++I)
+    Starts[I] = BBLs[I].OldOffset;
+  Map = TranslationMap(Starts, End);
+  NewEnd = End;
+}
+
+// Koo: Only the code of the compiler goes unaligned; the alignment of asm may
+// be that of the data it interleaves or what its loops were tuned for
+bool Layout::isPacked(const BasicBlock &BBL) const {
+  const Function &F = Functions[BBL.Function];
+  if (!PackCold || F.Pinned || Objects[F.Object].SourceType != SRC_Source)
+    return false;
+  return BBL.ColdPart || F.Hotness == HOT_Cold ||
+         F.SectionClass == SC_Unlikely;
+}
+
+// The functions of an object that moves as a whole are placed one after
+// another within a segment, and may fall through into each other
+bool Layout::movesWithPrevious(size_t P) const {
+  if (P == 0 || FunctionOrder[P] != FunctionOrder[P - 1] + 1 ||
+      std::binary_search(SegmentEnds.begin(), SegmentEnds.end(), P))
+    return false;
+  const Function &F = Functions[FunctionOrder[P]];
+  if (F.Object != Functions[FunctionOrder[P - 1]].Object ||
+      F.NumColdSlots || Functions[FunctionOrder[P - 1]].NumColdSlots)
+    return false;
+  uint32_t SourceType = Objects[F.Object].SourceType;
+  return ObjectUnits || SourceType == SRC_Asm || SourceType == SRC_AsmBlocks;
+}
+
+// The bytes the hot (or cold) part of a function takes at the most wherever
+// it is placed, its alignment padding included
+uint64_t Layout::getMaxPlacedSize(unsigned FuncIdx, bool Cold) const {
+  const Function &F = Functions[FuncIdx];
+  unsigned First = F.FirstBBL, Last = F.FirstBBL + F.NumBBLs;
+  if (Cold)
+    First = Last - F.NumColdSlots;
+  else
+    Last -= F.NumColdSlots;
+  uint64_t Size = 0;
+  for (unsigned I = First; I != Last; ++I) {
+    const BasicBlock &BBL = BBLs[BBLOrder[I]];
+    Size += getCodeSize(BBL) + BBL.Growth;
+    if (Realign && BBL.AlignLog2 && !isPacked(BBL))
+      Size += (1ULL << BBL.AlignLog2) - 1;
+    if (Realign && BBL.BoundaryLog2)
+      Size += (1ULL << BBL.BoundaryLog2) - 1;
+  }
+  return Size;
+}
+
+// The bytes of a function in a hot region at the most, by its BBLs whatever
+// their order and growth (which differ between the seeds of the region)
+uint64_t Layout::getHotRegionReserve(unsigned FuncIdx) const {
+  const Function &F = Functions[FuncIdx];
+  uint64_t Size = FuncIdx < HotRegionGrowth.size() ? HotRegionGrowth[FuncIdx] : 0;
+  for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs; I != E; ++I) {
+    const BasicBlock &BBL = BBLs[I];
+    Size += getCodeSize(BBL);
+    if (Realign && BBL.AlignLog2 && !isPacked(BBL))
+      Size += (1ULL << BBL.AlignLog2) - 1;
+    if (Realign && BBL.BoundaryLog2)
+      Size += (1ULL << BBL.BoundaryLog2) - 1;
+  }
+  return Size;
+}
+
+// Koo: The cold parts of the split functions of a segment follow all of its
+// units, in the order of their functions. A unit (or a cold part) whose bytes
+// might cover an entry trampoline starts after it, the bytes before it being
+// the padding of the BBL placed before; units never fall through into each
+// other, thus the trampoline is only reached by its jumpers.
+void Layout::assignNewOffsets() {
+  uint64_t Offset = Begin, HotBegin = UINT64_MAX, HotEnd = 0;
+  BasicBlock *Prev = nullptr, *PrevPrev = nullptr;
+  unsigned PrevIdx = 0;
+  LeadingPadding = 0;
+  Stats.NumAlignedBBLs = Stats.NumAlignedLoopHeaders = 0;
+  Stats.NumSlidBBLs = 0;
+  Stats.SlideBytes = 0;
+  Stats.NumPackedBBLs = 0;
+  Stats.PackedBytes = 0;
+  Stats.NumBoundaryPadded = 0;
+  Stats.BoundaryPadBytes = 0;
+  Stats.NumSplitFunctions = 0;
+  Stats.ColdPartBytes = 0;
+  Stats.NumTrampolines = Trampolines.size();
+  Stats.TrampolineGapBytes = 0;
+  Stats.HotRegionBytes = 0;
+  HotRegionOverflow = false;
+  HotRegionSlots.clear();
+  auto NextTrampoline = Trampolines.begin();
+  bool AfterTrampoline = false; // The BBL placed before must not slide over it
+  auto SkipTrampolines = [&](uint64_t MaxSize) {
+    for (; NextTrampoline != Trampolines.end() &&
+           *NextTrampoline + TrampolineSize <= Offset;
+         ++NextTrampoline)
+      ;
+    for (; NextTrampoline != Trampolines.end() &&
+           Offset + MaxSize > *NextTrampoline;
+         ++NextTrampoline) {
+      uint64_t Gap = *NextTrampoline + TrampolineSize - Offset;
+      if (Prev)
+        Prev->NewPadding += Gap;
+      else
+        LeadingPadding += Gap;
+      Offset += Gap;
+      Stats.TrampolineGapBytes += Gap;
+      AfterTrampoline = true;
+    }
+  };
+  auto Place = [&](unsigned Slot, bool Hot) {
+    BasicBlock &BBL = BBLs[BBLOrder[Slot]];
+    if (Realign && BBL.AlignLog2 && isPacked(BBL)) {
+      uint64_t Pad =
+          alignTo(AlignBase + Offset, 1ULL << BBL.AlignLog2) - AlignBase -
+          Offset;
+      Stats.NumPackedBBLs += Pad != 0;
+      Stats.PackedBytes += Pad;
+    } else if (Realign && BBL.AlignLog2) {
+      // The padding goes at the end of the BBL placed before
+      uint64_t Aligned =
+          alignTo(AlignBase + Offset, 1ULL << BBL.AlignLog2) - AlignBase;
+      uint64_t Pad = Aligned - Offset;
+      if (SlidePadding && Pad && Prev && Prev->Slidable && !AfterTrampoline) {
+        // The BBL placed before starts later by a share of the padding, which
+        // ends the one before it instead
+        RandomStream RS(SlideSeed, RandomStream::slideStream(PrevIdx));
+        uint32_t Slide = RS.below(Pad + 1);
+        if (PrevPrev)
+          PrevPrev->NewPadding += Slide;
+        else
+          LeadingPadding += Slide;
+        Prev->NewOffset += Slide;
+        Map.setNewOffset(PrevIdx, Prev->NewOffset);
+        Pad -= Slide;
+        Stats.NumSlidBBLs += Slide != 0;
+        Stats.SlideBytes += Slide;
+      }
+      if (Prev)
+        Prev->NewPadding += Pad;
+      else
+        LeadingPadding += Pad;
+      Offset = Aligned;
+      Stats.NumAlignedBBLs++;
+      Stats.NumAlignedLoopHeaders += BBL.LoopHeader;
+    }
+    if (Realign && BBL.BoundaryLog2 && !BBL.Resized) {
+      // Koo: The assembler padded an instruction of the BBL clear of the
+      // boundaries at its old address; the padding is left inside, and the BBL
+      // starts later (by its alignment steps) until it is clear at the new one
+      uint64_t Window = 1ULL << BBL.BoundaryLog2;
+      uint64_t Step = BBL.AlignLog2 && !isPacked(BBL) ? 1ULL << BBL.AlignLog2 : 1;
+      auto Crosses = [&](uint64_t Pad) {
+        uint64_t Addr = AlignBase + Offset + Pad + BBL.BoundaryOffset;
+        return (Addr & (Window - 1)) + BBL.BoundarySize >= Window;
+      };
+      uint64_t Pad = 0;
+      while (Pad < Window && Crosses(Pad))
+        Pad += Step;
+      if (Pad && Pad < Window) {
+        if (Prev)
+          Prev->NewPadding += Pad;
+        else
+          LeadingPadding += Pad;
+        Offset += Pad;
+        Stats.NumBoundaryPadded++;
+        Stats.BoundaryPadBytes += Pad;
+      }
+    }
+    BBL.NewOffset = Offset;
+    BBL.NewPadding = 0;
+    Map.setNewOffset(BBLOrder[Slot], Offset);
+    if (Hot) {
+      HotBegin = std::min(HotBegin, Offset);
+      HotEnd = Offset + getCodeSize(BBL) + BBL.Growth;
+    }
+    Offset += getCodeSize(BBL) + BBL.Growth;
+    PrevPrev = Prev;
+    Prev = &BBL;
+    PrevIdx = BBLOrder[Slot];
+    AfterTrampoline = false;
+  };
+  size_t SegBegin = 0;
+  auto PlaceColdParts = [&](size_t SegEnd) {
+    for (size_t P = SegBegin; P != SegEnd; ++P) {
+      const Function &F = Functions[FunctionOrder[P]];
+      if (!F.NumColdSlots)
+        continue;
+      Stats.NumSplitFunctions++;
+      if (!Trampolines.empty())
+        SkipTrampolines(getMaxPlacedSize(FunctionOrder[P], true));
+      uint64_t PartBegin = Offset;
+      for (unsigned I = F.FirstBBL + F.NumBBLs - F.NumColdSlots,
+                    E = F.FirstBBL + F.NumBBLs;
+           I != E; ++I)
+        Place(I, false);
+      Stats.ColdPartBytes += Offset - PartBegin;
+    }
+    SegBegin = SegEnd;
+  };
+  // Koo: A hot region starts with its slots, which end the padding of the BBL
+  //      placed before, and ends at its reserve, thus the BBLs after it are
+  //      placed as for any other seed of the region; none of them slides
+  //      into it either.
+  auto NextRegion = Regions.begin();
+  auto CloseRegion = [&](size_t P) {
+    if (NextRegion == Regions.end() || NextRegion->EndPos != P)
+      return;
+    uint64_t RegionEnd = NextRegion->Begin + NextRegion->Reserve;
+    if (Offset > RegionEnd) {
+      HotRegionOverflow = true;
+    } else {
+      if (Prev)
+        Prev->NewPadding += RegionEnd - Offset;
+      else
+        LeadingPadding += RegionEnd - Offset;
+      Offset = RegionEnd;
+    }
+    AfterTrampoline = true;
+    Stats.HotRegionBytes += NextRegion->Reserve;
+    ++NextRegion;
+  };
+  auto OpenRegion = [&](size_t P) {
+    if (NextRegion == Regions.end() || NextRegion->FirstPos != P)
+      return;
+    HotRegion &R = *NextRegion;
+    uint64_t Slots = (uint64_t)R.Functions.size() * HotRegionSlotSize;
+    R.Begin = Offset;
+    R.Reserve = Slots;
+    for (size_t Q = R.FirstPos; Q != R.EndPos; ++Q)
+      R.Reserve += getHotRegionReserve(FunctionOrder[Q]);
+    for (size_t K = 0; K != R.Functions.size(); ++K)
+      HotRegionSlots[BBLs[Functions[R.Functions[K]].FirstBBL].OldOffset] =
+          R.Begin + K * HotRegionSlotSize;
+    if (Prev)
+      Prev->NewPadding += Slots;
+    else
+      LeadingPadding += Slots;
+    Offset += Slots;
+    AfterTrampoline = true;
+  };
+  auto NextEnd = SegmentEnds.begin();
+  for (size_t P = 0, PE = FunctionOrder.size(); P != PE; ++P) {
+    CloseRegion(P);
+    for (; NextEnd != SegmentEnds.end() && *NextEnd == P; ++NextEnd)
+      PlaceColdParts(P);
+    OpenRegion(P);
+    const Function &F = Functions[FunctionOrder[P]];
+    bool ObjectStart = ObjectUnits && Realign &&
+                       FunctionOrder[P] == Objects[F.Object].FirstFunction;
+    if (!Trampolines.empty() && !movesWithPrevious(P)) {
+      uint64_t MaxSize = ObjectStart
+                             ? (1ULL << ObjectAlignLog2[F.Object]) - 1
+                             : 0;
+      size_t Q = P;
+      do
+        MaxSize += getMaxPlacedSize(FunctionOrder[Q++], false);
+      while (Q != PE && movesWithPrevious(Q));
+      SkipTrampolines(MaxSize);
+    }
+    if (ObjectStart) {
+      // Congruent to its old place up to its largest alignment
+      uint64_t Mask = (1ULL << ObjectAlignLog2[F.Object]) - 1;
+      uint64_t Pad = (BBLs[F.FirstBBL].OldOffset - Offset) & Mask;
+      if (Prev)
+        Prev->NewPadding += Pad;
+      else
+        LeadingPadding += Pad;
+      Offset += Pad;
+    }
+    for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs - F.NumColdSlots;
+         I != E; ++I)
+      Place(I, F.Hotness == HOT_Hot);
+  }
+  CloseRegion(FunctionOrder.size());
+  for (; NextEnd != SegmentEnds.end(); ++NextEnd)
+    PlaceColdParts(FunctionOrder.size());
+  NewEnd = Offset;
+  Stats.NewHotSpan = HotEnd > HotBegin ? HotEnd - HotBegin : 0;
+  if (HugePageSize)
+    countHotHugePages();
+}
+
+// The hot BBLs are visited in ascending new offsets, thus a page is counted
+// by the first one on it
+void Layout::countHotHugePages() {
+  uint64_t HotBytes = 0, Pages = 0, NextPage = 0; // The first one not counted
+  for (unsigned FuncIdx : FunctionOrder) {
+    const Function &F = Functions[FuncIdx];
+    if (F.Hotness != HOT_Hot)
+      continue;
+    for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs - F.NumColdSlots;
+         I != E; ++I) {
+      const BasicBlock &BBL = BBLs[BBLOrder[I]];
+      uint64_t Size = getCodeSize(BBL) + BBL.Growth;
+      if (!Size)
+        continue;
+      uint64_t Addr = AlignBase + BBL.NewOffset;
+      uint64_t First = std::max(Addr / HugePageSize, NextPage);
+      uint64_t Last = (Addr + Size - 1) / HugePageSize;
+      if (Last >= First) {
+        Pages += Last - First + 1;
+        NextPage = Last + 1;
+      }
+      HotBytes += Size;
+    }
+  }
+  Stats.NumHotHugePages = Pages;
+  Stats.MinHotHugePages = divideCeil(HotBytes, HugePageSize);
+}
+
+bool Layout::isHotFunction(unsigned FuncIdx) const {
+  const Function &F = Functions[FuncIdx];
+  if (F.Startup || F.Hotness == HOT_Hot)
+    return true;
+  return hasProfile() &&
+         std::any_of(Counts.begin() + F.FirstBBL,
+                     Counts.begin() + F.FirstBBL + F.NumBBLs,
+                     [](uint64_t Count) { return Count != 0; });
+}
+
+std::pair<uint64_t, uint64_t> Layout::getNewRange(unsigned FuncIdx,
+                                                  bool Cold) const {
+  const Function &F = Functions[FuncIdx];
+  unsigned First = F.FirstBBL, Last = F.FirstBBL + F.NumBBLs;
+  if (Cold)
+    First = Last - F.NumColdSlots;
+  else
+    Last -= F.NumColdSlots;
+  if (First == Last)
+    return {0, 0};
+  const BasicBlock &B = BBLs[BBLOrder[First]], &E = BBLs[BBLOrder[Last - 1]];
+  return {B.NewOffset, E.NewOffset + getCodeSize(E) + E.Growth};
+}
+
+void Layout::setObjectUnits(bool Enable) {
+  ObjectUnits = Enable;
+  ObjectAlignLog2.assign(Enable ? Objects.size() : 0, 0);
+  for (unsigned I = 0, E = ObjectAlignLog2.size(); I != E; ++I) {
+    const ObjectRange &Obj = Objects[I];
+    if (!Obj.NumFunctions)
+      continue;
+    const Function &Last = Functions[Obj.FirstFunction + Obj.NumFunctions - 1];
+    for (unsigned J = Functions[Obj.FirstFunction].FirstBBL,
+                  JE = Last.FirstBBL + Last.NumBBLs;
+         J != JE; ++J)
+      ObjectAlignLog2[I] = std::max(ObjectAlignLog2[I], BBLs[J].AlignLog2);
+  }
+}
+
+uint64_t Layout::getUnitSize(std::pair<unsigned, unsigned> Unit) const {
+  const Function &Last = Functions[Unit.first + Unit.second - 1];
+  const BasicBlock &End = BBLs[Last.FirstBBL + Last.NumBBLs - 1];
+  return End.OldOffset + End.Size - BBLs[Functions[Unit.first].FirstBBL].OldOffset;
+}
+
+uint64_t Layout::getChainSize(const Chain &C) const {
+  return BBLs[C.Last].OldOffset + BBLs[C.Last].Size - BBLs[C.First].OldOffset;
+}
+
+// Koo: A window takes the consecutive items (units, runs of them, or chains)
+// up to ShuffleWindow bytes, at least one; the first one takes what is left
+// of a window after the phase, so that no boundary is the same for every
+// seed. Without a window, a single one takes all the items and the stream
+// is not drawn from.
+void Layout::forEachWindow(size_t N, RandomStream &RS,
+                           function_ref<uint64_t(size_t)> SizeOf,
+                           function_ref<void(size_t, size_t)> Fn) const {
+  if (!ShuffleWindow) {
+    Fn(0, N);
+    return;
+  }
+  uint64_t Bytes = RS.below((uint32_t)std::min<uint64_t>(ShuffleWindow, UINT32_MAX));
+  for (size_t First = 0, Last = 0; First < N; First = Last, Bytes = 0) {
+    for (; Last < N; ++Last) {
+      uint64_t Size = SizeOf(Last);
+      if (Last > First && Bytes + Size > ShuffleWindow)
+        break;
+      Bytes += Size;
+    }
+    Fn(First, Last);
+  }
+}
+
+void Layout::setRealign(bool Enable, uint64_t TextAddr) {
+  Realign = Enable && MaxAlignLog2 > 0;
+  AlignBase = TextAddr;
+  assignNewOffsets();
+}
+
+int64_t Layout::getGrowthBefore(unsigned Idx, uint64_t OldOffset) const {
+  int64_t Growth = 0;
+  for (const auto &Site : GrowthSites.find(Idx)->second) {
+    if (Site.first >= OldOffset)
+      break;
+    Growth += Site.second;
+  }
+  return Growth;
+}
+
+// A site goes once its bytes net to zero (a shrink undone), and the BBL is no
+// longer resized once it has none
+void Layout::resizeBasicBlock(unsigned Idx, uint64_t OldOffset, int32_t Bytes) {
+  assert(OldOffset >= BBLs[Idx].OldOffset &&
+         OldOffset < BBLs[Idx].OldOffset + BBLs[Idx].Size && "Not in the BBL!");
+  auto &Sites = GrowthSites[Idx];
+  auto It = std::lower_bound(Sites.begin(), Sites.end(), OldOffset,
+                             [](const std::pair<uint64_t, int32_t> &Site,
+                                uint64_t Offset) { return Site.first < Offset; });
+  if (It != Sites.end() && It->first == OldOffset) {
+    It->second += Bytes;
+    if (!It->second)
+      Sites.erase(It);
+  } else {
+    Sites.insert(It, std::make_pair(OldOffset, Bytes));
+  }
+  BBLs[Idx].Growth += Bytes;
+  BBLs[Idx].Resized = !Sites.empty();
+  if (Sites.empty())
+    GrowthSites.erase(Idx);
+}
+
+void Layout::growBasicBlock(unsigned Idx, uint64_t OldOffset, uint32_t Bytes) {
+  resizeBasicBlock(Idx, OldOffset, (int32_t)Bytes);
+  TotalGrowth += Bytes;
+  Stats.NumRelaxedBranches++;
+}
+
+void Layout::shrinkBasicBlock(unsigned Idx, uint64_t OldOffset, uint32_t Bytes) {
+  resizeBasicBlock(Idx, OldOffset, -(int32_t)Bytes);
+  TotalShrinkage += Bytes;
+  Stats.NumShrunkBranches++;
+}
+
+void Layout::unshrinkBasicBlock(unsigned Idx, uint64_t OldOffset,
+                                uint32_t Bytes) {
+  resizeBasicBlock(Idx, OldOffset, (int32_t)Bytes);
+  TotalShrinkage -= Bytes;
+  Stats.NumShrunkBranches--;
+}
+
+// A chain ends with a BBL that cannot fall through; the entry chain stays
+// first, and a trailing chain that falls out of the function (NumFixed) stays
+// last. A chain is as hot as its hottest BBL.
+//
+// Koo: Along the chains of MachineBlockPlacement, a chain only ends where
+// the placement began a new one, unless the edge into it is the likely
+// one; the hot path that the placement laid out then stays in one piece.
+std::vector<Layout::Chain> Layout::buildChains(unsigned FuncIdx,
+                                               unsigned &NumFixed) const {
+  const Function &F = Functions[FuncIdx];
+  std::vector<Chain> Chains;
+  unsigned ChainBegin = F.FirstBBL, Bucket = 2;
+  bool AlongPlacement = PlacementChains && F.PlacementChains;
+  for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs; I != E; ++I) {
+    Bucket = HotColdBuckets ? std::min(Bucket, getBucket(BBLs[I].Hotness)) : 1;
+    if (BBLs[I].FallThrough && I + 1 != E)
+      continue;
+    if (AlongPlacement && I + 1 != E &&
+        (!BBLs[I + 1].ChainStart || BBLs[I].EdgeProb >= 8))
+      continue;
+    Chains.push_back({ChainBegin, I, Bucket});
+    ChainBegin = I + 1;
+    Bucket = 2;
+  }
+  NumFixed = BBLs[F.FirstBBL + F.NumBBLs - 1].FallThrough ? 1 : 0;
+  return Chains;
+}
+
+void Layout::shuffleBBLs(unsigned FuncIdx, RandomStream &RS) {
+  Function &F = Functions[FuncIdx];
+  unsigned NumFixed;
+  std::vector<Chain> Chains = buildChains(FuncIdx, NumFixed);
+  F.NumChains = Chains.size();
+  if (Chains.size() < 2 + NumFixed)
+    return;
+
+  // Group the movable chains by bucket (hot first), then permute each group
+  auto First = Chains.begin() + 1, Last = Chains.end() - NumFixed;
+  std::stable_sort(First, Last, [](const Chain &A, const Chain &B) {
+    return A.Bucket < B.Bucket;
+  });
+  F.NumMovedChains = Last - First;
+  F.ChainEntropyBits = 0;
+  for (auto Group = First; Group != Last;) {
+    unsigned GroupBucket = Group->Bucket;
+    auto GroupEnd = std::find_if(Group, Last, [&](const Chain &C) {
+      return C.Bucket != GroupBucket;
+    });
+    forEachWindow(
+        GroupEnd - Group, RS, [&](size_t C) { return getChainSize(Group[C]); },
+        [&](size_t WFirst, size_t WLast) {
+          ccr::shuffle(Group + WFirst, Group + WLast, RS);
+          F.ChainEntropyBits += log2Factorial(WLast - WFirst);
+        });
+    Group = GroupEnd;
+  }
+
+  unsigned Slot = F.FirstBBL;
+  for (const Chain &C : Chains)
+    for (unsigned I = C.First; I <= C.Last; ++I)
+      BBLOrder[Slot++] = I;
+}
+
+double Layout::log2Factorial(unsigned N) {
+  return std::lgamma((double)N + 1) / std::log(2.0);
+}
+
+uint64_t Layout::getOldHotSpan() const {
+  uint64_t HotBegin = UINT64_MAX, HotEnd = 0;
+  for (const Function &F : Functions) {
+    if (F.Hotness != HOT_Hot)
+      continue;
+    const BasicBlock &Last = BBLs[F.FirstBBL + F.NumBBLs - 1];
+    HotBegin = std::min(HotBegin, BBLs[F.FirstBBL].OldOffset);
+    HotEnd = Last.OldOffset + Last.Size;
+  }
+  return HotEnd > HotBegin ? HotEnd - HotBegin : 0;
+}
+
+std::vector<Layout::Segment> Layout::buildSegments() {
+  // Standalone assembly lacks precise function boundaries, thus the whole
+  // object moves as a single unit (of unknown hotness); its BBLs may still be
+  // shuffled within each function if they have been split at the terminators. Hot units are packed
+  // at the beginning of the range and cold ones at the end, so the hot code
+  // spans as few pages (and iTLB entries) as possible.
+  //
+  // Koo: A pinned function closes a segment of the range, whose units are
+  // permuted (and bucketed) among themselves; the segment takes the bytes it
+  // took before, thus the pinned function after it stays in place. Without
+  // pinned functions the range is a single segment.
+  //
+  // Koo: The linker groups the input sections of each prefix class (e.g.,
+  // .text.hot.* and .text.unlikely.* of -fprofile-use), thus a segment also
+  // ends where the class changes; the hot and cold code that the compiler
+  // split apart stays apart, and .text.startup stays packed for the startup.
+  //
+  // Koo: The functions of the startup path (see setStartupFunctions()) are a
+  // fourth bucket, permuted among themselves and placed first in their
+  // segment, thus a cold start faults in a contiguous prefix of the code.
+  std::vector<Segment> Segments(1);
+  Segments.back().Begin = Begin;
+  if (!Functions.empty())
+    Segments.back().Class = Functions[0].SectionClass;
+  auto OpenSegment = [&](unsigned FuncIdx) {
+    Segment &Seg = Segments.back();
+    if (!SectionClasses || Functions[FuncIdx].SectionClass == Seg.Class)
+      return;
+    if (Seg.Units[0].size() + Seg.Units[1].size() + Seg.Units[2].size() +
+        Seg.Units[3].size()) {
+      Segments.emplace_back();
+      Segments.back().Begin = BBLs[Functions[FuncIdx].FirstBBL].OldOffset;
+    }
+    Segments.back().Class = Functions[FuncIdx].SectionClass;
+  };
+  for (const ObjectRange &Obj : Objects) {
+    if (Obj.SourceType == SRC_Asm || Obj.SourceType == SRC_AsmBlocks) {
+      OpenSegment(Obj.FirstFunction);
+      Segments.back().Units[1].push_back(
+          std::make_pair(Obj.FirstFunction, Obj.NumFunctions));
+      continue;
+    }
+    // With object units, the functions of the object in a segment are one
+    bool InUnit = false;
+    for (unsigned I = 0; I < Obj.NumFunctions; ++I) {
+      unsigned FuncIdx = Obj.FirstFunction + I;
+      if (Functions[FuncIdx].Pinned) {
+        InUnit = false;
+        Segments.back().Pinned = FuncIdx;
+        const Function &P = Functions[FuncIdx];
+        const BasicBlock &Last = BBLs[P.FirstBBL + P.NumBBLs - 1];
+        Segments.emplace_back();
+        Segments.back().Begin = Last.OldOffset + Last.Size;
+        Segments.back().Class = P.SectionClass;
+        Stats.NumPinnedFunctions++;
+        continue;
+      }
+      size_t NumSegments = Segments.size();
+      OpenSegment(FuncIdx);
+      if (ObjectUnits) {
+        auto &Units = Segments.back().Units[1];
+        if (InUnit && Segments.size() == NumSegments)
+          Units.back().second++;
+        else
+          Units.push_back(std::make_pair(FuncIdx, 1U));
+        InUnit = true;
+        continue;
+      }
+      unsigned Bucket = Functions[FuncIdx].Startup ? 3
+                        : HotColdBuckets ? getBucket(Functions[FuncIdx].Hotness)
+                                         : 1;
+      Segments.back().Units[Bucket].push_back(std::make_pair(FuncIdx, 1U));
+    }
+  }
+  Stats.NumSegments = Segments.size();
+  return Segments;
+}
+
+// Koo: A hot bucket that would straddle one more huge page than its bytes
+// need starts at the next boundary instead, after the first units of the
+// unknown (then the cold) bucket that fit in before it. A unit that ends
+// too far past the boundary is skipped, as long as the hot code still fits
+// in the pages it needs; the old sizes are close enough to the new ones.
+void Layout::placeSegments(std::vector<Segment> &Segments) {
+  FunctionOrder.clear();
+  SegmentEnds.clear();
+  Regions.clear();
+  for (Segment &Seg : Segments) {
+    Stats.NumHotUnits += Seg.Units[0].size();
+    Stats.NumColdUnits += Seg.Units[2].size();
+    Stats.NumStartupUnits += Seg.Units[3].size();
+    std::vector<std::pair<unsigned, unsigned>> Filler;
+    uint64_t HotSize = 0, StartupSize = 0;
+    for (const auto &Unit : Seg.Units[0])
+      HotSize += getUnitSize(Unit);
+    for (const auto &Unit : Seg.Units[3])
+      StartupSize += getUnitSize(Unit);
+    if (HugePageSize && HotSize) {
+      uint64_t Addr = AlignBase + Seg.Begin + StartupSize;
+      uint64_t Gap = alignTo(Addr, HugePageSize) - Addr;
+      uint64_t Slack = alignTo(HotSize, HugePageSize) - HotSize;
+      uint64_t Pages = divideCeil(Addr + HotSize, HugePageSize) -
+                       Addr / HugePageSize;
+      if (Gap && Pages > divideCeil(HotSize, HugePageSize)) {
+        uint64_t Filled = 0;
+        std::vector<std::pair<unsigned, unsigned>> Rest[3];
+        for (unsigned B = 1; B < 3; ++B) {
+          for (const auto &Unit : Seg.Units[B]) {
+            uint64_t Size = getUnitSize(Unit);
+            if (Filled < Gap && Filled + Size <= Gap + Slack) {
+              Filler.push_back(Unit);
+              Filled += Size;
+            } else {
+              Rest[B].push_back(Unit);
+            }
+          }
+        }
+        if (Filled >= Gap) {
+          Seg.Units[1].swap(Rest[1]);
+          Seg.Units[2].swap(Rest[2]);
+        } else {
+          Filler.clear();
+        }
+      }
+    }
+
+    auto Place = [&](ArrayRef<std::pair<unsigned, unsigned>> Units) {
+      for (const auto &Unit : Units)
+        for (unsigned I = 0; I < Unit.second; ++I)
+          FunctionOrder.push_back(Unit.first + I);
+    };
+    Place(Seg.Units[3]);
+    Place(Filler);
+    if (Seg.NumHotRegionUnits) {
+      HotRegion R;
+      R.FirstPos = FunctionOrder.size();
+      Place(makeArrayRef(Seg.Units[0]).take_front(Seg.NumHotRegionUnits));
+      R.EndPos = FunctionOrder.size();
+      R.Functions.assign(FunctionOrder.begin() + R.FirstPos,
+                         FunctionOrder.begin() + R.EndPos);
+      llvm::sort(R.Functions);
+      Stats.NumHotRegionFunctions += R.Functions.size();
+      Regions.push_back(std::move(R));
+      Place(makeArrayRef(Seg.Units[0]).drop_front(Seg.NumHotRegionUnits));
+    } else {
+      Place(Seg.Units[0]);
+    }
+    for (unsigned B = 1; B < 3; ++B)
+      Place(Seg.Units[B]);
+    SegmentEnds.push_back(FunctionOrder.size());
+    if (Seg.Pinned >= 0)
+      FunctionOrder.push_back(Seg.Pinned);
+  }
+}
+
+// Each function runs in a chunk of consecutive ones
+void Layout::forEachFunction(bool Parallel, function_ref<void(size_t)> Fn) {
+  const size_t ChunkSize = 1024;
+  size_t NumChunks = (Functions.size() + ChunkSize - 1) / ChunkSize;
+  auto RunChunk = [&](size_t Chunk) {
+    TimeTraceScope Scope("Functions", [&] { return std::to_string(Chunk); });
+    for (size_t I = Chunk * ChunkSize,
+                E = std::min(Functions.size(), I + ChunkSize);
+         I != E; ++I)
+      Fn(I);
+  };
+  if (Parallel && NumChunks > 1)
+    parallel::for_each_n(parallel::par, (size_t)0, NumChunks, RunChunk);
+  else
+    for (size_t Chunk = 0; Chunk != NumChunks; ++Chunk)
+      RunChunk(Chunk);
+}
+
+// Koo: The key of a unit is the first draw of the stream of its identity,
+// thus the keys of a seed order the units as a shuffle would, and a unit
+// keeps it whatever is added or removed around it
+void Layout::sortByIdentity(MutableArrayRef<std::pair<unsigned, unsigned>> Units,
+                            uint64_t Seed) {
+  std::vector<std::pair<uint64_t, std::pair<unsigned, unsigned>>> Keyed;
+  Keyed.reserve(Units.size());
+  for (const auto &Unit : Units) {
+    uint64_t ID = Functions[Unit.first].StableID;
+    if (!ID) {
+      Stats.NumUnstableUnits++;
+      ID = Unit.first;
+    }
+    RandomStream RS(Seed, RandomStream::stableStream(ID));
+    Keyed.emplace_back(RS(), Unit);
+  }
+  // The same key twice (by the folded stream IDs) falls back to the index
+  llvm::sort(Keyed);
+  for (size_t I = 0; I < Units.size(); ++I)
+    Units[I] = Keyed[I].second;
+}
+
+// Koo: The hot region of a segment takes the leading hot units in the order
+// of the seed of the layout (their bytes count against the budget as they
+// were), thus which functions it holds does not depend on its own seed; that
+// seed only permutes them. The segments draw one after another from its
+// stream as in shuffle().
+void Layout::pickHotRegions(std::vector<Segment> &Segments) {
+  uint64_t Left = HotRegionBudget ? HotRegionBudget : UINT64_MAX;
+  RandomStream RS(HotRegionSeed, RandomStream::unitStream(0));
+  for (Segment &Seg : Segments) {
+    auto &Bucket = Seg.Units[0];
+    size_t N = 0;
+    for (; N < Bucket.size() && Left; ++N) {
+      uint64_t Size = getUnitSize(Bucket[N]);
+      if (Size > Left)
+        break;
+      Left -= Size;
+    }
+    Seg.NumHotRegionUnits = N;
+    ccr::shuffle(Bucket.begin(), Bucket.begin() + N, RS);
+    for (size_t U = 0; U < N; ++U)
+      for (unsigned I = 0; I < Bucket[U].second; ++I)
+        Functions[Bucket[U].first + I].HotRegion = true;
+  }
+}
+
+void Layout::shuffle(uint64_t Seed, unsigned BBLShufflePercent, bool Parallel) {
+  Stats = LayoutStats();
+  Stats.OldHotSpan = getOldHotSpan();
+  std::vector<Segment> Segments = buildSegments();
+  if (hasProfile() || hasCallGraph())
+    clusterUnits(Segments, /*Randomize=*/true);
+
+  // The segments draw one after another from the stream of each bucket; the
+  // units of a call cluster move together. Each window of the bucket (see
+  // setShuffleWindow()) is permuted on its own
+  for (unsigned B = 0; B < 4; ++B) {
+    RandomStream RS(Seed, RandomStream::unitStream(B));
+    for (Segment &Seg : Segments) {
+      auto &Bucket = Seg.Units[B];
+      const std::vector<unsigned> &Clusters = Seg.Clusters[B];
+      Stats.NumUnits += Bucket.size();
+      if (Clusters.empty()) {
+        forEachWindow(
+            Bucket.size(), RS, [&](size_t U) { return getUnitSize(Bucket[U]); },
+            [&](size_t First, size_t Last) {
+              auto Window = MutableArrayRef<std::pair<unsigned, unsigned>>(Bucket).slice(
+                  First, Last - First);
+              if (StableOrder)
+                sortByIdentity(Window, Seed);
+              else
+                ccr::shuffle(Window.begin(), Window.end(), RS);
+              Stats.EntropyBits += log2Factorial(Window.size());
+              Stats.NumShuffleWindows += !Window.empty();
+            });
+        continue;
+      }
+      std::vector<std::pair<unsigned, unsigned>> Runs; // [first unit, count]
+      for (unsigned N : Clusters)
+        Runs.emplace_back(Runs.empty() ? 0 : Runs.back().first +
+                                                 Runs.back().second, N);
+      auto RunSize = [&](size_t R) {
+        uint64_t Size = 0;
+        for (unsigned U = Runs[R].first, UE = U + Runs[R].second; U != UE; ++U)
+          Size += getUnitSize(Bucket[U]);
+        return Size;
+      };
+      forEachWindow(Runs.size(), RS, RunSize, [&](size_t First, size_t Last) {
+        auto Window = MutableArrayRef<std::pair<unsigned, unsigned>>(Runs).slice(
+            First, Last - First);
+        if (StableOrder) {
+          // A cluster is keyed by its first unit: [its function, run]
+          std::vector<std::pair<unsigned, unsigned>> Firsts;
+          for (unsigned R = 0; R < Window.size(); ++R)
+            Firsts.emplace_back(Bucket[Window[R].first].first, R);
+          sortByIdentity(Firsts, Seed);
+          std::vector<std::pair<unsigned, unsigned>> SortedRuns;
+          for (const auto &First : Firsts)
+            SortedRuns.push_back(Window[First.second]);
+          std::copy(SortedRuns.begin(), SortedRuns.end(), Window.begin());
+        } else {
+          ccr::shuffle(Window.begin(), Window.end(), RS);
+        }
+        Stats.EntropyBits += log2Factorial(Window.size());
+        Stats.NumShuffleWindows += !Window.empty();
+      });
+      std::vector<std::pair<unsigned, unsigned>> Shuffled;
+      Shuffled.reserve(Bucket.size());
+      for (const auto &Run : Runs)
+        Shuffled.insert(Shuffled.end(), Bucket.begin() + Run.first,
+                        Bucket.begin() + Run.first + Run.second);
+      Bucket.swap(Shuffled);
+    }
+  }
+
+  // Koo: Replay the epochs up to the current one; each picks its windows of
+  // a bucket (and permutes them) from a stream of its own. A function draws
+  // its chains from the stream of the last epoch that moved it.
+  const size_t EpochWindow = 8;
+  std::vector<unsigned> FunctionEpoch(Epoch ? Functions.size() : 0, 0);
+  for (unsigned K = 1; K <= Epoch; ++K) {
+    for (unsigned B = 0; B < 4; ++B) {
+      RandomStream RS(Seed, RandomStream::epochStream(K, B));
+      for (Segment &Seg : Segments) {
+        auto &Bucket = Seg.Units[B];
+        for (size_t W = 0; W < Bucket.size(); W += EpochWindow) {
+          if (RS.below(100) >= RefreshPercent)
+            continue;
+          auto First = Bucket.begin() + W;
+          auto Last = Bucket.begin() + std::min(Bucket.size(), W + EpochWindow);
+          ccr::shuffle(First, Last, RS);
+          for (auto It = First; It != Last; ++It)
+            for (unsigned I = 0; I < It->second; ++I)
+              FunctionEpoch[It->first + I] = K;
+          if (K == Epoch)
+            Stats.NumRefreshedUnits += Last - First;
+        }
+      }
+    }
+  }
+
+  if (HotRegions)
+    pickHotRegions(Segments);
+  placeSegments(Segments);
+
+  // Each function only writes its own BBL slots
+  auto ShuffleFunction = [&](size_t I) {
+    Function &F = Functions[I];
+    F.NumChains = 0;
+    F.NumMovedChains = 0;
+    F.ChainEntropyBits = 0;
+    for (unsigned J = F.FirstBBL, JE = F.FirstBBL + F.NumBBLs; J != JE; ++J)
+      BBLOrder[J] = J;
+    if (!F.ShuffleBBLs) {
+      splitFunction(I);
+      return;
+    }
+    unsigned FEpoch = Epoch ? FunctionEpoch[I] : 0;
+    RandomStream RS(F.HotRegion ? HotRegionSeed : Seed,
+                    StableOrder && F.StableID
+                        ? RandomStream::stableStream(F.StableID, FEpoch)
+                        : RandomStream::functionStream(I, FEpoch));
+    if (BBLShufflePercent >= 100 || RS.below(100) < BBLShufflePercent)
+      shuffleBBLs(I, RS);
+    splitFunction(I);
+  };
+  forEachFunction(Parallel, ShuffleFunction);
+
+  // Summed in order, thus the statistics do not depend on the scheduling
+  for (const Function &F : Functions) {
+    Stats.NumChains += F.NumChains;
+    if (F.NumMovedChains) {
+      Stats.NumShuffledFunctions++;
+      Stats.EntropyBits += F.ChainEntropyBits;
+    }
+  }
+
+  assignNewOffsets();
+}
+
+void Layout::restoreBBLOrder(ArrayRef<unsigned> FuncIdxs) {
+  for (unsigned FuncIdx : FuncIdxs) {
+    Function &F = Functions[FuncIdx];
+    F.ShuffleBBLs = false;
+    F.SplitCold = false;
+    F.NumColdSlots = 0;
+    if (F.NumMovedChains) {
+      Stats.NumRestoredFunctions++;
+      Stats.EntropyBits -= F.ChainEntropyBits;
+      F.NumMovedChains = 0;
+      F.ChainEntropyBits = 0;
+    }
+    for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs; I != E; ++I) {
+      BBLOrder[I] = I;
+      BBLs[I].ColdPart = false;
+    }
+  }
+  assignNewOffsets();
+}
+
+// Koo: A chain is cold by the profile if none of its BBLs ran (in a function
+// that did), else if all of its BBLs are cold by .rand. The slots hold whole
+// chains, thus the cold ones move to the end of the function, in the order
+// they were shuffled, and out of it into the cold region.
+void Layout::splitFunction(unsigned FuncIdx) {
+  Function &F = Functions[FuncIdx];
+  unsigned First = F.FirstBBL, End = F.FirstBBL + F.NumBBLs;
+  F.NumColdSlots = 0;
+  for (unsigned I = First; I != End; ++I)
+    BBLs[I].ColdPart = false;
+  if (!F.SplitCold)
+    return;
+  if (hasProfile() &&
+      std::all_of(Counts.begin() + First, Counts.begin() + End,
+                  [](uint64_t Count) { return Count == 0; }))
+    return;
+  unsigned NumFixed;
+  std::vector<Chain> Chains = buildChains(FuncIdx, NumFixed);
+  bool AnyCold = false;
+  // The entry chain stays first and a trailing one last
+  for (unsigned C = 1, CE = Chains.size() - NumFixed; C < CE; ++C) {
+    bool Cold = true;
+    for (unsigned I = Chains[C].First; I <= Chains[C].Last && Cold; ++I)
+      Cold = hasProfile() ? Counts[I] == 0 : BBLs[I].Hotness == HOT_Cold;
+    if (!Cold)
+      continue;
+    for (unsigned I = Chains[C].First; I <= Chains[C].Last; ++I)
+      BBLs[I].ColdPart = true;
+    AnyCold = true;
+  }
+  if (!AnyCold)
+    return;
+  std::stable_partition(BBLOrder.begin() + First, BBLOrder.begin() + End,
+                        [&](unsigned I) { return !BBLs[I].ColdPart; });
+  for (unsigned I = First; I != End; ++I)
+    F.NumColdSlots += BBLs[I].ColdPart;
+}
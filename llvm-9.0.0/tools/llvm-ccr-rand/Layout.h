@@ -0,0 +1,541 @@
+//===- Layout.h - Function/BBL layout of a CCR-annotated binary -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The layout groups the BBLs of the .rand section into functions and
+// objects, computes a randomized order and translates old .text offsets into
+// new ones. All offsets are relative to the start of the .text section.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_LAYOUT_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_LAYOUT_H
+
+#include "RandInfo.h"
+#include "RandomStream.h"
+#include "TranslationMap.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+
+struct BasicBlock {
+  uint64_t OldOffset = 0;
+  uint64_t NewOffset = 0;
+  uint32_t Size = 0;
+  int32_t Growth = 0; // Bytes added by relaxed branches, less shrunk ones
+  bool Resized = false; // Has relaxed or shrunk branches (see GrowthSites)
+  uint32_t Padding = 0; // Trailing alignment NOPs, dropped when re-aligning
+  uint32_t NewPadding = 0; // NOPs after the BBL in the new layout
+  uint8_t Hotness = HOT_Unknown;
+  uint8_t AlignLog2 = 0;
+  bool FallThrough = false;
+  bool LoopHeader = false;
+  bool ChainStart = false; // MachineBlockPlacement began a chain here
+  bool ColdPart = false;   // Moved to the cold region of its segment
+  uint8_t EdgeProb = 0;    // Of the edge into the next BBL, in 15ths
+  uint8_t TermSize = 0;    // Of the last instruction, before the padding
+  uint8_t TermKind = TK_None;
+  uint8_t BoundarySize = 0; // An instruction kept clear of 2^BoundaryLog2 boundaries,
+  uint8_t BoundaryLog2 = 0; // ... BoundaryOffset bytes into the BBL (0 if none)
+  uint32_t BoundaryOffset = 0;
+  bool Slidable = false; // May start within the padding after it (see setPaddingSlides())
+  unsigned Function = 0;
+};
+
+struct Function {
+  unsigned FirstBBL = 0;
+  unsigned NumBBLs = 0;
+  unsigned Object = 0;
+  uint8_t Hotness = HOT_Unknown; // Hot if any BBL is, cold if all BBLs are
+  bool ShuffleBBLs = false; // BBL-level reordering is allowed in this function
+  bool Splittable = false; // Its chains may move apart (no CFI past the entry)
+  bool SplitCold = false; // Its cold chains go to the cold region (see setSplitFunctions())
+  unsigned NumColdSlots = 0; // The trailing BBL slots placed there
+  bool Pinned = false; // Stays at its old offset (ccr_granularity("none"))
+  uint64_t StableID = 0; // Its name (or content) hash in .rand, if recorded
+  bool PlacementChains = false; // Its BBLs tell the chains of the placement
+  uint8_t SectionClass = SC_Text; // Of its input section (.text.hot etc.)
+  bool Startup = false; // On the startup path (see setStartupFunctions())
+  bool HotRegion = false; // Permuted by the seed of the hot region (see setHotRegion())
+  unsigned NumChains = 0; // Fall-through chains, if BBL shuffling was tried
+  unsigned NumMovedChains = 0; // Chains permuted by the current shuffle
+  double ChainEntropyBits = 0; // What the permutation of the chains bought
+};
+
+// What a shuffle bought and cost. Fall-through chains are never split, thus
+// no jump has to be inserted; the entropy is log2 of the number of layouts
+// the shuffle could have picked.
+struct LayoutStats {
+  unsigned NumUnits = 0;             // Functions (or asm objects) permuted
+  unsigned NumHotUnits = 0;          // ... kept in the hot bucket
+  unsigned NumColdUnits = 0;         // ... kept in the cold bucket
+  unsigned NumStartupUnits = 0;      // ... packed first for the startup
+  unsigned NumPinnedFunctions = 0;   // Kept in place, splitting the range
+  unsigned NumSegments = 0;          // Permuted apart (by pins, section classes)
+  unsigned NumChains = 0;            // Fall-through chains in all functions
+  unsigned NumShuffledFunctions = 0; // Functions with their chains permuted
+  unsigned NumRestoredFunctions = 0; // Put back in order for short branches
+  unsigned NumInsertedJumps = 0;
+  unsigned NumRelaxedBranches = 0;   // Short branches grown to long ones
+  unsigned NumShrunkBranches = 0;    // Long branches back to short ones
+  unsigned NumAlignedBBLs = 0;       // Re-aligned at their new places
+  unsigned NumAlignedLoopHeaders = 0;
+  unsigned NumSlidBBLs = 0;          // Started later within their padding
+  uint64_t SlideBytes = 0;           // ... by that many bytes in all
+  unsigned NumPackedBBLs = 0;        // Of cold code, no longer aligned
+  uint64_t PackedBytes = 0;          // ... the padding they went without
+  unsigned NumBoundaryPadded = 0;    // Padded to keep an instruction clear of a boundary
+  uint64_t BoundaryPadBytes = 0;     // ... by that many bytes in all
+  unsigned NumTrampolines = 0;       // Entries kept for exported functions
+  uint64_t TrampolineGapBytes = 0;   // ... the bytes the units skipped for them
+  unsigned NumRefreshedUnits = 0;    // Moved by the last epoch
+  unsigned NumUnstableUnits = 0;     // Placed by index for want of an identity
+  unsigned NumClusteredUnits = 0;    // Merged into call-chain clusters (C3)
+  unsigned NumSplitFunctions = 0;    // With their cold chains moved away
+  uint64_t ColdPartBytes = 0;        // ... that many bytes of them
+  unsigned NumHotRegionFunctions = 0; // In the per-process hot regions
+  uint64_t HotRegionBytes = 0;       // ... the bytes reserved for them
+  unsigned NumShuffleWindows = 0;    // The units were permuted within (see setShuffleWindow())
+  unsigned NumHotHugePages = 0;      // Huge pages the hot functions touch
+  unsigned MinHotHugePages = 0;      // ... at the least, by their bytes
+  uint64_t OldHotSpan = 0;           // Bytes from the first hot BBL to the
+  uint64_t NewHotSpan = 0;           // last one, before and after
+  double EntropyBits = 0;
+};
+
+// A profiled edge of the old layout between two BBLs: a branch, a call or a
+// fall-through, taken Count times (see Layout::setProfile()); or a static
+// call of Count sites (see Layout::setCallGraph())
+struct ProfileEdge {
+  unsigned From = 0, To = 0;
+  uint64_t Count = 0;
+};
+
+// The hot region of a segment (see Layout::setHotRegion()): a table of a jump
+// slot per function, then the functions, within Reserve bytes from Begin
+struct HotRegion {
+  size_t FirstPos = 0, EndPos = 0; // Into Layout::functionOrder()
+  uint64_t Begin = 0;              // New offset of the table
+  uint64_t Reserve = 0;
+  std::vector<unsigned> Functions; // By their slots, in ascending indices
+};
+
+struct ObjectRange {
+  unsigned FirstFunction = 0;
+  unsigned NumFunctions = 0;
+  uint32_t SourceType = 0;
+};
+
+class Layout {
+  std::vector<BasicBlock> BBLs;
+  std::vector<Function> Functions;
+  std::vector<ObjectRange> Objects;
+  uint64_t Begin = 0, End = 0; // Randomizable range [Begin, End) of .text
+  bool HotColdBuckets = true;
+  bool PlacementChains = false;
+  bool SectionClasses = true; // Permute every class of input sections apart
+
+  // Re-randomization epochs (see setEpoch())
+  unsigned Epoch = 0;
+  unsigned RefreshPercent = 100;
+
+  // Re-align the BBLs at their new places (addresses are AlignBase + offset)
+  bool Realign = false;
+  uint64_t AlignBase = 0;
+  unsigned MaxAlignLog2 = 0;
+  uint64_t LeadingPadding = 0, NewEnd = 0;
+
+  // Slide the BBLs within the padding of the re-aligned ones after them (see
+  // setPaddingSlides())
+  bool SlidePadding = false;
+  uint64_t SlideSeed = 0;
+
+  // Permute the input objects as they are (see setObjectUnits()), by the
+  // largest alignment in each
+  bool ObjectUnits = false;
+  std::vector<uint8_t> ObjectAlignLog2;
+
+  // Order the units by their identities (see setStableOrder())
+  bool StableOrder = false;
+  void sortByIdentity(MutableArrayRef<std::pair<unsigned, unsigned>> Units,
+                      uint64_t Seed);
+
+  // Permute the units and the chains within windows of this many old bytes
+  // (see setShuffleWindow()); 0 permutes them all at once
+  uint64_t ShuffleWindow = 0;
+  void forEachWindow(size_t N, RandomStream &RS,
+                     function_ref<uint64_t(size_t)> SizeOf,
+                     function_ref<void(size_t, size_t)> Fn) const;
+
+  // Leave the cold code unaligned once re-aligned (see setPackCold())
+  bool PackCold = false;
+  bool isPacked(const BasicBlock &BBL) const;
+
+  // The old offsets of the entry trampolines, which no unit covers (see
+  // setTrampolines()), in ascending order
+  std::vector<uint64_t> Trampolines;
+  unsigned TrampolineSize = 0;
+
+  // Keep the hot code on few huge pages of this size (see setHugePages())
+  uint64_t HugePageSize = 0;
+
+  // Permute the hot units by a seed of their own within regions of fixed
+  // sizes (see setHotRegion())
+  bool HotRegions = false;
+  uint64_t HotRegionSeed = 0;
+  uint64_t HotRegionBudget = 0;
+  std::vector<uint32_t> HotRegionGrowth; // By function
+  std::vector<ccr::HotRegion> Regions;
+  DenseMap<uint64_t, uint64_t> HotRegionSlots; // Old entry -> new slot offset
+  bool HotRegionOverflow = false;
+  uint64_t getHotRegionReserve(unsigned FuncIdx) const;
+
+  // The new order: functions by index, and within the BBL slots of each
+  // function (FirstBBL .. FirstBBL + NumBBLs) the indices of its BBLs
+  std::vector<unsigned> FunctionOrder;
+  std::vector<unsigned> BBLOrder;
+  // The cold parts of the split functions before FunctionOrder[I] go there,
+  // for every I here: the end of each segment (before its pinned function)
+  std::vector<unsigned> SegmentEnds;
+
+  TranslationMap Map; // Old to new offsets of the current order
+  LayoutStats Stats;
+
+  // The profile of optimize(), sorted by (From, To), and the count of every
+  // BBL (the sum of its incoming edges)
+  std::vector<ProfileEdge> Profile;
+  std::vector<uint64_t> Counts;
+
+  // The direct calls of the .rand fixups, from the BBL of the call site to the
+  // entry of the callee, sorted by (From, To)
+  std::vector<ProfileEdge> CallGraph;
+
+  // The units of a range that shuffle() (or optimize()) orders among
+  // themselves (see buildSegments())
+  struct Segment {
+    // Hot, unknown, cold, startup: [first function, count]
+    std::vector<std::pair<unsigned, unsigned>> Units[4];
+    int Pinned = -1; // The function that follows the units
+    size_t NumHotRegionUnits = 0; // The leading hot units in its hot region
+    uint64_t Begin = 0; // Old offset of its first byte
+    uint8_t Class = SC_Text;
+    // The call clusters of each bucket, by their counts of units, or empty if
+    // every unit moves alone (see clusterUnits())
+    std::vector<unsigned> Clusters[4];
+  };
+
+  // A run of BBLs that never splits (see buildChains())
+  struct Chain {
+    unsigned First, Last, Bucket;
+  };
+
+  // Per resized BBL: (old offset of the relaxed or shrunk instruction, growth
+  // or the negated bytes saved), sorted
+  DenseMap<unsigned, SmallVector<std::pair<uint64_t, int32_t>, 2>> GrowthSites;
+  uint64_t TotalGrowth = 0;
+  uint64_t TotalShrinkage = 0;
+
+  int64_t getGrowthBefore(unsigned Idx, uint64_t OldOffset) const;
+  void resizeBasicBlock(unsigned Idx, uint64_t OldOffset, int32_t Bytes);
+
+  void assignNewOffsets();
+  void countHotHugePages();
+  uint64_t getUnitSize(std::pair<unsigned, unsigned> Unit) const;
+  uint64_t getChainSize(const Chain &C) const;
+  uint64_t getMaxPlacedSize(unsigned FuncIdx, bool Cold) const;
+  bool movesWithPrevious(size_t P) const;
+  uint64_t getOldHotSpan() const;
+  std::vector<Segment> buildSegments();
+  void placeSegments(std::vector<Segment> &Segments);
+  void pickHotRegions(std::vector<Segment> &Segments);
+  std::vector<Chain> buildChains(unsigned FuncIdx, unsigned &NumFixed) const;
+  void shuffleBBLs(unsigned FuncIdx, RandomStream &RS);
+  void forEachFunction(bool Parallel, function_ref<void(size_t)> Fn);
+  void clusterUnits(std::vector<Segment> &Segments, bool Randomize);
+  void orderChains(unsigned FuncIdx);
+  void splitFunction(unsigned FuncIdx);
+  static double log2Factorial(unsigned N);
+
+  // Hot first, then unknown, then cold
+  static unsigned getBucket(uint8_t Hotness) {
+    return Hotness == HOT_Hot ? 0 : Hotness == HOT_Cold ? 2 : 1;
+  }
+
+public:
+  /// Build the layout from the decoded metadata. BBL-level shuffling is
+  /// enabled (if \p ShuffleBBLs) for compiled code only, and not for the
+  /// functions with CFI instructions past their entry chain. With
+  /// \p HotColdBuckets, hot and cold code (by the profile in .rand) is only
+  /// permuted within its own bucket. With \p PlacementChains, the BBLs are
+  /// shuffled by the chains of MachineBlockPlacement (if .rand tells them)
+  /// rather than by the fall-through chains.
+  Layout(const RandInfo &Info, bool ShuffleBBLs, bool HotColdBuckets = true,
+         bool PlacementChains = false);
+
+  ArrayRef<BasicBlock> basicBlocks() const { return BBLs; }
+  ArrayRef<Function> functions() const { return Functions; }
+  ArrayRef<ObjectRange> objects() const { return Objects; }
+  ArrayRef<unsigned> functionOrder() const { return FunctionOrder; }
+  ArrayRef<unsigned> segmentEnds() const { return SegmentEnds; }
+  uint64_t getBegin() const { return Begin; }
+  uint64_t getEnd() const { return End; }
+
+  /// End of the new layout, including the growth and the alignment padding;
+  /// the NOPs before the first BBL are getLeadingPadding() bytes.
+  uint64_t getNewEnd() const { return NewEnd; }
+  uint64_t getLeadingPadding() const { return LeadingPadding; }
+
+  /// Bytes of \p BBL copied to the new layout (before it grows), i.e.,
+  /// without its stale alignment padding when re-aligning.
+  uint32_t getCodeSize(const BasicBlock &BBL) const {
+    return Realign ? BBL.Size - BBL.Padding : BBL.Size;
+  }
+
+  /// Derive the layout of re-randomization \p Epoch of the seed from the one
+  /// of the previous epoch: within each bucket, \p RefreshPercent percent of
+  /// the windows of consecutive units are permuted again (and the functions
+  /// in them draw new chain orders). The other units keep their places, thus
+  /// an update rewrites few pages. Epoch 0 is the plain shuffle. To be called
+  /// before shuffle().
+  void setEpoch(unsigned E, unsigned Percent) {
+    Epoch = E;
+    RefreshPercent = Percent;
+  }
+
+  /// Permute whole input objects rather than functions: the functions of an
+  /// object stay in their order, bucketed as unknown, and a re-aligned object
+  /// starts where its largest alignment congruent to its old place, thus its
+  /// padding (and the distances within it) stays as the compiler laid it out.
+  /// To be called before shuffle().
+  void setObjectUnits(bool Enable);
+
+  /// Order the units of each bucket by a key of the seed and the identity of
+  /// their first function (see FunctionIdentity), and draw the chains of a
+  /// function from a stream of its identity: a function keeps its place among
+  /// the others across builds of the seed, thus a small change of the code
+  /// moves the functions it adds or renames only. A unit without an identity
+  /// is keyed by its index. To be called before shuffle().
+  void setStableOrder(bool Enable) { StableOrder = Enable; }
+
+  /// Keep the \p Size bytes at each of the old offsets \p Offsets (the entries
+  /// of the exported functions) free for a trampoline to the new place of its
+  /// function: a unit that would cover one starts right after it instead, and
+  /// no unit falls through into it. The offsets must be at least \p Size bytes
+  /// apart. Takes effect with the next assignment of the new offsets.
+  void setTrampolines(std::vector<uint64_t> Offsets, unsigned Size) {
+    Trampolines = std::move(Offsets);
+    TrampolineSize = Size;
+  }
+  ArrayRef<uint64_t> trampolines() const { return Trampolines; }
+  unsigned getTrampolineSize() const { return TrampolineSize; }
+
+  /// Keep the hot, unlikely, startup and exit code of the input sections
+  /// (.text.<class>.*) within their classes: the range the linker grouped
+  /// each class into is permuted on its own. To be called before shuffle().
+  void setSectionClasses(bool Enable) { SectionClasses = Enable; }
+
+  /// Permute the units of every bucket, and the chains of every function,
+  /// only within windows of the consecutive ones that took up to \p Bytes of
+  /// the old layout (at least one each, e.g. 4 KB or a huge page): a unit
+  /// moves by less than a window, thus most short branches stay short and
+  /// the code that ran together stays together. The windows start at a phase
+  /// drawn from the stream of the permutation, thus their boundaries slide
+  /// with the seed; the entropy is that of the windows alone. 0 permutes the
+  /// buckets and functions whole. To be called before shuffle().
+  void setShuffleWindow(uint64_t Bytes) { ShuffleWindow = Bytes; }
+
+  /// Start the hot bucket of every segment on a boundary of \p PageSize
+  /// (with the .text address \p TextAddr) if that saves a huge page: units
+  /// of the other buckets, in the order they were shuffled, fill the bytes
+  /// before it. The hot functions are still permuted among themselves only.
+  /// 0 turns it off. To be called before shuffle().
+  void setHugePages(uint64_t PageSize, uint64_t TextAddr) {
+    HugePageSize = PageSize;
+    AlignBase = TextAddr;
+  }
+
+  /// Permute the leading hot units of every segment (in the order of the seed
+  /// of shuffle(), up to \p Budget bytes in all; 0 takes them all) by
+  /// \p Seed instead, within a region whose size does not depend on it: a
+  /// table of a jump slot per function, then the functions, then the padding
+  /// up to their worst case (their alignment, and \p MaxGrowth bytes by
+  /// function for their branches). Every other byte of the layout is that of
+  /// the seed of shuffle() alone, as long as the references into the regions
+  /// from outside go to the slots (see getHotRegionSlot()). To be called
+  /// before shuffle().
+  void setHotRegion(uint64_t Seed, uint64_t Budget,
+                    std::vector<uint32_t> MaxGrowth) {
+    HotRegions = true;
+    HotRegionSeed = Seed;
+    HotRegionBudget = Budget;
+    HotRegionGrowth = std::move(MaxGrowth);
+  }
+  ArrayRef<ccr::HotRegion> hotRegions() const { return Regions; }
+  static const unsigned HotRegionSlotSize = 5; // jmp rel32
+
+  /// The new offset of the slot of the function whose entry is at
+  /// \p OldOffset, if it is in a hot region.
+  Optional<uint64_t> getHotRegionSlot(uint64_t OldOffset) const {
+    auto It = HotRegionSlots.find(OldOffset);
+    if (It == HotRegionSlots.end())
+      return None;
+    return It->second;
+  }
+
+  /// Whether a hot region outgrew its reserve (by more growth than told).
+  bool hasHotRegionOverflow() const { return HotRegionOverflow; }
+
+  /// Permute the functions \p FuncIdxs (those a cold start runs) among
+  /// themselves, ahead of the other units of their segments, whatever their
+  /// hotness. Pinned functions and assembly objects keep their own places.
+  /// To be called before shuffle().
+  void setStartupFunctions(ArrayRef<unsigned> FuncIdxs) {
+    for (unsigned FuncIdx : FuncIdxs)
+      Functions[FuncIdx].Startup = true;
+  }
+
+  /// Move the cold chains (by the profile if any, else by .rand) of the
+  /// functions \p FuncIdxs to the end of their segments, after all of its
+  /// units; the chains never fall through, thus no jump is inserted. Only the
+  /// functions without CFI past their entry chains are split. To be called
+  /// before shuffle() (or optimize()).
+  void setSplitFunctions(ArrayRef<unsigned> FuncIdxs) {
+    for (unsigned FuncIdx : FuncIdxs)
+      Functions[FuncIdx].SplitCold = Functions[FuncIdx].Splittable;
+  }
+
+  /// Whether the function \p FuncIdx runs early or often: on the startup path,
+  /// hot by .rand, or run at all by the profile (if any).
+  bool isHotFunction(unsigned FuncIdx) const;
+
+  /// The new [begin, end) of the function \p FuncIdx, without (or only, if
+  /// \p Cold) its cold part; empty if there is none.
+  std::pair<uint64_t, uint64_t> getNewRange(unsigned FuncIdx, bool Cold) const;
+
+  /// Re-materialize the alignment of every BBL at its new place (with the
+  /// .text address \p TextAddr) instead of copying the old padding along.
+  /// The new offsets are assigned right away.
+  void setRealign(bool Enable, uint64_t TextAddr);
+  bool isRealigned() const { return Realign; }
+
+  /// Once re-aligned, start every slidable BBL right before an aligned one
+  /// later by a share (drawn from \p Seed) of the padding between them, which
+  /// goes before the BBL instead. No aligned boundary moves and no byte is
+  /// added, thus the diversity costs nothing but the NOPs run through. Takes
+  /// effect with the next assignment of the new offsets (e.g. setRealign()).
+  void setPaddingSlides(uint64_t Seed) {
+    SlidePadding = true;
+    SlideSeed = Seed;
+  }
+
+  /// Once re-aligned, drop the alignment of the BBLs of the cold functions
+  /// (by their hotness or their .text.unlikely sections) and of the cold parts
+  /// of the split ones: cold code is packed byte to byte, the hot code keeps
+  /// its alignment. Takes effect with the next assignment of the new offsets.
+  void setPackCold(bool Enable) { PackCold = Enable; }
+
+  bool contains(uint64_t OldOffset) const {
+    return OldOffset >= Begin && OldOffset < End;
+  }
+
+  /// Index of the BBL that contains \p OldOffset, or -1 if outside the range.
+  int findBasicBlock(uint64_t OldOffset) const { return Map.lookup(OldOffset); }
+
+  /// Translate an old .text offset into the randomized one. Offsets outside
+  /// the randomizable range are not moved.
+  uint64_t translate(uint64_t OldOffset) const {
+    int Idx = Map.lookup(OldOffset);
+    return Idx < 0 ? OldOffset : translateWithin(Idx, OldOffset);
+  }
+
+  /// Translate \p OldOffset, known to be within the BBL \p Idx.
+  uint64_t translateWithin(unsigned Idx, uint64_t OldOffset) const {
+    const BasicBlock &BBL = BBLs[Idx];
+    uint64_t NewOffset = BBL.NewOffset + (OldOffset - BBL.OldOffset);
+    return BBL.Resized ? NewOffset + getGrowthBefore(Idx, OldOffset) : NewOffset;
+  }
+
+  /// Grow the BBL \p Idx by \p Bytes for the instruction at \p OldOffset
+  /// (a relaxed branch); the bytes after it move along. relayout() makes the
+  /// new sizes effective.
+  void growBasicBlock(unsigned Idx, uint64_t OldOffset, uint32_t Bytes);
+
+  /// Shrink the BBL \p Idx by \p Bytes for the instruction at \p OldOffset
+  /// (a long branch re-encoded short), or undo that with unshrinkBasicBlock().
+  void shrinkBasicBlock(unsigned Idx, uint64_t OldOffset, uint32_t Bytes);
+  void unshrinkBasicBlock(unsigned Idx, uint64_t OldOffset, uint32_t Bytes);
+
+  void relayout() { assignNewOffsets(); }
+  uint64_t getTotalGrowth() const { return TotalGrowth; }
+  uint64_t getTotalShrinkage() const { return TotalShrinkage; }
+  bool isResized() const { return TotalGrowth || TotalShrinkage; }
+  ArrayRef<std::pair<uint64_t, int32_t>> getGrowthSites(unsigned Idx) const {
+    auto It = GrowthSites.find(Idx);
+    return It == GrowthSites.end() ? ArrayRef<std::pair<uint64_t, int32_t>>()
+                                   : ArrayRef<std::pair<uint64_t, int32_t>>(It->second);
+  }
+
+  const TranslationMap &getTranslationMap() const { return Map; }
+  const LayoutStats &getStats() const { return Stats; }
+
+  /// Shuffle functions (standalone assembly objects move as a single unit),
+  /// and chains of fall-through BBLs within the functions that allow it.
+  /// Only \p BBLShufflePercent percent of those functions (picked at random)
+  /// have their chains permuted, trading entropy for locality. With hot/cold
+  /// buckets, hot units (chains) are placed first and cold ones last.
+  /// A pinned function keeps its offset: the units between two pinned
+  /// functions are permuted among themselves (unless re-aligning or grown
+  /// branches shift the code ahead of it).
+  /// Every bucket and every function draws from a stream of its own (see
+  /// RandomStream.h), thus the functions are shuffled on the thread pool if
+  /// \p Parallel, and the layout of \p Seed does not depend on it.
+  /// Given the calls (of a profile, else of the call graph), each bucket is
+  /// clustered by C3 first and its clusters are permuted as units.
+  void shuffle(uint64_t Seed, unsigned BBLShufflePercent = 100,
+               bool Parallel = false);
+
+  /// Take the edges of a profile of the old layout for optimize(); those of
+  /// the same BBLs are summed up. A BBL counts its incoming edges, or its
+  /// \p Samples (by BBL, if any) where they are more.
+  void setProfile(std::vector<ProfileEdge> Edges,
+                  std::vector<uint64_t> Samples = {});
+  bool hasProfile() const { return !Profile.empty(); }
+
+  /// Take the static direct calls for shuffle() to keep callers and callees
+  /// together; those of the same BBLs are summed up. The calls of a profile
+  /// weigh them instead if there is one.
+  void setCallGraph(std::vector<ProfileEdge> Calls);
+  bool hasCallGraph() const { return !CallGraph.empty(); }
+
+  /// Lay the code out by the profile instead of at random (see
+  /// LayoutOptimizer.cpp): within every segment, the profiled units are
+  /// ordered by call-chain clustering (C3) ahead of the others, which keep
+  /// their order, and the chains of every function that allows BBL shuffling
+  /// by the ext-TSP score of its edges. The entry chain still stays first,
+  /// and the startup and pinned functions keep their places as in shuffle().
+  void optimize(bool Parallel = false);
+
+  /// The ext-TSP score of the profile in the old or the new layout: a
+  /// fall-through counts fully, and a short jump by a share that falls with
+  /// its distance.
+  double getExtTSPScore(bool NewLayout) const;
+
+  /// Put the BBLs of \p FunctionIdxs back in their original order (and their
+  /// cold parts back in place), keeping the functions at their new places.
+  void restoreBBLOrder(ArrayRef<unsigned> FunctionIdxs);
+};
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_LAYOUT_H
@@ -0,0 +1,427 @@
+//===- LayoutOptimizer.cpp - Profile-guided layout of a CCR binary --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Given a profile of the binary (-optimize-layout), the layout puts the
+// code where it runs fastest instead of at random, as a post-link optimizer
+// would: the .rand section tells the function and BBL boundaries, the
+// fall-throughs and every reference to patch, which is all it takes. The
+// order has no entropy; the same patching engine rewrites the binary.
+//
+// The units of every segment are clustered by C3 (the call-chain clustering
+// of HFSort): in descending order of samples, a unit joins the cluster of its
+// heaviest caller unless the cluster outgrows MaxClusterSize or its density
+// drops by more than MaxDensityDegradation. The clusters are placed by
+// density, ahead of the units without samples, which keep their old order.
+//
+// Koo: The randomizer clusters the same way (-cluster-calls) but by the static
+// call graph, unless given a profile: the direct calls are the 4-byte
+// PC-relative .text fixups into function entries, weighted by their number of
+// call sites. The clusters never cross a bucket and are permuted as units,
+// thus a caller shares its pages with its callees, and the entropy is that of
+// the order of the clusters.
+//
+// The chains of a function never split (thus no jump is inserted); they are
+// merged greedily by the gain in the ext-TSP score of the edges between them:
+// a fall-through counts fully, and a forward (backward) jump of up to
+// ForwardDistance (BackwardDistance) bytes by JumpWeight, falling linearly
+// with the distance. The entry chain stays first and a trailing chain that
+// falls out of the function stays last.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Layout.h"
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+static const uint64_t MaxClusterSize = 1 << 20;
+static const double MaxDensityDegradation = 8;
+static const uint64_t ForwardDistance = 1024;
+static const uint64_t BackwardDistance = 640;
+static const double JumpWeight = 0.1;
+// The chains of a larger function keep their order
+static const size_t MaxExtTSPChains = 1024;
+
+static double scoreEdge(uint64_t SrcEnd, uint64_t DstBegin, uint64_t Count) {
+  if (SrcEnd == DstBegin)
+    return Count;
+  if (DstBegin > SrcEnd) {
+    uint64_t Dist = DstBegin - SrcEnd;
+    return Dist > ForwardDistance
+               ? 0
+               : JumpWeight * Count * (1 - (double)Dist / ForwardDistance);
+  }
+  uint64_t Dist = SrcEnd - DstBegin;
+  return Dist > BackwardDistance
+             ? 0
+             : JumpWeight * Count * (1 - (double)Dist / BackwardDistance);
+}
+
+// Sort \p Edges by (From, To) and sum up those of the same BBLs
+static std::vector<ProfileEdge> mergeEdges(std::vector<ProfileEdge> Edges) {
+  llvm::sort(Edges, [](const ProfileEdge &A, const ProfileEdge &B) {
+    return std::tie(A.From, A.To) < std::tie(B.From, B.To);
+  });
+  std::vector<ProfileEdge> Merged;
+  for (const ProfileEdge &E : Edges) {
+    if (!Merged.empty() && Merged.back().From == E.From &&
+        Merged.back().To == E.To)
+      Merged.back().Count += E.Count;
+    else
+      Merged.push_back(E);
+  }
+  return Merged;
+}
+
+void Layout::setProfile(std::vector<ProfileEdge> Edges,
+                        std::vector<uint64_t> Samples) {
+  Profile = mergeEdges(std::move(Edges));
+  Counts.assign(BBLs.size(), 0);
+  for (const ProfileEdge &E : Profile) {
+    assert(E.From < BBLs.size() && E.To < BBLs.size() && "Not a BBL!");
+    Counts[E.To] += E.Count;
+  }
+  assert((Samples.empty() || Samples.size() == BBLs.size()) && "Not by BBL!");
+  for (size_t I = 0, E = Samples.size(); I != E; ++I)
+    Counts[I] = std::max(Counts[I], Samples[I]);
+}
+
+void Layout::setCallGraph(std::vector<ProfileEdge> Calls) {
+  CallGraph = mergeEdges(std::move(Calls));
+  assert(llvm::all_of(CallGraph, [&](const ProfileEdge &E) {
+           return E.To == Functions[BBLs[E.To].Function].FirstBBL;
+         }) && "Not a call!");
+}
+
+double Layout::getExtTSPScore(bool NewLayout) const {
+  double Score = 0;
+  for (const ProfileEdge &E : Profile) {
+    const BasicBlock &Src = BBLs[E.From], &Dst = BBLs[E.To];
+    if (NewLayout)
+      Score += scoreEdge(Src.NewOffset + getCodeSize(Src) + Src.Growth +
+                             Src.NewPadding,
+                         Dst.NewOffset, E.Count);
+    else
+      Score += scoreEdge(Src.OldOffset + Src.Size, Dst.OldOffset, E.Count);
+  }
+  return Score;
+}
+
+// A call is an edge into the entry of a function of another unit (a return
+// lands past the entry of its caller). Without a profile, the samples of a
+// unit are the calls into it. To \p Randomize, the clusters keep to their
+// buckets and are left as they are, for shuffle() to permute.
+void Layout::clusterUnits(std::vector<Segment> &Segments, bool Randomize) {
+  struct Unit {
+    std::pair<unsigned, unsigned> Range; // [first function, count]
+    unsigned Segment, Bucket;
+    uint64_t Size, Samples;
+  };
+  std::vector<Unit> Units;
+  std::vector<int> UnitOf(Functions.size(), -1);
+  for (unsigned S = 0, SE = Segments.size(); S != SE; ++S)
+    for (unsigned B = 0; B < 3; ++B)
+      for (const auto &Range : Segments[S].Units[B]) {
+        for (unsigned I = 0; I < Range.second; ++I)
+          UnitOf[Range.first + I] = Units.size();
+        Units.push_back({Range, S, B, getUnitSize(Range), 0});
+      }
+  if (hasProfile())
+    for (unsigned I = 0, E = BBLs.size(); I != E; ++I)
+      if (Counts[I] && UnitOf[BBLs[I].Function] >= 0)
+        Units[UnitOf[BBLs[I].Function]].Samples += Counts[I];
+
+  // The heaviest caller of every unit (the first one of a tie)
+  std::vector<std::tuple<unsigned, unsigned, uint64_t>> Calls;
+  for (const ProfileEdge &E : hasProfile() ? Profile : CallGraph) {
+    const BasicBlock &Dst = BBLs[E.To];
+    if (E.To != Functions[Dst.Function].FirstBBL)
+      continue;
+    int Caller = UnitOf[BBLs[E.From].Function], Callee = UnitOf[Dst.Function];
+    if (Caller < 0 || Callee < 0 || Caller == Callee ||
+        Units[Caller].Segment != Units[Callee].Segment ||
+        (Randomize && Units[Caller].Bucket != Units[Callee].Bucket))
+      continue;
+    Calls.emplace_back(Callee, Caller, E.Count);
+    if (!hasProfile())
+      Units[Callee].Samples += E.Count;
+  }
+  llvm::sort(Calls);
+  std::vector<int> BestCaller(Units.size(), -1);
+  std::vector<uint64_t> BestWeight(Units.size(), 0);
+  for (size_t I = 0, E = Calls.size(); I != E;) {
+    unsigned Callee = std::get<0>(Calls[I]), Caller = std::get<1>(Calls[I]);
+    uint64_t Weight = 0;
+    for (; I != E && std::get<0>(Calls[I]) == Callee &&
+           std::get<1>(Calls[I]) == Caller;
+         ++I)
+      Weight += std::get<2>(Calls[I]);
+    if (Weight > BestWeight[Callee]) {
+      BestWeight[Callee] = Weight;
+      BestCaller[Callee] = Caller;
+    }
+  }
+
+  // Every unit starts as a cluster of its own (named by its first unit)
+  std::vector<unsigned> ClusterOf(Units.size());
+  std::iota(ClusterOf.begin(), ClusterOf.end(), 0);
+  std::vector<std::vector<unsigned>> Members(Units.size());
+  std::vector<uint64_t> Size(Units.size()), Samples(Units.size());
+  std::vector<unsigned> Hot;
+  for (unsigned U = 0, E = Units.size(); U != E; ++U) {
+    Members[U].push_back(U);
+    Size[U] = Units[U].Size;
+    Samples[U] = Units[U].Samples;
+    if (Samples[U])
+      Hot.push_back(U);
+  }
+  std::stable_sort(Hot.begin(), Hot.end(), [&](unsigned A, unsigned B) {
+    return Units[A].Samples > Units[B].Samples;
+  });
+  auto Density = [](uint64_t Samples, uint64_t Size) {
+    return (double)Samples / std::max<uint64_t>(Size, 1);
+  };
+  for (unsigned U : Hot) {
+    if (BestCaller[U] < 0)
+      continue;
+    unsigned To = ClusterOf[BestCaller[U]], From = ClusterOf[U];
+    if (To == From || Size[To] + Size[From] > MaxClusterSize)
+      continue;
+    if (Density(Samples[To] + Samples[From], Size[To] + Size[From]) *
+            MaxDensityDegradation <
+        Density(Samples[To], Size[To]))
+      continue;
+    for (unsigned M : Members[From]) {
+      ClusterOf[M] = To;
+      Members[To].push_back(M);
+    }
+    Members[From].clear();
+    Size[To] += Size[From];
+    Samples[To] += Samples[From];
+    Stats.NumClusteredUnits++;
+  }
+
+  // Every cluster in the place of its first unit (the units of a bucket are a
+  // run of them)
+  if (Randomize) {
+    for (unsigned S = 0, SE = Segments.size(); S != SE; ++S)
+      for (unsigned B = 0; B < 3; ++B) {
+        Segments[S].Units[B].clear();
+        Segments[S].Clusters[B].clear();
+      }
+    for (unsigned C = 0, E = Units.size(); C != E; ++C) {
+      if (Members[C].empty())
+        continue;
+      Segment &Seg = Segments[Units[C].Segment];
+      for (unsigned M : Members[C])
+        Seg.Units[Units[C].Bucket].push_back(Units[M].Range);
+      Seg.Clusters[Units[C].Bucket].push_back(Members[C].size());
+    }
+    return;
+  }
+
+  // The profiled clusters lead the hot bucket of their segments by density;
+  // the other units keep their buckets and order
+  std::vector<std::vector<unsigned>> Clusters(Segments.size());
+  for (unsigned C = 0, E = Units.size(); C != E; ++C)
+    if (!Members[C].empty() && Samples[C])
+      Clusters[Units[C].Segment].push_back(C);
+  for (unsigned S = 0, SE = Segments.size(); S != SE; ++S) {
+    if (Clusters[S].empty())
+      continue;
+    std::stable_sort(Clusters[S].begin(), Clusters[S].end(),
+                     [&](unsigned A, unsigned B) {
+                       return Density(Samples[A], Size[A]) >
+                              Density(Samples[B], Size[B]);
+                     });
+    std::vector<std::pair<unsigned, unsigned>> Profiled;
+    for (unsigned C : Clusters[S])
+      for (unsigned M : Members[C])
+        Profiled.push_back(Units[M].Range);
+    Segment &Seg = Segments[S];
+    for (unsigned B = 0; B < 3; ++B)
+      Seg.Units[B].erase(
+          std::remove_if(Seg.Units[B].begin(), Seg.Units[B].end(),
+                         [&](const std::pair<unsigned, unsigned> &Range) {
+                           return Units[UnitOf[Range.first]].Samples != 0;
+                         }),
+          Seg.Units[B].end());
+    Profiled.insert(Profiled.end(), Seg.Units[0].begin(), Seg.Units[0].end());
+    Seg.Units[0].swap(Profiled);
+  }
+}
+
+void Layout::orderChains(unsigned FuncIdx) {
+  Function &F = Functions[FuncIdx];
+  unsigned NumFixed;
+  std::vector<Chain> Chains = buildChains(FuncIdx, NumFixed);
+  unsigned N = Chains.size();
+  F.NumChains = N;
+  if (N < 2 + NumFixed || N > MaxExtTSPChains)
+    return;
+
+  // The profiled edges between the chains, by their offsets in the chains
+  unsigned Begin = F.FirstBBL, End = F.FirstBBL + F.NumBBLs;
+  std::vector<unsigned> ChainOf(F.NumBBLs);
+  std::vector<uint64_t> Size(N, 0), Samples(N, 0);
+  for (unsigned C = 0; C != N; ++C)
+    for (unsigned I = Chains[C].First; I <= Chains[C].Last; ++I) {
+      ChainOf[I - Begin] = C;
+      Size[C] += BBLs[I].Size;
+      Samples[C] += Counts[I];
+    }
+  struct ChainEdge {
+    unsigned Src, Dst;
+    uint64_t SrcEnd, DstBegin, Count;
+  };
+  std::vector<ChainEdge> Edges;
+  auto It = std::lower_bound(Profile.begin(), Profile.end(), Begin,
+                             [](const ProfileEdge &E, unsigned BBL) {
+                               return E.From < BBL;
+                             });
+  for (; It != Profile.end() && It->From < End; ++It) {
+    if (It->To < Begin || It->To >= End)
+      continue;
+    unsigned Src = ChainOf[It->From - Begin], Dst = ChainOf[It->To - Begin];
+    if (Src == Dst) // Its distance is fixed
+      continue;
+    uint64_t SrcBase = BBLs[Chains[Src].First].OldOffset;
+    uint64_t DstBase = BBLs[Chains[Dst].First].OldOffset;
+    Edges.push_back({Src, Dst,
+                     BBLs[It->From].OldOffset + BBLs[It->From].Size - SrcBase,
+                     BBLs[It->To].OldOffset - DstBase, It->Count});
+  }
+  if (Edges.empty())
+    return;
+
+  // Merge the pair of clusters (named by their first chains) that gains the
+  // most by one following the other, until none gains
+  std::vector<unsigned> ClusterOf(N);
+  std::iota(ClusterOf.begin(), ClusterOf.end(), 0);
+  std::vector<std::vector<unsigned>> Members(N);
+  std::vector<uint64_t> Pos(N, 0), ClusterSize(Size), ClusterSamples(Samples);
+  for (unsigned C = 0; C != N; ++C)
+    Members[C].push_back(C);
+  int Trailing = NumFixed ? N - 1 : -1;
+  auto MayFollow = [&](unsigned A, unsigned B) {
+    bool BHasTrailing = Trailing >= 0 && ClusterOf[Trailing] == B;
+    return B != ClusterOf[0] && !(Trailing >= 0 && ClusterOf[Trailing] == A) &&
+           !(A == ClusterOf[0] && BHasTrailing);
+  };
+  for (;;) {
+    // The gains of A followed by B, by (A, B)
+    std::vector<std::tuple<unsigned, unsigned, double>> Gains;
+    for (const ChainEdge &E : Edges) {
+      unsigned A = ClusterOf[E.Src], B = ClusterOf[E.Dst];
+      if (A == B)
+        continue;
+      uint64_t SrcEnd = Pos[E.Src] + E.SrcEnd, DstBegin = Pos[E.Dst] + E.DstBegin;
+      // The source before (A, B) or after (B, A) the destination
+      Gains.emplace_back(A, B,
+                         scoreEdge(SrcEnd, ClusterSize[A] + DstBegin, E.Count));
+      Gains.emplace_back(B, A,
+                         scoreEdge(ClusterSize[B] + SrcEnd, DstBegin, E.Count));
+    }
+    llvm::sort(Gains, [](const std::tuple<unsigned, unsigned, double> &X,
+                         const std::tuple<unsigned, unsigned, double> &Y) {
+      return std::make_pair(std::get<0>(X), std::get<1>(X)) <
+             std::make_pair(std::get<0>(Y), std::get<1>(Y));
+    });
+    double BestGain = 0;
+    unsigned BestA = 0, BestB = 0;
+    for (size_t I = 0, E = Gains.size(); I != E;) {
+      unsigned A = std::get<0>(Gains[I]), B = std::get<1>(Gains[I]);
+      double Gain = 0;
+      for (; I != E && std::get<0>(Gains[I]) == A && std::get<1>(Gains[I]) == B;
+           ++I)
+        Gain += std::get<2>(Gains[I]);
+      if (Gain > BestGain && MayFollow(A, B)) {
+        BestGain = Gain;
+        BestA = A;
+        BestB = B;
+      }
+    }
+    if (BestGain <= 0)
+      break;
+    for (unsigned C : Members[BestB]) {
+      Pos[C] += ClusterSize[BestA];
+      ClusterOf[C] = BestA;
+      Members[BestA].push_back(C);
+    }
+    Members[BestB].clear();
+    ClusterSize[BestA] += ClusterSize[BestB];
+    ClusterSamples[BestA] += ClusterSamples[BestB];
+  }
+
+  // The entry cluster first and the trailing one last; between them the
+  // profiled clusters by density, then the others by bucket as they were
+  unsigned EntryCluster = ClusterOf[0];
+  int TrailingCluster = Trailing >= 0 ? (int)ClusterOf[Trailing] : -1;
+  std::vector<unsigned> Middle;
+  for (unsigned C = 0; C != N; ++C)
+    if (!Members[C].empty() && C != EntryCluster && (int)C != TrailingCluster)
+      Middle.push_back(C);
+  std::stable_sort(Middle.begin(), Middle.end(), [&](unsigned A, unsigned B) {
+    if (!ClusterSamples[A] || !ClusterSamples[B]) {
+      if (ClusterSamples[A] || ClusterSamples[B])
+        return ClusterSamples[A] != 0;
+      return Chains[A].Bucket < Chains[B].Bucket;
+    }
+    return (double)ClusterSamples[A] / ClusterSize[A] >
+           (double)ClusterSamples[B] / ClusterSize[B];
+  });
+  std::vector<unsigned> Order(Members[EntryCluster]);
+  for (unsigned C : Middle)
+    Order.insert(Order.end(), Members[C].begin(), Members[C].end());
+  if (TrailingCluster >= 0)
+    Order.insert(Order.end(), Members[TrailingCluster].begin(),
+                 Members[TrailingCluster].end());
+
+  unsigned Slot = F.FirstBBL;
+  F.NumMovedChains = 0;
+  for (unsigned I = 0; I != N; ++I) {
+    F.NumMovedChains += Order[I] != I;
+    const Chain &C = Chains[Order[I]];
+    for (unsigned J = C.First; J <= C.Last; ++J)
+      BBLOrder[Slot++] = J;
+  }
+}
+
+void Layout::optimize(bool Parallel) {
+  assert(hasProfile() && "No profile to optimize the layout by!");
+  Stats = LayoutStats();
+  Stats.OldHotSpan = getOldHotSpan();
+  std::vector<Segment> Segments = buildSegments();
+  for (const Segment &Seg : Segments)
+    for (unsigned B = 0; B < 4; ++B)
+      Stats.NumUnits += Seg.Units[B].size();
+  clusterUnits(Segments, /*Randomize=*/false);
+  placeSegments(Segments);
+
+  // Each function only writes its own BBL slots
+  forEachFunction(Parallel, [&](size_t I) {
+    Function &F = Functions[I];
+    F.NumChains = 0;
+    F.NumMovedChains = 0;
+    F.ChainEntropyBits = 0;
+    for (unsigned J = F.FirstBBL, JE = F.FirstBBL + F.NumBBLs; J != JE; ++J)
+      BBLOrder[J] = J;
+    if (F.ShuffleBBLs)
+      orderChains(I);
+    splitFunction(I);
+  });
+  for (const Function &F : Functions) {
+    Stats.NumChains += F.NumChains;
+    Stats.NumShuffledFunctions += F.NumMovedChains != 0;
+  }
+
+  assignNewOffsets();
+}
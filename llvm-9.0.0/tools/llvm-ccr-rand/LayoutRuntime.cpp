@@ -0,0 +1,135 @@
+//===- LayoutRuntime.cpp - The layout note and its lookup -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The runtime is linked into the profiled services, thus it only uses
+// the (header-only) definitions of the note, and no LLVM library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CCRLayout.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/RandMap.h"
+#include <cstddef>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace llvm;
+
+#ifndef CCR_LAYOUT_CAPACITY
+#define CCR_LAYOUT_CAPACITY (1 << 16)
+#endif
+
+#ifndef CCR_HOT_PAGES_CAPACITY
+#define CCR_HOT_PAGES_CAPACITY 256
+#endif
+
+namespace {
+// The note as the linker sees it: zeroed room but for the capacity, which
+// the randomizer fills in within the file (the header fields are 32-bit
+// words on the little-endian hosts the randomizer supports)
+struct ReservedNote {
+  ELF::Elf64_Nhdr Header;
+  char Name[4];
+  uint32_t Desc[sizeof(ccr::LayoutNoteHeader) / 4];
+  uint8_t Ranges[CCR_LAYOUT_CAPACITY * sizeof(ccr::LayoutNoteRange)];
+};
+
+struct ReservedHotPagesNote {
+  ELF::Elf64_Nhdr Header;
+  char Name[4];
+  uint32_t Desc[sizeof(ccr::HotPagesNoteHeader) / 4];
+  uint8_t Ranges[CCR_HOT_PAGES_CAPACITY * sizeof(ccr::HotPageRange)];
+};
+} // end anonymous namespace
+
+static_assert(offsetof(ReservedNote, Desc) % 8 == 0, "Unaligned note header");
+static_assert(offsetof(ReservedHotPagesNote, Desc) % 8 == 0,
+              "Unaligned note header");
+
+__attribute__((section(".note.ccr.layout"), used, aligned(8)))
+static const ReservedNote LayoutNote = {
+    {4, sizeof(ReservedNote) - offsetof(ReservedNote, Desc),
+     ccr::NT_CCR_LAYOUT},
+    "CCR",
+    {0, 0, CCR_LAYOUT_CAPACITY},
+    {}};
+
+__attribute__((section(".note.ccr.hot_pages"), used, aligned(8)))
+static const ReservedHotPagesNote HotPagesNote = {
+    {4, sizeof(ReservedHotPagesNote) - offsetof(ReservedHotPagesNote, Desc),
+     ccr::NT_CCR_HOT_PAGES},
+    "CCR",
+    {0, 0, CCR_HOT_PAGES_CAPACITY},
+    {}};
+
+// The note is constant to the compiler, which would fold the reads of its
+// zeroes: they go through a pointer it cannot see into instead
+static const ccr::LayoutNoteHeader *getHeader() {
+  const void *P = LayoutNote.Desc;
+  __asm__("" : "+r"(P));
+  const auto *H = static_cast<const ccr::LayoutNoteHeader *>(P);
+  if (H->Signature != ccr::LayoutNoteHeader::MagicSignature ||
+      H->Version != ccr::LayoutNoteHeader::CurrentVersion)
+    return nullptr;
+  return H;
+}
+
+extern "C" int ccr_layout_randomized(void) { return getHeader() != nullptr; }
+
+extern "C" uintptr_t ccr_translate_pc(uintptr_t PC) {
+  const ccr::LayoutNoteHeader *H = getHeader();
+  if (!H)
+    return PC;
+  uintptr_t Bias = reinterpret_cast<uintptr_t>(H) - H->NoteAddr;
+  uintptr_t Text = H->TextAddr + Bias;
+  if (PC < Text)
+    return PC;
+  uintptr_t Offset = PC - Text;
+
+  // The last range that starts at or before Offset
+  const auto *Ranges = reinterpret_cast<const ccr::LayoutNoteRange *>(H + 1);
+  uint32_t Lo = 0, Hi = H->NumRanges;
+  while (Lo < Hi) {
+    uint32_t Mid = Lo + (Hi - Lo) / 2;
+    if (Ranges[Mid].NewOffset <= Offset)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  if (Lo == 0)
+    return PC;
+  const ccr::LayoutNoteRange &R = Ranges[Lo - 1];
+  if (Offset - R.NewOffset < R.Size)
+    return Text + R.OldOffset + (Offset - R.NewOffset);
+  // The gap up to the next range was filled in by the randomizer
+  if (Lo != H->NumRanges)
+    return Text + R.OldOffset + R.Size - 1;
+  return PC;
+}
+
+extern "C" long ccr_prefetch_hot_pages(void) {
+  const void *P = HotPagesNote.Desc;
+  __asm__("" : "+r"(P));
+  const auto *H = static_cast<const ccr::HotPagesNoteHeader *>(P);
+  if (H->Signature != ccr::HotPagesNoteHeader::MagicSignature ||
+      H->Version != ccr::HotPagesNoteHeader::CurrentVersion)
+    return -1;
+  uintptr_t Bias = reinterpret_cast<uintptr_t>(H) - H->NoteAddr;
+  // The pages of the host may be larger than those of the ranges
+  uintptr_t PageSize = sysconf(_SC_PAGESIZE);
+  const auto *Ranges = reinterpret_cast<const ccr::HotPageRange *>(H + 1);
+  long Advised = 0;
+  for (uint32_t I = 0; I < H->NumRanges; ++I) {
+    uintptr_t Begin = (Ranges[I].Addr + Bias) & ~(PageSize - 1);
+    uintptr_t End = (Ranges[I].Addr + Ranges[I].Size + Bias + PageSize - 1) &
+                    ~(PageSize - 1);
+    if (madvise(reinterpret_cast<void *>(Begin), End - Begin, MADV_WILLNEED) == 0)
+      Advised += End - Begin;
+  }
+  return Advised;
+}
@@ -0,0 +1,325 @@
+//===- LoadTime.cpp - Randomize a binary before it runs -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LoadTime.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+RandomizerConfig llvm::ccr::getLoadConfig(const RandomizerConfig &Config,
+                                         ArrayRef<uint8_t> Index) {
+  RandomizerConfig LoadConfig = Config;
+  LoadConfig.Index = Index;
+  LoadConfig.IndexPath.clear();
+  LoadConfig.StatsPath.clear();
+  LoadConfig.RewriteDebugInfo = false;
+  LoadConfig.BBAddrMap = false;
+  return LoadConfig;
+}
+
+Error llvm::ccr::randomizeImage(MutableArrayRef<uint8_t> Image,
+                                ArrayRef<uint8_t> Index,
+                                const RandomizerConfig &Config) {
+  RandomizerConfig LoadConfig = getLoadConfig(Config, Index);
+  Randomizer R(Image, LoadConfig);
+  return R.run();
+}
+
+RandomizerConfig llvm::ccr::getFlagsConfig(uint64_t Seed, unsigned Flags) {
+  RandomizerConfig Config;
+  Config.Seed = Seed;
+  Config.ShuffleBBLs = Flags & CCR_LOAD_SHUFFLE_BBLS;
+  Config.Realign = !(Flags & CCR_LOAD_NO_REALIGN);
+  Config.Parallel = !(Flags & CCR_LOAD_SERIAL);
+  if (Flags & CCR_LOAD_HUGE_PAGES)
+    Config.HugePageSize = 2ULL << 20;
+  Config.StartupLayout = Flags & CCR_LOAD_STARTUP;
+  return Config;
+}
+
+// The address of the program headers in the auxiliary vector less their
+// link-time one
+bool llvm::ccr::getLoadBias(ArrayRef<uint8_t> Image, uint64_t &Bias) {
+#ifdef __linux__
+  using namespace llvm::ELF;
+  const uint64_t AtPhdr = 3; // AT_PHDR
+  uint64_t Phdr = 0, Aux[2];
+  int FD = open("/proc/self/auxv", O_RDONLY | O_CLOEXEC);
+  if (FD < 0)
+    return false;
+  while (!Phdr && read(FD, Aux, sizeof(Aux)) == sizeof(Aux) && Aux[0])
+    if (Aux[0] == AtPhdr)
+      Phdr = Aux[1];
+  close(FD);
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image.data());
+  if (!Phdr || Image.size() < sizeof(Elf64_Ehdr) ||
+      Ehdr->e_phentsize != sizeof(Elf64_Phdr) || Ehdr->e_phoff > Image.size() ||
+      (uint64_t)Ehdr->e_phnum * sizeof(Elf64_Phdr) >
+          Image.size() - Ehdr->e_phoff)
+    return false;
+  const auto *Phdrs =
+      reinterpret_cast<const Elf64_Phdr *>(Image.data() + Ehdr->e_phoff);
+  for (unsigned I = 0; I < Ehdr->e_phnum; ++I)
+    if (Phdrs[I].p_type == PT_LOAD && Phdrs[I].p_offset <= Ehdr->e_phoff &&
+        Ehdr->e_phoff < Phdrs[I].p_offset + Phdrs[I].p_filesz) {
+      Bias = Phdr - (Phdrs[I].p_vaddr + (Ehdr->e_phoff - Phdrs[I].p_offset));
+      return true;
+    }
+#endif
+  return false;
+}
+
+static int reportError(Error E) {
+  WithColor::error(errs(), "ccr-load") << toString(std::move(E)) << "\n";
+  return 1;
+}
+
+int ccr_randomize_image(void *Image, size_t ImageSize, const void *Index,
+                        size_t IndexSize, uint64_t Seed, unsigned Flags) {
+  Error E = randomizeImage(
+      MutableArrayRef<uint8_t>(static_cast<uint8_t *>(Image), ImageSize),
+      ArrayRef<uint8_t>(static_cast<const uint8_t *>(Index), IndexSize),
+      getFlagsConfig(Seed, Flags));
+  return E ? reportError(std::move(E)) : 0;
+}
+
+int ccr_randomize_image_hot_region(void *Image, size_t ImageSize,
+                                   const void *Index, size_t IndexSize,
+                                   uint64_t Seed, uint64_t HotSeed,
+                                   uint64_t HotBudget, unsigned Flags) {
+  RandomizerConfig Config = getFlagsConfig(Seed, Flags);
+  Config.HotRegion = true;
+  Config.HotRegionSeed = HotSeed;
+  Config.HotRegionBudget = HotBudget;
+  Error E = randomizeImage(
+      MutableArrayRef<uint8_t>(static_cast<uint8_t *>(Image), ImageSize),
+      ArrayRef<uint8_t>(static_cast<const uint8_t *>(Index), IndexSize),
+      Config);
+  return E ? reportError(std::move(E)) : 0;
+}
+
+int ccr_patch_loaded_pages(const void *Shared, size_t SharedSize,
+                           const void *Private, size_t PrivateSize,
+                           uint64_t LoadBias) {
+#ifdef __linux__
+  using namespace llvm::ELF;
+  const auto *Old = static_cast<const uint8_t *>(Shared);
+  const auto *New = static_cast<const uint8_t *>(Private);
+  if (SharedSize != PrivateSize || PrivateSize < sizeof(Elf64_Ehdr))
+    return reportError(createStringError(inconvertibleErrorCode(),
+                                         "the images are not of one binary"));
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(New);
+  if (Ehdr->e_phentsize != sizeof(Elf64_Phdr) || Ehdr->e_phoff > PrivateSize ||
+      (uint64_t)Ehdr->e_phnum * sizeof(Elf64_Phdr) > PrivateSize - Ehdr->e_phoff)
+    return reportError(createStringError(inconvertibleErrorCode(),
+                                         "the program headers are truncated"));
+  const uint64_t PageSize = sysconf(_SC_PAGESIZE);
+  const auto *Phdrs = reinterpret_cast<const Elf64_Phdr *>(New + Ehdr->e_phoff);
+  // Nothing is written unless all of it can be: the code would run mixed
+  for (unsigned I = 0; I < Ehdr->e_phnum; ++I) {
+    const Elf64_Phdr &Seg = Phdrs[I];
+    if (Seg.p_type != PT_LOAD || !Seg.p_filesz)
+      continue;
+    if (Seg.p_offset > PrivateSize || Seg.p_filesz > PrivateSize - Seg.p_offset)
+      return reportError(createStringError(inconvertibleErrorCode(),
+                                           "a segment is out of the image"));
+    if ((Seg.p_flags & PF_W) &&
+        memcmp(Old + Seg.p_offset, New + Seg.p_offset, Seg.p_filesz))
+      return reportError(
+          createStringError(inconvertibleErrorCode(),
+                            "a writable segment differs between the images"));
+  }
+  bool Patched = false;
+  for (unsigned I = 0; I < Ehdr->e_phnum; ++I) {
+    const Elf64_Phdr &Seg = Phdrs[I];
+    if (Seg.p_type != PT_LOAD || !Seg.p_filesz || (Seg.p_flags & PF_W))
+      continue;
+    int Prot = (Seg.p_flags & PF_R ? PROT_READ : 0) |
+               (Seg.p_flags & PF_X ? PROT_EXEC : 0);
+    uint64_t End = Seg.p_vaddr + Seg.p_filesz;
+    for (uint64_t Page = alignDown(Seg.p_vaddr, PageSize); Page < End;
+         Page += PageSize) {
+      uint64_t Begin = std::max(Page, Seg.p_vaddr);
+      size_t Bytes = std::min(Page + PageSize, End) - Begin;
+      uint64_t Off = Seg.p_offset + (Begin - Seg.p_vaddr);
+      if (!memcmp(Old + Off, New + Off, Bytes))
+        continue;
+      void *Loaded = reinterpret_cast<void *>(LoadBias + Page);
+      if (mprotect(Loaded, PageSize, PROT_READ | PROT_WRITE)) {
+        if (!Patched)
+          return reportError(
+              createStringError(std::error_code(errno, std::generic_category()),
+                                "mprotect: %s", strerror(errno)));
+        // Some of the code is of the other seed already
+        WithColor::error(errs(), "ccr-load")
+            << "cannot patch the loaded pages: " << strerror(errno) << "\n";
+        abort();
+      }
+      memcpy(reinterpret_cast<void *>(LoadBias + Begin), New + Off, Bytes);
+      Patched = true;
+      if (mprotect(Loaded, PageSize, Prot)) {
+        WithColor::error(errs(), "ccr-load")
+            << "cannot protect the loaded pages: " << strerror(errno) << "\n";
+        abort();
+      }
+    }
+  }
+  return 0;
+#else
+  return reportError(createStringError(inconvertibleErrorCode(),
+                                       "no loaded pages to patch on this host"));
+#endif
+}
+
+// The randomizer refers to its configuration to the end
+struct ccr_lazy_text {
+  RandomizerConfig Config;
+  std::unique_ptr<Randomizer> R;
+};
+
+int ccr_randomize_image_lazy(void *Image, size_t ImageSize, const void *Index,
+                             size_t IndexSize, uint64_t Seed, unsigned Flags,
+                             ccr_lazy_text **Lazy) {
+  auto L = llvm::make_unique<ccr_lazy_text>();
+  L->Config = getLoadConfig(
+      getFlagsConfig(Seed, Flags),
+      ArrayRef<uint8_t>(static_cast<const uint8_t *>(Index), IndexSize));
+  L->Config.LazyText = true;
+  L->R = llvm::make_unique<Randomizer>(
+      MutableArrayRef<uint8_t>(static_cast<uint8_t *>(Image), ImageSize),
+      L->Config);
+  if (Error E = L->R->run())
+    return reportError(std::move(E));
+  *Lazy = L.release();
+  return 0;
+}
+
+void ccr_lazy_text_range(const ccr_lazy_text *Lazy, uint64_t *Addr,
+                         uint64_t *Size) {
+  std::pair<uint64_t, uint64_t> Range = Lazy->R->getTextRange();
+  *Addr = Range.first;
+  *Size = Range.second - Range.first;
+}
+
+void ccr_lazy_text_read(ccr_lazy_text *Lazy, uint64_t Addr, size_t Size,
+                        void *Dest) {
+  Lazy->R->materializeText(Addr, Size, static_cast<uint8_t *>(Dest));
+}
+
+void ccr_lazy_text_free(ccr_lazy_text *Lazy) { delete Lazy; }
+
+#if defined(__linux__) && defined(__NR_userfaultfd)
+// Koo: The faults come one at a time (the faulting thread waits for its
+// page), thus a fault fills the pages after it as well: the code runs on, and
+// the BBLs across the boundaries are copied once. UFFDIO_COPY maps the pages
+// as the mapping allows (i.e., read and execute), thus no page of the text is
+// ever writable, and no mprotect() is needed either.
+static void serveFaults(ccr_lazy_text *Lazy, int FD, uint8_t *Mapping,
+                        uint64_t Addr, size_t Size, unsigned BatchPages) {
+  const size_t PageSize = sysconf(_SC_PAGESIZE);
+  size_t NumPages = Size / PageSize, Missing = NumPages;
+  std::vector<bool> Filled(NumPages);
+  std::vector<uint8_t> Buf(PageSize * BatchPages);
+  while (Missing) {
+    uffd_msg Msg;
+    ssize_t N = read(FD, &Msg, sizeof(Msg));
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N != sizeof(Msg)) {
+      WithColor::error(errs(), "ccr-load")
+          << "cannot read the faults of the lazy text: " << strerror(errno)
+          << "\n";
+      abort();
+    }
+    if (Msg.event != UFFD_EVENT_PAGEFAULT)
+      continue;
+
+    size_t First = (Msg.arg.pagefault.address - (uintptr_t)Mapping) / PageSize;
+    size_t Last = First;
+    while (Last < NumPages && Last - First < BatchPages && !Filled[Last])
+      ++Last;
+    if (Last == First) {
+      // Filled since the fault was raised; wake the faulting thread
+      uffdio_range Wake = {(uintptr_t)Mapping + First * PageSize, PageSize};
+      ioctl(FD, UFFDIO_WAKE, &Wake);
+      continue;
+    }
+    size_t Bytes = (Last - First) * PageSize;
+    Lazy->R->materializeText(Addr + First * PageSize, Bytes, Buf.data());
+    uffdio_copy Copy;
+    Copy.dst = (uintptr_t)Mapping + First * PageSize;
+    Copy.src = (uintptr_t)Buf.data();
+    Copy.len = Bytes;
+    Copy.mode = 0;
+    Copy.copy = 0;
+    if (ioctl(FD, UFFDIO_COPY, &Copy)) {
+      // The faulting threads would wait forever
+      WithColor::error(errs(), "ccr-load")
+          << "cannot fill the lazy text: " << strerror(errno) << "\n";
+      abort();
+    }
+    for (size_t P = First; P != Last; ++P)
+      Filled[P] = true;
+    Missing -= Last - First;
+  }
+  close(FD);
+  delete Lazy;
+}
+#endif
+
+int ccr_lazy_text_serve(ccr_lazy_text *Lazy, void *Mapping, uint64_t Addr,
+                        size_t Size, unsigned BatchPages) {
+#if defined(__linux__) && defined(__NR_userfaultfd)
+  const uint64_t PageSize = sysconf(_SC_PAGESIZE);
+  if (((uintptr_t)Mapping | Addr | Size) % PageSize || !Size)
+    return reportError(createStringError(
+        inconvertibleErrorCode(), "the lazy text mapping is not page-aligned"));
+  int FD = syscall(__NR_userfaultfd, O_CLOEXEC);
+  if (FD < 0)
+    return reportError(
+        createStringError(std::error_code(errno, std::generic_category()),
+                          "userfaultfd: %s", strerror(errno)));
+  uffdio_api API = {UFFD_API, 0, 0};
+  uffdio_register Register;
+  Register.range = {(uintptr_t)Mapping, Size};
+  Register.mode = UFFDIO_REGISTER_MODE_MISSING;
+  if (ioctl(FD, UFFDIO_API, &API) || ioctl(FD, UFFDIO_REGISTER, &Register)) {
+    int Errno = errno;
+    close(FD);
+    return reportError(
+        createStringError(std::error_code(Errno, std::generic_category()),
+                          "cannot register the lazy text: %s",
+                          strerror(Errno)));
+  }
+  std::thread(serveFaults, Lazy, FD, static_cast<uint8_t *>(Mapping), Addr,
+              Size, std::max(1U, BatchPages))
+      .detach();
+  return 0;
+#else
+  return reportError(createStringError(inconvertibleErrorCode(),
+                                       "no userfaultfd on this host"));
+#endif
+}
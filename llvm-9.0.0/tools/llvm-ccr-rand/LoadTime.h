@@ -0,0 +1,141 @@
+//===- LoadTime.h - Randomize a binary before it runs -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Randomizing at install time leaves every process of a host with the
+// same layout until the next install. The load-time engine (libCCRLoadTime)
+// shuffles a fresh copy of the binary for every process instead: a loader
+// (a preload shim, see Preload.cpp, or a custom PT_INTERP) maps the ELF file
+// privately, has it randomized in memory, and runs that copy.
+//
+// The engine is the randomizer of llvm-ccr-rand, less the protobuf decoder:
+// the .rand section is read from its pre-analysed index (see RandIndex.h),
+// built once next to the binary with 'llvm-ccr-rand -index=<bin>.ccridx'.
+// Decoding nothing, a launch costs the permutation and the patching only.
+//
+// A text of hundreds of MB still takes its copying and patching before main.
+// A loader that maps the segments itself may have .text materialized lazily
+// instead: ccr_randomize_image_lazy() patches all but .text, and
+// ccr_lazy_text_serve() fills an anonymous mapping of it page by page on the
+// first touch with userfaultfd, thus a launch costs the code it runs. The
+// pages are filled without ever being writable. The preload shim re-executes
+// its copy, which no fault handler survives; it randomizes the whole image.
+//
+// A layout per process costs the sharing of the code pages. The hot-region
+// mode keeps most of them shared: ccr_randomize_image_hot_region() lays out
+// everything by a seed but the leading hot functions, which a second seed
+// permutes within regions of a fixed size (the references from outside go
+// through a table of jumps in the regions). The images of one seed thus only
+// differ on the pages of the regions (and of what refers into the functions,
+// as .eh_frame does), and ccr_patch_loaded_pages() writes those pages of a
+// private variant over a mapping of the shared one.
+//
+// A long-lived process re-randomizes itself with the runtime of CCRRerand.h,
+// which lays out the binary anew with this engine, off the threads of the
+// service, and swaps the code at a safepoint of its choice.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_LOADTIME_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_LOADTIME_H
+
+#include "Randomizer.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Error.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace llvm {
+namespace ccr {
+
+/// Randomize the ELF file \p Image in place with the mapped \p Index, which
+/// must have been built for its .rand section. Config.Index is ignored.
+Error randomizeImage(MutableArrayRef<uint8_t> Image, ArrayRef<uint8_t> Index,
+                     const RandomizerConfig &Config);
+
+/// The configuration of the C entry points for \p Seed and \p Flags (of
+/// CCR_LOAD_*).
+RandomizerConfig getFlagsConfig(uint64_t Seed, unsigned Flags);
+
+/// \p Config as the engine runs it, with the mapped \p Index.
+RandomizerConfig getLoadConfig(const RandomizerConfig &Config,
+                               ArrayRef<uint8_t> Index);
+
+/// Where the executable of this process, whose file \p Image is (or a copy
+/// with its program headers), is loaded; false if it cannot be told.
+bool getLoadBias(ArrayRef<uint8_t> Image, uint64_t &Bias);
+
+} // end namespace ccr
+} // end namespace llvm
+
+// The entry point for loaders written in C
+enum {
+  CCR_LOAD_SHUFFLE_BBLS = 1 << 0, // Shuffle the BBLs within functions as well
+  CCR_LOAD_NO_REALIGN = 1 << 1,   // Copy the old alignment padding along
+  CCR_LOAD_SERIAL = 1 << 2,       // Do not patch on the thread pool
+  CCR_LOAD_HUGE_PAGES = 1 << 3,   // Keep the hot code on few 2MB pages
+  CCR_LOAD_STARTUP = 1 << 4,      // Pack the startup path at the beginning
+};
+
+/// Returns 0 on success; otherwise the image may have been partially written
+/// and the message is printed to stderr.
+extern "C" int ccr_randomize_image(void *Image, size_t ImageSize,
+                                   const void *Index, size_t IndexSize,
+                                   uint64_t Seed, unsigned Flags);
+
+/// Randomize the image as ccr_randomize_image() does with \p Seed, but the
+/// hot regions (\p HotBudget bytes of hot code in all; 0 takes it all) by
+/// \p HotSeed. The images of a seed differ on the pages of the regions only.
+extern "C" int ccr_randomize_image_hot_region(void *Image, size_t ImageSize,
+                                              const void *Index,
+                                              size_t IndexSize, uint64_t Seed,
+                                              uint64_t HotSeed,
+                                              uint64_t HotBudget,
+                                              unsigned Flags);
+
+/// Write the pages of the read-only segments of the image \p Private where
+/// it differs from \p Shared, the image that is loaded at \p LoadBias (both
+/// of a seed, see ccr_randomize_image_hot_region()), over the loaded ones. To
+/// be called before the code of the regions runs, by the only thread. Fails
+/// if a writable segment differs, which the loader has relocated already.
+extern "C" int ccr_patch_loaded_pages(const void *Shared, size_t SharedSize,
+                                      const void *Private, size_t PrivateSize,
+                                      uint64_t LoadBias);
+
+/// A randomized .text yet to be materialized
+struct ccr_lazy_text;
+
+/// Randomize the image as ccr_randomize_image() does, but leave .text as it
+/// was (the branches are neither straightened nor replaced with their tails).
+/// On success, *Lazy materializes it; the image must outlive it.
+extern "C" int ccr_randomize_image_lazy(void *Image, size_t ImageSize,
+                                        const void *Index, size_t IndexSize,
+                                        uint64_t Seed, unsigned Flags,
+                                        struct ccr_lazy_text **Lazy);
+
+/// The link-time address and the size of .text
+extern "C" void ccr_lazy_text_range(const struct ccr_lazy_text *Lazy,
+                                    uint64_t *Addr, uint64_t *Size);
+
+/// Write the randomized contents of the \p Size bytes at the link-time address
+/// \p Addr (the other sections on them from the image) to \p Dest.
+extern "C" void ccr_lazy_text_read(struct ccr_lazy_text *Lazy, uint64_t Addr,
+                                   size_t Size, void *Dest);
+
+/// Fill the missing pages of the anonymous mapping \p Mapping, which holds the
+/// \p Size bytes at the link-time address \p Addr (all page-aligned), on their
+/// first touch, \p BatchPages pages a fault (those after the faulting one, if
+/// missing). A thread serves the faults until every page has been filled, then
+/// frees \p Lazy. Returns 0 once the thread runs; otherwise *Lazy is left to
+/// the caller and the message is printed to stderr.
+extern "C" int ccr_lazy_text_serve(struct ccr_lazy_text *Lazy, void *Mapping,
+                                   uint64_t Addr, size_t Size,
+                                   unsigned BatchPages);
+
+extern "C" void ccr_lazy_text_free(struct ccr_lazy_text *Lazy);
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_LOADTIME_H
@@ -0,0 +1,128 @@
+//===- MCAExport.cpp - The hot code of a layout as llvm-mca regions -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: What a shuffle mode costs the hot loops can be told without running
+// the workload: -mca-regions disassembles the hot BBLs of every hot function
+// twice, from the old .text in their old order and from the new .text in
+// their new order, into a pair of llvm-mca code regions (<name>@old and
+// <name>@new). The new one holds what the layout changed in the code: the
+// branches relaxed to their long forms, and the alignment NOPs at the new
+// places of the BBLs. Fall-through chains are never split (see Layout.h),
+// thus no jump is inserted. llvm-mca then estimates the cycles per iteration
+// of both, e.g. in benchmarks/ccr-mca/run_ccr_mca.py.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CodeDecoder.h"
+#include "Randomizer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// Print the instructions of \p Code (at \p Addr) to \p OS; false if some
+// bytes do not decode
+static bool printCode(const CodeDecoder &Decoder, ArrayRef<uint8_t> Code,
+                      uint64_t Addr, raw_ostream &OS) {
+  for (uint64_t Offset = 0; Offset < Code.size();) {
+    MCInst Inst;
+    uint64_t Size = Decoder.decode(Code.slice(Offset), Addr + Offset, Inst);
+    if (!Size)
+      return false;
+    Decoder.print(Inst, OS);
+    OS << '\n';
+    Offset += Size;
+  }
+  return true;
+}
+
+Error Randomizer::writeMCARegions(raw_ostream &OS) {
+  std::string Err;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Err);
+  if (!T)
+    return makeError("Cannot export for llvm-mca without the X86 "
+                     "disassembler: " + Err);
+  CodeDecoder Decoder;
+  if (!Decoder.init(*T))
+    return makeError("No MC layer for " + Twine(TripleName));
+
+  // The symbols are patched already: a function is named by the new offset
+  // of its entry, which stays first
+  DenseMap<uint64_t, StringRef> Names;
+  forEachFunctionSymbol([&](StringRef Name, uint64_t Addr) {
+    if (Addr >= Text->Addr && !Name.empty())
+      Names.try_emplace(Addr - Text->Addr, Name);
+  });
+
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  const uint8_t *NewText = getContents(*Text);
+  unsigned NumFunctions = 0, NumUndecodable = 0;
+  SmallVector<unsigned, 16> Hot;
+  std::string Old, New;
+  for (const Function &F : L->functions()) {
+    if (F.Hotness != HOT_Hot)
+      continue;
+    Hot.clear();
+    for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs; I != E; ++I)
+      if (BBLs[I].Hotness == HOT_Hot)
+        Hot.push_back(I);
+    if (Hot.empty())
+      continue;
+
+    // The old order is that of the indices; the new one, of the new offsets
+    Old.clear();
+    raw_string_ostream OldOS(Old);
+    bool Decoded = true;
+    for (unsigned I : Hot) {
+      const BasicBlock &BBL = BBLs[I];
+      Decoded &= printCode(Decoder,
+                           makeArrayRef(OldText.data() + BBL.OldOffset, BBL.Size),
+                           Text->Addr + BBL.OldOffset, OldOS);
+    }
+    llvm::sort(Hot, [&](unsigned A, unsigned B) {
+      return BBLs[A].NewOffset < BBLs[B].NewOffset;
+    });
+    New.clear();
+    raw_string_ostream NewOS(New);
+    for (unsigned I : Hot) {
+      const BasicBlock &BBL = BBLs[I];
+      uint64_t Size = L->getCodeSize(BBL) + BBL.Growth + BBL.NewPadding;
+      Decoded &= printCode(Decoder, makeArrayRef(NewText + BBL.NewOffset, Size),
+                           Text->Addr + BBL.NewOffset, NewOS);
+    }
+    if (!Decoded) {
+      ++NumUndecodable;
+      continue;
+    }
+
+    uint64_t Entry = BBLs[F.FirstBBL].NewOffset;
+    std::string Name = Names.lookup(Entry);
+    if (Name.empty())
+      Name = ("func_" + Twine::utohexstr(Text->Addr + Entry)).str();
+    OS << "# LLVM-MCA-BEGIN " << Name << "@old\n"
+       << OldOS.str() << "# LLVM-MCA-END\n"
+       << "# LLVM-MCA-BEGIN " << Name << "@new\n"
+       << NewOS.str() << "# LLVM-MCA-END\n";
+    ++NumFunctions;
+  }
+
+  if (!NumFunctions && !NumUndecodable)
+    return makeError("No hot functions to export for llvm-mca (the binary "
+                     "was not built with a profile)");
+  if (Config.Verbose)
+    outs() << "llvm-mca regions: " << NumFunctions << " hot functions ("
+           << NumUndecodable << " undecodable skipped)\n";
+  return Error::success();
+}
@@ -0,0 +1,166 @@
+//===- OutputCache.cpp - Content-addressed cache of randomized outputs ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OutputCache.h"
+#include "RandIndex.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA1.h"
+
+using namespace llvm;
+using namespace llvm::object;
+
+// Bumped whenever the same input, seed and options may yield another layout
+static const uint32_t OutputCacheVersion = 1;
+
+static void addInt(SHA1 &Hasher, uint64_t Value) {
+  uint8_t Bytes[8];
+  support::endian::write64le(Bytes, Value);
+  Hasher.update(Bytes);
+}
+
+std::string llvm::ccr::getOutputCacheKey(const ObjectFile &Obj,
+                                         const RandomizerConfig &Config) {
+  StringRef BuildID, Rand;
+  for (const SectionRef &Sec : Obj.sections()) {
+    StringRef Name;
+    if (Sec.getName(Name))
+      continue;
+    if (Name != ".note.gnu.build-id" && Name != ".rand")
+      continue;
+    Expected<StringRef> Contents = Sec.getContents();
+    if (!Contents) {
+      consumeError(Contents.takeError());
+      return "";
+    }
+    (Name == ".rand" ? Rand : BuildID) = *Contents;
+  }
+  if (Rand.empty())
+    Rand = toStringRef(Config.RandSidecar);
+  if (BuildID.empty() || Rand.empty())
+    return "";
+
+  SHA1 Hasher;
+  addInt(Hasher, OutputCacheVersion);
+  addInt(Hasher, BuildID.size());
+  Hasher.update(BuildID);
+  addInt(Hasher, ccr::getRandIndexKey(arrayRefFromStringRef(Rand)));
+  addInt(Hasher, Config.Seed);
+  addInt(Hasher, Config.ShuffleBBLs);
+  addInt(Hasher, Config.BBLShufflePercent);
+  addInt(Hasher, Config.Epoch);
+  addInt(Hasher, Config.RefreshPercent);
+  addInt(Hasher, Config.HotColdBuckets);
+  addInt(Hasher, Config.PlacementChains);
+  addInt(Hasher, Config.SectionClasses);
+  addInt(Hasher, Config.Realign);
+  addInt(Hasher, Config.SlidePadding);
+  addInt(Hasher, Config.PaddingOnly);
+  addInt(Hasher, Config.PackCold);
+  addInt(Hasher, Config.ObjectGranularity);
+  addInt(Hasher, Config.EntryTrampolines);
+  addInt(Hasher, Config.HotRegion);
+  addInt(Hasher, Config.HotRegionSeed);
+  addInt(Hasher, Config.HotRegionBudget);
+  addInt(Hasher, Config.StableOrder);
+  addInt(Hasher, Config.StraightenBranches);
+  addInt(Hasher, Config.ShrinkBranches);
+  addInt(Hasher, Config.TailDupSize);
+  addInt(Hasher, Config.HugePageSize);
+  addInt(Hasher, Config.ShuffleWindow);
+  addInt(Hasher, DoubleToBits(Config.MaxGrowthPercent));
+  addInt(Hasher, Config.NoHotGrowth);
+  addInt(Hasher, Config.StartupLayout);
+  addInt(Hasher, Config.StartupDepth);
+  addInt(Hasher, Config.StartupSymbols.size());
+  for (const std::string &Name : Config.StartupSymbols) {
+    addInt(Hasher, Name.size());
+    Hasher.update(Name);
+  }
+  addInt(Hasher, Config.Profile.size());
+  for (const ProfileRecord &R : Config.Profile) {
+    addInt(Hasher, R.From);
+    addInt(Hasher, R.To);
+    addInt(Hasher, R.Count);
+    addInt(Hasher, R.FallThrough);
+    addInt(Hasher, R.Sampled);
+  }
+  addInt(Hasher, Config.ClusterCalls);
+  addInt(Hasher, Config.SplitFunctions);
+  addInt(Hasher, Config.RewriteDebugInfo);
+  addInt(Hasher, Config.BBAddrMap);
+  addInt(Hasher, Config.SyntheticSites);
+  addInt(Hasher, Config.ShuffleData);
+  addInt(Hasher, Config.DataAffinity.size());
+  for (const std::vector<std::string> &Set : Config.DataAffinity) {
+    addInt(Hasher, Set.size());
+    for (const std::string &Name : Set) {
+      addInt(Hasher, Name.size());
+      Hasher.update(Name);
+    }
+  }
+  return toHex(Hasher.result());
+}
+
+static SmallString<128> getEntryPath(StringRef CacheDir, StringRef Key) {
+  SmallString<128> Path;
+  sys::path::append(Path, CacheDir, "llvmcache-" + Key);
+  return Path;
+}
+
+// Hard-link (or copy, across file systems) \p From to a unique name next to
+// \p To that is then renamed over it, thus \p To is replaced atomically
+std::error_code llvm::ccr::linkOrCopy(const Twine &From, const Twine &To) {
+  SmallString<128> Temp;
+  sys::fs::createUniquePath(To + ".tmp%%%%%%%", Temp, /*MakeAbsolute=*/false);
+  if (sys::fs::create_hard_link(From, Temp)) {
+    if (std::error_code EC = sys::fs::copy_file(From, Temp)) {
+      sys::fs::remove(Temp);
+      return EC;
+    }
+  }
+  if (std::error_code EC = sys::fs::rename(Temp, To)) {
+    sys::fs::remove(Temp);
+    return EC;
+  }
+  return std::error_code();
+}
+
+bool llvm::ccr::fetchCachedOutput(StringRef CacheDir, StringRef Key,
+                                  StringRef Output, StringRef MapPath) {
+  SmallString<128> Entry = getEntryPath(CacheDir, Key);
+  // Opened for the access time, which pruneCache() evicts by
+  int FD;
+  if (sys::fs::openFileForRead(Entry, FD, sys::fs::OF_UpdateAtime))
+    return false;
+  sys::Process::SafelyCloseFileDescriptor(FD);
+  if (!MapPath.empty() && !sys::fs::exists(Entry + ".ccrmap"))
+    return false;
+  if (linkOrCopy(Entry, Output))
+    return false;
+  return MapPath.empty() || !linkOrCopy(Entry + ".ccrmap", MapPath);
+}
+
+Error llvm::ccr::cacheOutput(StringRef CacheDir, StringRef Key,
+                             StringRef Output, StringRef MapPath) {
+  if (std::error_code EC = sys::fs::create_directories(CacheDir))
+    return createFileError(CacheDir, EC);
+  SmallString<128> Entry = getEntryPath(CacheDir, Key);
+  // The map goes first: an entry without its map is a miss for -address-map
+  if (!MapPath.empty())
+    if (std::error_code EC = linkOrCopy(MapPath, Entry + ".ccrmap"))
+      return createFileError(Entry + ".ccrmap", EC);
+  if (std::error_code EC = linkOrCopy(Output, Entry))
+    return createFileError(Entry, EC);
+  return Error::success();
+}
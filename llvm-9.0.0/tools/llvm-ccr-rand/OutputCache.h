@@ -0,0 +1,56 @@
+//===- OutputCache.h - Cache of randomized outputs --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Canaries and rollbacks randomize the same binary with the same seed on
+// many hosts. A randomized output only depends on the input (told by its
+// NT_GNU_BUILD_ID and the hash of its .rand section), the seed and the options
+// that shape the layout, thus it is kept in a cache directory by that key
+// (shared by the hosts, if on a network file system) and an identical
+// request is served by a hard link to the entry, skipping all the work.
+//
+// The entries are named like those of the ThinLTO cache (llvmcache-<key>),
+// thus pruneCache() bounds the directory. An output served from the cache
+// shares its inode with the entry and must not be modified in place.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_OUTPUTCACHE_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_OUTPUTCACHE_H
+
+#include "Randomizer.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Error.h"
+#include <string>
+#include <system_error>
+
+namespace llvm {
+namespace ccr {
+
+/// Key of the output of randomizing \p Obj with \p Config (and its seed), or
+/// empty if the binary has no build ID (or no .rand section) to tell it by.
+std::string getOutputCacheKey(const object::ObjectFile &Obj,
+                              const RandomizerConfig &Config);
+
+/// Replace \p To with a hard link to \p From (a copy across file systems).
+std::error_code linkOrCopy(const Twine &From, const Twine &To);
+
+/// Link the entry \p Key of \p CacheDir to \p Output, and its address map to
+/// \p MapPath unless empty. Returns false on a miss.
+bool fetchCachedOutput(StringRef CacheDir, StringRef Key, StringRef Output,
+                       StringRef MapPath);
+
+/// Publish \p Output (and the address map \p MapPath unless empty) as the
+/// entry \p Key of \p CacheDir.
+Error cacheOutput(StringRef CacheDir, StringRef Key, StringRef Output,
+                  StringRef MapPath);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_OUTPUTCACHE_H
@@ -0,0 +1,202 @@
+//===- PerfMap.cpp - Describe a randomized process to perf ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "PerfMap.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/ExecutionEngine/PerfJITRecords.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::ELF;
+
+// <sys/auxv.h> takes <elf.h>, whose macros clash with llvm/BinaryFormat/ELF.h
+extern "C" unsigned long getauxval(unsigned long Type);
+static const unsigned long AuxProgramHeaders = 3; // AT_PHDR
+
+namespace {
+struct FunctionSymbol {
+  uint64_t Addr;
+  uint64_t Size;
+  StringRef Name;
+  const uint8_t *Code; // In the image
+};
+} // end anonymous namespace
+
+// The sized functions of .symtab (or of .dynsym, if the binary is stripped)
+// in the executable sections
+static std::vector<FunctionSymbol> getFunctions(const uint8_t *Image,
+                                                size_t Size) {
+  std::vector<FunctionSymbol> Funcs;
+  if (Size < sizeof(Elf64_Ehdr) || memcmp(Image, ElfMagic, 4) ||
+      Image[EI_CLASS] != ELFCLASS64 || Image[EI_DATA] != ELFDATA2LSB)
+    return Funcs;
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image);
+  if (Ehdr->e_shentsize != sizeof(Elf64_Shdr) || Ehdr->e_shoff > Size ||
+      (uint64_t)Ehdr->e_shnum * sizeof(Elf64_Shdr) > Size - Ehdr->e_shoff)
+    return Funcs;
+  const auto *Shdrs = reinterpret_cast<const Elf64_Shdr *>(Image + Ehdr->e_shoff);
+  auto InImage = [&](const Elf64_Shdr &Sec) {
+    return Sec.sh_type != SHT_NOBITS && Sec.sh_offset <= Size &&
+           Sec.sh_size <= Size - Sec.sh_offset;
+  };
+
+  for (uint32_t Type : {SHT_SYMTAB, SHT_DYNSYM}) {
+    for (unsigned I = 0; I < Ehdr->e_shnum; ++I) {
+      const Elf64_Shdr &Sec = Shdrs[I];
+      if (Sec.sh_type != Type || !InImage(Sec) || Sec.sh_link >= Ehdr->e_shnum ||
+          !InImage(Shdrs[Sec.sh_link]))
+        continue;
+      const Elf64_Shdr &StrTab = Shdrs[Sec.sh_link];
+      const char *Strings = reinterpret_cast<const char *>(Image + StrTab.sh_offset);
+      const auto *Syms = reinterpret_cast<const Elf64_Sym *>(Image + Sec.sh_offset);
+      for (uint64_t S = 0, E = Sec.sh_size / sizeof(Elf64_Sym); S < E; ++S) {
+        const Elf64_Sym &Sym = Syms[S];
+        if (Sym.getType() != STT_FUNC || !Sym.st_size ||
+            Sym.st_shndx >= Ehdr->e_shnum || Sym.st_name >= StrTab.sh_size)
+          continue;
+        const Elf64_Shdr &Code = Shdrs[Sym.st_shndx];
+        if (!(Code.sh_flags & SHF_EXECINSTR) || !InImage(Code) ||
+            Sym.st_value < Code.sh_addr ||
+            Sym.st_value - Code.sh_addr > Code.sh_size ||
+            Sym.st_size > Code.sh_size - (Sym.st_value - Code.sh_addr))
+          continue;
+        const char *Name = Strings + Sym.st_name;
+        Funcs.push_back({Sym.st_value, Sym.st_size,
+                         StringRef(Name, strnlen(Name, StrTab.sh_size -
+                                                           Sym.st_name)),
+                         Image + Code.sh_offset + (Sym.st_value - Code.sh_addr)});
+      }
+    }
+    if (!Funcs.empty())
+      break;
+  }
+  return Funcs;
+}
+
+// Where the kernel mapped the program headers of the executable, less where
+// they were linked (a PIE), or 0
+static uint64_t getLoadBias(const uint8_t *Image, size_t Size) {
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image);
+  if (Ehdr->e_phentsize != sizeof(Elf64_Phdr) || Ehdr->e_phoff > Size ||
+      (uint64_t)Ehdr->e_phnum * sizeof(Elf64_Phdr) > Size - Ehdr->e_phoff)
+    return 0;
+  const auto *Phdrs = reinterpret_cast<const Elf64_Phdr *>(Image + Ehdr->e_phoff);
+  uint64_t Mapped = getauxval(AuxProgramHeaders);
+  for (unsigned I = 0; I < Ehdr->e_phnum; ++I) {
+    const Elf64_Phdr &Phdr = Phdrs[I];
+    if (Phdr.p_type == PT_PHDR)
+      return Mapped - Phdr.p_vaddr;
+    if (Phdr.p_type == PT_LOAD && Ehdr->e_phoff >= Phdr.p_offset &&
+        Ehdr->e_phoff - Phdr.p_offset < Phdr.p_filesz)
+      return Mapped - (Phdr.p_vaddr + Ehdr->e_phoff - Phdr.p_offset);
+  }
+  return 0;
+}
+
+static uint64_t getTimestamp() {
+  struct timespec TS;
+  if (clock_gettime(CLOCK_MONOTONIC, &TS))
+    return 0;
+  return (uint64_t)TS.tv_sec * 1000000000 + TS.tv_nsec;
+}
+
+static bool writeAll(int FD, StringRef Data) {
+  for (size_t Done = 0; Done < Data.size();) {
+    ssize_t N = write(FD, Data.data() + Done, Data.size() - Done);
+    if (N <= 0)
+      return false;
+    Done += N;
+  }
+  return true;
+}
+
+// The perf map is text: "<start> <size> <name>" in hex, a line a function
+static std::string getPerfMap(ArrayRef<FunctionSymbol> Funcs, uint64_t Bias) {
+  std::string Out;
+  raw_string_ostream OS(Out);
+  for (const FunctionSymbol &F : Funcs)
+    OS << format_hex_no_prefix(F.Addr + Bias, 1) << ' '
+       << format_hex_no_prefix(F.Size, 1) << ' ' << F.Name << '\n';
+  return OS.str();
+}
+
+// A JIT_CODE_LOAD record per function, with its name and code
+static std::string getJitDump(ArrayRef<FunctionSymbol> Funcs, uint64_t Bias,
+                              uint16_t Machine, uint32_t Pid) {
+  uint64_t Timestamp = getTimestamp();
+  std::string Out;
+  LLVMPerfJitHeader Header = {0};
+  Header.Magic = LLVM_PERF_JIT_MAGIC;
+  Header.Version = LLVM_PERF_JIT_VERSION;
+  Header.TotalSize = sizeof(Header);
+  Header.ElfMach = Machine;
+  Header.Pid = Pid;
+  Header.Timestamp = Timestamp;
+  Out.append(reinterpret_cast<const char *>(&Header), sizeof(Header));
+
+  uint64_t CodeIndex = 1;
+  for (const FunctionSymbol &F : Funcs) {
+    LLVMPerfJitRecordCodeLoad Rec;
+    Rec.Prefix.Id = JIT_CODE_LOAD;
+    Rec.Prefix.TotalSize = sizeof(Rec) + F.Name.size() + 1 + F.Size;
+    Rec.Prefix.Timestamp = Timestamp;
+    Rec.Pid = Pid;
+    Rec.Tid = Pid;
+    Rec.Vma = F.Addr + Bias;
+    Rec.CodeAddr = F.Addr + Bias;
+    Rec.CodeSize = F.Size;
+    Rec.CodeIndex = CodeIndex++;
+    Out.append(reinterpret_cast<const char *>(&Rec), sizeof(Rec));
+    Out.append(F.Name.data(), F.Name.size());
+    Out.push_back('\0');
+    Out.append(reinterpret_cast<const char *>(F.Code), F.Size);
+  }
+  return Out;
+}
+
+bool llvm::ccr::writePerfMap(const uint8_t *Image, size_t Size,
+                             const char *JitDumpDir) {
+  std::vector<FunctionSymbol> Funcs = getFunctions(Image, Size);
+  if (Funcs.empty())
+    return false;
+  uint64_t Bias = getLoadBias(Image, Size);
+  uint32_t Pid = getpid();
+
+  std::string Path, Data;
+  if (JitDumpDir) {
+    Path = std::string(JitDumpDir) + "/jit-" + std::to_string(Pid) + ".dump";
+    Data = getJitDump(Funcs, Bias,
+                      reinterpret_cast<const Elf64_Ehdr *>(Image)->e_machine,
+                      Pid);
+  } else {
+    Path = "/tmp/perf-" + std::to_string(Pid) + ".map";
+    Data = getPerfMap(Funcs, Bias);
+  }
+  int FD = open(Path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (FD < 0)
+    return false;
+  bool Written = writeAll(FD, Data);
+  // perf finds a jitdump by the executable mapping of the file, which stays
+  // for the life of the process
+  if (Written && JitDumpDir &&
+      mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE,
+           FD, 0) == MAP_FAILED)
+    Written = false;
+  close(FD);
+  return Written;
+}
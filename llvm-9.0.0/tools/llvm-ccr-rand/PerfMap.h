@@ -0,0 +1,39 @@
+//===- PerfMap.h - Describe a randomized process to perf --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A process that runs a copy randomized at load time (see Preload.cpp)
+// has no file perf can symbolize its samples with: the copy is an anonymous
+// file, or a cached one that the next boot removes. The copy itself knows
+// where its functions went, as the randomizer has patched its symbol table,
+// thus the re-executed process describes them to perf, either in the perf
+// map /tmp/perf-<pid>.map, or in a jitdump <dir>/jit-<pid>.dump (the record
+// formats of the PerfJITEventListener, see llvm/ExecutionEngine/
+// PerfJITRecords.h) that 'perf inject --jit' folds into the profile along
+// with the code.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_PERFMAP_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_PERFMAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace llvm {
+namespace ccr {
+
+/// Describe the functions of the ELF file \p Image (of \p Size bytes), the
+/// executable of this process, in a perf map; or in a jitdump in \p
+/// JitDumpDir, if set. The file is written with a single write(). Returns
+/// false if it cannot be.
+bool writePerfMap(const uint8_t *Image, size_t Size, const char *JitDumpDir);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_PERFMAP_H
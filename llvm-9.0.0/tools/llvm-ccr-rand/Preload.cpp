@@ -0,0 +1,407 @@
+//===- Preload.cpp - Re-execute a binary from a randomized copy -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: LD_PRELOAD=libCCRPreload.so <binary> runs <binary> with a layout of its
+// own. Before the constructors of <binary>, the shim copies the executable
+// into an anonymous file, randomizes it there with the index <binary>.ccridx
+// (or $CCR_INDEX) and re-executes the copy in the same process. Without an
+// index (or on any error) <binary> simply runs as it is.
+//
+// The re-executed copy finds its own pid in $CCR_PRELOAD_PID and drops the
+// variable, thus its children are randomized again. $CCR_SHUFFLE_BBLS=1 adds
+// the BBL-level shuffling, and $CCR_STARTUP_LAYOUT=1 packs the functions of
+// the startup path first (i.e., for short-lived tools). $CCR_PERF_MAP=1 has
+// the copy write /tmp/perf-<pid>.map for perf, and $CCR_PERF_MAP=jitdump a
+// jitdump in $JITDUMPDIR (or /tmp) instead (see PerfMap.h).
+//
+// A layout per process costs the sharing of the code pages among the workers
+// of a prefork server. With $CCR_CACHE_DIR (e.g., on a tmpfs), the binary is
+// randomized once per boot instead: the copy is kept there by the build ID of
+// the binary and the boot ID, and every later process runs that same file.
+//
+// $CCR_HOT_REGION=<bytes> (with $CCR_CACHE_DIR) keeps a layout per process
+// for the hot code: the cached copy is laid out in the hot-region mode (see
+// LoadTime.h), its seed kept next to it in <copy>.seed, and every process
+// that runs it re-randomizes the <bytes> of hot code of the original binary
+// ($CCR_PRELOAD_ORIGIN) privately, writing the pages that differ over the
+// loaded ones. The other pages stay those of the cached file, shared.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LoadTime.h"
+#include "PerfMap.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// An mmap()ed range that is unmapped on every exit path
+struct Mapping {
+  void *Addr = MAP_FAILED;
+  size_t Size = 0;
+
+  Mapping(int FD, size_t Size, int Prot, int Flags) : Size(Size) {
+    if (Size)
+      Addr = mmap(nullptr, Size, Prot, Flags, FD, 0);
+  }
+  ~Mapping() {
+    if (Addr != MAP_FAILED)
+      munmap(Addr, Size);
+  }
+  bool valid() const { return Addr != MAP_FAILED; }
+};
+} // end anonymous namespace
+
+static bool copyFile(int From, int To, size_t Size) {
+  if (ftruncate(To, Size))
+    return false;
+  char Buf[1 << 16];
+  for (size_t Done = 0; Done < Size;) {
+    ssize_t N = read(From, Buf, sizeof(Buf));
+    if (N <= 0)
+      return false;
+    for (ssize_t W = 0; W < N;) {
+      ssize_t M = write(To, Buf + W, N - W);
+      if (M <= 0)
+        return false;
+      W += M;
+    }
+    Done += N;
+  }
+  return true;
+}
+
+// The NT_GNU_BUILD_ID of the ELF file in \p Image in hex, or empty
+static std::string getBuildID(const uint8_t *Image, size_t Size) {
+  using namespace llvm::ELF;
+  if (Size < sizeof(Elf64_Ehdr) || memcmp(Image, ElfMagic, 4) ||
+      Image[EI_CLASS] != ELFCLASS64 || Image[EI_DATA] != ELFDATA2LSB)
+    return "";
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image);
+  if (Ehdr->e_shentsize != sizeof(Elf64_Shdr) || Ehdr->e_shoff > Size ||
+      (uint64_t)Ehdr->e_shnum * sizeof(Elf64_Shdr) > Size - Ehdr->e_shoff)
+    return "";
+  const auto *Shdrs = reinterpret_cast<const Elf64_Shdr *>(Image + Ehdr->e_shoff);
+  for (unsigned I = 0; I < Ehdr->e_shnum; ++I) {
+    const Elf64_Shdr &Sec = Shdrs[I];
+    if (Sec.sh_type != SHT_NOTE || Sec.sh_offset > Size ||
+        Sec.sh_size > Size - Sec.sh_offset)
+      continue;
+    for (uint64_t Off = 0; Off + sizeof(Elf64_Nhdr) <= Sec.sh_size;) {
+      const auto *Note =
+          reinterpret_cast<const Elf64_Nhdr *>(Image + Sec.sh_offset + Off);
+      uint64_t Name = Off + sizeof(Elf64_Nhdr);
+      uint64_t Desc = Name + llvm::alignTo(Note->n_namesz, 4);
+      uint64_t End = Desc + llvm::alignTo(Note->n_descsz, 4);
+      if (End > Sec.sh_size)
+        break;
+      if (Note->n_type == NT_GNU_BUILD_ID && Note->n_namesz == 4 &&
+          !memcmp(Image + Sec.sh_offset + Name, "GNU", 4)) {
+        std::string ID;
+        llvm::raw_string_ostream OS(ID);
+        for (uint32_t B = 0; B < Note->n_descsz; ++B)
+          OS << llvm::format_hex_no_prefix(Image[Sec.sh_offset + Desc + B], 2);
+        return OS.str();
+      }
+      Off = End;
+    }
+  }
+  return "";
+}
+
+// <dir>/<build ID>-<boot ID>, or empty if the binary has no build ID
+static std::string getCachePath(const char *Dir, int ExeFD, size_t Size) {
+  Mapping Exe(ExeFD, Size, PROT_READ, MAP_PRIVATE);
+  if (!Exe.valid())
+    return "";
+  std::string BuildID =
+      getBuildID(static_cast<const uint8_t *>(Exe.Addr), Exe.Size);
+  if (BuildID.empty())
+    return "";
+
+  char BootID[64] = {0};
+  int FD = open("/proc/sys/kernel/random/boot_id", O_RDONLY | O_CLOEXEC);
+  if (FD < 0)
+    return "";
+  ssize_t Len = read(FD, BootID, sizeof(BootID) - 1);
+  close(FD);
+  if (Len <= 0)
+    return "";
+  std::string Boot(BootID, Len);
+  while (!Boot.empty() && Boot.back() == '\n')
+    Boot.pop_back();
+  return std::string(Dir) + "/" + BuildID + "-" + Boot;
+}
+
+// A file with a writer (or a writable mapping) cannot be executed
+static int reopenReadOnly(int FD) {
+  std::string Path = "/proc/self/fd/" + std::to_string(FD);
+  int ReadOnly = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+  close(FD);
+  return ReadOnly;
+}
+
+// The layout flags of the environment
+static unsigned getLoadFlags() {
+  const char *BBLs = getenv("CCR_SHUFFLE_BBLS");
+  const char *Startup = getenv("CCR_STARTUP_LAYOUT");
+  unsigned Flags = BBLs && !strcmp(BBLs, "1") ? CCR_LOAD_SHUFFLE_BBLS : 0;
+  if (Startup && !strcmp(Startup, "1"))
+    Flags |= CCR_LOAD_STARTUP;
+  return Flags;
+}
+
+static uint64_t getRandomSeed() {
+  return ((uint64_t)llvm::sys::Process::GetRandomNumber() << 32) |
+         llvm::sys::Process::GetRandomNumber();
+}
+
+// The bytes of hot code of $CCR_HOT_REGION, or 0 if not set
+static uint64_t getHotRegionBudget() {
+  const char *Env = getenv("CCR_HOT_REGION");
+  return Env ? strtoull(Env, nullptr, 10) : 0;
+}
+
+// The index of the binary at \p ExePath, mapped
+static bool mapIndex(const char *ExePath, std::unique_ptr<Mapping> &Index) {
+  const char *Env = getenv("CCR_INDEX");
+  std::string IndexPath = Env ? Env : std::string(ExePath) + ".ccridx";
+  int IndexFD = open(IndexPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (IndexFD < 0)
+    return false;
+  struct stat IndexStat;
+  bool IndexValid = !fstat(IndexFD, &IndexStat);
+  Index.reset(new Mapping(IndexFD, IndexValid ? IndexStat.st_size : 0,
+                          PROT_READ, MAP_PRIVATE));
+  close(IndexFD);
+  return Index->valid();
+}
+
+// Returns the descriptor of the randomized copy, or -1
+static int randomizeSelf() {
+  char ExePath[4096];
+  ssize_t Len = readlink("/proc/self/exe", ExePath, sizeof(ExePath) - 1);
+  if (Len <= 0)
+    return -1;
+  ExePath[Len] = '\0';
+  std::unique_ptr<Mapping> IndexMapping;
+  if (!mapIndex(ExePath, IndexMapping))
+    return -1;
+  const Mapping &Index = *IndexMapping;
+
+  int ExeFD = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+  if (ExeFD < 0)
+    return -1;
+  struct stat ExeStat;
+  if (fstat(ExeFD, &ExeStat)) {
+    close(ExeFD);
+    return -1;
+  }
+
+  // A copy of this boot may exist already; otherwise it is built under a
+  // temporary name, and the first process to publish it wins
+  std::string CachePath, TempPath;
+  if (const char *Dir = getenv("CCR_CACHE_DIR"))
+    CachePath = getCachePath(Dir, ExeFD, ExeStat.st_size);
+  int CopyFD = -1;
+  if (!CachePath.empty()) {
+    int Cached = open(CachePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (Cached >= 0) {
+      close(ExeFD);
+      return Cached;
+    }
+    std::string Temp = CachePath + ".XXXXXX";
+    CopyFD = mkostemp(&Temp[0], O_CLOEXEC);
+    if (CopyFD >= 0)
+      TempPath = Temp;
+  } else {
+    CopyFD = memfd_create("ccr-rand", MFD_CLOEXEC);
+  }
+  if (CopyFD >= 0 && !copyFile(ExeFD, CopyFD, ExeStat.st_size)) {
+    close(CopyFD);
+    CopyFD = -1;
+  }
+  close(ExeFD);
+  if (CopyFD < 0) {
+    if (!TempPath.empty())
+      unlink(TempPath.c_str());
+    return -1;
+  }
+
+  uint64_t Seed = getRandomSeed();
+  unsigned Flags = getLoadFlags();
+  uint64_t HotBudget = TempPath.empty() ? 0 : getHotRegionBudget();
+  {
+    Mapping Image(CopyFD, ExeStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED);
+    // The hot regions of the cached copy are those of its own seed, which
+    // no process runs long: each re-randomizes them
+    int Failed =
+        !Image.valid() ||
+        (HotBudget ? ccr_randomize_image_hot_region(Image.Addr, Image.Size,
+                                                    Index.Addr, Index.Size,
+                                                    Seed, Seed, HotBudget,
+                                                    Flags)
+                   : ccr_randomize_image(Image.Addr, Image.Size, Index.Addr,
+                                         Index.Size, Seed, Flags));
+    if (Failed) {
+      close(CopyFD);
+      if (!TempPath.empty())
+        unlink(TempPath.c_str());
+      return -1;
+    }
+  }
+  if (TempPath.empty())
+    return reopenReadOnly(CopyFD);
+
+  close(CopyFD);
+  chmod(TempPath.c_str(), 0555);
+  // The seed is published first: whoever publishes it publishes the copy
+  if (HotBudget) {
+    std::string SeedTemp = TempPath + ".seed";
+    int SeedFD = open(SeedTemp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                      0444);
+    std::string Line = std::to_string(Seed) + " " + std::to_string(Flags) +
+                       " " + std::to_string(HotBudget) + "\n";
+    bool Written = SeedFD >= 0 &&
+                   write(SeedFD, Line.data(), Line.size()) == (ssize_t)Line.size();
+    if (SeedFD >= 0)
+      close(SeedFD);
+    bool Published =
+        Written && !link(SeedTemp.c_str(), (CachePath + ".seed").c_str());
+    unlink(SeedTemp.c_str());
+    if (!Published) {
+      unlink(TempPath.c_str());
+      return open(CachePath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+  }
+  if (link(TempPath.c_str(), CachePath.c_str()) && errno != EEXIST) {
+    unlink(TempPath.c_str());
+    return -1;
+  }
+  unlink(TempPath.c_str());
+  return open(CachePath.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+// The cached copy runs, with the hot regions of its own seed: lay out those
+// of the original binary by a seed of this process, and write the pages that
+// differ over the loaded ones. On any error the copy runs as it is.
+static void randomizeHotRegions(const char *Origin) {
+  char ExePath[4096];
+  ssize_t Len = readlink("/proc/self/exe", ExePath, sizeof(ExePath) - 1);
+  if (Len <= 0)
+    return;
+  ExePath[Len] = '\0';
+  FILE *SeedFile = fopen((std::string(ExePath) + ".seed").c_str(), "re");
+  if (!SeedFile)
+    return;
+  unsigned long long Seed, HotBudget;
+  unsigned Flags;
+  int Fields = fscanf(SeedFile, "%llu %u %llu", &Seed, &Flags, &HotBudget);
+  fclose(SeedFile);
+  std::unique_ptr<Mapping> Index;
+  if (Fields != 3 || !mapIndex(Origin, Index))
+    return;
+
+  int SharedFD = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+  int OriginFD = open(Origin, O_RDONLY | O_CLOEXEC);
+  struct stat SharedStat, OriginStat;
+  bool Valid = SharedFD >= 0 && OriginFD >= 0 && !fstat(SharedFD, &SharedStat) &&
+               !fstat(OriginFD, &OriginStat) &&
+               SharedStat.st_size == OriginStat.st_size;
+  Mapping Shared(SharedFD, Valid ? SharedStat.st_size : 0, PROT_READ,
+                 MAP_PRIVATE);
+  Mapping Private(OriginFD, Valid ? OriginStat.st_size : 0,
+                  PROT_READ | PROT_WRITE, MAP_PRIVATE);
+  if (SharedFD >= 0)
+    close(SharedFD);
+  if (OriginFD >= 0)
+    close(OriginFD);
+  if (!Shared.valid() || !Private.valid() ||
+      ccr_randomize_image_hot_region(Private.Addr, Private.Size, Index->Addr,
+                                     Index->Size, Seed, getRandomSeed(),
+                                     HotBudget, Flags))
+    return;
+  uint64_t Bias;
+  llvm::ArrayRef<uint8_t> SharedImage(
+      static_cast<const uint8_t *>(Shared.Addr), Shared.Size);
+  if (llvm::ccr::getLoadBias(SharedImage, Bias))
+    ccr_patch_loaded_pages(Shared.Addr, Shared.Size, Private.Addr,
+                           Private.Size, Bias);
+}
+
+// The randomized copy runs: its (patched) symbols say where the code went
+static void describeToPerf() {
+  const char *Mode = getenv("CCR_PERF_MAP");
+  if (!Mode || (strcmp(Mode, "1") && strcmp(Mode, "jitdump")))
+    return;
+  const char *JitDumpDir = nullptr;
+  if (!strcmp(Mode, "jitdump")) {
+    JitDumpDir = getenv("JITDUMPDIR");
+    if (!JitDumpDir)
+      JitDumpDir = "/tmp";
+  }
+  int ExeFD = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+  if (ExeFD < 0)
+    return;
+  struct stat ExeStat;
+  bool Valid = !fstat(ExeFD, &ExeStat);
+  Mapping Exe(ExeFD, Valid ? ExeStat.st_size : 0, PROT_READ, MAP_PRIVATE);
+  close(ExeFD);
+  if (Exe.valid())
+    llvm::ccr::writePerfMap(static_cast<const uint8_t *>(Exe.Addr), Exe.Size,
+                            JitDumpDir);
+}
+
+static void preload(int Argc, char **Argv, char **Envp) {
+  std::string Self = std::to_string(getpid());
+  if (const char *Pid = getenv("CCR_PRELOAD_PID")) {
+    if (Self == Pid) {
+      unsetenv("CCR_PRELOAD_PID");
+      if (const char *Origin = getenv("CCR_PRELOAD_ORIGIN")) {
+        randomizeHotRegions(Origin);
+        unsetenv("CCR_PRELOAD_ORIGIN");
+      }
+      describeToPerf();
+      return;
+    }
+  }
+  int FD = randomizeSelf();
+  if (FD < 0)
+    return;
+  setenv("CCR_PRELOAD_PID", Self.c_str(), /*overwrite=*/1);
+  char ExePath[4096];
+  ssize_t Len = readlink("/proc/self/exe", ExePath, sizeof(ExePath) - 1);
+  bool HotRegion = getHotRegionBudget() && getenv("CCR_CACHE_DIR") && Len > 0;
+  if (HotRegion) {
+    ExePath[Len] = '\0';
+    setenv("CCR_PRELOAD_ORIGIN", ExePath, /*overwrite=*/1);
+  }
+  extern char **environ;
+  fexecve(FD, Argv, environ);
+  // The original binary runs on if the copy cannot be executed
+  close(FD);
+  unsetenv("CCR_PRELOAD_PID");
+  if (HotRegion)
+    unsetenv("CCR_PRELOAD_ORIGIN");
+}
+
+// glibc passes (argc, argv, envp) to the functions of .init_array
+__attribute__((section(".init_array"), used))
+static void (*const CCRPreloadInit)(int, char **, char **) = preload;
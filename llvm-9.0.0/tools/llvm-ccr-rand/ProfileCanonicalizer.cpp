@@ -0,0 +1,434 @@
+//===- ProfileCanonicalizer.cpp - Profiles of randomized hosts ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ProfileCanonicalizer.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Errno.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::object;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// The bytes read at once, and the blocks translated at once per thread
+static const size_t BlockSize = 1 << 22;
+static const size_t BlocksPerThread = 2;
+
+namespace {
+typedef SmallVector<std::pair<uint64_t, uint64_t>, 4> RangePieces;
+
+class Translator {
+  const RandAddressMap &Map;
+
+public:
+  explicit Translator(const RandAddressMap &Map) : Map(Map) {}
+
+  static bool parseHex(StringRef Field, uint64_t &Value, bool &Prefixed) {
+    Prefixed = Field.consume_front("0x") || Field.consume_front("0X");
+    return !Field.empty() && !Field.getAsInteger(16, Value);
+  }
+
+  static void appendHex(std::string &Out, uint64_t Value, bool Prefixed) {
+    if (Prefixed)
+      Out += "0x";
+    Out += utohexstr(Value, /*LowerCase=*/true);
+  }
+
+  // An address out of the randomized code (another DSO, the PLT) stays
+  uint64_t translate(uint64_t Addr, CanonicalizeStats &S) const {
+    Optional<uint64_t> Old = Map.getOriginalAddress(Addr);
+    if (!Old)
+      return Addr;
+    ++S.NumTranslated;
+    return *Old;
+  }
+
+  // The range [Begin, End] as its original pieces (itself if not randomized)
+  void translateRange(uint64_t Begin, uint64_t End, RangePieces &Pieces,
+                      CanonicalizeStats &S) const {
+    Pieces.clear();
+    if (!Map.getOriginalRanges(Begin, End, Pieces)) {
+      Pieces.emplace_back(Begin, End);
+      return;
+    }
+    S.NumTranslated += 2;
+    S.NumSplitRanges += Pieces.size() > 1;
+  }
+
+  void translatePerfScript(StringRef Line, std::string &Out,
+                           CanonicalizeStats &S) const;
+  void translatePreAggregated(StringRef Line, std::string &Out,
+                              CanonicalizeStats &S) const;
+  bool translateTextRecord(StringRef Line, std::string &Out, size_t &NumOut,
+                           CanonicalizeStats &S) const;
+};
+} // end anonymous namespace
+
+void Translator::translatePerfScript(StringRef Line, std::string &Out,
+                                     CanonicalizeStats &S) const {
+  // The header of a sample (comm, pid/tid, time and event) ends at the last
+  // ": " before the first DSO, and its decimal fields would read as hex
+  size_t I = Line.take_front(Line.find('(')).rfind(": ");
+  I = I == StringRef::npos ? 0 : I + 2;
+  Out += Line.take_front(I);
+  size_t Depth = 0; // Within the parentheses of a DSO
+  size_t E = Line.size();
+  while (I != E) {
+    char C = Line[I];
+    if (C == ' ' || C == '\t' || C == '/' || C == '(' || C == ')') {
+      Depth += C == '(';
+      Depth -= C == ')' && Depth;
+      Out += C;
+      ++I;
+      continue;
+    }
+    size_t TokenEnd = Line.find_first_of(" \t/()", I);
+    if (TokenEnd == StringRef::npos)
+      TokenEnd = E;
+    StringRef Token = Line.slice(I, TokenEnd);
+    uint64_t Addr;
+    bool Prefixed;
+    if (!Depth && parseHex(Token, Addr, Prefixed)) {
+      uint64_t Old = translate(Addr, S);
+      if (Old != Addr) {
+        appendHex(Out, Old, Prefixed);
+        I = TokenEnd;
+        continue;
+      }
+    }
+    Out += Token;
+    I = TokenEnd;
+  }
+}
+
+void Translator::translatePreAggregated(StringRef Line, std::string &Out,
+                                        CanonicalizeStats &S) const {
+  SmallVector<StringRef, 5> Fields;
+  StringRef Record = Line.split('#').first;
+  Record.split(Fields, ' ', -1, /*KeepEmpty=*/false);
+  uint64_t From, To;
+  bool FromPrefixed, ToPrefixed;
+  if (Fields.size() < 4 || Fields[0].size() != 1 ||
+      !parseHex(Fields[1], From, FromPrefixed) ||
+      !parseHex(Fields[2], To, ToPrefixed)) {
+    Out += Line;
+    return;
+  }
+
+  if (Fields[0] == "B") {
+    Out += "B ";
+    appendHex(Out, translate(From, S), FromPrefixed);
+    Out += ' ';
+    appendHex(Out, translate(To, S), ToPrefixed);
+    for (size_t I = 3, E = Fields.size(); I != E; ++I) {
+      Out += ' ';
+      Out += Fields[I];
+    }
+    return;
+  }
+  if (Fields[0] != "F" && Fields[0] != "f") {
+    Out += Line;
+    return;
+  }
+
+  RangePieces Pieces;
+  translateRange(From, To, Pieces, S);
+  for (size_t P = 0, E = Pieces.size(); P != E; ++P) {
+    if (P)
+      Out += '\n';
+    Out += Fields[0];
+    Out += ' ';
+    appendHex(Out, Pieces[P].first, FromPrefixed);
+    Out += ' ';
+    appendHex(Out, Pieces[P].second, ToPrefixed);
+    for (size_t I = 3, FE = Fields.size(); I != FE; ++I) {
+      Out += ' ';
+      Out += Fields[I];
+    }
+  }
+}
+
+// A record of a text profile: "<begin>-<end>:<count>", "<addr>:<count>" or
+// "<from>-><to>:<count>"; NumOut tells the records it became. Returns false
+// if the line is no record.
+bool Translator::translateTextRecord(StringRef Line, std::string &Out,
+                                     size_t &NumOut,
+                                     CanonicalizeStats &S) const {
+  StringRef Trimmed = Line.trim();
+  size_t Colon = Trimmed.rfind(':');
+  if (Colon == StringRef::npos)
+    return false;
+  StringRef Addrs = Trimmed.take_front(Colon), Count = Trimmed.drop_front(Colon);
+  uint64_t A, B;
+  bool APrefixed, BPrefixed;
+  size_t Arrow = Addrs.find("->");
+  if (Arrow != StringRef::npos) {
+    if (!parseHex(Addrs.take_front(Arrow), A, APrefixed) ||
+        !parseHex(Addrs.drop_front(Arrow + 2), B, BPrefixed))
+      return false;
+    appendHex(Out, translate(A, S), APrefixed);
+    Out += "->";
+    appendHex(Out, translate(B, S), BPrefixed);
+    Out += Count;
+    NumOut = 1;
+    return true;
+  }
+  size_t Dash = Addrs.find('-');
+  if (Dash == StringRef::npos) {
+    if (!parseHex(Addrs, A, APrefixed))
+      return false;
+    appendHex(Out, translate(A, S), APrefixed);
+    Out += Count;
+    NumOut = 1;
+    return true;
+  }
+  if (!parseHex(Addrs.take_front(Dash), A, APrefixed) ||
+      !parseHex(Addrs.drop_front(Dash + 1), B, BPrefixed))
+    return false;
+  RangePieces Pieces;
+  translateRange(A, B, Pieces, S);
+  for (size_t P = 0, E = Pieces.size(); P != E; ++P) {
+    if (P)
+      Out += '\n';
+    appendHex(Out, Pieces[P].first, APrefixed);
+    Out += '-';
+    appendHex(Out, Pieces[P].second, BPrefixed);
+    Out += Count;
+  }
+  NumOut = Pieces.size();
+  return true;
+}
+
+static void forEach(bool Parallel, size_t N, function_ref<void(size_t)> Fn) {
+  if (Parallel && N > 1)
+    parallel::for_each_n(parallel::par, (size_t)0, N, Fn);
+  else
+    for (size_t I = 0; I != N; ++I)
+      Fn(I);
+}
+
+static ProfileFormat detectFormat(StringRef Data) {
+  while (!Data.empty()) {
+    StringRef Line;
+    std::tie(Line, Data) = Data.split('\n');
+    Line = Line.trim();
+    if (Line.empty() || Line.startswith("#"))
+      continue;
+    if (Line.size() > 2 && strchr("BFf", Line[0]) && Line[1] == ' ')
+      return ProfileFormat::PreAggregated;
+    uint64_t Count;
+    if (!Line.getAsInteger(10, Count))
+      return ProfileFormat::TextProfile;
+    return ProfileFormat::PerfScript;
+  }
+  return ProfileFormat::PerfScript;
+}
+
+// A text profile is a sequence of sections, each of a line with the number of
+// its records and then the records; the context lines of a context-sensitive
+// profile ("[main @ foo]") go as they are
+static void canonicalizeTextProfile(StringRef Data, raw_ostream &OS,
+                                    const Translator &T, bool Parallel,
+                                    CanonicalizeStats &Stats) {
+  SmallVector<StringRef, 0> Lines;
+  Data.split(Lines, '\n');
+  if (!Lines.empty() && Lines.back().empty())
+    Lines.pop_back();
+  Stats.NumLines += Lines.size();
+
+  std::vector<std::string> Outs;
+  std::vector<size_t> Counts;
+  std::vector<CanonicalizeStats> RecordStats;
+  for (size_t I = 0, E = Lines.size(); I != E;) {
+    uint64_t NumRecords;
+    if (Lines[I].trim().getAsInteger(10, NumRecords) ||
+        NumRecords > E - I - 1) {
+      OS << Lines[I++] << '\n';
+      continue;
+    }
+    ArrayRef<StringRef> Records =
+        makeArrayRef(Lines).slice(I + 1, NumRecords);
+    Outs.assign(Records.size(), std::string());
+    Counts.assign(Records.size(), 1);
+    RecordStats.assign(Records.size(), CanonicalizeStats());
+    forEach(Parallel, Records.size(), [&](size_t R) {
+      if (!T.translateTextRecord(Records[R], Outs[R], Counts[R],
+                                 RecordStats[R]))
+        Outs[R] = Records[R];
+    });
+    size_t Total = 0;
+    for (size_t R = 0; R != Records.size(); ++R) {
+      Total += Counts[R];
+      Stats.add(RecordStats[R]);
+    }
+    OS << Total << '\n';
+    for (const std::string &Out : Outs)
+      OS << Out << '\n';
+    I += 1 + NumRecords;
+  }
+}
+
+// Fill \p Blocks with up to \p Max blocks of whole lines from \p FD; the
+// partial line at the end of a read is carried over in \p Pending
+static Error readBlocks(int FD, StringRef Input, size_t Max,
+                        std::vector<std::string> &Blocks, std::string &Pending,
+                        bool &AtEnd) {
+  Blocks.clear();
+  while (Blocks.size() < Max && !AtEnd) {
+    std::string Block = std::move(Pending);
+    Pending.clear();
+    size_t Have = Block.size();
+    Block.resize(Have + BlockSize);
+    ssize_t N = sys::RetryAfterSignal(-1, ::read, FD, &Block[Have], BlockSize);
+    if (N < 0)
+      return createFileError(Input,
+                             std::error_code(errno, std::generic_category()));
+    Block.resize(Have + N);
+    if (N == 0) {
+      AtEnd = true;
+      if (!Block.empty())
+        Blocks.push_back(std::move(Block));
+      break;
+    }
+    size_t Cut = Block.rfind('\n');
+    if (Cut == std::string::npos) {
+      Pending = std::move(Block); // A line longer than the block
+      continue;
+    }
+    Pending = Block.substr(Cut + 1);
+    Block.resize(Cut + 1);
+    Blocks.push_back(std::move(Block));
+  }
+  return Error::success();
+}
+
+static Error canonicalizeStream(int FD, StringRef Input, raw_ostream &OS,
+                                const RandAddressMap &Map,
+                                ProfileFormat Format, bool Parallel,
+                                CanonicalizeStats &Stats) {
+  Translator T(Map);
+  size_t MaxBlocks =
+      Parallel ? BlocksPerThread * std::max(1U, std::thread::hardware_concurrency())
+               : 1;
+  std::vector<std::string> Blocks, Outs;
+  std::vector<CanonicalizeStats> BlockStats;
+  std::string Pending;
+  bool AtEnd = false;
+  while (!AtEnd) {
+    if (Error E = readBlocks(FD, Input, MaxBlocks, Blocks, Pending, AtEnd))
+      return E;
+    if (Blocks.empty())
+      continue;
+    if (Format == ProfileFormat::Auto)
+      Stats.Format = Format = detectFormat(Blocks.front());
+
+    // A text profile is translated by sections, once all of it has been read
+    if (Format == ProfileFormat::TextProfile) {
+      std::string Whole;
+      for (std::string &Block : Blocks)
+        Whole += Block;
+      while (!AtEnd) {
+        if (Error E = readBlocks(FD, Input, MaxBlocks, Blocks, Pending, AtEnd))
+          return E;
+        for (std::string &Block : Blocks)
+          Whole += Block;
+      }
+      canonicalizeTextProfile(Whole, OS, T, Parallel, Stats);
+      return Error::success();
+    }
+
+    Outs.assign(Blocks.size(), std::string());
+    BlockStats.assign(Blocks.size(), CanonicalizeStats());
+    forEach(Parallel, Blocks.size(), [&](size_t B) {
+      StringRef Rest = Blocks[B];
+      std::string &Out = Outs[B];
+      Out.reserve(Rest.size() + Rest.size() / 8);
+      while (!Rest.empty()) {
+        StringRef Line;
+        std::tie(Line, Rest) = Rest.split('\n');
+        if (Format == ProfileFormat::PreAggregated)
+          T.translatePreAggregated(Line, Out, BlockStats[B]);
+        else
+          T.translatePerfScript(Line, Out, BlockStats[B]);
+        Out += '\n';
+        ++BlockStats[B].NumLines;
+      }
+    });
+    for (size_t B = 0; B != Blocks.size(); ++B) {
+      OS << Outs[B];
+      Stats.add(BlockStats[B]);
+    }
+  }
+  return Error::success();
+}
+
+Error llvm::ccr::canonicalizeProfile(StringRef Input, StringRef Output,
+                                     const RandAddressMap &Map,
+                                     ProfileFormat Format, bool Parallel,
+                                     CanonicalizeStats &Stats) {
+  Stats.Format = Format;
+  int InFD = 0;
+  if (Input != "-")
+    if (std::error_code EC = sys::fs::openFileForRead(Input, InFD))
+      return createFileError(Input, EC);
+  auto CloseInput = make_scope_exit([&] {
+    if (Input != "-")
+      sys::Process::SafelyCloseFileDescriptor(InFD);
+  });
+
+  if (Output == "-") {
+    raw_ostream &OS = outs();
+    if (Error E = canonicalizeStream(InFD, Input, OS, Map, Format, Parallel,
+                                     Stats))
+      return E;
+    OS.flush();
+    return Error::success();
+  }
+
+  // Written to a temporary file first, thus a consumer never sees a partial
+  // profile
+  SmallString<128> TmpPath;
+  int OutFD;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Output + ".tmp%%%%%%", OutFD, TmpPath))
+    return createFileError(Output, EC);
+  auto RemoveTemp = make_scope_exit([&] {
+    if (!TmpPath.empty())
+      sys::fs::remove(TmpPath);
+  });
+  {
+    raw_fd_ostream OS(OutFD, /*shouldClose=*/true);
+    if (Error E = canonicalizeStream(InFD, Input, OS, Map, Format, Parallel,
+                                     Stats))
+      return E;
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      return makeError("Cannot write the profile '" + Output + "'");
+    }
+  }
+  if (std::error_code EC = sys::fs::rename(TmpPath, Output))
+    return createFileError(Output, EC);
+  TmpPath.clear();
+  return Error::success();
+}
@@ -0,0 +1,80 @@
+//===- ProfileCanonicalizer.h - Profiles of randomized hosts ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Every host runs a layout of its own of a randomized binary, thus the
+// samples that perf collects across a fleet do not add up. With
+// -canonicalize-profile, the address streams derived from perf.data are
+// rewritten into the original layout of the binary by the address map of
+// each host (-rand-map, as -address-map wrote it), and the AutoFDO/BOLT
+// pipeline merges them as if the layout had never changed:
+//
+// - perf script output (i.e., -F ip,brstack): every hex token between blanks
+//   or '/' that falls into the randomized code (the DSO in parentheses
+//   aside);
+// - pre-aggregated profiles (perf2bolt -pa, as -optimize-layout reads): the
+//   ends of the B branches, and the F (and f) fall-through ranges;
+// - unsymbolized text profiles (llvm-profgen, create_llvm_prof): the range,
+//   address and branch sections, each of which leads with its count.
+//
+// A fall-through range of the randomized code may span BBLs that came from
+// apart: it becomes a range per original piece, of the same count. The
+// symbolized profiles (llvm-profdata) tell functions and lines rather than
+// addresses and hold across layouts as they are.
+//
+// The streams are translated in blocks of lines on the thread pool and
+// written in order, thus the memory taken is bounded whatever the size of
+// the input ("-" for stdin). A text profile has been aggregated already, and
+// is read whole: the count of a section is only known once its ranges have
+// been split.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_PROFILECANONICALIZER_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_PROFILECANONICALIZER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Object/RandMap.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+
+namespace llvm {
+namespace ccr {
+
+enum class ProfileFormat {
+  Auto,          // By the first record
+  PerfScript,    // perf script output
+  PreAggregated, // B/F records of perf2bolt -pa
+  TextProfile    // Unsymbolized llvm-profgen/create_llvm_prof text
+};
+
+struct CanonicalizeStats {
+  uint64_t NumLines = 0;
+  uint64_t NumTranslated = 0;  // Addresses in the randomized code
+  uint64_t NumSplitRanges = 0; // Ranges that became many
+  ProfileFormat Format = ProfileFormat::Auto; // As detected
+
+  void add(const CanonicalizeStats &S) {
+    NumLines += S.NumLines;
+    NumTranslated += S.NumTranslated;
+    NumSplitRanges += S.NumSplitRanges;
+  }
+};
+
+/// Rewrite the profile at \p Input ("-" for stdin), collected on a host whose
+/// layout \p Map tells, into the original layout at \p Output ("-" for
+/// stdout; a file is replaced atomically). The blocks are translated on the
+/// thread pool if \p Parallel.
+Error canonicalizeProfile(StringRef Input, StringRef Output,
+                          const object::RandAddressMap &Map,
+                          ProfileFormat Format, bool Parallel,
+                          CanonicalizeStats &Stats);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_PROFILECANONICALIZER_H
@@ -0,0 +1,289 @@
+//===- RandDiff.cpp - Structural diff of two .rand sections ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "RandDiff.h"
+#include "Layout.h"
+#include "RandInfo.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/xxhash.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::object;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+namespace {
+
+// A function of .rand, condensed
+struct FunctionSummary {
+  std::string Name; // Of its symbol (with "#<n>" for the n-th duplicate), if any
+  uint64_t Offset = 0;
+  uint64_t Size = 0;
+  unsigned NumBBLs = 0;
+  unsigned NumFixups = 0;
+  uint64_t ShapeHash = 0;
+  uint64_t FixupHash = 0;
+  FunctionIdentity ID; // Recorded by the compiler, if at all
+  bool Matched = false;
+};
+
+struct RandSummary {
+  std::vector<FunctionSummary> Functions;
+  uint64_t RandSize = 0;
+  unsigned NumBBLs = 0;
+  size_t NumFixups[NumFixupKinds] = {};
+};
+
+} // end anonymous namespace
+
+static uint64_t hashWords(ArrayRef<uint64_t> Words) {
+  return xxHash64(StringRef(reinterpret_cast<const char *>(Words.data()),
+                            Words.size() * sizeof(uint64_t)));
+}
+
+static Expected<RandSummary> summarize(const ELF64LEObjectFile &Obj) {
+  Optional<SectionRef> Text, Rand;
+  for (const SectionRef &Sec : Obj.sections()) {
+    StringRef Name;
+    if (Sec.getName(Name))
+      continue;
+    if (Name == ".text")
+      Text = Sec;
+    else if (Name == ".rand")
+      Rand = Sec;
+  }
+  if (!Rand)
+    return makeError("No .rand section: not built by the CCR toolchain");
+  if (!Text)
+    return makeError("No .text section");
+
+  Expected<StringRef> Contents = Rand->getContents();
+  if (!Contents)
+    return Contents.takeError();
+  Expected<RandInfo> InfoOrErr =
+      parseRandInfo(".rand", arrayRefFromStringRef(*Contents),
+                    ELFSectionRef(*Rand).getFlags() & ELF::SHF_COMPRESSED);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  RandInfo &Info = *InfoOrErr;
+  computeFixupOwners(Info);
+  Layout L(Info, /*ShuffleBBLs=*/false);
+
+  // The functions by the offsets of their symbols in .text; the first symbol
+  // at an offset names it, the static ones included
+  uint64_t TextAddr = Text->getAddress(), TextSize = Text->getSize();
+  DenseMap<uint64_t, StringRef> Names;
+  auto AddSymbols = [&](ELFObjectFileBase::elf_symbol_iterator_range Symbols) {
+    for (const ELFSymbolRef &Sym : Symbols) {
+      if (Sym.getELFType() != ELF::STT_FUNC)
+        continue;
+      Expected<uint64_t> Addr = Sym.getAddress();
+      Expected<StringRef> Name = Sym.getName();
+      if (!Addr || !Name) {
+        consumeError(Addr.takeError());
+        consumeError(Name.takeError());
+        continue;
+      }
+      if (*Addr >= TextAddr && *Addr < TextAddr + TextSize && !Name->empty())
+        Names.try_emplace(*Addr - TextAddr, *Name);
+    }
+  };
+  AddSymbols(Obj.symbols());
+  AddSymbols(Obj.getDynamicSymbolIterators());
+
+  RandSummary S;
+  S.RandSize = Contents->size();
+  S.NumBBLs = Info.BasicBlocks.size();
+  for (unsigned K = 0; K != NumFixupKinds; ++K)
+    S.NumFixups[K] = Info.Fixups[K].size();
+
+  // Both the BBLs and the (sorted) fixups of a function are runs, thus every
+  // function is condensed in one pass over them
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  size_t NextFixup = 0;
+  StringMap<unsigned> NumDuplicates;
+  SmallVector<uint64_t, 64> Words;
+  for (const Function &F : L.functions()) {
+    FunctionSummary FS;
+    FS.ID = Info.getFunctionID(S.Functions.size());
+    const BasicBlock &Entry = L.basicBlocks()[F.FirstBBL];
+    FS.Offset = Entry.OldOffset;
+    FS.NumBBLs = F.NumBBLs;
+    auto It = Names.find(FS.Offset);
+    if (It != Names.end()) {
+      FS.Name = It->second;
+      if (unsigned N = NumDuplicates[It->second]++)
+        FS.Name += "#" + utostr(N + 1);
+    }
+
+    Words.clear();
+    for (unsigned I = F.FirstBBL, E = F.FirstBBL + F.NumBBLs; I != E; ++I) {
+      const BasicBlockInfo &BI = Info.BasicBlocks[I];
+      FS.Size += BI.Size;
+      Words.push_back((uint64_t)BI.Size | (uint64_t)BI.PaddingSize << 32);
+      Words.push_back(BI.Type | BI.AlignLog2 << 8 | BI.FallThrough << 16 |
+                      BI.Hotness << 17 | BI.SectionClass << 20 |
+                      BI.Pinned << 24);
+    }
+    FS.ShapeHash = hashWords(Words);
+
+    Words.clear();
+    uint64_t FuncEnd = FS.Offset + FS.Size;
+    for (; NextFixup != Fixups.size() && Fixups[NextFixup].Offset < FuncEnd;
+         ++NextFixup) {
+      const FixupInfo &Fx = Fixups[NextFixup];
+      if (Fx.Offset < FS.Offset)
+        continue; // Before the first BBL (not in the layout)
+      Words.push_back(Fx.Offset - FS.Offset);
+      Words.push_back((uint64_t)Fx.DerefSize | (uint64_t)Fx.IsRela << 8 |
+                      (uint64_t)Fx.Target << 9 | (uint64_t)Fx.RefClass << 12 |
+                      (uint64_t)Fx.GOTRelax << 14 |
+                      (uint64_t)Fx.RelaxShortSize << 16 |
+                      (uint64_t)Fx.Type << 24 |
+                      (uint64_t)Fx.ShrinkShortSize << 28 |
+                      (uint64_t)Fx.NumJTEntries << 32);
+      ++FS.NumFixups;
+    }
+    FS.FixupHash = hashWords(Words);
+    S.Functions.push_back(std::move(FS));
+  }
+  return std::move(S);
+}
+
+static void printFunction(raw_ostream &OS, char Tag, const FunctionSummary &F) {
+  OS << Tag << ' ' << (F.Name.empty() ? "<unnamed>" : F.Name) << " @ .text+"
+     << format_hex(F.Offset, 1) << ": " << F.NumBBLs << " BBLs, " << F.Size
+     << " bytes, " << F.NumFixups << " fixups\n";
+}
+
+static void printCount(raw_ostream &OS, StringRef What, uint64_t Old,
+                       uint64_t New) {
+  OS << What << ": " << Old;
+  if (New != Old)
+    OS << " -> " << New;
+  OS << "\n";
+}
+
+Expected<bool> llvm::ccr::diffRandSections(const ELF64LEObjectFile &Old,
+                                           const ELF64LEObjectFile &New,
+                                           raw_ostream &OS) {
+  Expected<RandSummary> OldOrErr = summarize(Old);
+  if (!OldOrErr)
+    return createFileError(Old.getFileName(), OldOrErr.takeError());
+  Expected<RandSummary> NewOrErr = summarize(New);
+  if (!NewOrErr)
+    return createFileError(New.getFileName(), NewOrErr.takeError());
+  std::vector<FunctionSummary> &OldFuncs = OldOrErr->Functions;
+  std::vector<FunctionSummary> &NewFuncs = NewOrErr->Functions;
+
+  // Named functions pair up by name; the unnamed ones (i.e., of a stripped
+  // binary) by the hash of the name the compiler has recorded, in order, or
+  // else by shape and fixups, thus such a function is either unchanged or
+  // added and removed
+  StringMap<unsigned> ByName;
+  DenseMap<uint64_t, SmallVector<unsigned, 1>> ByNameHash, ByHash;
+  for (unsigned I = NewFuncs.size(); I--;) {
+    const FunctionSummary &F = NewFuncs[I];
+    if (!F.Name.empty())
+      ByName[F.Name] = I;
+    else if (F.ID.NameHash)
+      ByNameHash[F.ID.NameHash].push_back(I);
+    else
+      ByHash[F.ShapeHash ^ (F.FixupHash * 31)].push_back(I);
+  }
+  auto PopMatch = [&](DenseMap<uint64_t, SmallVector<unsigned, 1>> &Map,
+                      uint64_t Key) -> FunctionSummary * {
+    auto It = Map.find(Key);
+    if (It == Map.end() || It->second.empty())
+      return nullptr;
+    FunctionSummary *Match = &NewFuncs[It->second.back()];
+    It->second.pop_back();
+    return Match;
+  };
+
+  unsigned NumMatched = 0, NumRemoved = 0, NumLayoutChanged = 0,
+           NumFixupsChanged = 0, NumCodeChanged = 0;
+  for (FunctionSummary &F : OldFuncs) {
+    FunctionSummary *Match = nullptr;
+    if (!F.Name.empty()) {
+      auto It = ByName.find(F.Name);
+      if (It != ByName.end())
+        Match = &NewFuncs[It->second];
+    } else if (F.ID.NameHash) {
+      Match = PopMatch(ByNameHash, F.ID.NameHash);
+    } else {
+      Match = PopMatch(ByHash, F.ShapeHash ^ (F.FixupHash * 31));
+    }
+    if (!Match) {
+      printFunction(OS, '-', F);
+      ++NumRemoved;
+      continue;
+    }
+    Match->Matched = true;
+    ++NumMatched;
+
+    bool LayoutChanged = F.ShapeHash != Match->ShapeHash;
+    bool FixupsChanged = F.FixupHash != Match->FixupHash;
+    // The instructions may change within the same shape (-ccr-function-hashes)
+    bool CodeChanged = F.ID.ContentHash && Match->ID.ContentHash &&
+                       F.ID.ContentHash != Match->ID.ContentHash;
+    NumLayoutChanged += LayoutChanged;
+    NumFixupsChanged += FixupsChanged;
+    NumCodeChanged += CodeChanged;
+    if (!LayoutChanged && !FixupsChanged && !CodeChanged)
+      continue;
+    OS << "~ " << (F.Name.empty() ? "<unnamed>" : F.Name) << " @ .text+"
+       << format_hex(F.Offset, 1);
+    if (Match->Offset != F.Offset)
+      OS << " -> " << format_hex(Match->Offset, 1);
+    OS << ":";
+    if (LayoutChanged)
+      OS << " layout (" << F.NumBBLs << " -> " << Match->NumBBLs << " BBLs, "
+         << F.Size << " -> " << Match->Size << " bytes)";
+    if (FixupsChanged)
+      OS << " fixups (" << F.NumFixups << " -> " << Match->NumFixups << ")";
+    if (CodeChanged)
+      OS << " code";
+    OS << "\n";
+  }
+
+  unsigned NumAdded = 0;
+  for (const FunctionSummary &F : NewFuncs)
+    if (!F.Matched) {
+      printFunction(OS, '+', F);
+      ++NumAdded;
+    }
+
+  OS << "\n";
+  printCount(OS, "Functions", OldFuncs.size(), NewFuncs.size());
+  OS << "  matched " << NumMatched << ", removed " << NumRemoved << ", added "
+     << NumAdded << "\n";
+  OS << "  layout changed " << NumLayoutChanged << ", fixups changed "
+     << NumFixupsChanged << ", code changed " << NumCodeChanged << "\n";
+  printCount(OS, "BBLs", OldOrErr->NumBBLs, NewOrErr->NumBBLs);
+  for (unsigned K = 0; K != NumFixupKinds; ++K)
+    printCount(OS, ("Fixups in " + getFixupKindSectionName((FixupKind)K)).str(),
+               OldOrErr->NumFixups[K], NewOrErr->NumFixups[K]);
+  printCount(OS, ".rand bytes", OldOrErr->RandSize, NewOrErr->RandSize);
+
+  bool Differ = NumRemoved || NumAdded || NumLayoutChanged ||
+                NumFixupsChanged || NumCodeChanged;
+  for (unsigned K = 1; K != NumFixupKinds; ++K)
+    Differ |= OldOrErr->NumFixups[K] != NewOrErr->NumFixups[K];
+  return Differ;
+}
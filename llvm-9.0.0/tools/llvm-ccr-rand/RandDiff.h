@@ -0,0 +1,41 @@
+//===- RandDiff.h - Structural diff of two .rand sections -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A byte diff of two .rand sections (or of their dumps) tells nothing
+// once a single function has moved: every offset after it changes. -diff
+// decodes both sections, condenses every function into its shape (the sizes,
+// types and alignment of its BBLs) and its fixups (relative to the start of
+// the function), and pairs the functions of the two builds by their symbols,
+// by the name hashes the compiler has recorded if the binaries are stripped,
+// or by their shapes if they have neither. With -ccr-function-hashes, a
+// function whose instructions changed in the same shape is reported as well. Only the functions that were added,
+// removed or changed are reported, in time linear in the size of the inputs.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_RANDDIFF_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_RANDDIFF_H
+
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace ccr {
+
+/// Print the differences between the .rand sections of \p Old and \p New
+/// to \p OS: every function added, removed or changed, followed by the
+/// totals. Returns whether the sections differ.
+Expected<bool> diffRandSections(const object::ELF64LEObjectFile &Old,
+                                const object::ELF64LEObjectFile &New,
+                                raw_ostream &OS);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_RANDDIFF_H
@@ -0,0 +1,527 @@
+//===- RandIndex.cpp - Pre-analysed, mappable .rand index -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Layout of an index file (all little-endian):
+//   IndexHeader
+//   uint32 SourceTypes[NumObjects]
+//   uint8 ObjectFlags[NumObjects]           (EH info: bit 0, d2d fixups: 1)
+//   IndexBasicBlock BasicBlocks[NumBBLs]
+//   IndexFixup Fixups[NumFixups[FK_Text]] ... Fixups[NumFixups[FK_Custom]]
+//   IndexCallSiteTable CallSiteTables[NumCallSiteTables]
+//   IndexFunction Functions[NumFunctions]     (ascending offsets, identities)
+//   uint32 IncomingFixups[NumIncomingFixups]  (FixupRef, by target function)
+//   { uint32 Length; char Name[Length]; } SectionNames[NumSectionNames]
+//
+//===----------------------------------------------------------------------===//
+
+#include "RandIndex.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/BinaryByteStream.h"
+#include "llvm/Support/BinaryStreamReader.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::support;
+
+static const char IndexMagic[8] = {'C', 'C', 'R', 'R', 'I', 'D', 'X', '\0'};
+static const uint32_t IndexVersion = 25;
+
+namespace {
+struct IndexHeader {
+  char Magic[8];
+  ulittle32_t Version;
+  ulittle32_t FormatVersion;
+  ulittle64_t Key;
+  ulittle64_t RandObjOffset;
+  ulittle64_t MainAddrOffset;
+  ulittle64_t ObjSize;
+  ulittle32_t NumObjects;
+  ulittle32_t NumBBLs;
+  ulittle32_t NumFixups[NumFixupKinds];
+  ulittle32_t NumSectionNames;
+  ulittle32_t NumCallSiteTables;
+  ulittle32_t NumFunctions;
+  ulittle32_t NumIncomingFixups;
+};
+
+struct IndexBasicBlock {
+  ulittle32_t Size;
+  ulittle32_t PaddingSize;
+  uint8_t Type;
+  uint8_t Flags; // Fall-through (bit 0), loop header (1), CFI (2), pinned (3)
+  uint8_t Hotness;
+  uint8_t AlignLog2;
+  uint8_t Term; // Size of the last instruction | its kind << 4
+  uint8_t Boundary; // Size of the padded instruction | log2 of its window << 4
+  uint8_t Reserved;
+  uint8_t Placement; // Section class (bits 5-7), chain start (bit 4), edge prob.
+  ulittle32_t BoundaryOffset;
+};
+
+struct IndexFixup {
+  ulittle64_t Offset;
+  ulittle32_t DerefSize;
+  ulittle16_t Type;
+  uint8_t PairDelta;
+  uint8_t Reserved;
+  ulittle32_t NumJTEntries;
+  ulittle32_t JTEntrySize;
+  little32_t OwnerBBL;
+  uint8_t IsRela; // PC-relative (bit 0), GOT relaxation (bits 1-2)
+  uint8_t RelaxShortSize;
+  uint8_t RelaxLongSize;
+  uint8_t RelaxFixupOffset;
+  uint8_t RelaxLongForm[8];
+  uint8_t Target;
+  uint8_t RefClass;
+  uint8_t JTFunctionRelative;
+  uint8_t Scope;
+  ulittle32_t SectionIdx;
+  uint8_t ShrinkLongSize;
+  uint8_t ShrinkShortSize;
+  uint8_t ShrinkShortForm[6];
+};
+
+struct IndexCallSiteTable {
+  ulittle64_t FunctionOffset;
+  ulittle64_t TableOffset;
+  ulittle32_t NumRecords;
+  ulittle32_t Reserved;
+};
+
+// The BBLs and the run of .text fixups of a function, its identity, and the
+// run of the fixups (of any list) into it
+struct IndexFunction {
+  ulittle64_t Offset;
+  ulittle32_t FirstBBL;
+  ulittle32_t NumBBLs;
+  ulittle32_t FirstFixup;
+  ulittle32_t NumFixups;
+  ulittle64_t NameHash;
+  ulittle64_t ContentHash;
+  ulittle32_t FirstIncoming;
+  ulittle32_t NumIncoming;
+};
+} // end anonymous namespace
+
+static_assert(sizeof(IndexBasicBlock) == 20, "Unexpected padding!");
+static_assert(sizeof(IndexFixup) == 56, "Unexpected padding!");
+static_assert(sizeof(IndexCallSiteTable) == 24, "Unexpected padding!");
+static_assert(sizeof(IndexFunction) == 48, "Unexpected padding!");
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// Returns false if the record is invalid
+static bool decodeBasicBlock(const IndexBasicBlock &In, BasicBlockInfo &Out) {
+  Out.Size = In.Size;
+  Out.Type = In.Type;
+  Out.FallThrough = In.Flags & 1;
+  Out.Hotness = In.Hotness;
+  Out.PaddingSize = In.PaddingSize;
+  Out.AlignLog2 = In.AlignLog2;
+  Out.LoopHeader = (In.Flags >> 1) & 1;
+  Out.HasCFI = (In.Flags >> 2) & 1;
+  Out.Pinned = (In.Flags >> 3) & 1;
+  Out.TermSize = In.Term & 15;
+  Out.TermKind = In.Term >> 4;
+  Out.SectionClass = In.Placement >> 5;
+  Out.ChainStart = (In.Placement >> 4) & 1;
+  Out.EdgeProb = In.Placement & 15;
+  Out.BoundarySize = In.Boundary & 15;
+  Out.BoundaryLog2 = In.Boundary >> 4;
+  Out.BoundaryOffset = In.BoundaryOffset;
+  return Out.SectionClass < NumSectionClasses && In.PaddingSize <= In.Size &&
+         In.AlignLog2 <= 15 && Out.TermKind <= TK_Indirect &&
+         Out.TermSize <= In.Size - In.PaddingSize &&
+         uint64_t(Out.BoundaryOffset) + Out.BoundarySize <=
+             In.Size - In.PaddingSize;
+}
+
+static bool decodeFixup(const IndexFixup &In, FixupInfo &Out, size_t NumBBLs) {
+  Out.Offset = In.Offset;
+  Out.DerefSize = In.DerefSize;
+  Out.IsRela = In.IsRela & 1;
+  Out.GOTRelax = In.IsRela >> 1;
+  Out.Target = In.Target;
+  Out.RefClass = In.RefClass;
+  Out.Scope = In.Scope;
+  Out.Type = In.Type;
+  Out.PairDelta = In.PairDelta;
+  Out.NumJTEntries = In.NumJTEntries;
+  Out.JTEntrySize = In.JTEntrySize;
+  Out.JTFunctionRelative = In.JTFunctionRelative;
+  Out.OwnerBBL = In.OwnerBBL;
+  Out.SectionIdx = In.SectionIdx;
+  Out.RelaxShortSize = In.RelaxShortSize;
+  Out.RelaxLongSize = In.RelaxLongSize;
+  Out.RelaxFixupOffset = In.RelaxFixupOffset;
+  memcpy(Out.RelaxLongForm, In.RelaxLongForm, sizeof(In.RelaxLongForm));
+  Out.ShrinkLongSize = In.ShrinkLongSize;
+  Out.ShrinkShortSize = In.ShrinkShortSize;
+  memcpy(Out.ShrinkShortForm, In.ShrinkShortForm, sizeof(In.ShrinkShortForm));
+  return Out.OwnerBBL < (int64_t)NumBBLs &&
+         Out.RelaxLongSize <= sizeof(In.RelaxLongForm) &&
+         Out.ShrinkShortSize <= sizeof(In.ShrinkShortForm) &&
+         Out.Scope <= FS_IntraFunction &&
+         Out.GOTRelax <= FGR_RexGOTPCRELX;
+}
+
+uint64_t llvm::ccr::getRandIndexKey(ArrayRef<uint8_t> RandContents) {
+  return xxHash64(RandContents);
+}
+
+Expected<RandInfo> llvm::ccr::readRandIndex(StringRef Path, uint64_t Key) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(
+      Path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return errorCodeToError(BufOrErr.getError());
+  return readRandIndex(arrayRefFromStringRef((*BufOrErr)->getBuffer()), Key,
+                       Path);
+}
+
+Expected<RandInfo> llvm::ccr::readRandIndex(ArrayRef<uint8_t> Data,
+                                            uint64_t Key, StringRef Path) {
+  BinaryByteStream Stream(Data, support::little);
+  BinaryStreamReader Reader(Stream);
+
+  const IndexHeader *H;
+  if (Reader.readObject(H) || memcmp(H->Magic, IndexMagic, sizeof(IndexMagic)) ||
+      H->Version != IndexVersion)
+    return makeError("'" + Path + "' is not a .rand index");
+  if (H->Key != Key)
+    return makeError("'" + Path + "' has been built for another binary");
+
+  RandInfo Info;
+  Info.FormatVersion = H->FormatVersion;
+  Info.RandObjOffset = H->RandObjOffset;
+  Info.MainAddrOffset = H->MainAddrOffset;
+  Info.ObjSize = H->ObjSize;
+
+  auto Truncated = [&]() { return makeError("'" + Path + "' is truncated"); };
+
+  ArrayRef<ulittle32_t> SourceTypes;
+  if (Reader.readArray(SourceTypes, H->NumObjects))
+    return Truncated();
+  Info.SourceTypes.assign(SourceTypes.begin(), SourceTypes.end());
+  ArrayRef<uint8_t> ObjectFlags;
+  if (Reader.readArray(ObjectFlags, H->NumObjects))
+    return Truncated();
+  for (uint8_t Flags : ObjectFlags) {
+    Info.EHInfo.push_back(Flags & 1);
+    Info.DataFixups.push_back((Flags >> 1) & 1);
+  }
+
+  ArrayRef<IndexBasicBlock> BBLs;
+  if (Reader.readArray(BBLs, H->NumBBLs))
+    return Truncated();
+  Info.BasicBlocks.resize(BBLs.size());
+  for (size_t I = 0, E = BBLs.size(); I != E; ++I)
+    if (!decodeBasicBlock(BBLs[I], Info.BasicBlocks[I]))
+      return makeError("'" + Path + "' has an invalid BBL alignment");
+
+  for (unsigned K = 0; K < NumFixupKinds; ++K) {
+    ArrayRef<IndexFixup> Fixups;
+    if (Reader.readArray(Fixups, H->NumFixups[K]))
+      return Truncated();
+    std::vector<FixupInfo> &Out = Info.Fixups[K];
+    Out.resize(Fixups.size());
+    for (size_t I = 0, E = Fixups.size(); I != E; ++I)
+      if (!decodeFixup(Fixups[I], Out[I], Info.BasicBlocks.size()))
+        return makeError("'" + Path + "' has an invalid fixup");
+  }
+
+  ArrayRef<IndexCallSiteTable> Tables;
+  if (Reader.readArray(Tables, H->NumCallSiteTables))
+    return Truncated();
+  Info.CallSiteTables.resize(Tables.size());
+  for (size_t I = 0, E = Tables.size(); I != E; ++I) {
+    Info.CallSiteTables[I].FunctionOffset = Tables[I].FunctionOffset;
+    Info.CallSiteTables[I].TableOffset = Tables[I].TableOffset;
+    Info.CallSiteTables[I].NumRecords = Tables[I].NumRecords;
+  }
+  // The function table is for RandIndexView, but for the identities
+  ArrayRef<IndexFunction> Functions;
+  if (Reader.readArray(Functions, H->NumFunctions))
+    return Truncated();
+  ArrayRef<ulittle32_t> Incoming;
+  if (Reader.readArray(Incoming, H->NumIncomingFixups))
+    return Truncated();
+  if (H->NumIncomingFixups) {
+    Info.IncomingBegin.resize(Functions.size() + 1);
+    for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+      if (Functions[I].FirstIncoming != Info.IncomingBegin[I])
+        return makeError("'" + Path + "' has invalid incoming fixups");
+      Info.IncomingBegin[I + 1] =
+          Functions[I].FirstIncoming + Functions[I].NumIncoming;
+    }
+    if (Info.IncomingBegin.back() != H->NumIncomingFixups)
+      return makeError("'" + Path + "' has invalid incoming fixups");
+    Info.IncomingFixups.resize(Incoming.size());
+    for (size_t I = 0, E = Incoming.size(); I != E; ++I) {
+      FixupRef &Ref = Info.IncomingFixups[I];
+      Ref.Raw = Incoming[I];
+      if (Ref.getKind() >= NumFixupKinds ||
+          Ref.getIndex() >= Info.Fixups[Ref.getKind()].size())
+        return makeError("'" + Path + "' has invalid incoming fixups");
+    }
+  }
+  for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+    if (!Functions[I].NameHash && !Functions[I].ContentHash)
+      continue;
+    Info.FunctionIDs.resize(E);
+    Info.FunctionIDs[I].NameHash = Functions[I].NameHash;
+    Info.FunctionIDs[I].ContentHash = Functions[I].ContentHash;
+  }
+
+  for (uint32_t I = 0; I < H->NumSectionNames; ++I) {
+    uint32_t Length;
+    StringRef Name;
+    if (Reader.readInteger(Length) || Reader.readFixedString(Name, Length))
+      return Truncated();
+    Info.SectionNames.push_back(Name);
+  }
+  return std::move(Info);
+}
+
+Error llvm::ccr::writeRandIndex(StringRef Path, uint64_t Key,
+                                const RandInfo &Info) {
+  // Write to a temporary file first, thus a concurrent reader never sees a
+  // partial index
+  SmallString<128> TmpPath;
+  int FD;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + ".tmp%%%%%%", FD, TmpPath))
+    return errorCodeToError(EC);
+
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    endian::Writer W(OS, support::little);
+
+    OS.write(IndexMagic, sizeof(IndexMagic));
+    W.write<uint32_t>(IndexVersion);
+    W.write<uint32_t>(Info.FormatVersion);
+    W.write<uint64_t>(Key);
+    W.write<uint64_t>(Info.RandObjOffset);
+    W.write<uint64_t>(Info.MainAddrOffset);
+    W.write<uint64_t>(Info.ObjSize);
+    W.write<uint32_t>(Info.SourceTypes.size());
+    W.write<uint32_t>(Info.BasicBlocks.size());
+    for (unsigned K = 0; K < NumFixupKinds; ++K)
+      W.write<uint32_t>(Info.Fixups[K].size());
+    W.write<uint32_t>(Info.SectionNames.size());
+    W.write<uint32_t>(Info.CallSiteTables.size());
+    size_t NumFunctions = countFunctions(Info.BasicBlocks);
+    bool Incoming = Info.IncomingBegin.size() == NumFunctions + 1;
+
+    // A function ends at the end of MF or of its object (as in the Layout)
+    std::vector<IndexFunction> Functions;
+    ArrayRef<FixupInfo> TextFixups = Info.Fixups[FK_Text];
+    assert(std::is_sorted(TextFixups.begin(), TextFixups.end(),
+                          [](const FixupInfo &A, const FixupInfo &B) {
+                            return A.Offset < B.Offset;
+                          }) &&
+           "The .text fixups are not sorted!");
+    auto FixupsFrom = [&](uint64_t Offset) -> uint32_t {
+      return std::lower_bound(TextFixups.begin(), TextFixups.end(), Offset,
+                              [](const FixupInfo &F, uint64_t Offset) {
+                                return F.Offset < Offset;
+                              }) -
+             TextFixups.begin();
+    };
+    uint64_t Offset = Info.RandObjOffset, FuncOffset = Offset;
+    unsigned FirstBBL = 0;
+    for (size_t I = 0, E = Info.BasicBlocks.size(); I != E; ++I) {
+      Offset += Info.BasicBlocks[I].Size;
+      if (Info.BasicBlocks[I].Type == BBT_Block && I + 1 != E)
+        continue;
+      IndexFunction F;
+      F.Offset = FuncOffset;
+      F.FirstBBL = FirstBBL;
+      F.NumBBLs = I + 1 - FirstBBL;
+      F.FirstFixup = FixupsFrom(FuncOffset);
+      F.NumFixups = FixupsFrom(Offset) - F.FirstFixup;
+      FunctionIdentity ID = Info.getFunctionID(Functions.size());
+      F.NameHash = ID.NameHash;
+      F.ContentHash = ID.ContentHash;
+      F.FirstIncoming = Incoming ? Info.IncomingBegin[Functions.size()] : 0;
+      F.NumIncoming =
+          Incoming ? Info.IncomingBegin[Functions.size() + 1] - F.FirstIncoming
+                   : 0;
+      Functions.push_back(F);
+      FirstBBL = I + 1;
+      FuncOffset = Offset;
+    }
+    W.write<uint32_t>(Functions.size());
+    W.write<uint32_t>(Incoming ? Info.IncomingFixups.size() : 0);
+
+    for (uint32_t SourceType : Info.SourceTypes)
+      W.write<uint32_t>(SourceType);
+    for (unsigned I = 0, E = Info.SourceTypes.size(); I != E; ++I)
+      W.write<uint8_t>(Info.hasEHInfo(I) | Info.hasDataFixups(I) << 1);
+    for (const BasicBlockInfo &BBL : Info.BasicBlocks) {
+      W.write<uint32_t>(BBL.Size);
+      W.write<uint32_t>(BBL.PaddingSize);
+      W.write<uint8_t>(BBL.Type);
+      W.write<uint8_t>(BBL.FallThrough | BBL.LoopHeader << 1 | BBL.HasCFI << 2 |
+                       BBL.Pinned << 3);
+      W.write<uint8_t>(BBL.Hotness);
+      W.write<uint8_t>(BBL.AlignLog2);
+      W.write<uint8_t>(BBL.TermSize | BBL.TermKind << 4);
+      W.write<uint8_t>(BBL.BoundarySize | BBL.BoundaryLog2 << 4);
+      W.write<uint8_t>(0);
+      W.write<uint8_t>(BBL.SectionClass << 5 | BBL.ChainStart << 4 |
+                       BBL.EdgeProb);
+      W.write<uint32_t>(BBL.BoundaryOffset);
+    }
+    for (unsigned K = 0; K < NumFixupKinds; ++K)
+      for (const FixupInfo &F : Info.Fixups[K]) {
+        W.write<uint64_t>(F.Offset);
+        W.write<uint32_t>(F.DerefSize);
+        W.write<uint16_t>(F.Type);
+        W.write<uint8_t>(F.PairDelta);
+        OS.write_zeros(1);
+        W.write<uint32_t>(F.NumJTEntries);
+        W.write<uint32_t>(F.JTEntrySize);
+        W.write<int32_t>(F.OwnerBBL);
+        W.write<uint8_t>(F.IsRela | F.GOTRelax << 1);
+        W.write<uint8_t>(F.RelaxShortSize);
+        W.write<uint8_t>(F.RelaxLongSize);
+        W.write<uint8_t>(F.RelaxFixupOffset);
+        OS.write(reinterpret_cast<const char *>(F.RelaxLongForm),
+                 sizeof(F.RelaxLongForm));
+        W.write<uint8_t>(F.Target);
+        W.write<uint8_t>(F.RefClass);
+        W.write<uint8_t>(F.JTFunctionRelative);
+        W.write<uint8_t>(F.Scope);
+        W.write<uint32_t>(F.SectionIdx);
+        W.write<uint8_t>(F.ShrinkLongSize);
+        W.write<uint8_t>(F.ShrinkShortSize);
+        OS.write(reinterpret_cast<const char *>(F.ShrinkShortForm),
+                 sizeof(F.ShrinkShortForm));
+      }
+    for (const CallSiteTableInfo &T : Info.CallSiteTables) {
+      W.write<uint64_t>(T.FunctionOffset);
+      W.write<uint64_t>(T.TableOffset);
+      W.write<uint32_t>(T.NumRecords);
+      OS.write_zeros(4);
+    }
+    OS.write(reinterpret_cast<const char *>(Functions.data()),
+             Functions.size() * sizeof(IndexFunction));
+    if (Incoming)
+      for (FixupRef Ref : Info.IncomingFixups)
+        W.write<uint32_t>(Ref.Raw);
+    for (const std::string &Name : Info.SectionNames) {
+      W.write<uint32_t>(Name.size());
+      OS << Name;
+    }
+
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TmpPath);
+      return makeError("Cannot write the .rand index '" + Path + "'");
+    }
+  }
+
+  if (std::error_code EC = sys::fs::rename(TmpPath, Path)) {
+    sys::fs::remove(TmpPath);
+    return errorCodeToError(EC);
+  }
+  return Error::success();
+}
+
+Expected<RandIndexView> RandIndexView::create(ArrayRef<uint8_t> Data,
+                                              uint64_t Key, StringRef Path) {
+  BinaryByteStream Stream(Data, support::little);
+  BinaryStreamReader Reader(Stream);
+  const IndexHeader *H;
+  if (Reader.readObject(H) || memcmp(H->Magic, IndexMagic, sizeof(IndexMagic)) ||
+      H->Version != IndexVersion)
+    return makeError("'" + Path + "' is not a .rand index");
+  if (H->Key != Key)
+    return makeError("'" + Path + "' has been built for another binary");
+
+  uint64_t NumFixups = 0;
+  for (unsigned K = 0; K < NumFixupKinds; ++K)
+    NumFixups += H->NumFixups[K];
+  RandIndexView View;
+  View.NumBBLs = H->NumBBLs;
+  View.NumTextFixups = H->NumFixups[FK_Text];
+  View.NumFunctions = H->NumFunctions;
+  uint64_t BBLsAt = sizeof(IndexHeader) + (uint64_t)H->NumObjects * 5;
+  uint64_t FixupsAt = BBLsAt + (uint64_t)H->NumBBLs * sizeof(IndexBasicBlock);
+  uint64_t FunctionsAt = FixupsAt + NumFixups * sizeof(IndexFixup) +
+                         (uint64_t)H->NumCallSiteTables *
+                             sizeof(IndexCallSiteTable);
+  uint64_t IncomingAt =
+      FunctionsAt + (uint64_t)H->NumFunctions * sizeof(IndexFunction);
+  if (IncomingAt + (uint64_t)H->NumIncomingFixups * 4 > Data.size())
+    return makeError("'" + Path + "' is truncated");
+  View.BBLs = Data.data() + BBLsAt;
+  View.TextFixups = Data.data() + FixupsAt;
+  View.Functions = Data.data() + FunctionsAt;
+  View.Incoming = Data.data() + IncomingAt;
+  View.NumIncoming = H->NumIncomingFixups;
+  return View;
+}
+
+Expected<Optional<IndexedFunction>>
+RandIndexView::lookup(uint64_t Offset) const {
+  ArrayRef<IndexFunction> Funcs(
+      reinterpret_cast<const IndexFunction *>(Functions), NumFunctions);
+  auto It = std::upper_bound(
+      Funcs.begin(), Funcs.end(), Offset,
+      [](uint64_t Offset, const IndexFunction &F) { return Offset < F.Offset; });
+  if (It == Funcs.begin())
+    return None;
+  const IndexFunction &F = *std::prev(It);
+  if ((uint64_t)F.FirstBBL + F.NumBBLs > NumBBLs ||
+      (uint64_t)F.FirstFixup + F.NumFixups > NumTextFixups ||
+      (uint64_t)F.FirstIncoming + F.NumIncoming > NumIncoming)
+    return makeError("The function at .text+" + Twine::utohexstr(F.Offset) +
+                     " is out of the index");
+
+  IndexedFunction Out;
+  Out.Offset = F.Offset;
+  Out.FirstBBL = F.FirstBBL;
+  Out.ID.NameHash = F.NameHash;
+  Out.ID.ContentHash = F.ContentHash;
+  Out.BasicBlocks.resize(F.NumBBLs);
+  const auto *InBBLs = reinterpret_cast<const IndexBasicBlock *>(BBLs);
+  uint64_t End = F.Offset;
+  for (uint32_t I = 0; I < F.NumBBLs; ++I) {
+    if (!decodeBasicBlock(InBBLs[F.FirstBBL + I], Out.BasicBlocks[I]))
+      return makeError("The index has an invalid BBL alignment");
+    End += Out.BasicBlocks[I].Size;
+  }
+  // The last function of the index ends with its BBLs, not at the next one
+  if (Offset >= End)
+    return None;
+
+  Out.Fixups.resize(F.NumFixups);
+  const auto *InFixups = reinterpret_cast<const IndexFixup *>(TextFixups);
+  for (uint32_t I = 0; I < F.NumFixups; ++I)
+    if (!decodeFixup(InFixups[F.FirstFixup + I], Out.Fixups[I], NumBBLs))
+      return makeError("The index has an invalid fixup");
+  const auto *InIncoming = reinterpret_cast<const ulittle32_t *>(Incoming);
+  Out.Incoming.resize(F.NumIncoming);
+  for (uint32_t I = 0; I < F.NumIncoming; ++I)
+    Out.Incoming[I].Raw = InIncoming[F.FirstIncoming + I];
+  return Optional<IndexedFunction>(std::move(Out));
+}
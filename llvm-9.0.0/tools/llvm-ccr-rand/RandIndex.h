@@ -0,0 +1,93 @@
+//===- RandIndex.h - Pre-analysed, mappable .rand index ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Binaries are re-randomized periodically (i.e., on every restart), yet
+// each run would inflate, parse and analyse the same .rand section again. The
+// index persists the decoded RandInfo (BBL boundaries, fall-through flags,
+// per-object source types, fixups with their owner BBLs, jump table sizes
+// and relaxations) as fixed-size little-endian records that can be read from
+// a mapped file, so a new shuffle is pure permutation plus patching.
+//
+// The index is keyed by the hash of the raw .rand section; a stale index
+// (i.e., the binary has been rebuilt) does not match and is regenerated.
+//
+// A tool that needs a single function (e.g., a symbolizer or the check of one
+// function) looks it up in the function table of the index with
+// RandIndexView instead, which decodes that function only. The table tells
+// the fixups into each function as well (a CSR adjacency over all the fixup
+// lists), thus moving one function patches its references only.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_RANDINDEX_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_RANDINDEX_H
+
+#include "RandInfo.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+
+/// Key of the index for the raw contents of a .rand section.
+uint64_t getRandIndexKey(ArrayRef<uint8_t> RandContents);
+
+/// Read the index at \p Path; fails unless it has been built for \p Key.
+Expected<RandInfo> readRandIndex(StringRef Path, uint64_t Key);
+
+/// Read the index in \p Data (e.g., mapped by a loader), named \p Path in
+/// the errors.
+Expected<RandInfo> readRandIndex(ArrayRef<uint8_t> Data, uint64_t Key,
+                                 StringRef Path);
+
+/// Write the index of \p Info (with the fixup owners computed) to \p Path.
+Error writeRandIndex(StringRef Path, uint64_t Key, const RandInfo &Info);
+
+/// The metadata of one function, as decoded from the index.
+struct IndexedFunction {
+  uint64_t Offset = 0;   // Of the first BBL from the start of .text
+  unsigned FirstBBL = 0; // Index of the first BBL in the whole layout
+  FunctionIdentity ID;
+  std::vector<BasicBlockInfo> BasicBlocks;
+  std::vector<FixupInfo> Fixups; // The .text fixups, in ascending offsets
+  std::vector<FixupRef> Incoming; // The fixups into it, of the whole index
+};
+
+/// Random access to the functions of a (mapped) index: a lookup is a binary
+/// search over the function table, sorted by offset, and decodes the BBLs
+/// and .text fixups of the function found. \p Data must outlive the view.
+class RandIndexView {
+  const uint8_t *BBLs = nullptr;
+  const uint8_t *TextFixups = nullptr;
+  const uint8_t *Functions = nullptr;
+  const uint8_t *Incoming = nullptr;
+  uint32_t NumBBLs = 0;
+  uint32_t NumTextFixups = 0;
+  uint32_t NumFunctions = 0;
+  uint32_t NumIncoming = 0;
+
+  RandIndexView() = default;
+
+public:
+  static Expected<RandIndexView> create(ArrayRef<uint8_t> Data, uint64_t Key,
+                                        StringRef Path);
+
+  uint32_t getNumFunctions() const { return NumFunctions; }
+
+  /// The function whose BBLs cover the .text offset \p Offset, if any.
+  Expected<Optional<IndexedFunction>> lookup(uint64_t Offset) const;
+};
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_RANDINDEX_H
@@ -0,0 +1,754 @@
+//===- RandInfo.cpp - Decoded CCR reordering information ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "RandInfo.h"
+#include "TranslationMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Object/Decompressor.h"
+#include "llvm/Object/RandChunk.h"
+#include "llvm/Support/Parallel.h"
+#ifndef CCR_NO_PROTOBUF
+#include "llvm/Support/shuffleInfoReader.h"
+#endif
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+StringRef llvm::ccr::getFixupKindSectionName(FixupKind Kind) {
+  switch (Kind) {
+  case FK_Text:      return ".text";
+  case FK_Rodata:    return ".rodata";
+  case FK_Data:      return ".data";
+  case FK_DataRel:   return ".data.rel.ro";
+  case FK_InitArray: return ".init_array";
+  case FK_FiniArray: return ".fini_array";
+  case FK_TData:     return ".tdata";
+  case FK_XRay:      return "xray_instr_map";
+  case FK_PatchableEntries: return "__patchable_function_entries";
+  case FK_JumpTable: return "__jump_table";
+  case FK_Custom:    return "custom";
+  default:           llvm_unreachable("[CCR-Error] Unknown fixup kind!");
+  }
+}
+
+SectionClass llvm::ccr::getSectionClass(StringRef Name) {
+  static const std::pair<StringRef, SectionClass> Prefixes[] = {
+      {".text.hot", SC_Hot},
+      {".text.unlikely", SC_Unlikely},
+      {".text.startup", SC_Startup},
+      {".text.exit", SC_Exit}};
+  for (const auto &P : Prefixes)
+    if (Name.startswith(P.first) &&
+        (Name.size() == P.first.size() || Name[P.first.size()] == '.'))
+      return P.second;
+  return SC_Text;
+}
+
+unsigned RandInfo::getNumObjects() const {
+  unsigned NumObjects = 0;
+  for (const BasicBlockInfo &BBL : BasicBlocks)
+    if (BBL.Type == BBT_ObjectEnd)
+      NumObjects++;
+  // The linker may drop the end-of-object mark of the last object
+  if (!BasicBlocks.empty() && BasicBlocks.back().Type != BBT_ObjectEnd)
+    NumObjects++;
+  return NumObjects;
+}
+
+size_t llvm::ccr::countFunctions(ArrayRef<BasicBlockInfo> BasicBlocks) {
+  size_t NumFunctions = 0;
+  for (const BasicBlockInfo &BBL : BasicBlocks)
+    if (BBL.Type != BBT_Block)
+      NumFunctions++;
+  if (!BasicBlocks.empty() && BasicBlocks.back().Type == BBT_Block)
+    NumFunctions++;
+  return NumFunctions;
+}
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// Koo: The load-time engine (see LoadTime.h) reads the index only, thus it is
+//      built without the protobuf runtime (-DCCR_NO_PROTOBUF)
+#ifndef CCR_NO_PROTOBUF
+
+// Fetch the Width-bit value of the Idx-th element from a packed bitfield column
+template <class ColumnT>
+static uint64_t getBits(const ColumnT &Bits, unsigned Idx, unsigned Width) {
+  unsigned PerWord = 64 / Width;
+  if (Idx / PerWord >= (unsigned)Bits.size())
+    return 0;
+  return (Bits.Get(Idx / PerWord) >> ((Idx % PerWord) * Width)) &
+         ((1ULL << Width) - 1);
+}
+
+// Set the last instruction of BBL from LayoutInfo.term (size | kind << 4);
+// returns false if it is not within the code of the BBL
+static bool setTerminator(BasicBlockInfo &BBL, uint32_t Term) {
+  BBL.TermSize = Term & 15;
+  BBL.TermKind = Term >> 4;
+  return BBL.TermKind <= TK_Indirect &&
+         BBL.TermSize <= BBL.Size - BBL.PaddingSize;
+}
+
+// Set the padded instruction of BBL from LayoutInfo.boundary (size | log2 << 4
+// | offset << 8); returns false if it is not within the code of the BBL
+static bool setBoundary(BasicBlockInfo &BBL, uint32_t Boundary) {
+  BBL.BoundarySize = Boundary & 15;
+  BBL.BoundaryLog2 = (Boundary >> 4) & 15;
+  BBL.BoundaryOffset = Boundary >> 8;
+  if (!BBL.BoundaryLog2)
+    BBL.BoundarySize = BBL.BoundaryOffset = 0;
+  return uint64_t(BBL.BoundaryOffset) + BBL.BoundarySize <=
+         BBL.Size - BBL.PaddingSize;
+}
+
+static Error setRelaxation(FixupInfo &F, uint32_t ShortSize, StringRef LongForm,
+                           uint32_t FixupOffset) {
+  if (ShortSize == 0)
+    return Error::success();
+  if (ShortSize < F.DerefSize || LongForm.size() <= ShortSize ||
+      LongForm.size() > sizeof(F.RelaxLongForm) ||
+      FixupOffset + 4 != LongForm.size())
+    return makeError("Invalid relaxation of the fixup at " +
+                     Twine::utohexstr(F.Offset));
+  F.RelaxShortSize = ShortSize;
+  F.RelaxLongSize = LongForm.size();
+  F.RelaxFixupOffset = FixupOffset;
+  memcpy(F.RelaxLongForm, LongForm.data(), LongForm.size());
+  return Error::success();
+}
+
+static Error setShrink(FixupInfo &F, uint32_t LongSize, StringRef ShortForm) {
+  if (LongSize == 0)
+    return Error::success();
+  if (F.DerefSize != 4 || !F.IsRela || LongSize < F.DerefSize ||
+      LongSize > UINT8_MAX || ShortForm.size() < 2 ||
+      ShortForm.size() >= LongSize ||
+      ShortForm.size() > sizeof(F.ShrinkShortForm))
+    return makeError("Invalid short form of the fixup at " +
+                     Twine::utohexstr(F.Offset));
+  F.ShrinkLongSize = LongSize;
+  F.ShrinkShortSize = ShortForm.size();
+  memcpy(F.ShrinkShortForm, ShortForm.data(), ShortForm.size());
+  return Error::success();
+}
+
+static Error readFixups(
+    const google::protobuf::RepeatedPtrField<
+        ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple> &Tuples,
+    bool DeltaOffsets, std::vector<FixupInfo> &Out) {
+  uint32_t PrevOffset = 0;
+  Out.reserve(Out.size() + Tuples.size());
+  for (const auto &Tuple : Tuples) {
+    FixupInfo F;
+    // Deltas wrap around modulo 2^32 (see setFixups() in MCAssembler.cpp);
+    // only the absolute offsets reach past 4GB
+    F.Offset = DeltaOffsets ? uint32_t(PrevOffset + Tuple.offset()) : Tuple.offset();
+    F.DerefSize = Tuple.deref_sz();
+    F.IsRela = Tuple.is_rela();
+    F.Type = Tuple.type();
+    F.NumJTEntries = Tuple.num_jt_entries();
+    F.JTEntrySize = Tuple.jt_entry_sz();
+    F.JTFunctionRelative = Tuple.jt_func_rel();
+    if (Tuple.target() > FT_Data)
+      return makeError("Invalid target of the fixup at " + Twine::utohexstr(F.Offset));
+    F.Target = Tuple.target();
+    if (Tuple.ref_class() > FRC_TLS)
+      return makeError("Invalid reference class of the fixup at " +
+                       Twine::utohexstr(F.Offset));
+    F.RefClass = Tuple.ref_class();
+    if (Tuple.scope() > FS_IntraFunction)
+      return makeError("Invalid scope of the fixup at " + Twine::utohexstr(F.Offset));
+    F.Scope = Tuple.scope();
+    if (Tuple.pair_delta() > UINT8_MAX || Tuple.pair_delta() > Out.size())
+      return makeError("Invalid pair of the fixup at " + Twine::utohexstr(F.Offset));
+    F.PairDelta = Tuple.pair_delta();
+    if (Tuple.got_relax() > FGR_RexGOTPCRELX ||
+        (Tuple.got_relax() && (F.RefClass != FRC_GOT || !F.IsRela)))
+      return makeError("Invalid GOT relaxation of the fixup at " +
+                       Twine::utohexstr(F.Offset));
+    F.GOTRelax = Tuple.got_relax();
+    if (Error E = setRelaxation(F, Tuple.relax_short_sz(), Tuple.relax_long_form(),
+                                Tuple.relax_fixup_offset()))
+      return E;
+    if (Error E = setShrink(F, Tuple.shrink_long_sz(), Tuple.shrink_short_form()))
+      return E;
+    Out.push_back(F);
+    PrevOffset = uint32_t(F.Offset);
+  }
+  return Error::success();
+}
+
+// SectionBases (of a chunk) rebase the section-relative offsets of the fixups;
+// the fixups of a section that the linker has discarded (or folded) are dropped
+static Error readFixupColumns(const ShuffleInfo::ReorderInfo_FixupColumns &C,
+                              ArrayRef<uint64_t> SectionBases,
+                              std::vector<FixupInfo> &Out) {
+  int N = C.offset_delta_size();
+  if (C.deref_sz_size() != N || C.jt_fixup_idx_size() != C.num_jt_entries_size() ||
+      C.jt_fixup_idx_size() != C.jt_entry_sz_size() ||
+      (!SectionBases.empty() && C.section_idx_size() != N))
+    return makeError("Inconsistent fixup columns in the .rand section");
+
+  size_t Base = Out.size();
+  Out.resize(Base + N);
+  std::vector<bool> Discarded;
+  int64_t Offset = 0;
+  for (int I = 0; I < N; ++I) {
+    FixupInfo &F = Out[Base + I];
+    Offset += C.offset_delta(I);
+    F.Offset = Offset;
+    F.DerefSize = C.deref_sz(I);
+    F.IsRela = getBits(C.is_rela_bits(), I, 1);
+    F.Type = getBits(C.new_section_bits(), I, 1) ? 4 : 0;
+    F.Target = getBits(C.target_bits(), I, 2);
+    F.RefClass = getBits(C.ref_class_bits(), I, 2);
+    F.Scope = getBits(C.scope_bits(), I, 2);
+    F.GOTRelax = getBits(C.got_relax_bits(), I, 2);
+    if (F.Target > FT_Data)
+      return makeError("Invalid target of the fixup at " + Twine::utohexstr(F.Offset));
+    if (F.Scope > FS_IntraFunction)
+      return makeError("Invalid scope of the fixup at " + Twine::utohexstr(F.Offset));
+    if (F.GOTRelax > FGR_RexGOTPCRELX ||
+        (F.GOTRelax && (F.RefClass != FRC_GOT || !F.IsRela)))
+      return makeError("Invalid GOT relaxation of the fixup at " +
+                       Twine::utohexstr(F.Offset));
+    if (!SectionBases.empty()) {
+      if (C.section_idx(I) >= SectionBases.size())
+        return makeError("Fixup column refers to a non-existing section");
+      uint64_t SectionBase = SectionBases[C.section_idx(I)];
+      if (SectionBase == ccr::ChunkSection::DiscardedBase) {
+        Discarded.resize(N, false);
+        Discarded[I] = true;
+        continue;
+      }
+      F.Offset += SectionBase;
+      F.SectionIdx = C.section_idx(I);
+    }
+  }
+  for (int I = 0, E = C.jt_fixup_idx_size(); I < E; ++I) {
+    if (C.jt_fixup_idx(I) >= (uint32_t)N)
+      return makeError("Jump table column refers to a non-existing fixup");
+    FixupInfo &F = Out[Base + C.jt_fixup_idx(I)];
+    F.NumJTEntries = C.num_jt_entries(I);
+    F.JTEntrySize = C.jt_entry_sz(I);
+    F.JTFunctionRelative = getBits(C.jt_func_rel_bits(), I, 1);
+  }
+
+  if (C.pair_fixup_idx_size() != C.pair_delta_size())
+    return makeError("Inconsistent pair columns in the .rand section");
+  for (int I = 0, E = C.pair_fixup_idx_size(); I < E; ++I) {
+    if (C.pair_fixup_idx(I) >= (uint32_t)N || C.pair_delta(I) > UINT8_MAX ||
+        C.pair_delta(I) > C.pair_fixup_idx(I))
+      return makeError("Pair column refers to a non-existing fixup");
+    Out[Base + C.pair_fixup_idx(I)].PairDelta = C.pair_delta(I);
+  }
+
+  if (C.relax_fixup_idx_size() != C.relax_short_sz_size() ||
+      C.relax_fixup_idx_size() != C.relax_long_form_size() ||
+      C.relax_fixup_idx_size() != C.relax_fixup_offset_size())
+    return makeError("Inconsistent relaxation columns in the .rand section");
+  for (int I = 0, E = C.relax_fixup_idx_size(); I < E; ++I) {
+    if (C.relax_fixup_idx(I) >= (uint32_t)N)
+      return makeError("Relaxation column refers to a non-existing fixup");
+    if (Error E = setRelaxation(Out[Base + C.relax_fixup_idx(I)],
+                                C.relax_short_sz(I), C.relax_long_form(I),
+                                C.relax_fixup_offset(I)))
+      return E;
+  }
+
+  if (C.shrink_fixup_idx_size() != C.shrink_long_sz_size() ||
+      C.shrink_fixup_idx_size() != C.shrink_short_form_size())
+    return makeError("Inconsistent shrink columns in the .rand section");
+  for (int I = 0, E = C.shrink_fixup_idx_size(); I < E; ++I) {
+    if (C.shrink_fixup_idx(I) >= (uint32_t)N)
+      return makeError("Shrink column refers to a non-existing fixup");
+    if (Error E = setShrink(Out[Base + C.shrink_fixup_idx(I)],
+                            C.shrink_long_sz(I), C.shrink_short_form(I)))
+      return E;
+  }
+
+  // Drop the fixups of the discarded sections only now, since the columns above
+  // refer to the fixups by their index
+  if (!Discarded.empty()) {
+    size_t Kept = Base;
+    for (int I = 0; I < N; ++I)
+      if (!Discarded[I])
+        Out[Kept++] = Out[Base + I];
+    Out.resize(Kept);
+  }
+  return Error::success();
+}
+
+// The call-site tables (format 3 only) are rebased like the fixups; a table
+// whose function or LSDA section has been discarded is dropped
+static Error readCallSiteColumns(const ShuffleInfo::ReorderInfo_CallSiteColumns &C,
+                                 ArrayRef<uint64_t> SectionBases,
+                                 std::vector<CallSiteTableInfo> &Out) {
+  int N = C.num_records_size();
+  if (C.function_offset_size() != N || C.function_section_idx_size() != N ||
+      C.table_offset_size() != N || C.table_section_idx_size() != N)
+    return makeError("Inconsistent call-site columns in the .rand section");
+
+  for (int I = 0; I < N; ++I) {
+    if (C.function_section_idx(I) >= SectionBases.size() ||
+        C.table_section_idx(I) >= SectionBases.size())
+      return makeError("Call-site column refers to a non-existing section");
+    uint64_t FunctionBase = SectionBases[C.function_section_idx(I)];
+    uint64_t TableBase = SectionBases[C.table_section_idx(I)];
+    if (FunctionBase == ccr::ChunkSection::DiscardedBase ||
+        TableBase == ccr::ChunkSection::DiscardedBase)
+      continue;
+    CallSiteTableInfo T;
+    T.FunctionOffset = FunctionBase + C.function_offset(I);
+    T.TableOffset = TableBase + C.table_offset(I);
+    T.NumRecords = C.num_records(I);
+    Out.push_back(T);
+  }
+  return Error::success();
+}
+
+// Decode a single ReorderInfo message; SectionBases are given for the payload
+// of a chunk (format 3), whose offsets are relative to its concrete sections,
+// and BBLSections then receives the section index of every BBL
+static Expected<RandInfo> decodeReorderInfo(ArrayRef<uint8_t> Contents,
+                                            ArrayRef<uint64_t> SectionBases,
+                                            std::vector<uint32_t> *BBLSections) {
+  // CodedInputStream counts the bytes of a message in an int
+  if (Contents.size() > static_cast<size_t>(INT_MAX))
+    return makeError("A .rand message is larger than 2GB; build with "
+                     "-ccr-rand-format=3 for a chunk per object");
+  google::protobuf::Arena Arena;
+  const ShuffleInfo::ReorderInfo *RI =
+      ShuffleInfo::ParseReorderInfo(Contents.data(), Contents.size(), &Arena);
+  if (!RI)
+    return makeError("Failed to parse the .rand section");
+
+  RandInfo Info;
+  const auto &Bin = RI->bin();
+  Info.RandObjOffset = Bin.rand_obj_offset();
+  Info.MainAddrOffset = Bin.main_addr_offset();
+  Info.ObjSize = Bin.obj_sz();
+  Info.FormatVersion = Bin.has_format_version() ? Bin.format_version() : 1;
+  if (RI->has_source())
+    Info.SourceTypes.assign(RI->source().src_type().begin(),
+                            RI->source().src_type().end());
+  else
+    Info.SourceTypes.push_back(Bin.src_type());
+  Info.SectionNames.assign(RI->section_names().begin(),
+                           RI->section_names().end());
+  if (!SectionBases.empty() && Info.FormatVersion < 2)
+    return makeError("A .rand chunk does not hold packed columns");
+  if (Bin.eh_info() && SectionBases.empty())
+    return makeError("EH information outside of a .rand chunk");
+  // The linker clears the flag once it has added the fixups of the relocations
+  if (Bin.fixups_from_relocs())
+    return makeError("An object has left its relocated fixups out of .rand "
+                     "(-ccr-omit-relocated-fixups), which the linker has not "
+                     "added back; link with a linker that does");
+  Info.EHInfo.push_back(Bin.eh_info());
+  Info.DataFixups.push_back(Bin.data_fixups());
+
+  if (Info.FormatVersion >= 2) {
+    const auto &L = RI->layout_columns();
+    int N = L.bb_size_size();
+    // The BBLs past the end of section_idx are in the first section
+    if (L.num_fixups_size() != N || L.section_idx_size() > N)
+      return makeError("Inconsistent layout columns in the .rand section");
+    if (BBLSections) {
+      BBLSections->assign(L.section_idx().begin(), L.section_idx().end());
+      BBLSections->resize(N, 0);
+    }
+    Info.BasicBlocks.resize(N);
+    for (int I = 0; I < N; ++I) {
+      BasicBlockInfo &BBL = Info.BasicBlocks[I];
+      BBL.Size = L.bb_size(I);
+      BBL.Type = getBits(L.type_bits(), I, 2);
+      BBL.FallThrough = getBits(L.fallthrough_bits(), I, 1);
+      BBL.Hotness = getBits(L.hotness_bits(), I, 2);
+      BBL.PaddingSize = I < L.padding_sz_size() ? L.padding_sz(I) : 0;
+      BBL.AlignLog2 = getBits(L.align_bits(), I, 4);
+      BBL.LoopHeader = getBits(L.loop_header_bits(), I, 1);
+      BBL.HasCFI = getBits(L.cfi_bits(), I, 1);
+      BBL.Pinned = getBits(L.pinned_bits(), I, 1);
+      BBL.ChainStart = getBits(L.chain_start_bits(), I, 1);
+      BBL.EdgeProb = getBits(L.edge_prob_bits(), I, 4);
+      if (!setTerminator(BBL, getBits(L.term_bits(), I, 8)))
+        return makeError("Invalid last instruction of the BBL #" + Twine(I));
+      if (!setBoundary(BBL, I < L.boundary_size() ? L.boundary(I) : 0))
+        return makeError("Invalid padded instruction of the BBL #" + Twine(I));
+      uint32_t SectionIdx = I < L.section_idx_size() ? L.section_idx(I) : 0;
+      if (SectionIdx < Info.SectionNames.size())
+        BBL.SectionClass = getSectionClass(Info.SectionNames[SectionIdx]);
+    }
+
+    // The identities of the functions are one column each, if any
+    int NumNames = L.function_name_hash_size();
+    int NumContents = L.function_content_hash_size();
+    if (NumNames || NumContents) {
+      size_t NumFunctions = countFunctions(Info.BasicBlocks);
+      if ((NumNames && (size_t)NumNames != NumFunctions) ||
+          (NumContents && (size_t)NumContents != NumFunctions))
+        return makeError("The function identities do not match the functions "
+                         "of the .rand section");
+      Info.FunctionIDs.resize(NumFunctions);
+      for (int I = 0; I < NumNames; ++I)
+        Info.FunctionIDs[I].NameHash = L.function_name_hash(I);
+      for (int I = 0; I < NumContents; ++I)
+        Info.FunctionIDs[I].ContentHash = L.function_content_hash(I);
+    }
+
+    const ShuffleInfo::ReorderInfo_FixupColumns *Columns[NumFixupKinds] = {
+        &RI->text_fixup_columns(), &RI->rodata_fixup_columns(),
+        &RI->data_fixup_columns(), &RI->datarel_fixup_columns(),
+        &RI->initarray_fixup_columns(), &RI->finiarray_fixup_columns(),
+        &RI->tdata_fixup_columns(), &RI->xray_fixup_columns(),
+        &RI->patchable_fixup_columns(), &RI->jumptable_fixup_columns(),
+        &RI->custom_fixup_columns()};
+    for (unsigned K = 0; K < NumFixupKinds; ++K)
+      if (Error E = readFixupColumns(*Columns[K], SectionBases, Info.Fixups[K]))
+        return std::move(E);
+    if (Bin.eh_info())
+      if (Error E = readCallSiteColumns(RI->call_site_columns(), SectionBases,
+                                        Info.CallSiteTables))
+        return std::move(E);
+  } else {
+    Info.BasicBlocks.reserve(RI->layout_size());
+    for (const auto &Layout : RI->layout()) {
+      BasicBlockInfo BBL;
+      BBL.Size = Layout.bb_size();
+      BBL.Type = Layout.type();
+      BBL.FallThrough = Layout.bb_fallthrough();
+      BBL.Hotness = Layout.hotness();
+      BBL.PaddingSize = Layout.padding_sz();
+      BBL.AlignLog2 = std::min(Layout.align_log2(), 15U);
+      BBL.LoopHeader = Layout.loop_header();
+      BBL.Pinned = Layout.pinned();
+      BBL.ChainStart = Layout.chain_start();
+      BBL.EdgeProb = std::min(Layout.edge_prob(), 15U);
+      if (!setTerminator(BBL, Layout.term()))
+        return makeError("Invalid last instruction of the BBL #" +
+                         Twine(Info.BasicBlocks.size()));
+      if (!setBoundary(BBL, Layout.boundary()))
+        return makeError("Invalid padded instruction of the BBL #" +
+                         Twine(Info.BasicBlocks.size()));
+      if (Layout.has_section_idx()) {
+        if (Layout.section_idx() < Info.SectionNames.size())
+          BBL.SectionClass =
+              getSectionClass(Info.SectionNames[Layout.section_idx()]);
+      } else {
+        BBL.SectionClass = getSectionClass(Layout.section_name());
+      }
+      Info.BasicBlocks.push_back(BBL);
+    }
+
+    bool DeltaOffsets = Bin.fixup_offset_encoding() == 1;
+    for (const auto &FI : RI->fixup()) {
+      const google::protobuf::RepeatedPtrField<
+          ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple> *Lists[NumFixupKinds] = {
+          &FI.text(), &FI.rodata(), &FI.data(), &FI.datarel(), &FI.initarray(),
+          &FI.finiarray(), &FI.tdata(), &FI.xray(), &FI.patchable(),
+          &FI.jumptable(), &FI.custom()};
+      for (unsigned K = 0; K < NumFixupKinds; ++K)
+        if (Error E = readFixups(*Lists[K], DeltaOffsets, Info.Fixups[K]))
+          return std::move(E);
+    }
+  }
+
+  // Nothing but a chunk tells the output section of a -ccr-fixup-section fixup
+  if (SectionBases.empty() && !Info.Fixups[FK_Custom].empty())
+    return makeError("The fixups of -ccr-fixup-section need -ccr-rand-format=3");
+
+  uint64_t Total = 0;
+  for (const BasicBlockInfo &BBL : Info.BasicBlocks) {
+    if (BBL.PaddingSize > BBL.Size)
+      return makeError("A BBL has more padding than bytes in the .rand section");
+    Total += BBL.Size;
+  }
+  if (Info.ObjSize == 0)
+    Info.ObjSize = Total;
+  else if (Info.ObjSize != Total)
+    return makeError("The BBL sizes do not add up to the object size (" +
+                     Twine(Total) + " != " + Twine(Info.ObjSize) + ")");
+  return std::move(Info);
+}
+
+// Koo: Join the chunks of a .rand section merged by the linker (format 3) into
+//      one RandInfo. The BBLs of each concrete section of a chunk begin at the
+//      output offset of the section, thus the sections are laid out by their
+//      bases rather than by the order of the chunks: the .rand of a COMDAT group
+//      lands wherever the linker puts the group, and a section that has been
+//      discarded (i.e., folded into an identical one by --icf) has no BBLs left.
+//      The fixups that referred to a folded copy have been resolved to the kept
+//      one, whose BBLs carry them along as any other reference.
+namespace {
+struct SectionRun {
+  uint64_t Start;             // Output offset of the section in .text
+  std::vector<BasicBlockInfo> BasicBlocks;
+  std::vector<FunctionIdentity> FunctionIDs; // Empty if the chunk has none
+  uint32_t SourceType;
+  bool EHInfo;
+  bool DataFixups;
+};
+} // end anonymous namespace
+
+static Expected<RandInfo> decodeRandChunks(ArrayRef<uint8_t> Contents,
+                                           bool Parallel) {
+  Expected<std::vector<object::RandChunkRef>> ChunksOrErr =
+      object::readRandChunks(Contents);
+  if (!ChunksOrErr)
+    return ChunksOrErr.takeError();
+  ArrayRef<object::RandChunkRef> Chunks = *ChunksOrErr;
+
+  // Koo: Each payload is a message of its own, thus the chunks are decoded
+  //      independently (and in parallel); only joining them is sequential
+  size_t NumChunks = Chunks.size();
+  std::vector<std::vector<uint64_t>> SectionBases(NumChunks);
+  std::vector<std::vector<uint32_t>> BBLSections(NumChunks);
+  std::vector<Optional<Expected<RandInfo>>> Parts(NumChunks);
+  auto DecodeChunk = [&](size_t C) {
+    for (const ccr::ChunkSection &S : Chunks[C].getSections())
+      SectionBases[C].push_back(S.Base);
+    // An object without any section still yields a (harmless) 0 base
+    if (SectionBases[C].empty())
+      SectionBases[C].push_back(0);
+    Parts[C].emplace(decodeReorderInfo(Chunks[C].getPayload(), SectionBases[C],
+                                       &BBLSections[C]));
+  };
+  if (Parallel && NumChunks > 1)
+    parallel::for_each_n(parallel::par, (size_t)0, NumChunks, DecodeChunk);
+  else
+    for (size_t C = 0; C != NumChunks; ++C)
+      DecodeChunk(C);
+
+  // The first chunk that fails tells why
+  Error Err = Error::success();
+  for (Optional<Expected<RandInfo>> &Part : Parts)
+    if (!*Part) {
+      if (Err)
+        consumeError(Part->takeError());
+      else
+        Err = Part->takeError();
+    }
+  if (Err)
+    return std::move(Err);
+
+  RandInfo Info;
+  Info.FormatVersion = 3;
+  std::vector<SectionRun> Runs;
+  bool AnyFunctionIDs = false;
+  for (size_t C = 0; C != NumChunks; ++C) {
+    const object::RandChunkRef &Chunk = Chunks[C];
+    const ccr::ChunkHeader &H = Chunk.getHeader();
+    uint32_t FirstSection = Info.SectionNames.size();
+    for (const ccr::ChunkSection &S : Chunk.getSections())
+      Info.SectionNames.push_back(Chunk.getSectionName(S));
+
+    Expected<RandInfo> &Part = *Parts[C];
+    if (H.MainAddrOffset)
+      Info.MainAddrOffset = H.MainAddrOffset;
+
+    // The BBLs of a concrete section are consecutive (each run ends the object)
+    uint32_t SourceType = Part->getSourceType(0);
+    size_t FirstFunction = 0; // Of the current run
+    ArrayRef<uint32_t> Owners = BBLSections[C]; // The section of each BBL
+    for (size_t I = 0, E = Owners.size(); I != E;) {
+      size_t RunEnd = I;
+      while (RunEnd != E && Owners[RunEnd] == Owners[I])
+        ++RunEnd;
+      ArrayRef<BasicBlockInfo> RunBBLs =
+          makeArrayRef(Part->BasicBlocks).slice(I, RunEnd - I);
+      size_t NumFunctions = countFunctions(RunBBLs);
+      if (Owners[I] >= SectionBases[C].size())
+        return makeError("Layout column refers to a non-existing section");
+      uint64_t Base = SectionBases[C][Owners[I]];
+      if (Base != ccr::ChunkSection::DiscardedBase) {
+        std::vector<FunctionIdentity> FunctionIDs;
+        if (!Part->FunctionIDs.empty())
+          FunctionIDs.assign(Part->FunctionIDs.begin() + FirstFunction,
+                             Part->FunctionIDs.begin() + FirstFunction +
+                                 NumFunctions);
+        AnyFunctionIDs |= !FunctionIDs.empty();
+        Runs.push_back({Base, RunBBLs.vec(), std::move(FunctionIDs),
+                        SourceType, Part->hasEHInfo(0),
+                        Part->hasDataFixups(0)});
+        ArrayRef<ccr::ChunkSection> Sections = Chunk.getSections();
+        SectionClass Class =
+            Owners[I] < Sections.size()
+                ? getSectionClass(Chunk.getSectionName(Sections[Owners[I]]))
+                : SC_Text;
+        for (BasicBlockInfo &BBL : Runs.back().BasicBlocks)
+          BBL.SectionClass = Class;
+      }
+      FirstFunction += NumFunctions;
+      I = RunEnd;
+    }
+    // The fixups tell their sections among those of all the chunks
+    for (unsigned K = 0; K < NumFixupKinds; ++K) {
+      size_t Begin = Info.Fixups[K].size();
+      Info.Fixups[K].insert(Info.Fixups[K].end(), Part->Fixups[K].begin(),
+                            Part->Fixups[K].end());
+      for (size_t I = Begin, E = Info.Fixups[K].size(); I != E; ++I)
+        Info.Fixups[K][I].SectionIdx += FirstSection;
+    }
+    Info.CallSiteTables.insert(Info.CallSiteTables.end(),
+                               Part->CallSiteTables.begin(),
+                               Part->CallSiteTables.end());
+  }
+
+  std::stable_sort(Runs.begin(), Runs.end(),
+                   [](const SectionRun &A, const SectionRun &B) {
+                     return A.Start < B.Start;
+                   });
+
+  uint64_t End = 0; // End of the BBLs of the previous runs
+  for (SectionRun &R : Runs) {
+    if (Info.BasicBlocks.empty()) {
+      Info.RandObjOffset = End = R.Start;
+    } else if (R.Start < End) {
+      return makeError("The BBLs of the .rand chunks overlap at " +
+                       Twine::utohexstr(R.Start));
+    } else if (R.Start > End &&
+               R.Start - End < (1ULL << R.BasicBlocks[0].AlignLog2)) {
+      // The alignment between two sections belongs to the last BBL of the
+      // previous one, just as the linker of v1 laid it out
+      BasicBlockInfo &Last = Info.BasicBlocks.back();
+      Last.Size += R.Start - End;
+      Last.PaddingSize += R.Start - End;
+      Info.ObjSize += R.Start - End;
+      End = R.Start;
+    } else if (R.Start > End) {
+      // Koo: More than that is an input without .rand (e.g., of a prebuilt
+      //      library), which stays where the linker put it; the references
+      //      of it are told by its relocations (see addForeignFixups())
+      BasicBlockInfo Foreign;
+      Foreign.Size = R.Start - End;
+      Foreign.Type = BBT_ObjectEnd;
+      Foreign.Pinned = true;
+      Foreign.SectionClass = R.BasicBlocks[0].SectionClass;
+      Info.BasicBlocks.push_back(Foreign);
+      Info.SourceTypes.push_back(SRC_Foreign);
+      Info.EHInfo.push_back(false);
+      Info.DataFixups.push_back(false);
+      if (AnyFunctionIDs)
+        Info.FunctionIDs.emplace_back();
+      Info.ObjSize += Foreign.Size;
+      End = R.Start;
+    }
+    for (const BasicBlockInfo &BBL : R.BasicBlocks) {
+      End += BBL.Size;
+      Info.ObjSize += BBL.Size;
+    }
+    Info.SourceTypes.push_back(R.SourceType);
+    Info.EHInfo.push_back(R.EHInfo);
+    Info.DataFixups.push_back(R.DataFixups);
+    Info.BasicBlocks.insert(Info.BasicBlocks.end(), R.BasicBlocks.begin(),
+                            R.BasicBlocks.end());
+    // The functions of the chunks without identities are unknown ones
+    if (AnyFunctionIDs) {
+      if (R.FunctionIDs.empty())
+        R.FunctionIDs.resize(countFunctions(R.BasicBlocks));
+      Info.FunctionIDs.insert(Info.FunctionIDs.end(), R.FunctionIDs.begin(),
+                              R.FunctionIDs.end());
+    }
+  }
+  return std::move(Info);
+}
+
+Expected<RandInfo> llvm::ccr::parseRandInfo(StringRef SectionName,
+                                            ArrayRef<uint8_t> Contents,
+                                            bool Compressed, bool Parallel) {
+  SmallString<0> Decompressed;
+  if (Compressed) {
+    Expected<object::Decompressor> D = object::Decompressor::create(
+        SectionName, toStringRef(Contents), /*IsLE=*/true, /*Is64Bit=*/true);
+    if (!D)
+      return D.takeError();
+    if (Error E = D->resizeAndDecompress(Decompressed))
+      return std::move(E);
+    Contents = arrayRefFromStringRef(Decompressed);
+  }
+
+  if (object::isRandChunked(Contents))
+    return decodeRandChunks(Contents, Parallel);
+  return decodeReorderInfo(Contents, None, nullptr);
+}
+#else
+Expected<RandInfo> llvm::ccr::parseRandInfo(StringRef SectionName,
+                                            ArrayRef<uint8_t> Contents,
+                                            bool Compressed, bool Parallel) {
+  return makeError("Decoding " + SectionName +
+                   " requires the protobuf runtime; build an index instead");
+}
+#endif
+
+void llvm::ccr::computeFixupOwners(RandInfo &Info) {
+  std::vector<uint64_t> Starts(Info.BasicBlocks.size());
+  uint64_t Offset = Info.RandObjOffset;
+  for (size_t I = 0, E = Starts.size(); I != E; ++I) {
+    Starts[I] = Offset;
+    Offset += Info.BasicBlocks[I].Size;
+  }
+  TranslationMap Map(Starts, Offset);
+  // In ascending offsets, the fixups of a function are a run (see the index)
+  std::stable_sort(Info.Fixups[FK_Text].begin(), Info.Fixups[FK_Text].end(),
+                   [](const FixupInfo &A, const FixupInfo &B) {
+                     return A.Offset < B.Offset;
+                   });
+  for (FixupInfo &F : Info.Fixups[FK_Text])
+    F.OwnerBBL = Map.lookup(F.Offset);
+}
+
+// A counting sort of the fixups by the function of their targets, thus one
+// pass finds the targets and another places the references
+void llvm::ccr::computeIncomingFixups(
+    RandInfo &Info,
+    function_ref<Optional<uint64_t>(unsigned Kind, const FixupInfo &F)> TargetOf) {
+  std::vector<uint64_t> Starts; // Of the functions
+  uint64_t Offset = Info.RandObjOffset, FuncOffset = Offset;
+  for (size_t I = 0, E = Info.BasicBlocks.size(); I != E; ++I) {
+    Offset += Info.BasicBlocks[I].Size;
+    if (Info.BasicBlocks[I].Type == BBT_Block && I + 1 != E)
+      continue;
+    Starts.push_back(FuncOffset);
+    FuncOffset = Offset;
+  }
+
+  const uint32_t NoFunction = UINT32_MAX;
+  std::vector<uint32_t> Targets[NumFixupKinds];
+  Info.IncomingBegin.assign(Starts.size() + 1, 0);
+  for (unsigned K = 0; K < NumFixupKinds; ++K) {
+    Targets[K].assign(Info.Fixups[K].size(), NoFunction);
+    for (size_t I = 0, E = Info.Fixups[K].size(); I != E; ++I) {
+      Optional<uint64_t> Target = TargetOf(K, Info.Fixups[K][I]);
+      if (!Target || *Target < Info.RandObjOffset || *Target >= Offset)
+        continue;
+      uint32_t Func =
+          std::upper_bound(Starts.begin(), Starts.end(), *Target) -
+          Starts.begin() - 1;
+      Targets[K][I] = Func;
+      Info.IncomingBegin[Func + 1]++;
+    }
+  }
+  for (size_t F = 0, E = Starts.size(); F != E; ++F)
+    Info.IncomingBegin[F + 1] += Info.IncomingBegin[F];
+
+  Info.IncomingFixups.resize(Info.IncomingBegin.back());
+  std::vector<uint32_t> Next(Info.IncomingBegin.begin(),
+                             Info.IncomingBegin.end() - 1);
+  for (unsigned K = 0; K < NumFixupKinds; ++K)
+    for (size_t I = 0, E = Targets[K].size(); I != E; ++I)
+      if (Targets[K][I] != NoFunction)
+        Info.IncomingFixups[Next[Targets[K][I]]++] = FixupRef(K, I);
+}
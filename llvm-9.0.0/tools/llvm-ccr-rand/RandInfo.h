@@ -0,0 +1,299 @@
+//===- RandInfo.h - Decoded CCR reordering information ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Plain-struct view of the .rand section (shuffleInfo.proto) of a linked
+// binary. Both wire formats (per-message v1 and packed-column v2), the
+// delta-encoded fixup offsets and SHF_COMPRESSED sections are decoded here, so
+// the rest of the randomizer never touches protobuf.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_RANDINFO_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_RANDINFO_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+
+/// The fixup lists of the .rand section, in the order of FixupInfo.
+enum FixupKind : unsigned {
+  FK_Text = 0,
+  FK_Rodata,
+  FK_Data,
+  FK_DataRel,
+  FK_InitArray,
+  FK_FiniArray,
+  FK_TData,
+  FK_XRay, // The sled and function addresses of xray_instr_map
+  FK_PatchableEntries, // __patchable_function_entries
+  FK_JumpTable,        // __jump_table of the user-space static keys
+  FK_Custom,           // -ccr-fixup-section: in the sections of their SectionIdx
+  NumFixupKinds
+};
+
+/// Name of the output section whose fixups are kept in list \p Kind
+/// ("custom" for FK_Custom, whose fixups are in many).
+StringRef getFixupKindSectionName(FixupKind Kind);
+
+/// BBL type in the layout: MBB = 0, end of MF = 1, end of object = 2
+enum BasicBlockType : uint8_t {
+  BBT_Block = 0,
+  BBT_FunctionEnd = 1,
+  BBT_ObjectEnd = 2
+};
+
+/// Source of an object: 3 = standalone assembly whose BBLs have been split at
+/// the terminators (not only at the labels), thus the BBLs are reliable; 4 =
+/// an input without .rand between the chunks (format 3), one pinned BBL
+enum SourceType : uint32_t {
+  SRC_Source = 0,
+  SRC_InlineAsm = 1,
+  SRC_Asm = 2,
+  SRC_AsmBlocks = 3,
+  SRC_Foreign = 4
+};
+
+/// Hotness class of a BBL by the profile the binary has been built with
+enum Hotness : uint8_t {
+  HOT_Unknown = 0,
+  HOT_Hot = 1,
+  HOT_Cold = 2
+};
+
+/// The kind of the last instruction of a BBL (see MCMBBInfo::TermNone); a BBL
+/// of older objects or of parsed assembly tells none
+enum TermKind : uint8_t {
+  TK_None = 0,
+  TK_Jump = 1,
+  TK_CondBranch = 2,
+  TK_Return = 3,
+  TK_Indirect = 4
+};
+
+/// Prefix class of the input section of a BBL: the compiler puts hot,
+/// unlikely (-fprofile-use), startup and exit code in .text.<class>.*, which
+/// the linker groups, thus each class is permuted on its own
+enum SectionClass : uint8_t {
+  SC_Text = 0,
+  SC_Hot = 1,
+  SC_Unlikely = 2,
+  SC_Startup = 3,
+  SC_Exit = 4,
+  NumSectionClasses
+};
+
+/// Class of the input section \p Name (SC_Text for the plain ones).
+SectionClass getSectionClass(StringRef Name);
+
+/// What a fixup refers to; the fixups of data sections that refer to data
+/// (d2d) are left out by the compiler unless -ccr-keep-data-fixups is given
+enum FixupTarget : uint8_t {
+  FT_Unknown = 0,
+  FT_Code = 1,
+  FT_Data = 2
+};
+
+/// How a fixup refers to its target (PIC code); see MCFixupRefClass
+enum FixupRefClass : uint8_t {
+  FRC_Direct = 0,
+  FRC_PLT = 1,
+  FRC_GOT = 2,
+  FRC_TLS = 3
+};
+
+/// How far the target of a .text fixup is (see MCFixupScope); an intra-function
+/// fixup keeps its value where its function moves as a whole
+enum FixupScope : uint8_t {
+  FS_External = 0, // Outside the object, or not known (older objects)
+  FS_IntraObject = 1,
+  FS_IntraFunction = 2
+};
+
+/// Whether the linker may relax a GOTPCREL reference of .text into a direct
+/// one (see MCAsmBackend::getFixupKindGOTRelax())
+enum FixupGOTRelax : uint8_t {
+  FGR_None = 0,
+  FGR_GOTPCRELX = 1,
+  FGR_RexGOTPCRELX = 2 // mov, test and binop may take immediates
+};
+
+struct BasicBlockInfo {
+  uint32_t Size = 0;
+  uint32_t PaddingSize = 0; // Trailing alignment NOPs (included in Size)
+  uint8_t Type = BBT_Block;
+  uint8_t Hotness = HOT_Unknown;
+  uint8_t AlignLog2 = 0;    // Alignment of the start of the BBL
+  bool FallThrough = false;
+  bool LoopHeader = false;
+  bool HasCFI = false;      // Holds CFI instructions (objects with EH info only)
+  bool Pinned = false;      // The function stays in place (ccr_granularity("none"))
+  bool ChainStart = false;  // MachineBlockPlacement began a chain here
+  uint8_t EdgeProb = 0;     // Of the edge into the next BBL, in 15ths
+  uint8_t SectionClass = SC_Text; // Of its input section
+  uint8_t TermSize = 0;     // Of the last instruction, which ends the code (0 if not known)
+  uint8_t TermKind = TK_None;
+  // An instruction the assembler padded clear of the 2^BoundaryLog2-byte
+  // boundaries (0 if none), at BoundaryOffset from the start of the BBL
+  uint8_t BoundarySize = 0;
+  uint8_t BoundaryLog2 = 0;
+  uint32_t BoundaryOffset = 0;
+};
+
+struct FixupInfo {
+  uint64_t Offset = 0;     // Offset from the start of the output section
+  uint32_t DerefSize = 0;  // Bytes to dereference (1, 2, 4 or 8)
+  bool IsRela = false;     // PC-relative
+  uint8_t Target = FT_Unknown;
+  uint8_t RefClass = FRC_Direct;
+  uint8_t Scope = FS_External;
+  uint8_t PairDelta = 0;   // A low half: its high adjusted half is PairDelta fixups back
+  uint8_t GOTRelax = FGR_None; // The linker may have relaxed it (see FixupGOTRelax)
+  bool JTFunctionRelative = false; // Entries relative to the function, not the table
+  uint32_t Type = 0;       // c2c, c2d, d2c, d2d, or 4 (new section)
+  uint32_t NumJTEntries = 0;
+  uint32_t JTEntrySize = 0;
+  uint32_t SectionIdx = 0; // Input section, into RandInfo::SectionNames (format 3)
+  int32_t OwnerBBL = -1;   // BBL that holds a .text fixup (-1 if not known)
+
+  // A relaxable short branch (RelaxShortSize > 0) ends its instruction; the
+  // long form carries a zero displacement at RelaxFixupOffset
+  uint8_t RelaxShortSize = 0;
+  uint8_t RelaxLongSize = 0;
+  uint8_t RelaxFixupOffset = 0;
+  uint8_t RelaxLongForm[8] = {};
+
+  // A long branch that the assembler relaxed (ShrinkShortSize > 0) ends its
+  // instruction of ShrinkLongSize bytes; the short form it was relaxed from
+  // carries a zero rel8 displacement at its end
+  uint8_t ShrinkLongSize = 0;
+  uint8_t ShrinkShortSize = 0;
+  uint8_t ShrinkShortForm[6] = {};
+
+  bool isRelaxable() const { return RelaxShortSize > 0; }
+  bool isShrinkable() const { return ShrinkShortSize > 0; }
+};
+
+/// The call-site table of the LSDA of a function (-ccr-eh-info): the records
+/// have udata4 start, length and landing pad fields (relative to the start of
+/// the function), followed by the ULEB128 action.
+struct CallSiteTableInfo {
+  uint64_t FunctionOffset = 0; // Offset of the function from the start of .text
+  uint64_t TableOffset = 0;    // ... of the first record in .gcc_except_table
+  uint32_t NumRecords = 0;
+};
+
+/// What tells a function across builds (format 2 or 3): the hash of its
+/// symbol name and that of its instructions (-ccr-function-hashes), either of
+/// which is 0 if the compiler has not recorded it.
+struct FunctionIdentity {
+  uint64_t NameHash = 0;
+  uint64_t ContentHash = 0;
+};
+
+/// A fixup of RandInfo::Fixups: its list (bits 28-31) and its index in there.
+struct FixupRef {
+  uint32_t Raw = 0;
+
+  FixupRef() = default;
+  FixupRef(unsigned Kind, uint32_t Index) : Raw(Kind << 28 | Index) {}
+
+  unsigned getKind() const { return Raw >> 28; }
+  uint32_t getIndex() const { return Raw & ((1U << 28) - 1); }
+};
+
+/// Everything the randomizer needs from a .rand section.
+struct RandInfo {
+  uint64_t RandObjOffset = 0;  // Offset of the first BBL from the start of .text
+  uint64_t MainAddrOffset = 0;
+  uint64_t ObjSize = 0;        // Sum of all BBL sizes
+  uint32_t FormatVersion = 1;
+  std::vector<uint32_t> SourceTypes; // Per object: 0 = source, 1 = inline asm, 2/3 = asm
+  std::vector<BasicBlockInfo> BasicBlocks;
+  std::vector<FixupInfo> Fixups[NumFixupKinds];
+  std::vector<std::string> SectionNames;
+  std::vector<bool> EHInfo; // Per object: HasCFI and CallSiteTables are known
+  std::vector<bool> DataFixups; // Per object: built with -ccr-keep-data-fixups
+  std::vector<CallSiteTableInfo> CallSiteTables;
+  // Per function in layout order (as in the Layout); empty if no object has any
+  std::vector<FunctionIdentity> FunctionIDs;
+  // The fixups into each function, CSR-style (see computeIncomingFixups()):
+  // those of the F-th one are IncomingFixups[IncomingBegin[F]] up to
+  // IncomingFixups[IncomingBegin[F + 1]]; empty unless computed
+  std::vector<uint32_t> IncomingBegin;
+  std::vector<FixupRef> IncomingFixups;
+
+  /// Number of objects that contributed BBLs (each ends with BBT_ObjectEnd).
+  unsigned getNumObjects() const;
+
+  /// Source type of the \p Idx-th object.
+  uint32_t getSourceType(unsigned Idx) const {
+    return Idx < SourceTypes.size() ? SourceTypes[Idx] : 0;
+  }
+
+  /// Identity of the \p Idx-th function.
+  FunctionIdentity getFunctionID(unsigned Idx) const {
+    return Idx < FunctionIDs.size() ? FunctionIDs[Idx] : FunctionIdentity();
+  }
+
+  /// Whether the \p Idx-th object has been built with -ccr-eh-info.
+  bool hasEHInfo(unsigned Idx) const {
+    return Idx < EHInfo.size() && EHInfo[Idx];
+  }
+
+  /// Whether the \p Idx-th object has recorded the data-to-data fixups.
+  bool hasDataFixups(unsigned Idx) const {
+    return Idx < DataFixups.size() && DataFixups[Idx];
+  }
+
+  /// Whether the fixups into the functions have been computed.
+  bool hasIncomingFixups() const { return !IncomingBegin.empty(); }
+
+  /// The fixups into the \p Idx-th function, if computed.
+  ArrayRef<FixupRef> getIncomingFixups(unsigned Idx) const {
+    if (Idx + 1 >= IncomingBegin.size())
+      return None;
+    return makeArrayRef(IncomingFixups)
+        .slice(IncomingBegin[Idx], IncomingBegin[Idx + 1] - IncomingBegin[Idx]);
+  }
+};
+
+/// Number of functions in \p BasicBlocks: each ends at the end of MF or of
+/// its object, and so does the last BBL.
+size_t countFunctions(ArrayRef<BasicBlockInfo> BasicBlocks);
+
+/// Decode the contents of a .rand section. \p Compressed tells that the
+/// section has SHF_COMPRESSED set (-ccr-compress-rand); \p Parallel decodes
+/// the chunks of format 3 on all threads.
+Expected<RandInfo> parseRandInfo(StringRef SectionName, ArrayRef<uint8_t> Contents,
+                                 bool Compressed, bool Parallel = false);
+
+/// Find the BBL that holds each .text fixup (FixupInfo::OwnerBBL); the .text
+/// fixups are sorted by offset first.
+void computeFixupOwners(RandInfo &Info);
+
+/// Find the fixups into each function (RandInfo::IncomingFixups), for the
+/// moves of a single function to patch its references only. \p TargetOf tells
+/// the .text offset that a fixup refers to, from the contents of the binary, or
+/// None if it is not into the code; the fixups of a function are in the order
+/// of their lists and indices.
+void computeIncomingFixups(
+    RandInfo &Info,
+    function_ref<Optional<uint64_t>(unsigned Kind, const FixupInfo &F)> TargetOf);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_RANDINFO_H
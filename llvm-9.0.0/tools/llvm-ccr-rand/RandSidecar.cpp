@@ -0,0 +1,121 @@
+//===- RandSidecar.cpp - .rand sidecars found by build ID -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "RandSidecar.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+
+using namespace llvm;
+using namespace llvm::object;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+ArrayRef<uint8_t> llvm::ccr::getBuildID(const ELF64LEObjectFile &Obj) {
+  const ELF64LEFile *File = Obj.getELFFile();
+  auto SectionsOrErr = File->sections();
+  if (!SectionsOrErr) {
+    consumeError(SectionsOrErr.takeError());
+    return {};
+  }
+  for (const ELF64LE::Shdr &Shdr : *SectionsOrErr) {
+    if (Shdr.sh_type != ELF::SHT_NOTE)
+      continue;
+    Error Err = Error::success();
+    for (const ELF64LE::Note &Note : File->notes(Shdr, Err)) {
+      if (Note.getType() == ELF::NT_GNU_BUILD_ID &&
+          Note.getName() == ELF::ELF_NOTE_GNU) {
+        consumeError(std::move(Err));
+        return Note.getDesc();
+      }
+    }
+    consumeError(std::move(Err));
+  }
+  return {};
+}
+
+// <xx>/<xxx>.rand of the hex build ID
+static std::string getSidecarName(ArrayRef<uint8_t> BuildID) {
+  return toHex(BuildID.take_front(), /*LowerCase=*/true) + "/" +
+         toHex(BuildID.drop_front(), /*LowerCase=*/true) + ".rand";
+}
+
+// LLVM has no HTTP client, thus curl fetches the sidecar to a unique name
+// next to \p Path that is then renamed over it
+static Error fetchSidecar(StringRef URL, StringRef Path) {
+  ErrorOr<std::string> Curl = sys::findProgramByName("curl");
+  if (!Curl)
+    return makeError("-rand-server needs curl in the PATH");
+  SmallString<128> Temp;
+  sys::fs::createUniquePath(Path + ".tmp%%%%%%%", Temp, /*MakeAbsolute=*/false);
+  StringRef Args[] = {*Curl, "--silent", "--show-error", "--fail",
+                      "--location", "--output", Temp, URL};
+  std::string ErrMsg;
+  int Status = sys::ExecuteAndWait(*Curl, Args, /*Env=*/None, /*Redirects=*/{},
+                                   /*SecondsToWait=*/0, /*MemoryLimit=*/0,
+                                   &ErrMsg);
+  if (Status != 0) {
+    sys::fs::remove(Temp);
+    return makeError("Cannot fetch " + URL + ": " +
+                     (ErrMsg.empty() ? "curl exited with " + Twine(Status)
+                                     : Twine(ErrMsg)));
+  }
+  if (std::error_code EC = sys::fs::rename(Temp, Path)) {
+    sys::fs::remove(Temp);
+    return createFileError(Path, EC);
+  }
+  return Error::success();
+}
+
+Expected<std::unique_ptr<MemoryBuffer>>
+llvm::ccr::findRandSidecar(ArrayRef<uint8_t> BuildID, StringRef Dir,
+                           StringRef ServerURL) {
+  if (BuildID.size() < 2)
+    return makeError("No build ID to find the .rand sidecar by");
+  std::string Name = getSidecarName(BuildID);
+
+  SmallString<128> Path;
+  if (!Dir.empty()) {
+    sys::path::append(Path, Dir, Name);
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(
+        Path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+    if (BufOrErr)
+      return std::move(*BufOrErr);
+    if (ServerURL.empty() ||
+        BufOrErr.getError() != std::errc::no_such_file_or_directory)
+      return createFileError(Path, BufOrErr.getError());
+    if (std::error_code EC =
+            sys::fs::create_directories(sys::path::parent_path(Path)))
+      return createFileError(sys::path::parent_path(Path), EC);
+  } else if (ServerURL.empty()) {
+    return makeError("No .rand sidecar directory or server");
+  } else if (std::error_code EC =
+                 sys::fs::createTemporaryFile("ccr", "rand", Path)) {
+    return errorCodeToError(EC);
+  }
+
+  // Without -rand-dir the fetched sidecar is read and removed
+  std::string URL = (ServerURL.rtrim('/') + "/" + Name).str();
+  if (Error E = fetchSidecar(URL, Path)) {
+    if (Dir.empty())
+      sys::fs::remove(Path);
+    return std::move(E);
+  }
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(
+      Path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (Dir.empty())
+    sys::fs::remove(Path);
+  if (!BufOrErr)
+    return createFileError(Path, BufOrErr.getError());
+  return std::move(*BufOrErr);
+}
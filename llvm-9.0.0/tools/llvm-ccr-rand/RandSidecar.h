@@ -0,0 +1,42 @@
+//===- RandSidecar.h - .rand sidecars found by build ID ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A binary may ship without its .rand section: llvm-objcopy
+// --extract-ccr-rand=<dir> writes it to <dir>/xx/xxx.rand, named by the hex
+// build ID as in the .build-id trees of debuginfo, and --strip-ccr-rand drops
+// it from the shipped binary. The randomizer then looks the sidecar up in a
+// local directory (-rand-dir), or fetches it from a symbol-server-like HTTP
+// store with the same layout (-rand-server).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_RANDSIDECAR_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_RANDSIDECAR_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+
+namespace llvm {
+namespace ccr {
+
+/// The build ID of \p Obj (the NT_GNU_BUILD_ID note), or empty if none.
+ArrayRef<uint8_t> getBuildID(const object::ELF64LEObjectFile &Obj);
+
+/// Read the .rand sidecar of \p BuildID from \p Dir; if it is not there and
+/// \p ServerURL is set, fetch it from the server first (into \p Dir, if set).
+Expected<std::unique_ptr<MemoryBuffer>>
+findRandSidecar(ArrayRef<uint8_t> BuildID, StringRef Dir, StringRef ServerURL);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_RANDSIDECAR_H
@@ -0,0 +1,136 @@
+//===- RandomStream.h - Counter-based random streams ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A single std::mt19937_64 ties every draw of a shuffle to all the draws
+// before it, thus the functions cannot be permuted on several threads without
+// changing the layout of a seed. A RandomStream is the Philox4x32-10 block
+// function (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+// keyed by the seed, over a counter of (stream ID, position): the streams of
+// a seed are independent of each other, and any of them can be drawn from on
+// any thread, in any order, with the same result.
+//
+// shuffle() is a Fisher-Yates shuffle with unbiased bounded draws, thus a
+// seed yields the same layout with every standard library as well.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_RANDOMSTREAM_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_RANDOMSTREAM_H
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace llvm {
+namespace ccr {
+
+class RandomStream {
+  uint32_t Key[2];
+  uint64_t Stream;
+  uint64_t Position = 0; // Of the next block
+  uint32_t Block[4];
+  unsigned NumUsed = 4; // 32-bit words of Block already handed out
+
+  static void mulHiLo(uint32_t A, uint32_t B, uint32_t &Hi, uint32_t &Lo) {
+    uint64_t Product = (uint64_t)A * B;
+    Hi = Product >> 32;
+    Lo = (uint32_t)Product;
+  }
+
+  void refill() {
+    uint32_t C[4] = {(uint32_t)Position, (uint32_t)(Position >> 32),
+                     (uint32_t)Stream, (uint32_t)(Stream >> 32)};
+    uint32_t K0 = Key[0], K1 = Key[1];
+    for (unsigned Round = 0; Round < 10; ++Round) {
+      uint32_t Hi0, Lo0, Hi1, Lo1;
+      mulHiLo(0xD2511F53, C[0], Hi0, Lo0);
+      mulHiLo(0xCD9E8D57, C[2], Hi1, Lo1);
+      uint32_t Next[4] = {Hi1 ^ C[1] ^ K0, Lo1, Hi0 ^ C[3] ^ K1, Lo0};
+      for (unsigned I = 0; I < 4; ++I)
+        C[I] = Next[I];
+      K0 += 0x9E3779B9;
+      K1 += 0xBB67AE85;
+    }
+    for (unsigned I = 0; I < 4; ++I)
+      Block[I] = C[I];
+    ++Position;
+    NumUsed = 0;
+  }
+
+public:
+  using result_type = uint64_t;
+
+  /// Stream \p StreamID of \p Seed; see the stream IDs below.
+  RandomStream(uint64_t Seed, uint64_t StreamID)
+      : Key{(uint32_t)Seed, (uint32_t)(Seed >> 32)}, Stream(StreamID) {}
+
+  // Koo: Domains of the stream IDs, thus e.g. the chains of function 0 and the
+  // units of bucket 0 draw from different streams
+  static uint64_t unitStream(unsigned Bucket) { return Bucket; }
+  static uint64_t functionStream(unsigned FuncIdx, unsigned Epoch = 0) {
+    return ((uint64_t)Epoch << 40) | (1ULL << 32) | FuncIdx;
+  }
+  static uint64_t epochStream(unsigned Epoch, unsigned Bucket) {
+    return ((uint64_t)Epoch << 40) | (2ULL << 32) | Bucket;
+  }
+  static uint64_t sectionStream(unsigned Class) {
+    return (3ULL << 32) | Class;
+  }
+  static uint64_t slideStream(unsigned BBLIdx) {
+    return (4ULL << 32) | BBLIdx;
+  }
+  static uint64_t nopStream(unsigned BBLIdx) {
+    return (5ULL << 32) | BBLIdx;
+  }
+  // Of a function by its identity across builds rather than its index
+  static uint64_t stableStream(uint64_t ID, unsigned Epoch = 0) {
+    return ((uint64_t)Epoch << 40) | (6ULL << 32) | (uint32_t)(ID ^ ID >> 32);
+  }
+  // Of the data groups of a section (-shuffle-data)
+  static uint64_t dataStream(unsigned SectionIdx) {
+    return (7ULL << 32) | SectionIdx;
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+
+  uint32_t next32() {
+    if (NumUsed == 4)
+      refill();
+    return Block[NumUsed++];
+  }
+
+  result_type operator()() {
+    uint64_t Low = next32();
+    return ((uint64_t)next32() << 32) | Low;
+  }
+
+  /// A uniform draw from [0, Bound), Bound > 0 (Lemire's multiply-and-reject)
+  uint32_t below(uint32_t Bound) {
+    uint64_t M = (uint64_t)next32() * Bound;
+    if ((uint32_t)M < Bound) {
+      uint32_t Threshold = -Bound % Bound;
+      while ((uint32_t)M < Threshold)
+        M = (uint64_t)next32() * Bound;
+    }
+    return M >> 32;
+  }
+};
+
+/// Permute [First, Last) uniformly with draws from \p RS
+template <typename RandomIt>
+void shuffle(RandomIt First, RandomIt Last, RandomStream &RS) {
+  using std::swap;
+  for (auto N = std::distance(First, Last); N > 1; --N)
+    swap(First[N - 1], First[RS.below(N)]);
+}
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_RANDOMSTREAM_H
@@ -0,0 +1,3373 @@
+//===- Randomizer.cpp - Rewrite a binary with a randomized layout ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Randomizer.h"
+#include "RandIndex.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Object/ELF.h"
+#include "llvm/Object/RandMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/X86Nops.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::support;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+static int64_t readValue(const uint8_t *P, unsigned Size, bool Signed) {
+  switch (Size) {
+  case 1: return Signed ? (int8_t)*P : *P;
+  case 2: return Signed ? (int16_t)endian::read16le(P) : endian::read16le(P);
+  case 4: return Signed ? (int32_t)endian::read32le(P) : endian::read32le(P);
+  case 8: return endian::read64le(P);
+  default: llvm_unreachable("[CCR-Error] Invalid fixup size!");
+  }
+}
+
+static void writeValue(uint8_t *P, unsigned Size, int64_t Value) {
+  switch (Size) {
+  case 1: *P = (uint8_t)Value; break;
+  case 2: endian::write16le(P, Value); break;
+  case 4: endian::write32le(P, Value); break;
+  case 8: endian::write64le(P, Value); break;
+  default: llvm_unreachable("[CCR-Error] Invalid fixup size!");
+  }
+}
+
+static bool fitsIn(int64_t Value, unsigned Size, bool Signed) {
+  if (Size == 8)
+    return true;
+  return Signed ? isIntN(Size * 8, Value) : isUIntN(Size * 8, Value);
+}
+
+// The same for a size known at compile time, which the patch kernels below
+// are instantiated for (see patchFixupsIn() and patchTextFixups())
+template <unsigned Size> struct FixupWord;
+template <> struct FixupWord<1> { using S = int8_t; using U = uint8_t; };
+template <> struct FixupWord<2> { using S = int16_t; using U = uint16_t; };
+template <> struct FixupWord<4> { using S = int32_t; using U = uint32_t; };
+template <> struct FixupWord<8> { using S = int64_t; using U = uint64_t; };
+
+template <unsigned Size, bool Signed>
+static int64_t readFixed(const uint8_t *P) {
+  using T = typename std::conditional<Signed, typename FixupWord<Size>::S,
+                                      typename FixupWord<Size>::U>::type;
+  return (int64_t)endian::read<T, little, unaligned>(P);
+}
+
+template <unsigned Size> static void writeFixed(uint8_t *P, int64_t Value) {
+  endian::write<typename FixupWord<Size>::U, little, unaligned>(P, Value);
+}
+
+template <unsigned Size, bool Signed> static bool fitsFixed(int64_t Value) {
+  if (Size == 8)
+    return true;
+  return Signed ? isIntN(Size * 8, Value) : isUIntN(Size * 8, Value);
+}
+
+// The padding recorded in .rand is trusted only if it decodes as NOPs (of
+// the forms the assembler emits); anything else may be code, e.g., after a
+// .p2align in inline assembly
+static bool isNopPadding(ArrayRef<uint8_t> Bytes) {
+  while (!Bytes.empty()) {
+    unsigned Size = X86::getNopLength(Bytes);
+    if (!Size)
+      return false;
+    Bytes = Bytes.drop_front(Size);
+  }
+  return true;
+}
+
+Randomizer::Randomizer(MutableArrayRef<uint8_t> Image,
+                       const RandomizerConfig &Config)
+    : Image(Image), Config(Config) {}
+
+Randomizer::~Randomizer() = default;
+
+uint8_t *Randomizer::getContents(const Section &Sec) {
+  assert(Sec.Type != ELF::SHT_NOBITS && Sec.Offset + Sec.Size <= Image.size());
+  return Image.data() + Sec.Offset;
+}
+
+const Section *Randomizer::findSection(StringRef Name) const {
+  for (const Section &Sec : Sections)
+    if (Sec.Name == Name)
+      return &Sec;
+  return nullptr;
+}
+
+uint64_t Randomizer::translateAddress(uint64_t Addr) const {
+  if (DG) {
+    uint64_t NewAddr = DG->translate(Addr);
+    if (NewAddr != Addr)
+      return NewAddr;
+  }
+  if (Addr < Text->Addr)
+    return Addr;
+  uint64_t Offset = Addr - Text->Addr;
+  if (!L->contains(Offset))
+    return Addr;
+  return Text->Addr + L->translate(Offset);
+}
+
+// The address that a reference from outside .text (data, relocations, the
+// entry point, .dynsym) takes: the slot of a function of the hot regions
+uint64_t Randomizer::translateInbound(uint64_t Addr) const {
+  if (Addr >= Text->Addr)
+    if (Optional<uint64_t> Slot = L->getHotRegionSlot(Addr - Text->Addr))
+      return Text->Addr + *Slot;
+  return translateAddress(Addr);
+}
+
+bool Randomizer::isPIC() const { return FileType == ELF::ET_DYN; }
+
+// The bytes .text may grow by without overlapping the next section in memory
+// or in the file, and without leaving its loadable segment. Only the padding
+// after the randomizable range can be used, i.e., if the range ends .text.
+uint64_t Randomizer::getTextSlack() const {
+  if (L->getEnd() != Text->Size)
+    return 0;
+  uint64_t AddrEnd = Text->Addr + Text->Size;
+  uint64_t FileEnd = Text->Offset + Text->Size;
+  uint64_t Slack = 0;
+  for (const auto &Segment : LoadSegments)
+    if (Text->Addr >= Segment.first && AddrEnd <= Segment.second)
+      Slack = Segment.second - AddrEnd;
+
+  for (const Section &Sec : Sections) {
+    if (&Sec == Text || Sec.Type == ELF::SHT_NULL)
+      continue;
+    if ((Sec.Flags & ELF::SHF_ALLOC) && Sec.Addr >= AddrEnd)
+      Slack = std::min(Slack, Sec.Addr - AddrEnd);
+    if (Sec.Type != ELF::SHT_NOBITS && Sec.Size && Sec.Offset >= FileEnd)
+      Slack = std::min(Slack, Sec.Offset - FileEnd);
+  }
+  // Neither the section header table nor the end of the file can be crossed
+  if (!Sections.empty() && Sections.front().HeaderOffset >= FileEnd)
+    Slack = std::min(Slack, Sections.front().HeaderOffset - FileEnd);
+  return std::min<uint64_t>(Slack, Image.size() - FileEnd);
+}
+
+Error Randomizer::readSections() {
+  Expected<object::ELF64LEFile> ElfOrErr =
+      object::ELF64LEFile::create(toStringRef(Image));
+  if (!ElfOrErr)
+    return ElfOrErr.takeError();
+  const object::ELF64LEFile &Elf = *ElfOrErr;
+  if (Elf.getHeader()->e_machine != ELF::EM_X86_64)
+    return makeError("Only x86-64 binaries are supported");
+  FileType = Elf.getHeader()->e_type;
+
+  auto PhdrsOrErr = Elf.program_headers();
+  if (!PhdrsOrErr)
+    return PhdrsOrErr.takeError();
+  for (const object::ELF64LE::Phdr &Phdr : *PhdrsOrErr)
+    if (Phdr.p_type == ELF::PT_LOAD)
+      LoadSegments.emplace_back(Phdr.p_vaddr, Phdr.p_vaddr + Phdr.p_filesz);
+
+  auto SectionsOrErr = Elf.sections();
+  if (!SectionsOrErr)
+    return SectionsOrErr.takeError();
+  unsigned Index = 0;
+  for (const object::ELF64LE::Shdr &Shdr : *SectionsOrErr) {
+    Expected<StringRef> NameOrErr = Elf.getSectionName(&Shdr);
+    if (!NameOrErr)
+      return NameOrErr.takeError();
+    Section Sec;
+    Sec.Name = *NameOrErr;
+    Sec.Index = Index++;
+    Sec.Type = Shdr.sh_type;
+    Sec.Flags = Shdr.sh_flags;
+    Sec.Addr = Shdr.sh_addr;
+    Sec.Offset = Shdr.sh_offset;
+    Sec.Size = Shdr.sh_size;
+    Sec.Link = Shdr.sh_link;
+    Sec.AddrAlign = Shdr.sh_addralign;
+    Sec.HeaderOffset = Elf.getHeader()->e_shoff +
+                       (uint64_t)Sec.Index * Elf.getHeader()->e_shentsize;
+    if (Sec.Type != ELF::SHT_NOBITS && Sec.Offset + Sec.Size > Image.size())
+      return makeError("Section " + Sec.Name + " is out of the file");
+    Sections.push_back(std::move(Sec));
+  }
+
+  for (StringRef Name : {".got", ".got.plt"}) {
+    const Section *Sec = findSection(Name);
+    if (!Sec || !Sec->Size)
+      continue;
+    GOT.Begin = GOT.End ? std::min(GOT.Begin, Sec->Addr) : Sec->Addr;
+    GOT.End = std::max(GOT.End, Sec->Addr + Sec->Size);
+    GOT.Base = Sec->Addr; // .got.plt wins
+  }
+  return Error::success();
+}
+
+Error Randomizer::loadRandInfo() {
+  // The sidecar stands in for the section stripped from the binary
+  const Section *Rand = findSection(".rand");
+  if (!Rand && Config.RandSidecar.empty())
+    return makeError("No .rand section; the binary has not been built with CCR");
+  Text = findSection(".text");
+  if (!Text || Text->Type == ELF::SHT_NOBITS)
+    return makeError("No .text section to randomize");
+
+  ArrayRef<uint8_t> Contents =
+      Rand ? makeArrayRef(getContents(*Rand), Rand->Size) : Config.RandSidecar;
+  uint64_t Key = getRandIndexKey(Contents);
+  bool Indexed = false;
+  if (Config.Metadata) {
+    Info = *Config.Metadata;
+    resolveGOTRelaxations();
+    Indexed = true;
+  } else if (!Config.Index.empty()) {
+    // A loader has nothing to fall back to (i.e., no protobuf decoder)
+    Expected<RandInfo> IndexOrErr = readRandIndex(Config.Index, Key, "index");
+    if (!IndexOrErr)
+      return IndexOrErr.takeError();
+    Info = std::move(*IndexOrErr);
+    Indexed = true;
+  } else if (!Config.IndexPath.empty()) {
+    Expected<RandInfo> IndexOrErr = readRandIndex(Config.IndexPath, Key);
+    if (IndexOrErr) {
+      Info = std::move(*IndexOrErr);
+      Indexed = true;
+    } else if (Config.Verbose) {
+      // A missing or stale index is simply rebuilt
+      outs() << "Rebuilding the .rand index: " << toString(IndexOrErr.takeError())
+             << "\n";
+    } else {
+      consumeError(IndexOrErr.takeError());
+    }
+  }
+
+  if (!Indexed) {
+    Expected<RandInfo> InfoOrErr =
+        Rand ? parseRandInfo(Rand->Name, Contents,
+                             Rand->Flags & ELF::SHF_COMPRESSED, Config.Parallel)
+             : parseRandInfo("the .rand sidecar", Contents, false,
+                             Config.Parallel);
+    if (!InfoOrErr)
+      return InfoOrErr.takeError();
+    Info = std::move(*InfoOrErr);
+    computeFixupOwners(Info);
+    // The index holds the fixups as resolved
+    resolveGOTRelaxations();
+    if (!Config.IndexPath.empty()) {
+      computeIncomingFixups();
+      if (Error E = writeRandIndex(Config.IndexPath, Key, Info))
+        WithColor::warning() << toString(std::move(E)) << "\n";
+    }
+  }
+
+  if (Info.RandObjOffset + Info.ObjSize > Text->Size)
+    return makeError("The layout in .rand exceeds the .text section");
+  for (const FixupInfo &F : Info.Fixups[FK_Text]) {
+    if (F.DerefSize != 1 && F.DerefSize != 2 && F.DerefSize != 4 && F.DerefSize != 8)
+      return makeError("Invalid fixup size " + Twine(F.DerefSize) + " in .text");
+    if (F.Offset + F.DerefSize > Text->Size)
+      return makeError("Fixup at .text+" + Twine::utohexstr(F.Offset) +
+                       " is out of the section");
+  }
+  return addForeignFixups();
+}
+
+// Koo: The linker relaxes a GOTPCRELX reference whose symbol it binds locally
+//      (-fno-plt, -z now): the call or jump through the GOT becomes a direct
+//      one, either with a prefix (addr32 call foo) or with a NOP after it
+//      (call foo; nop, whose rel32 is one byte ahead), the mov of an address
+//      a lea of it, and in a position-dependent binary a mov, test or binop
+//      may take the address as an immediate. The bytes tell which form a
+//      relaxable fixup has now; a relaxed one becomes the direct reference of
+//      that form, thus the randomizer keeps the call (or load) direct rather
+//      than reading its bytes as a GOT load. Resolving it twice changes nothing.
+void Randomizer::resolveGOTRelaxations() {
+  NumRelaxedGOTRefs = 0;
+  const uint8_t *Code = getContents(*Text);
+  for (FixupInfo &F : Info.Fixups[FK_Text]) {
+    if (!F.GOTRelax || F.RefClass != FRC_GOT || !F.IsRela ||
+        F.DerefSize != 4 || F.Offset < 2 || F.Offset + 4 > Text->Size)
+      continue;
+    const uint8_t *Op = Code + F.Offset;
+    if ((Op[-2] == 0xe8 || Op[-2] == 0xe9) && Op[3] == 0x90) {
+      F.Offset -= 1;
+    } else if ((Op[-1] & 0xc0) == 0xc0 &&
+               (Op[-2] == 0xc7 || Op[-2] == 0xf7 || Op[-2] == 0x81)) {
+      // ModRM of a register operand: mov $foo, test $foo or a binop $foo
+      F.IsRela = false;
+    } else if (Op[-1] != 0xe8 && Op[-2] != 0x8d) {
+      continue; // Still through the GOT (ModRM of a RIP-relative operand)
+    }
+    F.RefClass = FRC_Direct;
+    NumRelaxedGOTRefs++;
+  }
+}
+
+// Koo: The inputs without .rand (SRC_Foreign) stay in place, yet they refer
+//      to the moved code as well: the relocations the linker has kept for
+//      them (--emit-relocs) tell where. A relocation of .text out of the BBLs
+//      of .rand (or in a foreign one), or of a data section that .rand has no
+//      fixup at, becomes a fixup of its own; the rest of the randomizer does
+//      not tell it from those of the compiler. With Config.ShuffleData, the
+//      code around the objects of .rand (e.g., that of crt1.o) refers to the
+//      moved data objects likewise.
+Error Randomizer::addForeignFixups() {
+  NumForeignObjects = count(Info.SourceTypes, (uint32_t)SRC_Foreign);
+  NumForeignFixups = 0;
+  bool Uncovered = Config.ShuffleData &&
+                   (Info.RandObjOffset ||
+                    Info.RandObjOffset + Info.ObjSize < Text->Size);
+  if (!NumForeignObjects && !Uncovered)
+    return Error::success();
+
+  std::vector<std::pair<uint64_t, uint64_t>> Foreign; // [begin, end) of .text
+  uint64_t Offset = Info.RandObjOffset;
+  unsigned Object = 0;
+  for (const BasicBlockInfo &BBL : Info.BasicBlocks) {
+    if (Info.getSourceType(Object) == SRC_Foreign)
+      Foreign.emplace_back(Offset, Offset + BBL.Size);
+    Offset += BBL.Size;
+    Object += BBL.Type == BBT_ObjectEnd;
+  }
+  auto InForeignCode = [&](uint64_t Off) {
+    if (Off < Info.RandObjOffset || Off >= Info.RandObjOffset + Info.ObjSize)
+      return true;
+    auto It = std::upper_bound(
+        Foreign.begin(), Foreign.end(), Off,
+        [](uint64_t O, const std::pair<uint64_t, uint64_t> &R) {
+          return O < R.first;
+        });
+    return It != Foreign.begin() && Off < std::prev(It)->second;
+  };
+
+  bool AnyRelocations = false;
+  for (const Section &Rela : Sections) {
+    StringRef Name = Rela.Name;
+    if (Rela.Type != ELF::SHT_RELA || (Rela.Flags & ELF::SHF_ALLOC) ||
+        !Name.startswith(".rela"))
+      continue;
+    const Section *Sec = findSection(Name.drop_front(5));
+    if (!Sec || !(Sec->Flags & ELF::SHF_ALLOC) || Sec->Type == ELF::SHT_NOBITS)
+      continue;
+    unsigned Kind = NumFixupKinds;
+    for (unsigned K = FK_Text; K <= FK_TData; ++K)
+      if (Sec->Name == getFixupKindSectionName(FixupKind(K)))
+        Kind = K;
+    if (Kind == NumFixupKinds)
+      continue;
+    AnyRelocations = true;
+
+    std::vector<FixupInfo> &Fixups = Info.Fixups[Kind];
+    DenseSet<uint64_t> Known;
+    for (const FixupInfo &F : Fixups)
+      Known.insert(F.Offset);
+    const uint8_t *R = getContents(Rela);
+    for (uint64_t Off = 0; Off + sizeof(ELF::Elf64_Rela) <= Rela.Size;
+         Off += sizeof(ELF::Elf64_Rela)) {
+      FixupInfo F;
+      F.Offset = endian::read64le(R + Off) - Sec->Addr;
+      switch (endian::read64le(R + Off + 8) & 0xffffffff) {
+      case ELF::R_X86_64_PC32:
+      case ELF::R_X86_64_PLT32:
+      case ELF::R_X86_64_GOTPCREL: // Relaxed to the symbol itself, or not
+      case ELF::R_X86_64_GOTPCRELX:
+      case ELF::R_X86_64_REX_GOTPCRELX:
+        F.DerefSize = 4;
+        F.IsRela = true;
+        break;
+      case ELF::R_X86_64_PC64:
+        F.DerefSize = 8;
+        F.IsRela = true;
+        break;
+      case ELF::R_X86_64_32:
+      case ELF::R_X86_64_32S:
+        F.DerefSize = 4;
+        break;
+      case ELF::R_X86_64_64:
+        F.DerefSize = 8;
+        break;
+      default:
+        continue;
+      }
+      if (F.Offset + F.DerefSize > Sec->Size)
+        return makeError("The relocation at " +
+                         Twine::utohexstr(Sec->Addr + F.Offset) + " in " +
+                         Rela.Name + " is out of " + Sec->Name);
+      if ((Kind == FK_Text && !InForeignCode(F.Offset)) ||
+          !Known.insert(F.Offset).second)
+        continue;
+      Fixups.push_back(F);
+      NumForeignFixups++;
+    }
+  }
+  if (!AnyRelocations && !NumForeignObjects)
+    return makeError("The code out of the objects of .rand refers to the moved "
+                     "data objects by the relocations of --emit-relocs only; "
+                     "relink with it");
+  if (!AnyRelocations)
+    return makeError(Twine(NumForeignObjects) +
+                     " input(s) without .rand stay in place, whose references "
+                     "to the moved code are told by the relocations of "
+                     "--emit-relocs only; relink with it");
+  // In ascending offsets again, each with its BBL (if any); the references
+  // by index have moved along
+  computeFixupOwners(Info);
+  if (Info.hasIncomingFixups())
+    computeIncomingFixups();
+  return Error::success();
+}
+
+// Koo: The target of a fixup is read from the binary as the patching reads it
+//      (see relocateTextFixup() and patchFixupsIn()); the references to the
+//      GOT, to data and the TP/DTP offsets are into no function
+void Randomizer::computeIncomingFixups() {
+  const Section *FixupSections[NumFixupKinds] = {Text};
+  for (unsigned K = FK_Rodata; K < FK_Custom; ++K)
+    FixupSections[K] = findSection(getFixupKindSectionName(FixupKind(K)));
+  DenseMap<uint32_t, const Section *> CustomSections; // By SectionIdx
+  auto TargetOf = [&](unsigned Kind, const FixupInfo &F) -> Optional<uint64_t> {
+    if (F.Target == FT_Data || F.RefClass == FRC_TLS || F.DerefSize == 0 ||
+        F.DerefSize > 8)
+      return None;
+    const Section *Sec = FixupSections[Kind];
+    if (Kind == FK_Custom) {
+      if (F.SectionIdx >= Info.SectionNames.size())
+        return None;
+      auto It = CustomSections.find(F.SectionIdx);
+      if (It == CustomSections.end())
+        It = CustomSections
+                 .insert({F.SectionIdx,
+                          findOutputSection(Info.SectionNames[F.SectionIdx])})
+                 .first;
+      Sec = It->second;
+    }
+    if (!Sec || Sec->Type == ELF::SHT_NOBITS ||
+        F.Offset + F.DerefSize > Sec->Size)
+      return None;
+    const uint8_t *P = getContents(*Sec) + F.Offset;
+    uint64_t Target;
+    if (F.RefClass == FRC_GOT && !F.IsRela && GOT.Base)
+      Target = GOT.Base + readValue(P, F.DerefSize, /*Signed=*/true);
+    else if (F.IsRela)
+      Target = Sec->Addr + F.Offset + (Kind == FK_Text ? F.DerefSize : 0) +
+               readValue(P, F.DerefSize, /*Signed=*/true);
+    else
+      Target = readValue(P, F.DerefSize, /*Signed=*/false);
+    if (Target < Text->Addr)
+      return None;
+    return Target - Text->Addr;
+  };
+  ccr::computeIncomingFixups(Info, TargetOf);
+}
+
+// Koo: Whether the fixup \p F is the displacement of a direct call, jump or
+// conditional branch, i.e., no address that the code may keep
+static bool isDirectTransfer(const FixupInfo &F, const uint8_t *OldText) {
+  if (!F.IsRela || F.RefClass == FRC_GOT || F.RefClass == FRC_TLS)
+    return false;
+  if (F.RelaxShortSize || F.ShrinkLongSize)
+    return true;
+  const uint8_t *Op = OldText + F.Offset;
+  if (F.DerefSize == 1 && F.Offset >= 1)
+    return Op[-1] == 0xeb || (Op[-1] & 0xf0) == 0x70;
+  if (F.DerefSize == 4 && F.Offset >= 2)
+    return Op[-1] == 0xe8 || Op[-1] == 0xe9 ||
+           (Op[-2] == 0x0f && (Op[-1] & 0xf0) == 0x80);
+  return false;
+}
+
+static TextFixup relocateTextFixupTo(const FixupInfo &F, bool Relaxed,
+                                     bool Shrunk, const uint8_t *OldText,
+                                     uint64_t TextAddr, const Layout &L,
+                                     const GOTInfo &GOT,
+                                     function_ref<uint64_t(uint64_t)> Translate) {
+  TextFixup R;
+  const uint8_t *P = OldText + F.Offset;
+  uint64_t OldAddr = TextAddr + F.Offset;
+  R.NewSize = F.DerefSize;
+  if (Relaxed) {
+    // The long form (rel32) replaces the whole short instruction
+    uint64_t Inst = F.Offset + F.DerefSize - F.RelaxShortSize;
+    R.NewOffset = L.translateWithin(F.OwnerBBL, Inst) + F.RelaxFixupOffset;
+    R.NewSize = 4;
+  } else if (Shrunk) {
+    // The short form (rel8) replaces the whole long instruction
+    uint64_t Inst = F.Offset + F.DerefSize - F.ShrinkLongSize;
+    R.NewOffset = L.translateWithin(F.OwnerBBL, Inst) + F.ShrinkShortSize - 1;
+    R.NewSize = 1;
+  } else if (F.OwnerBBL >= 0) {
+    R.NewOffset = L.translateWithin(F.OwnerBBL, F.Offset);
+  } else {
+    R.NewOffset = L.translate(F.Offset);
+  }
+  uint64_t NewAddr = TextAddr + R.NewOffset;
+
+  // A TP/DTP offset is no address; neither is a TLS access to the GOT once the
+  // linker has relaxed it into a TP offset (GD/IE to LE), which is told by the
+  // target being out of the GOT now
+  if (F.RefClass == FRC_TLS &&
+      (!F.IsRela ||
+       !GOT.contains(OldAddr + F.DerefSize +
+                     readValue(P, F.DerefSize, /*Signed=*/true)))) {
+    R.NewValue = readValue(P, F.DerefSize, F.IsRela);
+    R.OldTarget = 0;
+    R.Fits = true;
+    return R;
+  }
+
+  // An absolute GOT-relative value (foo@GOTOFF) is the target less the GOT base
+  if (F.RefClass == FRC_GOT && !F.IsRela && GOT.Base) {
+    int64_t V = readValue(P, F.DerefSize, /*Signed=*/true);
+    R.OldTarget = GOT.Base + V;
+    R.NewValue = (int64_t)(Translate(R.OldTarget) - GOT.Base);
+    R.Fits = fitsIn(R.NewValue, F.DerefSize, /*Signed=*/true);
+    return R;
+  }
+
+  if (F.IsRela) {
+    // The PC-relative fixup ends the instruction (branches, calls, lea and
+    // RIP-relative operands without a trailing immediate)
+    int64_t V = readValue(P, F.DerefSize, /*Signed=*/true);
+    R.OldTarget = OldAddr + F.DerefSize + V;
+    uint64_t NewTarget = Translate(R.OldTarget);
+    R.NewValue = V + (int64_t)(NewTarget - R.OldTarget) -
+                 (int64_t)(NewAddr - OldAddr) + (int64_t)F.DerefSize -
+                 (int64_t)R.NewSize;
+    R.Fits = fitsIn(R.NewValue, R.NewSize, /*Signed=*/true);
+  } else {
+    R.OldTarget = readValue(P, F.DerefSize, /*Signed=*/false);
+    R.NewValue = Translate(R.OldTarget);
+    R.Fits = fitsIn(R.NewValue, F.DerefSize, /*Signed=*/false);
+  }
+  return R;
+}
+
+static TextFixup relocateTextFixup(const FixupInfo &F, bool Relaxed,
+                                   bool Shrunk, const uint8_t *OldText,
+                                   uint64_t TextAddr,
+                                   const Layout &L, const GOTInfo &GOT,
+                                   function_ref<uint64_t(uint64_t)> Translate) {
+  // Koo: The references into the hot regions go to the slots of the functions
+  //      unless they are the calls and branches within the regions, thus the
+  //      code outside is the same for every seed of the regions, and so is an
+  //      address of a function wherever it is taken
+  if (!L.hotRegions().empty()) {
+    bool Within = F.OwnerBBL >= 0 &&
+                  L.functions()[L.basicBlocks()[F.OwnerBBL].Function].HotRegion &&
+                  isDirectTransfer(F, OldText);
+    if (!Within) {
+      auto ToSlot = [&](uint64_t Addr) {
+        if (Addr >= TextAddr)
+          if (Optional<uint64_t> Slot = L.getHotRegionSlot(Addr - TextAddr))
+            return TextAddr + *Slot;
+        return Translate(Addr);
+      };
+      return relocateTextFixupTo(F, Relaxed, Shrunk, OldText, TextAddr, L,
+                                 GOT, ToSlot);
+    }
+  }
+  return relocateTextFixupTo(F, Relaxed, Shrunk, OldText, TextAddr, L, GOT,
+                             Translate);
+}
+
+// The branch whose displacement is the fixup \p F in \p OldText: a jump
+// (jmp rel8/rel32), a conditional branch (jcc rel8/rel32) or neither. The
+// compiler has recorded the last instruction of every BBL (see
+// BasicBlock::TermKind), thus a fixup that ends the code of its BBL is told
+// by the record; the opcode is read for the others and for older objects.
+enum BranchKind { BK_None, BK_Jump, BK_CondBranch };
+
+static BranchKind getBranchKind(const FixupInfo &F, const uint8_t *OldText,
+                                const Layout &L) {
+  if (!F.IsRela || (F.RefClass != FRC_Direct && F.RefClass != FRC_PLT) ||
+      F.Offset < 2)
+    return BK_None;
+  if (F.OwnerBBL >= 0) {
+    const BasicBlock &BBL = L.basicBlocks()[F.OwnerBBL];
+    if (BBL.TermKind != TK_None &&
+        F.Offset + F.DerefSize == BBL.OldOffset + BBL.Size - BBL.Padding) {
+      // A prefixed branch (i.e., bnd jmp) is larger than its plain form
+      if (BBL.TermKind == TK_Jump)
+        return (F.DerefSize == 1 || F.DerefSize == 4) &&
+                       BBL.TermSize == 1 + F.DerefSize
+                   ? BK_Jump
+                   : BK_None;
+      if (BBL.TermKind == TK_CondBranch)
+        return BBL.TermSize == (F.DerefSize == 1 ? 2 : 6) &&
+                       (F.DerefSize == 1 || F.DerefSize == 4)
+                   ? BK_CondBranch
+                   : BK_None;
+      return BK_None;
+    }
+  }
+  const uint8_t *Op = OldText + F.Offset;
+  if (F.DerefSize == 1)
+    return Op[-1] == 0xeb ? BK_Jump
+                          : (Op[-1] & 0xf0) == 0x70 ? BK_CondBranch : BK_None;
+  if (F.DerefSize == 4)
+    return Op[-1] == 0xe9 ? BK_Jump
+                          : Op[-2] == 0x0f && (Op[-1] & 0xf0) == 0x80
+                                ? BK_CondBranch
+                                : BK_None;
+  return BK_None;
+}
+
+void Randomizer::forEachFunctionSymbol(
+    function_ref<void(StringRef, uint64_t)> Fn) {
+  for (const Section &Sec : Sections) {
+    if (Sec.Type != ELF::SHT_SYMTAB && Sec.Type != ELF::SHT_DYNSYM)
+      continue;
+    if (Sec.Link >= Sections.size())
+      continue;
+    const Section &Strtab = Sections[Sec.Link];
+    StringRef Strings(reinterpret_cast<const char *>(getContents(Strtab)),
+                      Strtab.Size);
+    const uint8_t *Contents = getContents(Sec);
+    for (uint64_t Off = 0; Off + sizeof(ELF::Elf64_Sym) <= Sec.Size;
+         Off += sizeof(ELF::Elf64_Sym)) {
+      const uint8_t *Sym = Contents + Off;
+      uint32_t Name = endian::read32le(Sym);
+      if ((Sym[4] & 0xf) != ELF::STT_FUNC || Name >= Strings.size())
+        continue;
+      Fn(Strings.drop_front(Name).split('\0').first,
+         endian::read64le(Sym + 8));
+    }
+  }
+}
+
+// Koo: With Config.EntryTrampolines, the entries of the exported functions (of
+// .dynsym, with default or protected visibility) keep a jump to the new places
+// of their functions, thus .dynsym and whatever took the addresses from it (a
+// prelinked or cached lookup, the result of dlsym()) stay valid. The calls and
+// references within the object are patched to the functions as ever; only the
+// callers through .dynsym take the jump. An entry too close to the next one
+// (or to the end of the range) for a jump is patched in .dynsym instead, as
+// with the pinned functions, which need no trampoline.
+static const unsigned TrampolineSize = 5; // jmp rel32
+
+Error Randomizer::planTrampolines() {
+  if (!isPIC())
+    return makeError("Entry trampolines keep the exported functions of "
+                     "shared objects (and PIEs) only");
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  std::vector<uint64_t> Entries;
+  for (const Section &Sec : Sections) {
+    if (Sec.Type != ELF::SHT_DYNSYM)
+      continue;
+    const uint8_t *Contents = getContents(Sec);
+    for (uint64_t Off = 0; Off + sizeof(ELF::Elf64_Sym) <= Sec.Size;
+         Off += sizeof(ELF::Elf64_Sym)) {
+      const uint8_t *Sym = Contents + Off;
+      uint8_t Type = Sym[4] & 0xf, Bind = Sym[4] >> 4, Visibility = Sym[5] & 0x3;
+      if ((Type != ELF::STT_FUNC && Type != ELF::STT_GNU_IFUNC) ||
+          (Bind != ELF::STB_GLOBAL && Bind != ELF::STB_WEAK) ||
+          (Visibility != ELF::STV_DEFAULT && Visibility != ELF::STV_PROTECTED) ||
+          endian::read16le(Sym + 6) != Text->Index)
+        continue;
+      uint64_t Value = endian::read64le(Sym + 8);
+      if (Value < Text->Addr || !L->contains(Value - Text->Addr))
+        continue;
+      int Idx = L->findBasicBlock(Value - Text->Addr);
+      if (Idx < 0 || BBLs[Idx].OldOffset != Value - Text->Addr)
+        continue;
+      const ccr::Function &F = Funcs[BBLs[Idx].Function];
+      if ((unsigned)Idx == F.FirstBBL && !F.Pinned)
+        Entries.push_back(Value - Text->Addr);
+    }
+  }
+  llvm::sort(Entries);
+  Entries.erase(std::unique(Entries.begin(), Entries.end()), Entries.end());
+
+  std::vector<uint64_t> Kept;
+  for (size_t I = 0, E = Entries.size(); I != E; ++I) {
+    uint64_t Next = I + 1 != E ? Entries[I + 1] : L->getEnd();
+    if (Next - Entries[I] >= TrampolineSize)
+      Kept.push_back(Entries[I]);
+  }
+  if (Config.Verbose && Kept.size() < Entries.size())
+    outs() << "Patching " << Entries.size() - Kept.size()
+           << " exported function(s) in .dynsym: too short for a trampoline\n";
+  L->setTrampolines(std::move(Kept), TrampolineSize);
+  return Error::success();
+}
+
+// The trampolines that start within [Lo, Hi) (of the new .text), over the
+// padding that the layout left for them
+void Randomizer::writeTrampolines(uint8_t *NewText, uint64_t Lo,
+                                  uint64_t Hi) const {
+  ArrayRef<uint64_t> Entries = L->trampolines();
+  for (auto I = std::lower_bound(Entries.begin(), Entries.end(), Lo);
+       I != Entries.end() && *I < Hi; ++I) {
+    uint8_t *P = NewText + *I;
+    P[0] = 0xe9;
+    endian::write32le(P + 1, uint32_t(L->translate(*I) - (*I + TrampolineSize)));
+  }
+}
+
+// The slots of the hot regions that start within [Lo, Hi) (of the new .text):
+// a jump to the function of each, which the seed of the regions has placed
+void Randomizer::writeHotRegionSlots(uint8_t *NewText, uint64_t Lo,
+                                     uint64_t Hi) const {
+  const unsigned SlotSize = Layout::HotRegionSlotSize;
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  for (const ccr::HotRegion &R : L->hotRegions())
+    for (size_t I = 0, E = R.Functions.size(); I != E; ++I) {
+      uint64_t Slot = R.Begin + I * SlotSize;
+      if (Slot < Lo || Slot >= Hi)
+        continue;
+      uint8_t *P = NewText + Slot;
+      P[0] = 0xe9;
+      uint64_t Target = BBLs[Funcs[R.Functions[I]].FirstBBL].NewOffset;
+      endian::write32le(P + 1, uint32_t(Target - (Slot + SlotSize)));
+    }
+}
+
+// The words that a RELR table (-z pack-relative-relocs) relocates
+static Error forEachRelrWord(ArrayRef<uint8_t> Contents,
+                             function_ref<Error(uint64_t)> Fn) {
+  uint64_t Base = 0;
+  for (uint64_t Off = 0; Off + 8 <= Contents.size(); Off += 8) {
+    uint64_t Entry = endian::read64le(Contents.data() + Off);
+    if (!(Entry & 1)) {
+      if (Error E = Fn(Entry))
+        return E;
+      Base = Entry + 8;
+      continue;
+    }
+    // A bitmap of the 63 words from Base on
+    for (unsigned Bit = 0; Bit < 63; ++Bit)
+      if (Entry & (2ULL << Bit))
+        if (Error E = Fn(Base + Bit * 8))
+          return E;
+    Base += 63 * 8;
+  }
+  return Error::success();
+}
+
+// Koo: With Config.ShuffleData, the objects of .data and .bss (those of the
+// symbol table) move in the groups of DataGroups.h, once every reference to
+// them is known: the d2d fixups of every object of .rand (the chunks of
+// format 3 tell those built with -ccr-keep-data-fixups), the relocations of
+// the code without .rand (see addForeignFixups()) and the dynamic
+// relocations. What has no record stays: the words of the RELR bitmaps, and
+// the DW.ref.* personality pointers that .eh_frame refers to.
+static const uint64_t DataGroupGrain = 64; // A cache line
+
+Error Randomizer::planDataGroups() {
+  if (Info.FormatVersion < 3)
+    return makeError("The data objects move by the .rand chunks of "
+                     "-ccr-rand-format=3 only, which tell the objects built "
+                     "with -ccr-keep-data-fixups");
+  unsigned Object = 0;
+  for (const BasicBlockInfo &BBL : Info.BasicBlocks) {
+    if (BBL.Type != BBT_ObjectEnd)
+      continue;
+    if (Info.getSourceType(Object) != SRC_Foreign &&
+        !Info.hasDataFixups(Object))
+      return makeError("An object of .rand has left out the fixups of its "
+                       "data to data; build with -ccr-keep-data-fixups to "
+                       "move the data objects");
+    ++Object;
+  }
+  const Section *Symtab = nullptr;
+  for (const Section &Sec : Sections)
+    if (Sec.Type == ELF::SHT_SYMTAB)
+      Symtab = &Sec;
+  if (!Symtab || Symtab->Link >= Sections.size())
+    return makeError("The data objects are told by .symtab, which the binary "
+                     "lacks");
+
+  for (StringRef Name : {".data", ".bss"}) {
+    const Section *Sec = findSection(Name);
+    if (Sec && Sec->Size && (Sec->Flags & ELF::SHF_ALLOC) &&
+        (Sec->Flags & ELF::SHF_WRITE) && !(Sec->Flags & ELF::SHF_TLS))
+      DataSections.push_back(Sec);
+  }
+
+  std::vector<uint64_t> Pinned;
+  for (const Section &Sec : Sections)
+    if (Sec.Type == ELF::SHT_RELR || Sec.Type == ELF::SHT_ANDROID_RELR)
+      cantFail(forEachRelrWord(makeArrayRef(getContents(Sec), Sec.Size),
+                               [&](uint64_t Addr) {
+                                 Pinned.push_back(Addr);
+                                 return Error::success();
+                               }));
+
+  StringMap<int> Affinity;
+  for (size_t I = 0, E = Config.DataAffinity.size(); I != E; ++I)
+    for (const std::string &Name : Config.DataAffinity[I])
+      Affinity.try_emplace(Name, I);
+
+  std::vector<std::vector<DataObject>> Objects(DataSections.size());
+  const Section &Strtab = Sections[Symtab->Link];
+  StringRef Strings(reinterpret_cast<const char *>(getContents(Strtab)),
+                    Strtab.Size);
+  const uint8_t *Contents = getContents(*Symtab);
+  for (uint64_t Off = 0; Off + sizeof(ELF::Elf64_Sym) <= Symtab->Size;
+       Off += sizeof(ELF::Elf64_Sym)) {
+    const uint8_t *Sym = Contents + Off;
+    uint16_t Shndx = endian::read16le(Sym + 6);
+    auto It = find_if(DataSections,
+                      [&](const Section *Sec) { return Sec->Index == Shndx; });
+    if ((Sym[4] & 0xf) != ELF::STT_OBJECT || It == DataSections.end())
+      continue;
+    uint32_t NameOffset = endian::read32le(Sym);
+    StringRef Name = NameOffset < Strings.size()
+                         ? Strings.drop_front(NameOffset).split('\0').first
+                         : StringRef();
+    DataObject O;
+    O.Addr = endian::read64le(Sym + 8);
+    O.Size = endian::read64le(Sym + 16);
+    auto Set = Affinity.find(Name);
+    if (Set != Affinity.end())
+      O.Affinity = Set->second;
+    if (Name.startswith("DW.ref."))
+      Pinned.push_back(O.Addr);
+    Objects[It - DataSections.begin()].push_back(O);
+  }
+
+  DG = llvm::make_unique<DataGroups>();
+  for (size_t I = 0, E = DataSections.size(); I != E; ++I) {
+    const Section &Sec = *DataSections[I];
+    ArrayRef<uint8_t> Bytes;
+    if (Sec.Type != ELF::SHT_NOBITS)
+      Bytes = makeArrayRef(getContents(Sec), Sec.Size);
+    RandomStream RS(Config.Seed, RandomStream::dataStream(Sec.Index));
+    DG->addSection(Sec.Addr, Sec.Size,
+                   std::max<uint64_t>(DataGroupGrain, Sec.AddrAlign), Bytes,
+                   std::move(Objects[I]), Pinned, RS);
+  }
+  if (DG->empty())
+    DG.reset();
+  return Error::success();
+}
+
+// The groups move within the contents of their sections, after everything in
+// them has been patched at its old place; so does a word of the GOT that a
+// position-dependent binary has resolved at link time
+void Randomizer::moveDataGroups() {
+  if (!isPIC())
+    for (StringRef Name : {".got", ".got.plt"}) {
+      const Section *Sec = findSection(Name);
+      if (!Sec || Sec->Type == ELF::SHT_NOBITS)
+        continue;
+      uint8_t *Words = getContents(*Sec);
+      for (uint64_t Off = 0; Off + 8 <= Sec->Size; Off += 8)
+        endian::write64le(Words + Off,
+                          DG->translate(endian::read64le(Words + Off)));
+    }
+  for (const Section *Sec : DataSections)
+    if (Sec->Type != ELF::SHT_NOBITS)
+      DG->moveContents(Sec->Addr,
+                       makeMutableArrayRef(getContents(*Sec), Sec->Size));
+}
+
+// Koo: The functions a cold start runs are the entry point, main and the
+// static constructors (.preinit_array, .init_array), along with the code they
+// reach through PC-relative .text fixups (calls, tail calls, and the function
+// pointers taken by lea) up to Config.StartupDepth levels deep. A startup
+// profile (the symbols a traced run executed) names them instead. Taking too
+// many only costs entropy: the startup functions are still permuted.
+void Randomizer::markStartupFunctions() {
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  std::vector<bool> Seen(Funcs.size());
+  std::vector<unsigned> Startup;
+  auto AddFunction = [&](uint64_t Addr) {
+    if (Addr < Text->Addr || !L->contains(Addr - Text->Addr))
+      return;
+    int Idx = L->findBasicBlock(Addr - Text->Addr);
+    if (Idx < 0 || Seen[BBLs[Idx].Function])
+      return;
+    Seen[BBLs[Idx].Function] = true;
+    Startup.push_back(BBLs[Idx].Function);
+  };
+
+  if (!Config.StartupSymbols.empty()) {
+    StringSet<> Names;
+    for (const std::string &Name : Config.StartupSymbols)
+      Names.insert(Name);
+    forEachFunctionSymbol([&](StringRef Name, uint64_t Addr) {
+      if (Names.count(Name))
+        AddFunction(Addr);
+    });
+    L->setStartupFunctions(Startup);
+    return;
+  }
+
+  AddFunction(endian::read64le(Image.data() + offsetof(ELF::Elf64_Ehdr, e_entry)));
+  if (Info.MainAddrOffset)
+    AddFunction(Text->Addr + Info.MainAddrOffset);
+  forEachFunctionSymbol([&](StringRef Name, uint64_t Addr) {
+    if (Name == "main")
+      AddFunction(Addr);
+  });
+  // The constructors of a PIE are the addends of its relative relocations
+  for (StringRef Name : {".preinit_array", ".init_array"}) {
+    const Section *Sec = findSection(Name);
+    if (!Sec || Sec->Type == ELF::SHT_NOBITS)
+      continue;
+    const uint8_t *Contents = getContents(*Sec);
+    for (uint64_t Off = 0; Off + 8 <= Sec->Size; Off += 8)
+      AddFunction(endian::read64le(Contents + Off));
+    for (const Section &Rela : Sections) {
+      if (Rela.Type != ELF::SHT_RELA || !(Rela.Flags & ELF::SHF_ALLOC))
+        continue;
+      const uint8_t *R = getContents(Rela);
+      for (uint64_t Off = 0; Off + sizeof(ELF::Elf64_Rela) <= Rela.Size;
+           Off += sizeof(ELF::Elf64_Rela)) {
+        uint64_t Where = endian::read64le(R + Off);
+        if (Where >= Sec->Addr && Where < Sec->Addr + Sec->Size &&
+            (endian::read64le(R + Off + 8) & 0xffffffff) ==
+                ELF::R_X86_64_RELATIVE)
+          AddFunction(endian::read64le(R + Off + 16));
+      }
+    }
+  }
+
+  // The .text fixups are sorted, thus those of a function are a run
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  size_t LevelBegin = 0;
+  for (unsigned Depth = 0; Depth < Config.StartupDepth; ++Depth) {
+    size_t LevelEnd = Startup.size();
+    for (size_t I = LevelBegin; I != LevelEnd; ++I) {
+      const ccr::Function &F = Funcs[Startup[I]];
+      const BasicBlock &Last = BBLs[F.FirstBBL + F.NumBBLs - 1];
+      uint64_t Begin = BBLs[F.FirstBBL].OldOffset;
+      uint64_t End = Last.OldOffset + Last.Size;
+      auto It = std::lower_bound(Fixups.begin(), Fixups.end(), Begin,
+                                 [](const FixupInfo &Fx, uint64_t Offset) {
+                                   return Fx.Offset < Offset;
+                                 });
+      for (; It != Fixups.end() && It->Offset < End; ++It) {
+        if (!It->IsRela || It->DerefSize != 4 || It->Target == FT_Data ||
+            It->RefClass == FRC_TLS)
+          continue;
+        int64_t V = readValue(OldText.data() + It->Offset, 4, /*Signed=*/true);
+        AddFunction(Text->Addr + It->Offset + 4 + V);
+      }
+    }
+    LevelBegin = LevelEnd;
+  }
+  L->setStartupFunctions(Startup);
+}
+
+// Koo: The records of the profile become the edges between the BBLs: a taken
+// branch is one edge, and a fall-through range crosses every BBL boundary in
+// it. A range that leaves the randomizable code, or steps over a BBL that
+// does not fall through, is stale and dropped as a whole.
+//
+// The code sampled by a sample profile (see SampleProfile.h) tells no edges:
+// a BBL counts the most samples of its code, and the edges are inferred from
+// the counts. The fall-through into the next BBL and every branch to a BBL
+// of the function take the fewer samples of their ends.
+void Randomizer::setLayoutProfile() {
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  auto FindBBL = [&](uint64_t Addr) {
+    if (Addr < Text->Addr || !L->contains(Addr - Text->Addr))
+      return -1;
+    return L->findBasicBlock(Addr - Text->Addr);
+  };
+  std::vector<ProfileEdge> Edges;
+  std::vector<uint64_t> Samples;
+  for (const ProfileRecord &R : Config.Profile) {
+    int From = FindBBL(R.From), To = FindBBL(R.To);
+    if (From < 0 || To < 0 || !R.Count)
+      continue;
+    if (R.Sampled) {
+      if (Samples.empty())
+        Samples.assign(BBLs.size(), 0);
+      for (int I = From; I <= To; ++I)
+        Samples[I] = std::max(Samples[I], R.Count);
+      continue;
+    }
+    if (!R.FallThrough) {
+      Edges.push_back({unsigned(From), unsigned(To), R.Count});
+      continue;
+    }
+    if (To < From ||
+        std::any_of(BBLs.begin() + From, BBLs.begin() + To,
+                    [](const BasicBlock &BBL) { return !BBL.FallThrough; }))
+      continue;
+    for (int I = From; I < To; ++I)
+      Edges.push_back({unsigned(I), unsigned(I + 1), R.Count});
+  }
+
+  if (!Samples.empty()) {
+    for (unsigned I = 0, E = BBLs.size(); I + 1 < E; ++I)
+      if (BBLs[I].FallThrough && std::min(Samples[I], Samples[I + 1]))
+        Edges.push_back({I, I + 1, std::min(Samples[I], Samples[I + 1])});
+    for (const FixupInfo &F : Info.Fixups[FK_Text]) {
+      if (getBranchKind(F, OldText.data(), *L) == BK_None ||
+          !L->contains(F.Offset))
+        continue;
+      uint64_t Target = F.Offset + F.DerefSize +
+                        readValue(OldText.data() + F.Offset, F.DerefSize,
+                                  /*Signed=*/true);
+      int From = F.OwnerBBL >= 0 ? F.OwnerBBL : L->findBasicBlock(F.Offset);
+      int To = L->contains(Target) ? L->findBasicBlock(Target) : -1;
+      if (From < 0 || To < 0 || BBLs[To].OldOffset != Target ||
+          BBLs[From].Function != BBLs[To].Function)
+        continue;
+      if (uint64_t Count = std::min(Samples[From], Samples[To]))
+        Edges.push_back({unsigned(From), unsigned(To), Count});
+    }
+  }
+  L->setProfile(std::move(Edges), std::move(Samples));
+}
+
+// Koo: The direct calls (and tail calls) are the 4-byte PC-relative .text
+// fixups into the entry of another function, as markStartupFunctions() takes
+// them; each call site weighs one
+void Randomizer::buildCallGraph() {
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  std::vector<ProfileEdge> Calls;
+  for (const FixupInfo &F : Info.Fixups[FK_Text]) {
+    if (!F.IsRela || F.DerefSize != 4 || F.Target == FT_Data ||
+        F.RefClass == FRC_TLS || !L->contains(F.Offset))
+      continue;
+    int64_t V = readValue(OldText.data() + F.Offset, 4, /*Signed=*/true);
+    uint64_t Target = F.Offset + 4 + V;
+    int From = F.OwnerBBL >= 0 ? F.OwnerBBL : L->findBasicBlock(F.Offset);
+    int To = L->contains(Target) ? L->findBasicBlock(Target) : -1;
+    if (From < 0 || To < 0 || BBLs[To].OldOffset != Target ||
+        (unsigned)To != Funcs[BBLs[To].Function].FirstBBL ||
+        BBLs[From].Function == BBLs[To].Function)
+      continue;
+    Calls.push_back({unsigned(From), unsigned(To), 1});
+  }
+  L->setCallGraph(std::move(Calls));
+}
+
+// Koo: The assembler relaxed the branches whose targets were out of the reach
+// of rel8 in the old layout (and, for want of a layout, those to other
+// functions), and .rand tells their short forms. Once the chains are
+// shuffled, many land close to their targets again: every one that reaches
+// in the new layout goes back to its short form, 3 or 4 bytes less, and the
+// layout shrinks. Only the code after it moves, thus a branch is shrunk only
+// where no CFI row follows in its function: past the entry chain of a function
+// that has CFI only in there (which is all a shuffle of its BBLs relies on), or
+// as the last instruction of its function. Shrinking the code (or realigning
+// it) may push others out of reach again, which fixBranchRange() grows back.
+// Koo: The passes that settle the branches scan the .text fixups again on
+// every step of the layout, yet only look at a few shapes of them: one scan
+// over the records buckets their indices, and the passes walk the compact
+// columns of those instead.
+void Randomizer::bucketFixups() {
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  Buckets = FixupBuckets();
+  for (size_t I = 0, E = Fixups.size(); I != E; ++I) {
+    const FixupInfo &F = Fixups[I];
+    if ((F.IsRela && F.DerefSize < 4) || F.isShrinkable())
+      Buckets.RangeLimited.push_back(I);
+    if (F.isShrinkable())
+      Buckets.Shrinkable.push_back(I);
+    if (getBranchKind(F, OldText.data(), *L) == BK_Jump &&
+        OldText[F.Offset - 2] != 0xf2) // bnd jmp
+      Buckets.Jumps.push_back(I);
+  }
+}
+
+void Randomizer::shrinkBranches() {
+  auto Translate = [this](uint64_t Addr) { return translateAddress(Addr); };
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  Shrunk.assign(Fixups.size(), false);
+  if (!Config.ShrinkBranches)
+    return;
+
+  // The first BBL past the entry chain of every function
+  std::vector<unsigned> EntryChainEnds(Funcs.size());
+  for (size_t I = 0, E = Funcs.size(); I != E; ++I) {
+    unsigned B = Funcs[I].FirstBBL, End = B + Funcs[I].NumBBLs;
+    while (B + 1 < End && BBLs[B].FallThrough)
+      ++B;
+    EntryChainEnds[I] = B + 1;
+  }
+
+  for (uint32_t I : Buckets.Shrinkable) {
+    const FixupInfo &F = Fixups[I];
+    if (F.OwnerBBL < 0)
+      continue;
+    const BasicBlock &BBL = BBLs[F.OwnerBBL];
+    const ccr::Function &Func = Funcs[BBL.Function];
+    bool EndsFunction =
+        (unsigned)F.OwnerBBL + 1 == Func.FirstBBL + Func.NumBBLs &&
+        F.Offset + F.DerefSize == BBL.OldOffset + BBL.Size - BBL.Padding;
+    if (Func.Pinned ||
+        !(EndsFunction || (Func.Splittable &&
+                           (unsigned)F.OwnerBBL >= EntryChainEnds[BBL.Function])))
+      continue;
+    if (!relocateTextFixup(F, false, true, OldText.data(), Text->Addr, *L, GOT,
+                           Translate)
+             .Fits)
+      continue;
+    L->shrinkBasicBlock(F.OwnerBBL, F.Offset + F.DerefSize - F.ShrinkLongSize,
+                        F.ShrinkLongSize - F.ShrinkShortSize);
+    ResizedFixups[F.OwnerBBL].push_back(I);
+    Shrunk[I] = true;
+  }
+  if (L->getTotalShrinkage())
+    L->relayout();
+}
+
+// Short branches (rel8) may not reach their targets after shuffling BBLs.
+// Like the assembler relaxation, such a branch is replaced with its long form
+// (recorded in .rand) as long as .text can grow; otherwise the original BBL
+// order of its function is kept. Either step moves code and may push other
+// branches out of range, thus iterate until every branch fits; the layout
+// only grows, hence this terminates.
+//
+// Koo: A growth budget (-max-growth) tightens the slack: past it, the entropy
+// of the BBL shuffling gives way instead, function by function. Hot functions
+// may be kept from growing at all (-no-hot-growth), at the same price.
+//
+// The branches that shrinkBranches() has shrunk and that no longer reach are
+// grown back to the long forms they had, for good; the bytes they take back
+// never count against the budget.
+Error Randomizer::fixBranchRange() {
+  auto Translate = [this](uint64_t Addr) { return translateAddress(Addr); };
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  Relaxed.assign(Fixups.size(), false);
+  shrinkBranches();
+  uint64_t Slack = getTextSlack();
+  if (Config.MaxGrowthPercent >= 0)
+    Slack = std::min<uint64_t>(Slack, (L->getEnd() - L->getBegin()) *
+                                          Config.MaxGrowthPercent / 100);
+  for (;;) {
+    SmallSetVector<unsigned, 8> Restore;
+    bool Grown = false;
+    for (uint32_t I : Buckets.RangeLimited) {
+      const FixupInfo &F = Fixups[I];
+      if (Shrunk[I]) {
+        if (relocateTextFixup(F, false, true, OldText.data(), Text->Addr, *L,
+                              GOT, Translate)
+                .Fits)
+          continue;
+        L->unshrinkBasicBlock(F.OwnerBBL,
+                              F.Offset + F.DerefSize - F.ShrinkLongSize,
+                              F.ShrinkLongSize - F.ShrinkShortSize);
+        auto &Owned = ResizedFixups[F.OwnerBBL];
+        Owned.erase(llvm::find(Owned, I));
+        if (Owned.empty())
+          ResizedFixups.erase(F.OwnerBBL);
+        Shrunk[I] = false;
+        Grown = true;
+        continue;
+      }
+      if (!F.IsRela || F.DerefSize >= 4 || Relaxed[I])
+        continue;
+      TextFixup R = relocateTextFixup(F, false, false, OldText.data(),
+                                      Text->Addr, *L, GOT, Translate);
+      if (R.Fits)
+        continue;
+
+      unsigned Growth = F.RelaxLongSize - F.RelaxShortSize;
+      if (F.isRelaxable() && F.OwnerBBL >= 0 &&
+          L->getTotalGrowth() + Growth <= Slack &&
+          !(Config.NoHotGrowth &&
+            Funcs[BBLs[F.OwnerBBL].Function].Hotness == HOT_Hot)) {
+        L->growBasicBlock(F.OwnerBBL, F.Offset + F.DerefSize - F.RelaxShortSize,
+                          Growth);
+        ResizedFixups[F.OwnerBBL].push_back(I);
+        Relaxed[I] = true;
+        Grown = true;
+        continue;
+      }
+
+      int Src = F.OwnerBBL >= 0 ? F.OwnerBBL : L->findBasicBlock(F.Offset);
+      int Tgt = L->findBasicBlock(R.OldTarget - Text->Addr);
+      if (Src >= 0 && Funcs[BBLs[Src].Function].NumMovedChains)
+        Restore.insert(BBLs[Src].Function);
+      else if (Tgt >= 0 && Funcs[BBLs[Tgt].Function].NumMovedChains)
+        Restore.insert(BBLs[Tgt].Function);
+      else
+        return makeError("The short branch at " +
+                         Twine::utohexstr(Text->Addr + F.Offset) +
+                         " cannot reach its target after shuffling functions");
+    }
+    if (Restore.empty() && !Grown) {
+      // Re-aligning may take more room than there is; then the old padding
+      // is copied along instead, which never grows the layout
+      if (!L->isRealigned() || L->getNewEnd() <= L->getEnd() + Slack)
+        break;
+      if (Config.Verbose)
+        outs() << "Not re-aligning the BBLs: the new padding does not fit\n";
+      L->setRealign(false, Text->Addr);
+      continue;
+    }
+    if (Restore.empty()) {
+      L->relayout();
+      continue;
+    }
+    if (Config.Verbose)
+      outs() << "Restored the BBL order of " << Restore.size()
+             << " function(s) for short branches\n";
+    L->restoreBBLOrder(Restore.getArrayRef());
+  }
+
+  for (auto &Entry : ResizedFixups)
+    llvm::sort(Entry.second, [&](unsigned A, unsigned B) {
+      return Fixups[A].Offset < Fixups[B].Offset;
+    });
+  // The grown .text now covers part of its padding
+  if (L->getNewEnd() > Text->Size && !Config.PlanOnly) {
+    uint8_t *Shdr = Image.data() + Text->HeaderOffset;
+    endian::write64le(Shdr + offsetof(ELF::Elf64_Shdr, sh_size), L->getNewEnd());
+  }
+  unsigned NumRelaxed = L->getStats().NumRelaxedBranches;
+  if (Config.Verbose && NumRelaxed)
+    outs() << "Relaxed " << NumRelaxed << " short branch(es) (+"
+           << L->getTotalGrowth() << " bytes)\n";
+  unsigned NumShrunk = L->getStats().NumShrunkBranches;
+  if (Config.Verbose && NumShrunk)
+    outs() << "Shrunk " << NumShrunk << " long branch(es) (-"
+           << L->getTotalShrinkage() << " bytes)\n";
+  return Error::success();
+}
+
+// Koo: Chains never fall through (see Layout.h), thus no jump is inserted;
+// but a chain that ends in a jump may land right before the target of the
+// jump. The jump then goes: it becomes a NOP of its size, so the dynamic
+// count of instructions stays and the taken branch is saved. So does the
+// jump that a conditional branch to the next BBL skips once the branch is
+// inverted to take the target of the jump instead. The terminators are told
+// by the .text fixups that end the code of a BBL and the opcodes before
+// them; a BBL with a relaxed branch is left alone (a shrunk one is not).
+void Randomizer::straightenBranches() {
+  DroppedJumps.clear();
+  InvertedBranches.clear();
+  if (!Config.StraightenBranches)
+    return;
+  auto Translate = [this](uint64_t Addr) { return translateAddress(Addr); };
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  auto HasRelaxed = [&](unsigned Idx) {
+    auto It = ResizedFixups.find(Idx);
+    return It != ResizedFixups.end() &&
+           any_of(It->second, [&](unsigned FixupIdx) { return Relaxed[FixupIdx]; });
+  };
+  for (uint32_t I : Buckets.Jumps) {
+    const FixupInfo &F = Fixups[I];
+    if (Relaxed[I])
+      continue;
+    int Owner = F.OwnerBBL >= 0 ? F.OwnerBBL : L->findBasicBlock(F.Offset);
+    if (Owner < 0)
+      continue;
+    const BasicBlock &BBL = BBLs[Owner];
+    uint32_t CodeSize = L->getCodeSize(BBL);
+    if (HasRelaxed(Owner) || F.Offset + F.DerefSize != BBL.OldOffset + CodeSize)
+      continue;
+    uint64_t NewEnd = Text->Addr + BBL.NewOffset + CodeSize + BBL.Growth;
+    TextFixup R = relocateTextFixup(F, false, Shrunk[I], OldText.data(),
+                                    Text->Addr, *L, GOT, Translate);
+    if (Translate(R.OldTarget) == NewEnd) {
+      DroppedJumps.push_back(I);
+      continue;
+    }
+
+    // jcc next; jmp target -> jcc' target; nop
+    uint64_t Jump = F.Offset - 1;
+    if (!I || Relaxed[I - 1])
+      continue;
+    const FixupInfo &C = Fixups[I - 1];
+    if (C.Offset + C.DerefSize != Jump || C.Offset < BBL.OldOffset ||
+        getBranchKind(C, OldText.data(), *L) != BK_CondBranch)
+      continue;
+    TextFixup RC = relocateTextFixup(C, false, Shrunk[I - 1], OldText.data(),
+                                     Text->Addr, *L, GOT, Translate);
+    if (Translate(RC.OldTarget) != NewEnd ||
+        !fitsIn(R.NewValue + 1 + R.NewSize, RC.NewSize, /*Signed=*/true))
+      continue;
+    InvertedBranches[I - 1] = I;
+    DroppedJumps.push_back(I);
+  }
+}
+
+// The .text fixups of the code of \p BBL, [first, last) in \p Fixups
+static std::pair<size_t, size_t> getFixupRun(ArrayRef<FixupInfo> Fixups,
+                                             const BasicBlock &BBL) {
+  auto ByOffset = [](const FixupInfo &F, uint64_t Offset) {
+    return F.Offset < Offset;
+  };
+  size_t First = std::lower_bound(Fixups.begin(), Fixups.end(), BBL.OldOffset,
+                                  ByOffset) - Fixups.begin();
+  size_t Last = std::lower_bound(Fixups.begin() + First, Fixups.end(),
+                                 BBL.OldOffset + BBL.Size - BBL.Padding,
+                                 ByOffset) - Fixups.begin();
+  return {First, Last};
+}
+
+// Koo: A jump that straightenBranches() leaves may still go to a tail that
+// ends a path on its own in a few bytes (a ret, a pop and a ret, a tail
+// call): the tail is copied over the jump instead, which saves the taken
+// branch. It has to fit in the bytes of the jump (the rest are NOPs), thus
+// the layout stays as it is; its fixups are cloned from those of its BBL and
+// the PC-relative ones rebased on the copy. Only the tails of the function of
+// the jump are copied, and only in functions without CFI past their entry
+// chains or call-site tables, since neither the CFA rules nor the LSDA cover
+// the copy otherwise. A tail that holds a jump rewritten in turn is left
+// alone.
+void Randomizer::duplicateTails() {
+  DuplicatedTails.clear();
+  if (!Config.TailDupSize)
+    return;
+  auto Translate = [this](uint64_t Addr) { return translateAddress(Addr); };
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  DenseSet<unsigned> WithLSDA, Jumps, Tails;
+  for (const CallSiteTable &T : CallSiteTables)
+    WithLSDA.insert(BBLs[T.EntryBBL].Function);
+  auto Rewritten = [&](size_t I) {
+    return Jumps.count(I) || InvertedBranches.count(I) ||
+           std::binary_search(DroppedJumps.begin(), DroppedJumps.end(), I);
+  };
+  for (uint32_t I : Buckets.Jumps) {
+    const FixupInfo &F = Fixups[I];
+    if (Relaxed[I] || F.OwnerBBL < 0 || Tails.count(F.OwnerBBL) || Rewritten(I))
+      continue;
+    const BasicBlock &BBL = BBLs[F.OwnerBBL];
+    if (!Funcs[BBL.Function].Splittable || WithLSDA.count(BBL.Function) ||
+        F.Offset + F.DerefSize != BBL.OldOffset + BBL.Size - BBL.Padding)
+      continue;
+    TextFixup R = relocateTextFixup(F, false, Shrunk[I], OldText.data(),
+                                    Text->Addr, *L, GOT, Translate);
+    int Tail = L->findBasicBlock(R.OldTarget - Text->Addr);
+    if (Tail < 0 || Tail == F.OwnerBBL)
+      continue;
+    const BasicBlock &T = BBLs[Tail];
+    uint32_t TailSize = T.Size - T.Padding;
+    unsigned JumpSize = Shrunk[I] ? F.ShrinkShortSize : 1 + F.DerefSize;
+    if (T.Function != BBL.Function || T.OldOffset + Text->Addr != R.OldTarget ||
+        T.FallThrough || T.Resized || !TailSize ||
+        TailSize > std::min(JumpSize, Config.TailDupSize))
+      continue;
+
+    // The copy goes where the opcode of the jump goes
+    int64_t Delta = (int64_t)(R.NewOffset - 1) - (int64_t)T.NewOffset;
+    std::pair<size_t, size_t> Run = getFixupRun(Fixups, T);
+    bool Fits = true;
+    for (size_t J = Run.first; J != Run.second && Fits; ++J) {
+      const FixupInfo &TF = Fixups[J];
+      if (Rewritten(J) || TF.RefClass == FRC_TLS) {
+        Fits = false;
+      } else if (TF.IsRela) {
+        TextFixup RT = relocateTextFixup(TF, false, false, OldText.data(),
+                                         Text->Addr, *L, GOT, Translate);
+        Fits = fitsIn(RT.NewValue - Delta, TF.DerefSize, /*Signed=*/true);
+      }
+    }
+    if (!Fits)
+      continue;
+    DuplicatedTails.emplace_back(I, Tail);
+    Jumps.insert(I);
+    Tails.insert(Tail);
+  }
+}
+
+// Once the layout is final, every BBL move and every fixup is independent of
+// the others (each writes to its own location), so they are processed in
+// chunks on the thread pool. Fn returns false on a failure; the index of the
+// first failing element (or N) is returned, thus the error reported does not
+// depend on the scheduling and the output is the same for a given seed.
+size_t Randomizer::forEachIndex(size_t N, function_ref<bool(size_t)> Fn) const {
+  const size_t ChunkSize = 4096;
+  size_t NumChunks = (N + ChunkSize - 1) / ChunkSize;
+  std::vector<size_t> FirstFailure(NumChunks, N);
+  auto RunChunk = [&](size_t Chunk) {
+    TimeTraceScope Scope("Chunk", [&] { return std::to_string(Chunk); });
+    for (size_t I = Chunk * ChunkSize, E = std::min(N, I + ChunkSize); I != E; ++I)
+      if (!Fn(I)) {
+        FirstFailure[Chunk] = I;
+        return;
+      }
+  };
+
+  if (Config.Parallel && NumChunks > 1)
+    parallel::for_each_n(parallel::par, (size_t)0, NumChunks, RunChunk);
+  else
+    for (size_t Chunk = 0; Chunk != NumChunks; ++Chunk)
+      RunChunk(Chunk);
+
+  for (size_t Failure : FirstFailure)
+    if (Failure != N)
+      return Failure;
+  return N;
+}
+
+// Koo: NOPs of random lengths, thus the padding differs between the variants
+// even where no BBL slid within it
+static void writeRandomNops(uint8_t *P, uint64_t Count, RandomStream &RS) {
+  while (Count) {
+    unsigned Length =
+        1 + RS.below(std::min<uint64_t>(Count, X86::DefaultMaxNopLength));
+    ArrayRef<uint8_t> Nop = X86::getNop(Length);
+    memcpy(P, Nop.data(), Length);
+    P += Length;
+    Count -= Length;
+  }
+}
+
+// The padding after the BBL Idx (or before the first one), from a stream of
+// its own so that the BBLs can be moved on any thread
+void Randomizer::writePadding(uint8_t *P, uint64_t Count, unsigned Idx) const {
+  if (!Config.SlidePadding)
+    return X86::writeNops(P, Count);
+  RandomStream RS(Config.Seed, RandomStream::nopStream(Idx));
+  writeRandomNops(P, Count, RS);
+}
+
+// Koo: The code of a run of BBLs that stay together, by its size. The tiny
+//      runs (a BBL of a few instructions) are copied inline rather than by a
+//      call to memcpy; the huge ones go to the image with non-temporal stores,
+//      as they are not read again before the fixups on their pages are patched
+//      and would only evict the code that is still to be copied.
+static const size_t InlineCopySize = 32;
+static const size_t StreamingCopySize = 1 << 20;
+
+static void copyCode(uint8_t *Dest, const uint8_t *Src, size_t Size) {
+  if (Size <= InlineCopySize) {
+    for (; Size >= 8; Size -= 8, Dest += 8, Src += 8)
+      memcpy(Dest, Src, 8);
+    for (; Size; --Size)
+      *Dest++ = *Src++;
+    return;
+  }
+#if defined(__SSE2__)
+  if (Size >= StreamingCopySize) {
+    size_t Head = -reinterpret_cast<uintptr_t>(Dest) & 15;
+    memcpy(Dest, Src, Head);
+    Dest += Head;
+    Src += Head;
+    Size -= Head;
+    for (; Size >= 64; Size -= 64, Dest += 64, Src += 64) {
+      auto *D = reinterpret_cast<__m128i *>(Dest);
+      auto *S = reinterpret_cast<const __m128i *>(Src);
+      __m128i A = _mm_loadu_si128(S), B = _mm_loadu_si128(S + 1);
+      __m128i C = _mm_loadu_si128(S + 2), E = _mm_loadu_si128(S + 3);
+      _mm_stream_si128(D, A);
+      _mm_stream_si128(D + 1, B);
+      _mm_stream_si128(D + 2, C);
+      _mm_stream_si128(D + 3, E);
+    }
+    _mm_sfence();
+  }
+#endif
+  memcpy(Dest, Src, Size);
+}
+
+// Move the BBL Idx, whose old code is at \p Code, to its new offset
+void Randomizer::moveBasicBlock(uint8_t *NewText, unsigned Idx,
+                                const uint8_t *Code) const {
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  const BasicBlock &BBL = L->basicBlocks()[Idx];
+  uint32_t CodeSize = L->getCodeSize(BBL);
+  writePadding(NewText + BBL.NewOffset + CodeSize + BBL.Growth, BBL.NewPadding,
+               Idx);
+  if (!BBL.Resized) {
+    copyCode(NewText + BBL.NewOffset, Code, CodeSize);
+    return;
+  }
+
+  // Copy around the relaxed (shrunk) branches, writing their long (short)
+  // forms instead
+  uint64_t Old = BBL.OldOffset, New = BBL.NewOffset;
+  for (unsigned FixupIdx : ResizedFixups.find(Idx)->second) {
+    const FixupInfo &F = Fixups[FixupIdx];
+    bool Long = Relaxed[FixupIdx];
+    unsigned OldSize = Long ? F.RelaxShortSize : F.ShrinkLongSize;
+    unsigned NewSize = Long ? F.RelaxLongSize : F.ShrinkShortSize;
+    uint64_t Inst = F.Offset + F.DerefSize - OldSize;
+    memcpy(NewText + New, Code + (Old - BBL.OldOffset), Inst - Old);
+    New += Inst - Old;
+    memcpy(NewText + New, Long ? F.RelaxLongForm : F.ShrinkShortForm, NewSize);
+    New += NewSize;
+    Old = Inst + OldSize;
+  }
+  memcpy(NewText + New, Code + (Old - BBL.OldOffset),
+         BBL.OldOffset + CodeSize - Old);
+}
+
+Error Randomizer::moveBasicBlocks() {
+  uint8_t *NewText = getContents(*Text);
+  size_t NumBBLs = L->basicBlocks().size();
+
+  // The padding before the first BBL and after the (shrunk) layout
+  writePadding(NewText + L->getBegin(), L->getLeadingPadding(), NumBBLs);
+  if (L->getNewEnd() < L->getEnd())
+    X86::writeNops(NewText + L->getNewEnd(), L->getEnd() - L->getNewEnd());
+
+  // Koo: The BBLs that keep their distance (e.g., those of a function that
+  //      moves as a whole) are copied as one run, thus a function at function
+  //      granularity costs a copy rather than one per BBL. The padding within
+  //      a run is copied along, then written over like that of any other BBL.
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  std::vector<uint32_t> RunStarts;
+  for (uint32_t I = 0; I != NumBBLs; ++I)
+    if (I == 0 || BBLs[I].Resized || BBLs[I - 1].Resized ||
+        BBLs[I].NewOffset - BBLs[I - 1].NewOffset !=
+            BBLs[I].OldOffset - BBLs[I - 1].OldOffset)
+      RunStarts.push_back(I);
+  RunStarts.push_back(NumBBLs);
+
+  forEachIndex(RunStarts.size() - 1, [&](size_t R) {
+    uint32_t Begin = RunStarts[R], End = RunStarts[R + 1];
+    const BasicBlock &First = BBLs[Begin];
+    if (End - Begin == 1 || First.Resized) {
+      moveBasicBlock(NewText, Begin, OldText.data() + First.OldOffset);
+      return true;
+    }
+    const BasicBlock &Last = BBLs[End - 1];
+    copyCode(NewText + First.NewOffset, OldText.data() + First.OldOffset,
+             Last.OldOffset + L->getCodeSize(Last) - First.OldOffset);
+    for (uint32_t I = Begin; I != End; ++I)
+      writePadding(NewText + BBLs[I].NewOffset + L->getCodeSize(BBLs[I]),
+                   BBLs[I].NewPadding, I);
+    return true;
+  });
+  writeTrampolines(NewText, L->getBegin(), L->getEnd());
+  writeHotRegionSlots(NewText, L->getBegin(), L->getEnd());
+  return Error::success();
+}
+
+// Koo: -permute-in-place. The BBLs move within .text itself rather than from
+//      a copy of it: a BBL moves once no other BBL still has its old code
+//      where it goes (its code, growth and padding). The BBLs that wait for
+//      each other are the cycles of the permutation; one of each is set aside,
+//      which lets the others move one by one until it can move in turn. The
+//      BBLs of an order are mostly set aside one at a time (the largest unit
+//      bounds that bounce buffer), but BBLs of other sizes may overlap several
+//      and the set-aside BBLs are kept until they move. The moves run on one
+//      thread, and the fixups are relocated before the first of them.
+Error Randomizer::permuteBasicBlocks() {
+  uint8_t *NewText = getContents(*Text);
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  uint32_t N = BBLs.size();
+  auto OldEnd = [&](uint32_t I) {
+    return BBLs[I].OldOffset + L->getCodeSize(BBLs[I]);
+  };
+  auto NewEnd = [&](uint32_t I) {
+    const BasicBlock &BBL = BBLs[I];
+    return BBL.NewOffset + L->getCodeSize(BBL) + BBL.Growth + BBL.NewPadding;
+  };
+
+  // The BBLs are in their old order: those whose old code a BBL moves over
+  // follow each other. Waiting counts them; the dependents of a BBL are those
+  // its old code keeps waiting
+  std::vector<uint32_t> Waiting(N), DependentStarts(N + 1), Dependents;
+  auto ForEachOverlap = [&](uint32_t I, function_ref<void(uint32_t)> Fn) {
+    uint64_t Begin = BBLs[I].NewOffset, End = NewEnd(I);
+    auto It = std::upper_bound(BBLs.begin(), BBLs.end(), Begin,
+                               [](uint64_t Offset, const BasicBlock &BBL) {
+                                 return Offset < BBL.OldOffset;
+                               });
+    uint32_t J = It == BBLs.begin() ? 0 : It - BBLs.begin() - 1;
+    for (; J < N && BBLs[J].OldOffset < End; ++J)
+      if (J != I && OldEnd(J) > Begin && OldEnd(J) > BBLs[J].OldOffset)
+        Fn(J);
+  };
+  for (uint32_t I = 0; I != N; ++I)
+    ForEachOverlap(I, [&](uint32_t J) {
+      Waiting[I]++;
+      DependentStarts[J + 1]++;
+    });
+  for (uint32_t J = 0; J != N; ++J)
+    DependentStarts[J + 1] += DependentStarts[J];
+  Dependents.resize(DependentStarts[N]);
+  {
+    std::vector<uint32_t> Next(DependentStarts.begin(),
+                               DependentStarts.end() - 1);
+    for (uint32_t I = 0; I != N; ++I)
+      ForEachOverlap(I, [&](uint32_t J) { Dependents[Next[J]++] = I; });
+  }
+
+  enum : uint8_t { BBL_InPlace, BBL_SetAside, BBL_Moved };
+  std::vector<uint8_t> State(N, BBL_InPlace);
+  std::vector<uint32_t> Ready;
+  for (uint32_t I = 0; I != N; ++I)
+    if (!Waiting[I])
+      Ready.push_back(I);
+  // The old code of J is free: the BBLs that waited for it alone may move
+  auto Release = [&](uint32_t J) {
+    for (uint32_t K = DependentStarts[J]; K != DependentStarts[J + 1]; ++K)
+      if (!--Waiting[Dependents[K]])
+        Ready.push_back(Dependents[K]);
+  };
+
+  DenseMap<uint32_t, std::vector<uint8_t>> Stash;
+  std::vector<uint8_t> Bounce;
+  uint64_t StashBytes = 0;
+  uint32_t NumMoved = 0, Cursor = 0;
+  while (NumMoved != N) {
+    while (!Ready.empty()) {
+      uint32_t I = Ready.back();
+      Ready.pop_back();
+      const BasicBlock &BBL = BBLs[I];
+      if (State[I] == BBL_SetAside) {
+        auto It = Stash.find(I);
+        moveBasicBlock(NewText, I, It->second.data());
+        StashBytes -= It->second.size();
+        Stash.erase(It);
+      } else if (OldEnd(I) > BBL.NewOffset && NewEnd(I) > BBL.OldOffset) {
+        // A BBL that moves over its own old code moves from a copy of it
+        Bounce.assign(OldText.begin() + BBL.OldOffset,
+                      OldText.begin() + OldEnd(I));
+        moveBasicBlock(NewText, I, Bounce.data());
+        Release(I);
+      } else {
+        moveBasicBlock(NewText, I, NewText + BBL.OldOffset);
+        Release(I);
+      }
+      State[I] = BBL_Moved;
+      ++NumMoved;
+    }
+    if (NumMoved == N)
+      break;
+
+    // Every BBL left waits for another: set aside the next one (in the old
+    // order) that some BBL waits for. One that none waits for now never will
+    auto Blocks = [&](uint32_t J) {
+      for (uint32_t K = DependentStarts[J]; K != DependentStarts[J + 1]; ++K)
+        if (State[Dependents[K]] != BBL_Moved)
+          return true;
+      return false;
+    };
+    while (Cursor < N && (State[Cursor] != BBL_InPlace || !Blocks(Cursor)))
+      ++Cursor;
+    if (Cursor == N)
+      return makeError("Cannot permute the BBLs of .text in place");
+    std::vector<uint8_t> &Code = Stash[Cursor];
+    Code.assign(OldText.begin() + BBLs[Cursor].OldOffset,
+                OldText.begin() + OldEnd(Cursor));
+    StashBytes += Code.size();
+    PeakStashBytes = std::max(PeakStashBytes, StashBytes);
+    State[Cursor] = BBL_SetAside;
+    Release(Cursor);
+  }
+
+  // The padding before the first BBL and after the (shrunk) layout, over
+  // what may have been old code
+  writePadding(NewText + L->getBegin(), L->getLeadingPadding(), N);
+  if (L->getNewEnd() < L->getEnd())
+    X86::writeNops(NewText + L->getNewEnd(), L->getEnd() - L->getNewEnd());
+  writeTrampolines(NewText, L->getBegin(), L->getEnd());
+  writeHotRegionSlots(NewText, L->getBegin(), L->getEnd());
+  return Error::success();
+}
+
+// Koo: A lazily materialized .text (see LoadTime.h) keeps the relocated text
+// fixups, bucketed by the page they start on, and the BBLs by their new
+// offsets: the BBLs on some pages are copied over the image, then the fixups
+// of their pages patched. Both are written whole, thus a BBL or a fixup across
+// a page boundary is right on either page.
+namespace llvm {
+namespace ccr {
+struct LazyTextState {
+  static const unsigned PageShift = 12;
+  std::vector<TextFixup> Patches;
+  std::vector<uint32_t> PageStarts, Order; // Of Patches, by page
+  std::vector<uint32_t> ByNewOffset;       // BBL indices
+};
+} // end namespace ccr
+} // end namespace llvm
+
+void Randomizer::materializeText(uint64_t Addr, uint64_t Size, uint8_t *Dest) {
+  // The bytes outside the randomized range are those of the image
+  int64_t FileOffset = (int64_t)Text->Offset + (int64_t)(Addr - Text->Addr);
+  uint64_t Copied = 0;
+  if (FileOffset >= 0 && (uint64_t)FileOffset < Image.size()) {
+    Copied = std::min<uint64_t>(Size, Image.size() - FileOffset);
+    memcpy(Dest, Image.data() + FileOffset, Copied);
+  }
+  memset(Dest + Copied, 0, Size - Copied);
+
+  uint64_t Lo = std::max(Addr, Text->Addr + L->getBegin());
+  uint64_t Hi = std::min(Addr + Size, Text->Addr + L->getEnd());
+  if (Lo >= Hi)
+    return;
+  Lo -= Text->Addr;
+  Hi -= Text->Addr;
+  uint8_t *NewText = getContents(*Text);
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  if (Lo < L->getBegin() + L->getLeadingPadding())
+    writePadding(NewText + L->getBegin(), L->getLeadingPadding(), BBLs.size());
+  if (Hi > L->getNewEnd())
+    X86::writeNops(NewText + L->getNewEnd(), L->getEnd() - L->getNewEnd());
+
+  ArrayRef<uint32_t> ByNewOffset = Lazy->ByNewOffset;
+  auto I = std::upper_bound(ByNewOffset.begin(), ByNewOffset.end(), Lo,
+                            [&](uint64_t Offset, uint32_t Idx) {
+                              return Offset < BBLs[Idx].NewOffset;
+                            });
+  if (I != ByNewOffset.begin())
+    --I;
+  uint64_t PatchBegin = Lo, PatchEnd = Hi;
+  for (; I != ByNewOffset.end() && BBLs[*I].NewOffset < Hi; ++I) {
+    const BasicBlock &BBL = BBLs[*I];
+    moveBasicBlock(NewText, *I, OldText.data() + BBL.OldOffset);
+    PatchBegin = std::min(PatchBegin, BBL.NewOffset);
+    uint64_t End =
+        BBL.NewOffset + L->getCodeSize(BBL) + BBL.Growth + BBL.NewPadding;
+    PatchEnd = std::max(PatchEnd, End);
+  }
+  // Those that start on the pages before are written whole as well
+  writeTrampolines(NewText, Lo - std::min<uint64_t>(Lo, TrampolineSize - 1), Hi);
+  writeHotRegionSlots(
+      NewText, Lo - std::min<uint64_t>(Lo, Layout::HotRegionSlotSize - 1), Hi);
+
+  const unsigned PageShift = LazyTextState::PageShift;
+  size_t NumPages = Lazy->PageStarts.size() - 1;
+  size_t LastPage = std::min<size_t>((PatchEnd - 1) >> PageShift, NumPages - 1);
+  for (size_t Page = PatchBegin >> PageShift; Page <= LastPage; ++Page)
+    for (uint32_t J = Lazy->PageStarts[Page], E = Lazy->PageStarts[Page + 1];
+         J != E; ++J) {
+      const TextFixup &R = Lazy->Patches[Lazy->Order[J]];
+      writeValue(NewText + R.NewOffset, R.NewSize, R.NewValue);
+    }
+  memcpy(Dest + (Text->Addr + Lo - Addr), NewText + Lo, Hi - Lo);
+}
+
+// Koo: The fixups come in the old order of the code, thus their new places
+//      hop across the whole of the new .text. They are relocated in that
+//      order (the old bytes are read sequentially) and written page by page
+//      instead: a counting sort by the destination page groups the fixups of
+//      a size, whose values go in a loop of a kernel of that size, each page
+//      prefetching the next. The 4-byte values (rel32 and abs32) go first.
+static void groupByPage(ArrayRef<TextFixup> Patches, unsigned PageShift,
+                        unsigned Size, std::vector<uint32_t> &PageStarts,
+                        std::vector<uint32_t> &Order) {
+  size_t NumPages = PageStarts.size() - 1;
+  std::fill(PageStarts.begin(), PageStarts.end(), 0);
+  // A fixup left alone (NewSize 0, see patchTextFixups()) goes to no page
+  for (const TextFixup &R : Patches)
+    if (R.NewSize == Size)
+      PageStarts[(R.NewOffset >> PageShift) + 1]++;
+  for (size_t P = 0; P < NumPages; ++P)
+    PageStarts[P + 1] += PageStarts[P];
+  Order.resize(PageStarts[NumPages]);
+  std::vector<uint32_t> Next(PageStarts.begin(), PageStarts.end() - 1);
+  for (size_t I = 0, E = Patches.size(); I != E; ++I)
+    if (Patches[I].NewSize == Size)
+      Order[Next[Patches[I].NewOffset >> PageShift]++] = I;
+}
+
+template <unsigned Size>
+static void writeTextPage(uint8_t *NewText, ArrayRef<TextFixup> Patches,
+                          ArrayRef<uint32_t> Order) {
+  for (uint32_t I : Order)
+    writeFixed<Size>(NewText + Patches[I].NewOffset, Patches[I].NewValue);
+}
+
+namespace {
+struct TextPageKernel {
+  unsigned Size;
+  void (*Write)(uint8_t *, ArrayRef<TextFixup>, ArrayRef<uint32_t>);
+};
+} // end anonymous namespace
+
+static const TextPageKernel TextPageKernels[] = {
+    {4, writeTextPage<4>}, {1, writeTextPage<1>},
+    {8, writeTextPage<8>}, {2, writeTextPage<2>}};
+
+// Whether the BBLs of \p F keep the distances between them, thus its
+// intra-function fixups keep their values: a single BBL moves as a whole unless
+// a branch of it has been relaxed (or shrunk), and several ones only if none
+// moved apart (or was realigned) and no branch anywhere was resized
+bool Randomizer::movedAsWhole(const ccr::Function &F) const {
+  if (F.NumMovedChains || F.SplitCold)
+    return false;
+  if (F.NumBBLs == 1)
+    return !ResizedFixups.count(F.FirstBBL);
+  return !L->isRealigned() && !L->isResized();
+}
+
+// The new values of the .text fixups, by index; those of NewSize 0 are left
+// as they are
+Error Randomizer::relocateTextFixups(std::vector<TextFixup> &Patches) {
+  auto Translate = [this](uint64_t Addr) { return translateAddress(Addr); };
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  ArrayRef<ccr::BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+
+  // The intra-function fixups of the functions that moved as a whole are
+  // carried along with their bytes, unless straightenBranches() rewrites them
+  std::vector<bool> Intact(Funcs.size());
+  for (size_t I = 0, E = Funcs.size(); I != E; ++I)
+    Intact[I] = movedAsWhole(Funcs[I]);
+  DenseSet<unsigned> Straightened;
+  Straightened.insert(DroppedJumps.begin(), DroppedJumps.end());
+  for (const auto &Entry : DuplicatedTails)
+    Straightened.insert(Entry.first);
+  for (const auto &Entry : InvertedBranches) {
+    Straightened.insert(Entry.first);
+    Straightened.insert(Entry.second);
+  }
+
+  // Koo: With object units, the objects whose BBLs all moved by one distance
+  //      (see Layout::setObjectUnits()) carry their PC-relative intra-object
+  //      fixups along as well; only the fixups across objects are relocated
+  std::vector<bool> IntactObjects;
+  if (Config.ObjectGranularity) {
+    ArrayRef<ObjectRange> Objs = L->objects();
+    IntactObjects.assign(Objs.size(), false);
+    NumIntactObjects = 0;
+    for (size_t I = 0, E = Objs.size(); I != E; ++I) {
+      if (!Objs[I].NumFunctions)
+        continue;
+      const ccr::Function &Last =
+          Funcs[Objs[I].FirstFunction + Objs[I].NumFunctions - 1];
+      unsigned First = Funcs[Objs[I].FirstFunction].FirstBBL;
+      uint64_t Distance = BBLs[First].NewOffset - BBLs[First].OldOffset;
+      bool Moved = true;
+      for (unsigned J = First, JE = Last.FirstBBL + Last.NumBBLs;
+           Moved && J != JE; ++J)
+        Moved = !BBLs[J].Resized &&
+                BBLs[J].NewOffset - BBLs[J].OldOffset == Distance;
+      IntactObjects[I] = Moved;
+      NumIntactObjects += Moved;
+    }
+  }
+
+  Patches.resize(Fixups.size());
+  size_t Failure = forEachIndex(Fixups.size(), [&](size_t I) {
+    const FixupInfo &F = Fixups[I];
+    if (F.OwnerBBL >= 0 && !Relaxed[I] && !Shrunk[I] &&
+        !Straightened.count(I) &&
+        ((F.Scope == FS_IntraFunction && Intact[BBLs[F.OwnerBBL].Function]) ||
+         (F.Scope != FS_External && F.IsRela && !IntactObjects.empty() &&
+          IntactObjects[Funcs[BBLs[F.OwnerBBL].Function].Object]))) {
+      Patches[I] = TextFixup{0, 0, 0, /*NewSize=*/0, /*Fits=*/true};
+      return true;
+    }
+    Patches[I] = relocateTextFixup(F, Relaxed[I], Shrunk[I], OldText.data(),
+                                   Text->Addr, *L, GOT, Translate);
+    return Patches[I].Fits;
+  });
+  if (Failure != Fixups.size())
+    return makeError("The fixup at " +
+                     Twine::utohexstr(Text->Addr + Fixups[Failure].Offset) +
+                     " overflows after randomization");
+  return Error::success();
+}
+
+Error Randomizer::patchTextFixups() {
+  uint8_t *NewText = getContents(*Text);
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  ArrayRef<ccr::BasicBlock> BBLs = L->basicBlocks();
+  std::vector<TextFixup> Patches;
+  if (Config.PermuteInPlace)
+    Patches = std::move(TextPatches);
+  else if (Error E = relocateTextFixups(Patches))
+    return E;
+  if (Config.LazyText) {
+    // materializeText() patches the pages it is asked for
+    const unsigned PageShift = LazyTextState::PageShift;
+    Lazy->PageStarts.assign((Text->Size >> PageShift) + 2, 0);
+    for (const TextFixup &R : Patches)
+      if (R.NewSize)
+        Lazy->PageStarts[(R.NewOffset >> PageShift) + 1]++;
+    for (size_t P = 0, E = Lazy->PageStarts.size() - 1; P < E; ++P)
+      Lazy->PageStarts[P + 1] += Lazy->PageStarts[P];
+    Lazy->Order.resize(Lazy->PageStarts.back());
+    std::vector<uint32_t> Next(Lazy->PageStarts.begin(),
+                               Lazy->PageStarts.end() - 1);
+    for (size_t I = 0, E = Patches.size(); I != E; ++I)
+      if (Patches[I].NewSize)
+        Lazy->Order[Next[Patches[I].NewOffset >> PageShift]++] = I;
+    Lazy->Patches = std::move(Patches);
+    return Error::success();
+  }
+  uint64_t MaxOffset = 0;
+  for (const TextFixup &R : Patches)
+    MaxOffset = std::max(MaxOffset, R.NewOffset);
+
+  const unsigned PageShift = 12;
+  std::vector<uint32_t> PageStarts((MaxOffset >> PageShift) + 2), Order;
+  for (const TextPageKernel &K : TextPageKernels) {
+    groupByPage(Patches, PageShift, K.Size, PageStarts, Order);
+    if (Order.empty())
+      continue;
+    size_t NumPages = PageStarts.size() - 1;
+    forEachIndex(NumPages, [&](size_t Page) {
+      uint32_t Begin = PageStarts[Page], End = PageStarts[Page + 1];
+      if (End != Order.size())
+        LLVM_PREFETCH(NewText + Patches[Order[End]].NewOffset, 1, 3);
+      K.Write(NewText, Patches, makeArrayRef(Order).slice(Begin, End - Begin));
+      return true;
+    });
+  }
+
+  // The straightened branches (see straightenBranches()): the conditional
+  // branch takes the target of the jump, which becomes a NOP
+  for (const auto &Entry : InvertedBranches) {
+    const TextFixup &R = Patches[Entry.first], &Jump = Patches[Entry.second];
+    NewText[R.NewOffset - 1] ^= 1;
+    writeValue(NewText + R.NewOffset, R.NewSize,
+               Jump.NewValue + 1 + Jump.NewSize);
+  }
+  for (unsigned FixupIdx : DroppedJumps) {
+    const TextFixup &R = Patches[FixupIdx];
+    X86::writeNops(NewText + R.NewOffset - 1, 1 + R.NewSize);
+  }
+
+  // The duplicated tails (see duplicateTails()) are copied once patched
+  for (const auto &Entry : DuplicatedTails) {
+    const TextFixup &Jump = Patches[Entry.first];
+    const BasicBlock &T = BBLs[Entry.second];
+    uint64_t Site = Jump.NewOffset - 1;
+    uint32_t TailSize = T.Size - T.Padding;
+    memcpy(NewText + Site, NewText + T.NewOffset, TailSize);
+    X86::writeNops(NewText + Site + TailSize, 1 + Jump.NewSize - TailSize);
+    std::pair<size_t, size_t> Run = getFixupRun(Fixups, T);
+    for (size_t J = Run.first; J != Run.second; ++J) {
+      const FixupInfo &TF = Fixups[J];
+      if (!TF.IsRela)
+        continue;
+      uint8_t *P = NewText + Site + (TF.Offset - T.OldOffset);
+      writeValue(P, TF.DerefSize,
+                 readValue(P, TF.DerefSize, /*Signed=*/true) -
+                     (int64_t)(Site - T.NewOffset));
+    }
+  }
+  return Error::success();
+}
+
+// Relative jump table entries (.LBBx - .LJTIx, pic/pie) are resolved by the
+// assembler, thus the .text fixup that refers to the table carries them.
+// Function-relative entries (.LBBx - .LJTBx) only change if the BBLs moved
+// within their function.
+Error Randomizer::patchJumpTables() {
+  ArrayRef<ccr::BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  bool Intact = !L->isRealigned() && !L->isResized();
+  for (const FixupInfo &F : Info.Fixups[FK_Text]) {
+    if (F.NumJTEntries == 0 || F.JTEntrySize != 4)
+      continue;
+    uint64_t EntryBase = 0;
+    if (F.JTFunctionRelative) {
+      if (F.OwnerBBL < 0)
+        return makeError("The jump table of the fixup at " +
+                         Twine::utohexstr(Text->Addr + F.Offset) +
+                         " has no function");
+      const ccr::Function &Func = Funcs[BBLs[F.OwnerBBL].Function];
+      if (Intact && !Func.NumMovedChains)
+        continue;
+      EntryBase = Text->Addr + BBLs[Func.FirstBBL].OldOffset;
+    }
+
+    const uint8_t *P = OldText.data() + F.Offset;
+    uint64_t Base = F.IsRela ? Text->Addr + F.Offset + F.DerefSize +
+                                   readValue(P, F.DerefSize, /*Signed=*/true)
+                             : readValue(P, F.DerefSize, /*Signed=*/false);
+
+    const Section *JTSec = nullptr;
+    for (const Section &Sec : Sections)
+      if ((Sec.Flags & ELF::SHF_ALLOC) && Sec.Type != ELF::SHT_NOBITS &&
+          Base >= Sec.Addr && Base + (uint64_t)F.NumJTEntries * 4 <= Sec.Addr + Sec.Size)
+        JTSec = &Sec;
+    if (!JTSec)
+      return makeError("Cannot locate the jump table at " + Twine::utohexstr(Base));
+
+    uint8_t *Entries = getContents(*JTSec) + (Base - JTSec->Addr);
+    uint64_t OldBase = F.JTFunctionRelative ? EntryBase : Base;
+    uint64_t NewBase = F.JTFunctionRelative ? translateAddress(EntryBase) : Base;
+    for (unsigned I = 0; I < F.NumJTEntries; ++I) {
+      // A jump table may be shared by several fixups; patch it only once
+      if (!JumpTableEntries.insert(Base + I * 4).second)
+        continue;
+      int64_t Entry = (int32_t)endian::read32le(Entries + I * 4);
+      int64_t NewEntry = (int64_t)(translateAddress(OldBase + Entry) - NewBase);
+      if (!fitsIn(NewEntry, 4, /*Signed=*/true))
+        return makeError("The jump table entry at " + Twine::utohexstr(Base + I * 4) +
+                         " overflows after randomization");
+      endian::write32le(Entries + I * 4, NewEntry);
+    }
+  }
+  return Error::success();
+}
+
+Error Randomizer::patchDataFixups() {
+  InPlaceAddends = isPIC() && any_of(Sections, [](const Section &Sec) {
+    return Sec.Type == ELF::SHT_RELR || Sec.Type == ELF::SHT_ANDROID_RELR ||
+           (Sec.Type == ELF::SHT_REL && (Sec.Flags & ELF::SHF_ALLOC));
+  });
+  for (unsigned K = FK_Rodata; K < FK_Custom; ++K) {
+    if (Info.Fixups[K].empty())
+      continue;
+    StringRef SecName = getFixupKindSectionName(FixupKind(K));
+    const Section *Sec = findSection(SecName);
+    if (!Sec || Sec->Type == ELF::SHT_NOBITS)
+      return makeError("No " + SecName + " section for " +
+                       Twine(Info.Fixups[K].size()) + " fixups");
+    if (Error E = patchFixupsIn(*Sec, Info.Fixups[K]))
+      return E;
+  }
+  return patchCustomFixups();
+}
+
+// The output section of an input section of -ccr-fixup-section is the one of
+// its name or else, as the linker groups .foo.* into .foo, the longest .foo
+const Section *Randomizer::findOutputSection(StringRef InputName) const {
+  if (const Section *Sec = findSection(InputName))
+    return Sec;
+  const Section *Found = nullptr;
+  for (const Section &Sec : Sections)
+    if (!Sec.Name.empty() && (Sec.Flags & ELF::SHF_ALLOC) &&
+        InputName.startswith(Sec.Name + ".") &&
+        (!Found || Sec.Name.size() > Found->Name.size()))
+      Found = &Sec;
+  return Found;
+}
+
+Error Randomizer::patchCustomFixups() {
+  MapVector<const Section *, std::vector<FixupInfo>> ByOutputSection;
+  DenseMap<uint32_t, const Section *> OutputSections; // By SectionIdx
+  for (const FixupInfo &F : Info.Fixups[FK_Custom]) {
+    if (F.SectionIdx >= Info.SectionNames.size())
+      return makeError("A custom fixup refers to a non-existing section");
+    const Section *&Sec = OutputSections[F.SectionIdx];
+    if (!Sec) {
+      StringRef InputName = Info.SectionNames[F.SectionIdx];
+      Sec = findOutputSection(InputName);
+      if (!Sec || Sec->Type == ELF::SHT_NOBITS)
+        return makeError("No output section for the fixups of " + InputName);
+    }
+    ByOutputSection[Sec].push_back(F);
+  }
+  for (const auto &P : ByOutputSection)
+    if (Error E = patchFixupsIn(*P.first, P.second))
+      return E;
+  return Error::success();
+}
+
+// Koo: How the value of a data fixup refers to its target, which (with its
+//      size) tells the kernel that patches it (see patchFixupsIn())
+enum FixupRelativity : uint8_t {
+  FRL_Absolute,
+  FRL_PCRelative,
+  FRL_GOTRelative, // foo@GOTOFF: the target less the GOT base
+  NumFixupRelativities
+};
+
+namespace {
+struct DataFixupContext {
+  uint8_t *Contents;
+  uint64_t SectionAddr;
+  uint64_t GOTBase;
+  function_ref<uint64_t(uint64_t)> Translate;
+  const DataGroups *Data; // With Config.ShuffleData: the place moves too
+};
+} // end anonymous namespace
+
+template <unsigned Size, FixupRelativity Rel>
+static bool patchDataFixup(const DataFixupContext &C, uint64_t Offset) {
+  uint8_t *P = C.Contents + Offset;
+  int64_t NewValue;
+  if (Rel == FRL_GOTRelative) {
+    uint64_t Target = C.GOTBase + readFixed<Size, /*Signed=*/true>(P);
+    NewValue = (int64_t)(C.Translate(Target) - C.GOTBase);
+  } else if (Rel == FRL_PCRelative) {
+    int64_t V = readFixed<Size, /*Signed=*/true>(P);
+    uint64_t Place = C.SectionAddr + Offset;
+    uint64_t Target = Place + V;
+    NewValue = V + (int64_t)(C.Translate(Target) - Target);
+    if (C.Data)
+      NewValue -= (int64_t)(C.Data->translate(Place) - Place);
+  } else {
+    NewValue = C.Translate(readFixed<Size, /*Signed=*/false>(P));
+  }
+  if (!fitsFixed<Size, /*Signed=*/Rel != FRL_Absolute>(NewValue))
+    return false;
+  writeFixed<Size>(P, NewValue);
+  return true;
+}
+
+using DataFixupKernel = bool (*)(const DataFixupContext &, uint64_t);
+
+// By shape: log2 of the size, then the relativity
+static const DataFixupKernel DataFixupKernels[] = {
+    patchDataFixup<1, FRL_Absolute>, patchDataFixup<1, FRL_PCRelative>,
+    patchDataFixup<1, FRL_GOTRelative>,
+    patchDataFixup<2, FRL_Absolute>, patchDataFixup<2, FRL_PCRelative>,
+    patchDataFixup<2, FRL_GOTRelative>,
+    patchDataFixup<4, FRL_Absolute>, patchDataFixup<4, FRL_PCRelative>,
+    patchDataFixup<4, FRL_GOTRelative>,
+    patchDataFixup<8, FRL_Absolute>, patchDataFixup<8, FRL_PCRelative>,
+    patchDataFixup<8, FRL_GOTRelative>};
+static const unsigned NumDataFixupShapes = array_lengthof(DataFixupKernels);
+
+// Koo: The fixups are bucketed by their shape first, thus each bucket goes
+//      through a kernel that reads, translates and writes its values without
+//      testing what its fixups are
+Error Randomizer::patchFixupsIn(const Section &Sec, ArrayRef<FixupInfo> Fixups) {
+  for (const FixupInfo &F : Fixups)
+    if (F.DerefSize == 0 || F.DerefSize > 8 || !isPowerOf2_32(F.DerefSize) ||
+        F.Offset + F.DerefSize > Sec.Size)
+      return makeError("Invalid fixup at " + Sec.Name + "+" +
+                       Twine::utohexstr(F.Offset));
+
+  // JumpTableEntries is only read from here on. A d2d fixup (only with
+  // -ccr-keep-data-fixups) never changes unless the data objects move, and
+  // neither does a TP/DTP offset nor a jump table entry (see
+  // patchJumpTables()), thus they take no shape.
+  std::vector<uint8_t> Shapes(Fixups.size());
+  forEachIndex(Fixups.size(), [&](size_t I) {
+    const FixupInfo &F = Fixups[I];
+    if ((F.Target == FT_Data && !DG) || F.RefClass == FRC_TLS ||
+        (!JumpTableEntries.empty() && JumpTableEntries.count(Sec.Addr + F.Offset))) {
+      Shapes[I] = NumDataFixupShapes;
+      return true;
+    }
+    FixupRelativity Rel = F.RefClass == FRC_GOT && !F.IsRela && GOT.Base
+                              ? FRL_GOTRelative
+                              : F.IsRela ? FRL_PCRelative : FRL_Absolute;
+    Shapes[I] = Log2_32(F.DerefSize) * NumFixupRelativities + Rel;
+    return true;
+  });
+
+  // Their words are translated once
+  if (InPlaceAddends)
+    for (size_t I = 0, E = Fixups.size(); I != E; ++I)
+      if (Shapes[I] == Log2_32(8) * NumFixupRelativities + FRL_Absolute)
+        PatchedWords.insert(Sec.Addr + Fixups[I].Offset);
+
+  // A counting sort by the shape keeps the old order within each bucket
+  uint32_t Starts[NumDataFixupShapes + 2] = {};
+  for (uint8_t Shape : Shapes)
+    Starts[Shape + 1]++;
+  for (unsigned S = 0; S <= NumDataFixupShapes; ++S)
+    Starts[S + 1] += Starts[S];
+  std::vector<uint32_t> Order(Fixups.size());
+  uint32_t Next[NumDataFixupShapes + 1];
+  std::copy(Starts, Starts + NumDataFixupShapes + 1, Next);
+  for (size_t I = 0, E = Fixups.size(); I != E; ++I)
+    Order[Next[Shapes[I]]++] = I;
+
+  auto Translate = [this](uint64_t Addr) { return translateInbound(Addr); };
+  DataFixupContext C{getContents(Sec), Sec.Addr, GOT.Base, Translate,
+                     DG.get()};
+  for (unsigned S = 0; S < NumDataFixupShapes; ++S) {
+    ArrayRef<uint32_t> Bucket =
+        makeArrayRef(Order).slice(Starts[S], Starts[S + 1] - Starts[S]);
+    DataFixupKernel Kernel = DataFixupKernels[S];
+    size_t Failure = forEachIndex(Bucket.size(), [&](size_t I) {
+      return Kernel(C, Fixups[Bucket[I]].Offset);
+    });
+    if (Failure != Bucket.size())
+      return makeError("The fixup at " +
+                       Twine::utohexstr(Sec.Addr + Fixups[Bucket[Failure]].Offset) +
+                       " overflows after randomization");
+  }
+  return Error::success();
+}
+
+// The word at \p Addr, which a RELR (or REL) relocation adds the load address
+// to, unless a data fixup has translated it already
+Error Randomizer::patchRelocatedWord(uint64_t Addr) {
+  if (PatchedWords.count(Addr))
+    return Error::success();
+  uint64_t TextBegin = Text->Addr + L->getBegin();
+  if (Addr >= TextBegin && Addr < Text->Addr + L->getEnd())
+    return makeError("A relative relocation at " + Twine::utohexstr(Addr) +
+                     " relocates a word of the randomized .text in place");
+  for (const Section &Sec : Sections) {
+    if (!(Sec.Flags & ELF::SHF_ALLOC) || Sec.Type == ELF::SHT_NOBITS ||
+        Addr < Sec.Addr || Addr + 8 > Sec.Addr + Sec.Size)
+      continue;
+    uint8_t *P = getContents(Sec) + (Addr - Sec.Addr);
+    endian::write64le(P, translateInbound(endian::read64le(P)));
+    return Error::success();
+  }
+  return makeError("A relative relocation at " + Twine::utohexstr(Addr) +
+                   " is outside the sections of the binary");
+}
+
+// Koo: R_X86_64_RELATIVE/IRELATIVE of .rela.dyn carry the (code) address in
+// their addends; those of REL and the RELR tables (-z pack-relative-relocs)
+// in the words they relocate, thus a RELR bitmap stays as it is. A relocation
+// in .text moves with its code, thus the relative ones that -z combreloc put
+// first in the order of their offsets are sorted again if need be. The place
+// of any relocation in a moved data object moves along (-shuffle-data);
+// without PIC, that is all there is to patch.
+Error Randomizer::patchDynamicRelocations() {
+  for (const Section &Sec : Sections) {
+    if (Sec.Type == ELF::SHT_ANDROID_RELA || Sec.Type == ELF::SHT_ANDROID_REL)
+      return makeError(Sec.Name + " holds packed relocations, which cannot be "
+                       "rewritten in place; pack them into RELR instead");
+    if (Sec.Type == ELF::SHT_RELR || Sec.Type == ELF::SHT_ANDROID_RELR) {
+      if (Error E = forEachRelrWord(
+              makeArrayRef(getContents(Sec), Sec.Size),
+              [this](uint64_t Addr) { return patchRelocatedWord(Addr); }))
+        return E;
+      continue;
+    }
+
+    bool IsRela = Sec.Type == ELF::SHT_RELA;
+    if ((!IsRela && Sec.Type != ELF::SHT_REL) || !(Sec.Flags & ELF::SHF_ALLOC))
+      continue;
+    size_t EntSize = IsRela ? sizeof(ELF::Elf64_Rela) : sizeof(ELF::Elf64_Rel);
+    uint8_t *Contents = getContents(Sec);
+    size_t NumRelative = 0; // The leading run of R_X86_64_RELATIVE
+    bool Sorted = true;
+    uint64_t PrevOffset = 0;
+    for (uint64_t Off = 0; Off + EntSize <= Sec.Size; Off += EntSize) {
+      uint8_t *Rel = Contents + Off;
+      uint32_t Type = endian::read64le(Rel + 8) & 0xffffffff;
+      uint64_t OldOffset = endian::read64le(Rel);
+      if (!isPIC() ||
+          (Type != ELF::R_X86_64_RELATIVE && Type != ELF::R_X86_64_IRELATIVE)) {
+        if (DG)
+          endian::write64le(Rel, DG->translate(OldOffset));
+        continue;
+      }
+      uint64_t Offset = translateAddress(OldOffset);
+      endian::write64le(Rel, Offset);
+      // The word is patched at its old place, before the data moves
+      if (IsRela)
+        endian::write64le(Rel + 16,
+                          translateInbound(endian::read64le(Rel + 16)));
+      else if (Error E = patchRelocatedWord(OldOffset))
+        return E;
+      if (Type == ELF::R_X86_64_RELATIVE && NumRelative * EntSize == Off) {
+        Sorted &= !NumRelative || PrevOffset <= Offset;
+        PrevOffset = Offset;
+        ++NumRelative;
+      }
+    }
+    if (Sorted)
+      continue;
+    std::vector<std::array<uint64_t, 3>> Entries(NumRelative);
+    for (size_t I = 0; I != NumRelative; ++I)
+      for (size_t W = 0; W != EntSize / 8; ++W)
+        Entries[I][W] = endian::read64le(Contents + I * EntSize + W * 8);
+    llvm::sort(Entries, [](const std::array<uint64_t, 3> &A,
+                           const std::array<uint64_t, 3> &B) {
+      return A[0] < B[0];
+    });
+    for (size_t I = 0; I != NumRelative; ++I)
+      for (size_t W = 0; W != EntSize / 8; ++W)
+        endian::write64le(Contents + I * EntSize + W * 8, Entries[I][W]);
+  }
+  return Error::success();
+}
+
+// Koo: The symbols are patched in place in one pass over each table, on the
+// thread pool: the order of the entries stays, thus neither .gnu.hash (which
+// only hashes the names, by the index of the entries) nor the relocations
+// that refer to symbols by index need to be rebuilt. A function symbol that
+// covered its whole function takes the new size of the function, i.e., of its
+// hot part if the function is split.
+void Randomizer::patchSymbols() {
+  uint8_t *Entry = Image.data() + offsetof(ELF::Elf64_Ehdr, e_entry);
+  endian::write64le(Entry, translateInbound(endian::read64le(Entry)));
+
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  ArrayRef<uint64_t> Trampolines = L->trampolines();
+  auto PatchSymbol = [&](uint8_t *Sym, bool Dynamic) {
+    uint8_t Type = Sym[4] & 0xf;
+    uint16_t Shndx = endian::read16le(Sym + 6);
+    if (Type == ELF::STT_SECTION || Type == ELF::STT_FILE)
+      return;
+    // A data object moves with its group (-shuffle-data)
+    if (DG && any_of(DataSections, [&](const Section *Sec) {
+          return Sec->Index == Shndx;
+        })) {
+      endian::write64le(Sym + 8, DG->translate(endian::read64le(Sym + 8)));
+      return;
+    }
+    if (Shndx != Text->Index)
+      return;
+    uint64_t Value = endian::read64le(Sym + 8);
+    if (Value < Text->Addr)
+      return;
+    // An exported entry keeps its address (and size) with a trampoline
+    if (Dynamic && std::binary_search(Trampolines.begin(), Trampolines.end(),
+                                      Value - Text->Addr))
+      return;
+    // The callers through .dynsym take the slot of a hot-region function
+    if (Dynamic)
+      if (Optional<uint64_t> Slot = L->getHotRegionSlot(Value - Text->Addr)) {
+        endian::write64le(Sym + 8, Text->Addr + *Slot);
+        return;
+      }
+    int Idx = L->findBasicBlock(Value - Text->Addr);
+    if (Idx < 0)
+      return;
+    endian::write64le(Sym + 8, Text->Addr + L->translateWithin(
+                                                Idx, Value - Text->Addr));
+    if (Type != ELF::STT_FUNC)
+      return;
+    const BasicBlock &BBL = BBLs[Idx];
+    const ccr::Function &F = Funcs[BBL.Function];
+    if ((unsigned)Idx != F.FirstBBL || Value - Text->Addr != BBL.OldOffset)
+      return;
+    const BasicBlock &Last = BBLs[F.FirstBBL + F.NumBBLs - 1];
+    if (endian::read64le(Sym + 16) != Last.OldOffset + Last.Size - BBL.OldOffset)
+      return;
+    std::pair<uint64_t, uint64_t> Range = L->getNewRange(BBL.Function, false);
+    endian::write64le(Sym + 16, Range.second - Range.first);
+  };
+
+  for (const Section &Sec : Sections) {
+    if (Sec.Type != ELF::SHT_SYMTAB && Sec.Type != ELF::SHT_DYNSYM)
+      continue;
+    uint8_t *Contents = getContents(Sec);
+    forEachIndex(Sec.Size / sizeof(ELF::Elf64_Sym), [&](size_t I) {
+      PatchSymbol(Contents + I * sizeof(ELF::Elf64_Sym),
+                  Sec.Type == ELF::SHT_DYNSYM);
+      return true;
+    });
+  }
+}
+
+// Skip an encoded pointer in the augmentation data of a CIE
+static unsigned getEncodedSize(uint8_t Encoding) {
+  switch (Encoding & 0x0f) {
+  case dwarf::DW_EH_PE_absptr: return 8;
+  case dwarf::DW_EH_PE_udata2:
+  case dwarf::DW_EH_PE_sdata2: return 2;
+  case dwarf::DW_EH_PE_udata4:
+  case dwarf::DW_EH_PE_sdata4: return 4;
+  case dwarf::DW_EH_PE_udata8:
+  case dwarf::DW_EH_PE_sdata8: return 8;
+  default: return 0;
+  }
+}
+
+// Koo: The compiler describes the call-site tables of the LSDAs it emitted
+// (-ccr-eh-info) with udata4 fields, thus a table is rewritten in place. The
+// records are relative to the start of the function, i.e., its entry chain,
+// which stays first.
+Error Randomizer::readCallSiteTables() {
+  if (Info.CallSiteTables.empty())
+    return Error::success();
+  LSDA = findSection(".gcc_except_table");
+  if (!LSDA || LSDA->Type == ELF::SHT_NOBITS)
+    return makeError("The call-site tables in .rand have no .gcc_except_table");
+
+  const uint8_t *Contents = getContents(*LSDA);
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  for (const CallSiteTableInfo &T : Info.CallSiteTables) {
+    int Entry = L->findBasicBlock(T.FunctionOffset);
+    if (Entry < 0)
+      continue;
+    if (Funcs[BBLs[Entry].Function].FirstBBL != (unsigned)Entry)
+      return makeError("The call-site table at .gcc_except_table+" +
+                       Twine::utohexstr(T.TableOffset) +
+                       " does not start at a function");
+
+    CallSiteTable Table;
+    Table.EntryBBL = Entry;
+    Table.FunctionOffset = T.FunctionOffset;
+    Table.Offset = T.TableOffset;
+    uint64_t Off = T.TableOffset;
+    for (uint32_t I = 0; I < T.NumRecords; ++I) {
+      if (Off + 13 > LSDA->Size)
+        return makeError("Truncated call-site table at .gcc_except_table+" +
+                         Twine::utohexstr(T.TableOffset));
+      CallSiteRecord R;
+      R.Start = endian::read32le(Contents + Off);
+      R.Length = endian::read32le(Contents + Off + 4);
+      R.LandingPad = endian::read32le(Contents + Off + 8);
+      unsigned N;
+      const char *Err = nullptr;
+      decodeULEB128(Contents + Off + 12, &N, Contents + LSDA->Size, &Err);
+      if (Err)
+        return makeError("Malformed call-site record at .gcc_except_table+" +
+                         Twine::utohexstr(Off) + ": " + Err);
+      R.Size = 12 + N;
+      Off += R.Size;
+      Table.Records.push_back(R);
+    }
+    CallSiteTables.push_back(std::move(Table));
+  }
+  return Error::success();
+}
+
+// A call-site range may cover a fall-through chain, whose BBLs stay in order
+// but may be re-aligned apart; any other BBL in between would be attributed
+// to the range. Such a function keeps its original BBL order.
+void Randomizer::keepCallSitesTogether() {
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  SmallSetVector<unsigned, 8> Restore;
+  for (const CallSiteTable &Table : CallSiteTables) {
+    for (const CallSiteRecord &R : Table.Records) {
+      if (!R.Length)
+        continue;
+      int First = L->findBasicBlock(Table.FunctionOffset + R.Start);
+      int Last = L->findBasicBlock(Table.FunctionOffset + R.Start + R.Length - 1);
+      if (First < 0 || Last < 0)
+        continue;
+      for (int I = First + 1; I <= Last; ++I) {
+        const BasicBlock &Prev = BBLs[I - 1];
+        if (BBLs[I].NewOffset != Prev.NewOffset + L->getCodeSize(Prev) +
+                                     Prev.Growth + Prev.NewPadding) {
+          Restore.insert(BBLs[Table.EntryBBL].Function);
+          break;
+        }
+      }
+    }
+  }
+  if (Restore.empty())
+    return;
+  if (Config.Verbose)
+    outs() << "Restored the BBL order of " << Restore.size()
+           << " function(s) for call-site ranges\n";
+  L->restoreBBLOrder(Restore.getArrayRef());
+}
+
+Error Randomizer::patchCallSiteTables() {
+  if (CallSiteTables.empty())
+    return Error::success();
+  uint8_t *Contents = getContents(*LSDA);
+  std::vector<uint8_t> Old;
+  for (const CallSiteTable &Table : CallSiteTables) {
+    uint64_t NewFunc = L->translateWithin(Table.EntryBBL, Table.FunctionOffset);
+    uint64_t Size = 0;
+    std::vector<std::pair<CallSiteRecord, uint64_t>> Records;
+    for (const CallSiteRecord &R : Table.Records) {
+      CallSiteRecord New = R;
+      uint64_t Begin = Table.FunctionOffset + R.Start;
+      New.Start = L->translate(Begin) - NewFunc;
+      if (R.Length)
+        New.Length = L->translate(Begin + R.Length - 1) + 1 - L->translate(Begin);
+      if (R.LandingPad)
+        New.LandingPad =
+            L->translate(Table.FunctionOffset + R.LandingPad) - NewFunc;
+      Records.push_back({New, Size});
+      Size += R.Size;
+    }
+    // The personality routine scans the records in order of their start
+    std::stable_sort(Records.begin(), Records.end(),
+                     [](const std::pair<CallSiteRecord, uint64_t> &A,
+                        const std::pair<CallSiteRecord, uint64_t> &B) {
+                       return A.first.Start < B.first.Start;
+                     });
+
+    Old.assign(Contents + Table.Offset, Contents + Table.Offset + Size);
+    uint8_t *P = Contents + Table.Offset;
+    for (const auto &Entry : Records) {
+      const CallSiteRecord &R = Entry.first;
+      endian::write32le(P, R.Start);
+      endian::write32le(P + 4, R.Length);
+      endian::write32le(P + 8, R.LandingPad);
+      memcpy(P + 12, Old.data() + Entry.second + 12, R.Size - 12);
+      P += R.Size;
+    }
+  }
+  if (Config.Verbose)
+    outs() << "Rewrote " << CallSiteTables.size() << " call-site table(s)\n";
+  return Error::success();
+}
+
+// The new extent of the code at [Begin, Begin + Size) of the old layout: a
+// function moves as a whole, but it grows by its relaxed branches and its
+// padding changes when re-aligning
+uint64_t Randomizer::translateRange(uint64_t Begin, uint64_t Size) const {
+  int First = L->findBasicBlock(Begin);
+  if (First < 0 || !Size)
+    return Size;
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  uint64_t NewBegin = L->translateWithin(First, Begin);
+  uint64_t NewEnd = NewBegin + Size;
+  uint64_t End = Begin + Size;
+  for (size_t I = First, E = BBLs.size(); I != E && BBLs[I].OldOffset < End;
+       ++I) {
+    const BasicBlock &BBL = BBLs[I];
+    // The cold part of a split function has an FDE of its own (see EHFrame.cpp)
+    if (BBL.ColdPart)
+      continue;
+    uint64_t CodeEnd = BBL.OldOffset + L->getCodeSize(BBL);
+    uint64_t Last = std::min(End, CodeEnd);
+    if (Last <= std::max(Begin, BBL.OldOffset))
+      continue;
+    uint64_t New = Last == CodeEnd
+                       ? BBL.NewOffset + L->getCodeSize(BBL) + BBL.Growth
+                       : L->translateWithin(I, Last - 1) + 1;
+    if (I == (size_t)First)
+      NewEnd = New;
+    else
+      NewEnd = std::max(NewEnd, New);
+  }
+  return NewEnd - NewBegin;
+}
+
+// Sort the binary search table of .eh_frame_hdr (pairs of the datarel
+// initial location and FDE address) by the new locations
+void Randomizer::sortSearchTable(
+    std::vector<std::pair<int32_t, int32_t>> &Table) const {
+  if (Config.Parallel)
+    parallel::sort(parallel::par, Table.begin(), Table.end());
+  else
+    llvm::sort(Table);
+}
+
+// Move the pc_begin of every FDE along with its function and fit its
+// pc_range to the new size, then regenerate the sorted binary search table
+// of .eh_frame_hdr from the FDEs; _Unwind_Find_FDE() falls back to a linear
+// scan of .eh_frame on a table it cannot trust. The CFI programs themselves
+// are not rewritten; they describe whole functions, which stay contiguous,
+// and a function with CFI outside its entry chain keeps its BBL order (see
+// the Layout).
+Error Randomizer::patchEHFrame() {
+  const Section *EHFrame = findSection(".eh_frame");
+  if (!EHFrame || EHFrame->Type == ELF::SHT_NOBITS)
+    return Error::success();
+
+  uint8_t *Contents = getContents(*EHFrame);
+  DenseMap<uint64_t, uint8_t> CIEEncodings;
+  // The new initial location of every FDE by its address, and the FDEs
+  // with code (in .eh_frame order)
+  DenseMap<uint64_t, uint64_t> NewBegins;
+  std::vector<std::pair<uint64_t, uint64_t>> FDEs;
+  uint64_t Off = 0;
+  while (Off + 8 <= EHFrame->Size) {
+    uint32_t Length = endian::read32le(Contents + Off);
+    if (Length == 0)
+      break;
+    if (Length == 0xffffffff || Off + 4 + Length > EHFrame->Size)
+      return makeError("Unsupported .eh_frame record at offset " + Twine::utohexstr(Off));
+    uint64_t End = Off + 4 + Length;
+    uint32_t ID = endian::read32le(Contents + Off + 4);
+
+    if (ID == 0) {
+      // CIE: version, augmentation, code/data alignment, return register
+      const uint8_t *P = Contents + Off + 8;
+      uint8_t Version = *P++;
+      const char *Aug = reinterpret_cast<const char *>(P);
+      P += strlen(Aug) + 1;
+      unsigned N;
+      decodeULEB128(P, &N); P += N;
+      decodeSLEB128(P, &N); P += N;
+      if (Version == 1)
+        P++;
+      else {
+        decodeULEB128(P, &N); P += N;
+      }
+      uint8_t FDEEncoding = dwarf::DW_EH_PE_absptr;
+      if (Aug[0] == 'z') {
+        decodeULEB128(P, &N); P += N;
+        for (const char *C = Aug + 1; *C; ++C) {
+          if (*C == 'R')
+            FDEEncoding = *P++;
+          else if (*C == 'L')
+            P++;
+          else if (*C == 'P') {
+            uint8_t Enc = *P++;
+            P += getEncodedSize(Enc);
+          }
+        }
+      }
+      CIEEncodings[Off] = FDEEncoding;
+    } else {
+      uint64_t CIEOff = Off + 4 - ID;
+      auto It = CIEEncodings.find(CIEOff);
+      if (It == CIEEncodings.end())
+        return makeError("FDE at .eh_frame+" + Twine::utohexstr(Off) + " without CIE");
+      uint8_t Enc = It->second;
+      uint8_t *P = Contents + Off + 8;
+      uint64_t PCAddr = EHFrame->Addr + Off + 8;
+      unsigned Size = getEncodedSize(Enc);
+      if (Size != 4 && Size != 8)
+        return makeError("Unsupported FDE pointer encoding " + Twine::utohexstr(Enc));
+
+      bool Signed = (Enc & 0x0f) == dwarf::DW_EH_PE_sdata4 ||
+                    (Enc & 0x0f) == dwarf::DW_EH_PE_sdata8;
+      int64_t V = readValue(P, Size, Signed);
+      uint64_t Begin;
+      switch (Enc & 0x70) {
+      case dwarf::DW_EH_PE_absptr:
+        Begin = V;
+        writeValue(P, Size, translateAddress(V));
+        break;
+      case dwarf::DW_EH_PE_pcrel:
+        Begin = PCAddr + V;
+        writeValue(P, Size, (int64_t)(translateAddress(PCAddr + V) - PCAddr));
+        break;
+      default:
+        return makeError("Unsupported FDE pointer encoding " + Twine::utohexstr(Enc));
+      }
+      // pc_range has the same size, but is never relative
+      if (Off + 8 + 2 * Size > End)
+        return makeError("Truncated FDE at .eh_frame+" + Twine::utohexstr(Off));
+      uint64_t Range = readValue(P + Size, Size, false);
+      if (Begin >= Text->Addr && L->contains(Begin - Text->Addr))
+        writeValue(P + Size, Size, translateRange(Begin - Text->Addr, Range));
+      NewBegins[EHFrame->Addr + Off] = translateAddress(Begin);
+      // The linker leaves the FDEs of discarded code out of the table
+      if (Range)
+        FDEs.push_back({EHFrame->Addr + Off, translateAddress(Begin)});
+    }
+    Off = End;
+  }
+
+  // .eh_frame_hdr: version, eh_frame_ptr_enc, fde_count_enc, table_enc
+  const Section *Hdr = findSection(".eh_frame_hdr");
+  if (!Hdr || Hdr->Type == ELF::SHT_NOBITS || Hdr->Size < 12)
+    return Error::success();
+  uint8_t *H = getContents(*Hdr);
+  uint8_t PtrEnc = H[1], CountEnc = H[2], TableEnc = H[3];
+  if (CountEnc != dwarf::DW_EH_PE_udata4 ||
+      TableEnc != (dwarf::DW_EH_PE_datarel | dwarf::DW_EH_PE_sdata4) ||
+      getEncodedSize(PtrEnc) != 4) {
+    WithColor::warning() << "unsupported .eh_frame_hdr encoding; table not updated\n";
+    return Error::success();
+  }
+  uint32_t Count = endian::read32le(H + 8);
+  if (12 + (uint64_t)Count * 8 > Hdr->Size)
+    return makeError("Malformed .eh_frame_hdr");
+
+  // The table indexes every FDE with code, unless the linker left some out:
+  // then its own entries are moved instead
+  std::vector<std::pair<int32_t, int32_t>> Table(Count);
+  bool Regenerate = FDEs.size() == Count;
+  forEachIndex(Count, [&](size_t I) {
+    if (Regenerate) {
+      Table[I] = {(int32_t)(FDEs[I].second - Hdr->Addr),
+                  (int32_t)(FDEs[I].first - Hdr->Addr)};
+      return true;
+    }
+    int32_t Loc = endian::read32le(H + 12 + I * 8);
+    Table[I].first = (int32_t)(translateAddress(Hdr->Addr + Loc) - Hdr->Addr);
+    Table[I].second = endian::read32le(H + 12 + I * 8 + 4);
+    return true;
+  });
+  sortSearchTable(Table);
+
+  // Verified against the FDEs before it is written: sorted, and every entry
+  // names an FDE at its initial location
+  size_t Bad = forEachIndex(Count, [&](size_t I) {
+    auto It = NewBegins.find(Hdr->Addr + Table[I].second);
+    return It != NewBegins.end() &&
+           (int32_t)(It->second - Hdr->Addr) == Table[I].first &&
+           (!I || Table[I - 1].first <= Table[I].first);
+  });
+  if (Bad != Count)
+    return makeError("The .eh_frame_hdr entry #" + Twine(Bad) + " (FDE at " +
+                     Twine::utohexstr(Hdr->Addr + Table[Bad].second) +
+                     ") does not match the FDEs");
+  forEachIndex(Count, [&](size_t I) {
+    endian::write32le(H + 12 + I * 8, Table[I].first);
+    endian::write32le(H + 12 + I * 8 + 4, Table[I].second);
+    return true;
+  });
+  return Error::success();
+}
+
+// Leave out the stale padding, lay the code out and settle its branches; the
+// layout is final once it returns
+Error Randomizer::planLayout() {
+  uint8_t *TextContents = getContents(*Text);
+  if (Config.PermuteInPlace || Config.PlanOnly) {
+    OldText = makeArrayRef(TextContents, Text->Size);
+  } else {
+    OldTextCopy.assign(TextContents, TextContents + Text->Size);
+    OldText = OldTextCopy;
+  }
+
+  uint64_t Offset = Info.RandObjOffset;
+  for (BasicBlockInfo &BBL : Info.BasicBlocks) {
+    if (BBL.PaddingSize &&
+        !isNopPadding(makeArrayRef(OldText.data() + Offset + BBL.Size -
+                                       BBL.PaddingSize, BBL.PaddingSize)))
+      BBL.PaddingSize = 0;
+    Offset += BBL.Size;
+  }
+
+  bool Optimize = !Config.Profile.empty() && !Config.ClusterCalls;
+  L = llvm::make_unique<ccr::Layout>(Info, Config.ShuffleBBLs || Optimize,
+                                     Config.HotColdBuckets,
+                                     Config.PlacementChains);
+  bucketFixups(); // By the last instructions of the BBLs as well
+  L->setEpoch(Config.Epoch, Config.RefreshPercent);
+  L->setSectionClasses(Config.SectionClasses);
+  L->setObjectUnits(Config.ObjectGranularity);
+  if (Config.StableOrder && Info.FunctionIDs.empty())
+    return makeError("A stable layout needs the identities of the functions, "
+                     "which .rand records as of format 2");
+  L->setStableOrder(Config.StableOrder);
+  L->setShuffleWindow(Config.ShuffleWindow);
+  if (Config.EntryTrampolines)
+    if (Error E = planTrampolines())
+      return E;
+  if (Config.StartupLayout)
+    markStartupFunctions();
+  if (Config.HugePageSize)
+    L->setHugePages(Config.HugePageSize, Text->Addr);
+  if (Config.HotRegion) {
+    // The worst case of a region is known whatever its seed: every short
+    // branch of its functions relaxed
+    if (Config.SplitFunctions || Config.EntryTrampolines || Config.PaddingOnly ||
+        Optimize || !Config.HotColdBuckets)
+      return makeError("The hot regions take the functions as whole units of "
+                       "the hot bucket (no -split-functions, "
+                       "-entry-trampolines, -padding-only or profile layout)");
+    ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+    std::vector<uint32_t> MaxGrowth(L->functions().size());
+    for (const FixupInfo &F : Info.Fixups[FK_Text])
+      if (F.RelaxShortSize && F.OwnerBBL >= 0)
+        MaxGrowth[BBLs[F.OwnerBBL].Function] +=
+            F.RelaxLongSize - F.RelaxShortSize;
+    L->setHotRegion(Config.HotRegionSeed, Config.HotRegionBudget,
+                    std::move(MaxGrowth));
+  }
+  if (!Config.Profile.empty())
+    setLayoutProfile();
+  else if (Config.ClusterCalls)
+    buildCallGraph();
+  if (Config.SplitFunctions)
+    if (Error E = readEHRecords())
+      return E;
+  // The padding slides alone keep every BBL in its old order
+  if (Optimize)
+    L->optimize(Config.Parallel);
+  else if (!Config.PaddingOnly)
+    L->shuffle(Config.Seed, Config.BBLShufflePercent, Config.Parallel);
+  if (Config.SlidePadding)
+    L->setPaddingSlides(Config.Seed);
+  L->setPackCold(Config.PackCold);
+  if (Config.Realign)
+    L->setRealign(true, Text->Addr);
+  if (Config.SplitFunctions)
+    planColdFDEs();
+
+  if (Error E = readCallSiteTables())
+    return E;
+  keepCallSitesTogether();
+
+  if (Error E = fixBranchRange())
+    return E;
+  if (L->hasHotRegionOverflow())
+    return makeError("A hot region outgrew its reserve");
+  if (Config.EntryTrampolines &&
+      L->getNewEnd() > L->getEnd() + getTextSlack())
+    return makeError("The units moved past the entry trampolines (" +
+                     Twine(L->getStats().TrampolineGapBytes) +
+                     " bytes) do not fit in the padding after .text");
+  // Both rewrite bytes of one page by the patched ones of another, which a
+  // lazily materialized .text does not have
+  // The copy of a tail keeps the branches of its function, which would put
+  // what the seed of a hot region picked outside of it
+  if (!Config.LazyText) {
+    straightenBranches();
+    if (!Config.HotRegion)
+      duplicateTails();
+  }
+  return Error::success();
+}
+
+// The byte count a phase of -time-trace reports
+static std::string getBytesDetail(uint64_t Bytes) {
+  return std::to_string(Bytes) + " bytes";
+}
+
+Error Randomizer::run() {
+  {
+    TimeTraceScope Scope("Parse", [&] { return getBytesDetail(Image.size()); });
+    if (Error E = readSections())
+      return E;
+    if (Error E = loadRandInfo())
+      return E;
+  }
+  {
+    TimeTraceScope Scope("Plan", [&] {
+      return std::to_string(Info.BasicBlocks.size()) + " BBLs";
+    });
+    if (Error E = planLayout())
+      return E;
+    if (Config.ShuffleData)
+      if (Error E = planDataGroups())
+        return E;
+  }
+  // The layout is final: what it costs is known before anything is rewritten
+  if (!Config.StatsPath.empty()) {
+    std::error_code EC;
+    raw_fd_ostream OS(Config.StatsPath, EC, sys::fs::OF_Text);
+    if (EC)
+      return createFileError(Config.StatsPath, EC);
+    writeStats(OS);
+  }
+  // Koo: A layout is a function of the .rand section, the options and the
+  //      seed (the streams of RandomStream.h are drawn alike on any thread),
+  //      thus the map of a host is planned again from its seed, in the time
+  //      of the planning alone, rather than kept
+  if (Config.PlanOnly)
+    return Error::success();
+  {
+    TimeTraceScope Scope("Copy", [&] {
+      return getBytesDetail(L->getNewEnd() - L->getBegin());
+    });
+    if (Config.LazyText) {
+      Lazy = llvm::make_unique<LazyTextState>();
+      ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+      Lazy->ByNewOffset.resize(BBLs.size());
+      std::iota(Lazy->ByNewOffset.begin(), Lazy->ByNewOffset.end(), 0);
+      llvm::sort(Lazy->ByNewOffset, [&](uint32_t A, uint32_t B) {
+        return BBLs[A].NewOffset < BBLs[B].NewOffset;
+      });
+    } else if (Config.PermuteInPlace) {
+      // What reads the old code does so before it is moved over
+      if (Error E = relocateTextFixups(TextPatches))
+        return E;
+      if (Error E = patchJumpTables())
+        return E;
+      if (Error E = permuteBasicBlocks())
+        return E;
+    } else if (Error E = moveBasicBlocks()) {
+      return E;
+    }
+  }
+  {
+    TimeTraceScope Scope("Patch", [&] {
+      uint64_t Bytes = 0;
+      for (unsigned K = 0; K < NumFixupKinds; ++K)
+        for (const FixupInfo &F : Info.Fixups[K])
+          Bytes += F.DerefSize;
+      return getBytesDetail(Bytes);
+    });
+    if (Error E = patchTextFixups())
+      return E;
+    if (!Config.PermuteInPlace)
+      if (Error E = patchJumpTables())
+        return E;
+    if (Error E = patchDataFixups())
+      return E;
+    if (isPIC() || DG)
+      if (Error E = patchDynamicRelocations())
+        return E;
+    patchSymbols();
+    if (DG)
+      moveDataGroups();
+  }
+  {
+    TimeTraceScope Scope("EH", [&] {
+      uint64_t Bytes = 0;
+      for (StringRef Name : {".eh_frame", ".eh_frame_hdr", ".gcc_except_table"})
+        if (const Section *Sec = findSection(Name))
+          Bytes += Sec->Size;
+      return getBytesDetail(Bytes);
+    });
+    if (Error E = patchEHFrame())
+      return E;
+    if (Error E = writeColdFDEs())
+      return E;
+    if (Error E = patchCallSiteTables())
+      return E;
+  }
+  writeLayoutNote();
+  writeHotPagesNote();
+
+  if (Config.Verbose) {
+    bool Optimize = !Config.Profile.empty() && !Config.ClusterCalls;
+    outs() << (Optimize ? "Optimized " : "Randomized ")
+           << L->functions().size() << " functions ("
+           << L->basicBlocks().size() << " BBLs) in "
+           << format_hex(Text->Addr + L->getBegin(), 10) << " - "
+           << format_hex(Text->Addr + L->getEnd(), 10) << "\n";
+    for (unsigned K = 0; K < NumFixupKinds; ++K)
+      outs() << "  " << getFixupKindSectionName(FixupKind(K)) << " fixups: "
+             << Info.Fixups[K].size() << "\n";
+
+    const LayoutStats &Stats = L->getStats();
+    outs() << "  Units permuted: " << Stats.NumUnits << " (" << Stats.NumHotUnits
+           << " hot, " << Stats.NumColdUnits << " cold, "
+           << Stats.NumPinnedFunctions << " functions pinned, "
+           << Stats.NumSegments << " segments)\n";
+    if (Config.StartupLayout)
+      outs() << "  Startup units: " << Stats.NumStartupUnits << "\n";
+    if (Config.HotRegion)
+      outs() << "  Hot-region functions: " << Stats.NumHotRegionFunctions
+             << " (" << L->hotRegions().size() << " regions, "
+             << Stats.HotRegionBytes << " bytes reserved)\n";
+    if (NumForeignObjects)
+      outs() << "  Inputs without .rand kept in place: " << NumForeignObjects
+             << " (" << NumForeignFixups << " fixups from relocations)\n";
+    if (DG) {
+      const DataGroupStats &DS = DG->getStats();
+      outs() << "  Data groups: " << DS.NumGroups << " of " << DS.NumObjects
+             << " objects (" << DS.NumPinnedGroups << " pinned, "
+             << DS.NumAffinityGroups << " by affinity, " << DS.MovedBytes
+             << " bytes moved)\n";
+    }
+    if (NumRelaxedGOTRefs)
+      outs() << "  GOT references relaxed by the linker: " << NumRelaxedGOTRefs
+             << "\n";
+    outs()
+           << "  Fall-through chains: " << Stats.NumChains << " (BBLs shuffled in "
+           << Stats.NumShuffledFunctions - Stats.NumRestoredFunctions
+           << " functions, " << Stats.NumRestoredFunctions
+           << " restored for short branches)\n"
+           << "  Inserted jumps: " << Stats.NumInsertedJumps << "\n"
+           << "  Dropped jumps: " << DroppedJumps.size() << " ("
+           << InvertedBranches.size() << " branches inverted)\n"
+           << "  Duplicated tails: " << DuplicatedTails.size() << "\n"
+           << "  Re-aligned BBLs: " << Stats.NumAlignedBBLs << " ("
+           << Stats.NumAlignedLoopHeaders << " loop headers)\n"
+           << "  Slid BBLs: " << Stats.NumSlidBBLs << " (" << Stats.SlideBytes
+           << " bytes of padding)\n";
+    if (Config.ObjectGranularity)
+      outs() << "  Objects moved as they were: " << NumIntactObjects << "\n";
+    if (Config.PackCold)
+      outs() << "  Packed cold BBLs: " << Stats.NumPackedBBLs << " ("
+             << Stats.PackedBytes << " bytes of padding left out)\n";
+    if (Stats.NumBoundaryPadded)
+      outs() << "  Re-padded boundaries: " << Stats.NumBoundaryPadded << " ("
+             << Stats.BoundaryPadBytes << " bytes)\n";
+    if (Config.PermuteInPlace)
+      outs() << "  Set aside in place: at most " << PeakStashBytes
+             << " bytes\n";
+    if (Config.EntryTrampolines)
+      outs() << "  Entry trampolines: " << Stats.NumTrampolines << " ("
+             << Stats.TrampolineGapBytes << " bytes skipped for them)\n";
+    if (Config.StableOrder)
+      outs() << "  Units placed by index (no identity): "
+             << Stats.NumUnstableUnits << "\n";
+    if (NumHotPageRanges)
+      outs() << "  Hot pages to read ahead: " << NumHotPages << " in "
+             << NumHotPageRanges << " range(s)\n";
+    outs() << "  Entropy: " << format("%.1f", Stats.EntropyBits) << " bits\n";
+    if (Config.ShuffleWindow)
+      outs() << "  Shuffle windows: " << Stats.NumShuffleWindows << " (of up to "
+             << Config.ShuffleWindow << " bytes)\n";
+    if (Config.HugePageSize) {
+      outs() << "  Hot huge pages: " << Stats.NumHotHugePages << " (at least "
+             << Stats.MinHotHugePages << ")\n";
+      // The pages are file-backed by huge ones only where the mapping keeps
+      // the file offsets congruent
+      if ((Text->Addr - Text->Offset) % Config.HugePageSize)
+        outs() << "  .text is not mapped at a huge page boundary of its file "
+                  "offset; link with -z max-page-size="
+               << Config.HugePageSize << "\n";
+    }
+    int64_t Growth = (int64_t)L->getNewEnd() - (int64_t)L->getEnd();
+    uint64_t RangeSize = std::max<uint64_t>(1, L->getEnd() - L->getBegin());
+    outs() << "  Code growth: " << Growth << " bytes ("
+           << format("%.2f", 100.0 * Growth / RangeSize) << "%)\n";
+    if (Stats.OldHotSpan)
+      outs() << "  Hot span: " << Stats.OldHotSpan << " -> "
+             << Stats.NewHotSpan << " bytes\n";
+    if (Config.SplitFunctions)
+      outs() << "  Split functions: " << Stats.NumSplitFunctions << " ("
+             << Stats.ColdPartBytes << " cold bytes)\n";
+    if (Config.Epoch)
+      outs() << "  Epoch " << Config.Epoch << ": " << Stats.NumRefreshedUnits
+             << " units moved\n";
+    if (L->hasProfile() || L->hasCallGraph())
+      outs() << "  Clustered units: " << Stats.NumClusteredUnits << "\n";
+    if (L->hasProfile())
+      outs() << "  Ext-TSP score: " << format("%.0f", L->getExtTSPScore(false))
+             << " -> " << format("%.0f", L->getExtTSPScore(true)) << "\n";
+  }
+  return Error::success();
+}
+
+// Koo: What the layout bought (entropy) and cost (growth, jumps, the spread of
+// the hot code), for the tooling that tunes the trade-off
+void Randomizer::writeStats(raw_ostream &OS) const {
+  const LayoutStats &Stats = L->getStats();
+  uint64_t RangeSize = L->getEnd() - L->getBegin();
+  int64_t Growth = (int64_t)L->getNewEnd() - (int64_t)L->getEnd();
+  json::OStream J(OS, 2);
+  J.object([&] {
+    J.attribute("seed", int64_t(Config.Seed));
+    J.attribute("functions", int64_t(L->functions().size()));
+    J.attribute("bbls", int64_t(L->basicBlocks().size()));
+    J.attribute("range_size", int64_t(RangeSize));
+    J.attribute("units", int64_t(Stats.NumUnits));
+    J.attribute("hot_units", int64_t(Stats.NumHotUnits));
+    J.attribute("cold_units", int64_t(Stats.NumColdUnits));
+    if (Config.StartupLayout)
+      J.attribute("startup_units", int64_t(Stats.NumStartupUnits));
+    if (Config.HotRegion) {
+      J.attribute("hot_region_functions", int64_t(Stats.NumHotRegionFunctions));
+      J.attribute("hot_region_bytes", int64_t(Stats.HotRegionBytes));
+    }
+    J.attribute("pinned_functions", int64_t(Stats.NumPinnedFunctions));
+    J.attribute("segments", int64_t(Stats.NumSegments));
+    J.attribute("chains", int64_t(Stats.NumChains));
+    J.attribute("shuffled_functions",
+                int64_t(Stats.NumShuffledFunctions - Stats.NumRestoredFunctions));
+    J.attribute("restored_functions", int64_t(Stats.NumRestoredFunctions));
+    J.attribute("entropy_bits", Stats.EntropyBits);
+    J.attribute("inserted_jumps", int64_t(Stats.NumInsertedJumps));
+    J.attribute("dropped_jumps", int64_t(DroppedJumps.size()));
+    J.attribute("inverted_branches", int64_t(InvertedBranches.size()));
+    J.attribute("duplicated_tails", int64_t(DuplicatedTails.size()));
+    J.attribute("relaxed_branches", int64_t(Stats.NumRelaxedBranches));
+    J.attribute("relaxation_bytes", int64_t(L->getTotalGrowth()));
+    J.attribute("shrunk_branches", int64_t(Stats.NumShrunkBranches));
+    J.attribute("shrink_bytes", int64_t(L->getTotalShrinkage()));
+    J.attribute("realigned_bbls", int64_t(Stats.NumAlignedBBLs));
+    J.attribute("slid_bbls", int64_t(Stats.NumSlidBBLs));
+    J.attribute("slide_bytes", int64_t(Stats.SlideBytes));
+    if (Config.PackCold) {
+      J.attribute("packed_bbls", int64_t(Stats.NumPackedBBLs));
+      J.attribute("packed_bytes", int64_t(Stats.PackedBytes));
+    }
+    J.attribute("boundary_padded", int64_t(Stats.NumBoundaryPadded));
+    J.attribute("boundary_pad_bytes", int64_t(Stats.BoundaryPadBytes));
+    if (Config.EntryTrampolines) {
+      J.attribute("entry_trampolines", int64_t(Stats.NumTrampolines));
+      J.attribute("trampoline_gap_bytes", int64_t(Stats.TrampolineGapBytes));
+    }
+    if (Config.StableOrder)
+      J.attribute("unstable_units", int64_t(Stats.NumUnstableUnits));
+    if (Config.ShuffleWindow) {
+      J.attribute("shuffle_window", int64_t(Config.ShuffleWindow));
+      J.attribute("shuffle_windows", int64_t(Stats.NumShuffleWindows));
+    }
+    J.attribute("growth_bytes", Growth);
+    J.attribute("growth_percent", RangeSize ? 100.0 * Growth / RangeSize : 0.0);
+    // Without a profile there is no hot code to tell
+    if (Stats.OldHotSpan) {
+      J.attribute("old_hot_span", int64_t(Stats.OldHotSpan));
+      J.attribute("new_hot_span", int64_t(Stats.NewHotSpan));
+    }
+    if (Config.SplitFunctions) {
+      J.attribute("split_functions", int64_t(Stats.NumSplitFunctions));
+      J.attribute("cold_part_bytes", int64_t(Stats.ColdPartBytes));
+    }
+    if (L->hasProfile() || L->hasCallGraph())
+      J.attribute("clustered_units", int64_t(Stats.NumClusteredUnits));
+    if (L->hasProfile()) {
+      J.attribute("ext_tsp_score_old", L->getExtTSPScore(false));
+      J.attribute("ext_tsp_score_new", L->getExtTSPScore(true));
+    }
+    if (Config.HugePageSize) {
+      J.attribute("hot_huge_pages", int64_t(Stats.NumHotHugePages));
+      J.attribute("min_hot_huge_pages", int64_t(Stats.MinHotHugePages));
+    }
+    if (DG) {
+      const DataGroupStats &DS = DG->getStats();
+      J.attribute("data_objects", int64_t(DS.NumObjects));
+      J.attribute("data_groups", int64_t(DS.NumGroups));
+      J.attribute("pinned_data_groups", int64_t(DS.NumPinnedGroups));
+      J.attribute("affinity_data_groups", int64_t(DS.NumAffinityGroups));
+      J.attribute("moved_data_bytes", int64_t(DS.MovedBytes));
+    }
+  });
+  OS << "\n";
+}
+
+// Koo: A BBL moves as a whole but for its relaxed and shrunk branches: the
+// bytes after each one shift by its growth (or the bytes it saved); the long
+// form beyond the short size has no original address of its own, and the old
+// bytes of a shrunk branch beyond its short form no new one
+std::vector<object::RandAddressRange> Randomizer::getAddressRanges() const {
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  std::vector<object::RandAddressRange> Ranges;
+  Ranges.reserve(L->basicBlocks().size());
+  for (size_t I = 0, E = L->basicBlocks().size(); I != E; ++I) {
+    const BasicBlock &BBL = L->basicBlocks()[I];
+    uint64_t Old = BBL.OldOffset, New = BBL.NewOffset;
+    uint64_t End = BBL.OldOffset + L->getCodeSize(BBL);
+    if (BBL.Resized) {
+      for (unsigned FixupIdx : ResizedFixups.find(I)->second) {
+        const FixupInfo &F = Fixups[FixupIdx];
+        uint64_t InstEnd = F.Offset + F.DerefSize;
+        if (Relaxed[FixupIdx]) {
+          Ranges.push_back({Text->Addr + Old, Text->Addr + New, InstEnd - Old});
+          New += InstEnd - Old + F.RelaxLongSize - F.RelaxShortSize;
+        } else {
+          uint64_t ShortEnd = InstEnd - F.ShrinkLongSize + F.ShrinkShortSize;
+          Ranges.push_back({Text->Addr + Old, Text->Addr + New, ShortEnd - Old});
+          New += ShortEnd - Old;
+        }
+        Old = InstEnd;
+      }
+    }
+    Ranges.push_back({Text->Addr + Old, Text->Addr + New, End - Old});
+  }
+  return Ranges;
+}
+
+// The descriptor of the first allocated "CCR" note of \p Type that has at
+// least \p MinSize bytes, its size and its link-time address; null if none
+uint8_t *Randomizer::findNote(uint32_t Type, uint64_t MinSize,
+                              uint64_t &DescSize, uint64_t &DescAddr) {
+  for (const Section &Sec : Sections) {
+    if (Sec.Type != ELF::SHT_NOTE || !(Sec.Flags & ELF::SHF_ALLOC))
+      continue;
+    uint8_t *Contents = getContents(Sec);
+    for (uint64_t Off = 0; Off + sizeof(ELF::Elf64_Nhdr) <= Sec.Size;) {
+      const auto *Note = reinterpret_cast<const ELF::Elf64_Nhdr *>(Contents + Off);
+      uint64_t Name = Off + sizeof(ELF::Elf64_Nhdr);
+      uint64_t Desc = Name + alignTo(Note->n_namesz, 4);
+      uint64_t End = Desc + alignTo(Note->n_descsz, 4);
+      if (End > Sec.Size)
+        break;
+      Off = End;
+      if (Note->n_type != Type || Note->n_namesz != 4 ||
+          memcmp(Contents + Name, "CCR", 4) || Note->n_descsz < MinSize)
+        continue;
+      DescSize = Note->n_descsz;
+      DescAddr = Sec.Addr + Desc;
+      return Contents + Desc;
+    }
+  }
+  return nullptr;
+}
+
+// Koo: The note that the layout runtime reserves (see CCRLayout.h) takes the
+// map of the ranges by their new addresses, if it has the room: otherwise
+// its signature stays clear and the runtime translates nothing.
+void Randomizer::writeLayoutNote() {
+  uint64_t DescSize, DescAddr;
+  uint8_t *Desc = findNote(ccr::NT_CCR_LAYOUT, sizeof(ccr::LayoutNoteHeader),
+                           DescSize, DescAddr);
+  if (!Desc)
+    return;
+  auto &H = *reinterpret_cast<ccr::LayoutNoteHeader *>(Desc);
+  auto *Out = reinterpret_cast<ccr::LayoutNoteRange *>(&H + 1);
+  H.Signature = 0;
+  uint64_t Capacity =
+      std::min<uint64_t>(H.Capacity, (DescSize - sizeof(H)) / sizeof(*Out));
+  std::vector<object::RandAddressRange> Ranges =
+      object::mergeRandAddressRanges(getAddressRanges());
+  if (Ranges.size() > Capacity) {
+    WithColor::warning() << "the layout note holds " << Capacity << " of the "
+                         << Ranges.size()
+                         << " moved ranges; in-process translation is off\n";
+    return;
+  }
+  llvm::sort(Ranges, [](const object::RandAddressRange &A,
+                        const object::RandAddressRange &B) {
+    return A.NewAddr < B.NewAddr;
+  });
+  for (size_t I = 0; I < Ranges.size(); ++I) {
+    Out[I].NewOffset = Ranges[I].NewAddr - Text->Addr;
+    Out[I].OldOffset = Ranges[I].OldAddr - Text->Addr;
+    Out[I].Size = Ranges[I].Size;
+  }
+  H.Version = ccr::LayoutNoteHeader::CurrentVersion;
+  H.NumRanges = Ranges.size();
+  H.NoteAddr = DescAddr;
+  H.TextAddr = Text->Addr;
+  H.Signature = ccr::LayoutNoteHeader::MagicSignature;
+}
+
+// Koo: The hot pages note (see CCRLayout.h) takes the pages of the hot parts
+// of the hot and startup functions (see Layout::isHotFunction()) at their new
+// places. Beyond its capacity the ranges closest to each other are merged, as
+// reading a few cold pages ahead costs less than faulting the hot ones in.
+void Randomizer::writeHotPagesNote() {
+  const uint64_t PageSize = 4096;
+  uint64_t DescSize, DescAddr;
+  uint8_t *Desc = findNote(ccr::NT_CCR_HOT_PAGES,
+                           sizeof(ccr::HotPagesNoteHeader), DescSize, DescAddr);
+  if (!Desc)
+    return;
+  auto &H = *reinterpret_cast<ccr::HotPagesNoteHeader *>(Desc);
+  auto *Out = reinterpret_cast<ccr::HotPageRange *>(&H + 1);
+  H.Signature = 0;
+  uint64_t Capacity =
+      std::min<uint64_t>(H.Capacity, (DescSize - sizeof(H)) / sizeof(*Out));
+
+  std::vector<std::pair<uint64_t, uint64_t>> Pages; // [begin, end)
+  for (unsigned I = 0, E = L->functions().size(); I != E; ++I) {
+    if (!L->isHotFunction(I))
+      continue;
+    std::pair<uint64_t, uint64_t> Range = L->getNewRange(I, false);
+    if (Range.first == Range.second)
+      continue;
+    Pages.emplace_back(alignDown(Text->Addr + Range.first, PageSize),
+                       alignTo(Text->Addr + Range.second, PageSize));
+  }
+  llvm::sort(Pages);
+  std::vector<std::pair<uint64_t, uint64_t>> Merged;
+  for (const auto &P : Pages) {
+    if (!Merged.empty() && P.first <= Merged.back().second)
+      Merged.back().second = std::max(Merged.back().second, P.second);
+    else
+      Merged.push_back(P);
+  }
+  if (Merged.size() > Capacity && Capacity) {
+    // Close the smallest gaps, up to the one that makes the ranges fit
+    std::vector<uint64_t> Gaps;
+    for (size_t I = 1; I < Merged.size(); ++I)
+      Gaps.push_back(Merged[I].first - Merged[I - 1].second);
+    std::nth_element(Gaps.begin(), Gaps.begin() + (Merged.size() - Capacity - 1),
+                     Gaps.end());
+    uint64_t MaxGap = Gaps[Merged.size() - Capacity - 1];
+    std::vector<std::pair<uint64_t, uint64_t>> Closed;
+    for (const auto &P : Merged) {
+      if (!Closed.empty() && P.first - Closed.back().second <= MaxGap)
+        Closed.back().second = P.second;
+      else
+        Closed.push_back(P);
+    }
+    Merged.swap(Closed);
+  }
+  if (Merged.size() > Capacity) {
+    WithColor::warning() << "the hot pages note holds no range\n";
+    return;
+  }
+  NumHotPages = 0;
+  for (size_t I = 0; I < Merged.size(); ++I) {
+    Out[I].Addr = Merged[I].first;
+    Out[I].Size = Merged[I].second - Merged[I].first;
+    NumHotPages += Out[I].Size / PageSize;
+  }
+  H.Version = ccr::HotPagesNoteHeader::CurrentVersion;
+  H.NumRanges = Merged.size();
+  H.NoteAddr = DescAddr;
+  H.PageSize = PageSize;
+  H.Signature = ccr::HotPagesNoteHeader::MagicSignature;
+  NumHotPageRanges = Merged.size();
+}
+
+void Randomizer::writeAddressMap(raw_ostream &OS) const {
+  // The map names the (possibly grown) .text as the section header now does
+  uint64_t TextSize = std::max(Text->Size, L->getNewEnd());
+  if (Config.PlanOnly) {
+    object::writeRandAddressMap(OS, Text->Addr, TextSize, getAddressRanges());
+    return;
+  }
+  object::writeRandAddressMap(OS, Text->Addr,
+                              Image.slice(Text->Offset, TextSize),
+                              getAddressRanges());
+}
+
+NewSection Randomizer::getBBAddrMap() const {
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  std::vector<unsigned> ByNew(BBLs.size());
+  std::iota(ByNew.begin(), ByNew.end(), 0);
+  std::stable_sort(ByNew.begin(), ByNew.end(), [&](unsigned A, unsigned B) {
+    return BBLs[A].NewOffset < BBLs[B].NewOffset;
+  });
+
+  // The trailing padding of a BBL is the gap before the next one
+  std::vector<object::RandBBAddrEntry> Entries;
+  for (unsigned I : ByNew) {
+    const BasicBlock &BBL = BBLs[I];
+    if (Entries.empty() || Entries.back().FunctionID != BBL.Function)
+      Entries.push_back({BBL.Function, {}});
+    Entries.back().BBLs.push_back(
+        {I, Text->Addr + BBL.NewOffset,
+         uint64_t(int64_t(L->getCodeSize(BBL)) + BBL.Growth)});
+  }
+
+  SmallString<0> Data;
+  raw_svector_ostream OS(Data);
+  object::writeRandBBAddrMap(OS, Text->Addr, Entries);
+  NewSection Sec;
+  Sec.Name = ccr::BBAddrMapHeader::SectionName;
+  Sec.Data.assign(Data.begin(), Data.end());
+  return Sec;
+}
+
+// Koo: The entry trampolines are written over the padding of the BBL placed
+//      before them, thus a padding site is cut around them; the other sites
+//      are within the code of their BBLs and never overlap
+NewSection Randomizer::getSyntheticSites() const {
+  using object::RandSyntheticSite;
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  std::vector<RandSyntheticSite> Sites, Paddings;
+  for (uint64_t Entry : L->trampolines())
+    Sites.push_back({Text->Addr + Entry, TrampolineSize, ccr::SSK_Trampoline,
+                     uint64_t(L->findBasicBlock(Entry)), Text->Addr + Entry});
+  // The slots of the hot regions are trampolines of a new address
+  for (const ccr::HotRegion &R : L->hotRegions())
+    for (size_t I = 0, E = R.Functions.size(); I != E; ++I) {
+      unsigned First = L->functions()[R.Functions[I]].FirstBBL;
+      Sites.push_back({Text->Addr + R.Begin + I * Layout::HotRegionSlotSize,
+                       Layout::HotRegionSlotSize, ccr::SSK_Trampoline, First,
+                       Text->Addr + BBLs[First].OldOffset});
+    }
+  for (size_t I = 0, E = Fixups.size(); I != E; ++I) {
+    const FixupInfo &F = Fixups[I];
+    if (!Relaxed[I] || F.OwnerBBL < 0)
+      continue;
+    uint64_t Inst = F.Offset + F.DerefSize - F.RelaxShortSize;
+    Sites.push_back({Text->Addr + L->translateWithin(F.OwnerBBL, Inst),
+                     F.RelaxLongSize, ccr::SSK_RelaxedBranch,
+                     uint64_t(F.OwnerBBL), Text->Addr + Inst});
+  }
+  auto Translate = [this](uint64_t Addr) { return translateAddress(Addr); };
+  for (const auto &Entry : DuplicatedTails) {
+    const FixupInfo &F = Fixups[Entry.first];
+    TextFixup Jump = relocateTextFixup(F, false, Shrunk[Entry.first],
+                                       OldText.data(), Text->Addr, *L, GOT,
+                                       Translate);
+    Sites.push_back({Text->Addr + Jump.NewOffset - 1, 1 + Jump.NewSize,
+                     ccr::SSK_DuplicatedTail, Entry.second,
+                     Text->Addr + BBLs[Entry.second].OldOffset});
+  }
+  for (size_t I = 0, E = BBLs.size(); I != E; ++I) {
+    const BasicBlock &BBL = BBLs[I];
+    if (!BBL.FallThrough || !BBL.NewPadding)
+      continue;
+    uint64_t CodeSize = L->getCodeSize(BBL);
+    Paddings.push_back({Text->Addr + BBL.NewOffset + CodeSize + BBL.Growth,
+                        BBL.NewPadding, ccr::SSK_Padding, I,
+                        Text->Addr + BBL.OldOffset + CodeSize});
+  }
+  auto ByAddr = [](const RandSyntheticSite &A, const RandSyntheticSite &B) {
+    return A.Addr < B.Addr;
+  };
+  llvm::sort(Sites, ByAddr);
+
+  size_t NumCode = Sites.size();
+  for (const RandSyntheticSite &P : Paddings) {
+    uint64_t Begin = P.Addr, End = P.Addr + P.Size;
+    auto It = std::lower_bound(Sites.begin(), Sites.begin() + NumCode, P, ByAddr);
+    if (It != Sites.begin() && std::prev(It)->Addr + std::prev(It)->Size > Begin)
+      Begin = std::prev(It)->Addr + std::prev(It)->Size;
+    for (; It != Sites.begin() + NumCode && It->Addr < End; ++It) {
+      if (It->Addr > Begin)
+        Sites.push_back({Begin, It->Addr - Begin, P.Kind, P.BBL, P.OrigAddr});
+      Begin = std::max(Begin, It->Addr + It->Size);
+    }
+    if (Begin < End)
+      Sites.push_back({Begin, End - Begin, P.Kind, P.BBL, P.OrigAddr});
+  }
+  llvm::sort(Sites, ByAddr);
+
+  SmallString<0> Data;
+  raw_svector_ostream OS(Data);
+  object::writeRandSyntheticSites(OS, Text->Addr, Sites);
+  NewSection Sec;
+  Sec.Name = ccr::SyntheticSitesHeader::SectionName;
+  Sec.Data.assign(Data.begin(), Data.end());
+  return Sec;
+}
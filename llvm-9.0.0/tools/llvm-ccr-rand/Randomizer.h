@@ -0,0 +1,401 @@
+//===- Randomizer.h - Rewrite a binary with a randomized layout -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The randomizer moves the BBLs of .text into the order computed by the
+// Layout, and patches everything that refers to the moved code in the same
+// pass: the fixups in .text and the data sections (.rand), relative jump
+// table entries, dynamic relocations, symbols, the entry point, the FDEs
+// of .eh_frame/.eh_frame_hdr (and those of the cold regions of split
+// functions, see EHFrame.cpp), the LSDA call-site tables that the compiler
+// has described (-ccr-eh-info) and the layout note of the runtime that
+// in-process profilers translate their samples with (see CCRLayout.h). With
+// -shuffle-data, the objects of .data and .bss move as well, by the groups of
+// DataGroups.h, and so does what refers to them.
+//
+// The randomizer never changes the file layout: it patches the section
+// contents in place within a writable (typically mapped) image of the binary,
+// thus only the pages of .text and the sections with fixups are touched.
+// The only exception is a short branch relaxed to its long form, which grows
+// .text into the padding up to the next section.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_RANDOMIZER_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_RANDOMIZER_H
+
+#include "DataGroups.h"
+#include "Layout.h"
+#include "RandInfo.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Object/RandMap.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+
+namespace ccr {
+
+// The section header fields the randomizer needs
+struct Section {
+  std::string Name;
+  unsigned Index = 0;
+  uint32_t Type = 0;
+  uint64_t Flags = 0;
+  uint64_t Addr = 0;
+  uint64_t Offset = 0;
+  uint64_t Size = 0;
+  uint32_t Link = 0;
+  uint64_t AddrAlign = 0;
+  uint64_t HeaderOffset = 0; // File offset of the section header
+};
+
+// The GOT (.got and .got.plt) that the fixups of PIC code may refer to
+struct GOTInfo {
+  uint64_t Base = 0;  // _GLOBAL_OFFSET_TABLE_ (.got.plt if any)
+  uint64_t Begin = 0; // [Begin, End) covers every GOT entry
+  uint64_t End = 0;
+
+  bool contains(uint64_t Addr) const { return Addr >= Begin && Addr < End; }
+};
+
+// A record of a pre-aggregated profile (see -optimize-layout): a taken branch
+// From -> To, or a fall-through range [From, To] of straight-line code; or
+// the code [From, To] sampled Count times (see SampleProfile.h)
+struct ProfileRecord {
+  uint64_t From = 0;
+  uint64_t To = 0;
+  uint64_t Count = 0;
+  bool FallThrough = false;
+  bool Sampled = false;
+};
+
+struct RandomizerConfig {
+  uint64_t Seed = 0;
+  bool ShuffleBBLs = false;
+  unsigned BBLShufflePercent = 100; // Share of the functions to BBL-shuffle
+  unsigned Epoch = 0; // Re-randomization epoch of the seed (see Layout::setEpoch())
+  unsigned RefreshPercent = 10; // Share of the units each epoch moves again
+  bool HotColdBuckets = true; // Keep hot and cold code apart
+  bool PlacementChains = true; // Shuffle the BBLs by the chains of the placement
+  bool SectionClasses = true; // Permute .text.hot, .text.unlikely etc. apart
+  bool Realign = true; // Re-materialize the BBL alignment at the new places
+  bool SlidePadding = false; // Slide the BBLs and vary the NOPs within the padding
+  bool PaddingOnly = false; // Keep the order; only slide within the padding
+  bool PackCold = false; // Leave the cold code unaligned (see Layout::setPackCold())
+  bool ObjectGranularity = false; // Permute whole objects (see Layout::setObjectUnits())
+  bool EntryTrampolines = false; // Keep the exported entries (see planTrampolines())
+  bool HotRegion = false; // Re-randomize the hot regions only (see Layout::setHotRegion())
+  uint64_t HotRegionSeed = 0; // The seed of the hot regions (Seed: of the rest)
+  uint64_t HotRegionBudget = 0; // Bytes of hot code in the regions (0: all of it)
+  bool StableOrder = false; // Place by the function identities (see Layout::setStableOrder())
+  bool StraightenBranches = true; // Drop the jumps to the next BBL
+  bool ShrinkBranches = true; // Re-encode the relaxed branches short if they reach
+  unsigned TailDupSize = 5; // Copy the tails up to this size over the jumps to them
+  uint64_t HugePageSize = 0; // Keep the hot code on few pages of this size
+  uint64_t ShuffleWindow = 0; // Permute within windows of this many bytes (see Layout::setShuffleWindow())
+  double MaxGrowthPercent = -1; // Budget of the code growth (< 0: the slack)
+  bool NoHotGrowth = false; // Never relax the short branches of hot functions
+  bool StartupLayout = false; // Pack the startup path first (see markStartupFunctions())
+  unsigned StartupDepth = 1; // Levels of callees of the startup roots
+  std::vector<std::string> StartupSymbols; // A startup profile, instead of the roots
+  std::vector<ProfileRecord> Profile; // Optimize the layout by it instead
+  bool ClusterCalls = false; // Permute call clusters (by Profile, if any)
+  bool SplitFunctions = false; // Move cold chains to the end of the segments
+  bool Verbose = false;
+  bool Parallel = true; // Shuffle the functions and patch on the thread pool
+  bool LazyText = false; // Leave .text to materializeText() (see LoadTime.h)
+  bool PermuteInPlace = false; // Move the BBLs within .text (no copy of it)
+  bool PlanOnly = false; // run() plans the layout only; the image is read, never written
+  std::string IndexPath; // Pre-analysed .rand index to reuse (or create)
+  ArrayRef<uint8_t> Index; // A mapped index to use instead (see LoadTime.h)
+  ArrayRef<uint8_t> RandSidecar; // The .rand of a stripped binary (see RandSidecar.h)
+  const RandInfo *Metadata = nullptr; // The decoded .rand to copy (see Server.h)
+  bool RewriteDebugInfo = false; // Regenerate the DWARF for the new layout
+  bool BBAddrMap = false; // Add the BBL address map (see getBBAddrMap())
+  bool SyntheticSites = false; // Add the code it inserted (see getSyntheticSites())
+  bool ShuffleData = false; // Permute .data and .bss as well (see planDataGroups())
+  std::vector<std::vector<std::string>> DataAffinity; // Globals kept on adjacent lines
+  std::string StatsPath; // Write what the layout bought and cost there (JSON)
+  std::string MCAPath; // The tool writes the llvm-mca regions there
+};
+
+// A record of an LSDA call-site table: udata4 start, length and landing pad
+// relative to the start of the function, then the ULEB128 action
+struct CallSiteRecord {
+  uint32_t Start = 0;
+  uint32_t Length = 0;
+  uint32_t LandingPad = 0; // 0 if none
+  uint32_t Size = 0;       // Of the whole record
+};
+
+struct CallSiteTable {
+  unsigned EntryBBL = 0;       // The first BBL of the function
+  uint64_t FunctionOffset = 0; // .text offset of the function
+  uint64_t Offset = 0;         // Of the first record in .gcc_except_table
+  std::vector<CallSiteRecord> Records;
+};
+
+// A record of .eh_frame, for the FDEs of split functions (see EHFrame.cpp)
+struct EHRecord {
+  uint64_t Offset = 0;     // In .eh_frame
+  uint32_t Size = 0;       // With the length field
+  int CIE = -1;            // The record of the CIE of an FDE; -1 for a CIE
+  // CIE: the encodings of pc_begin and the LSDA pointer of its FDEs, and the
+  // offset of a pc-relative personality pointer (0 if none)
+  uint8_t FDEEncoding = 0;
+  uint8_t LSDAEncoding = 0xff; // DW_EH_PE_omit
+  bool Augmented = false;      // 'z': the FDEs have augmentation data
+  bool UnitCodeAlign = false;  // Code alignment factor 1
+  uint32_t PersonalityField = 0;
+  uint8_t PersonalityEncoding = 0xff;
+  // FDE: its old code, the offsets of its LSDA pointer (0 if none) and its
+  // CFI program, and whether it has an LSDA or a program the cold region
+  // cannot take
+  uint64_t Begin = 0;
+  uint64_t Range = 0;
+  uint32_t LSDAField = 0;
+  uint32_t Program = 0;
+  bool HasLSDA = false;
+  bool Simple = false;
+  bool Indexed = false; // In the search table of .eh_frame_hdr
+};
+
+// The FDE of the cold region of a segment: the functions absorbed from the
+// end of the segment, then the cold parts of its split functions
+struct ColdFDE {
+  unsigned Segment = 0; // Into Layout::segmentEnds()
+  int CIE = -1;
+  std::vector<unsigned> Absorbed; // Functions, by descending new offsets
+};
+
+// The old and new location/value of a fixup in .text
+struct TextFixup {
+  uint64_t NewOffset;
+  int64_t NewValue;
+  uint64_t OldTarget; // Text fixups only (PC-relative)
+  unsigned NewSize;
+  bool Fits;
+};
+
+// Bytes to write past the end of the image (see appendSections())
+struct FileAppend {
+  uint64_t Offset = 0;
+  std::vector<uint8_t> Data;
+};
+
+// A regenerated (or new) non-allocated section (see appendSections())
+struct NewSection {
+  StringRef Name;
+  std::vector<uint8_t> Data;
+  bool Compressed = false; // Data is an Elf64_Chdr and its zlib stream
+};
+
+struct LazyTextState;
+
+class Randomizer {
+  MutableArrayRef<uint8_t> Image; // The whole ELF file, patched in place
+  const RandomizerConfig &Config;
+
+  uint16_t FileType = 0;
+  std::vector<Section> Sections;
+  RandInfo Info;
+  std::unique_ptr<ccr::Layout> L;
+  const Section *Text = nullptr;
+  ArrayRef<uint8_t> OldText;           // .text before randomization
+  std::vector<uint8_t> OldTextCopy;    // Its copy, unless Config.PermuteInPlace
+  // With Config.PermuteInPlace, the text fixups relocated before the BBLs
+  // move over their old bytes, and the most the moves have set aside at once
+  std::vector<TextFixup> TextPatches;
+  uint64_t PeakStashBytes = 0;
+  unsigned NumIntactObjects = 0; // With Config.ObjectGranularity
+  unsigned NumForeignObjects = 0; // Inputs without .rand (see addForeignFixups())
+  unsigned NumForeignFixups = 0;  // ... and the fixups of their relocations
+  unsigned NumRelaxedGOTRefs = 0; // Relaxed by the linker (see resolveGOTRelaxations())
+  DenseSet<uint64_t> JumpTableEntries; // Addresses of relative JT entries
+  // The words of the 8-byte absolute data fixups, if RELR (or REL) relocations
+  // hold their addends in words as well (see patchDynamicRelocations())
+  bool InPlaceAddends = false;
+  DenseSet<uint64_t> PatchedWords;
+  std::vector<std::pair<uint64_t, uint64_t>> LoadSegments; // [Addr, End)
+  GOTInfo GOT;
+  // With Config.ShuffleData, the groups of the data objects and the sections
+  // they move within
+  std::unique_ptr<DataGroups> DG;
+  SmallVector<const Section *, 2> DataSections;
+
+  // The indices of the .text fixups of the few shapes that the range and
+  // straightening passes look at, in ascending order (see bucketFixups()):
+  // short PC-relative fixups and shrinkable branches, shrinkable branches,
+  // and direct jumps
+  struct FixupBuckets {
+    std::vector<uint32_t> RangeLimited;
+    std::vector<uint32_t> Shrinkable;
+    std::vector<uint32_t> Jumps;
+  } Buckets;
+
+  // Short branches relaxed to their long forms and long branches shrunk to
+  // their short forms, by index in .text fixups, and the fixups of either
+  // kind owned by each resized BBL (in ascending offsets)
+  std::vector<bool> Relaxed;
+  std::vector<bool> Shrunk;
+  DenseMap<unsigned, SmallVector<unsigned, 2>> ResizedFixups;
+
+  // The jumps to the next BBL that become NOPs, and the conditional branches
+  // inverted to take the target of such a jump (by .text fixup index)
+  std::vector<unsigned> DroppedJumps;
+  DenseMap<unsigned, unsigned> InvertedBranches;
+
+  // The jumps that a copy of their target BBL replaces (by .text fixup index,
+  // and the BBL of the tail)
+  std::vector<std::pair<unsigned, unsigned>> DuplicatedTails;
+
+  // The call-site tables of the randomizable functions
+  const Section *LSDA = nullptr;
+  std::vector<CallSiteTable> CallSiteTables;
+
+  // The records of .eh_frame and the FDE of every function that has one,
+  // and the FDEs of the cold regions (if functions are split)
+  std::vector<EHRecord> EHRecords;
+  DenseMap<unsigned, unsigned> FunctionFDEs;
+  std::vector<ColdFDE> ColdFDEs;
+
+  uint8_t *getContents(const Section &Sec);
+  const Section *findSection(StringRef Name) const;
+  uint64_t translateAddress(uint64_t Addr) const;
+  uint64_t translateInbound(uint64_t Addr) const;
+  bool isPIC() const;
+  uint64_t getTextSlack() const;
+  size_t forEachIndex(size_t N, function_ref<bool(size_t)> Fn) const;
+
+  Error readSections();
+  Error loadRandInfo();
+  void resolveGOTRelaxations();
+  Error addForeignFixups();
+  void computeIncomingFixups();
+  Error planLayout();
+  void forEachFunctionSymbol(function_ref<void(StringRef, uint64_t)> Fn);
+  void markStartupFunctions();
+  Error planTrampolines();
+  Error planDataGroups();
+  void moveDataGroups();
+  void writeTrampolines(uint8_t *NewText, uint64_t Lo, uint64_t Hi) const;
+  void writeHotRegionSlots(uint8_t *NewText, uint64_t Lo, uint64_t Hi) const;
+  void setLayoutProfile();
+  void buildCallGraph();
+  void bucketFixups();
+  void shrinkBranches();
+  Error fixBranchRange();
+  void straightenBranches();
+  void duplicateTails();
+  void writePadding(uint8_t *P, uint64_t Count, unsigned Idx) const;
+  void moveBasicBlock(uint8_t *NewText, unsigned Idx,
+                      const uint8_t *Code) const;
+  Error moveBasicBlocks();
+  Error permuteBasicBlocks();
+  std::unique_ptr<LazyTextState> Lazy; // With Config.LazyText
+  bool movedAsWhole(const ccr::Function &F) const;
+  Error relocateTextFixups(std::vector<TextFixup> &Patches);
+  Error patchTextFixups();
+  Error patchJumpTables();
+  Error patchDataFixups();
+  const Section *findOutputSection(StringRef InputName) const;
+  Error patchCustomFixups();
+  Error patchFixupsIn(const Section &Sec, ArrayRef<FixupInfo> Fixups);
+  Error patchDynamicRelocations();
+  Error patchRelocatedWord(uint64_t Addr);
+  void patchSymbols();
+  Error readCallSiteTables();
+  void keepCallSitesTogether();
+  Error patchCallSiteTables();
+  uint64_t translateRange(uint64_t Begin, uint64_t Size) const;
+  void sortSearchTable(std::vector<std::pair<int32_t, int32_t>> &Table) const;
+  Error patchEHFrame();
+  Error readEHRecords();
+  void planColdFDEs();
+  Error writeColdFDEs();
+  std::vector<object::RandAddressRange> getAddressRanges() const;
+  uint8_t *findNote(uint32_t Type, uint64_t MinSize, uint64_t &DescSize,
+                    uint64_t &DescAddr);
+  void writeLayoutNote();
+  void writeHotPagesNote();
+  unsigned NumHotPages = 0; // In the note of writeHotPagesNote()
+  unsigned NumHotPageRanges = 0;
+  void writeStats(raw_ostream &OS) const;
+  Error compressSections(MutableArrayRef<NewSection> New);
+
+public:
+  Randomizer(MutableArrayRef<uint8_t> Image, const RandomizerConfig &Config);
+  ~Randomizer();
+
+  /// Randomize the layout of .text (or optimize it by Config.Profile) and
+  /// patch all references to it.
+  Error run();
+
+  /// The layout that run() has applied; only valid after a successful run().
+  const Layout &getLayout() const { return *L; }
+
+  /// With Config.LazyText, run() patches all but .text, which is left as it
+  /// was: write the randomized contents of the \p Size bytes at the address
+  /// \p Addr to \p Dest, the other sections on them from the image. Only
+  /// valid after a successful run(); one caller at a time.
+  void materializeText(uint64_t Addr, uint64_t Size, uint8_t *Dest);
+
+  /// The addresses [begin, end) of .text
+  std::pair<uint64_t, uint64_t> getTextRange() const {
+    return {Text->Addr, Text->Addr + Text->Size};
+  }
+
+  /// Write the address translation map of the randomized .text (see
+  /// llvm/Object/RandMap.h); only valid after a successful run(). With
+  /// Config.PlanOnly, the map of the planned layout has no hash of the text.
+  void writeAddressMap(raw_ostream &OS) const;
+
+  /// Rewrite the line tables and the address ranges of the DWARF for the
+  /// randomized layout (see DwarfRewriter.cpp); only valid after run(). The
+  /// regenerated sections outgrow their places, thus they are added to \p New
+  /// for appendSections().
+  Error rewriteDebugInfo(std::vector<NewSection> &New);
+
+  /// The BBL address map of the randomized .text (.ccr_bb_addr_map, see
+  /// llvm/BinaryFormat/RandMap.h); only valid after a successful run().
+  NewSection getBBAddrMap() const;
+
+  /// The code that the randomization put into the new .text
+  /// (.ccr_synthetic_sites, see llvm/BinaryFormat/RandMap.h); only valid
+  /// after a successful run().
+  NewSection getSyntheticSites() const;
+
+  /// Point the headers of the sections \p New (adding those the binary lacks)
+  /// at their contents, which are returned in \p Appends to be written past
+  /// \p FileSize, the end of the file.
+  Error appendSections(ArrayRef<NewSection> New, uint64_t FileSize,
+                       std::vector<FileAppend> &Appends);
+
+  /// Write the hot BBLs of every hot function, in the old and the new layout,
+  /// to \p OS as pairs of llvm-mca code regions (see MCAExport.cpp); only
+  /// valid after run().
+  Error writeMCARegions(raw_ostream &OS);
+
+  /// Cross-check the .rand section against the code instead, leaving the
+  /// image untouched (see Verifier.cpp).
+  Error verify();
+};
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_RANDOMIZER_H
@@ -0,0 +1,626 @@
+//===- RerandRuntime.cpp - Re-randomize a running process -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The build compares the new image with the file: the words of the
+// writable segments that differ are the data fixups the randomizer patched,
+// and the dynamic relocations whose addends (or symbols) differ are the code
+// pointers the loader wrote. The loaded values of those are translated at the
+// commit rather than copied, as the loader (or the application) may have
+// written them since.
+//
+// Everything is translated before the swap: the running layout is read from
+// the loaded note, which the swap replaces.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CCRRerand.h"
+#include "Layout.h"
+#include "LoadTime.h"
+#include "Randomizer.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/RandMap.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <unwind.h>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::ELF;
+
+namespace {
+enum BuildState { BS_Building, BS_Ready, BS_Failed, BS_Done };
+
+// The frames in the code of the executable that a thread may have
+const unsigned MaxFramesInCode = 1024;
+
+// A return address on the stack of a stopped thread
+struct StackSlot {
+  uintptr_t *Addr;
+  uintptr_t Value;
+};
+
+struct ThreadRecord {
+  pid_t Tid = 0;
+  bool Valid = false; // The stack has been walked to its end
+  unsigned NumSlots = 0;
+  StackSlot Slots[MaxFramesInCode];
+};
+
+// The pages of a read-only segment in the new layout, in a mapping of their
+// own to be moved over the loaded ones
+struct FreshSegment {
+  void *Mapping;
+  uintptr_t Addr;
+  size_t Size;
+};
+} // end anonymous namespace
+
+struct ccr_rerand {
+  std::thread Worker;
+  std::atomic<int> State{BS_Building};
+  std::string Message;
+  bool Reported = false;
+
+  std::unique_ptr<MemoryBuffer> File, Index;
+  std::vector<uint8_t> Image;
+  RandomizerConfig Config; // The randomizer refers to it to the end
+  std::unique_ptr<Randomizer> R;
+
+  uint64_t Bias = 0;
+  uint64_t TextAddr = 0, TextEnd = 0; // The link-time .text and its segment
+  std::vector<std::pair<uintptr_t, uintptr_t>> Code; // Loaded, executable
+  std::vector<LayoutNoteRange> Running; // Of the note; none if as built
+  std::vector<FreshSegment> Segments;
+  std::vector<uintptr_t> Sites; // Loaded code pointers in writable segments
+  uintptr_t RelroBegin = 0, RelroEnd = 0;
+
+  Error build(const std::string &BinaryPath, const std::string &IndexPath,
+              uint64_t Seed, unsigned Flags);
+  bool inCode(uintptr_t PC) const;
+  uint64_t toBuilt(uint64_t Offset) const;
+  uintptr_t translate(uintptr_t PC) const;
+  int apply(ArrayRef<ThreadRecord> Records);
+
+  ~ccr_rerand() {
+    if (Worker.joinable())
+      Worker.join();
+    for (const FreshSegment &S : Segments)
+      if (S.Mapping)
+        munmap(S.Mapping, S.Size);
+  }
+};
+
+static Error makeError(const Twine &Message) {
+  return make_error<StringError>(Message, inconvertibleErrorCode());
+}
+
+static Error makeErrnoError(const Twine &Message) {
+  return make_error<StringError>(Message + ": " + strerror(errno),
+                                 std::error_code(errno, std::generic_category()));
+}
+
+static int reportError(Error E) {
+  WithColor::error(errs(), "ccr-rerand") << toString(std::move(E)) << "\n";
+  return -1;
+}
+
+static ArrayRef<Elf64_Phdr> getProgramHeaders(ArrayRef<uint8_t> Image) {
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image.data());
+  if (Image.size() < sizeof(Elf64_Ehdr) ||
+      Ehdr->e_phentsize != sizeof(Elf64_Phdr) || Ehdr->e_phoff > Image.size() ||
+      (uint64_t)Ehdr->e_phnum * sizeof(Elf64_Phdr) >
+          Image.size() - Ehdr->e_phoff)
+    return {};
+  return {reinterpret_cast<const Elf64_Phdr *>(Image.data() + Ehdr->e_phoff),
+          Ehdr->e_phnum};
+}
+
+static ArrayRef<Elf64_Shdr> getSectionHeaders(ArrayRef<uint8_t> Image) {
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image.data());
+  if (Image.size() < sizeof(Elf64_Ehdr) ||
+      Ehdr->e_shentsize != sizeof(Elf64_Shdr) || Ehdr->e_shoff > Image.size() ||
+      (uint64_t)Ehdr->e_shnum * sizeof(Elf64_Shdr) >
+          Image.size() - Ehdr->e_shoff)
+    return {};
+  return {reinterpret_cast<const Elf64_Shdr *>(Image.data() + Ehdr->e_shoff),
+          Ehdr->e_shnum};
+}
+
+static bool inFile(ArrayRef<uint8_t> Image, uint64_t Offset, uint64_t Size) {
+  return Offset <= Image.size() && Size <= Image.size() - Offset;
+}
+
+static const Elf64_Shdr *findSection(ArrayRef<uint8_t> Image,
+                                     ArrayRef<Elf64_Shdr> Shdrs,
+                                     StringRef Name) {
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Image.data());
+  if (Ehdr->e_shstrndx >= Shdrs.size())
+    return nullptr;
+  const Elf64_Shdr &StrTab = Shdrs[Ehdr->e_shstrndx];
+  if (!inFile(Image, StrTab.sh_offset, StrTab.sh_size))
+    return nullptr;
+  StringRef Names(reinterpret_cast<const char *>(Image.data()) +
+                      StrTab.sh_offset,
+                  StrTab.sh_size);
+  for (const Elf64_Shdr &S : Shdrs)
+    if (S.sh_name < Names.size() &&
+        Names.drop_front(S.sh_name).split('\0').first == Name)
+      return &S;
+  return nullptr;
+}
+
+Error ccr_rerand::build(const std::string &BinaryPath,
+                        const std::string &IndexPath, uint64_t Seed,
+                        unsigned Flags) {
+  auto readFile = [](const std::string &Path,
+                     std::unique_ptr<MemoryBuffer> &Buf) -> Error {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(
+        Path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+    if (!BufOrErr)
+      return createFileError(Path, errorCodeToError(BufOrErr.getError()));
+    Buf = std::move(*BufOrErr);
+    return Error::success();
+  };
+  if (Error E = readFile(BinaryPath, File))
+    return E;
+  if (Error E = readFile(IndexPath, Index))
+    return E;
+  ArrayRef<uint8_t> Built = arrayRefFromStringRef(File->getBuffer());
+  ArrayRef<Elf64_Phdr> Phdrs = getProgramHeaders(Built);
+  ArrayRef<Elf64_Shdr> Shdrs = getSectionHeaders(Built);
+  if (Phdrs.empty() || Shdrs.empty())
+    return makeError(BinaryPath + " is not an ELF executable");
+  if (!getLoadBias(Built, Bias))
+    return makeError("Cannot tell where " + BinaryPath + " is loaded");
+  for (const Elf64_Phdr &Seg : Phdrs)
+    if (Seg.p_type == PT_LOAD && !inFile(Built, Seg.p_offset, Seg.p_filesz))
+      return makeError("A segment is out of " + BinaryPath);
+
+  // The loaded program headers tell the file is that of the executable
+  const auto *Ehdr = reinterpret_cast<const Elf64_Ehdr *>(Built.data());
+  const Elf64_Phdr *LoadedPhdrs = nullptr;
+  for (const Elf64_Phdr &Seg : Phdrs)
+    if (Seg.p_type == PT_LOAD && Seg.p_offset <= Ehdr->e_phoff &&
+        Ehdr->e_phoff < Seg.p_offset + Seg.p_filesz)
+      LoadedPhdrs = reinterpret_cast<const Elf64_Phdr *>(
+          Bias + Seg.p_vaddr + (Ehdr->e_phoff - Seg.p_offset));
+  if (!LoadedPhdrs ||
+      memcmp(LoadedPhdrs, Phdrs.data(), Phdrs.size() * sizeof(Elf64_Phdr)))
+    return makeError(BinaryPath + " is not the executable of this process");
+
+  const Elf64_Shdr *Text = findSection(Built, Shdrs, ".text");
+  if (!Text)
+    return makeError(BinaryPath + " has no .text section");
+  TextAddr = Text->sh_addr;
+  for (const Elf64_Phdr &Seg : Phdrs) {
+    if (Seg.p_type != PT_LOAD || !(Seg.p_flags & PF_X))
+      continue;
+    Code.push_back({Bias + Seg.p_vaddr, Bias + Seg.p_vaddr + Seg.p_memsz});
+    if (Seg.p_vaddr <= TextAddr && TextAddr < Seg.p_vaddr + Seg.p_memsz)
+      TextEnd = Seg.p_vaddr + Seg.p_memsz;
+  }
+
+  // The running layout: that of the note, if the code has been randomized
+  const Elf64_Shdr *Note = findSection(Built, Shdrs, ".note.ccr.layout");
+  const uint64_t DescOffset = sizeof(Elf64_Nhdr) + 4; // Past "CCR\0"
+  const LayoutNoteHeader *H = nullptr;
+  if (Note && (Note->sh_flags & SHF_ALLOC) &&
+      Note->sh_size >= DescOffset + sizeof(LayoutNoteHeader))
+    H = reinterpret_cast<const LayoutNoteHeader *>(Bias + Note->sh_addr +
+                                                   DescOffset);
+  if (H && H->Signature == LayoutNoteHeader::MagicSignature &&
+      H->Version == LayoutNoteHeader::CurrentVersion) {
+    if (H->TextAddr != TextAddr ||
+        DescOffset + sizeof(*H) + (uint64_t)H->NumRanges * sizeof(LayoutNoteRange) >
+            Note->sh_size)
+      return makeError("The layout note of the running code is corrupt");
+    const auto *Ranges = reinterpret_cast<const LayoutNoteRange *>(H + 1);
+    Running.assign(Ranges, Ranges + H->NumRanges);
+  } else if (!inFile(Built, Text->sh_offset, Text->sh_size) ||
+             memcmp(reinterpret_cast<const void *>(Bias + TextAddr),
+                    Built.data() + Text->sh_offset, Text->sh_size)) {
+    return makeError("The running code has been randomized without a layout "
+                     "note; link libCCRLayout into the binary");
+  }
+
+  Image.assign(Built.begin(), Built.end());
+  Config = getLoadConfig(getFlagsConfig(Seed, Flags),
+                         arrayRefFromStringRef(Index->getBuffer()));
+  R = llvm::make_unique<Randomizer>(Image, Config);
+  if (Error E = R->run())
+    return E;
+  if (memcmp(getProgramHeaders(Image).data(), Phdrs.data(),
+             Phdrs.size() * sizeof(Elf64_Phdr)))
+    return makeError("The new layout does not fit the loaded segments");
+
+  const uint64_t PageSize = sysconf(_SC_PAGESIZE);
+  for (const Elf64_Phdr &Seg : Phdrs) {
+    if (Seg.p_type == PT_GNU_RELRO) {
+      RelroBegin = alignDown(Bias + Seg.p_vaddr, PageSize);
+      RelroEnd = alignDown(Bias + Seg.p_vaddr + Seg.p_memsz, PageSize);
+    }
+    if (Seg.p_type != PT_LOAD || !Seg.p_filesz)
+      continue;
+    const uint8_t *New = Image.data() + Seg.p_offset;
+    const uint8_t *Old = Built.data() + Seg.p_offset;
+    uintptr_t Loaded = Bias + Seg.p_vaddr;
+
+    // The code pointers that the randomizer patched in the writable ones
+    if (Seg.p_flags & PF_W) {
+      for (uint64_t Chunk = 0; Chunk < Seg.p_filesz; Chunk += PageSize) {
+        uint64_t ChunkEnd = std::min<uint64_t>(Seg.p_filesz, Chunk + PageSize);
+        if (!memcmp(Old + Chunk, New + Chunk, ChunkEnd - Chunk))
+          continue;
+        for (uint64_t Off = alignTo(Loaded + Chunk, 8) - Loaded;
+             Off + 8 <= ChunkEnd; Off += 8)
+          if (memcmp(Old + Off, New + Off, 8))
+            Sites.push_back(Loaded + Off);
+      }
+      continue;
+    }
+
+    if (!memcmp(reinterpret_cast<const void *>(Loaded), New, Seg.p_filesz))
+      continue;
+    uintptr_t Begin = alignDown(Loaded, PageSize);
+    size_t Size = alignTo(Loaded + Seg.p_memsz, PageSize) - Begin;
+    void *M = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (M == MAP_FAILED)
+      return makeErrnoError("mmap");
+    Segments.push_back({M, Begin, Size});
+    memcpy(M, reinterpret_cast<const void *>(Begin), Size);
+    memcpy(static_cast<uint8_t *>(M) + (Loaded - Begin), New, Seg.p_filesz);
+    int Prot = (Seg.p_flags & PF_R ? PROT_READ : 0) |
+               (Seg.p_flags & PF_X ? PROT_EXEC : 0);
+    if (mprotect(M, Size, Prot))
+      return makeErrnoError("mprotect");
+  }
+
+  // The code pointers that the loader wrote
+  for (const Elf64_Shdr &Sec : Shdrs) {
+    if (Sec.sh_type != SHT_RELA || !(Sec.sh_flags & SHF_ALLOC))
+      continue;
+    if (!inFile(Built, Sec.sh_offset, Sec.sh_size))
+      return makeError("A relocation section is out of " + BinaryPath);
+    const auto *Old = reinterpret_cast<const Elf64_Rela *>(Built.data() +
+                                                           Sec.sh_offset);
+    const auto *New = reinterpret_cast<const Elf64_Rela *>(Image.data() +
+                                                           Sec.sh_offset);
+    const Elf64_Shdr *Syms =
+        Sec.sh_link < Shdrs.size() ? &Shdrs[Sec.sh_link] : nullptr;
+    auto getSymbolValue = [&](ArrayRef<uint8_t> In, uint32_t Idx) -> uint64_t {
+      if (!Syms || !inFile(In, Syms->sh_offset, Syms->sh_size) ||
+          Idx >= Syms->sh_size / sizeof(Elf64_Sym))
+        return 0;
+      return reinterpret_cast<const Elf64_Sym *>(In.data() + Syms->sh_offset)
+          [Idx].st_value;
+    };
+    for (size_t I = 0, E = Sec.sh_size / sizeof(Elf64_Rela); I != E; ++I) {
+      uint32_t Sym = Old[I].getSymbol();
+      if (Old[I].r_addend != New[I].r_addend ||
+          (Sym && getSymbolValue(Built, Sym) != getSymbolValue(Image, Sym)))
+        Sites.push_back(Bias + New[I].r_offset);
+    }
+  }
+  // ... in the writable segments; the others are swapped
+  auto isWritable = [&](uintptr_t Site) {
+    for (const Elf64_Phdr &Seg : Phdrs)
+      if (Seg.p_type == PT_LOAD && (Seg.p_flags & PF_W) &&
+          Site >= Bias + Seg.p_vaddr &&
+          Site + 8 <= Bias + Seg.p_vaddr + Seg.p_memsz)
+        return true;
+    return false;
+  };
+  Sites.erase(std::remove_if(Sites.begin(), Sites.end(),
+                             [&](uintptr_t Site) { return !isWritable(Site); }),
+              Sites.end());
+  llvm::sort(Sites);
+  Sites.erase(std::unique(Sites.begin(), Sites.end()), Sites.end());
+  return Error::success();
+}
+
+bool ccr_rerand::inCode(uintptr_t PC) const {
+  for (const std::pair<uintptr_t, uintptr_t> &Seg : Code)
+    if (PC >= Seg.first && PC < Seg.second)
+      return true;
+  return false;
+}
+
+// The running .text offset in the layout as built, as ccr_translate_pc()
+// tells it
+uint64_t ccr_rerand::toBuilt(uint64_t Offset) const {
+  auto It = llvm::upper_bound(Running, Offset,
+                              [](uint64_t O, const LayoutNoteRange &Range) {
+                                return O < Range.NewOffset;
+                              });
+  if (It == Running.begin())
+    return Offset;
+  const LayoutNoteRange &Range = *std::prev(It);
+  if (Offset - Range.NewOffset < Range.Size)
+    return Range.OldOffset + (Offset - Range.NewOffset);
+  if (It != Running.end())
+    return Range.OldOffset + Range.Size - 1;
+  return Offset;
+}
+
+uintptr_t ccr_rerand::translate(uintptr_t PC) const {
+  uint64_t Addr = PC - Bias;
+  if (Addr < TextAddr || Addr >= TextEnd)
+    return PC;
+  uint64_t Offset = Addr - TextAddr;
+  if (!Running.empty())
+    Offset = toBuilt(Offset);
+  return Bias + TextAddr + R->getLayout().translate(Offset);
+}
+
+// Koo: The commit is one at a time; the handler only reads the globals below
+//      (and writes the record it takes), thus one that runs late (a thread
+//      that had the signal blocked) finds no commit and returns
+static std::atomic<bool> Commit{false};
+static std::atomic<int> Waiting{0}; // The futex of the stopped threads
+static std::atomic<unsigned> Taken{0}, Walked{0}, Inside{0};
+static const ccr_rerand *Committing;
+static ThreadRecord *Records;
+static unsigned NumRecords;
+
+namespace {
+struct Walk {
+  const ccr_rerand *C;
+  ThreadRecord *T;
+  uintptr_t PrevCFA;
+  bool Failed;
+};
+} // end anonymous namespace
+
+// Koo: The return address of a frame is the IP of its caller, at the CFA of
+//      the frame less 8 on x86-64; an IP that is none (the interrupted one)
+//      or not found there fails the walk
+static _Unwind_Reason_Code walkFrame(_Unwind_Context *Ctx, void *Arg) {
+  auto &W = *static_cast<Walk *>(Arg);
+  int BeforeInsn = 0;
+  uintptr_t IP = _Unwind_GetIPInfo(Ctx, &BeforeInsn);
+  uintptr_t CFA = _Unwind_GetCFA(Ctx);
+  if (W.C->inCode(IP)) {
+    auto *Slot = reinterpret_cast<uintptr_t *>(W.PrevCFA - sizeof(uintptr_t));
+    if (BeforeInsn || !W.PrevCFA || *Slot != IP ||
+        W.T->NumSlots == MaxFramesInCode) {
+      W.Failed = true;
+      return _URC_NORMAL_STOP;
+    }
+    W.T->Slots[W.T->NumSlots++] = {Slot, IP};
+  }
+  W.PrevCFA = CFA;
+  return _URC_NO_REASON;
+}
+
+static void walkStack(const ccr_rerand &C, ThreadRecord &T) {
+  Walk W = {&C, &T, 0, false};
+  T.NumSlots = 0;
+  _Unwind_Reason_Code Code = _Unwind_Backtrace(walkFrame, &W);
+  T.Valid = !W.Failed && Code == _URC_END_OF_STACK;
+}
+
+static void stopThread(int) {
+  int SavedErrno = errno;
+  ++Inside;
+  if (Commit) {
+    unsigned I = Taken++;
+    if (I < NumRecords) {
+      Records[I].Tid = syscall(SYS_gettid);
+      walkStack(*Committing, Records[I]);
+      ++Walked;
+      while (Waiting)
+        syscall(SYS_futex, reinterpret_cast<int *>(&Waiting),
+                FUTEX_WAIT_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+  }
+  --Inside;
+  errno = SavedErrno;
+}
+
+static std::vector<pid_t> listThreads() {
+  std::vector<pid_t> Tids;
+  if (DIR *D = opendir("/proc/self/task")) {
+    while (dirent *E = readdir(D))
+      if (pid_t Tid = atoi(E->d_name))
+        Tids.push_back(Tid);
+    closedir(D);
+  }
+  llvm::sort(Tids);
+  return Tids;
+}
+
+// Koo: Past the first mremap() the code is of both layouts, thus a failure
+//      is fatal
+int ccr_rerand::apply(ArrayRef<ThreadRecord> Stopped) {
+  std::vector<std::pair<uintptr_t *, uintptr_t>> Writes;
+  for (const ThreadRecord &T : Stopped)
+    for (unsigned I = 0; I < T.NumSlots; ++I)
+      Writes.push_back({T.Slots[I].Addr, translate(T.Slots[I].Value)});
+  for (uintptr_t Site : Sites) {
+    auto *P = reinterpret_cast<uintptr_t *>(Site);
+    uintptr_t New = translate(*P);
+    if (New != *P)
+      Writes.push_back({P, New});
+  }
+  std::vector<std::pair<int, struct sigaction>> Handlers;
+  for (int Sig = 1; Sig < NSIG; ++Sig) {
+    struct sigaction Action;
+    if (sigaction(Sig, nullptr, &Action))
+      continue;
+    auto Handler = reinterpret_cast<uintptr_t>(Action.sa_handler);
+    if (translate(Handler) != Handler) {
+      Action.sa_handler =
+          reinterpret_cast<void (*)(int)>(translate(Handler));
+      Handlers.push_back({Sig, Action});
+    }
+  }
+
+  for (size_t I = 0; I < Segments.size(); ++I) {
+    FreshSegment &S = Segments[I];
+    if (mremap(S.Mapping, S.Size, S.Size, MREMAP_MAYMOVE | MREMAP_FIXED,
+               reinterpret_cast<void *>(S.Addr)) == MAP_FAILED) {
+      if (!I)
+        return reportError(makeErrnoError("mremap"));
+      WithColor::error(errs(), "ccr-rerand")
+          << "cannot swap the code: " << strerror(errno) << "\n";
+      abort();
+    }
+    S.Mapping = nullptr;
+  }
+  size_t RelroSize = RelroEnd - RelroBegin;
+  auto *Relro = reinterpret_cast<void *>(RelroBegin);
+  if (RelroSize && mprotect(Relro, RelroSize, PROT_READ | PROT_WRITE)) {
+    WithColor::error(errs(), "ccr-rerand")
+        << "cannot patch the relocated data: " << strerror(errno) << "\n";
+    abort();
+  }
+  for (const std::pair<uintptr_t *, uintptr_t> &W : Writes)
+    *W.first = W.second;
+  if (RelroSize && mprotect(Relro, RelroSize, PROT_READ)) {
+    WithColor::error(errs(), "ccr-rerand")
+        << "cannot protect the relocated data: " << strerror(errno) << "\n";
+    abort();
+  }
+  for (const std::pair<int, struct sigaction> &H : Handlers)
+    sigaction(H.first, &H.second, nullptr);
+  return 0;
+}
+
+struct ccr_rerand *ccr_rerand_prepare(const char *Binary, const char *Index,
+                                      uint64_t Seed, unsigned Flags) {
+  auto *C = new ccr_rerand;
+  C->Worker = std::thread([=](std::string BinaryPath, std::string IndexPath) {
+    if (Error E = C->build(BinaryPath, IndexPath, Seed, Flags)) {
+      C->Message = toString(std::move(E));
+      C->State = BS_Failed;
+    } else {
+      C->State = BS_Ready;
+    }
+  }, std::string(Binary), std::string(Index));
+  return C;
+}
+
+int ccr_rerand_ready(struct ccr_rerand *C) {
+  switch (C->State) {
+  case BS_Building:
+    return 0;
+  case BS_Ready:
+    return 1;
+  case BS_Failed:
+    if (!C->Reported) {
+      WithColor::error(errs(), "ccr-rerand") << C->Message << "\n";
+      C->Reported = true;
+    }
+    return -1;
+  default:
+    return -1;
+  }
+}
+
+int ccr_rerand_commit(struct ccr_rerand *C, int Signal, unsigned MaxPauseUs,
+                      uint64_t *PauseNs) {
+  int Ready = ccr_rerand_ready(C);
+  if (Ready <= 0)
+    return Ready ? reportError(makeError("The layout cannot be committed"))
+                 : 1;
+  static std::atomic<bool> Busy{false};
+  if (Busy.exchange(true))
+    return reportError(makeError("Another layout is being committed"));
+
+  pid_t Self = syscall(SYS_gettid);
+  std::vector<pid_t> Tids = listThreads();
+  Tids.erase(std::remove(Tids.begin(), Tids.end(), Self), Tids.end());
+  std::vector<ThreadRecord> Stopped(Tids.size() + 1);
+  struct sigaction Action, Saved;
+  memset(&Action, 0, sizeof(Action));
+  Action.sa_handler = stopThread;
+  Action.sa_flags = SA_RESTART;
+  sigfillset(&Action.sa_mask);
+  if (sigaction(Signal, &Action, &Saved)) {
+    Busy = false;
+    return reportError(makeErrnoError("sigaction"));
+  }
+  Committing = C;
+  Records = Stopped.data();
+  NumRecords = Tids.size();
+  Taken = Walked = 0;
+  Waiting = 1;
+  Commit = true;
+
+  auto Start = std::chrono::steady_clock::now();
+  auto Deadline = Start + std::chrono::microseconds(MaxPauseUs);
+  unsigned Expected = 0;
+  for (pid_t Tid : Tids)
+    if (!syscall(SYS_tgkill, getpid(), Tid, Signal))
+      ++Expected;
+  while (Walked < Expected && std::chrono::steady_clock::now() < Deadline)
+    sched_yield();
+  // The records taken are walked to the end, and no more are taken
+  Commit = false;
+  while (Walked < std::min<unsigned>(Taken, NumRecords))
+    sched_yield();
+  ThreadRecord &Own = Stopped.back();
+  walkStack(*C, Own);
+
+  // Every thread has stopped at a safepoint, and none has been created since
+  unsigned NumStopped = std::min<unsigned>(Walked, NumRecords);
+  bool Safe = NumStopped == Expected && Own.Valid;
+  for (unsigned I = 0; Safe && I < NumStopped; ++I)
+    Safe = Stopped[I].Valid;
+  if (Safe) {
+    std::vector<pid_t> Now = listThreads();
+    Now.erase(std::remove(Now.begin(), Now.end(), Self), Now.end());
+    std::vector<pid_t> StoppedTids;
+    for (unsigned I = 0; I < NumStopped; ++I)
+      StoppedTids.push_back(Stopped[I].Tid);
+    llvm::sort(StoppedTids);
+    Safe = Now == StoppedTids;
+  }
+  int Result = 1;
+  if (Safe) {
+    Stopped[NumStopped] = Own;
+    Result = C->apply(makeArrayRef(Stopped).take_front(NumStopped + 1));
+  }
+
+  Waiting = 0;
+  syscall(SYS_futex, reinterpret_cast<int *>(&Waiting), FUTEX_WAKE_PRIVATE,
+          INT_MAX, nullptr, nullptr, 0);
+  while (Inside)
+    sched_yield();
+  sigaction(Signal, &Saved, nullptr);
+  if (PauseNs)
+    *PauseNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - Start)
+                   .count();
+  if (!Result)
+    C->State = BS_Done;
+  Busy = false;
+  return Result;
+}
+
+void ccr_rerand_free(struct ccr_rerand *C) { delete C; }
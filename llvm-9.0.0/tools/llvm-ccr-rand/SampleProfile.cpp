@@ -0,0 +1,142 @@
+//===- SampleProfile.cpp - Sample profiles for the layout -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SampleProfile.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugLine.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/ProfileData/SampleProf.h"
+#include "llvm/ProfileData/SampleProfReader.h"
+#include <set>
+#include <tuple>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::sampleprof;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// The profile names a function without the suffixes the linker (or ThinLTO)
+// appended to the symbol
+static StringRef getProfileName(StringRef Name) {
+  return Name.split(".llvm.").first;
+}
+
+// The location of a frame in the profile of its function, as the sample
+// profile loader computes it from the DILocation
+static LineLocation getLineLocation(const DILineInfo &Frame) {
+  return LineLocation(
+      (Frame.Line - Frame.StartLine) & 0xffff,
+      DILocation::getBaseDiscriminatorFromDiscriminator(Frame.Discriminator));
+}
+
+Expected<std::vector<ProfileRecord>>
+ccr::readSampleProfile(StringRef Path, const object::ObjectFile &Obj) {
+  LLVMContext Ctx;
+  ErrorOr<std::unique_ptr<SampleProfileReader>> ReaderOrErr =
+      SampleProfileReader::create(Path, Ctx);
+  if (!ReaderOrErr)
+    return createFileError(Path, ReaderOrErr.getError());
+  SampleProfileReader &Reader = **ReaderOrErr;
+  if (std::error_code EC = Reader.read())
+    return createFileError(Path, EC);
+
+  // The function symbols, for the targets of the calls
+  StringMap<uint64_t> Symbols;
+  for (const object::SymbolRef &Sym : Obj.symbols()) {
+    Expected<object::SymbolRef::Type> Type = Sym.getType();
+    Expected<StringRef> Name = Sym.getName();
+    Expected<uint64_t> Addr = Sym.getAddress();
+    if (!Type || !Name || !Addr) {
+      consumeError(Type.takeError());
+      consumeError(Name.takeError());
+      consumeError(Addr.takeError());
+      continue;
+    }
+    if (*Type == object::SymbolRef::ST_Function && *Addr)
+      Symbols.try_emplace(getProfileName(*Name), *Addr);
+  }
+
+  std::unique_ptr<DWARFContext> DCtx = DWARFContext::create(Obj);
+  DILineInfoSpecifier Spec(DILineInfoSpecifier::FileLineInfoKind::Default,
+                           DINameKind::LinkageName);
+  std::vector<ProfileRecord> Records, Calls;
+  std::set<std::tuple<const FunctionSamples *, uint32_t, uint32_t>> CallSites;
+  for (const std::unique_ptr<DWARFUnit> &CU : DCtx->compile_units()) {
+    const DWARFDebugLine::LineTable *LineTable = DCtx->getLineTableForUnit(CU.get());
+    if (!LineTable)
+      continue;
+    ArrayRef<DWARFDebugLine::Row> Rows = LineTable->Rows;
+    for (size_t I = 0; I + 1 < Rows.size(); ++I) {
+      const DWARFDebugLine::Row &Row = Rows[I];
+      uint64_t Begin = Row.Address.Address, End = Rows[I + 1].Address.Address;
+      if (Row.EndSequence || End <= Begin)
+        continue;
+
+      // The profile of the outermost function, then of each inlined one
+      DIInliningInfo Frames = DCtx->getInliningInfoForAddress(Row.Address, Spec);
+      unsigned NumFrames = Frames.getNumberOfFrames();
+      if (!NumFrames)
+        continue;
+      const FunctionSamples *FS = Reader.getSamplesFor(
+          getProfileName(Frames.getFrame(NumFrames - 1).FunctionName));
+      for (unsigned K = NumFrames - 1; FS && K > 0; --K)
+        FS = FS->findFunctionSamplesAt(
+            getLineLocation(Frames.getFrame(K)),
+            getProfileName(Frames.getFrame(K - 1).FunctionName));
+      if (!FS)
+        continue;
+      LineLocation Loc = getLineLocation(Frames.getFrame(0));
+      ErrorOr<uint64_t> Count = FS->findSamplesAt(Loc.LineOffset, Loc.Discriminator);
+      if (!Count || !*Count)
+        continue;
+
+      // The adjacent rows of a count are one record
+      ProfileRecord *Last = Records.empty() ? nullptr : &Records.back();
+      if (Last && Last->To + 1 == Begin && Last->Count == *Count) {
+        Last->To = End - 1;
+      } else {
+        ProfileRecord R;
+        R.From = Begin;
+        R.To = End - 1;
+        R.Count = *Count;
+        R.Sampled = true;
+        Records.push_back(R);
+      }
+
+      // The calls of a location, from its first row
+      if (!CallSites.insert(std::make_tuple(FS, Loc.LineOffset, Loc.Discriminator))
+               .second)
+        continue;
+      ErrorOr<SampleRecord::CallTargetMap> Targets =
+          FS->findCallTargetMapAt(Loc.LineOffset, Loc.Discriminator);
+      if (!Targets)
+        continue;
+      for (const auto &Target : *Targets) {
+        auto It = Symbols.find(getProfileName(Target.first()));
+        if (It == Symbols.end() || !Target.second)
+          continue;
+        ProfileRecord R;
+        R.From = Begin;
+        R.To = It->second;
+        R.Count = Target.second;
+        Calls.push_back(R);
+      }
+    }
+  }
+  if (Records.empty())
+    return createFileError(Path, makeError("no samples of the code of " +
+                                           Obj.getFileName()));
+  Records.insert(Records.end(), Calls.begin(), Calls.end());
+  return Records;
+}
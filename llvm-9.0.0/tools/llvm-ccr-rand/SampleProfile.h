@@ -0,0 +1,45 @@
+//===- SampleProfile.h - Sample profiles for the layout ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: An AutoFDO/llvm-profdata sample profile (-sample-profile) counts the
+// samples by function name and line location (the line offset from the start
+// of the function and the discriminator), as the compiler would apply it
+// with -fprofile-sample-use. The binary need not have been built with it: its
+// DWARF maps every line-table row to the location in the profile, through
+// the inlined functions at the row, and the rows become the records of the
+// layout profile (see ProfileRecord):
+//
+// - the code of a row is sampled as many times as its location, and
+// - the calls at a location go to the function symbols of their targets.
+//
+// The Randomizer infers the edges between the BBLs from their sample counts
+// (see Randomizer::setLayoutProfile()).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_SAMPLEPROFILE_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_SAMPLEPROFILE_H
+
+#include "Randomizer.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Error.h"
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+
+/// Read the sample profile at \p Path (in any format of SampleProfileReader)
+/// into the records of the layout profile of \p Obj, by its DWARF.
+Expected<std::vector<ProfileRecord>>
+readSampleProfile(StringRef Path, const object::ObjectFile &Obj);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_SAMPLEPROFILE_H
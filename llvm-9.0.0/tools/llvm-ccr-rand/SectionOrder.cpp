@@ -0,0 +1,110 @@
+//===- SectionOrder.cpp - Seeded section order for the linker -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SectionOrder.h"
+#include "RandInfo.h"
+#include "RandomStream.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Object/Decompressor.h"
+#include "llvm/Object/RandChunk.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::object;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+// Add the code sections of \p Code that the chunks of \p Rand list to their
+// classes; only the named ones (.text.<function>) can be told apart by gold
+static Error collectSections(const SectionRef &Rand, const StringSet<> &Code,
+                             bool SectionClasses, StringSet<> &Seen,
+                             std::vector<std::string> *Classes) {
+  Expected<StringRef> Contents = Rand.getContents();
+  if (!Contents)
+    return Contents.takeError();
+  ArrayRef<uint8_t> Data = arrayRefFromStringRef(*Contents);
+  SmallString<0> Decompressed;
+  if (ELFSectionRef(Rand).getFlags() & ELF::SHF_COMPRESSED) {
+    Expected<Decompressor> D = Decompressor::create(
+        ".rand", *Contents, /*IsLE=*/true, /*Is64Bit=*/true);
+    if (!D)
+      return D.takeError();
+    if (Error E = D->resizeAndDecompress(Decompressed))
+      return E;
+    Data = arrayRefFromStringRef(Decompressed);
+  }
+  if (!isRandChunked(Data))
+    return makeError("The .rand section lists no input sections (it takes "
+                     "-ccr-rand-format=3)");
+
+  Expected<std::vector<RandChunkRef>> ChunksOrErr = readRandChunks(Data);
+  if (!ChunksOrErr)
+    return ChunksOrErr.takeError();
+  for (const RandChunkRef &Chunk : *ChunksOrErr)
+    for (const ChunkSection &S : Chunk.getSections()) {
+      StringRef Name = Chunk.getSectionName(S);
+      if (!Name.startswith(".text.") || !Code.count(Name) ||
+          !Seen.insert(Name).second)
+        continue;
+      Classes[SectionClasses ? getSectionClass(Name) : SC_Text].push_back(Name);
+    }
+  return Error::success();
+}
+
+Expected<unsigned>
+llvm::ccr::writeSectionOrder(ArrayRef<const ELF64LEObjectFile *> Objects,
+                             uint64_t Seed, bool SectionClasses,
+                             raw_ostream &OS) {
+  std::vector<std::string> Classes[NumSectionClasses];
+  StringSet<> Seen;
+  for (const ELF64LEObjectFile *Obj : Objects) {
+    if (Obj->getELFFile()->getHeader()->e_type != ELF::ET_REL)
+      return createFileError(Obj->getFileName(),
+                             makeError("Not a relocatable object"));
+    // The chunks name the sections without telling code from data
+    StringSet<> Code;
+    std::vector<SectionRef> Rands;
+    for (const SectionRef &Sec : Obj->sections()) {
+      StringRef Name;
+      if (Sec.getName(Name))
+        continue;
+      if (Name == ".rand")
+        Rands.push_back(Sec);
+      else if (ELFSectionRef(Sec).getFlags() & ELF::SHF_EXECINSTR)
+        Code.insert(Name);
+    }
+    if (Rands.empty())
+      return createFileError(
+          Obj->getFileName(),
+          makeError("No .rand section: not built by the CCR toolchain"));
+    for (const SectionRef &Rand : Rands)
+      if (Error E =
+              collectSections(Rand, Code, SectionClasses, Seen, Classes))
+        return createFileError(Obj->getFileName(), std::move(E));
+  }
+
+  unsigned NumSections = 0;
+  for (unsigned C = 0; C < NumSectionClasses; ++C) {
+    std::vector<std::string> &Names = Classes[C];
+    llvm::sort(Names);
+    RandomStream RS(Seed, RandomStream::sectionStream(C));
+    shuffle(Names.begin(), Names.end(), RS);
+    for (const std::string &Name : Names)
+      OS << Name << '\n';
+    NumSections += Names.size();
+  }
+  return NumSections;
+}
@@ -0,0 +1,45 @@
+//===- SectionOrder.h - Seeded section order for the linker ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: With -ffunction-sections, every function is an input section of its
+// own, thus the linker can shuffle the functions by itself: -section-order
+// permutes the code sections that the .rand chunks of the objects of a link
+// list, and writes them as a --section-ordering-file for gold, which lays out
+// .text in that order and resolves every reference as in any other link.
+// No fixup is patched after the link, and the .rand sections merge as usual
+// for the randomizer to shuffle the BBLs later on, if at all.
+//
+// The names are sorted before they are shuffled, thus a seed yields the same
+// order whatever the order of the objects on the command line.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_SECTIONORDER_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_SECTIONORDER_H
+
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace ccr {
+
+/// Write the .text.* input sections of the relocatable \p Objects (built
+/// with -ffunction-sections and -ccr-rand-format=3) to \p OS, one name per
+/// line, in a random order of \p Seed. With \p SectionClasses, the hot,
+/// unlikely, startup and exit sections are permuted within their own classes.
+/// A name that several objects share is listed once. Returns the number of
+/// sections written.
+Expected<unsigned>
+writeSectionOrder(ArrayRef<const object::ELF64LEObjectFile *> Objects,
+                  uint64_t Seed, bool SectionClasses, raw_ostream &OS);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_SECTIONORDER_H
@@ -0,0 +1,199 @@
+//===- Server.cpp - The randomizer as a long-running service --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Server.h"
+#include "RandIndex.h"
+#include "RandSidecar.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ThreadPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifdef LLVM_ON_UNIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::object;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+MetadataCache::MetadataCache(unsigned Capacity)
+    : Capacity(std::max(1U, Capacity)) {}
+
+Expected<std::shared_ptr<const RandInfo>>
+MetadataCache::get(const ELF64LEObjectFile &Obj, ArrayRef<uint8_t> Sidecar) {
+  ArrayRef<uint8_t> Rand = Sidecar;
+  bool Compressed = false;
+  for (const SectionRef &Sec : Obj.sections()) {
+    StringRef Name;
+    if (Sec.getName(Name) || Name != ".rand")
+      continue;
+    Expected<StringRef> Contents = Sec.getContents();
+    if (!Contents)
+      return Contents.takeError();
+    Rand = arrayRefFromStringRef(*Contents);
+    Compressed = ELFSectionRef(Sec).getFlags() & ELF::SHF_COMPRESSED;
+    break;
+  }
+  if (Rand.empty())
+    return makeError("No .rand section; the binary has not been built with CCR");
+
+  // Hashing .rand is far cheaper than inflating and decoding it
+  std::string Key = toHex(getBuildID(Obj), /*LowerCase=*/true) + "-" +
+                    utohexstr(getRandIndexKey(Rand));
+  auto Find = [&] {
+    return find_if(Entries, [&](const Entry &E) { return E.Key == Key; });
+  };
+  {
+    std::unique_lock<std::mutex> Guard(Lock);
+    for (auto I = Find(); I != Entries.end(); I = Find()) {
+      if (I->Info) {
+        Entries.splice(Entries.begin(), Entries, I);
+        ++Hits;
+        return Entries.front().Info;
+      }
+      // Being decoded for another request (e.g., another variant of the binary)
+      Decoded.wait(Guard);
+    }
+    ++Misses;
+    Entries.push_front({Key, nullptr});
+  }
+
+  Expected<RandInfo> InfoOrErr = parseRandInfo(".rand", Rand, Compressed);
+  std::shared_ptr<const RandInfo> Info;
+  if (InfoOrErr) {
+    computeFixupOwners(*InfoOrErr);
+    Info = std::make_shared<const RandInfo>(std::move(*InfoOrErr));
+  }
+
+  // A request waiting for a failed decoding decodes (and fails) by itself
+  std::lock_guard<std::mutex> Guard(Lock);
+  auto I = Find();
+  if (I != Entries.end()) {
+    if (Info)
+      I->Info = Info;
+    else
+      Entries.erase(I);
+  }
+  // An entry still being decoded stays, however full the cache
+  if (Entries.size() > Capacity && Entries.back().Info)
+    Entries.pop_back();
+  Decoded.notify_all();
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  return Info;
+}
+
+#ifdef LLVM_ON_UNIX
+static std::error_code getErrno() {
+  return std::error_code(errno, std::generic_category());
+}
+
+// A request is the first line a client sends
+static bool readRequest(int FD, std::string &Line) {
+  char Buf[512];
+  for (;;) {
+    ssize_t N = ::read(FD, Buf, sizeof(Buf));
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      return !Line.empty();
+    const char *NewLine = static_cast<const char *>(memchr(Buf, '\n', N));
+    Line.append(Buf, NewLine ? NewLine - Buf : N);
+    if (NewLine)
+      return true;
+    if (Line.size() > 16 * 1024)
+      return false;
+  }
+}
+
+static void writeReply(int FD, StringRef Reply) {
+  while (!Reply.empty()) {
+    ssize_t N = ::write(FD, Reply.data(), Reply.size());
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      return; // The client has gone away
+    Reply = Reply.drop_front(N);
+  }
+}
+#endif
+
+Error llvm::ccr::serveRequests(StringRef SocketPath, unsigned NumThreads,
+                               std::function<Error(StringRef)> Handle) {
+#ifndef LLVM_ON_UNIX
+  return makeError("-serve requires Unix domain sockets");
+#else
+  sockaddr_un Addr;
+  memset(&Addr, 0, sizeof(Addr));
+  if (SocketPath.size() >= sizeof(Addr.sun_path))
+    return makeError("The socket path " + SocketPath + " is too long");
+  Addr.sun_family = AF_UNIX;
+  memcpy(Addr.sun_path, SocketPath.data(), SocketPath.size());
+
+  int Listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (Listener < 0)
+    return createFileError(SocketPath, getErrno());
+  auto CloseListener = make_scope_exit([&] { ::close(Listener); });
+  sys::fs::remove(SocketPath);
+  if (::bind(Listener, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)))
+    return createFileError(SocketPath, getErrno());
+  auto RemoveSocket = make_scope_exit([&] { sys::fs::remove(SocketPath); });
+  // A client names the files the service reads and writes on its behalf
+  if (std::error_code EC = sys::fs::setPermissions(
+          SocketPath, sys::fs::owner_read | sys::fs::owner_write))
+    return createFileError(SocketPath, EC);
+  if (::listen(Listener, SOMAXCONN))
+    return createFileError(SocketPath, getErrno());
+
+  ThreadPool Pool(std::max(1U, NumThreads));
+  for (;;) {
+    int FD = ::accept(Listener, nullptr, nullptr);
+    if (FD < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      std::error_code EC = getErrno();
+      Pool.wait();
+      return createFileError(SocketPath, EC);
+    }
+    std::string Line;
+    if (!readRequest(FD, Line)) {
+      ::close(FD);
+      continue;
+    }
+    StringRef Request = StringRef(Line).trim();
+    if (Request == "shutdown") {
+      Pool.wait();
+      writeReply(FD, "ok\n");
+      ::close(FD);
+      return Error::success();
+    }
+    Pool.async([&Handle, FD, Line] {
+      Error E = Handle(StringRef(Line).trim());
+      std::string Reply = "ok\n";
+      if (E) {
+        Reply = "error " + toString(std::move(E));
+        std::replace(Reply.begin(), Reply.end(), '\n', ' ');
+        Reply += '\n';
+      }
+      writeReply(FD, Reply);
+      ::close(FD);
+    });
+  }
+#endif
+}
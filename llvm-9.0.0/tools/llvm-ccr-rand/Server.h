@@ -0,0 +1,77 @@
+//===- Server.h - The randomizer as a long-running service ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: A host that starts many short-lived containers from the same images
+// randomizes the same binaries over and over, and each invocation of the tool
+// would decode the same .rand sections again. With -serve=<socket>, the tool
+// stays up and takes the requests over a Unix socket instead, one per
+// connection: a line '<input> <output> [<seed>]' is answered by 'ok' or
+// 'error <message>' once the output stands (the line 'shutdown' stops the
+// service). The decoded .rand of the binaries seen recently is kept by their
+// build IDs and the keys of their .rand sections (see RandIndex.h), thus a
+// request costs the copy, the permutation and the patching only.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_SERVER_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_SERVER_H
+
+#include "RandInfo.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/Error.h"
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace ccr {
+
+/// The decoded .rand sections of the binaries randomized recently; beyond
+/// its capacity, the least recently used one is dropped. Thread-safe.
+class MetadataCache {
+  struct Entry {
+    std::string Key; // Build ID and .rand key
+    std::shared_ptr<const RandInfo> Info; // Null while being decoded
+  };
+
+  std::mutex Lock;
+  std::condition_variable Decoded;
+  std::list<Entry> Entries; // The most recently used first
+  unsigned Capacity;
+  unsigned Hits = 0;
+  unsigned Misses = 0;
+
+public:
+  explicit MetadataCache(unsigned Capacity);
+
+  /// The decoded .rand of \p Obj (or \p Sidecar, if it has been stripped of
+  /// it, see RandSidecar.h), with the fixup owners computed; decoded and
+  /// kept on a miss. The concurrent requests for a binary being decoded wait
+  /// for it rather than decoding it again.
+  Expected<std::shared_ptr<const RandInfo>>
+  get(const object::ELF64LEObjectFile &Obj, ArrayRef<uint8_t> Sidecar);
+
+  unsigned getHits() const { return Hits; }
+  unsigned getMisses() const { return Misses; }
+};
+
+/// Listen on the Unix socket \p SocketPath (replacing a stale one, and left
+/// to its owner only) and hand every request line to \p Handle on a pool of
+/// \p NumThreads threads, until a 'shutdown' request.
+Error serveRequests(StringRef SocketPath, unsigned NumThreads,
+                    std::function<Error(StringRef)> Handle);
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_SERVER_H
@@ -0,0 +1,34 @@
+//===- TranslationMap.cpp - Old-to-new offset translation -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TranslationMap.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+TranslationMap::TranslationMap(ArrayRef<uint64_t> BBLStarts, uint64_t RangeEnd)
+    : Starts(BBLStarts.begin(), BBLStarts.end()), Deltas(BBLStarts.size(), 0) {
+  assert(std::is_sorted(Starts.begin(), Starts.end()) && "Unsorted BBLs!");
+  if (Starts.empty())
+    return;
+  Begin = Starts.front();
+  End = RangeEnd;
+  if (End <= Begin)
+    return;
+
+  size_t NumPages = ((End - Begin - 1) >> PageShift) + 1;
+  PageIndex.resize(NumPages);
+  size_t Idx = 0;
+  for (size_t Page = 0; Page != NumPages; ++Page) {
+    uint64_t PageStart = Begin + ((uint64_t)Page << PageShift);
+    while (Idx + 1 < Starts.size() && Starts[Idx + 1] <= PageStart)
+      ++Idx;
+    PageIndex[Page] = Idx;
+  }
+}
@@ -0,0 +1,87 @@
+//===- TranslationMap.h - Old-to-new offset translation ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Every fixup needs its pre-shuffle target mapped to the post-shuffle
+// one. The map keeps the BBL starts and their displacements in two flat
+// arrays, plus a direct index from each 4KB page of the randomizable range to
+// the first BBL that overlaps it. A lookup is a page index load followed by a
+// branchless binary search over the (few) BBLs of that page.
+//
+// The map only depends on the BBL offsets, thus it can be built from the
+// layout of the .rand section by any consumer (randomizer, verifier, linker).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_CCR_RAND_TRANSLATIONMAP_H
+#define LLVM_TOOLS_LLVM_CCR_RAND_TRANSLATIONMAP_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+
+class TranslationMap {
+  uint64_t Begin = 0, End = 0;
+  std::vector<uint64_t> Starts;    // Old start offsets of the BBLs, sorted
+  std::vector<int64_t> Deltas;     // New minus old offset of each BBL
+  std::vector<uint32_t> PageIndex; // Last BBL starting at or before each page
+
+public:
+  static const unsigned PageShift = 12;
+
+  TranslationMap() = default;
+
+  /// Build the map for contiguous BBLs at \p BBLStarts (ascending) that end
+  /// at \p RangeEnd. All BBLs stay in place until setNewOffset() is called.
+  TranslationMap(ArrayRef<uint64_t> BBLStarts, uint64_t RangeEnd);
+
+  void setNewOffset(unsigned Idx, uint64_t NewOffset) {
+    Deltas[Idx] = (int64_t)(NewOffset - Starts[Idx]);
+  }
+
+  size_t size() const { return Starts.size(); }
+  uint64_t getBegin() const { return Begin; }
+  uint64_t getEnd() const { return End; }
+
+  bool contains(uint64_t Offset) const {
+    return Offset >= Begin && Offset < End;
+  }
+
+  /// Index of the BBL that contains \p Offset, or -1 if outside the range.
+  int lookup(uint64_t Offset) const {
+    if (!contains(Offset))
+      return -1;
+    size_t Page = (Offset - Begin) >> PageShift;
+    size_t Lo = PageIndex[Page];
+    size_t Hi = Page + 1 < PageIndex.size() ? PageIndex[Page + 1] : size() - 1;
+
+    // The last start <= Offset within [Lo, Hi]; Starts[Lo] <= Offset holds
+    const uint64_t *Base = Starts.data() + Lo;
+    for (size_t N = Hi - Lo + 1; N > 1;) {
+      size_t Half = N / 2;
+      Base = Base[Half] <= Offset ? Base + Half : Base;
+      N -= Half;
+    }
+    return Base - Starts.data();
+  }
+
+  /// Translate an old offset into the new one; offsets outside the range
+  /// are not moved.
+  uint64_t translate(uint64_t Offset) const {
+    int Idx = lookup(Offset);
+    return Idx < 0 ? Offset : Offset + Deltas[Idx];
+  }
+};
+
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_CCR_RAND_TRANSLATIONMAP_H
@@ -0,0 +1,314 @@
+//===- Verifier.cpp - Cross-check .rand against a CCR binary --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: Bad metadata only shows up once the binary has been randomized, i.e.,
+// as a crash on the host it is deployed to. The verifier (-verify) decodes
+// the layout and the fixups as the randomizer does and checks them against
+// the code: the BBLs must be tiled by whole instructions, every .text fixup
+// must lie within one instruction of its BBL, PC-relative fixups must end
+// their instructions (or at least resolve within the same BBL as their real
+// targets), and the jump tables must hold as many entries as recorded, each
+// pointing at a BBL of the same function. Functions are checked in parallel.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CodeDecoder.h"
+#include "Randomizer.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::support;
+
+static Error makeError(const Twine &Msg) {
+  return make_error<StringError>("[CCR-Error] " + Msg, inconvertibleErrorCode());
+}
+
+namespace {
+struct VerifierStats {
+  std::atomic<uint64_t> NumInsts{0};
+  std::atomic<uint64_t> NumFixups{0};
+  std::atomic<uint64_t> NumJumpTables{0};
+  std::atomic<uint64_t> NumJTEntries{0};
+};
+} // end anonymous namespace
+
+Error Randomizer::verify() {
+  if (Error E = readSections())
+    return E;
+  if (Error E = loadRandInfo())
+    return E;
+
+  std::string Err;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Err);
+  if (!T)
+    return makeError("Cannot verify without the X86 disassembler: " + Err);
+
+  L = llvm::make_unique<ccr::Layout>(Info, /*ShuffleBBLs=*/false,
+                                     /*HotColdBuckets=*/false);
+  ArrayRef<BasicBlock> BBLs = L->basicBlocks();
+  ArrayRef<ccr::Function> Funcs = L->functions();
+  ArrayRef<FixupInfo> Fixups = Info.Fixups[FK_Text];
+  const uint8_t *Code = getContents(*Text);
+  std::vector<std::string> Problems; // Of the layout as a whole
+
+  uint64_t Total = 0;
+  for (const BasicBlockInfo &BBL : Info.BasicBlocks)
+    Total += BBL.Size;
+  if (Total != Info.ObjSize)
+    Problems.push_back("The BBL sizes add up to " + utostr(Total) +
+                       " bytes instead of " + utostr(Info.ObjSize));
+
+  // The fixups of every function are the run of ByOffset in its range
+  std::vector<unsigned> ByOffset(Fixups.size());
+  std::iota(ByOffset.begin(), ByOffset.end(), 0);
+  llvm::sort(ByOffset, [&](unsigned A, unsigned B) {
+    return Fixups[A].Offset < Fixups[B].Offset;
+  });
+  for (unsigned I : ByOffset)
+    if (Fixups[I].OwnerBBL < 0)
+      Problems.push_back("The fixup at " +
+                         utohexstr(Text->Addr + Fixups[I].Offset) +
+                         " is outside of the BBLs in .rand");
+
+  auto isCodeAddress = [&](uint64_t Addr) {
+    for (const Section &Sec : Sections)
+      if ((Sec.Flags & ELF::SHF_EXECINSTR) && Addr >= Sec.Addr &&
+          Addr < Sec.Addr + Sec.Size)
+        return true;
+    return false;
+  };
+  // Index of the BBL that starts at the .text address Addr, or -1
+  auto findBBLStart = [&](uint64_t Addr) {
+    if (Addr < Text->Addr)
+      return -1;
+    int Idx = L->findBasicBlock(Addr - Text->Addr);
+    return Idx >= 0 && BBLs[Idx].OldOffset == Addr - Text->Addr ? Idx : -1;
+  };
+
+  VerifierStats Stats;
+  std::vector<std::vector<std::string>> FuncProblems(Funcs.size());
+  auto verifyFunction = [&](const CodeDecoder &Decoder, unsigned FuncIdx) {
+    const ccr::Function &Fn = Funcs[FuncIdx];
+    std::vector<std::string> &Out = FuncProblems[FuncIdx];
+    const BasicBlock &First = BBLs[Fn.FirstBBL];
+    const BasicBlock &Last = BBLs[Fn.FirstBBL + Fn.NumBBLs - 1];
+    uint64_t Begin = First.OldOffset, End = Last.OldOffset + Last.Size;
+
+    // A standalone assembly object moves as a whole, thus its BBLs need not
+    // be made of whole instructions (it may well hold data); neither do the
+    // inputs without .rand
+    uint32_t SourceType = L->objects()[Fn.Object].SourceType;
+    bool Decode = SourceType != SRC_Asm && SourceType != SRC_Foreign;
+    std::vector<uint64_t> Insts; // Offsets of the instructions, then End
+    for (unsigned I = Fn.FirstBBL; Decode && I != Fn.FirstBBL + Fn.NumBBLs;
+         ++I) {
+      const BasicBlock &BBL = BBLs[I];
+      uint64_t Off = BBL.OldOffset, BBLEnd = BBL.OldOffset + BBL.Size;
+      while (Off < BBLEnd) {
+        MCInst Inst;
+        uint64_t Size = Decoder.decode(
+            makeArrayRef(Code + Off, Text->Size - Off), Text->Addr + Off, Inst);
+        if (!Size) {
+          Out.push_back("Cannot decode the instruction at " +
+                        utohexstr(Text->Addr + Off));
+          Decode = false;
+          break;
+        }
+        if (Off + Size > BBLEnd) {
+          Out.push_back("The instruction at " + utohexstr(Text->Addr + Off) +
+                        " crosses the end of its BBL at " +
+                        utohexstr(Text->Addr + BBLEnd));
+          Decode = false;
+          break;
+        }
+        Insts.push_back(Off);
+        Off += Size;
+      }
+    }
+    Insts.push_back(End);
+    Stats.NumInsts += Insts.size() - 1;
+
+    auto FI = std::lower_bound(
+        ByOffset.begin(), ByOffset.end(), Begin,
+        [&](unsigned I, uint64_t Off) { return Fixups[I].Offset < Off; });
+    for (; FI != ByOffset.end() && Fixups[*FI].Offset < End; ++FI) {
+      const FixupInfo &F = Fixups[*FI];
+      uint64_t Addr = Text->Addr + F.Offset;
+      uint64_t FixupEnd = F.Offset + F.DerefSize;
+      Stats.NumFixups++;
+      if (F.OwnerBBL < 0)
+        continue;
+      const BasicBlock &Owner = BBLs[F.OwnerBBL];
+      if (FixupEnd > Owner.OldOffset + Owner.Size) {
+        Out.push_back("The fixup at " + utohexstr(Addr) +
+                      " crosses the end of its BBL");
+        continue;
+      }
+
+      const uint8_t *P = Code + F.Offset;
+      int64_t V = F.DerefSize == 8 ? (int64_t)endian::read64le(P)
+                  : F.DerefSize == 4 ? (int64_t)(int32_t)endian::read32le(P)
+                  : F.DerefSize == 2 ? (int64_t)(int16_t)endian::read16le(P)
+                                     : (int64_t)(int8_t)*P;
+      uint64_t InstEnd = FixupEnd;
+      if (Decode) {
+        // The instruction that holds the first byte of the fixup
+        auto II = std::upper_bound(Insts.begin(), Insts.end(), F.Offset) - 1;
+        uint64_t InstOff = *II;
+        InstEnd = *(II + 1);
+        if (FixupEnd > InstEnd) {
+          Out.push_back("The fixup at " + utohexstr(Addr) +
+                        " is not within one instruction");
+          continue;
+        }
+        if (F.isRelaxable() &&
+            (InstEnd != FixupEnd || InstEnd - InstOff != F.RelaxShortSize))
+          Out.push_back("The relaxable branch at " + utohexstr(Addr) +
+                        " is not a " + utostr(F.RelaxShortSize) +
+                        "-byte instruction");
+        if (F.isShrinkable() &&
+            (InstEnd != FixupEnd || InstEnd - InstOff != F.ShrinkLongSize))
+          Out.push_back("The shrinkable branch at " + utohexstr(Addr) +
+                        " is not a " + utostr(F.ShrinkLongSize) +
+                        "-byte instruction");
+
+        // A direct branch or call takes its displacement last
+        MCInst Inst;
+        uint64_t Target;
+        if (F.IsRela &&
+            Decoder.decode(makeArrayRef(Code + InstOff, InstEnd - InstOff),
+                           Text->Addr + InstOff, Inst) &&
+            Decoder.evaluateBranch(Inst, Text->Addr + InstOff,
+                                   InstEnd - InstOff, Target) &&
+            (InstEnd != FixupEnd || Target != Text->Addr + FixupEnd + V))
+          Out.push_back("The fixup at " + utohexstr(Addr) +
+                        " is not the displacement of its branch");
+      }
+
+      // The randomizer resolves a PC-relative fixup from its own end, which
+      // is only sound if that lands in the same BBL as the real target
+      if (F.IsRela && F.RefClass != FRC_TLS) {
+        uint64_t Assumed = Text->Addr + FixupEnd + V;
+        uint64_t Real = Text->Addr + InstEnd + V;
+        auto findBBL = [&](uint64_t A) {
+          return A < Text->Addr ? -1 : L->findBasicBlock(A - Text->Addr);
+        };
+        if (Real != Assumed && findBBL(Real) != findBBL(Assumed))
+          Out.push_back("The target of the fixup at " + utohexstr(Addr) +
+                        " would be mis-translated (" + utohexstr(Real) +
+                        " resolves as " + utohexstr(Assumed) + ")");
+        if (F.RefClass == FRC_Direct && F.Target == FT_Code &&
+            !isCodeAddress(Real))
+          Out.push_back("The fixup at " + utohexstr(Addr) +
+                        " refers to code at " + utohexstr(Real) +
+                        ", which is not executable");
+        else if (F.RefClass == FRC_Direct && F.Target == FT_Data &&
+                 Real >= Text->Addr && L->contains(Real - Text->Addr))
+          Out.push_back("The fixup at " + utohexstr(Addr) +
+                        " refers to data at " + utohexstr(Real) +
+                        ", which is within the BBLs");
+      }
+
+      if (!F.NumJTEntries)
+        continue;
+      // The jump table: relative entries (4 bytes), or absolute ones (8 bytes)
+      // unless they are left to the dynamic relocations of a PIC binary
+      Stats.NumJumpTables++;
+      Stats.NumJTEntries += F.NumJTEntries;
+      if (F.JTEntrySize != 4 && F.JTEntrySize != 8) {
+        Out.push_back("The jump table of the fixup at " + utohexstr(Addr) +
+                      " has " + utostr(F.JTEntrySize) + "-byte entries");
+        continue;
+      }
+      uint64_t Base = F.IsRela ? Text->Addr + FixupEnd + V : (uint64_t)V;
+      uint64_t Size = (uint64_t)F.NumJTEntries * F.JTEntrySize;
+      const Section *JTSec = nullptr;
+      for (const Section &Sec : Sections)
+        if ((Sec.Flags & ELF::SHF_ALLOC) && Sec.Type != ELF::SHT_NOBITS &&
+            Base >= Sec.Addr && Base + Size <= Sec.Addr + Sec.Size)
+          JTSec = &Sec;
+      if (!JTSec) {
+        Out.push_back("The jump table of the fixup at " + utohexstr(Addr) +
+                      " (" + utostr(F.NumJTEntries) + " entries at " +
+                      utohexstr(Base) + ") is out of the sections");
+        continue;
+      }
+      if (F.JTEntrySize == 8 && isPIC())
+        continue;
+      const uint8_t *Entries = Image.data() + JTSec->Offset + (Base - JTSec->Addr);
+      // Relative entries are offsets from the table, or from the function
+      uint64_t EntryBase = F.JTFunctionRelative ? Text->Addr + Begin : Base;
+      for (unsigned I = 0; I < F.NumJTEntries; ++I) {
+        uint64_t Dest =
+            F.JTEntrySize == 4
+                ? EntryBase + (int64_t)(int32_t)endian::read32le(Entries + I * 4)
+                : endian::read64le(Entries + I * 8);
+        int Idx = findBBLStart(Dest);
+        if (Idx < 0 || BBLs[Idx].Function != FuncIdx) {
+          Out.push_back("Entry " + utostr(I) + " of the jump table at " +
+                        utohexstr(Base) + " (" + utostr(F.NumJTEntries) +
+                        " entries) is not a BBL of its function");
+          break;
+        }
+      }
+    }
+  };
+
+  // Chunks of functions, each with its own decoder
+  const size_t ChunkSize = 512;
+  size_t NumChunks = (Funcs.size() + ChunkSize - 1) / ChunkSize;
+  std::atomic<bool> NoDecoder{false};
+  auto RunChunk = [&](size_t Chunk) {
+    CodeDecoder Decoder;
+    if (!Decoder.init(*T)) {
+      NoDecoder = true;
+      return;
+    }
+    for (size_t I = Chunk * ChunkSize,
+                E = std::min(Funcs.size(), I + ChunkSize);
+         I != E; ++I)
+      verifyFunction(Decoder, I);
+  };
+  if (Config.Parallel && NumChunks > 1)
+    parallel::for_each_n(parallel::par, (size_t)0, NumChunks, RunChunk);
+  else
+    for (size_t Chunk = 0; Chunk != NumChunks; ++Chunk)
+      RunChunk(Chunk);
+  if (NoDecoder)
+    return makeError("Cannot set up the X86 disassembler");
+
+  for (std::vector<std::string> &P : FuncProblems)
+    Problems.insert(Problems.end(), std::make_move_iterator(P.begin()),
+                    std::make_move_iterator(P.end()));
+
+  if (Config.Verbose)
+    outs() << "Verified " << Funcs.size() << " functions ("
+           << BBLs.size() << " BBLs, " << Stats.NumInsts
+           << " instructions), " << Stats.NumFixups << " .text fixups, "
+           << Stats.NumJumpTables << " jump tables (" << Stats.NumJTEntries
+           << " entries)\n";
+  if (Problems.empty())
+    return Error::success();
+
+  // The problems are listed in the order of the layout, whatever the
+  // scheduling was
+  const size_t MaxReported = 20;
+  for (size_t I = 0, E = std::min(Problems.size(), MaxReported); I != E; ++I)
+    WithColor::error() << Problems[I] << "\n";
+  return makeError(Twine(Problems.size()) +
+                   " inconsistencies between .rand and the binary");
+}
@@ -0,0 +1,1830 @@
+//===- llvm-ccr-rand.cpp - Randomize a CCR-annotated binary ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: llvm-ccr-rand is the native counterpart of the python randomizer
+// (prander). It reads the reordering information (.rand) of a binary linked
+// by the CCR toolchain, shuffles the functions (and optionally the BBLs) of
+// .text and writes a new binary with all references fixed up.
+//
+// The randomizer patches the binary within a read-write mapping of its
+// output: the input is copied by the kernel (copy_file_range, or a reflink),
+// so only the pages of .text and of the sections with fixups are touched,
+// and the peak RSS stays close to the size of .text. With -in-place the
+// input file itself is mapped and rewritten.
+//
+// Many binaries (i.e., a package with its shared objects) can be randomized
+// in one invocation, given on the command line or in a -manifest; they are
+// scheduled on a thread pool within an optional -max-memory budget. With
+// -pipeline, the reads of the inputs run ahead of the randomization and the
+// writes of the outputs behind it, on threads of their own, while the images
+// in flight fit into -pipeline-memory: on network storage, a batch takes
+// about the longer of its I/O and its CPU time rather than their sum.
+//
+// With -address-map, a sidecar <output>.ccrmap maps the randomized addresses
+// back to the original ones, for which the debug information stays valid
+// (see llvm/BinaryFormat/RandMap.h). With -rewrite-debug-info, the DWARF
+// itself is updated instead (see DwarfRewriter.cpp). A binary linked with
+// the layout runtime carries the map in a note for in-process profilers,
+// and the pages of its hot code in another for a readahead at startup
+// (see CCRLayout.h). With -bb-address-map, the output names the new address
+// of every BBL of .rand in a section of its own, from which a profile
+// converter attributes LBR and Intel PT samples to the BBLs; with
+// -synthetic-sites, the code the randomizer inserted is listed likewise,
+// which llvm-symbolizer reports as the overhead of its function.
+//
+// A layout is a function of the .rand section, the layout options and the
+// seed. With -plan-only, the layout is planned (from -index, if any) but no
+// output is written, only <output>.ccrmap: a fleet keeps the seed of every
+// host rather than its map, and a symbolization service regenerates the maps
+// it needs (e.g., -serve requests of '<binary> <host> <seed>') in the time of
+// the planning alone.
+//
+// A long-running host re-randomizes a binary in epochs: -epoch=<n> moves
+// -refresh-percent of the functions of the layout of epoch n-1 (of the same
+// seed), and -update writes only the pages of the output that differ from
+// the layout it holds. The write traffic (and the page cache invalidated)
+// thus follows the entropy refreshed, not the size of the binary.
+//
+// With -cache-dir, an output is kept by the build ID of its input, the hash of
+// the .rand section, the seed and the layout options, and a later identical
+// request hard-links it (see OutputCache.h).
+//
+// Many packages bundle the same shared library. With -share-layouts, the
+// copies of a binary in a batch (by build ID, .rand and options, whatever
+// their paths) draw the same seed: it is randomized once, and the other
+// outputs are hard links to the first one. A consumer binds to a library
+// through its dynamic symbols only, which are patched along, thus the
+// randomized image is all there is to share; no fixups of the consumers refer
+// to the code of the library.
+//
+// With -shuffle-data, the objects of .data and .bss move as well, in
+// affinity groups of whole cache lines rather than one by one, lest data
+// diversity turn into L1d misses: the objects that shared a line still do,
+// and the globals of a set of -data-affinity (those a profile finds accessed
+// together) take adjacent lines (see DataGroups.h). The objects are those of
+// .symtab; every object of .rand has to be built with -ccr-keep-data-fixups
+// (and -ccr-rand-format=3), and the binary linked with --emit-relocs for the
+// code that .rand does not describe. The assembler resolves a difference of
+// two symbols of a section without a fixup, thus such a difference between
+// two groups, or a reference out of the bounds of its object, goes stale.
+//
+// With -section-order, the inputs are the objects of a -ffunction-sections
+// link, whose function sections are written in a seeded order for gold to lay
+// out (see SectionOrder.h): the link randomizes the functions, with nothing
+// left to patch.
+//
+// With -variants=<n>, every binary is randomized into n outputs of different
+// seeds, on the thread pool, reading and decoding its .rand only once.
+//
+// With -verify, the binaries are not randomized: their .rand sections are
+// checked against the code (see Verifier.cpp), which is fast enough to gate
+// every build. With -diff, the .rand sections of two builds of a binary are
+// compared function by function (see RandDiff.h). With -mca-regions, the
+// hot code of every output is also written, in both layouts, for llvm-mca to
+// estimate what the layout costs the hot loops (see MCAExport.cpp).
+//
+// With -optimize-layout, the binary is not randomized but laid out by a perf
+// profile of it, pre-aggregated like the input of BOLT (perf2bolt -pa): the
+// functions by call-chain clustering, and the chains of BBLs by ext-TSP (see
+// LayoutOptimizer.cpp). The .rand section is all the metadata it takes.
+// With -cluster-calls, the callers and callees (of the direct calls in .rand,
+// or of the profile) are clustered alike, and the clusters are randomized.
+// With -sample-profile, an AutoFDO/llvm-profdata sample profile takes the
+// place of the pre-aggregated one (see SampleProfile.h).
+// With -split-functions, the cold chains of the functions (by the profile,
+// if any) move to the end of their segments, under FDEs of their own (see
+// EHFrame.cpp).
+//
+// A binary may ship without its .rand section (llvm-objcopy
+// --strip-ccr-rand): -rand-dir and -rand-server find the sidecar that
+// --extract-ccr-rand wrote by its build ID instead (see RandSidecar.h).
+//
+// With -serve=<socket>, the tool stays up and randomizes the requests of a
+// container runtime, keeping the decoded .rand of the binaries it has seen
+// (see Server.h).
+//
+// With -canonicalize-profile, the inputs are profiles collected on randomized
+// hosts (perf script output, pre-aggregated or unsymbolized text profiles),
+// rewritten into the original layout by the -rand-map of their hosts, thus
+// the profiles of a fleet merge (see ProfileCanonicalizer.h).
+//
+//===----------------------------------------------------------------------===//
+
+#include "OutputCache.h"
+#include "ProfileCanonicalizer.h"
+#include "RandDiff.h"
+#include "RandSidecar.h"
+#include "Randomizer.h"
+#include "SampleProfile.h"
+#include "SectionOrder.h"
+#include "Server.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Object/Binary.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::object;
+
+// The name this program was invoked as.
+static StringRef ToolName;
+
+LLVM_ATTRIBUTE_NORETURN static void error(Twine Message) {
+  WithColor::error(errs(), ToolName) << Message << ".\n";
+  errs().flush();
+  exit(1);
+}
+
+LLVM_ATTRIBUTE_NORETURN static void reportError(StringRef File,
+                                                std::error_code EC) {
+  assert(EC);
+  error("'" + File + "': " + EC.message());
+}
+
+LLVM_ATTRIBUTE_NORETURN static void error(Error E) {
+  assert(E);
+  logAllUnhandledErrors(std::move(E), WithColor::error(errs(), ToolName));
+  exit(1);
+}
+
+static cl::OptionCategory RandCategory("llvm-ccr-rand Options");
+
+static cl::list<std::string> InputFilenames(cl::Positional, cl::ZeroOrMore,
+                                            cl::desc("<input binaries>"),
+                                            cl::cat(RandCategory));
+
+static cl::opt<std::string> OutputFilename("o", cl::desc("Output binary"),
+                                           cl::value_desc("filename"),
+                                           cl::cat(RandCategory));
+
+static cl::opt<std::string> ManifestFilename(
+    "manifest",
+    cl::desc("Randomize the binaries listed in <file>, one '<input> "
+             "[<output> [<map>]]' per line"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<unsigned> Variants(
+    "variants",
+    cl::desc("Write <n> randomized variants of every input, to "
+             "<output>.0 ... <output>.<n-1>, of consecutive seeds from that "
+             "of the input; the .rand section is decoded once for all of them"),
+    cl::value_desc("n"), cl::init(1), cl::cat(RandCategory));
+
+static cl::opt<unsigned> Jobs("j",
+                              cl::desc("Number of binaries randomized at once "
+                                       "(default: hardware threads)"),
+                              cl::init(0), cl::cat(RandCategory));
+
+static cl::opt<unsigned> MaxMemory(
+    "max-memory",
+    cl::desc("Bound the estimated working set of the concurrent jobs (MB)"),
+    cl::init(0), cl::cat(RandCategory));
+
+static cl::opt<bool> Pipeline(
+    "pipeline",
+    cl::desc("Read, randomize and write the binaries of a batch in overlapped "
+             "stages: the inputs are read into memory ahead of the "
+             "randomization, and the outputs written behind it"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<unsigned> PipelineMemory(
+    "pipeline-memory",
+    cl::desc("Bound the images in flight of -pipeline (MB)"),
+    cl::init(1024), cl::cat(RandCategory));
+
+static cl::opt<unsigned> IOJobs(
+    "io-jobs",
+    cl::desc("Number of inputs read (and of outputs written) at once by "
+             "-pipeline"),
+    cl::init(4), cl::cat(RandCategory));
+
+static cl::opt<uint64_t> Seed("seed",
+                              cl::desc("Seed of the layout randomization "
+                                       "(default: random)"),
+                              cl::cat(RandCategory));
+
+enum GranularityKind { GK_Function, GK_Object };
+
+static cl::opt<GranularityKind> Granularity(
+    "granularity", cl::desc("What the randomization permutes"),
+    cl::init(GK_Function),
+    cl::values(clEnumValN(GK_Function, "function",
+                          "The functions (and the asm objects; default)"),
+               clEnumValN(GK_Object, "object",
+                          "The input objects as they are, relocating only "
+                          "the references across them")),
+    cl::cat(RandCategory));
+
+static cl::opt<bool> ShuffleBBLs(
+    "shuffle-bbls",
+    cl::desc("Shuffle the basic blocks within functions as well (the CFI "
+             "is not updated)"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<unsigned> BBLShufflePercent(
+    "shuffle-bbls-percent",
+    cl::desc("With -shuffle-bbls, permute the fall-through chains of only "
+             "this percentage of the functions (less entropy, more locality)"),
+    cl::init(100), cl::cat(RandCategory));
+
+static cl::opt<bool> HotCold(
+    "hot-cold",
+    cl::desc("Permute hot and cold code (by the profile recorded in .rand) "
+             "within separate buckets, keeping hot code packed"),
+    cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<bool> SectionClasses(
+    "section-classes",
+    cl::desc("Permute the code of .text.hot, .text.unlikely, .text.startup and "
+             ".text.exit input sections only within its own class"),
+    cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<bool> HugePages(
+    "huge-pages",
+    cl::desc("Start the hot code at a 2MB boundary if it then spans fewer "
+             "huge pages, filling the bytes before it with other code"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<uint64_t> ShuffleWindow(
+    "shuffle-window",
+    cl::desc("Permute the functions and BBLs only within windows of this many "
+             "bytes of the old layout (e.g. 4096, or 2097152 for a huge page), "
+             "thus short branches stay short at the cost of entropy "
+             "(default: 0, the whole range)"),
+    cl::init(0), cl::cat(RandCategory));
+
+static cl::opt<double> MaxGrowth(
+    "max-growth",
+    cl::desc("Bound the code growth to this percentage of the randomized "
+             "range, keeping the BBL order of functions beyond it"),
+    cl::init(-1), cl::cat(RandCategory));
+
+static cl::opt<bool> NoHotGrowth(
+    "no-hot-growth",
+    cl::desc("Keep the BBL order of hot functions rather than relax their "
+             "short branches"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> StartupLayout(
+    "startup-layout",
+    cl::desc("Permute the functions of the startup path (the entry point, main, "
+             "the static constructors and their callees) among themselves at "
+             "the beginning of the code, against page faults at cold start"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<unsigned> StartupDepth(
+    "startup-depth",
+    cl::desc("Levels of callees of the startup roots to take along"),
+    cl::init(1), cl::cat(RandCategory));
+
+static cl::opt<std::string> StartupProfile(
+    "startup-profile",
+    cl::desc("Take the functions of the startup path from a file of symbol "
+             "names (one per line) instead; implies -startup-layout"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<bool> ShuffleData(
+    "shuffle-data",
+    cl::desc("Permute the objects of .data and .bss as well, in groups of "
+             "whole cache lines (requires -ccr-keep-data-fixups)"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<std::string> DataAffinity(
+    "data-affinity",
+    cl::desc("Keep the globals of each line of a file (symbol names, "
+             "separated by whitespace) on adjacent cache lines; implies "
+             "-shuffle-data"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<std::string> OptimizeLayout(
+    "optimize-layout",
+    cl::desc("Lay the code out by a pre-aggregated profile of the binary "
+             "(B/F records of perf2bolt -pa) instead of randomizing it"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<std::string> SampleProfile(
+    "sample-profile",
+    cl::desc("Lay the code out by an AutoFDO/llvm-profdata sample profile, "
+             "mapped to the code by the DWARF of the binary, like "
+             "-optimize-layout"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<bool> ClusterCalls(
+    "cluster-calls",
+    cl::desc("Cluster the functions by the static call graph (or the calls of "
+             "-optimize-layout) and permute the clusters, keeping callers on "
+             "the pages of their callees"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> SplitFunctions(
+    "split-functions",
+    cl::desc("Move the cold chains of the functions (by -optimize-layout, or "
+             "by .rand) to the end of their segments"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> PlacementChains(
+    "placement-chains",
+    cl::desc("With -shuffle-bbls, permute the chains that the block placement "
+             "built (if .rand tells them) rather than the fall-through chains, "
+             "keeping the hot paths intact"),
+    cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<bool> Realign(
+    "realign",
+    cl::desc("Re-align the BBLs (loop headers, functions) at their new "
+             "places instead of copying their old padding along"),
+    cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<bool> SlidePadding(
+    "slide-padding",
+    cl::desc("With -realign, start the BBLs before the aligned ones later by a "
+             "random share of the padding between them, and pad with NOPs of "
+             "random lengths"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> PaddingOnly(
+    "padding-only",
+    cl::desc("Keep the order of the functions and BBLs, only sliding them "
+             "within the padding (implies -slide-padding); the layout costs no "
+             "byte or branch"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> PackCold(
+    "pack-cold",
+    cl::desc("With -realign, leave the cold functions (by their hotness or "
+             ".text.unlikely) and the cold parts of split ones unaligned, "
+             "packing them byte to byte"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> EntryTrampolines(
+    "entry-trampolines",
+    cl::desc("Keep a jump to the new place of every exported function of a "
+             "shared object at its old entry, thus .dynsym keeps its values; "
+             "the calls within the object go direct"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<uint64_t> HotRegionSeed(
+    "hot-region-seed",
+    cl::desc("Permute the leading hot functions of every segment by this seed "
+             "instead, within a region of a fixed size reached through a "
+             "table of jumps; the rest of the binary is that of -seed alone, "
+             "thus the variants of other hot-region seeds share its pages"),
+    cl::cat(RandCategory));
+
+static cl::opt<uint64_t> HotRegionBudget(
+    "hot-region-budget",
+    cl::desc("With -hot-region-seed, the bytes of hot code in the regions "
+             "(default: all of it)"),
+    cl::init(0), cl::cat(RandCategory));
+
+static cl::opt<bool> StableLayout(
+    "stable-layout",
+    cl::desc("Place the functions by their identities in .rand (name or "
+             "content hashes) rather than their indices, thus a function keeps "
+             "its place among the others across builds of the same seed and "
+             "the binary deltas stay small"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> StraightenBranches(
+    "straighten-branches",
+    cl::desc("Replace the jumps that land right before their targets with "
+             "NOPs, inverting the conditional branches over them"),
+    cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<bool> ShrinkBranches(
+    "shrink-branches",
+    cl::desc("Re-encode the long branches that the assembler relaxed in their "
+             "short forms where the new layout brings their targets close"),
+    cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<unsigned> TailDupSize(
+    "tail-dup-size",
+    cl::desc("Copy the tails of up to this many bytes (a ret, an epilogue, a "
+             "tail call) over the jumps to them that fit them (0: never)"),
+    cl::init(5), cl::cat(RandCategory));
+
+static cl::opt<bool> InPlace(
+    "in-place",
+    cl::desc("Rewrite the input binary instead of writing a new one (the "
+             "input is left corrupted if the randomization fails)"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> PermuteInPlace(
+    "permute-in-place",
+    cl::desc("Move the BBLs within the mapped .text of the output rather than "
+             "from a copy of it (single-threaded; the old code set aside at "
+             "once is reported with -v)"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<unsigned> Epoch(
+    "epoch",
+    cl::desc("Re-randomization epoch: derive the layout from the one of the "
+             "previous epoch of the seed, moving only -refresh-percent of it"),
+    cl::init(0), cl::cat(RandCategory));
+
+static cl::opt<unsigned> RefreshPercent(
+    "refresh-percent",
+    cl::desc("With -epoch, the percentage of the functions each epoch "
+             "permutes again"),
+    cl::init(10), cl::cat(RandCategory));
+
+static cl::opt<bool> Update(
+    "update",
+    cl::desc("The output holds an earlier layout of the input: rewrite only "
+             "its pages that change (fewest with -realign=false)"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<std::string> IndexFilename(
+    "index",
+    cl::desc("Reuse the pre-analysed .rand index in <file> if it matches the "
+             "binary, or create it"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<std::string> RandDir(
+    "rand-dir",
+    cl::desc("Read the .rand of a binary stripped of it from <dir>/xx/xxx.rand "
+             "by its build ID (llvm-objcopy --extract-ccr-rand)"),
+    cl::value_desc("dir"), cl::cat(RandCategory));
+
+static cl::opt<std::string> RandServer(
+    "rand-server",
+    cl::desc("Fetch a missing .rand sidecar from <url>/xx/xxx.rand (with curl), "
+             "into -rand-dir if set"),
+    cl::value_desc("url"), cl::cat(RandCategory));
+
+static cl::opt<std::string> CacheDir(
+    "cache-dir",
+    cl::desc("Keep the outputs in <dir> by their inputs, seeds and options, "
+             "and hard-link the kept one for an identical request"),
+    cl::value_desc("dir"), cl::cat(RandCategory));
+
+static cl::opt<std::string> CachePolicy(
+    "cache-policy",
+    cl::desc("Pruning policy of -cache-dir (as of the ThinLTO cache)"),
+    cl::value_desc("policy"), cl::cat(RandCategory));
+
+static cl::opt<bool> ShareLayouts(
+    "share-layouts",
+    cl::desc("Randomize every binary of a batch (by build ID and .rand) once, "
+             "linking its other outputs to the first one"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> Threads("threads",
+                             cl::desc("Shuffle and patch in parallel"),
+                             cl::init(true), cl::cat(RandCategory));
+
+static cl::opt<bool> Verify(
+    "verify",
+    cl::desc("Check the .rand section of every binary against its code "
+             "instead of randomizing it"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> Diff(
+    "diff",
+    cl::desc("Compare the .rand sections of two binaries function by function "
+             "instead of randomizing them; exits with 1 if they differ"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> AddressMap(
+    "address-map",
+    cl::desc("Write the address translation map of every output to "
+             "<output>.ccrmap, which llvm-symbolizer and profilers consult"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> PlanOnly(
+    "plan-only",
+    cl::desc("Plan the layout of every output by its seed and write its "
+             "address map (<output>.ccrmap) only, leaving the output "
+             "unwritten"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> RewriteDebugInfo(
+    "rewrite-debug-info",
+    cl::desc("Regenerate the line tables and the address ranges of the DWARF "
+             "for the new layout"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> BBAddrMap(
+    "bb-address-map",
+    cl::desc("Add the address of every BBL to the outputs (a non-allocated "
+             ".ccr_bb_addr_map) for the attribution of LBR and PT samples"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> SyntheticSites(
+    "synthetic-sites",
+    cl::desc("Add the code the randomizer inserted to the outputs (a "
+             "non-allocated .ccr_synthetic_sites) for the attribution of its "
+             "overhead in profiles"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<bool> WriteStats(
+    "layout-stats",
+    cl::desc("Write what the layout of every output bought and cost (entropy, "
+             "growth, hot span) to <output>.ccrstats as JSON"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<std::string> SectionOrder(
+    "section-order",
+    cl::desc("Write the function sections of the input objects in a random "
+             "order instead of randomizing binaries, as a "
+             "--section-ordering-file for gold"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<bool> MCARegions(
+    "mca-regions",
+    cl::desc("Write the hot code of every output, in the old and the new "
+             "layout, to <output>.ccrmca.s as llvm-mca code regions"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<std::string> Serve(
+    "serve",
+    cl::desc("Stay up and randomize the '<input> <output> [<seed>]' requests "
+             "sent to the Unix socket <path>, one per connection"),
+    cl::value_desc("path"), cl::cat(RandCategory));
+
+static cl::opt<unsigned> ServeCacheSize(
+    "serve-cache-size",
+    cl::desc("Number of binaries whose decoded .rand -serve keeps"),
+    cl::init(64), cl::cat(RandCategory));
+
+static cl::opt<bool> CanonicalizeProfile(
+    "canonicalize-profile",
+    cl::desc("Rewrite the addresses of the input profiles, collected on "
+             "randomized hosts, into the original layout instead of "
+             "randomizing binaries"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<std::string> RandMap(
+    "rand-map",
+    cl::desc("The address map (<output>.ccrmap) of the host of the profiles; "
+             "a -manifest line may name its own as a third field"),
+    cl::value_desc("file"), cl::cat(RandCategory));
+
+static cl::opt<ccr::ProfileFormat> ProfileFormat(
+    "profile-format", cl::desc("The format of the profiles to canonicalize"),
+    cl::init(ccr::ProfileFormat::Auto),
+    cl::values(clEnumValN(ccr::ProfileFormat::Auto, "auto",
+                          "Detect by the first record (default)"),
+               clEnumValN(ccr::ProfileFormat::PerfScript, "perf-script",
+                          "perf script output"),
+               clEnumValN(ccr::ProfileFormat::PreAggregated, "pre-aggregated",
+                          "B/F records of perf2bolt -pa"),
+               clEnumValN(ccr::ProfileFormat::TextProfile, "text",
+                          "Unsymbolized llvm-profgen text profile")),
+    cl::cat(RandCategory));
+
+static cl::opt<bool> TimeTrace(
+    "time-trace",
+    cl::desc("Write where the time goes (parse, plan, copy, patch, DWARF, EH "
+             "and write, by binary and by thread) as a Chrome trace, like "
+             "clang -ftime-trace"),
+    cl::init(false), cl::cat(RandCategory));
+
+static cl::opt<std::string> TimeTraceFile(
+    "time-trace-file",
+    cl::desc("Where -time-trace writes to (default: <output>.time-trace.json, "
+             "or llvm-ccr-rand.time-trace.json for a batch)"),
+    cl::value_desc("filename"), cl::cat(RandCategory));
+
+static cl::opt<bool> Verbose("verbose", cl::desc("Print the layout summary"),
+                             cl::init(false), cl::cat(RandCategory));
+
+namespace {
+struct Job {
+  std::string Input;
+  std::string Output; // Same as Input for -in-place
+  uint64_t Seed;
+  std::string Map; // The address map of a profile (-canonicalize-profile)
+};
+
+// Admits jobs while their estimated working sets fit into the budget; a job
+// larger than the whole budget runs alone
+class MemoryBudget {
+  uint64_t Limit, InUse = 0;
+  std::mutex M;
+  std::condition_variable CV;
+
+public:
+  explicit MemoryBudget(uint64_t Limit) : Limit(Limit) {}
+
+  uint64_t acquire(uint64_t Bytes) {
+    if (!Limit)
+      return 0;
+    Bytes = std::min(Bytes, Limit);
+    std::unique_lock<std::mutex> Lock(M);
+    CV.wait(Lock, [&] { return InUse + Bytes <= Limit; });
+    InUse += Bytes;
+    return Bytes;
+  }
+
+  void release(uint64_t Bytes) {
+    if (!Bytes)
+      return;
+    {
+      std::lock_guard<std::mutex> Lock(M);
+      InUse -= Bytes;
+    }
+    CV.notify_all();
+  }
+};
+} // end anonymous namespace
+
+// The llvm-mca regions of the layout \p R has made, if asked for
+static Error writeMCARegions(ccr::Randomizer &R,
+                             const ccr::RandomizerConfig &Config) {
+  if (Config.MCAPath.empty())
+    return Error::success();
+  std::error_code EC;
+  raw_fd_ostream OS(Config.MCAPath, EC, sys::fs::OF_Text);
+  if (EC)
+    return createFileError(Config.MCAPath, EC);
+  if (Error E = R.writeMCARegions(OS))
+    return E;
+  OS.close();
+  if (OS.has_error())
+    return createFileError(Config.MCAPath, OS.error());
+  return Error::success();
+}
+
+// Randomize the image of a binary; what grows the file past the image (the
+// regenerated DWARF and the BBL address map) goes to \p Appends
+static Error randomizeImage(MutableArrayRef<uint8_t> Image,
+                            const ccr::RandomizerConfig &Config,
+                            StringRef MapPath,
+                            std::vector<ccr::FileAppend> &Appends) {
+  ccr::Randomizer R(Image, Config);
+  if (Error E = R.run())
+    return E;
+  if (Error E = writeMCARegions(R, Config))
+    return E;
+
+  std::vector<ccr::NewSection> New;
+  if (Config.RewriteDebugInfo)
+    if (Error E = R.rewriteDebugInfo(New))
+      return E;
+  if (Config.BBAddrMap)
+    New.push_back(R.getBBAddrMap());
+  if (Config.SyntheticSites)
+    New.push_back(R.getSyntheticSites());
+  if (!New.empty())
+    if (Error E = R.appendSections(New, Image.size(), Appends))
+      return E;
+
+  if (MapPath.empty())
+    return Error::success();
+
+  TimeTraceScope Scope("Write", MapPath);
+  std::error_code EC;
+  raw_fd_ostream OS(MapPath, EC, sys::fs::OF_None);
+  if (EC)
+    return createFileError(MapPath, EC);
+  R.writeAddressMap(OS);
+  OS.close();
+  if (OS.has_error())
+    return createFileError(MapPath, OS.error());
+  return Error::success();
+}
+
+static Error randomize(int FD, uint64_t Size,
+                       const ccr::RandomizerConfig &Config,
+                       StringRef MapPath) {
+  std::error_code EC;
+  sys::fs::mapped_file_region Region(FD, sys::fs::mapped_file_region::readwrite,
+                                     Size, 0, EC);
+  if (EC)
+    return errorCodeToError(EC);
+  std::vector<ccr::FileAppend> Appends;
+  if (Error E = randomizeImage(
+          MutableArrayRef<uint8_t>(reinterpret_cast<uint8_t *>(Region.data()),
+                                   Size),
+          Config, MapPath, Appends))
+    return E;
+
+  if (!Appends.empty()) {
+    TimeTraceScope Scope("Write", [&] {
+      uint64_t Bytes = 0;
+      for (const ccr::FileAppend &A : Appends)
+        Bytes += A.Data.size();
+      return std::to_string(Bytes) + " bytes";
+    });
+    raw_fd_ostream OS(FD, /*shouldClose=*/false);
+    for (const ccr::FileAppend &A : Appends) {
+      OS.seek(A.Offset);
+      OS.write(reinterpret_cast<const char *>(A.Data.data()), A.Data.size());
+    }
+    OS.flush();
+    if (OS.has_error()) {
+      std::error_code WriteEC = OS.error();
+      OS.clear_error();
+      return errorCodeToError(WriteEC);
+    }
+  }
+  return Error::success();
+}
+
+// The randomizer holds a copy of .text and the decoded .rand
+static uint64_t estimateWorkingSet(const ObjectFile &Obj) {
+  uint64_t Bytes = 0;
+  for (const SectionRef &Sec : Obj.sections()) {
+    StringRef Name;
+    if (Sec.getName(Name))
+      continue;
+    if (Name == ".text")
+      Bytes += Sec.getSize();
+    else if (Name == ".rand")
+      Bytes += Sec.getSize() * 8;
+  }
+  return Bytes;
+}
+
+static bool hasRandSection(const ObjectFile &Obj) {
+  return any_of(Obj.sections(), [](const SectionRef &Sec) {
+    StringRef Name;
+    return !Sec.getName(Name) && Name == ".rand";
+  });
+}
+
+// The verifier only reads the image; a private mapping hands it over as the
+// writable one the randomizer takes without ever touching the file
+static Error verify(StringRef Path, uint64_t Size,
+                    const ccr::RandomizerConfig &Config) {
+  int FD;
+  if (std::error_code EC = sys::fs::openFileForRead(Path, FD))
+    return createFileError(Path, EC);
+  std::error_code EC;
+  sys::fs::mapped_file_region Region(FD, sys::fs::mapped_file_region::priv,
+                                     Size, 0, EC);
+  sys::Process::SafelyCloseFileDescriptor(FD);
+  if (EC)
+    return createFileError(Path, EC);
+  ccr::Randomizer R(
+      MutableArrayRef<uint8_t>(reinterpret_cast<uint8_t *>(Region.data()), Size),
+      Config);
+  if (Error E = R.verify())
+    return createFileError(Path, std::move(E));
+  if (Config.Verbose)
+    outs() << Path << ": OK\n";
+  return Error::success();
+}
+
+// -plan-only: the layout is planned over a private mapping of the input, of
+// which the planning reads .text, the call-site tables and the .rand section
+// only, and its map is all that is written
+static Error planMap(StringRef Path, uint64_t Size,
+                     const ccr::RandomizerConfig &Config, StringRef MapPath) {
+  int FD;
+  if (std::error_code EC = sys::fs::openFileForRead(Path, FD))
+    return createFileError(Path, EC);
+  std::error_code EC;
+  sys::fs::mapped_file_region Region(FD, sys::fs::mapped_file_region::priv,
+                                     Size, 0, EC);
+  sys::Process::SafelyCloseFileDescriptor(FD);
+  if (EC)
+    return createFileError(Path, EC);
+  ccr::RandomizerConfig PlanConfig = Config;
+  PlanConfig.PlanOnly = true;
+  ccr::Randomizer R(
+      MutableArrayRef<uint8_t>(reinterpret_cast<uint8_t *>(Region.data()), Size),
+      PlanConfig);
+  if (Error E = R.run())
+    return createFileError(Path, std::move(E));
+
+  TimeTraceScope Scope("Write", MapPath);
+  raw_fd_ostream OS(MapPath, EC, sys::fs::OF_None);
+  if (EC)
+    return createFileError(MapPath, EC);
+  R.writeAddressMap(OS);
+  OS.close();
+  if (OS.has_error())
+    return createFileError(MapPath, OS.error());
+  return Error::success();
+}
+
+// -update: the new layout is built in a private (copy-on-write) mapping of
+// the input, then only the pages that differ from the output are written
+static Error update(const Job &J, uint64_t Size,
+                    const ccr::RandomizerConfig &Config, StringRef MapPath) {
+  int InFD;
+  if (std::error_code EC = sys::fs::openFileForRead(J.Input, InFD))
+    return createFileError(J.Input, EC);
+  std::error_code EC;
+  sys::fs::mapped_file_region Image(InFD, sys::fs::mapped_file_region::priv,
+                                    Size, 0, EC);
+  sys::Process::SafelyCloseFileDescriptor(InFD);
+  if (EC)
+    return createFileError(J.Input, EC);
+  ccr::Randomizer R(
+      MutableArrayRef<uint8_t>(reinterpret_cast<uint8_t *>(Image.data()), Size),
+      Config);
+  if (Error E = R.run())
+    return createFileError(J.Input, std::move(E));
+  if (Error E = writeMCARegions(R, Config))
+    return createFileError(J.Input, std::move(E));
+
+  int OutFD;
+  if (std::error_code EC = sys::fs::openFileForReadWrite(
+          J.Output, OutFD, sys::fs::CD_OpenExisting, sys::fs::OF_None))
+    return createFileError(J.Output, EC);
+  auto CloseOutput =
+      make_scope_exit([&] { sys::Process::SafelyCloseFileDescriptor(OutFD); });
+  sys::fs::file_status Stat;
+  if (std::error_code EC = sys::fs::status(OutFD, Stat))
+    return createFileError(J.Output, EC);
+  uint64_t OldSize = std::min<uint64_t>(Stat.getSize(), Size);
+  std::unique_ptr<sys::fs::mapped_file_region> Old;
+  if (OldSize) {
+    Old = llvm::make_unique<sys::fs::mapped_file_region>(
+        OutFD, sys::fs::mapped_file_region::readonly, OldSize, 0, EC);
+    if (EC)
+      return createFileError(J.Output, EC);
+  }
+
+  // Consecutive changed pages go out in one write
+  const uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  const uint8_t *New = reinterpret_cast<const uint8_t *>(Image.data());
+  const uint8_t *Prev = Old ? reinterpret_cast<const uint8_t *>(Old->data())
+                            : nullptr;
+  raw_fd_ostream OS(OutFD, /*shouldClose=*/false);
+  uint64_t NumPages = 0, NumWritten = 0, RunBegin = 0, RunEnd = 0;
+  auto Flush = [&] {
+    if (RunEnd == RunBegin)
+      return;
+    OS.seek(RunBegin);
+    OS.write(reinterpret_cast<const char *>(New + RunBegin), RunEnd - RunBegin);
+    RunBegin = RunEnd;
+  };
+  for (uint64_t Offset = 0; Offset < Size; Offset += PageSize, ++NumPages) {
+    uint64_t Len = std::min(PageSize, Size - Offset);
+    if (Offset + Len <= OldSize && !memcmp(New + Offset, Prev + Offset, Len)) {
+      Flush();
+      RunBegin = RunEnd = Offset + Len;
+      continue;
+    }
+    RunEnd = Offset + Len;
+    ++NumWritten;
+  }
+  Flush();
+  OS.flush();
+  if (OS.has_error()) {
+    std::error_code WriteEC = OS.error();
+    OS.clear_error();
+    return createFileError(J.Output, WriteEC);
+  }
+  Old.reset();
+  if (Stat.getSize() != Size)
+    if (std::error_code EC = sys::fs::resize_file(OutFD, Size))
+      return createFileError(J.Output, EC);
+  if (Config.Verbose)
+    outs() << J.Output << ": rewrote " << NumWritten << " of " << NumPages
+           << " pages\n";
+
+  if (MapPath.empty())
+    return Error::success();
+  raw_fd_ostream MapOS(MapPath, EC, sys::fs::OF_None);
+  if (EC)
+    return createFileError(MapPath, EC);
+  R.writeAddressMap(MapOS);
+  MapOS.close();
+  if (MapOS.has_error())
+    return createFileError(MapPath, MapOS.error());
+  return Error::success();
+}
+
+// The decoded .rand of the binaries seen by -serve
+static std::unique_ptr<ccr::MetadataCache> ServedMetadata;
+
+namespace {
+// What the randomization of a binary takes besides its image
+struct PreparedJob {
+  ccr::RandomizerConfig Config;
+  std::unique_ptr<MemoryBuffer> Sidecar;         // Of a binary stripped of .rand
+  std::shared_ptr<const ccr::RandInfo> Metadata; // Decoded once (-variants)
+  std::string CacheKey;
+  std::string MapPath;
+  uint64_t WorkingSet = 0;
+  bool Cached = false; // The output has been fetched from -cache-dir
+};
+} // end anonymous namespace
+
+// Set up the randomization of the binary \p Buf of \p J, unless its output
+// is in the cache already
+static Error prepareJob(const Job &J, MemoryBufferRef Buf,
+                        const ccr::RandomizerConfig &Config, PreparedJob &P) {
+  Expected<std::unique_ptr<Binary>> BinOrErr = createBinary(Buf);
+  if (!BinOrErr)
+    return createFileError(J.Input, BinOrErr.takeError());
+  auto *Obj = dyn_cast<ELF64LEObjectFile>(BinOrErr->get());
+  if (!Obj)
+    return createFileError(
+        J.Input, createStringError(inconvertibleErrorCode(),
+                                   "only ELF64 little-endian binaries are "
+                                   "supported"));
+
+  P.Config = Config;
+  P.Config.Seed = J.Seed;
+  // A binary stripped of .rand takes its sidecar, kept to the end
+  if ((!RandDir.empty() || !RandServer.empty()) && !hasRandSection(*Obj)) {
+    Expected<std::unique_ptr<MemoryBuffer>> SidecarOrErr =
+        ccr::findRandSidecar(ccr::getBuildID(*Obj), RandDir, RandServer);
+    if (!SidecarOrErr)
+      return createFileError(J.Input, SidecarOrErr.takeError());
+    P.Sidecar = std::move(*SidecarOrErr);
+    P.Config.RandSidecar = arrayRefFromStringRef(P.Sidecar->getBuffer());
+  }
+  P.CacheKey = CacheDir.empty() || Verify || MCARegions || PlanOnly
+                   ? ""
+                   : ccr::getOutputCacheKey(*Obj, P.Config);
+  P.MapPath = AddressMap || PlanOnly ? J.Output + ".ccrmap" : "";
+  if (!P.CacheKey.empty() &&
+      ccr::fetchCachedOutput(CacheDir, P.CacheKey, J.Output, P.MapPath)) {
+    if (Config.Verbose)
+      outs() << J.Input << ": seed " << J.Seed << " (cached)\n";
+    P.Cached = true;
+    return Error::success();
+  }
+
+  if (ServedMetadata) {
+    Expected<std::shared_ptr<const ccr::RandInfo>> MetadataOrErr =
+        ServedMetadata->get(*Obj, P.Config.RandSidecar);
+    if (!MetadataOrErr)
+      return createFileError(J.Input, MetadataOrErr.takeError());
+    P.Metadata = std::move(*MetadataOrErr);
+    P.Config.Metadata = P.Metadata.get();
+  }
+  P.WorkingSet = estimateWorkingSet(*Obj) + P.Config.RandSidecar.size() * 8;
+
+  if (!Verify) {
+    if (WriteStats)
+      P.Config.StatsPath = J.Output + ".ccrstats";
+    if (MCARegions)
+      P.Config.MCAPath = J.Output + ".ccrmca.s";
+  }
+  return Error::success();
+}
+
+static Error randomizeFile(const Job &J, const ccr::RandomizerConfig &Config,
+                           MemoryBudget &Budget) {
+  TimeTraceScope Scope("Randomize", StringRef(J.Input));
+  // The input is only mapped; its pages are shared with the page cache
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(
+      J.Input, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return createFileError(J.Input, BufOrErr.getError());
+  std::unique_ptr<MemoryBuffer> Buf = std::move(*BufOrErr);
+  uint64_t Size = Buf->getBufferSize();
+
+  PreparedJob P;
+  if (Error E = prepareJob(J, Buf->getMemBufferRef(), Config, P))
+    return E;
+  if (P.Cached)
+    return Error::success();
+  const ccr::RandomizerConfig &FileConfig = P.Config;
+  const std::string &CacheKey = P.CacheKey, &MapPath = P.MapPath;
+
+  uint64_t Reserved = Budget.acquire(P.WorkingSet);
+  auto ReleaseBudget = make_scope_exit([&] { Budget.release(Reserved); });
+  Buf.reset();
+
+  if (Verify)
+    return verify(J.Input, Size, FileConfig);
+
+  if (Config.Verbose)
+    outs() << J.Input << ": seed " << J.Seed << "\n";
+  if (PlanOnly)
+    return planMap(J.Input, Size, FileConfig, MapPath);
+  if (Update)
+    return update(J, Size, FileConfig, MapPath);
+
+  if (J.Output == J.Input && InPlace) {
+    int FD;
+    if (std::error_code EC = sys::fs::openFileForReadWrite(
+            J.Input, FD, sys::fs::CD_OpenExisting, sys::fs::OF_None))
+      return createFileError(J.Input, EC);
+    Error E = randomize(FD, Size, FileConfig, MapPath);
+    sys::Process::SafelyCloseFileDescriptor(FD);
+    return E ? createFileError(J.Input, std::move(E)) : Error::success();
+  }
+
+  // Keep the permissions of the input (an executable stays executable)
+  sys::fs::file_status Stat;
+  if (std::error_code EC = sys::fs::status(J.Input, Stat))
+    return createFileError(J.Input, EC);
+
+  // Like FileOutputBuffer, write to a temporary file renamed at the end, but
+  // let the kernel seed it rather than dirtying every page through a mapping
+  Expected<sys::fs::TempFile> Temp =
+      sys::fs::TempFile::create(J.Output + ".tmp%%%%%%%", Stat.permissions());
+  if (!Temp)
+    return createFileError(J.Output, Temp.takeError());
+  {
+    TimeTraceScope WriteScope("Write", [&] {
+      return std::to_string(Size) + " bytes";
+    });
+    if (std::error_code EC = sys::fs::copy_file(J.Input, Temp->FD)) {
+      consumeError(Temp->discard());
+      return createFileError(J.Output, EC);
+    }
+  }
+
+  if (Error E = randomize(Temp->FD, Size, FileConfig, MapPath)) {
+    consumeError(Temp->discard());
+    return createFileError(J.Input, std::move(E));
+  }
+  if (Error E = Temp->keep(J.Output))
+    return createFileError(J.Output, std::move(E));
+  // The output stands anyway; a cache that cannot be written only warns
+  if (!CacheKey.empty())
+    if (Error E = ccr::cacheOutput(CacheDir, CacheKey, J.Output, MapPath))
+      WithColor::warning(errs(), ToolName) << toString(std::move(E)) << "\n";
+  return Error::success();
+}
+
+// Write the randomized image of a binary and what has been appended to it
+static Error writeOutput(StringRef Path, ArrayRef<uint8_t> Image,
+                         ArrayRef<ccr::FileAppend> Appends,
+                         sys::fs::perms Perms) {
+  TimeTraceScope Scope("Write", Path);
+  uint64_t Size = Image.size();
+  for (const ccr::FileAppend &A : Appends)
+    Size = std::max<uint64_t>(Size, A.Offset + A.Data.size());
+  Expected<std::unique_ptr<FileOutputBuffer>> OutOrErr =
+      FileOutputBuffer::create(Path, Size,
+                               Perms & sys::fs::owner_exe
+                                   ? FileOutputBuffer::F_executable
+                                   : 0);
+  if (!OutOrErr)
+    return createFileError(Path, OutOrErr.takeError());
+  std::unique_ptr<FileOutputBuffer> Out = std::move(*OutOrErr);
+  std::copy(Image.begin(), Image.end(), Out->getBufferStart());
+  for (const ccr::FileAppend &A : Appends)
+    std::copy(A.Data.begin(), A.Data.end(), Out->getBufferStart() + A.Offset);
+  if (Error E = Out->commit())
+    return createFileError(Path, std::move(E));
+  // Keep the permissions of the input, as randomizeFile() does
+  if (std::error_code EC = sys::fs::setPermissions(Path, Perms))
+    return createFileError(Path, EC);
+  return Error::success();
+}
+
+// Koo: -pipeline. Every input is read into memory, randomized there on the
+//      pool of the jobs and written from there, each stage on threads of its
+//      own; an image is held from its read to the commit of its output, within
+//      the -pipeline-memory budget, thus the reads run ahead while the budget
+//      allows. The reads are eager (not mapped), which is the read-ahead that
+//      network storage misses. Return whether every binary has been written.
+static bool runPipeline(ArrayRef<Job> Queue, const ccr::RandomizerConfig &Config,
+                        MemoryBudget &Budget, unsigned NumJobs) {
+  MemoryBudget InFlight((uint64_t)PipelineMemory << 20);
+  std::mutex ErrorLock;
+  bool Failed = false;
+  auto Fail = [&](Error E) {
+    std::lock_guard<std::mutex> Lock(ErrorLock);
+    logAllUnhandledErrors(std::move(E), WithColor::error(errs(), ToolName));
+    Failed = true;
+  };
+
+  unsigned NumIOJobs = std::max(1U, (unsigned)IOJobs);
+  ThreadPool ReadPool(NumIOJobs), RandomizePool(NumJobs), WritePool(NumIOJobs);
+  for (const Job &J : Queue)
+    ReadPool.async([&, J] {
+      sys::fs::file_status Stat;
+      if (std::error_code EC = sys::fs::status(J.Input, Stat))
+        return Fail(createFileError(J.Input, EC));
+      uint64_t Held = InFlight.acquire(Stat.getSize());
+      ErrorOr<std::unique_ptr<WritableMemoryBuffer>> BufOrErr = [&] {
+        TimeTraceScope Scope("Read", StringRef(J.Input));
+        return WritableMemoryBuffer::getFile(J.Input, /*FileSize=*/-1,
+                                             /*IsVolatile=*/true);
+      }();
+      if (!BufOrErr) {
+        InFlight.release(Held);
+        return Fail(createFileError(J.Input, BufOrErr.getError()));
+      }
+      std::shared_ptr<WritableMemoryBuffer> Buf = std::move(*BufOrErr);
+      MutableArrayRef<uint8_t> Image(
+          reinterpret_cast<uint8_t *>(Buf->getBufferStart()),
+          Buf->getBufferSize());
+      sys::fs::perms Perms = Stat.permissions();
+
+      RandomizePool.async([&, J, Buf, Image, Held, Perms] {
+        auto P = std::make_shared<PreparedJob>();
+        auto Appends = std::make_shared<std::vector<ccr::FileAppend>>();
+        {
+          TimeTraceScope Scope("Randomize", StringRef(J.Input));
+          if (Error E = prepareJob(J, Buf->getMemBufferRef(), Config, *P)) {
+            InFlight.release(Held);
+            return Fail(std::move(E));
+          }
+          if (P->Cached) {
+            InFlight.release(Held);
+            return;
+          }
+          if (Config.Verbose)
+            outs() << J.Input << ": seed " << J.Seed << "\n";
+          uint64_t Reserved = Budget.acquire(P->WorkingSet);
+          Error E = randomizeImage(Image, P->Config, P->MapPath, *Appends);
+          Budget.release(Reserved);
+          if (E) {
+            InFlight.release(Held);
+            return Fail(createFileError(J.Input, std::move(E)));
+          }
+        }
+
+        WritePool.async([&, J, Buf, Image, Held, Perms, P, Appends] {
+          Error E = writeOutput(J.Output, Image, *Appends, Perms);
+          InFlight.release(Held);
+          if (E)
+            return Fail(std::move(E));
+          // The output stands anyway; a cache that cannot be written only warns
+          if (!P->CacheKey.empty())
+            if (Error E = ccr::cacheOutput(CacheDir, P->CacheKey, J.Output,
+                                           P->MapPath))
+              WithColor::warning(errs(), ToolName)
+                  << toString(std::move(E)) << "\n";
+        });
+      });
+    });
+  // A stage only takes the work of the stage before it
+  ReadPool.wait();
+  RandomizePool.wait();
+  WritePool.wait();
+  return !Failed;
+}
+
+static std::vector<Job> readManifest(StringRef Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(Path);
+  if (!BufOrErr)
+    reportError(Path, BufOrErr.getError());
+
+  std::vector<Job> Jobs;
+  SmallVector<StringRef, 16> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    Line = Line.split('#').first.trim();
+    if (Line.empty())
+      continue;
+    std::pair<StringRef, StringRef> Fields = getToken(Line);
+    std::pair<StringRef, StringRef> Output = getToken(Fields.second);
+    Job J;
+    J.Input = Fields.first;
+    J.Output = Output.first;
+    J.Map = Output.second.trim();
+    Jobs.push_back(J);
+  }
+  return Jobs;
+}
+
+// The build ID, .rand and layout options of \p Path, or empty if unknown
+static std::string getInputIdentity(StringRef Path,
+                                    const ccr::RandomizerConfig &Config) {
+  Expected<OwningBinary<Binary>> BinOrErr = createBinary(Path);
+  if (!BinOrErr) {
+    consumeError(BinOrErr.takeError());
+    return "";
+  }
+  auto *Obj = dyn_cast<ELF64LEObjectFile>(BinOrErr->getBinary());
+  return Obj ? ccr::getOutputCacheKey(*Obj, Config) : "";
+}
+
+static std::vector<std::string> readStartupProfile(StringRef Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(Path);
+  if (!BufOrErr)
+    reportError(Path, BufOrErr.getError());
+
+  std::vector<std::string> Symbols;
+  SmallVector<StringRef, 16> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    Line = Line.split('#').first.trim();
+    if (!Line.empty())
+      Symbols.push_back(Line);
+  }
+  if (Symbols.empty())
+    error("'" + Path + "': no symbols in the startup profile");
+  return Symbols;
+}
+
+// A line is a set of the globals accessed together
+static std::vector<std::vector<std::string>> readDataAffinity(StringRef Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(Path);
+  if (!BufOrErr)
+    reportError(Path, BufOrErr.getError());
+
+  std::vector<std::vector<std::string>> Sets;
+  SmallVector<StringRef, 16> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    SmallVector<StringRef, 8> Names;
+    SplitString(Line.split('#').first, Names);
+    if (!Names.empty())
+      Sets.emplace_back(Names.begin(), Names.end());
+  }
+  if (Sets.empty())
+    error("'" + Path + "': no symbols in the data affinity sets");
+  return Sets;
+}
+
+// A line is 'B <from> <to> <count> <mispredicts>' for a taken branch or
+// 'F <from> <to> <count>' for a fall-through range, in hex addresses
+static std::vector<ccr::ProfileRecord> readLayoutProfile(StringRef Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(Path);
+  if (!BufOrErr)
+    reportError(Path, BufOrErr.getError());
+
+  std::vector<ccr::ProfileRecord> Records;
+  SmallVector<StringRef, 16> Lines;
+  (*BufOrErr)->getBuffer().split(Lines, '\n');
+  for (size_t I = 0, E = Lines.size(); I != E; ++I) {
+    StringRef Line = Lines[I].split('#').first.trim();
+    if (Line.empty())
+      continue;
+    SmallVector<StringRef, 5> Fields;
+    Line.split(Fields, ' ', -1, /*KeepEmpty=*/false);
+    auto ParseHex = [](StringRef Field, uint64_t &Value) {
+      Field.consume_front("0x");
+      return !Field.getAsInteger(16, Value);
+    };
+    ccr::ProfileRecord R;
+    R.FallThrough = Fields[0] == "F";
+    if ((Fields[0] != "B" && Fields[0] != "F") ||
+        Fields.size() != (R.FallThrough ? 4U : 5U) ||
+        !ParseHex(Fields[1], R.From) || !ParseHex(Fields[2], R.To) ||
+        Fields[3].getAsInteger(10, R.Count))
+      error("'" + Path + "':" + Twine(I + 1) + ": not a branch (B) or "
+            "fall-through (F) record");
+    Records.push_back(R);
+  }
+  if (Records.empty())
+    error("'" + Path + "': no records in the profile");
+  return Records;
+}
+
+static Expected<OwningBinary<Binary>> openELF(StringRef Path) {
+  Expected<OwningBinary<Binary>> BinOrErr = createBinary(Path);
+  if (!BinOrErr)
+    return createFileError(Path, BinOrErr.takeError());
+  if (!isa<ELF64LEObjectFile>(BinOrErr->getBinary()))
+    return createFileError(
+        Path, createStringError(inconvertibleErrorCode(),
+                                "only ELF64 little-endian binaries are "
+                                "supported"));
+  return BinOrErr;
+}
+
+static int diff() {
+  if (InputFilenames.size() != 2 || !ManifestFilename.empty())
+    error("-diff compares exactly two input binaries");
+  if (InPlace || Verify || Update || !OutputFilename.empty() || AddressMap ||
+      RewriteDebugInfo || BBAddrMap || SyntheticSites || MCARegions ||
+      !CacheDir.empty())
+    error("-diff writes no output");
+  Expected<OwningBinary<Binary>> Old = openELF(InputFilenames[0]);
+  if (!Old)
+    error(Old.takeError());
+  Expected<OwningBinary<Binary>> New = openELF(InputFilenames[1]);
+  if (!New)
+    error(New.takeError());
+  Expected<bool> Differ = ccr::diffRandSections(
+      *cast<ELF64LEObjectFile>(Old->getBinary()),
+      *cast<ELF64LEObjectFile>(New->getBinary()), outs());
+  if (!Differ)
+    error(Differ.takeError());
+  return *Differ ? 1 : 0;
+}
+
+// -section-order: the inputs are the objects of a link, which gold then
+// shuffles by itself
+static int writeSectionOrder(uint64_t BaseSeed) {
+  if (InputFilenames.empty() || !ManifestFilename.empty())
+    error("-section-order takes the input objects on the command line");
+  if (InPlace || Verify || Update || !OutputFilename.empty() || AddressMap ||
+      RewriteDebugInfo || BBAddrMap || SyntheticSites || MCARegions ||
+      !CacheDir.empty() || Epoch || ShuffleBBLs || !OptimizeLayout.empty() ||
+      !SampleProfile.empty())
+    error("-section-order permutes whole functions and writes the order only");
+  std::vector<OwningBinary<Binary>> Binaries;
+  std::vector<const ELF64LEObjectFile *> Objects;
+  for (const std::string &Input : InputFilenames) {
+    Expected<OwningBinary<Binary>> BinOrErr = openELF(Input);
+    if (!BinOrErr)
+      error(BinOrErr.takeError());
+    Binaries.push_back(std::move(*BinOrErr));
+    Objects.push_back(cast<ELF64LEObjectFile>(Binaries.back().getBinary()));
+  }
+
+  std::error_code EC;
+  raw_fd_ostream OS(SectionOrder, EC, sys::fs::OF_Text);
+  if (EC)
+    reportError(SectionOrder, EC);
+  Expected<unsigned> NumSections =
+      ccr::writeSectionOrder(Objects, BaseSeed, SectionClasses, OS);
+  if (!NumSections)
+    error(NumSections.takeError());
+  OS.close();
+  if (OS.has_error())
+    reportError(SectionOrder, OS.error());
+  if (Verbose)
+    outs() << SectionOrder << ": " << *NumSections << " sections (seed "
+           << BaseSeed << ")\n";
+  return 0;
+}
+
+static const char *getFormatName(ccr::ProfileFormat Format) {
+  switch (Format) {
+  case ccr::ProfileFormat::Auto:
+    return "empty";
+  case ccr::ProfileFormat::PerfScript:
+    return "perf script";
+  case ccr::ProfileFormat::PreAggregated:
+    return "pre-aggregated";
+  case ccr::ProfileFormat::TextProfile:
+    return "text profile";
+  }
+  llvm_unreachable("Unknown profile format");
+}
+
+// -canonicalize-profile: every profile is translated by the map of its job
+// (or -rand-map); a map is loaded once for the profiles that share it
+static int canonicalize(std::vector<Job> &Queue) {
+  if (Queue.empty())
+    error("no input profiles");
+  if (InPlace || Verify || Update || AddressMap || RewriteDebugInfo ||
+      BBAddrMap || SyntheticSites || MCARegions || !CacheDir.empty() ||
+      !Serve.empty() || !OptimizeLayout.empty() || !SampleProfile.empty())
+    error("-canonicalize-profile rewrites profiles only");
+  if (Queue.size() > 1 && !OutputFilename.empty())
+    error("-o requires a single input profile");
+
+  StringMap<std::unique_ptr<MemoryBuffer>> MapBuffers;
+  StringMap<object::RandAddressMap> Maps;
+  for (Job &J : Queue) {
+    if (J.Map.empty())
+      J.Map = RandMap;
+    if (J.Map.empty())
+      error("'" + J.Input + "': no -rand-map to translate the profile by");
+    if (J.Output.empty())
+      J.Output = OutputFilename.empty() ? J.Input + ".canonical"
+                                        : std::string(OutputFilename);
+    if (Maps.count(J.Map))
+      continue;
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+        MemoryBuffer::getFile(J.Map);
+    if (!BufOrErr)
+      reportError(J.Map, BufOrErr.getError());
+    StringRef Data = (*BufOrErr)->getBuffer();
+    Expected<object::RandAddressMap> MapOrErr = object::RandAddressMap::create(
+        makeArrayRef((const uint8_t *)Data.data(), Data.size()));
+    if (!MapOrErr)
+      error(createFileError(J.Map, MapOrErr.takeError()));
+    MapBuffers[J.Map] = std::move(*BufOrErr);
+    Maps.try_emplace(J.Map, std::move(*MapOrErr));
+  }
+
+  unsigned NumJobs = std::min<size_t>(
+      Jobs ? Jobs : std::max(1U, std::thread::hardware_concurrency()),
+      Queue.size());
+  if (!Threads)
+    NumJobs = 1;
+  bool Parallel = Threads && NumJobs == 1;
+  std::mutex Lock;
+  bool Failed = false;
+  auto Run = [&](const Job &J) {
+    ccr::CanonicalizeStats Stats;
+    Error E = ccr::canonicalizeProfile(J.Input, J.Output, Maps.find(J.Map)->second,
+                                       ProfileFormat, Parallel, Stats);
+    std::lock_guard<std::mutex> Guard(Lock);
+    if (E) {
+      logAllUnhandledErrors(std::move(E), WithColor::error(errs(), ToolName));
+      Failed = true;
+    } else if (Verbose) {
+      outs() << J.Output << ": " << Stats.NumLines << " lines ("
+             << getFormatName(Stats.Format) << "), " << Stats.NumTranslated
+             << " addresses translated, " << Stats.NumSplitRanges
+             << " ranges split\n";
+    }
+  };
+  if (NumJobs == 1) {
+    for (const Job &J : Queue)
+      Run(J);
+  } else {
+    ThreadPool Pool(NumJobs);
+    for (const Job &J : Queue)
+      Pool.async([&, J] { Run(J); });
+    Pool.wait();
+  }
+  return Failed ? 1 : 0;
+}
+
+// -serve: the options apply to every request, which names its input, its
+// output and optionally its seed (a random one otherwise)
+static int serve(ccr::RandomizerConfig &Config, MemoryBudget &Budget,
+                 function_ref<void()> PruneCache) {
+  unsigned NumJobs =
+      Jobs ? Jobs : std::max(1U, std::thread::hardware_concurrency());
+  if (!Threads)
+    NumJobs = 1;
+  Config.Parallel = Threads && NumJobs == 1;
+  ServedMetadata = llvm::make_unique<ccr::MetadataCache>(ServeCacheSize);
+
+  Error E = ccr::serveRequests(Serve, NumJobs, [&](StringRef Request) -> Error {
+    std::pair<StringRef, StringRef> Input = getToken(Request);
+    std::pair<StringRef, StringRef> Output = getToken(Input.second);
+    StringRef SeedField = Output.second.trim();
+    Job J;
+    J.Input = Input.first;
+    J.Output = Output.first;
+    if (J.Input.empty() || J.Output.empty())
+      return createStringError(inconvertibleErrorCode(),
+                               "expected '<input> <output> [<seed>]'");
+    if (SeedField.empty())
+      J.Seed = ((uint64_t)sys::Process::GetRandomNumber() << 32) |
+               sys::Process::GetRandomNumber();
+    else if (SeedField.getAsInteger(0, J.Seed))
+      return createStringError(inconvertibleErrorCode(),
+                               "invalid seed '%s'", SeedField.str().c_str());
+    return randomizeFile(J, Config, Budget);
+  });
+  PruneCache();
+  if (E)
+    error(std::move(E));
+  if (Verbose)
+    outs() << "Decoded .rand: " << ServedMetadata->getMisses() << " of "
+           << ServedMetadata->getHits() + ServedMetadata->getMisses()
+           << " requests\n";
+  return 0;
+}
+
+// -time-trace: the sections of every job, once all of them are done
+static void writeTimeTrace(ArrayRef<Job> Queue) {
+  if (!timeTraceProfilerEnabled())
+    return;
+  std::string Path = TimeTraceFile;
+  if (Path.empty())
+    Path = (Queue.size() == 1 ? Queue.front().Output
+                              : std::string("llvm-ccr-rand")) +
+           ".time-trace.json";
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_Text);
+  if (EC)
+    reportError(Path, EC);
+  timeTraceProfilerWrite(OS);
+  timeTraceProfilerCleanup();
+}
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  ToolName = argv[0];
+  cl::HideUnrelatedOptions(RandCategory);
+  cl::ParseCommandLineOptions(argc, argv, "CCR binary randomizer\n");
+
+  if (Diff)
+    return diff();
+
+  std::vector<Job> Queue;
+  for (const std::string &Input : InputFilenames)
+    Queue.push_back({Input, "", 0});
+  if (!ManifestFilename.empty()) {
+    std::vector<Job> Listed = readManifest(ManifestFilename);
+    Queue.insert(Queue.end(), Listed.begin(), Listed.end());
+  }
+  if (CanonicalizeProfile)
+    return canonicalize(Queue);
+  if (!RandMap.empty() || ProfileFormat.getNumOccurrences() ||
+      any_of(Queue, [](const Job &J) { return !J.Map.empty(); }))
+    error("address maps and -profile-format apply to -canonicalize-profile");
+  if (!Serve.empty() &&
+      (!Queue.empty() || !OutputFilename.empty() || InPlace || Update ||
+       Verify || ShareLayouts || !IndexFilename.empty() ||
+       !OptimizeLayout.empty() || !SampleProfile.empty() || Epoch))
+    error("-serve takes the inputs and outputs from its requests (no inputs, "
+          "-o, -in-place, -update, -verify, -share-layouts, -index, profiles "
+          "or -epoch)");
+  if (Queue.empty() && Serve.empty())
+    error("no input binaries");
+  if (Queue.size() > 1 && !OutputFilename.empty())
+    error("-o requires a single input binary");
+  if (Queue.size() > 1 && !IndexFilename.empty())
+    error("-index requires a single input binary");
+  if (AddressMap && RewriteDebugInfo)
+    error("-address-map maps to the original DWARF, which -rewrite-debug-info "
+          "replaces");
+  if (Verify && (InPlace || !OutputFilename.empty() || AddressMap ||
+                 RewriteDebugInfo || BBAddrMap || SyntheticSites || MCARegions))
+    error("-verify writes no output");
+  if (Update &&
+      (InPlace || Verify || RewriteDebugInfo || BBAddrMap || SyntheticSites))
+    error("-update rewrites an existing output with the image of the input "
+          "only (no -in-place, -verify, -rewrite-debug-info, -bb-address-map "
+          "or -synthetic-sites)");
+  if (PlanOnly && (InPlace || Update || Verify || RewriteDebugInfo ||
+                   BBAddrMap || SyntheticSites || MCARegions ||
+                   !CacheDir.empty() || Pipeline))
+    error("-plan-only writes the address maps only (no -in-place, -update, "
+          "-verify, -rewrite-debug-info, -bb-address-map, -synthetic-sites, "
+          "-mca-regions, -cache-dir or -pipeline)");
+  if (Variants == 0)
+    error("-variants takes one or more variants");
+  if (Variants > 1 && (InPlace || Update || Verify || ShareLayouts ||
+                       !IndexFilename.empty() || !Serve.empty()))
+    error("-variants writes new outputs of their own (no -in-place, -update, "
+          "-verify, -share-layouts, -index or -serve)");
+  if (Pipeline && (InPlace || Update || Verify || !Serve.empty()))
+    error("-pipeline writes new outputs of a batch (no -in-place, -update, "
+          "-verify or -serve)");
+  if ((PipelineMemory.getNumOccurrences() || IOJobs.getNumOccurrences()) &&
+      !Pipeline)
+    error("-pipeline-memory and -io-jobs require -pipeline");
+  if (ShareLayouts && (InPlace || Update || Verify))
+    error("-share-layouts links new outputs (no -in-place, -update or "
+          "-verify)");
+  if (!CacheDir.empty() && (InPlace || Update || Verify))
+    error("-cache-dir does not apply to -in-place, -update or -verify");
+  if (CachePolicy.getNumOccurrences() && CacheDir.empty())
+    error("-cache-policy requires -cache-dir");
+  if (TimeTrace && !Serve.empty())
+    error("-time-trace applies to the binaries of the command line (no "
+          "-serve)");
+  if (TimeTraceFile.getNumOccurrences() && !TimeTrace)
+    error("-time-trace-file requires -time-trace");
+  if (StartupDepth.getNumOccurrences() &&
+      (!StartupLayout || !StartupProfile.empty()))
+    error("-startup-depth applies to -startup-layout without a profile");
+  if (RefreshPercent.getNumOccurrences() && !Epoch)
+    error("-refresh-percent requires -epoch");
+  if (Epoch && !Seed.getNumOccurrences())
+    error("-epoch derives the layout from the one of -seed");
+  if ((SlidePadding || PaddingOnly) && !Realign)
+    error("-slide-padding and -padding-only slide within the padding that "
+          "-realign re-materializes");
+  if (Granularity == GK_Object &&
+      (ShuffleBBLs || PaddingOnly || !OptimizeLayout.empty() ||
+       !SampleProfile.empty() || ClusterCalls || SplitFunctions ||
+       StartupLayout || !StartupProfile.empty()))
+    error("-granularity=object keeps the functions of an object in their "
+          "order (no -shuffle-bbls, -padding-only, -optimize-layout, "
+          "-sample-profile, -cluster-calls, -split-functions or "
+          "-startup-layout)");
+  if (PackCold && !Realign)
+    error("-pack-cold leaves out the padding that -realign re-materializes");
+  if (PaddingOnly && (ShuffleBBLs || !OptimizeLayout.empty() ||
+                      !SampleProfile.empty() || ClusterCalls || SplitFunctions ||
+                      StartupLayout || !StartupProfile.empty()))
+    error("-padding-only keeps the order of the functions and BBLs (no "
+          "-shuffle-bbls, -optimize-layout, -sample-profile, -cluster-calls, "
+          "-split-functions or -startup-layout)");
+  if (EntryTrampolines && PaddingOnly)
+    error("-entry-trampolines moves the functions, which -padding-only keeps "
+          "at their entries");
+  if (HotRegionBudget.getNumOccurrences() && !HotRegionSeed.getNumOccurrences())
+    error("-hot-region-budget requires -hot-region-seed");
+  if (HotRegionSeed.getNumOccurrences() &&
+      (PaddingOnly || EntryTrampolines || SplitFunctions || !HotCold ||
+       !OptimizeLayout.empty() || !SampleProfile.empty()))
+    error("-hot-region-seed permutes whole functions of the hot bucket (no "
+          "-padding-only, -entry-trampolines, -split-functions, "
+          "-hot-cold=false, -optimize-layout or -sample-profile)");
+  if (StableLayout && (PaddingOnly || Epoch))
+    error("-stable-layout orders the units by their identities, which "
+          "-padding-only and -epoch do not");
+  if (ShuffleWindow && (PaddingOnly || HotRegionSeed.getNumOccurrences() ||
+                        !OptimizeLayout.empty() || !SampleProfile.empty()))
+    error("-shuffle-window bounds a random permutation (no -padding-only, "
+          "-hot-region-seed, -optimize-layout or -sample-profile)");
+  if (PermuteInPlace && MCARegions)
+    error("-mca-regions reads the old code, which -permute-in-place moves "
+          "over");
+  if ((ShuffleData || !DataAffinity.empty()) && (Epoch || RewriteDebugInfo))
+    error("-shuffle-data moves the data objects, which -epoch (that refreshes "
+          "the code only) and -rewrite-debug-info do not follow");
+  if (!OptimizeLayout.empty() && (Epoch || Queue.size() > 1))
+    error("-optimize-layout takes the profile of a single binary (no -epoch)");
+  if (!SampleProfile.empty() && (!OptimizeLayout.empty() || Epoch ||
+                                 Queue.size() > 1))
+    error("-sample-profile takes the profile of a single binary (no "
+          "-optimize-layout or -epoch)");
+  if (Verify || RewriteDebugInfo) {
+    InitializeAllTargetInfos();
+    InitializeAllTargetMCs();
+    InitializeAllDisassemblers();
+  }
+
+  uint64_t BaseSeed = Seed.getNumOccurrences()
+                          ? Seed
+                          : ((uint64_t)sys::Process::GetRandomNumber() << 32) |
+                                sys::Process::GetRandomNumber();
+  if (!SectionOrder.empty())
+    return writeSectionOrder(BaseSeed);
+  for (Job &J : Queue) {
+    if (InPlace) {
+      if (!OutputFilename.empty() || !J.Output.empty())
+        error("-in-place does not take an output for '" + J.Input + "'");
+      J.Output = J.Input;
+    } else if (J.Output.empty()) {
+      J.Output = OutputFilename.empty() ? J.Input + "_shuffled"
+                                        : std::string(OutputFilename);
+    }
+    // A different but reproducible layout for every binary of a batch
+    J.Seed = Queue.size() == 1 ? BaseSeed : BaseSeed ^ xxHash64(J.Input);
+  }
+
+  // The variants of a binary are so many jobs on the same input, which take
+  // the .rand it decodes once; the first of them has the seed of the binary
+  if (Variants > 1) {
+    ServedMetadata = llvm::make_unique<ccr::MetadataCache>(Queue.size());
+    std::vector<Job> Expanded;
+    for (const Job &J : Queue)
+      for (unsigned I = 0; I < Variants; ++I)
+        Expanded.push_back(
+            {J.Input, J.Output + "." + std::to_string(I), J.Seed + I, ""});
+    Queue.swap(Expanded);
+  }
+
+  ccr::RandomizerConfig Config;
+  Config.ShuffleBBLs = ShuffleBBLs;
+  Config.ObjectGranularity = Granularity == GK_Object;
+  Config.BBLShufflePercent = std::min(100U, (unsigned)BBLShufflePercent);
+  Config.HotColdBuckets = HotCold;
+  Config.PlacementChains = PlacementChains;
+  Config.SectionClasses = SectionClasses;
+  Config.Realign = Realign;
+  Config.PermuteInPlace = PermuteInPlace;
+  Config.SlidePadding = SlidePadding || PaddingOnly;
+  Config.PaddingOnly = PaddingOnly;
+  Config.PackCold = PackCold;
+  Config.EntryTrampolines = EntryTrampolines;
+  Config.HotRegion = HotRegionSeed.getNumOccurrences();
+  Config.HotRegionSeed = HotRegionSeed;
+  Config.HotRegionBudget = HotRegionBudget;
+  Config.StableOrder = StableLayout;
+  Config.StraightenBranches = StraightenBranches;
+  Config.ShrinkBranches = ShrinkBranches;
+  Config.TailDupSize = TailDupSize;
+  Config.HugePageSize = HugePages ? 2ULL << 20 : 0;
+  Config.ShuffleWindow = ShuffleWindow;
+  Config.MaxGrowthPercent = MaxGrowth;
+  Config.NoHotGrowth = NoHotGrowth;
+  Config.StartupLayout = StartupLayout || !StartupProfile.empty();
+  Config.StartupDepth = StartupDepth;
+  if (!StartupProfile.empty())
+    Config.StartupSymbols = readStartupProfile(StartupProfile);
+  Config.ShuffleData = ShuffleData || !DataAffinity.empty();
+  if (!DataAffinity.empty())
+    Config.DataAffinity = readDataAffinity(DataAffinity);
+  if (!OptimizeLayout.empty())
+    Config.Profile = readLayoutProfile(OptimizeLayout);
+  if (!SampleProfile.empty()) {
+    Expected<OwningBinary<Binary>> Bin = openELF(Queue.front().Input);
+    if (!Bin)
+      error(Bin.takeError());
+    Expected<std::vector<ccr::ProfileRecord>> Records = ccr::readSampleProfile(
+        SampleProfile, *cast<ELF64LEObjectFile>(Bin->getBinary()));
+    if (!Records)
+      error(Records.takeError());
+    Config.Profile = std::move(*Records);
+  }
+  Config.ClusterCalls = ClusterCalls;
+  Config.SplitFunctions = SplitFunctions;
+  Config.Epoch = Epoch;
+  Config.RefreshPercent = std::min(100U, (unsigned)RefreshPercent);
+  Config.Verbose = Verbose;
+  Config.IndexPath = IndexFilename;
+  Config.RewriteDebugInfo = RewriteDebugInfo;
+  Config.BBAddrMap = BBAddrMap;
+  Config.SyntheticSites = SyntheticSites;
+  Config.PlanOnly = PlanOnly;
+  if (Verbose)
+    outs() << "Seed: " << BaseSeed << "\n";
+
+  // The copies of a binary are randomized once (as the first of them), with
+  // a seed of their contents rather than of their paths
+  std::vector<std::pair<std::string, std::string>> SharedOutputs; // (to, from)
+  if (ShareLayouts && Queue.size() > 1) {
+    StringMap<unsigned> Primaries;
+    std::vector<Job> Unique;
+    for (Job &J : Queue) {
+      std::string Key = getInputIdentity(J.Input, Config);
+      if (Key.empty()) {
+        Unique.push_back(J);
+        continue;
+      }
+      J.Seed = BaseSeed ^ xxHash64(Key);
+      auto Ins = Primaries.try_emplace(Key, Unique.size());
+      if (Ins.second)
+        Unique.push_back(J);
+      else
+        SharedOutputs.emplace_back(J.Output, Unique[Ins.first->second].Output);
+    }
+    Queue.swap(Unique);
+  }
+  auto LinkSharedOutputs = [&] {
+    for (const auto &Shared : SharedOutputs) {
+      std::vector<std::string> Suffixes;
+      if (!PlanOnly)
+        Suffixes.push_back("");
+      if (AddressMap || PlanOnly)
+        Suffixes.push_back(".ccrmap");
+      if (WriteStats)
+        Suffixes.push_back(".ccrstats");
+      if (MCARegions)
+        Suffixes.push_back(".ccrmca.s");
+      for (const std::string &Suffix : Suffixes)
+        if (std::error_code EC = ccr::linkOrCopy(Shared.second + Suffix,
+                                                 Shared.first + Suffix))
+          reportError(Shared.first + Suffix, EC);
+      if (Verbose)
+        outs() << Shared.first << ": the layout of " << Shared.second << "\n";
+    }
+  };
+
+  unsigned NumJobs = std::min<size_t>(
+      Jobs ? Jobs : std::max(1U, std::thread::hardware_concurrency()),
+      Queue.size());
+  if (!Threads)
+    NumJobs = 1;
+  // Koo: The executor of lib/Support/Parallel.h blocks its workers on nested
+  // task groups, hence the fixup patching of a binary only runs on it while
+  // the binaries are randomized one by one
+  Config.Parallel = Threads && NumJobs == 1;
+  MemoryBudget Budget((uint64_t)MaxMemory << 20);
+
+  CachePruningPolicy Policy;
+  if (!CacheDir.empty()) {
+    Expected<CachePruningPolicy> PolicyOrErr =
+        parseCachePruningPolicy(CachePolicy);
+    if (!PolicyOrErr)
+      error(PolicyOrErr.takeError());
+    Policy = *PolicyOrErr;
+  }
+  auto PruneCache = [&] {
+    if (!CacheDir.empty())
+      pruneCache(CacheDir, Policy);
+  };
+
+  if (!Serve.empty())
+    return serve(Config, Budget, PruneCache);
+
+  if (TimeTrace)
+    timeTraceProfilerInitialize("llvm-ccr-rand");
+  if (Pipeline) {
+    bool Failed = !runPipeline(Queue, Config, Budget, NumJobs);
+    writeTimeTrace(Queue);
+    if (!Failed)
+      LinkSharedOutputs();
+    PruneCache();
+    return Failed ? 1 : 0;
+  }
+  if (NumJobs == 1) {
+    for (const Job &J : Queue)
+      if (Error E = randomizeFile(J, Config, Budget))
+        error(std::move(E));
+    writeTimeTrace(Queue);
+    LinkSharedOutputs();
+    PruneCache();
+    return 0;
+  }
+
+  std::mutex ErrorLock;
+  bool Failed = false;
+  ThreadPool Pool(NumJobs);
+  for (const Job &J : Queue)
+    Pool.async([&, J] {
+      if (Error E = randomizeFile(J, Config, Budget)) {
+        std::lock_guard<std::mutex> Lock(ErrorLock);
+        logAllUnhandledErrors(std::move(E), WithColor::error(errs(), ToolName));
+        Failed = true;
+      }
+    });
+  Pool.wait();
+  writeTimeTrace(Queue);
+  if (!Failed)
+    LinkSharedOutputs();
+  PruneCache();
+  return Failed ? 1 : 0;
+}
@@ -98,6 +98,11 @@ static cl::opt<bool> ShowRelocatedSectionContents(
     cl::desc("show section contents after fixups have been applied"),
     cl::init(false));
 
+// Koo
+static cl::opt<uint64_t> CCRShuffleSeed(
+    "ccr-shuffle-seed",
+    cl::desc("Permute the functions of every object with the given seed"));
+
 ExitOnError ExitOnErr;
 
 namespace llvm {
@@ -231,6 +236,9 @@ Session::Session(Triple TT) : ObjLayer(ES, MemMgr), TT(std::move(TT)) {
     Session &S;
   };
 
+  if (CCRShuffleSeed.getNumOccurrences())
+    ObjLayer.addPlugin(llvm::make_unique<CCRShufflePlugin>(CCRShuffleSeed));
+
   if (!NoExec && !TT.isOSWindows())
     ObjLayer.addPlugin(llvm::make_unique<LocalEHFrameRegistrationPlugin>());
 
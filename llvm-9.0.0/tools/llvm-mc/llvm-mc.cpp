@@ -373,6 +373,13 @@ int main(int argc, char **argv) {
 
   if (SaveTempLabels)
     Ctx.setAllowTemporaryLabels(false);
+  // Koo: With -ccr-metadata (see MCAsmInfo), assemble as clang -cc1as does for
+  //      a *.s file, i.e., record the layout of the assembly and write it to
+  //      .rand, so that the CCR path of the MC layer can be profiled (and
+  //      fuzzed) without the driver
+  bool CCRMetadata = MAI->RandMetadata;
+  if (CCRMetadata)
+    Ctx.getReorderInfo().isAssemFile = true;
 
   Ctx.setGenDwarfForAssembly(GenDwarfForAssembly);
   // Default to 4 for dwarf version.
@@ -489,6 +496,13 @@ int main(int argc, char **argv) {
         /*DWARFMustBeAtTheEnd*/ false));
     if (NoExecStack)
       Str->InitSections(true);
+    // Koo: The .rand section is finalized along with the object (ELF only);
+    //      as in cc1as_main.cpp, a current section has to exist already
+    if (CCRMetadata) {
+      if (!NoExecStack)
+        Str->InitSections(false);
+      Str->EmitRand();
+    }
   }
 
   // Use Assembler information for parsing.
@@ -120,6 +120,7 @@ struct CopyConfig {
   StringRef BuildIdLinkDir;
   Optional<StringRef> BuildIdLinkInput;
   Optional<StringRef> BuildIdLinkOutput;
+  StringRef ExtractCCRRand;
   Optional<StringRef> ExtractPartition;
   StringRef SplitDWO;
   StringRef SymbolsPrefix;
@@ -163,6 +164,7 @@ struct CopyConfig {
   bool PreserveDates = false;
   bool StripAll = false;
   bool StripAllGNU = false;
+  bool StripCCRRand = false;
   bool StripDWO = false;
   bool StripDebug = false;
   bool StripNonAlloc = false;
@@ -279,6 +279,52 @@ static Error splitDWOToFile(const CopyConfig &Config, const Reader &Reader,
   return Writer->write();
 }
 
+// Write the .rand section of CCR to <dir>/xx/xxx.rand, where llvm-ccr-rand
+// -rand-dir looks it up by the build ID once the binary ships without it
+// (--strip-ccr-rand). The sidecar is always written decompressed.
+static Error extractCCRRand(const CopyConfig &Config, Object &Obj,
+                            bool Is64Bit, ArrayRef<uint8_t> BuildIdBytes) {
+  const SectionBase *Rand = Obj.findSection(".rand");
+  if (!Rand || Rand->OriginalData.empty())
+    return createStringError(object_error::parse_failed,
+                             "cannot extract section '.rand': not found");
+
+  ArrayRef<uint8_t> Data = Rand->OriginalData;
+  SmallVector<char, 128> DecompressedData;
+  if (const auto *Compressed = dyn_cast<CompressedSection>(Rand)) {
+    const size_t DataOffset = Is64Bit ? sizeof(Elf_Chdr_Impl<ELF64LE>)
+                                      : sizeof(Elf_Chdr_Impl<ELF32LE>);
+    if (Data.size() < DataOffset)
+      return createStringError(object_error::parse_failed,
+                               "section '.rand' is truncated");
+    if (Error E = zlib::uncompress(toStringRef(Data.drop_front(DataOffset)),
+                                   DecompressedData,
+                                   Compressed->getDecompressedSize()))
+      return E;
+    Data = arrayRefFromStringRef(
+        StringRef(DecompressedData.data(), DecompressedData.size()));
+  }
+
+  SmallString<128> Path = Config.ExtractCCRRand;
+  sys::path::append(Path, llvm::toHex(BuildIdBytes[0], /*LowerCase*/ true));
+  if (auto EC = sys::fs::create_directories(Path))
+    return createFileError(
+        Path.str(), makeStringError(EC, "cannot create .rand directory"));
+  sys::path::append(Path,
+                    llvm::toHex(BuildIdBytes.slice(1), /*LowerCase*/ true));
+  Path += ".rand";
+
+  Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+      FileOutputBuffer::create(Path, Data.size());
+  if (!BufferOrErr)
+    return createFileError(Path.str(), BufferOrErr.takeError());
+  std::unique_ptr<FileOutputBuffer> Buf = std::move(*BufferOrErr);
+  std::copy(Data.begin(), Data.end(), Buf->getBufferStart());
+  if (Error E = Buf->commit())
+    return createFileError(Path.str(), std::move(E));
+  return Error::success();
+}
+
 static Error dumpSectionToFile(StringRef SecName, StringRef Filename,
                                Object &Obj) {
   for (auto &Sec : Obj.sections()) {
@@ -455,6 +501,11 @@ static Error replaceAndRemoveSections(const CopyConfig &Config, Object &Obj) {
       return onlyKeepDWOPred(Obj, Sec) || RemovePred(Sec);
     };
 
+  if (Config.StripCCRRand)
+    RemovePred = [RemovePred](const SectionBase &Sec) {
+      return Sec.Name == ".rand" || RemovePred(Sec);
+    };
+
   if (Config.StripAllGNU)
     RemovePred = [RemovePred, &Obj](const SectionBase &Sec) {
       if (RemovePred(Sec))
@@ -765,7 +816,7 @@ Error executeObjcopyOnBinary(const CopyConfig &Config,
                         : getOutputElfType(In);
   ArrayRef<uint8_t> BuildIdBytes;
 
-  if (!Config.BuildIdLinkDir.empty()) {
+  if (!Config.BuildIdLinkDir.empty() || !Config.ExtractCCRRand.empty()) {
     auto BuildIdBytesOrErr = findBuildID(Config, In);
     if (auto E = BuildIdBytesOrErr.takeError())
       return E;
@@ -784,6 +835,11 @@ Error executeObjcopyOnBinary(const CopyConfig &Config,
                              Config.BuildIdLinkInput.getValue(), BuildIdBytes))
       return E;
 
+  if (!Config.ExtractCCRRand.empty())
+    if (Error E = extractCCRRand(Config, *Obj, In.getBytesInAddress() == 8,
+                                 BuildIdBytes))
+      return createFileError(Config.InputFilename, std::move(E));
+
   if (Error E = handleArgs(Config, *Obj, Reader, OutputElfType))
     return createFileError(Config.InputFilename, std::move(E));
 
@@ -0,0 +1,230 @@
+//===-- CCRBoundaries.cpp - BBL boundaries of CCR binaries ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "CCRBoundaries.h"
+#include "RandInfo.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/RandMap.h"
+#include "llvm/MC/MCDisassembler/MCDisassembler.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Object/RandMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace llvm::object;
+
+// The BBLs decoded ahead of the printer at a time
+static const size_t WindowSize = 4096;
+
+static uint64_t readValue(const uint8_t *P, unsigned Size, bool Signed) {
+  switch (Size) {
+  case 1:
+    return Signed ? (uint64_t)(int8_t)*P : *P;
+  case 2:
+    return Signed ? (uint64_t)(int16_t)support::endian::read16le(P)
+                  : support::endian::read16le(P);
+  case 4:
+    return Signed ? (uint64_t)(int32_t)support::endian::read32le(P)
+                  : support::endian::read32le(P);
+  default:
+    return support::endian::read64le(P);
+  }
+}
+
+Expected<Optional<CCRBoundaries>>
+CCRBoundaries::create(const ObjectFile &Obj) {
+  if (!Obj.isELF())
+    return None;
+  Optional<SectionRef> Text, Rand, AddrMap;
+  for (const SectionRef &Sec : Obj.sections()) {
+    StringRef Name;
+    if (std::error_code EC = Sec.getName(Name))
+      return errorCodeToError(EC);
+    if (Name == ".text")
+      Text = Sec;
+    else if (Name == ".rand")
+      Rand = Sec;
+    else if (Name == ccr::BBAddrMapHeader::SectionName)
+      AddrMap = Sec;
+  }
+  if (!Text || (!Rand && !AddrMap))
+    return None;
+
+  CCRBoundaries B;
+  // The map tells where the randomizer put the BBLs: .rand still tells the
+  // old layout, and the gaps of the map may hold the code it inserted
+  if (AddrMap) {
+    Expected<StringRef> Contents = AddrMap->getContents();
+    if (!Contents)
+      return Contents.takeError();
+    Expected<std::vector<RandBBAddrEntry>> Entries =
+        readRandBBAddrMap(arrayRefFromStringRef(*Contents));
+    if (!Entries)
+      return Entries.takeError();
+    for (const RandBBAddrEntry &E : *Entries)
+      for (const RandBBLAddress &BBL : E.BBLs)
+        B.BBLs.push_back({BBL.Addr, BBL.Size, BBL.Size, BBL.ID, E.FunctionID});
+    llvm::sort(B.BBLs, [](const CCRBasicBlock &X, const CCRBasicBlock &Y) {
+      return X.Addr < Y.Addr;
+    });
+    return std::move(B);
+  }
+
+  StringRef Name;
+  if (std::error_code EC = Rand->getName(Name))
+    return errorCodeToError(EC);
+  Expected<StringRef> Contents = Rand->getContents();
+  if (!Contents)
+    return Contents.takeError();
+  bool Compressed = ELFSectionRef(*Rand).getFlags() & ELF::SHF_COMPRESSED;
+  Expected<ccr::RandInfo> InfoOrErr = ccr::parseRandInfo(
+      Name, arrayRefFromStringRef(*Contents), Compressed, /*Parallel=*/true);
+  if (!InfoOrErr)
+    return InfoOrErr.takeError();
+  const ccr::RandInfo &Info = *InfoOrErr;
+
+  // The inputs without .rand are swept as any code without boundaries
+  uint64_t TextAddr = Text->getAddress(), TextSize = Text->getSize();
+  uint64_t Addr = TextAddr + Info.RandObjOffset;
+  uint64_t Function = 0;
+  unsigned Object = 0;
+  for (size_t I = 0, E = Info.BasicBlocks.size(); I != E; ++I) {
+    const ccr::BasicBlockInfo &BBL = Info.BasicBlocks[I];
+    if (Info.getSourceType(Object) != ccr::SRC_Foreign)
+      B.BBLs.push_back(
+          {Addr, BBL.Size - BBL.PaddingSize, BBL.Size, I, Function});
+    Addr += BBL.Size;
+    if (BBL.Type != ccr::BBT_Block)
+      ++Function;
+    if (BBL.Type == ccr::BBT_ObjectEnd)
+      ++Object;
+  }
+  if (Addr > TextAddr + TextSize)
+    return createStringError(inconvertibleErrorCode(),
+                             "the layout in .rand exceeds the .text section");
+
+  // The jump tables that the code of .text holds
+  Expected<StringRef> TextContents = Text->getContents();
+  if (!TextContents)
+    return TextContents.takeError();
+  const uint8_t *TextBytes = TextContents->bytes_begin();
+  for (const ccr::FixupInfo &F : Info.Fixups[ccr::FK_Text]) {
+    if (!F.NumJTEntries || F.Offset + F.DerefSize > TextContents->size())
+      continue;
+    const uint8_t *P = TextBytes + F.Offset;
+    uint64_t Base = F.IsRela ? TextAddr + F.Offset + F.DerefSize +
+                                   readValue(P, F.DerefSize, /*Signed=*/true)
+                             : readValue(P, F.DerefSize, /*Signed=*/false);
+    uint64_t End = Base + (uint64_t)F.NumJTEntries * F.JTEntrySize;
+    if (Base >= TextAddr && End <= TextAddr + TextSize)
+      B.Data.push_back({Base, End});
+  }
+  // A table may be shared by several fixups, or overlap another
+  llvm::sort(B.Data);
+  std::vector<std::pair<uint64_t, uint64_t>> Merged;
+  for (const std::pair<uint64_t, uint64_t> &D : B.Data)
+    if (!Merged.empty() && D.first <= Merged.back().second)
+      Merged.back().second = std::max(Merged.back().second, D.second);
+    else
+      Merged.push_back(D);
+  B.Data = std::move(Merged);
+  return std::move(B);
+}
+
+int64_t CCRBoundaries::find(uint64_t Addr) const {
+  auto It = llvm::upper_bound(BBLs, Addr,
+                              [](uint64_t A, const CCRBasicBlock &BBL) {
+                                return A < BBL.Addr;
+                              });
+  if (It == BBLs.begin())
+    return -1;
+  --It;
+  return Addr < It->Addr + It->Size ? It - BBLs.begin() : -1;
+}
+
+Optional<uint64_t> CCRBoundaries::getDataEnd(uint64_t Addr) const {
+  auto It = llvm::upper_bound(
+      Data, Addr, [](uint64_t A, const std::pair<uint64_t, uint64_t> &D) {
+        return A < D.first;
+      });
+  if (It == Data.begin() || Addr >= std::prev(It)->second)
+    return None;
+  return std::prev(It)->second;
+}
+
+CCRDecoder::CCRDecoder(const Target &T, const MCSubtargetInfo &STI,
+                       MCContext &Ctx, const CCRBoundaries &B)
+    : B(B) {
+  unsigned NumThreads = std::max(1U, heavyweight_hardware_concurrency());
+  for (unsigned I = 0; I != NumThreads; ++I)
+    if (MCDisassembler *D = T.createMCDisassembler(STI, Ctx))
+      DisAsms.emplace_back(D);
+}
+
+CCRDecoder::~CCRDecoder() = default;
+
+void CCRDecoder::setSection(ArrayRef<uint8_t> SectionBytes, uint64_t Addr) {
+  Bytes = SectionBytes;
+  SectionAddr = Addr;
+  WindowBegin = WindowEnd = 0;
+  Window.clear();
+}
+
+void CCRDecoder::decodeWindow(size_t First) {
+  ArrayRef<CCRBasicBlock> BBLs = B.basicBlocks();
+  WindowBegin = First;
+  WindowEnd = std::min(BBLs.size(), First + WindowSize);
+  Window.assign(WindowEnd - WindowBegin, {});
+  size_t NumGroups = DisAsms.size();
+  size_t PerGroup = (WindowEnd - WindowBegin + NumGroups - 1) / NumGroups;
+  parallel::for_each_n(parallel::par, (size_t)0, NumGroups, [&](size_t G) {
+    MCDisassembler &DisAsm = *DisAsms[G];
+    size_t Begin = WindowBegin + G * PerGroup;
+    size_t End = std::min(WindowEnd, Begin + PerGroup);
+    for (size_t I = Begin; I < End; ++I) {
+      const CCRBasicBlock &BBL = BBLs[I];
+      if (BBL.Addr < SectionAddr ||
+          BBL.Addr + BBL.CodeSize > SectionAddr + Bytes.size())
+        continue;
+      std::vector<CCRDecodedInst> &Insts = Window[I - WindowBegin];
+      uint64_t Index = BBL.Addr - SectionAddr;
+      uint64_t CodeEnd = Index + BBL.CodeSize;
+      while (Index < CodeEnd) {
+        Insts.emplace_back();
+        CCRDecodedInst &D = Insts.back();
+        raw_string_ostream Comments(D.Comment);
+        D.Addr = SectionAddr + Index;
+        D.Valid = DisAsm.getInstruction(D.Inst, D.Size,
+                                        Bytes.slice(Index, CodeEnd - Index),
+                                        D.Addr, nulls(), Comments);
+        Comments.flush();
+        if (D.Size == 0)
+          D.Size = 1;
+        Index += D.Size;
+      }
+    }
+  });
+}
+
+const CCRDecodedInst *CCRDecoder::lookup(size_t BBL, uint64_t Addr) {
+  if (DisAsms.empty())
+    return nullptr;
+  if (BBL < WindowBegin || BBL >= WindowEnd)
+    decodeWindow(BBL);
+  ArrayRef<CCRDecodedInst> Insts = Window[BBL - WindowBegin];
+  auto It = llvm::lower_bound(Insts, Addr,
+                              [](const CCRDecodedInst &D, uint64_t A) {
+                                return D.Addr < A;
+                              });
+  return It != Insts.end() && It->Addr == Addr ? &*It : nullptr;
+}
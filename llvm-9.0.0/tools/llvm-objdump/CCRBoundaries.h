@@ -0,0 +1,105 @@
+//===-- CCRBoundaries.h - BBL boundaries of CCR binaries --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: --ccr-boundaries. A binary built with CCR records the BBLs of its
+// .text in .rand (and a randomized one their new places in the BBL address
+// map, .ccr_bb_addr_map), thus the disassembly starts afresh at every BBL
+// rather than sweeping through whatever precedes it: a jump table in the
+// code, the padding after a BBL or a mis-decoded instruction ends with its
+// BBL. The jump tables within .text are dumped as data; the padding is
+// skipped. The instructions of a window of BBLs are decoded ahead of the
+// printer on all threads, a disassembler each.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_OBJDUMP_CCRBOUNDARIES_H
+#define LLVM_TOOLS_LLVM_OBJDUMP_CCRBOUNDARIES_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+class MCContext;
+class MCDisassembler;
+class MCSubtargetInfo;
+class Target;
+
+namespace object {
+class ObjectFile;
+}
+
+struct CCRBasicBlock {
+  uint64_t Addr = 0;
+  uint64_t CodeSize = 0; // Without its trailing padding
+  uint64_t Size = 0;
+  uint64_t ID = 0;       // Index of the BBL in .rand
+  uint64_t Function = 0; // ... and of its function
+};
+
+class CCRBoundaries {
+  std::vector<CCRBasicBlock> BBLs;                 // By address
+  std::vector<std::pair<uint64_t, uint64_t>> Data; // [Begin, End) by Begin
+
+public:
+  /// The BBLs of \p Obj: those of its BBL address map if it has been
+  /// randomized with one, otherwise those of its .rand section. Returns None
+  /// if it has neither.
+  static Expected<Optional<CCRBoundaries>> create(const object::ObjectFile &Obj);
+
+  ArrayRef<CCRBasicBlock> basicBlocks() const { return BBLs; }
+
+  /// The index of the BBL that holds \p Addr, or -1.
+  int64_t find(uint64_t Addr) const;
+
+  /// The end of the jump table that holds \p Addr, if any.
+  Optional<uint64_t> getDataEnd(uint64_t Addr) const;
+};
+
+/// An instruction of a BBL, decoded ahead of the printer.
+struct CCRDecodedInst {
+  uint64_t Addr = 0;
+  uint64_t Size = 0;
+  bool Valid = false;
+  MCInst Inst;
+  std::string Comment;
+};
+
+class CCRDecoder {
+  const CCRBoundaries &B;
+  std::vector<std::unique_ptr<MCDisassembler>> DisAsms; // One per thread
+  ArrayRef<uint8_t> Bytes;
+  uint64_t SectionAddr = 0;
+  size_t WindowBegin = 0, WindowEnd = 0; // Of the BBLs decoded
+  std::vector<std::vector<CCRDecodedInst>> Window;
+
+  void decodeWindow(size_t First);
+
+public:
+  CCRDecoder(const Target &T, const MCSubtargetInfo &STI, MCContext &Ctx,
+             const CCRBoundaries &B);
+  ~CCRDecoder();
+
+  /// Decode the BBLs of the section \p Bytes at \p Addr from now on.
+  void setSection(ArrayRef<uint8_t> SectionBytes, uint64_t Addr);
+
+  /// The instruction at \p Addr of the \p BBL-th BBL (whose code holds it),
+  /// or null if none starts there. The BBLs are meant to be asked for in
+  /// ascending order; the window moves along.
+  const CCRDecodedInst *lookup(size_t BBL, uint64_t Addr);
+};
+
+} // end namespace llvm
+
+#endif
@@ -16,6 +16,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm-objdump.h"
+#include "CCRBoundaries.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetOperations.h"
@@ -141,6 +142,15 @@ static cl::alias DisassembleAllShort("D",
                                      cl::NotHidden, cl::Grouping,
                                      cl::aliasopt(DisassembleAll));
 
+// Koo: --ccr-boundaries (see CCRBoundaries.h)
+static cl::opt<bool> CCRBoundariesOpt(
+    "ccr-boundaries",
+    cl::desc("Disassemble the code of a binary built with CCR by the BBLs "
+             "that .rand (or the BBL address map) records: each starts "
+             "decoding afresh and is annotated with its index, the padding "
+             "is skipped and the jump tables in the code are dumped as data"),
+    cl::cat(ObjdumpCat));
+
 static cl::list<std::string>
     DisassembleFunctions("disassemble-functions", cl::CommaSeparated,
                          cl::desc("List of functions to disassemble"),
@@ -1065,6 +1075,18 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
   StringSaver Saver(A);
   addPltEntries(Obj, AllSymbols, Saver);
 
+  Optional<CCRBoundaries> Boundaries;
+  std::unique_ptr<CCRDecoder> Decoder;
+  if (CCRBoundariesOpt) {
+    Boundaries = unwrapOrError(CCRBoundaries::create(*Obj), FileName);
+    if (Boundaries)
+      Decoder = llvm::make_unique<CCRDecoder>(*TheTarget, *STI, Ctx,
+                                              *Boundaries);
+    else
+      warn("'" + FileName + "' has no .rand section; --ccr-boundaries "
+           "is ignored");
+  }
+
   // Create a mapping from virtual address to section.
   std::vector<std::pair<uint64_t, SectionRef>> SectionAddresses;
   for (SectionRef Sec : Obj->sections())
@@ -1171,6 +1193,8 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
     uint64_t VMAAdjustment = 0;
     if (shouldAdjustVA(Section))
       VMAAdjustment = AdjustVMA;
+    if (Decoder)
+      Decoder->setSection(Bytes, SectionAddr);
 
     uint64_t Size;
     uint64_t Index;
@@ -1286,9 +1310,39 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
           continue;
         }
 
+        // The BBL at hand (if any) bounds the instructions, which have been
+        // decoded ahead; its padding is skipped, as are the jump tables
+        const CCRDecodedInst *Decoded = nullptr;
+        ArrayRef<uint8_t> InstBytes = Bytes.slice(Index);
+        if (Boundaries) {
+          uint64_t Addr = SectionAddr + Index;
+          if (Optional<uint64_t> DataEnd = Boundaries->getDataEnd(Addr)) {
+            uint64_t DumpEnd = std::min(End, *DataEnd - SectionAddr);
+            dumpELFData(SectionAddr, Index, DumpEnd, Bytes);
+            Index = DumpEnd;
+            continue;
+          }
+          int64_t BBL = Boundaries->find(Addr);
+          if (BBL >= 0) {
+            const CCRBasicBlock &BB = Boundaries->basicBlocks()[BBL];
+            if (Addr >= BB.Addr + BB.CodeSize) {
+              uint64_t PadEnd = std::min(End, BB.Addr + BB.Size - SectionAddr);
+              outs() << "\t\t... (" << PadEnd - Index
+                     << " bytes of padding)\n";
+              Index = PadEnd;
+              continue;
+            }
+            if (Addr == BB.Addr)
+              outs() << "; BBL " << BB.ID << " (function " << BB.Function
+                     << ")\n";
+            InstBytes = Bytes.slice(Index, BB.Addr + BB.CodeSize - Addr);
+            Decoded = Decoder->lookup(BBL, Addr);
+          }
+        }
+
         // When -z or --disassemble-zeroes are given we always dissasemble
         // them. Otherwise we might want to skip zero bytes we see.
-        if (!DisassembleZeroes) {
+        if (!DisassembleZeroes && !Decoded) {
           uint64_t MaxOffset = End - Index;
           // For -reloc: print zero blocks patched by relocations, so that
           // relocations can be shown in the dump.
@@ -1306,9 +1360,17 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
         // Disassemble a real instruction or a data when disassemble all is
         // provided
         MCInst Inst;
-        bool Disassembled = DisAsm->getInstruction(
-            Inst, Size, Bytes.slice(Index), SectionAddr + Index, DebugOut,
-            CommentStream);
+        bool Disassembled;
+        if (Decoded) {
+          Inst = Decoded->Inst;
+          Size = Decoded->Size;
+          Disassembled = Decoded->Valid;
+          CommentStream << Decoded->Comment;
+        } else {
+          Disassembled = DisAsm->getInstruction(Inst, Size, InstBytes,
+                                                SectionAddr + Index, DebugOut,
+                                                CommentStream);
+        }
         if (Size == 0)
           Size = 1;
 
@@ -0,0 +1,634 @@
+//===-- CCRRandDumper.cpp - CCR .rand section dumper ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Koo: The ReorderInfo message is walked at the wire level: its top-level
+// fields are visited in order, and only the submessage at hand (a BBL or a
+// fixup of format 1, or a column group of format 2) is decoded, which keeps
+// the memory bounded on large binaries and tells the bytes of every field.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CCRRandDumper.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Object/Error.h"
+#include "llvm/Object/RandChunk.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/ScopedPrinter.h"
+#include "llvm/Support/shuffleInfo.pb.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::object;
+
+namespace {
+
+enum { NumFixupKinds = 11 };
+
+const char *const FixupKindNames[NumFixupKinds] = {
+    "text", "rodata", "data", "datarel", "initarray", "finiarray", "tdata",
+    "xray", "patchable", "jumptable", "custom"};
+
+// The field names of ReorderInfo, and of the column groups, by number
+const char *const ReorderInfoFields[] = {
+    nullptr,
+    "bin",
+    "layout",
+    "fixup",
+    "source",
+    "section_names",
+    "layout_columns",
+    "text_fixup_columns",
+    "rodata_fixup_columns",
+    "data_fixup_columns",
+    "datarel_fixup_columns",
+    "initarray_fixup_columns",
+    "finiarray_fixup_columns",
+    "tdata_fixup_columns",
+    "call_site_columns",
+    "xray_fixup_columns",
+    "patchable_fixup_columns",
+    "jumptable_fixup_columns",
+    "custom_fixup_columns"};
+
+const char *const LayoutColumnFields[] = {
+    nullptr,        "bb_size",      "type_bits",        "fallthrough_bits",
+    "num_fixups",   "section_idx",  "hotness_bits",     "padding_sz",
+    "align_bits",   "loop_header_bits", "cfi_bits",         "pinned_bits",
+    "chain_start_bits", "edge_prob_bits", "function_name_hash",
+    "function_content_hash", "term_bits", "boundary"};
+
+const char *const FixupColumnFields[] = {
+    nullptr,           "offset_delta",       "deref_sz",
+    "is_rela_bits",    "new_section_bits",   "section_idx",
+    "jt_fixup_idx",    "num_jt_entries",     "jt_entry_sz",
+    "relax_fixup_idx", "relax_short_sz",     "relax_long_form",
+    "relax_fixup_offset", "target_bits",     "reach_fixup_idx",
+    "reach_log2",      "ref_class_bits",     "jt_func_rel_bits",
+    "scope_bits",      "pair_fixup_idx",     "pair_delta",
+    "shrink_fixup_idx", "shrink_long_sz",    "shrink_short_form",
+    "reloc_delta",     "got_relax_bits"};
+
+Error createError(const Twine &Msg) {
+  return make_error<StringError>(Msg, object_error::parse_failed);
+}
+
+template <size_t N>
+std::string getFieldName(const char *const (&Names)[N], unsigned Field) {
+  if (Field < N && Names[Field])
+    return Names[Field];
+  return "#" + utostr(Field);
+}
+
+// A field of a message in the protobuf wire format
+struct WireField {
+  unsigned Number = 0;
+  unsigned WireType = 0;
+  uint64_t Value = 0;       // Varint and fixed-size fields
+  ArrayRef<uint8_t> Data;   // Length-delimited fields
+  uint64_t Size = 0;        // Including the tag
+};
+
+class WireReader {
+  ArrayRef<uint8_t> Buf;
+  uint64_t Pos = 0;
+
+  Expected<uint64_t> readVarint() {
+    unsigned N;
+    const char *Err = nullptr;
+    uint64_t V = decodeULEB128(Buf.data() + Pos, &N, Buf.data() + Buf.size(),
+                               &Err);
+    if (Err)
+      return createError("malformed varint at offset " + Twine(Pos));
+    Pos += N;
+    return V;
+  }
+
+public:
+  explicit WireReader(ArrayRef<uint8_t> Buf) : Buf(Buf) {}
+
+  bool atEnd() const { return Pos >= Buf.size(); }
+
+  Expected<WireField> next() {
+    WireField F;
+    uint64_t Start = Pos;
+    Expected<uint64_t> Tag = readVarint();
+    if (!Tag)
+      return Tag.takeError();
+    F.Number = *Tag >> 3;
+    F.WireType = *Tag & 7;
+    switch (F.WireType) {
+    case 0: { // Varint
+      Expected<uint64_t> V = readVarint();
+      if (!V)
+        return V.takeError();
+      F.Value = *V;
+      break;
+    }
+    case 1: // 64-bit
+    case 5: { // 32-bit
+      uint64_t Len = F.WireType == 1 ? 8 : 4;
+      if (Pos + Len > Buf.size())
+        return createError("truncated field #" + Twine(F.Number));
+      for (uint64_t I = 0; I != Len; ++I)
+        F.Value |= uint64_t(Buf[Pos + I]) << (8 * I);
+      Pos += Len;
+      break;
+    }
+    case 2: { // Length-delimited
+      Expected<uint64_t> Len = readVarint();
+      if (!Len)
+        return Len.takeError();
+      if (*Len > Buf.size() - Pos)
+        return createError("truncated field #" + Twine(F.Number));
+      F.Data = Buf.slice(Pos, *Len);
+      Pos += *Len;
+      break;
+    }
+    default:
+      return createError("unsupported wire type " + Twine(F.WireType) +
+                         " of field #" + Twine(F.Number));
+    }
+    F.Size = Pos - Start;
+    return F;
+  }
+};
+
+template <typename ColumnT>
+uint64_t getBits(const ColumnT &Bits, unsigned Idx, unsigned Width) {
+  unsigned PerWord = 64 / Width;
+  if (Idx / PerWord >= (unsigned)Bits.size())
+    return 0;
+  return (Bits.Get(Idx / PerWord) >> ((Idx % PerWord) * Width)) &
+         ((1ULL << Width) - 1);
+}
+
+template <typename MessageT>
+Error parseMessage(MessageT &M, ArrayRef<uint8_t> Data, StringRef Name) {
+  if (!M.ParseFromArray(Data.data(), Data.size()))
+    return createError("malformed " + Name + " message");
+  return Error::success();
+}
+
+struct FieldUsage {
+  uint64_t Count = 0;
+  uint64_t Bytes = 0;
+};
+
+struct RandSummary {
+  uint64_t NumMessages = 0;
+  uint64_t ObjSize = 0;
+  uint64_t NumBBLs = 0;
+  uint64_t NumFunctions = 0;
+  uint64_t NumNamedFunctions = 0; // With a name hash (format 2 or 3)
+  uint64_t NumObjects = 0;
+  uint64_t NumFixups[NumFixupKinds] = {};
+  uint64_t NumJumpTables = 0;
+  uint64_t NumJTEntries = 0;
+  uint64_t NumRelaxable = 0;
+  uint64_t NumShrinkable = 0;
+  std::map<unsigned, uint64_t> Formats;     // format_version -> messages
+  std::map<unsigned, uint64_t> SourceTypes; // src_type -> messages
+  std::map<std::string, FieldUsage> Fields;
+};
+
+class RandDumper {
+  ScopedPrinter &W;
+  bool Full;
+  RandSummary S;
+  bool DeltaOffsets = false;
+
+  void addField(const std::string &Name, uint64_t Bytes) {
+    FieldUsage &U = S.Fields[Name];
+    U.Count++;
+    U.Bytes += Bytes;
+  }
+
+  // Account the bytes of every field of a column group
+  template <size_t N>
+  Error addColumnFields(ArrayRef<uint8_t> Data, StringRef Group,
+                        const char *const (&Names)[N]) {
+    WireReader R(Data);
+    while (!R.atEnd()) {
+      Expected<WireField> F = R.next();
+      if (!F)
+        return F.takeError();
+      addField((Group + "." + getFieldName(Names, F->Number)).str(), F->Size);
+    }
+    return Error::success();
+  }
+
+  void countBBL(unsigned Type) {
+    S.NumBBLs++;
+    if (Type >= 1)
+      S.NumFunctions++;
+    if (Type == 2)
+      S.NumObjects++;
+  }
+
+  void printBBL(uint64_t Idx, uint32_t Size, unsigned Type, bool FallThrough,
+                uint32_t Padding, unsigned AlignLog2, bool LoopHeader,
+                unsigned Hotness, uint32_t NumFixups, uint32_t SectionIdx,
+                bool Pinned, bool ChainStart, unsigned EdgeProb,
+                unsigned Term, uint32_t Boundary) {
+    static const char *const Types[] = {"MBB", "MF", "Obj"};
+    static const char *const Hotnesses[] = {"-", "hot", "cold"};
+    static const char *const TermKinds[] = {"insn", "jmp", "jcc", "ret",
+                                            "indirect"};
+    raw_ostream &OS = W.startLine();
+    OS << format("BBL %6" PRIu64 ": size=%-5u %-3s ", Idx, Size,
+                 Type < 3 ? Types[Type] : "?")
+       << (FallThrough ? "ft " : "   ")
+       << format("pad=%-3u align=%-2u fixups=%-3u sec=%-3u %s%s%s", Padding,
+                 1U << AlignLog2, NumFixups, SectionIdx,
+                 Hotness < 3 ? Hotnesses[Hotness] : "?",
+                 LoopHeader ? " loop" : "", Pinned ? " pinned" : "");
+    if (ChainStart)
+      OS << " chain";
+    if (EdgeProb)
+      OS << format(" edge=%u/15", EdgeProb);
+    if (Term)
+      OS << format(" term=%s:%u", (Term >> 4) < 5 ? TermKinds[Term >> 4] : "?",
+                   Term & 15);
+    if (Boundary & 0xf0)
+      OS << format(" boundary=%u:%u@%u", 1U << ((Boundary >> 4) & 15),
+                   Boundary & 15, Boundary >> 8);
+    OS << "\n";
+  }
+
+  void printFixup(StringRef Kind, uint64_t Idx, uint64_t Offset,
+                  uint32_t DerefSize, bool IsRela, unsigned Target,
+                  unsigned RefClass, uint32_t SectionIdx, uint32_t NumJTEntries,
+                  uint32_t JTEntrySize, bool JTFunctionRelative,
+                  uint32_t RelaxShortSize, uint32_t ShrinkLongSize,
+                  unsigned Scope, uint32_t PairDelta, uint32_t RelocIdx,
+                  unsigned GOTRelax) {
+    static const char *const Targets[] = {"?", "code", "data"};
+    static const char *const Classes[] = {"direct", "plt", "got", "tls"};
+    static const char *const Scopes[] = {"", " intra-object", " intra-function"};
+    static const char *const GOTRelaxes[] = {"", " gotpcrelx", " rex_gotpcrelx"};
+    raw_ostream &OS = W.startLine();
+    OS << format("Fixup %-9s %6" PRIu64 ": offset=0x%-8" PRIx64
+                 " size=%u %-5s target=%-4s %-6s sec=%u",
+                 Kind.str().c_str(), Idx, Offset, DerefSize,
+                 IsRela ? "pcrel" : "abs", Target < 3 ? Targets[Target] : "!",
+                 RefClass < 4 ? Classes[RefClass] : "!", SectionIdx);
+    if (NumJTEntries)
+      OS << format(" jt=%ux%u%s", NumJTEntries, JTEntrySize,
+                   JTFunctionRelative ? "@func" : "");
+    if (RelaxShortSize)
+      OS << format(" relax=%u", RelaxShortSize);
+    if (ShrinkLongSize)
+      OS << format(" shrink=%u", ShrinkLongSize);
+    OS << (Scope < 3 ? Scopes[Scope] : " scope=!");
+    if (PairDelta)
+      OS << format(" pair=-%u", PairDelta);
+    if (RelocIdx)
+      OS << format(" reloc=%u", RelocIdx - 1);
+    OS << (GOTRelax < 3 ? GOTRelaxes[GOTRelax] : " got_relax=!");
+    OS << "\n";
+  }
+
+  Error dumpBinaryInfo(ArrayRef<uint8_t> Data) {
+    ShuffleInfo::ReorderInfo_BinaryInfo Bin;
+    if (Error E = parseMessage(Bin, Data, "BinaryInfo"))
+      return E;
+    unsigned Format = Bin.has_format_version() ? Bin.format_version() : 1;
+    S.Formats[Format]++;
+    S.SourceTypes[Bin.src_type()]++;
+    S.ObjSize += Bin.obj_sz();
+    DeltaOffsets = Bin.fixup_offset_encoding() == 1;
+    if (Full) {
+      DictScope D(W, "BinaryInfo");
+      W.printNumber("FormatVersion", Format);
+      W.printNumber("SourceType", Bin.src_type());
+      W.printHex("RandObjOffset", Bin.rand_obj_offset());
+      W.printHex("MainAddrOffset", Bin.main_addr_offset());
+      W.printNumber("ObjectSize", Bin.obj_sz());
+      W.printNumber("FixupOffsetEncoding", Bin.fixup_offset_encoding());
+      if (Bin.fixups_from_relocs())
+        W.printBoolean("FixupsFromRelocs", true);
+      if (Bin.data_fixups())
+        W.printBoolean("DataFixups", true);
+    }
+    return Error::success();
+  }
+
+  Error dumpLayout(ArrayRef<uint8_t> Data) {
+    ShuffleInfo::ReorderInfo_LayoutInfo L;
+    if (Error E = parseMessage(L, Data, "LayoutInfo"))
+      return E;
+    if (Full)
+      printBBL(S.NumBBLs, L.bb_size(), L.type(), L.bb_fallthrough(),
+               L.padding_sz(), std::min(L.align_log2(), 15U), L.loop_header(),
+               L.hotness(), L.num_fixups(), L.section_idx(), L.pinned(),
+               L.chain_start(), std::min(L.edge_prob(), 15U), L.term() & 255,
+               L.boundary());
+    countBBL(L.type());
+    return Error::success();
+  }
+
+  // A FixupInfo holds the FixupTuples of every kind of section, one field
+  // per kind, each of which is decoded on its own
+  Error dumpFixupInfo(ArrayRef<uint8_t> Data) {
+    uint32_t PrevOffset[NumFixupKinds] = {};
+    WireReader R(Data);
+    while (!R.atEnd()) {
+      Expected<WireField> F = R.next();
+      if (!F)
+        return F.takeError();
+      unsigned K = F->Number - 1;
+      if (F->WireType != 2 || K >= NumFixupKinds)
+        continue;
+      ShuffleInfo::ReorderInfo_FixupInfo_FixupTuple T;
+      if (Error E = parseMessage(T, F->Data, "FixupTuple"))
+        return E;
+      addField(std::string("fixup.") + FixupKindNames[K], F->Size);
+      uint32_t Offset = DeltaOffsets ? PrevOffset[K] + T.offset() : T.offset();
+      PrevOffset[K] = Offset;
+      if (T.num_jt_entries()) {
+        S.NumJumpTables++;
+        S.NumJTEntries += T.num_jt_entries();
+      }
+      if (T.relax_short_sz())
+        S.NumRelaxable++;
+      if (T.shrink_long_sz())
+        S.NumShrinkable++;
+      if (Full)
+        printFixup(FixupKindNames[K], S.NumFixups[K], Offset, T.deref_sz(),
+                   T.is_rela(), T.target(), T.ref_class(), T.section_idx(),
+                   T.num_jt_entries(), T.jt_entry_sz(), T.jt_func_rel(),
+                   T.relax_short_sz(), T.shrink_long_sz(), T.scope(),
+                   T.pair_delta(), T.reloc_idx(), T.got_relax());
+      S.NumFixups[K]++;
+    }
+    return Error::success();
+  }
+
+  Error dumpLayoutColumns(ArrayRef<uint8_t> Data) {
+    if (Error E = addColumnFields(Data, "layout_columns", LayoutColumnFields))
+      return E;
+    ShuffleInfo::ReorderInfo_LayoutColumns C;
+    if (Error E = parseMessage(C, Data, "LayoutColumns"))
+      return E;
+    int N = C.bb_size_size();
+    if (C.num_fixups_size() != N || C.padding_sz_size() != N ||
+        C.section_idx_size() > N)
+      return createError("inconsistent layout columns");
+    uint64_t FirstFunction = S.NumFunctions;
+    for (int I = 0; I < N; ++I) {
+      unsigned Type = getBits(C.type_bits(), I, 2);
+      if (Full)
+        printBBL(S.NumBBLs, C.bb_size(I), Type,
+                 getBits(C.fallthrough_bits(), I, 1), C.padding_sz(I),
+                 getBits(C.align_bits(), I, 4),
+                 getBits(C.loop_header_bits(), I, 1),
+                 getBits(C.hotness_bits(), I, 2), C.num_fixups(I),
+                 I < C.section_idx_size() ? C.section_idx(I) : 0,
+                 getBits(C.pinned_bits(), I, 1),
+                 getBits(C.chain_start_bits(), I, 1),
+                 getBits(C.edge_prob_bits(), I, 4),
+                 getBits(C.term_bits(), I, 8),
+                 I < C.boundary_size() ? C.boundary(I) : 0);
+      countBBL(Type);
+    }
+
+    // The identities of the functions, one per function (if any)
+    int NumNames = C.function_name_hash_size();
+    int NumContents = C.function_content_hash_size();
+    if (NumNames && NumContents && NumNames != NumContents)
+      return createError("inconsistent function identities");
+    for (int I = 0; I < NumNames; ++I)
+      S.NumNamedFunctions += C.function_name_hash(I) != 0;
+    if (Full)
+      for (int I = 0, E = std::max(NumNames, NumContents); I < E; ++I) {
+        raw_ostream &OS = W.startLine();
+        OS << format("Function %6" PRIu64 ":", FirstFunction + I);
+        if (NumNames)
+          OS << format(" name=0x%016" PRIx64, uint64_t(C.function_name_hash(I)));
+        if (NumContents)
+          OS << format(" content=0x%016" PRIx64,
+                       uint64_t(C.function_content_hash(I)));
+        OS << "\n";
+      }
+    return Error::success();
+  }
+
+  Error dumpFixupColumns(unsigned K, ArrayRef<uint8_t> Data) {
+    std::string Group = std::string(FixupKindNames[K]) + "_fixup_columns";
+    if (Error E = addColumnFields(Data, Group, FixupColumnFields))
+      return E;
+    ShuffleInfo::ReorderInfo_FixupColumns C;
+    if (Error E = parseMessage(C, Data, Group))
+      return E;
+    int N = C.offset_delta_size();
+    if (C.deref_sz_size() != N ||
+        (C.section_idx_size() && C.section_idx_size() != N) ||
+        C.jt_fixup_idx_size() != C.num_jt_entries_size() ||
+        C.jt_fixup_idx_size() != C.jt_entry_sz_size() ||
+        C.relax_fixup_idx_size() != C.relax_short_sz_size() ||
+        C.shrink_fixup_idx_size() != C.shrink_long_sz_size() ||
+        C.pair_fixup_idx_size() != C.pair_delta_size() ||
+        (C.reloc_delta_size() && C.reloc_delta_size() != N))
+      return createError("inconsistent " + Group);
+    S.NumJumpTables += C.jt_fixup_idx_size();
+    for (int I = 0, E = C.num_jt_entries_size(); I < E; ++I)
+      S.NumJTEntries += C.num_jt_entries(I);
+    S.NumRelaxable += C.relax_fixup_idx_size();
+    S.NumShrinkable += C.shrink_fixup_idx_size();
+
+    if (Full) {
+      // The sparse columns refer to the fixups by index (in order)
+      int JT = 0, Relax = 0, Shrink = 0, Pair = 0;
+      int64_t Offset = 0;
+      uint32_t PrevRelocIdx = 0;
+      for (int I = 0; I < N; ++I) {
+        Offset += C.offset_delta(I);
+        // The relocation indices are deltas within the section of the fixups
+        uint32_t RelocIdx = 0;
+        if (getBits(C.new_section_bits(), I, 1))
+          PrevRelocIdx = 0;
+        if (C.reloc_delta_size() && C.reloc_delta(I))
+          PrevRelocIdx = RelocIdx = PrevRelocIdx + C.reloc_delta(I);
+        uint32_t NumJTEntries = 0, JTEntrySize = 0, RelaxShortSize = 0,
+                 ShrinkLongSize = 0, PairDelta = 0;
+        bool JTFunctionRelative = false;
+        if (JT < C.jt_fixup_idx_size() && C.jt_fixup_idx(JT) == (uint32_t)I) {
+          NumJTEntries = C.num_jt_entries(JT);
+          JTFunctionRelative = getBits(C.jt_func_rel_bits(), JT, 1);
+          JTEntrySize = C.jt_entry_sz(JT++);
+        }
+        if (Relax < C.relax_fixup_idx_size() &&
+            C.relax_fixup_idx(Relax) == (uint32_t)I)
+          RelaxShortSize = C.relax_short_sz(Relax++);
+        if (Shrink < C.shrink_fixup_idx_size() &&
+            C.shrink_fixup_idx(Shrink) == (uint32_t)I)
+          ShrinkLongSize = C.shrink_long_sz(Shrink++);
+        if (Pair < C.pair_fixup_idx_size() && C.pair_fixup_idx(Pair) == (uint32_t)I)
+          PairDelta = C.pair_delta(Pair++);
+        printFixup(FixupKindNames[K], S.NumFixups[K] + I, Offset,
+                   C.deref_sz(I), getBits(C.is_rela_bits(), I, 1),
+                   getBits(C.target_bits(), I, 2),
+                   getBits(C.ref_class_bits(), I, 2),
+                   C.section_idx_size() ? C.section_idx(I) : 0, NumJTEntries,
+                   JTEntrySize, JTFunctionRelative, RelaxShortSize,
+                   ShrinkLongSize, getBits(C.scope_bits(), I, 2), PairDelta,
+                   RelocIdx, getBits(C.got_relax_bits(), I, 2));
+      }
+    }
+    S.NumFixups[K] += N;
+    return Error::success();
+  }
+
+public:
+  RandDumper(ScopedPrinter &W, bool Full) : W(W), Full(Full) {}
+
+  Error dumpMessage(ArrayRef<uint8_t> Payload) {
+    S.NumMessages++;
+    DeltaOffsets = false;
+    uint64_t NumSections = 0;
+    WireReader R(Payload);
+    while (!R.atEnd()) {
+      Expected<WireField> F = R.next();
+      if (!F)
+        return F.takeError();
+      // The repeated v1 submessages are accounted per record below
+      if (F->Number != 3)
+        addField(getFieldName(ReorderInfoFields, F->Number), F->Size);
+      if (F->WireType != 2)
+        continue;
+
+      Error E = Error::success();
+      switch (F->Number) {
+      case 1:
+        E = dumpBinaryInfo(F->Data);
+        break;
+      case 2:
+        E = dumpLayout(F->Data);
+        break;
+      case 3:
+        E = dumpFixupInfo(F->Data);
+        break;
+      case 4:
+        break;
+      case 5:
+        if (Full)
+          W.printString("Section " + utostr(NumSections),
+                        toStringRef(F->Data));
+        NumSections++;
+        break;
+      case 6:
+        E = dumpLayoutColumns(F->Data);
+        break;
+      default:
+        // The columns of the optional kinds (XRay on, 15 on) follow the
+        // call-site tables (14)
+        if (F->Number >= 7 && F->Number < 14)
+          E = dumpFixupColumns(F->Number - 7, F->Data);
+        else if (F->Number >= 15 && F->Number < 8 + NumFixupKinds)
+          E = dumpFixupColumns(F->Number - 8, F->Data);
+        break;
+      }
+      if (E)
+        return E;
+    }
+    return Error::success();
+  }
+
+  void printChunk(const RandChunkRef &C, uint64_t Idx) {
+    const ccr::ChunkHeader &H = C.getHeader();
+    W.startLine() << format("Chunk %" PRIu64 ": payload=%" PRIu64
+                            " layouts=%u fixups=%u objoff=0x%" PRIx64
+                            " mainoff=0x%" PRIx64 "\n",
+                            Idx, uint64_t(H.PayloadSize), uint32_t(H.NumLayouts),
+                            uint32_t(H.NumFixups), uint64_t(H.RandObjOffset),
+                            uint64_t(H.MainAddrOffset));
+    if (H.ShapeHash || C.hasSharedPayload()) {
+      W.startLine() << format("  shape=0x%016" PRIx64, uint64_t(H.ShapeHash));
+      if (C.hasSharedPayload())
+        W.getOStream() << format(" (payload of the chunk at 0x%" PRIx64 ")",
+                                 uint64_t(H.PayloadRef));
+      W.getOStream() << "\n";
+    }
+    for (const ccr::ChunkSection &Sec : C.getSections()) {
+      W.startLine() << "  " << C.getSectionName(Sec) << " #" << Sec.Ordinal;
+      if (Sec.Base == ccr::ChunkSection::DiscardedBase)
+        W.getOStream() << " (discarded)\n";
+      else
+        W.getOStream() << format(" at 0x%" PRIx64 "\n", uint64_t(Sec.Base));
+    }
+  }
+
+  void printSummary(uint64_t NumChunks) {
+    DictScope D(W, "Summary");
+    for (const auto &F : S.Formats)
+      W.printNumber("Format " + utostr(F.first) + " messages", F.second);
+    if (NumChunks)
+      W.printNumber("Chunks", NumChunks);
+    for (const auto &T : S.SourceTypes)
+      W.printNumber("SourceType " + utostr(T.first) + " messages", T.second);
+    W.printNumber("ObjectSize", S.ObjSize);
+    W.printNumber("BBLs", S.NumBBLs);
+    W.printNumber("Functions", S.NumFunctions);
+    W.printNumber("NamedFunctions", S.NumNamedFunctions);
+    W.printNumber("Objects", S.NumObjects);
+    {
+      DictScope F(W, "Fixups");
+      uint64_t Total = 0;
+      for (unsigned K = 0; K < NumFixupKinds; ++K) {
+        W.printNumber(FixupKindNames[K], S.NumFixups[K]);
+        Total += S.NumFixups[K];
+      }
+      W.printNumber("Total", Total);
+    }
+    W.printNumber("JumpTables", S.NumJumpTables);
+    W.printNumber("JumpTableEntries", S.NumJTEntries);
+    W.printNumber("RelaxableFixups", S.NumRelaxable);
+    W.printNumber("ShrinkableFixups", S.NumShrinkable);
+    ListScope L(W, "FieldBytes");
+    for (const auto &F : S.Fields)
+      W.startLine() << format("%-36s %10" PRIu64 " B in %" PRIu64 "\n",
+                              F.first.c_str(), F.second.Bytes, F.second.Count);
+  }
+};
+
+} // end anonymous namespace
+
+Error llvm::dumpCCRRandSection(StringRef Name, ArrayRef<uint8_t> Contents,
+                               ScopedPrinter &W, bool Full) {
+  auto annotate = [&](Error E) {
+    return createError(Name + ": " + toString(std::move(E)));
+  };
+  RandDumper D(W, Full);
+  uint64_t NumChunks = 0;
+  {
+    Optional<ListScope> Records;
+    if (Full)
+      Records.emplace(W, "Records");
+    if (isRandChunked(Contents)) {
+      Expected<std::vector<RandChunkRef>> Chunks = readRandChunks(Contents);
+      if (!Chunks)
+        return annotate(Chunks.takeError());
+      for (const RandChunkRef &C : *Chunks) {
+        if (Full)
+          D.printChunk(C, NumChunks);
+        NumChunks++;
+        if (Error E = D.dumpMessage(C.getPayload()))
+          return annotate(std::move(E));
+      }
+    } else if (Error E = D.dumpMessage(Contents)) {
+      return annotate(std::move(E));
+    }
+  }
+  D.printSummary(NumChunks);
+  return Error::success();
+}
@@ -0,0 +1,29 @@
+//===-- CCRRandDumper.h - CCR .rand section dumper --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_READOBJ_CCRRANDDUMPER_H
+#define LLVM_TOOLS_LLVM_READOBJ_CCRRANDDUMPER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+class ScopedPrinter;
+
+/// Koo: Dump the (uncompressed) contents of a CCR reordering information
+/// section (.rand) of any wire format: a summary of the BBLs, fixups and
+/// jump tables with the bytes that every field takes, and with \p Full every
+/// record as well. The records are printed as they are decoded, so that only
+/// one column group (or one v1 submessage) is held in memory at a time.
+Error dumpCCRRandSection(StringRef Name, ArrayRef<uint8_t> Contents,
+                         ScopedPrinter &W, bool Full);
+
+} // end namespace llvm
+
+#endif
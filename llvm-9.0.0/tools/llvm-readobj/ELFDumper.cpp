@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "ARMEHABIPrinter.h"
+#include "CCRRandDumper.h"
 #include "DwarfCFIEHPrinter.h"
 #include "Error.h"
 #include "ObjDumper.h"
@@ -31,11 +32,13 @@
 #include "llvm/BinaryFormat/AMDGPUMetadataVerifier.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Demangle/Demangle.h"
+#include "llvm/Object/Decompressor.h"
 #include "llvm/Object/ELF.h"
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/ELFTypes.h"
 #include "llvm/Object/Error.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/RandMap.h"
 #include "llvm/Object/StackMapParser.h"
 #include "llvm/Support/AMDGPUMetadata.h"
 #include "llvm/Support/ARMAttributeParser.h"
@@ -179,6 +182,10 @@ public:
 
   void printELFLinkerOptions() override;
 
+  void printCCRRand(bool Full) override;
+  void printCCRBBAddrMap() override;
+  void printCCRSyntheticSites() override;
+
 private:
   std::unique_ptr<DumpStyle<ELFT>> ELFDumperStyle;
 
@@ -2531,6 +2538,85 @@ template <class ELFT> void ELFDumper<ELFT>::printStackMap() const {
       W, StackMapParser<ELFT::TargetEndianness>(StackMapContentsArray));
 }
 
+// Koo: Every .rand section is dumped in turn; an object has one, but
+// nothing keeps a partial link (e.g., ld -r --unique) from leaving several
+template <class ELFT> void ELFDumper<ELFT>::printCCRRand(bool Full) {
+  const ELFFile<ELFT> *Obj = ObjF->getELFFile();
+  int SectionIndex = -1;
+  for (const auto &Sec : unwrapOrError(Obj->sections())) {
+    ++SectionIndex;
+    StringRef Name = unwrapOrError(Obj->getSectionName(&Sec));
+    if (Name != ".rand")
+      continue;
+
+    ArrayRef<uint8_t> Contents = unwrapOrError(Obj->getSectionContents(&Sec));
+    SmallString<0> Decompressed;
+    if (Sec.sh_flags & ELF::SHF_COMPRESSED) {
+      Expected<Decompressor> D = Decompressor::create(
+          Name, toStringRef(Contents), ELFT::TargetEndianness == support::little,
+          ELFT::Is64Bits);
+      if (!D)
+        reportError(toString(D.takeError()));
+      if (Error E = D->resizeAndDecompress(Decompressed))
+        reportError(toString(std::move(E)));
+      Contents = arrayRefFromStringRef(Decompressed);
+    }
+
+    DictScope D(W, "CCRRand");
+    W.printNumber("Section", SectionIndex);
+    W.printNumber("Size", Contents.size());
+    if (Error E = dumpCCRRandSection(Name, Contents, W, Full))
+      reportError(toString(std::move(E)));
+  }
+}
+
+template <class ELFT> void ELFDumper<ELFT>::printCCRBBAddrMap() {
+  const ELFFile<ELFT> *Obj = ObjF->getELFFile();
+  for (const auto &Sec : unwrapOrError(Obj->sections())) {
+    StringRef Name = unwrapOrError(Obj->getSectionName(&Sec));
+    if (Name != ccr::BBAddrMapHeader::SectionName)
+      continue;
+
+    ArrayRef<uint8_t> Contents = unwrapOrError(Obj->getSectionContents(&Sec));
+    std::vector<RandBBAddrEntry> Entries =
+        unwrapOrError(readRandBBAddrMap(Contents));
+    ListScope L(W, "CCRBBAddrMap");
+    for (const RandBBAddrEntry &E : Entries) {
+      DictScope D(W, "Function");
+      W.printNumber("ID", E.FunctionID);
+      ListScope BL(W, "BBLs");
+      for (const RandBBLAddress &BBL : E.BBLs) {
+        DictScope BD(W);
+        W.printNumber("ID", BBL.ID);
+        W.printHex("Address", BBL.Addr);
+        W.printNumber("Size", BBL.Size);
+      }
+    }
+  }
+}
+
+template <class ELFT> void ELFDumper<ELFT>::printCCRSyntheticSites() {
+  const ELFFile<ELFT> *Obj = ObjF->getELFFile();
+  for (const auto &Sec : unwrapOrError(Obj->sections())) {
+    StringRef Name = unwrapOrError(Obj->getSectionName(&Sec));
+    if (Name != ccr::SyntheticSitesHeader::SectionName)
+      continue;
+
+    ArrayRef<uint8_t> Contents = unwrapOrError(Obj->getSectionContents(&Sec));
+    std::vector<RandSyntheticSite> Sites =
+        unwrapOrError(readRandSyntheticSites(Contents));
+    ListScope L(W, "CCRSyntheticSites");
+    for (const RandSyntheticSite &S : Sites) {
+      DictScope D(W, "Site");
+      W.printString("Kind", getRandSyntheticSiteKindName(S.Kind));
+      W.printHex("Address", S.Addr);
+      W.printNumber("Size", S.Size);
+      W.printNumber("BBL", S.BBL);
+      W.printHex("OriginalAddress", S.OrigAddr);
+    }
+  }
+}
+
 template <class ELFT> void ELFDumper<ELFT>::printGroupSections() {
   ELFDumperStyle->printGroupSections(ObjF->getELFFile());
 }
@@ -68,6 +68,9 @@ public:
   virtual void printAddrsig() {}
   virtual void printNotes() {}
   virtual void printELFLinkerOptions() {}
+  virtual void printCCRRand(bool Full) {}
+  virtual void printCCRBBAddrMap() {}
+  virtual void printCCRSyntheticSites() {}
 
   // Only implemented for ARM ELF at this time.
   virtual void printAttributes() { }
@@ -125,6 +125,25 @@ namespace opts {
   cl::opt<bool> Notes("notes", cl::desc("Display the ELF notes in the file"));
   cl::alias NotesShort("n", cl::desc("Alias for --notes"), cl::aliasopt(Notes));
 
+  // --ccr-rand, --ccr-rand-full
+  cl::opt<bool> CCRRand("ccr-rand",
+                        cl::desc("Display a summary of the CCR reordering "
+                                 "information (.rand)"));
+  cl::opt<bool> CCRRandFull("ccr-rand-full",
+                            cl::desc("Display every BBL and fixup of the CCR "
+                                     "reordering information (.rand)"));
+
+  // --ccr-bb-addr-map
+  cl::opt<bool> CCRBBAddrMap("ccr-bb-addr-map",
+                             cl::desc("Display the CCR BBL address map "
+                                      "(.ccr_bb_addr_map)"));
+
+  // --ccr-synthetic-sites
+  cl::opt<bool> CCRSyntheticSites("ccr-synthetic-sites",
+                                  cl::desc("Display the code inserted by the "
+                                           "CCR randomizer "
+                                           "(.ccr_synthetic_sites)"));
+
   // --dyn-relocations
   cl::opt<bool> DynRelocs("dyn-relocations",
     cl::desc("Display the dynamic relocation entries in the file"));
@@ -534,6 +553,12 @@ static void dumpObject(const ObjectFile *Obj, ScopedPrinter &Writer) {
       Dumper->printAddrsig();
     if (opts::Notes)
       Dumper->printNotes();
+    if (opts::CCRRand || opts::CCRRandFull)
+      Dumper->printCCRRand(opts::CCRRandFull);
+    if (opts::CCRBBAddrMap)
+      Dumper->printCCRBBAddrMap();
+    if (opts::CCRSyntheticSites)
+      Dumper->printCCRSyntheticSites();
   }
   if (Obj->isCOFF()) {
     if (opts::COFFImports)
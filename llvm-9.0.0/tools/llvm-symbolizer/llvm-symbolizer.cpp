@@ -138,6 +138,20 @@ static cl::opt<uint64_t>
     ClAdjustVMA("adjust-vma", cl::init(0), cl::value_desc("offset"),
                 cl::desc("Add specified offset to object file addresses"));
 
+// Koo: A binary randomized by llvm-ccr-rand -address-map is symbolized through
+// its <binary>.ccrmap
+static cl::opt<bool> ClUseCCRAddressMaps(
+    "ccr-address-map", cl::init(true),
+    cl::desc("Translate the addresses of a randomized binary into its "
+             "original layout with <binary>.ccrmap"));
+
+// Koo: The code inserted by llvm-ccr-rand -synthetic-sites is told as the
+// overhead of its function
+static cl::opt<bool> ClUseCCRSyntheticSites(
+    "ccr-synthetic-sites", cl::init(true),
+    cl::desc("Report the code inserted by the CCR randomizer as the code it "
+             "stands for, marked [ccr-overhead:<kind>]"));
+
 static cl::list<std::string> ClInputAddresses(cl::Positional,
                                               cl::desc("<input addresses>..."),
                                               cl::ZeroOrMore);
@@ -273,6 +287,8 @@ int main(int argc, char **argv) {
   Opts.DefaultArch = ClDefaultArch;
   Opts.FallbackDebugPath = ClFallbackDebugPath;
   Opts.DWPName = ClDwpName;
+  Opts.UseCCRAddressMaps = ClUseCCRAddressMaps;
+  Opts.UseCCRSyntheticSites = ClUseCCRSyntheticSites;
 
   for (const auto &hint : ClDsymHint) {
     if (sys::path::extension(hint) == ".dSYM") {
@@ -2,6 +2,8 @@
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
@@ -41,6 +43,20 @@ std::unique_ptr<TargetMachine> createTargetMachine(bool EnableIPRA) {
       "X86", "", "", Options, None, None, CodeGenOpt::Aggressive));
 }
 
+/// Create the TargetMachine of the LTO backend task of M, as LTOBackend does.
+std::unique_ptr<TargetMachine> createBackendTargetMachine(const Module &M) {
+  Triple TargetTriple("x86_64--");
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget("", TargetTriple, Error);
+  if (!T)
+    return nullptr;
+
+  TargetOptions Options;
+  TargetMachine::applyCCRModuleFlags(M, Options);
+  return std::unique_ptr<TargetMachine>(T->createTargetMachine(
+      "X86", "", "", Options, None, None, CodeGenOpt::Aggressive));
+}
+
 typedef std::function<void(bool)> TargetOptionsTest;
 
 static void targetOptionsTest(bool EnableIPRA) {
@@ -69,6 +85,28 @@ TEST(TargetOptionsTest, IPRASetToOn) {
   targetOptionsTest(true);
 }
 
+TEST(TargetOptionsTest, CCRModuleFlags) {
+  LLVMContext Context;
+  Module WithCCR("with-ccr", Context), WithoutCCR("without-ccr", Context);
+  MCTargetOptions CCROptions;
+  CCROptions.CCRMetadata = true;
+  CCROptions.CCRRandFormat = 3;
+  TargetMachine::addCCRModuleFlags(WithCCR, CCROptions);
+  TargetMachine::addCCRModuleFlags(WithoutCCR, MCTargetOptions());
+
+  std::unique_ptr<TargetMachine> TM = createBackendTargetMachine(WithCCR);
+  // This test is designed for the X86 backend; stop if it is not available.
+  if (!TM)
+    return;
+  EXPECT_TRUE(TM->getMCAsmInfo()->RandMetadata);
+  EXPECT_EQ(3u, TM->getMCAsmInfo()->RandFormatVersion);
+
+  // Every backend task emits .rand as the compile of its own module told
+  TM = createBackendTargetMachine(WithoutCCR);
+  EXPECT_FALSE(TM->getMCAsmInfo()->RandMetadata);
+  EXPECT_EQ(1u, TM->getMCAsmInfo()->RandFormatVersion);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   initLLVM();
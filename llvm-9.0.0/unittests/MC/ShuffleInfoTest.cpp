@@ -0,0 +1,218 @@
+//===- ShuffleInfoTest.cpp - Tests for the CCR .rand codec ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MC/MCReorderInfo.h"
+#include "llvm/Support/shuffleInfo.pb.h"
+#include "llvm/Support/shuffleInfoReader.h"
+#include "llvm/Support/shuffleInfoWriter.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+
+using namespace llvm;
+using namespace ShuffleInfo;
+
+namespace {
+
+// The width-bit value of the Idx-th element, as the randomizer reads it
+template <class WordsT>
+uint64_t getBits(const WordsT &Bits, unsigned Idx, unsigned Width) {
+  unsigned PerWord = 64 / Width;
+  if (Idx / PerWord >= (unsigned)Bits.size())
+    return 0;
+  return (Bits.Get(Idx / PerWord) >> ((Idx % PerWord) * Width)) &
+         ((1ULL << Width) - 1);
+}
+
+FixupRecord makeFixup(uint64_t Offset, uint8_t DerefSize, bool IsRela) {
+  FixupRecord F;
+  F.Offset = Offset;
+  F.DerefSize = DerefSize;
+  F.IsRela = IsRela;
+  return F;
+}
+
+std::string serialize(const ReorderInfo &RI) {
+  std::string Bytes;
+  EXPECT_TRUE(RI.SerializeToString(&Bytes));
+  return Bytes;
+}
+
+TEST(ShuffleInfoTest, FixupSectionKind) {
+  EXPECT_EQ(FSK_Text, getFixupSectionKind(".text"));
+  EXPECT_EQ(FSK_Text, getFixupSectionKind(".text.unlikely.foo"));
+  EXPECT_EQ(FSK_Rodata, getFixupSectionKind(".rodata.str1.1"));
+  EXPECT_EQ(FSK_DataRel, getFixupSectionKind(".data.rel.ro.local"));
+  EXPECT_EQ(FSK_Data, getFixupSectionKind(".data.rel"));
+  EXPECT_EQ(FSK_TData, getFixupSectionKind(".tdata"));
+  EXPECT_EQ(FSK_XRay, getFixupSectionKind("xray_instr_map"));
+  EXPECT_EQ(FSK_None, getFixupSectionKind(".debug_info"));
+  EXPECT_EQ("data.rel.ro", getFixupSectionKindName(FSK_DataRel));
+  EXPECT_EQ("custom", getFixupSectionKindName(FSK_Custom));
+}
+
+TEST(ShuffleInfoTest, FixupLists) {
+  ReorderInfo RI;
+  ReorderInfo_FixupInfo *FI = RI.add_fixup();
+  for (unsigned List = 0; List < NumFixupLists; ++List) {
+    ASSERT_NE(nullptr, AddFixupTuple(FI, List));
+    ASSERT_NE(nullptr, MutableFixupColumns(&RI, List));
+  }
+  EXPECT_EQ(nullptr, AddFixupTuple(FI, NumFixupLists));
+  EXPECT_EQ(nullptr, MutableFixupColumns(&RI, NumFixupLists));
+  EXPECT_EQ(1, FI->text_size());
+  EXPECT_EQ(1, FI->datarel_size());
+  EXPECT_EQ(1, FI->custom_size());
+  EXPECT_EQ(&RI.jumptable_fixup_columns(),
+            MutableFixupColumns(&RI, FL_JumpTable));
+}
+
+TEST(ShuffleInfoTest, AppendBits) {
+  // 32 values of 2 bits fill a word; the 33rd begins another
+  google::protobuf::RepeatedField<google::protobuf::uint64> Bits;
+  for (unsigned I = 0; I < 33; ++I)
+    AppendBits(&Bits, I, I % 4, 2);
+  ASSERT_EQ(2, Bits.size());
+  for (unsigned I = 0; I < 33; ++I)
+    EXPECT_EQ(I % 4, getBits(Bits, I, 2)) << "element " << I;
+
+  // A width that does not divide 64 leaves the top bits of a word clear
+  google::protobuf::RepeatedField<google::protobuf::uint64> Terms;
+  for (unsigned I = 0; I < 9; ++I)
+    AppendBits(&Terms, I, 0x80 | I, 8);
+  ASSERT_EQ(2, Terms.size());
+  EXPECT_EQ(0x88u, getBits(Terms, 8, 8));
+}
+
+TEST(ShuffleInfoTest, FixupTuple) {
+  FixupRecord F = makeFixup(0x1234, 1, true);
+  F.TargetKind = 1;
+  F.Scope = 2;
+  F.IsNewSection = true;
+  F.RelaxShortSize = 2;
+  F.RelaxLongSize = 6;
+  F.RelaxFixupOffset = 2;
+  memcpy(F.RelaxLongForm, "\x0f\x84\0\0\0\0", 6);
+
+  ReorderInfo RI;
+  ReorderInfo_FixupInfo_FixupTuple *T = AddFixupTuple(RI.add_fixup(), FL_Text);
+  SetFixupTuple(T, F, 0x34);
+
+  google::protobuf::Arena Arena;
+  std::string Bytes = serialize(RI);
+  const ReorderInfo *Parsed = ParseReorderInfo(Bytes.data(), Bytes.size(), &Arena);
+  ASSERT_NE(nullptr, Parsed);
+  ASSERT_EQ(1, Parsed->fixup_size());
+  ASSERT_EQ(1, Parsed->fixup(0).text_size());
+  const ReorderInfo_FixupInfo_FixupTuple &P = Parsed->fixup(0).text(0);
+  EXPECT_EQ(0x34u, P.offset());
+  EXPECT_EQ(1u, P.deref_sz());
+  EXPECT_TRUE(P.is_rela());
+  EXPECT_EQ(4u, P.type());
+  EXPECT_EQ(1u, P.target());
+  EXPECT_EQ(2u, P.scope());
+  EXPECT_FALSE(P.has_ref_class());
+  EXPECT_FALSE(P.has_num_jt_entries());
+  EXPECT_EQ(2u, P.relax_short_sz());
+  EXPECT_EQ(std::string("\x0f\x84\0\0\0\0", 6), P.relax_long_form());
+  EXPECT_EQ(2u, P.relax_fixup_offset());
+  EXPECT_FALSE(P.has_shrink_long_sz());
+}
+
+TEST(ShuffleInfoTest, FixupColumns) {
+  ReorderInfo_FixupColumns C;
+  FixupColumnsWriter W(&C, 4, /*RelocIndices=*/true);
+
+  FixupRecord Call = makeFixup(0x100, 4, true);
+  Call.RelocIdx = 1;
+  W.Add(Call);
+
+  FixupRecord Table = makeFixup(0x108, 4, true);
+  Table.Scope = 1;
+  Table.NumJTEntries = 3;
+  Table.JTEntrySize = 4;
+  Table.JTFunctionRelative = true;
+  Table.RelocIdx = 2;
+  W.Add(Table);
+
+  FixupRecord Load = makeFixup(0x104, 4, true);
+  Load.RefClass = 2;
+  Load.GOTRelax = 2;
+  Load.SectionIdx = 1;
+  Load.IsNewSection = true;
+  Load.RelocIdx = 1;
+  W.Add(Load);
+
+  FixupRecord Jump = makeFixup(0x110, 4, true);
+  Jump.ShrinkLongSize = 5;
+  Jump.ShrinkShortSize = 2;
+  memcpy(Jump.ShrinkShortForm, "\xeb\0", 2);
+  Jump.PairDelta = 1;
+  W.Add(Jump);
+
+  ASSERT_EQ(4, C.offset_delta_size());
+  EXPECT_EQ(0x100, C.offset_delta(0));
+  EXPECT_EQ(8, C.offset_delta(1));
+  EXPECT_EQ(-4, C.offset_delta(2));
+  EXPECT_EQ(0xc, C.offset_delta(3));
+  EXPECT_EQ(4u, C.deref_sz(3));
+  EXPECT_EQ(1u, getBits(C.is_rela_bits(), 3, 1));
+  EXPECT_EQ(1u, getBits(C.new_section_bits(), 2, 1));
+  EXPECT_EQ(0u, getBits(C.new_section_bits(), 3, 1));
+  EXPECT_EQ(2u, getBits(C.ref_class_bits(), 2, 2));
+  ASSERT_EQ(4, C.section_idx_size());
+  EXPECT_EQ(1u, C.section_idx(2));
+
+  // The sparse columns stop at the last fixup that has a value
+  EXPECT_EQ(0u, getBits(C.scope_bits(), 0, 2));
+  EXPECT_EQ(1u, getBits(C.scope_bits(), 1, 2));
+  EXPECT_EQ(1, C.scope_bits_size());
+  EXPECT_EQ(2u, getBits(C.got_relax_bits(), 2, 2));
+
+  // The indices of the relocations restart at a new section
+  ASSERT_EQ(4, C.reloc_delta_size());
+  EXPECT_EQ(1u, C.reloc_delta(0));
+  EXPECT_EQ(1u, C.reloc_delta(1));
+  EXPECT_EQ(1u, C.reloc_delta(2));
+  EXPECT_EQ(0u, C.reloc_delta(3));
+
+  ASSERT_EQ(1, C.jt_fixup_idx_size());
+  EXPECT_EQ(1u, C.jt_fixup_idx(0));
+  EXPECT_EQ(3u, C.num_jt_entries(0));
+  EXPECT_EQ(4u, C.jt_entry_sz(0));
+  EXPECT_EQ(1u, getBits(C.jt_func_rel_bits(), 0, 1));
+  ASSERT_EQ(1, C.pair_fixup_idx_size());
+  EXPECT_EQ(3u, C.pair_fixup_idx(0));
+  EXPECT_EQ(0, C.relax_fixup_idx_size());
+  ASSERT_EQ(1, C.shrink_fixup_idx_size());
+  EXPECT_EQ(3u, C.shrink_fixup_idx(0));
+  EXPECT_EQ(5u, C.shrink_long_sz(0));
+  EXPECT_EQ(std::string("\xeb\0", 2), C.shrink_short_form(0));
+}
+
+TEST(ShuffleInfoTest, SectionNames) {
+  ReorderInfo RI;
+  RI.mutable_bin()->set_format_version(2);
+  RI.add_section_names(".text");
+  RI.add_section_names(".text.hot.foo");
+  RI.mutable_layout_columns()->add_bb_size(16);
+  std::string Bytes = serialize(RI);
+
+  std::vector<google::protobuf::StringPiece> Names;
+  ASSERT_TRUE(ReadSectionNames(Bytes.data(), Bytes.size(), &Names));
+  ASSERT_EQ(2u, Names.size());
+  EXPECT_EQ(".text", Names[0].as_string());
+  EXPECT_EQ(".text.hot.foo", Names[1].as_string());
+
+  // A name that runs past the end of the message
+  google::protobuf::Arena Arena;
+  EXPECT_EQ(nullptr, ParseReorderInfo("\x2a\x05.t", 4, &Arena));
+  EXPECT_FALSE(ReadSectionNames("\x2a\x05.t", 4, &Names));
+}
+
+} // end anonymous namespace
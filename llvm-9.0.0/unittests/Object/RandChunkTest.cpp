@@ -0,0 +1,219 @@
+//===- RandChunkTest.cpp - Tests for RandChunk.cpp ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Object/RandChunk.h"
+#include "RandFixture.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/RandChunk.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::object;
+
+// A chunk of the sections Names whose payload is Payload; the payloads are
+// opaque to the merge, thus any bytes do
+static std::vector<uint8_t> makeChunk(ArrayRef<StringRef> Names,
+                                      StringRef Payload,
+                                      uint64_t ShapeHash = 0) {
+  return ccr::unittest::makeChunk(Names, arrayRefFromStringRef(Payload),
+                                  /*NumLayouts=*/2, /*NumFixups=*/3, ShapeHash);
+}
+
+static std::vector<uint8_t> concat(ArrayRef<std::vector<uint8_t>> Chunks) {
+  std::vector<uint8_t> Out;
+  for (const std::vector<uint8_t> &C : Chunks)
+    Out.insert(Out.end(), C.begin(), C.end());
+  return Out;
+}
+
+// Give the sections of every input the base 0x1000 * (InputIdx + 1)
+static Error patchBases(unsigned InputIdx, ccr::ChunkHeader &H,
+                        MutableArrayRef<ccr::ChunkSection> Sections,
+                        StringRef) {
+  H.RandObjOffset = 0x1000 * (InputIdx + 1);
+  for (ccr::ChunkSection &S : Sections)
+    S.Base = 0x1000 * (InputIdx + 1) + S.NameOffset;
+  return Error::success();
+}
+
+TEST(RandChunkTest, Read) {
+  std::vector<uint8_t> A = makeChunk({".text", ".text.f"}, "payload");
+  std::vector<uint8_t> B = makeChunk({}, "");
+  EXPECT_EQ(0u, A.size() % 8);
+  std::vector<uint8_t> Contents = concat({A, B});
+  ASSERT_TRUE(isRandChunked(Contents));
+  EXPECT_FALSE(isRandChunked(makeArrayRef(Contents).take_front(16)));
+
+  Expected<std::vector<RandChunkRef>> Chunks = readRandChunks(Contents);
+  ASSERT_THAT_EXPECTED(Chunks, Succeeded());
+  ASSERT_EQ(2u, Chunks->size());
+  const RandChunkRef &C = (*Chunks)[0];
+  ASSERT_EQ(2u, C.getSections().size());
+  EXPECT_EQ(".text", C.getSectionName(C.getSections()[0]));
+  EXPECT_EQ(".text.f", C.getSectionName(C.getSections()[1]));
+  EXPECT_EQ("payload", toStringRef(C.getPayload()));
+  EXPECT_FALSE(C.hasSharedPayload());
+  EXPECT_TRUE((*Chunks)[1].getSections().empty());
+  EXPECT_TRUE((*Chunks)[1].getPayload().empty());
+}
+
+TEST(RandChunkTest, Malformed) {
+  std::vector<uint8_t> Chunk = makeChunk({".text"}, "payload");
+  EXPECT_THAT_EXPECTED(
+      readRandChunks(makeArrayRef(Chunk).drop_back(8)), Failed());
+
+  std::vector<uint8_t> BadVersion = Chunk;
+  reinterpret_cast<ccr::ChunkHeader *>(BadVersion.data())->Version = 2;
+  EXPECT_THAT_EXPECTED(readRandChunks(BadVersion), Failed());
+
+  std::vector<uint8_t> BadName = Chunk;
+  reinterpret_cast<ccr::ChunkSection *>(BadName.data() +
+                                        sizeof(ccr::ChunkHeader))
+      ->NameOffset = 6;
+  EXPECT_THAT_EXPECTED(readRandChunks(BadName), Failed());
+
+  // Sizes whose sum wraps around to an empty chunk or one of 8 bytes
+  for (uint64_t PayloadSize : {-64ULL, -56ULL}) {
+    std::vector<uint8_t> Huge = makeChunk({}, "");
+    reinterpret_cast<ccr::ChunkHeader *>(Huge.data())->PayloadSize =
+        PayloadSize;
+    EXPECT_THAT_EXPECTED(readRandChunks(Huge), Failed());
+  }
+  std::vector<uint8_t> HugeSections = Chunk;
+  reinterpret_cast<ccr::ChunkHeader *>(HugeSections.data())->NumSections =
+      0xffffffff;
+  EXPECT_THAT_EXPECTED(readRandChunks(HugeSections), Failed());
+  std::vector<uint8_t> HugeNames = Chunk;
+  reinterpret_cast<ccr::ChunkHeader *>(HugeNames.data())->NamesSize =
+      0xffffffff;
+  EXPECT_THAT_EXPECTED(readRandChunks(HugeNames), Failed());
+
+  // A shared payload has to be that of an earlier chunk
+  std::vector<uint8_t> BadRef = makeChunk({".text"}, "");
+  reinterpret_cast<ccr::ChunkHeader *>(BadRef.data())->PayloadRef = 0;
+  EXPECT_THAT_EXPECTED(readRandChunks(BadRef), Failed());
+}
+
+TEST(RandChunkTest, Merge) {
+  std::vector<uint8_t> Inputs[] = {
+      makeChunk({".text.a"}, "first"),
+      concat({makeChunk({".text.b", ".data.b"}, "second"),
+              makeChunk({".text.c"}, "third")}),
+  };
+  std::vector<ArrayRef<uint8_t>> Refs(std::begin(Inputs), std::end(Inputs));
+  std::vector<uint8_t> Merged;
+  ASSERT_THAT_ERROR(mergeRandSections(Refs, patchBases, Merged), Succeeded());
+  EXPECT_EQ(Inputs[0].size() + Inputs[1].size(), Merged.size());
+
+  // The chunks are copied in order, with the headers patched
+  Expected<std::vector<RandChunkRef>> Chunks = readRandChunks(Merged);
+  ASSERT_THAT_EXPECTED(Chunks, Succeeded());
+  ASSERT_EQ(3u, Chunks->size());
+  const char *Payloads[] = {"first", "second", "third"};
+  const uint64_t Bases[] = {0x1000, 0x2000, 0x2000};
+  for (size_t I = 0; I != 3; ++I) {
+    const RandChunkRef &C = (*Chunks)[I];
+    EXPECT_EQ(Payloads[I], toStringRef(C.getPayload())) << "chunk #" << I;
+    EXPECT_FALSE(C.hasSharedPayload()) << "chunk #" << I;
+    EXPECT_EQ(Bases[I], C.getHeader().RandObjOffset) << "chunk #" << I;
+    EXPECT_EQ(Bases[I], C.getSections()[0].Base) << "chunk #" << I;
+  }
+  EXPECT_EQ(0x2008u, (*Chunks)[1].getSections()[1].Base);
+
+  // An input that is no chunk is refused
+  std::vector<ArrayRef<uint8_t>> Bad = {Inputs[0],
+                                        makeArrayRef(Inputs[1]).drop_back(8)};
+  EXPECT_THAT_ERROR(mergeRandSections(Bad, patchBases, Merged), Failed());
+}
+
+TEST(RandChunkTest, SharedPayloads) {
+  // The payload of the second input is that of the first one, of the same
+  // shape; the third has the same bytes but no shape, which is not shared
+  std::vector<uint8_t> Inputs[] = {
+      makeChunk({".text.a"}, "template body", 0x77),
+      concat({makeChunk({".text.b"}, "template body", 0x77),
+              makeChunk({".text.c"}, "other", 0x77)}),
+      makeChunk({".text.d"}, "template body"),
+  };
+  std::vector<ArrayRef<uint8_t>> Refs(std::begin(Inputs), std::end(Inputs));
+  uint64_t Unshared = 0;
+  for (const std::vector<uint8_t> &I : Inputs)
+    Unshared += I.size();
+
+  uint64_t Size = getMergedRandSize(Refs);
+  EXPECT_LT(Size, Unshared);
+  std::vector<uint8_t> Merged;
+  RandMergeStats Stats[3];
+  ASSERT_THAT_ERROR(mergeRandSections(Refs, patchBases, Merged, Stats),
+                    Succeeded());
+  EXPECT_EQ(Size, Merged.size());
+  EXPECT_EQ(2u, Stats[1].NumChunks);
+  EXPECT_EQ(uint64_t(strlen("template body")), Stats[1].SharedBytes);
+  EXPECT_EQ(0u, Stats[2].SharedBytes);
+  EXPECT_EQ(6u, Stats[1].NumFixups);
+
+  Expected<std::vector<RandChunkRef>> Chunks = readRandChunks(Merged);
+  ASSERT_THAT_EXPECTED(Chunks, Succeeded());
+  ASSERT_EQ(4u, Chunks->size());
+  const char *Payloads[] = {"template body", "template body", "other",
+                            "template body"};
+  for (size_t I = 0; I != 4; ++I) {
+    const RandChunkRef &C = (*Chunks)[I];
+    EXPECT_EQ(Payloads[I], toStringRef(C.getPayload())) << "chunk #" << I;
+    EXPECT_EQ(I == 1, C.hasSharedPayload()) << "chunk #" << I;
+  }
+  EXPECT_EQ(0u, (*Chunks)[1].getHeader().PayloadRef);
+
+  // A buffer of another size is refused
+  std::vector<uint8_t> Short(Size - 8);
+  EXPECT_THAT_ERROR(mergeRandSections(Refs, patchBases,
+                                      MutableArrayRef<uint8_t>(Short)),
+                    Failed());
+}
+
+TEST(RandChunkTest, Update) {
+  std::vector<uint8_t> Inputs[] = {
+      makeChunk({".text.a"}, "template body", 0x77),
+      makeChunk({".text.b"}, "b"),
+  };
+  std::vector<ArrayRef<uint8_t>> Refs(std::begin(Inputs), std::end(Inputs));
+  std::vector<uint8_t> Merged;
+  ASSERT_THAT_ERROR(mergeRandSections(Refs, patchBases, Merged), Succeeded());
+  std::vector<uint64_t> Offsets = getMergedRandOffsets(Refs);
+  ASSERT_EQ(3u, Offsets.size());
+  EXPECT_EQ(0u, Offsets[0]);
+  EXPECT_EQ(Inputs[0].size(), Offsets[1]);
+  EXPECT_EQ(Merged.size(), Offsets[2]);
+  uint64_t OldSize = Merged.size();
+
+  // Replace the second input by a new one that shares the first payload
+  std::vector<uint8_t> Added = makeChunk({".text.e"}, "template body", 0x77);
+  Expected<std::vector<uint64_t>> AddedOffsets = updateRandSection(
+      Merged, {{Offsets[1], Offsets[2]}}, {Added}, patchBases);
+  ASSERT_THAT_EXPECTED(AddedOffsets, Succeeded());
+  ASSERT_EQ(2u, AddedOffsets->size());
+  EXPECT_EQ(OldSize, (*AddedOffsets)[0]);
+  EXPECT_EQ(Merged.size(), (*AddedOffsets)[1]);
+  EXPECT_LT(Merged.size() - OldSize, Added.size());
+
+  Expected<std::vector<RandChunkRef>> Chunks = readRandChunks(Merged);
+  ASSERT_THAT_EXPECTED(Chunks, Succeeded());
+  ASSERT_EQ(3u, Chunks->size());
+  EXPECT_EQ(0x1000u, (*Chunks)[0].getSections()[0].Base);
+  EXPECT_EQ(uint64_t(ccr::ChunkSection::DiscardedBase),
+            (*Chunks)[1].getSections()[0].Base);
+  EXPECT_TRUE((*Chunks)[2].hasSharedPayload());
+  EXPECT_EQ("template body", toStringRef((*Chunks)[2].getPayload()));
+
+  // A range within a chunk is refused
+  EXPECT_THAT_EXPECTED(updateRandSection(Merged, {{Offsets[1] + 8, Offsets[2]}},
+                                         {}, patchBases),
+                       Failed());
+}
@@ -0,0 +1,126 @@
+//===- DataGroupsTest.cpp - Tests for the groups of the data objects ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DataGroups.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+namespace {
+
+const uint64_t SectionAddr = 0x1000;
+const uint64_t SectionSize = 0x200;
+
+// The objects of a section of 8 lines: two that share the line 0x1040, one
+// that straddles 0x10c0, and one on each line from 0x1100 on; their bytes
+// are their indices + 1, the rest zeros
+std::vector<DataObject> makeObjects() {
+  const std::pair<uint64_t, uint64_t> Objects[] = {
+      {0x1000, 8},  {0x1040, 8},  {0x1048, 8},  {0x1080, 0x50},
+      {0x1100, 16}, {0x1140, 16}, {0x1180, 16}, {0x11c0, 16}};
+  std::vector<DataObject> Out;
+  for (const auto &O : Objects) {
+    DataObject D;
+    D.Addr = O.first;
+    D.Size = O.second;
+    Out.push_back(D);
+  }
+  return Out;
+}
+
+std::vector<uint8_t> makeContents(ArrayRef<DataObject> Objects) {
+  std::vector<uint8_t> Contents(SectionSize);
+  for (size_t I = 0, E = Objects.size(); I != E; ++I)
+    std::fill_n(Contents.begin() + (Objects[I].Addr - SectionAddr),
+                Objects[I].Size, uint8_t(I + 1));
+  return Contents;
+}
+
+TEST(DataGroupsTest, Groups) {
+  std::vector<DataObject> Objects = makeObjects();
+  std::vector<uint8_t> Contents = makeContents(Objects);
+  for (uint64_t Seed = 0; Seed != 8; ++Seed) {
+    RandomStream RS(Seed, RandomStream::dataStream(1));
+    DataGroups DG;
+    DG.addSection(SectionAddr, SectionSize, 64, Contents, Objects, {}, RS);
+
+    // The first object has no gap before it; the two of a line and the one
+    // that straddles a line move as one group each
+    ASSERT_EQ(7u, DG.groups().size()) << "seed " << Seed;
+    EXPECT_EQ(6u, DG.getStats().NumGroups);
+    EXPECT_EQ(SectionAddr, DG.translate(SectionAddr));
+    EXPECT_EQ(DG.translate(0x1040) + 8, DG.translate(0x1048));
+    EXPECT_EQ(DG.translate(0x1080) + 0x60, DG.translate(0x10e0));
+    EXPECT_EQ(SectionAddr + SectionSize,
+              DG.translate(SectionAddr + SectionSize));
+
+    // The groups tile the lines they were cut from, each at a new line
+    std::vector<DataGroup> ByNewAddr(DG.groups().begin(), DG.groups().end());
+    std::sort(ByNewAddr.begin(), ByNewAddr.end(),
+              [](const DataGroup &A, const DataGroup &B) {
+                return A.NewAddr < B.NewAddr;
+              });
+    EXPECT_EQ(0x1040u, ByNewAddr.front().NewAddr);
+    for (size_t I = 1, E = ByNewAddr.size(); I != E; ++I)
+      EXPECT_EQ(ByNewAddr[I - 1].NewAddr + ByNewAddr[I - 1].Size,
+                ByNewAddr[I].NewAddr);
+
+    // Up to MaxTrailingBytes short of a group is taken as that group
+    EXPECT_EQ(DG.translate(0x1100) - 4, DG.translate(0x10fc));
+    EXPECT_EQ(DG.translate(0x1080) + 0x50, DG.translate(0x10d0));
+
+    std::vector<uint8_t> Moved = Contents;
+    DG.moveContents(SectionAddr, Moved);
+    for (size_t I = 0, E = Objects.size(); I != E; ++I)
+      EXPECT_EQ(uint8_t(I + 1),
+                Moved[DG.translate(Objects[I].Addr) - SectionAddr])
+          << "object " << I << ", seed " << Seed;
+  }
+}
+
+TEST(DataGroupsTest, Affinity) {
+  std::vector<DataObject> Objects = makeObjects();
+  std::vector<uint8_t> Contents = makeContents(Objects);
+  Objects[4].Affinity = 0;
+  Objects[7].Affinity = 0;
+  for (uint64_t Seed = 0; Seed != 8; ++Seed) {
+    RandomStream RS(Seed, RandomStream::dataStream(1));
+    DataGroups DG;
+    DG.addSection(SectionAddr, SectionSize, 64, Contents, Objects, {}, RS);
+    // The set takes the first lines of the groups, in its old order
+    EXPECT_EQ(0x1040u, DG.translate(0x1100)) << "seed " << Seed;
+    EXPECT_EQ(0x1080u, DG.translate(0x11c0)) << "seed " << Seed;
+    EXPECT_EQ(2u, DG.getStats().NumAffinityGroups);
+  }
+}
+
+TEST(DataGroupsTest, Pinned) {
+  std::vector<DataObject> Objects = makeObjects();
+  std::vector<uint8_t> Contents = makeContents(Objects);
+  // No cut before 0x1180 either: a byte in its gap that no object covers
+  Contents[0x117e - SectionAddr] = 0xff;
+  for (uint64_t Seed = 0; Seed != 8; ++Seed) {
+    RandomStream RS(Seed, RandomStream::dataStream(1));
+    DataGroups DG;
+    DG.addSection(SectionAddr, SectionSize, 64, Contents, Objects, {0x1108},
+                  RS);
+    EXPECT_EQ(5u, DG.getStats().NumGroups);
+    EXPECT_EQ(1u, DG.getStats().NumPinnedGroups);
+    EXPECT_EQ(0x1100u, DG.translate(0x1100)) << "seed " << Seed;
+    // The groups on either side stay on their side
+    uint64_t Before = DG.translate(0x1080);
+    EXPECT_TRUE(Before == 0x1040 || Before == 0x1080) << "seed " << Seed;
+    uint64_t After = DG.translate(0x1140);
+    EXPECT_TRUE(After == 0x1140 || After == 0x1180) << "seed " << Seed;
+    EXPECT_EQ(After + 0x40, DG.translate(0x1180));
+  }
+}
+
+} // end anonymous namespace
@@ -0,0 +1,216 @@
+//===- LayoutTest.cpp - Tests for the shuffled layout ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Layout.h"
+#include "RandInfo.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+namespace {
+
+const unsigned NumTestFunctions = 24;
+const unsigned PinnedFunction = 10;
+
+// A single object at 0x1000 of functions of one to three BBLs; the first BBL
+// of a function of three falls through into the second
+RandInfo makeInfo() {
+  RandInfo Info;
+  Info.RandObjOffset = 0x1000;
+  for (unsigned F = 0; F != NumTestFunctions; ++F) {
+    unsigned NumBBLs = 1 + F % 3;
+    for (unsigned I = 0; I != NumBBLs; ++I) {
+      BasicBlockInfo BBL;
+      BBL.Size = 8 + 4 * ((F + I) % 4);
+      BBL.FallThrough = NumBBLs == 3 && I == 0;
+      BBL.Pinned = F == PinnedFunction;
+      BBL.Type = I + 1 != NumBBLs ? BBT_Block : BBT_FunctionEnd;
+      Info.BasicBlocks.push_back(BBL);
+      Info.ObjSize += BBL.Size;
+    }
+  }
+  Info.BasicBlocks.back().Type = BBT_ObjectEnd;
+  return Info;
+}
+
+std::vector<uint64_t> getNewOffsets(const Layout &L) {
+  std::vector<uint64_t> Offsets;
+  for (const BasicBlock &BBL : L.basicBlocks())
+    Offsets.push_back(BBL.NewOffset);
+  return Offsets;
+}
+
+// The BBLs tile the range of the old layout without overlapping
+void expectPermutation(const Layout &L) {
+  std::vector<const BasicBlock *> Sorted;
+  for (const BasicBlock &BBL : L.basicBlocks())
+    Sorted.push_back(&BBL);
+  std::sort(Sorted.begin(), Sorted.end(),
+            [](const BasicBlock *A, const BasicBlock *B) {
+              return A->NewOffset < B->NewOffset;
+            });
+  uint64_t Offset = L.getBegin();
+  for (const BasicBlock *BBL : Sorted) {
+    EXPECT_EQ(Offset, BBL->NewOffset);
+    Offset = BBL->NewOffset + BBL->Size + BBL->NewPadding;
+  }
+  EXPECT_EQ(L.getEnd(), Offset);
+  EXPECT_EQ(L.getEnd(), L.getNewEnd());
+}
+
+TEST(LayoutTest, Functions) {
+  RandInfo Info = makeInfo();
+  Layout L(Info, /*ShuffleBBLs=*/true);
+  EXPECT_EQ(0x1000u, L.getBegin());
+  EXPECT_EQ(0x1000u + Info.ObjSize, L.getEnd());
+  ASSERT_EQ(NumTestFunctions, L.functions().size());
+  EXPECT_EQ(1u, L.objects().size());
+  EXPECT_EQ(3u, L.functions()[2].NumBBLs);
+  EXPECT_EQ(6u, L.functions()[3].FirstBBL);
+  EXPECT_TRUE(L.functions()[PinnedFunction].Pinned);
+  EXPECT_FALSE(L.functions()[PinnedFunction].ShuffleBBLs);
+  EXPECT_TRUE(L.functions()[2].ShuffleBBLs);
+  EXPECT_FALSE(L.functions()[0].ShuffleBBLs);
+
+  // The old layout is the identity
+  for (const BasicBlock &BBL : L.basicBlocks())
+    EXPECT_EQ(BBL.OldOffset, BBL.NewOffset);
+  EXPECT_EQ(0, L.findBasicBlock(0x1000));
+  EXPECT_EQ(-1, L.findBasicBlock(0xfff));
+  EXPECT_EQ(-1, L.findBasicBlock(L.getEnd()));
+  EXPECT_EQ(0x10u, L.translate(0x10));
+}
+
+TEST(LayoutTest, Shuffle) {
+  RandInfo Info = makeInfo();
+  Layout L(Info, /*ShuffleBBLs=*/true);
+  L.shuffle(1);
+  expectPermutation(L);
+  EXPECT_GT(L.getStats().EntropyBits, 0);
+  EXPECT_EQ(NumTestFunctions - 1, L.getStats().NumUnits);
+
+  ArrayRef<BasicBlock> BBLs = L.basicBlocks();
+  for (const Function &F : L.functions()) {
+    // The entry stays first and a fall-through stays in place
+    const BasicBlock &Entry = BBLs[F.FirstBBL];
+    for (unsigned I = 0; I != F.NumBBLs; ++I) {
+      const BasicBlock &BBL = BBLs[F.FirstBBL + I];
+      EXPECT_LE(Entry.NewOffset, BBL.NewOffset);
+      if (BBL.FallThrough) {
+        ASSERT_LT(I + 1, F.NumBBLs);
+        EXPECT_EQ(BBL.NewOffset + BBL.Size, BBLs[F.FirstBBL + I + 1].NewOffset);
+      }
+    }
+  }
+
+  // A pinned function keeps its offset
+  const Function &Pinned = L.functions()[PinnedFunction];
+  for (unsigned I = 0; I != Pinned.NumBBLs; ++I)
+    EXPECT_EQ(BBLs[Pinned.FirstBBL + I].OldOffset,
+              BBLs[Pinned.FirstBBL + I].NewOffset);
+}
+
+TEST(LayoutTest, Translate) {
+  RandInfo Info = makeInfo();
+  Layout L(Info, /*ShuffleBBLs=*/true);
+  L.shuffle(7);
+  ArrayRef<BasicBlock> BBLs = L.basicBlocks();
+  for (unsigned I = 0, E = BBLs.size(); I != E; ++I)
+    for (uint64_t K : {uint64_t(0), uint64_t(BBLs[I].Size - 1)}) {
+      EXPECT_EQ(int(I), L.findBasicBlock(BBLs[I].OldOffset + K));
+      EXPECT_EQ(BBLs[I].NewOffset + K, L.translate(BBLs[I].OldOffset + K));
+      EXPECT_EQ(BBLs[I].NewOffset + K,
+                L.translateWithin(I, BBLs[I].OldOffset + K));
+    }
+  // Outside of the range, nothing moves
+  EXPECT_EQ(L.getEnd() + 4, L.translate(L.getEnd() + 4));
+}
+
+TEST(LayoutTest, Seeds) {
+  RandInfo Info = makeInfo();
+  Layout A(Info, /*ShuffleBBLs=*/true), B(Info, /*ShuffleBBLs=*/true);
+  A.shuffle(42);
+  B.shuffle(42, 100, /*Parallel=*/true);
+  EXPECT_EQ(getNewOffsets(A), getNewOffsets(B));
+
+  bool Differs = false;
+  for (uint64_t Seed = 43; Seed != 48 && !Differs; ++Seed) {
+    Layout C(Info, /*ShuffleBBLs=*/true);
+    C.shuffle(Seed);
+    Differs = getNewOffsets(A) != getNewOffsets(C);
+  }
+  EXPECT_TRUE(Differs);
+}
+
+TEST(LayoutTest, FunctionsOnly) {
+  RandInfo Info = makeInfo();
+  Layout L(Info, /*ShuffleBBLs=*/false);
+  L.shuffle(3);
+  expectPermutation(L);
+
+  // Without BBL shuffling, every function moves as a whole
+  ArrayRef<BasicBlock> BBLs = L.basicBlocks();
+  for (const Function &F : L.functions())
+    for (unsigned I = 1; I < F.NumBBLs; ++I)
+      EXPECT_EQ(BBLs[F.FirstBBL + I].NewOffset - BBLs[F.FirstBBL].NewOffset,
+                BBLs[F.FirstBBL + I].OldOffset - BBLs[F.FirstBBL].OldOffset);
+}
+
+TEST(LayoutTest, ShuffleWindow) {
+  RandInfo Info = makeInfo();
+  Layout Whole(Info, /*ShuffleBBLs=*/false);
+  Whole.shuffle(5);
+
+  const uint64_t Window = 128;
+  Layout L(Info, /*ShuffleBBLs=*/false);
+  L.setShuffleWindow(Window);
+  L.shuffle(5);
+  expectPermutation(L);
+  EXPECT_GT(L.getStats().NumShuffleWindows, 1u);
+  EXPECT_LT(L.getStats().EntropyBits, Whole.getStats().EntropyBits);
+
+  // A function moves by less than a window
+  for (const Function &F : L.functions()) {
+    const BasicBlock &Entry = L.basicBlocks()[F.FirstBBL];
+    uint64_t Distance = Entry.NewOffset > Entry.OldOffset
+                            ? Entry.NewOffset - Entry.OldOffset
+                            : Entry.OldOffset - Entry.NewOffset;
+    EXPECT_LT(Distance, Window);
+  }
+}
+
+TEST(LayoutTest, GrowBasicBlock) {
+  RandInfo Info = makeInfo();
+  Layout L(Info, /*ShuffleBBLs=*/true);
+  L.shuffle(9);
+  std::vector<uint64_t> Before = getNewOffsets(L);
+
+  // A short branch 2 bytes into the BBL 3 grows by 4 bytes
+  ArrayRef<BasicBlock> BBLs = L.basicBlocks();
+  uint64_t Branch = BBLs[3].OldOffset + 2;
+  L.growBasicBlock(3, Branch, 4);
+  L.relayout();
+  EXPECT_EQ(4u, L.getTotalGrowth());
+  EXPECT_EQ(L.getEnd() + 4, L.getNewEnd());
+
+  BBLs = L.basicBlocks();
+  for (unsigned I = 0, E = BBLs.size(); I != E; ++I) {
+    if (I == 3)
+      continue;
+    uint64_t Shift = Before[I] > Before[3] ? 4 : 0;
+    EXPECT_EQ(Before[I] + Shift, BBLs[I].NewOffset) << "BBL #" << I;
+  }
+  // The bytes before the branch stay, those after it move along
+  EXPECT_EQ(Before[3], L.translate(BBLs[3].OldOffset));
+  EXPECT_EQ(Before[3] + 2, L.translate(Branch));
+  EXPECT_EQ(Before[3] + 4 + 4, L.translate(Branch + 2));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,265 @@
+//===- RandFixture.h - A small object in every .rand format -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The object that the tests of the .rand readers (llvm-ccr-rand, the merge of
+// lib/Object and llvm-readobj) encode: its BBLs and fixups, the messages of
+// format 1 and 2, and the chunks of format 3 as the assembler writes them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_UNITTESTS_TOOLS_LLVM_CCR_RAND_RANDFIXTURE_H
+#define LLVM_UNITTESTS_TOOLS_LLVM_CCR_RAND_RANDFIXTURE_H
+
+#include "RandInfo.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/BinaryFormat/RandChunk.h"
+#include "llvm/Support/shuffleInfo.pb.h"
+#include "llvm/Support/shuffleInfoWriter.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace ccr {
+namespace unittest {
+
+// A hot function of two BBLs, the first of which falls through, and a cold
+// one aligned to 16 bytes; the fixup offsets are relative to the start of
+// their sections
+struct TestBBL {
+  uint32_t Size;
+  uint8_t Type;
+  bool FallThrough;
+  uint8_t Hotness;
+  uint32_t PaddingSize;
+  uint8_t AlignLog2;
+};
+
+const TestBBL TestBBLs[] = {
+    {16, BBT_Block, true, HOT_Hot, 0, 4},
+    {16, BBT_FunctionEnd, false, HOT_Hot, 6, 0},
+    {32, BBT_ObjectEnd, false, HOT_Cold, 0, 4},
+};
+
+const uint32_t TestFixupsPerBBL[] = {2, 1, 2};
+
+const uint64_t TestSize = 64;
+
+inline std::vector<ShuffleInfo::FixupRecord> getTextFixups() {
+  std::vector<ShuffleInfo::FixupRecord> Fixups(5);
+  ShuffleInfo::FixupRecord *F = Fixups.data();
+
+  // A call into the other function
+  F[0].Offset = 0x1;
+  F[0].DerefSize = 4;
+  F[0].IsRela = true;
+  F[0].TargetKind = FT_Code;
+  F[0].Scope = FS_IntraObject;
+
+  // A short jcc, whose long form is 0f 84 rel32
+  F[1].Offset = 0xa;
+  F[1].DerefSize = 1;
+  F[1].IsRela = true;
+  F[1].TargetKind = FT_Code;
+  F[1].Scope = FS_IntraFunction;
+  F[1].RelaxShortSize = 2;
+  F[1].RelaxLongSize = 6;
+  F[1].RelaxFixupOffset = 2;
+  memcpy(F[1].RelaxLongForm, "\x0f\x84\0\0\0\0", 6);
+
+  // A jmp rel32 that the assembler relaxed from eb rel8
+  F[2].Offset = 0x16;
+  F[2].DerefSize = 4;
+  F[2].IsRela = true;
+  F[2].TargetKind = FT_Code;
+  F[2].Scope = FS_IntraFunction;
+  F[2].ShrinkLongSize = 5;
+  F[2].ShrinkShortSize = 2;
+  memcpy(F[2].ShrinkShortForm, "\xeb\0", 2);
+
+  // The lea of a jump table of 3 entries relative to the function
+  F[3].Offset = 0x23;
+  F[3].DerefSize = 4;
+  F[3].IsRela = true;
+  F[3].TargetKind = FT_Data;
+  F[3].NumJTEntries = 3;
+  F[3].JTEntrySize = 4;
+  F[3].JTFunctionRelative = true;
+
+  // A mov of a GOT entry that the linker may relax
+  F[4].Offset = 0x2b;
+  F[4].DerefSize = 4;
+  F[4].IsRela = true;
+  F[4].TargetKind = FT_Data;
+  F[4].RefClass = FRC_GOT;
+  F[4].GOTRelax = FGR_RexGOTPCRELX;
+  return Fixups;
+}
+
+// A code pointer and the low half of a pointer pair in .data
+inline std::vector<ShuffleInfo::FixupRecord> getDataFixups(uint32_t SectionIdx) {
+  std::vector<ShuffleInfo::FixupRecord> Fixups(2);
+  for (ShuffleInfo::FixupRecord &F : Fixups) {
+    F.TargetKind = FT_Code;
+    F.SectionIdx = SectionIdx;
+  }
+  Fixups[0].DerefSize = 8;
+  Fixups[1].Offset = 0x8;
+  Fixups[1].DerefSize = 4;
+  Fixups[1].PairDelta = 1;
+  return Fixups;
+}
+
+inline std::vector<uint8_t> serialize(const ShuffleInfo::ReorderInfo &RI) {
+  std::string Bytes;
+  EXPECT_TRUE(RI.SerializeToString(&Bytes));
+  return std::vector<uint8_t>(Bytes.begin(), Bytes.end());
+}
+
+// The fixture in the messages of format 1, at RandObjOffset TextBase
+inline ShuffleInfo::ReorderInfo encodeTuples(uint64_t TextBase,
+                                             uint64_t DataBase,
+                                             bool DeltaOffsets) {
+  ShuffleInfo::ReorderInfo RI;
+  RI.mutable_bin()->set_rand_obj_offset(TextBase);
+  RI.mutable_bin()->set_obj_sz(TestSize);
+  if (DeltaOffsets)
+    RI.mutable_bin()->set_fixup_offset_encoding(1);
+  for (size_t I = 0; I != array_lengthof(TestBBLs); ++I) {
+    const TestBBL &B = TestBBLs[I];
+    ShuffleInfo::ReorderInfo_LayoutInfo *L = RI.add_layout();
+    L->set_bb_size(B.Size);
+    L->set_type(B.Type);
+    L->set_num_fixups(TestFixupsPerBBL[I]);
+    L->set_bb_fallthrough(B.FallThrough);
+    L->set_section_name(".text");
+    L->set_hotness(B.Hotness);
+    L->set_padding_sz(B.PaddingSize);
+    L->set_align_log2(B.AlignLog2);
+  }
+
+  ShuffleInfo::ReorderInfo_FixupInfo *FI = RI.add_fixup();
+  auto AddFixups = [&](ArrayRef<ShuffleInfo::FixupRecord> Fixups,
+                       unsigned List, uint64_t Base) {
+    uint32_t Prev = 0;
+    for (ShuffleInfo::FixupRecord F : Fixups) {
+      F.Offset += Base;
+      ShuffleInfo::SetFixupTuple(ShuffleInfo::AddFixupTuple(FI, List), F,
+                                 DeltaOffsets ? uint32_t(F.Offset - Prev)
+                                              : F.Offset);
+      Prev = F.Offset;
+    }
+  };
+  AddFixups(getTextFixups(), ShuffleInfo::FL_Text, TextBase);
+  AddFixups(getDataFixups(0), ShuffleInfo::FL_Data, DataBase);
+  return RI;
+}
+
+// The fixture in the packed columns of format 2; the offsets of a chunk are
+// relative to its sections, .text (0) and .data (1)
+inline ShuffleInfo::ReorderInfo encodeColumns(uint64_t TextBase,
+                                              uint64_t DataBase, bool Chunk) {
+  ShuffleInfo::ReorderInfo RI;
+  RI.mutable_bin()->set_format_version(2);
+  RI.mutable_bin()->set_rand_obj_offset(TextBase);
+  RI.mutable_bin()->set_obj_sz(TestSize);
+  if (Chunk) {
+    RI.add_section_names(".text");
+    RI.add_section_names(".data");
+  }
+
+  ShuffleInfo::ReorderInfo_LayoutColumns *L = RI.mutable_layout_columns();
+  for (size_t I = 0; I != array_lengthof(TestBBLs); ++I) {
+    const TestBBL &B = TestBBLs[I];
+    L->add_bb_size(B.Size);
+    ShuffleInfo::AppendBits(L->mutable_type_bits(), I, B.Type, 2);
+    ShuffleInfo::AppendBits(L->mutable_fallthrough_bits(), I, B.FallThrough, 1);
+    L->add_num_fixups(TestFixupsPerBBL[I]);
+    ShuffleInfo::AppendBits(L->mutable_hotness_bits(), I, B.Hotness, 2);
+    L->add_padding_sz(B.PaddingSize);
+    ShuffleInfo::AppendBits(L->mutable_align_bits(), I, B.AlignLog2, 4);
+  }
+  L->add_function_name_hash(0x1111);
+  L->add_function_name_hash(0x2222);
+
+  auto AddFixups = [&](std::vector<ShuffleInfo::FixupRecord> Fixups,
+                       unsigned List, uint64_t Base) {
+    ShuffleInfo::FixupColumnsWriter W(
+        ShuffleInfo::MutableFixupColumns(&RI, List), Fixups.size(),
+        /*RelocIndices=*/false);
+    for (ShuffleInfo::FixupRecord &F : Fixups) {
+      F.Offset += Base;
+      W.Add(F);
+    }
+  };
+  AddFixups(getTextFixups(), ShuffleInfo::FL_Text, TextBase);
+  AddFixups(getDataFixups(Chunk ? 1 : 0), ShuffleInfo::FL_Data, DataBase);
+  return RI;
+}
+
+// A chunk (format 3) of the encoded Payload, whose sections are named Names,
+// laid out as the assembler writes it; the merge takes the payload as opaque
+// bytes and the counts of its records from the header
+inline std::vector<uint8_t> makeChunk(ArrayRef<StringRef> Names,
+                                      ArrayRef<uint8_t> Payload,
+                                      uint32_t NumLayouts, uint32_t NumFixups,
+                                      uint64_t ShapeHash = 0) {
+  std::vector<ChunkSection> Sections;
+  std::string NameBytes;
+  for (StringRef Name : Names) {
+    ChunkSection S;
+    S.Base = 0;
+    S.NameOffset = NameBytes.size();
+    S.Ordinal = 0;
+    Sections.push_back(S);
+    NameBytes += Name;
+    NameBytes.push_back('\0');
+  }
+
+  ChunkHeader H;
+  H.Signature = ChunkHeader::MagicSignature;
+  H.Version = ChunkHeader::CurrentVersion;
+  H.NumSections = Sections.size();
+  H.NamesSize = NameBytes.size();
+  H.PayloadSize = Payload.size();
+  H.RandObjOffset = 0;
+  H.MainAddrOffset = 0;
+  H.NumLayouts = NumLayouts;
+  H.NumFixups = NumFixups;
+  H.ShapeHash = ShapeHash;
+  H.PayloadRef = ChunkHeader::NoPayloadRef;
+
+  std::vector<uint8_t> Chunk(getChunkSize(H));
+  uint8_t *P = Chunk.data();
+  memcpy(P, &H, sizeof(H));
+  P += sizeof(H);
+  memcpy(P, Sections.data(), Sections.size() * sizeof(ChunkSection));
+  P += Sections.size() * sizeof(ChunkSection);
+  memcpy(P, NameBytes.data(), NameBytes.size());
+  memcpy(P + NameBytes.size(), Payload.data(), Payload.size());
+  return Chunk;
+}
+
+inline std::vector<uint8_t> makeChunk(ArrayRef<StringRef> Names,
+                                      const ShuffleInfo::ReorderInfo &Payload,
+                                      uint64_t ShapeHash = 0) {
+  return makeChunk(Names, serialize(Payload),
+                   Payload.layout_columns().bb_size_size(),
+                   Payload.text_fixup_columns().deref_sz_size() +
+                       Payload.data_fixup_columns().deref_sz_size(),
+                   ShapeHash);
+}
+
+} // end namespace unittest
+} // end namespace ccr
+} // end namespace llvm
+
+#endif // LLVM_UNITTESTS_TOOLS_LLVM_CCR_RAND_RANDFIXTURE_H
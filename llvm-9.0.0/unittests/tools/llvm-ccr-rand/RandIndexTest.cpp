@@ -0,0 +1,299 @@
+//===- RandIndexTest.cpp - Tests for the .rand index ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "RandIndex.h"
+#include "RandInfo.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+
+namespace {
+
+// Two functions at 0x400, the second of which is cold and aligned, with a
+// call, a relaxable jcc and a jump table in .text and a pointer in .data
+RandInfo makeInfo() {
+  RandInfo Info;
+  Info.RandObjOffset = 0x400;
+  Info.MainAddrOffset = 0x410;
+  Info.FormatVersion = 3;
+  Info.SourceTypes = {SRC_Source, SRC_AsmBlocks};
+  Info.EHInfo = {false, true};
+  Info.DataFixups = {true, false};
+  Info.SectionNames = {".text", ".text.unlikely.f", ".data"};
+
+  BasicBlockInfo BBL;
+  BBL.Size = 16;
+  BBL.FallThrough = true;
+  BBL.Hotness = HOT_Hot;
+  BBL.TermSize = 2;
+  BBL.TermKind = TK_CondBranch;
+  Info.BasicBlocks.push_back(BBL);
+
+  BBL = BasicBlockInfo();
+  BBL.Size = 16;
+  BBL.PaddingSize = 5;
+  BBL.Type = BBT_ObjectEnd;
+  BBL.LoopHeader = true;
+  BBL.BoundarySize = 5;
+  BBL.BoundaryLog2 = 5;
+  BBL.BoundaryOffset = 3;
+  Info.BasicBlocks.push_back(BBL);
+
+  BBL = BasicBlockInfo();
+  BBL.Size = 32;
+  BBL.Type = BBT_ObjectEnd;
+  BBL.Hotness = HOT_Cold;
+  BBL.AlignLog2 = 4;
+  BBL.HasCFI = true;
+  BBL.SectionClass = SC_Unlikely;
+  BBL.ChainStart = true;
+  BBL.EdgeProb = 9;
+  Info.BasicBlocks.push_back(BBL);
+  Info.ObjSize = 64;
+
+  FixupInfo F;
+  F.Offset = 0x401;
+  F.DerefSize = 4;
+  F.IsRela = true;
+  F.Target = FT_Code;
+  F.Scope = FS_IntraObject;
+  F.SectionIdx = 0;
+  Info.Fixups[FK_Text].push_back(F);
+
+  F = FixupInfo();
+  F.Offset = 0x42a;
+  F.DerefSize = 1;
+  F.IsRela = true;
+  F.Target = FT_Code;
+  F.Scope = FS_IntraFunction;
+  F.SectionIdx = 1;
+  F.RelaxShortSize = 2;
+  F.RelaxLongSize = 6;
+  F.RelaxFixupOffset = 2;
+  memcpy(F.RelaxLongForm, "\x0f\x85\0\0\0\0", 6);
+  Info.Fixups[FK_Text].push_back(F);
+
+  F = FixupInfo();
+  F.Offset = 0x413;
+  F.DerefSize = 4;
+  F.IsRela = true;
+  F.Target = FT_Data;
+  F.RefClass = FRC_GOT;
+  F.GOTRelax = FGR_GOTPCRELX;
+  F.NumJTEntries = 4;
+  F.JTEntrySize = 4;
+  F.JTFunctionRelative = true;
+  F.ShrinkLongSize = 5;
+  F.ShrinkShortSize = 2;
+  memcpy(F.ShrinkShortForm, "\xeb\0", 2);
+  Info.Fixups[FK_Text].push_back(F);
+
+  F = FixupInfo();
+  F.Offset = 0x2000;
+  F.DerefSize = 8;
+  F.Target = FT_Code;
+  F.PairDelta = 0;
+  F.SectionIdx = 2;
+  Info.Fixups[FK_Data].push_back(F);
+
+  CallSiteTableInfo T;
+  T.FunctionOffset = 0x420;
+  T.TableOffset = 0x80;
+  T.NumRecords = 2;
+  Info.CallSiteTables.push_back(T);
+
+  Info.FunctionIDs.resize(2);
+  Info.FunctionIDs[0].NameHash = 0xfeed;
+  Info.FunctionIDs[1].ContentHash = 0xbeef;
+  computeFixupOwners(Info);
+  return Info;
+}
+
+void expectSameBBL(const BasicBlockInfo &A, const BasicBlockInfo &B) {
+  EXPECT_EQ(A.Size, B.Size);
+  EXPECT_EQ(A.PaddingSize, B.PaddingSize);
+  EXPECT_EQ(A.Type, B.Type);
+  EXPECT_EQ(A.Hotness, B.Hotness);
+  EXPECT_EQ(A.AlignLog2, B.AlignLog2);
+  EXPECT_EQ(A.FallThrough, B.FallThrough);
+  EXPECT_EQ(A.LoopHeader, B.LoopHeader);
+  EXPECT_EQ(A.HasCFI, B.HasCFI);
+  EXPECT_EQ(A.Pinned, B.Pinned);
+  EXPECT_EQ(A.ChainStart, B.ChainStart);
+  EXPECT_EQ(A.EdgeProb, B.EdgeProb);
+  EXPECT_EQ(A.SectionClass, B.SectionClass);
+  EXPECT_EQ(A.TermSize, B.TermSize);
+  EXPECT_EQ(A.TermKind, B.TermKind);
+  EXPECT_EQ(A.BoundarySize, B.BoundarySize);
+  EXPECT_EQ(A.BoundaryLog2, B.BoundaryLog2);
+  EXPECT_EQ(A.BoundaryOffset, B.BoundaryOffset);
+}
+
+void expectSameFixup(const FixupInfo &A, const FixupInfo &B) {
+  EXPECT_EQ(A.Offset, B.Offset);
+  EXPECT_EQ(A.DerefSize, B.DerefSize);
+  EXPECT_EQ(A.IsRela, B.IsRela);
+  EXPECT_EQ(A.Target, B.Target);
+  EXPECT_EQ(A.RefClass, B.RefClass);
+  EXPECT_EQ(A.Scope, B.Scope);
+  EXPECT_EQ(A.PairDelta, B.PairDelta);
+  EXPECT_EQ(A.GOTRelax, B.GOTRelax);
+  EXPECT_EQ(A.JTFunctionRelative, B.JTFunctionRelative);
+  EXPECT_EQ(A.Type, B.Type);
+  EXPECT_EQ(A.NumJTEntries, B.NumJTEntries);
+  EXPECT_EQ(A.JTEntrySize, B.JTEntrySize);
+  EXPECT_EQ(A.SectionIdx, B.SectionIdx);
+  EXPECT_EQ(A.OwnerBBL, B.OwnerBBL);
+  EXPECT_EQ(A.RelaxShortSize, B.RelaxShortSize);
+  EXPECT_EQ(A.RelaxLongSize, B.RelaxLongSize);
+  EXPECT_EQ(A.RelaxFixupOffset, B.RelaxFixupOffset);
+  EXPECT_EQ(0, memcmp(A.RelaxLongForm, B.RelaxLongForm, sizeof(A.RelaxLongForm)));
+  EXPECT_EQ(A.ShrinkLongSize, B.ShrinkLongSize);
+  EXPECT_EQ(A.ShrinkShortSize, B.ShrinkShortSize);
+  EXPECT_EQ(0, memcmp(A.ShrinkShortForm, B.ShrinkShortForm,
+                      sizeof(A.ShrinkShortForm)));
+}
+
+class RandIndexTest : public ::testing::Test {
+protected:
+  SmallString<128> Dir;
+  SmallString<128> Path;
+
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("rand-index-test", Dir));
+    Path = Dir;
+    sys::path::append(Path, "a.out.ccr-index");
+  }
+
+  void TearDown() override {
+    sys::fs::remove(Path);
+    sys::fs::remove(Dir);
+  }
+};
+
+TEST_F(RandIndexTest, RoundTrip) {
+  RandInfo Info = makeInfo();
+  // The owners have sorted the .text fixups by offset
+  EXPECT_EQ(0x413u, Info.Fixups[FK_Text][1].Offset);
+  EXPECT_EQ(1, Info.Fixups[FK_Text][1].OwnerBBL);
+  EXPECT_EQ(2, Info.Fixups[FK_Text][2].OwnerBBL);
+
+  const uint8_t Rand[] = {1, 2, 3, 4};
+  uint64_t Key = getRandIndexKey(Rand);
+  ASSERT_THAT_ERROR(writeRandIndex(Path, Key, Info), Succeeded());
+
+  Expected<RandInfo> Read = readRandIndex(Path, Key);
+  ASSERT_THAT_EXPECTED(Read, Succeeded());
+  EXPECT_EQ(Info.RandObjOffset, Read->RandObjOffset);
+  EXPECT_EQ(Info.MainAddrOffset, Read->MainAddrOffset);
+  EXPECT_EQ(Info.ObjSize, Read->ObjSize);
+  EXPECT_EQ(Info.FormatVersion, Read->FormatVersion);
+  EXPECT_EQ(Info.SourceTypes, Read->SourceTypes);
+  EXPECT_EQ(Info.EHInfo, Read->EHInfo);
+  EXPECT_EQ(Info.DataFixups, Read->DataFixups);
+  EXPECT_EQ(Info.SectionNames, Read->SectionNames);
+
+  ASSERT_EQ(Info.BasicBlocks.size(), Read->BasicBlocks.size());
+  for (size_t I = 0, E = Info.BasicBlocks.size(); I != E; ++I)
+    expectSameBBL(Info.BasicBlocks[I], Read->BasicBlocks[I]);
+  for (unsigned K = 0; K < NumFixupKinds; ++K) {
+    ASSERT_EQ(Info.Fixups[K].size(), Read->Fixups[K].size()) << "list " << K;
+    for (size_t I = 0, E = Info.Fixups[K].size(); I != E; ++I)
+      expectSameFixup(Info.Fixups[K][I], Read->Fixups[K][I]);
+  }
+
+  ASSERT_EQ(1u, Read->CallSiteTables.size());
+  EXPECT_EQ(0x420u, Read->CallSiteTables[0].FunctionOffset);
+  EXPECT_EQ(0x80u, Read->CallSiteTables[0].TableOffset);
+  EXPECT_EQ(2u, Read->CallSiteTables[0].NumRecords);
+  ASSERT_EQ(2u, Read->FunctionIDs.size());
+  EXPECT_EQ(0xfeedu, Read->getFunctionID(0).NameHash);
+  EXPECT_EQ(0xbeefu, Read->getFunctionID(1).ContentHash);
+  EXPECT_FALSE(Read->hasIncomingFixups());
+}
+
+TEST_F(RandIndexTest, StaleKey) {
+  RandInfo Info = makeInfo();
+  const uint8_t Rand[] = {1, 2, 3, 4}, Rebuilt[] = {1, 2, 3, 5};
+  ASSERT_NE(getRandIndexKey(Rand), getRandIndexKey(Rebuilt));
+  ASSERT_THAT_ERROR(writeRandIndex(Path, getRandIndexKey(Rand), Info),
+                    Succeeded());
+  EXPECT_THAT_EXPECTED(readRandIndex(Path, getRandIndexKey(Rebuilt)), Failed());
+
+  // So does a truncated index
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buf));
+  ArrayRef<uint8_t> Data = arrayRefFromStringRef((*Buf)->getBuffer());
+  EXPECT_THAT_EXPECTED(
+      readRandIndex(Data.drop_back(8), getRandIndexKey(Rand), Path), Failed());
+  EXPECT_THAT_EXPECTED(readRandIndex(Data, getRandIndexKey(Rand), Path),
+                       Succeeded());
+}
+
+TEST_F(RandIndexTest, View) {
+  RandInfo Info = makeInfo();
+  // The call at 0x401 goes to the second function, the jump table to the first
+  computeIncomingFixups(
+      Info, [](unsigned Kind, const FixupInfo &F) -> Optional<uint64_t> {
+        if (Kind == FK_Text && F.Offset == 0x401)
+          return 0x420;
+        if (Kind == FK_Data)
+          return 0x408;
+        return None;
+      });
+  ASSERT_THAT_ERROR(writeRandIndex(Path, 1, Info), Succeeded());
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buf));
+  ArrayRef<uint8_t> Data = arrayRefFromStringRef((*Buf)->getBuffer());
+
+  Expected<RandInfo> Read = readRandIndex(Data, 1, Path);
+  ASSERT_THAT_EXPECTED(Read, Succeeded());
+  ASSERT_TRUE(Read->hasIncomingFixups());
+  ASSERT_EQ(1u, Read->getIncomingFixups(0).size());
+  EXPECT_EQ(unsigned(FK_Data), Read->getIncomingFixups(0)[0].getKind());
+  ASSERT_EQ(1u, Read->getIncomingFixups(1).size());
+  EXPECT_EQ(0u, Read->getIncomingFixups(1)[0].getIndex());
+
+  Expected<RandIndexView> View = RandIndexView::create(Data, 1, Path);
+  ASSERT_THAT_EXPECTED(View, Succeeded());
+  EXPECT_EQ(2u, View->getNumFunctions());
+
+  Expected<Optional<IndexedFunction>> Second = View->lookup(0x42f);
+  ASSERT_THAT_EXPECTED(Second, Succeeded());
+  ASSERT_TRUE(Second->hasValue());
+  const IndexedFunction &F = **Second;
+  EXPECT_EQ(0x420u, F.Offset);
+  EXPECT_EQ(2u, F.FirstBBL);
+  EXPECT_EQ(0xbeefu, F.ID.ContentHash);
+  ASSERT_EQ(1u, F.BasicBlocks.size());
+  expectSameBBL(Info.BasicBlocks[2], F.BasicBlocks[0]);
+  ASSERT_EQ(1u, F.Fixups.size());
+  expectSameFixup(Info.Fixups[FK_Text][2], F.Fixups[0]);
+  ASSERT_EQ(1u, F.Incoming.size());
+  EXPECT_EQ(unsigned(FK_Text), F.Incoming[0].getKind());
+
+  Expected<Optional<IndexedFunction>> First = View->lookup(0x400);
+  ASSERT_THAT_EXPECTED(First, Succeeded());
+  ASSERT_TRUE(First->hasValue());
+  EXPECT_EQ(2u, (*First)->BasicBlocks.size());
+  EXPECT_EQ(2u, (*First)->Fixups.size());
+
+  Expected<Optional<IndexedFunction>> Outside = View->lookup(0x440);
+  ASSERT_THAT_EXPECTED(Outside, Succeeded());
+  EXPECT_FALSE(Outside->hasValue());
+  EXPECT_THAT_EXPECTED(RandIndexView::create(Data, 2, Path), Failed());
+}
+
+} // end anonymous namespace
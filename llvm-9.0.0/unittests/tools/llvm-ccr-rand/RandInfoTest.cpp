@@ -0,0 +1,275 @@
+//===- RandInfoTest.cpp - Tests for the decoding of .rand -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "RandFixture.h"
+#include "RandInfo.h"
+#include "llvm/Object/RandChunk.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::ccr;
+using namespace llvm::ccr::unittest;
+
+namespace {
+
+void expectFixup(const ShuffleInfo::FixupRecord &R, uint64_t Offset,
+                 const FixupInfo &F) {
+  EXPECT_EQ(Offset, F.Offset);
+  EXPECT_EQ(R.DerefSize, F.DerefSize);
+  EXPECT_EQ(R.IsRela, F.IsRela);
+  EXPECT_EQ(R.TargetKind, F.Target);
+  EXPECT_EQ(R.RefClass, F.RefClass);
+  EXPECT_EQ(R.Scope, F.Scope);
+  EXPECT_EQ(R.PairDelta, F.PairDelta);
+  EXPECT_EQ(R.GOTRelax, F.GOTRelax);
+  EXPECT_EQ(R.NumJTEntries, F.NumJTEntries);
+  EXPECT_EQ(R.JTEntrySize, F.JTEntrySize);
+  EXPECT_EQ(R.JTFunctionRelative, F.JTFunctionRelative);
+  EXPECT_EQ(R.RelaxShortSize, F.RelaxShortSize);
+  EXPECT_EQ(R.RelaxLongSize, F.RelaxLongSize);
+  EXPECT_EQ(R.RelaxFixupOffset, F.RelaxFixupOffset);
+  EXPECT_EQ(0, memcmp(R.RelaxLongForm, F.RelaxLongForm, R.RelaxLongSize));
+  EXPECT_EQ(R.ShrinkLongSize, F.ShrinkLongSize);
+  EXPECT_EQ(R.ShrinkShortSize, F.ShrinkShortSize);
+  EXPECT_EQ(0, memcmp(R.ShrinkShortForm, F.ShrinkShortForm, R.ShrinkShortSize));
+}
+
+// Check the fixture at the .text offset TextBase, with its .data fixups at
+// DataBase, in Info from its BBL FirstBBL and its fixups FirstText/FirstData;
+// its last BBL may have taken TailPadding bytes up to the next object
+void expectObject(const RandInfo &Info, size_t FirstBBL, uint64_t TextBase,
+                  size_t FirstText, uint64_t DataBase, size_t FirstData,
+                  uint32_t TailPadding = 0) {
+  size_t NumBBLs = array_lengthof(TestBBLs);
+  ASSERT_LE(FirstBBL + NumBBLs, Info.BasicBlocks.size());
+  for (size_t I = 0; I != NumBBLs; ++I) {
+    const BasicBlockInfo &BBL = Info.BasicBlocks[FirstBBL + I];
+    uint32_t Padding = I + 1 == NumBBLs ? TailPadding : 0;
+    EXPECT_EQ(TestBBLs[I].Size + Padding, BBL.Size) << "BBL #" << I;
+    EXPECT_EQ(TestBBLs[I].Type, BBL.Type) << "BBL #" << I;
+    EXPECT_EQ(TestBBLs[I].FallThrough, BBL.FallThrough) << "BBL #" << I;
+    EXPECT_EQ(TestBBLs[I].Hotness, BBL.Hotness) << "BBL #" << I;
+    EXPECT_EQ(TestBBLs[I].PaddingSize + Padding, BBL.PaddingSize)
+        << "BBL #" << I;
+    EXPECT_EQ(TestBBLs[I].AlignLog2, BBL.AlignLog2) << "BBL #" << I;
+  }
+
+  std::vector<ShuffleInfo::FixupRecord> Text = getTextFixups();
+  ASSERT_LE(FirstText + Text.size(), Info.Fixups[FK_Text].size());
+  for (size_t I = 0; I != Text.size(); ++I)
+    expectFixup(Text[I], TextBase + Text[I].Offset,
+                Info.Fixups[FK_Text][FirstText + I]);
+  std::vector<ShuffleInfo::FixupRecord> Data = getDataFixups(0);
+  ASSERT_LE(FirstData + Data.size(), Info.Fixups[FK_Data].size());
+  for (size_t I = 0; I != Data.size(); ++I)
+    expectFixup(Data[I], DataBase + Data[I].Offset,
+                Info.Fixups[FK_Data][FirstData + I]);
+}
+
+// Another object: a single BBL with a call out of the object
+ShuffleInfo::ReorderInfo encodeSmallObject() {
+  ShuffleInfo::ReorderInfo RI;
+  RI.mutable_bin()->set_format_version(2);
+  RI.add_section_names(".text");
+  ShuffleInfo::ReorderInfo_LayoutColumns *L = RI.mutable_layout_columns();
+  L->add_bb_size(24);
+  ShuffleInfo::AppendBits(L->mutable_type_bits(), 0, BBT_ObjectEnd, 2);
+  L->add_num_fixups(1);
+  ShuffleInfo::AppendBits(L->mutable_align_bits(), 0, 4, 4);
+
+  ShuffleInfo::FixupRecord F;
+  F.Offset = 0x5;
+  F.DerefSize = 4;
+  F.IsRela = true;
+  F.TargetKind = FT_Code;
+  ShuffleInfo::FixupColumnsWriter W(
+      ShuffleInfo::MutableFixupColumns(&RI, ShuffleInfo::FL_Text), 1,
+      /*RelocIndices=*/false);
+  W.Add(F);
+  return RI;
+}
+
+TEST(RandInfoTest, TupleAbsoluteOffsets) {
+  std::vector<uint8_t> Contents =
+      serialize(encodeTuples(0x40, 0x1000, /*DeltaOffsets=*/false));
+  Expected<RandInfo> Info = parseRandInfo(".rand", Contents, false);
+  ASSERT_THAT_EXPECTED(Info, Succeeded());
+  EXPECT_EQ(1u, Info->FormatVersion);
+  EXPECT_EQ(0x40u, Info->RandObjOffset);
+  EXPECT_EQ(TestSize, Info->ObjSize);
+  EXPECT_EQ(1u, Info->getNumObjects());
+  EXPECT_EQ(2u, countFunctions(Info->BasicBlocks));
+  ASSERT_EQ(3u, Info->BasicBlocks.size());
+  ASSERT_EQ(5u, Info->Fixups[FK_Text].size());
+  ASSERT_EQ(2u, Info->Fixups[FK_Data].size());
+  EXPECT_TRUE(Info->Fixups[FK_Rodata].empty());
+  EXPECT_TRUE(Info->FunctionIDs.empty());
+  expectObject(*Info, 0, 0x40, 0, 0x1000, 0);
+}
+
+TEST(RandInfoTest, TupleDeltaOffsets) {
+  // The deltas wrap around modulo 2^32
+  std::vector<uint8_t> Contents =
+      serialize(encodeTuples(0xfffffff0, 0x1000, /*DeltaOffsets=*/true));
+  Expected<RandInfo> Info = parseRandInfo(".rand", Contents, false);
+  ASSERT_THAT_EXPECTED(Info, Succeeded());
+  const uint64_t Wrapped[] = {0xfffffff1, 0xfffffffa, 0x6, 0x13, 0x1b};
+  ASSERT_EQ(5u, Info->Fixups[FK_Text].size());
+  for (size_t I = 0; I != array_lengthof(Wrapped); ++I)
+    EXPECT_EQ(Wrapped[I], Info->Fixups[FK_Text][I].Offset) << "fixup #" << I;
+
+  Contents = serialize(encodeTuples(0x40, 0x1000, /*DeltaOffsets=*/true));
+  Info = parseRandInfo(".rand", Contents, false);
+  ASSERT_THAT_EXPECTED(Info, Succeeded());
+  expectObject(*Info, 0, 0x40, 0, 0x1000, 0);
+}
+
+TEST(RandInfoTest, Columns) {
+  std::vector<uint8_t> Contents =
+      serialize(encodeColumns(0x40, 0x1000, /*Chunk=*/false));
+  Expected<RandInfo> Info = parseRandInfo(".rand", Contents, false);
+  ASSERT_THAT_EXPECTED(Info, Succeeded());
+  EXPECT_EQ(2u, Info->FormatVersion);
+  EXPECT_EQ(0x40u, Info->RandObjOffset);
+  EXPECT_EQ(TestSize, Info->ObjSize);
+  ASSERT_EQ(3u, Info->BasicBlocks.size());
+  ASSERT_EQ(5u, Info->Fixups[FK_Text].size());
+  ASSERT_EQ(2u, Info->Fixups[FK_Data].size());
+  expectObject(*Info, 0, 0x40, 0, 0x1000, 0);
+  ASSERT_EQ(2u, Info->FunctionIDs.size());
+  EXPECT_EQ(0x1111u, Info->getFunctionID(0).NameHash);
+  EXPECT_EQ(0x2222u, Info->getFunctionID(1).NameHash);
+  EXPECT_EQ(0u, Info->getFunctionID(1).ContentHash);
+}
+
+TEST(RandInfoTest, Chunks) {
+  // The inputs of the linker: the small object, the fixture, an input
+  // without .rand, the small object again (sharing its payload), and a copy
+  // that --icf has folded
+  ShuffleInfo::ReorderInfo Small = encodeSmallObject();
+  std::vector<uint8_t> Inputs[] = {
+      makeChunk({".text"}, Small, 0x5a5a),
+      makeChunk({".text", ".data"}, encodeColumns(0, 0, /*Chunk=*/true)),
+      makeChunk({".text"}, Small, 0x5a5a),
+      makeChunk({".text"}, Small, 0x5a5a),
+  };
+  // The fixture at 0x40 is followed by the small object at 0x88 (within its
+  // alignment) and by the copy at 0x100, past the foreign code at 0xa0
+  const uint64_t TextBases[] = {0x88, 0x40, 0x100, ChunkSection::DiscardedBase};
+  auto Patch = [&](unsigned InputIdx, ChunkHeader &,
+                   MutableArrayRef<ChunkSection> Sections,
+                   StringRef) -> Error {
+    Sections[0].Base = TextBases[InputIdx];
+    if (Sections.size() > 1)
+      Sections[1].Base = 0x1000;
+    return Error::success();
+  };
+  std::vector<ArrayRef<uint8_t>> InputRefs(std::begin(Inputs), std::end(Inputs));
+  std::vector<uint8_t> Merged;
+  ASSERT_THAT_ERROR(object::mergeRandSections(InputRefs, Patch, Merged),
+                    Succeeded());
+  ASSERT_TRUE(object::isRandChunked(Merged));
+
+  for (bool Parallel : {false, true}) {
+    Expected<RandInfo> Info = parseRandInfo(".rand", Merged, false, Parallel);
+    ASSERT_THAT_EXPECTED(Info, Succeeded());
+    EXPECT_EQ(3u, Info->FormatVersion);
+    EXPECT_EQ(0x40u, Info->RandObjOffset);
+    EXPECT_EQ(0xd8u, Info->ObjSize);
+    ASSERT_EQ(6u, Info->BasicBlocks.size());
+    EXPECT_EQ(4u, Info->getNumObjects());
+    ASSERT_EQ(4u, Info->SourceTypes.size());
+    EXPECT_EQ(uint32_t(SRC_Foreign), Info->SourceTypes[2]);
+    EXPECT_EQ(uint32_t(SRC_Source), Info->SourceTypes[3]);
+
+    // The gap up to the small object pads the last BBL of the fixture
+    expectObject(*Info, 0, 0x40, 1, 0x1000, 0, /*TailPadding=*/8);
+    const std::vector<BasicBlockInfo> &BBLs = Info->BasicBlocks;
+    EXPECT_EQ(24u, BBLs[3].Size);
+    EXPECT_EQ(0x60u, BBLs[4].Size);
+    EXPECT_TRUE(BBLs[4].Pinned);
+    EXPECT_EQ(BBT_ObjectEnd, BBLs[4].Type);
+    EXPECT_EQ(24u, BBLs[5].Size);
+
+    // The fixups are in the order of the chunks, and those of the folded
+    // copy are gone
+    ASSERT_EQ(5u, Info->SectionNames.size());
+    EXPECT_EQ(".data", Info->SectionNames[2]);
+    const std::vector<FixupInfo> &Text = Info->Fixups[FK_Text];
+    ASSERT_EQ(7u, Text.size());
+    EXPECT_EQ(0x8du, Text[0].Offset);
+    EXPECT_EQ(0u, Text[0].SectionIdx);
+    EXPECT_EQ(1u, Text[1].SectionIdx);
+    EXPECT_EQ(0x105u, Text[6].Offset);
+    EXPECT_EQ(3u, Text[6].SectionIdx);
+    ASSERT_EQ(2u, Info->Fixups[FK_Data].size());
+    EXPECT_EQ(2u, Info->Fixups[FK_Data][0].SectionIdx);
+
+    // Only the fixture has identities; the other functions are unknown
+    ASSERT_EQ(5u, Info->FunctionIDs.size());
+    EXPECT_EQ(0x2222u, Info->getFunctionID(1).NameHash);
+    EXPECT_EQ(0u, Info->getFunctionID(2).NameHash);
+  }
+}
+
+TEST(RandInfoTest, FixupOwners) {
+  std::vector<uint8_t> Contents =
+      serialize(encodeColumns(0x40, 0x1000, /*Chunk=*/false));
+  Expected<RandInfo> Info = parseRandInfo(".rand", Contents, false);
+  ASSERT_THAT_EXPECTED(Info, Succeeded());
+  computeFixupOwners(*Info);
+  const int32_t Owners[] = {0, 0, 1, 2, 2};
+  for (size_t I = 0; I != array_lengthof(Owners); ++I)
+    EXPECT_EQ(Owners[I], Info->Fixups[FK_Text][I].OwnerBBL) << "fixup #" << I;
+}
+
+TEST(RandInfoTest, Malformed) {
+  auto Parse = [](const ShuffleInfo::ReorderInfo &RI) {
+    return parseRandInfo(".rand", serialize(RI), false).takeError();
+  };
+
+  ShuffleInfo::ReorderInfo RI = encodeTuples(0x40, 0x1000, false);
+  RI.mutable_bin()->set_obj_sz(TestSize + 1);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  RI = encodeTuples(0x40, 0x1000, false);
+  RI.mutable_fixup(0)->mutable_text(0)->set_got_relax(FGR_GOTPCRELX);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  RI = encodeTuples(0x40, 0x1000, false);
+  RI.mutable_fixup(0)->mutable_text(1)->set_relax_fixup_offset(1);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  RI = encodeTuples(0x40, 0x1000, false);
+  RI.mutable_fixup(0)->mutable_data(0)->set_pair_delta(1);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  RI = encodeColumns(0x40, 0x1000, false);
+  RI.mutable_layout_columns()->add_function_name_hash(0x3333);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  // The BBLs past the end of section_idx are in the first section, but the
+  // column cannot outgrow the BBLs
+  RI = encodeColumns(0x40, 0x1000, false);
+  for (size_t I = 0; I <= array_lengthof(TestBBLs); ++I)
+    RI.mutable_layout_columns()->add_section_idx(0);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  RI = encodeColumns(0x40, 0x1000, false);
+  RI.mutable_text_fixup_columns()->add_jt_fixup_idx(5);
+  RI.mutable_text_fixup_columns()->add_num_jt_entries(1);
+  RI.mutable_text_fixup_columns()->add_jt_entry_sz(4);
+  EXPECT_THAT_ERROR(Parse(RI), Failed());
+
+  const uint8_t Truncated[] = {0x2a, 0x05, '.', 't'};
+  EXPECT_THAT_EXPECTED(parseRandInfo(".rand", Truncated, false), Failed());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,150 @@
+//===- CCRRandDumperTest.cpp - Tests for the .rand dumper -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "CCRRandDumper.h"
+#include "RandFixture.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/RandChunk.h"
+#include "llvm/Support/ScopedPrinter.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace llvm;
+using namespace llvm::ccr::unittest;
+using testing::HasSubstr;
+using testing::Not;
+
+namespace {
+
+std::string dump(ArrayRef<uint8_t> Contents, bool Full) {
+  std::string Out;
+  raw_string_ostream OS(Out);
+  ScopedPrinter W(OS);
+  EXPECT_THAT_ERROR(dumpCCRRandSection(".rand", Contents, W, Full),
+                    Succeeded());
+  return OS.str();
+}
+
+// The summary of N copies of the fixture
+void expectSummary(const std::string &Out, unsigned N) {
+  EXPECT_THAT(Out, HasSubstr("  BBLs: " + utostr(3 * N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("  Functions: " + utostr(2 * N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("  Objects: " + utostr(N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("    text: " + utostr(5 * N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("    data: " + utostr(2 * N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("    Total: " + utostr(7 * N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("  JumpTables: " + utostr(N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("  JumpTableEntries: " + utostr(3 * N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("  RelaxableFixups: " + utostr(N) + "\n"));
+  EXPECT_THAT(Out, HasSubstr("  ShrinkableFixups: " + utostr(N) + "\n"));
+}
+
+// The records of the fixture, whose .text starts at TextBase
+void expectRecords(const std::string &Out, uint64_t TextBase) {
+  EXPECT_THAT(Out, HasSubstr("BBL      0: size=16    MBB ft pad=0   align=16 "
+                             "fixups=2   sec=0   hot\n"));
+  EXPECT_THAT(Out, HasSubstr("BBL      1: size=16    MF     pad=6   align=1  "
+                             "fixups=1   sec=0   hot\n"));
+  EXPECT_THAT(Out, HasSubstr("BBL      2: size=32    Obj    pad=0   align=16 "
+                             "fixups=2   sec=0   cold\n"));
+  EXPECT_THAT(Out, HasSubstr("Fixup text           3: offset=0x" +
+                             utohexstr(TextBase + 0x23, true)));
+  EXPECT_THAT(Out, HasSubstr("size=4 pcrel target=data direct sec=0 "
+                             "jt=3x4@func\n"));
+  EXPECT_THAT(Out, HasSubstr("size=1 pcrel target=code direct sec=0 relax=2 "
+                             "intra-function\n"));
+  EXPECT_THAT(Out, HasSubstr("size=4 pcrel target=code direct sec=0 shrink=5 "
+                             "intra-function\n"));
+  EXPECT_THAT(Out, HasSubstr("target=data got    sec=0 rex_gotpcrelx\n"));
+  EXPECT_THAT(Out, HasSubstr("Fixup data           1: "));
+  EXPECT_THAT(Out, HasSubstr(" pair=-1\n"));
+}
+
+TEST(CCRRandDumperTest, Tuples) {
+  std::vector<uint8_t> Contents =
+      serialize(encodeTuples(0x400, 0x2000, /*DeltaOffsets=*/false));
+  std::string Out = dump(Contents, /*Full=*/false);
+  EXPECT_THAT(Out, HasSubstr("  Format 1 messages: 1\n"));
+  EXPECT_THAT(Out, Not(HasSubstr("Chunks")));
+  EXPECT_THAT(Out, Not(HasSubstr("Records")));
+  expectSummary(Out, 1);
+  EXPECT_THAT(Out, HasSubstr("fixup.text"));
+
+  Out = dump(Contents, /*Full=*/true);
+  EXPECT_THAT(Out, HasSubstr("  RandObjOffset: 0x400\n"));
+  expectRecords(Out, 0x400);
+  expectSummary(Out, 1);
+
+  // The offsets of the delta encoding read the same
+  Contents = serialize(encodeTuples(0x400, 0x2000, /*DeltaOffsets=*/true));
+  expectRecords(dump(Contents, /*Full=*/true), 0x400);
+}
+
+TEST(CCRRandDumperTest, Columns) {
+  std::vector<uint8_t> Contents =
+      serialize(encodeColumns(0x400, 0x2000, /*Chunk=*/false));
+  std::string Out = dump(Contents, /*Full=*/false);
+  EXPECT_THAT(Out, HasSubstr("  Format 2 messages: 1\n"));
+  EXPECT_THAT(Out, HasSubstr("  NamedFunctions: 2\n"));
+  expectSummary(Out, 1);
+  EXPECT_THAT(Out, HasSubstr("text_fixup_columns.offset_delta"));
+
+  Out = dump(Contents, /*Full=*/true);
+  expectRecords(Out, 0x400);
+  EXPECT_THAT(Out, HasSubstr("Function      1: name=0x0000000000002222\n"));
+}
+
+TEST(CCRRandDumperTest, Chunks) {
+  std::vector<uint8_t> Contents =
+      makeChunk({".text", ".data"}, encodeColumns(0, 0, /*Chunk=*/true));
+  std::vector<uint8_t> Second = Contents;
+  auto *H = reinterpret_cast<ccr::ChunkHeader *>(Second.data());
+  H->RandObjOffset = 0x440;
+  auto *Sections = reinterpret_cast<ccr::ChunkSection *>(H + 1);
+  Sections[0].Base = 0x440;
+  Sections[1].Base = 0x2000;
+  Contents.insert(Contents.end(), Second.begin(), Second.end());
+
+  std::string Out = dump(Contents, /*Full=*/false);
+  EXPECT_THAT(Out, HasSubstr("  Chunks: 2\n"));
+  EXPECT_THAT(Out, HasSubstr("  Format 2 messages: 2\n"));
+  expectSummary(Out, 2);
+
+  // The offsets of a chunk are relative to its sections
+  Out = dump(Contents, /*Full=*/true);
+  EXPECT_THAT(Out, HasSubstr("Chunk 1: payload="));
+  EXPECT_THAT(Out, HasSubstr("layouts=3 fixups=7 objoff=0x440"));
+  EXPECT_THAT(Out, HasSubstr("  .text #0 at 0x440\n"));
+  EXPECT_THAT(Out, HasSubstr("  .data #0 at 0x2000\n"));
+  EXPECT_THAT(Out, HasSubstr("  Section 1: .data\n"));
+  expectRecords(Out, 0);
+  EXPECT_THAT(Out, HasSubstr("Fixup text           9: "));
+}
+
+TEST(CCRRandDumperTest, Malformed) {
+  // A BinaryInfo that runs past the end of the section
+  const uint8_t Truncated[] = {0x0a, 0x05, 0x08};
+  std::string Out;
+  raw_string_ostream OS(Out);
+  ScopedPrinter W(OS);
+  Error E = dumpCCRRandSection(".rand", Truncated, W, /*Full=*/false);
+  ASSERT_TRUE(bool(E));
+  EXPECT_THAT(toString(std::move(E)), HasSubstr(".rand: "));
+
+  std::vector<uint8_t> Chunk =
+      makeChunk({".text", ".data"}, encodeColumns(0, 0, /*Chunk=*/true));
+  EXPECT_THAT_ERROR(dumpCCRRandSection(".rand",
+                                       makeArrayRef(Chunk).drop_back(8), W,
+                                       /*Full=*/false),
+                    Failed());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+"""Check a CCR runtime report against overhead budgets per shuffle mode.
+
+The report is written by benchmarks/ccr-runtime/run_ccr_perf.py; the budgets
+are the maximal overheads (in percent) of a metric statistic per mode, e.g.
+
+  {"function": {"time_ms.mean": 1.0, "time_ms.p99": 3.0,
+                "itlb_misses.mean": 20.0},
+   "bbl": {"time_ms.mean": 5.0, "l1i_misses.mean": 30.0}}
+
+The exit status is 1 if any budget is exceeded (or cannot be checked).
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+SUPPORTED_VERSION = 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('report', help='the JSON report of run_ccr_perf.py')
+    parser.add_argument('budgets', help='the JSON budgets')
+    args = parser.parse_args()
+
+    with open(args.report) as f:
+        report = json.load(f)
+    with open(args.budgets) as f:
+        budgets = json.load(f)
+    if report.get('version') != SUPPORTED_VERSION:
+        sys.exit('error: unsupported report version %r' % report.get('version'))
+
+    failed = False
+    for mode, limits in sorted(budgets.items()):
+        measured = report['modes'].get(mode)
+        if measured is None:
+            print('MISSING %s: the mode was not measured' % mode)
+            failed = True
+            continue
+        for key, limit in sorted(limits.items()):
+            metric, _, stat = key.partition('.')
+            value = measured['overhead_pct'].get(metric, {}).get(stat or 'mean')
+            if value is None:
+                print('MISSING %s %s: not in the report' % (mode, key))
+                failed = True
+            elif value > limit:
+                print('FAIL    %s %s: %+.2f%% > %.2f%%' % (mode, key, value,
+                                                          limit))
+                failed = True
+            else:
+                print('PASS    %s %s: %+.2f%% <= %.2f%%' % (mode, key, value,
+                                                           limit))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
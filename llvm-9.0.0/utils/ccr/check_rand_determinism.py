@@ -0,0 +1,160 @@
+#!/usr/bin/env python
+"""Check that the CCR toolchain writes the same .rand bytes on every build.
+
+The corpus (benchmarks/ccr-compile/corpus by default, or the --src files) is
+compiled twice with -fccr-metadata: once serially, and once with --jobs
+parallel compilations, from a copy of the sources in another directory, under
+another TMPDIR and with other object names. The .rand sections of every pair
+of objects must be byte-for-byte identical, since content-addressed build
+caches key the objects by them.
+
+  check_rand_determinism.py --cc build/bin/clang --jobs 16
+
+The exit status is 1 if any .rand section differs (or a build fails).
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+from multiprocessing import cpu_count
+from multiprocessing.pool import ThreadPool
+
+CORPUS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                          os.pardir, os.pardir, 'benchmarks', 'ccr-compile',
+                          'corpus')
+
+# The flag sets every source is built with; the section layout and the
+# debug information must not leak into the metadata either
+VARIANTS = [
+    ['-O2'],
+    ['-O2', '-g', '-ffunction-sections'],
+]
+
+
+def std_flags(src):
+    return ['-std=c++14'] if src.endswith(('.cpp', '.cc')) else []
+
+
+def rand_sections(path):
+    """Return the (name, bytes) of the .rand sections of an ELF64 object."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4:5] != b'\x02':
+        return []
+    shoff, = struct.unpack_from('<Q', data, 0x28)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x3a)
+
+    def header(i):
+        # sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size
+        return struct.unpack_from('<IIQQQQ', data, shoff + i * shentsize)
+
+    strtab_off = header(shstrndx)[4]
+    sections = []
+    for i in range(shnum):
+        name_off, _, _, _, offset, size = header(i)
+        end = data.index(b'\0', strtab_off + name_off)
+        name = data[strtab_off + name_off:end]
+        if name.startswith(b'.rand'):
+            sections.append((name, data[offset:offset + size]))
+    return sections
+
+
+def build(cc, jobs, srcs, work_dir, obj_prefix):
+    """Compile every (source, variant) into work_dir; return the objects."""
+    tmp = os.path.join(work_dir, 'tmp')
+    os.makedirs(tmp)
+    env = dict(os.environ, TMPDIR=tmp)
+    tasks = []
+    for src in srcs:
+        base = os.path.splitext(os.path.basename(src))[0]
+        for v, flags in enumerate(VARIANTS):
+            obj = os.path.join(work_dir, '%s%s.%d.o' % (obj_prefix, base, v))
+            cmd = [cc, '-c', src, '-o', obj, '-fccr-metadata'] + flags
+            tasks.append(((os.path.basename(src), v), cmd + std_flags(src),
+                          obj))
+
+    def run(task):
+        key, cmd, obj = task
+        return key, obj, subprocess.call(cmd, env=env)
+
+    pool = ThreadPool(jobs)
+    try:
+        results = pool.map(run, tasks)
+    finally:
+        pool.close()
+    for (_, cmd, _), (_, _, status) in zip(tasks, results):
+        if status != 0:
+            sys.exit('error: %s failed' % ' '.join(cmd))
+    return dict((key, obj) for key, obj, _ in results)
+
+
+def first_difference(a, b):
+    for i, (x, y) in enumerate(zip(a, b)):
+        if x != y:
+            return i
+    return min(len(a), len(b))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--cc', required=True, help='the CCR clang')
+    parser.add_argument('--jobs', type=int, default=cpu_count(),
+                        help='parallel compilations of the second build')
+    parser.add_argument('--src', action='append',
+                        help='a source to check instead of the corpus')
+    parser.add_argument('--work-dir', help='where the builds go (kept)')
+    args = parser.parse_args()
+
+    srcs = args.src or sorted(os.path.join(CORPUS_DIR, name)
+                              for name in os.listdir(CORPUS_DIR))
+    work_dir = args.work_dir or tempfile.mkdtemp(prefix='ccr-determinism-')
+    first_dir = os.path.join(work_dir, 'first')
+    second_dir = os.path.join(work_dir, 'second')
+    copy_dir = os.path.join(second_dir, 'src')
+    for d in (first_dir, second_dir):
+        if os.path.isdir(d):
+            shutil.rmtree(d)
+    os.makedirs(copy_dir)
+    copies = []
+    for src in srcs:
+        copies.append(os.path.join(copy_dir, os.path.basename(src)))
+        shutil.copyfile(src, copies[-1])
+
+    first = build(args.cc, 1, srcs, first_dir, '')
+    second = build(args.cc, args.jobs, copies, second_dir, 'again-')
+
+    failed = False
+    for key in sorted(first):
+        name, variant = key
+        flags = ' '.join(VARIANTS[variant])
+        a, b = rand_sections(first[key]), rand_sections(second[key])
+        if not a:
+            print('MISSING %s (%s): no .rand section' % (name, flags))
+            failed = True
+        elif [s[0] for s in a] != [s[0] for s in b]:
+            print('FAIL    %s (%s): other .rand sections' % (name, flags))
+            failed = True
+        else:
+            diffs = [(n, first_difference(x, y), len(x), len(y))
+                     for (n, x), (_, y) in zip(a, b) if x != y]
+            for n, offset, size_a, size_b in diffs:
+                print('FAIL    %s (%s): %s differs at byte %d (%d vs %d bytes)'
+                      % (name, flags, n.decode(), offset, size_a, size_b))
+            if diffs:
+                failed = True
+            else:
+                print('PASS    %s (%s): %d bytes' % (
+                    name, flags, sum(len(s[1]) for s in a)))
+    if not args.work_dir:
+        shutil.rmtree(work_dir)
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#!/usr/bin/env python
+"""Generate a synthetic corpus of CCR objects of a controllable shape.
+
+Every object is compiled from a generated C source of --functions functions,
+each of about --bbls basic blocks, --calls calls into functions of other
+objects (relocated .text fixups), --jump-tables switches (jump tables) spread
+over the object and a table of --data-pointers function pointers (d2c
+fixups). The section pattern is one .text per object (single), a section per
+function (function), or every other object of each (mixed). A main.o that
+refers to every object keeps them all in a link.
+
+  gen_ccr_corpus.py --cc build/bin/clang --objects 10000 --out-dir corpus
+
+The same --seed generates the same sources; a manifest.json in --out-dir
+lists the objects (main.o last) and the shape they have been generated with.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import random
+import subprocess
+import sys
+from multiprocessing import cpu_count
+from multiprocessing.pool import ThreadPool
+
+SECTION_PATTERNS = ('single', 'function', 'mixed')
+
+# The metadata of the linker flow: packed columns in relocatable chunks
+DEFAULT_CFLAGS = ['-O2', '-fccr-metadata', '-mllvm', '-ccr-rand-format=3']
+
+
+def function_name(obj, func):
+    return 'ccr_f%d_%d' % (obj, func)
+
+
+def gen_function(rng, obj, func, shape, callees):
+    """Return the C definition of a function and the callees it declares."""
+    lines = ['int %s(int x) {' % function_name(obj, func), '  int r = x;']
+    # An if/else is two BBLs, and its join the start of the next one
+    for b in range(max(shape['bbls'] // 2, 1)):
+        k = rng.randrange(1, 1 << 16)
+        lines.append('  if ((r & %d) == %d) r = r * 3 + %d; else r ^= %d;'
+                     % (1 << (b % 16), 1 << (b % 16), k, k + 1))
+    for callee in callees:
+        lines.append('  if (r & 1) r += %s(r);' % callee)
+    if func in shape['switches']:
+        lines.append('  switch (r & 15) {')
+        for case in range(16):
+            lines.append('  case %d: ccr_sink += %d; break;'
+                         % (case, rng.randrange(1 << 16)))
+        lines.append('  }')
+    lines.append('  return r + ccr_sink;')
+    lines.append('}')
+    return lines
+
+
+def gen_object(obj, args):
+    """Return the C source of the obj-th object."""
+    rng = random.Random('%d.%d' % (args.seed, obj))
+    switches = set(rng.sample(range(args.functions),
+                              min(args.jump_tables, args.functions)))
+    shape = {'bbls': args.bbls, 'switches': switches}
+    lines = ['/* Generated by gen_ccr_corpus.py; do not edit */',
+             'static volatile int ccr_sink;']
+    body, declared = [], set()
+    for func in range(args.functions):
+        callees = []
+        for _ in range(args.calls if args.objects > 1 else 0):
+            other = rng.randrange(args.objects - 1)
+            other += other >= obj
+            callees.append(function_name(other, rng.randrange(args.functions)))
+        declared.update(callees)
+        body.extend(gen_function(rng, obj, func, shape, callees))
+    lines.extend('int %s(int);' % name for name in sorted(declared))
+    lines.extend(body)
+    if args.data_pointers:
+        targets = [function_name(obj, rng.randrange(args.functions))
+                   for _ in range(args.data_pointers)]
+        lines.append('int (*const ccr_table%d[])(int) = {%s};'
+                     % (obj, ', '.join(targets)))
+    return '\n'.join(lines) + '\n'
+
+
+def gen_main(args):
+    lines = ['/* Generated by gen_ccr_corpus.py; do not edit */']
+    lines.extend('int %s(int);' % function_name(obj, 0)
+                 for obj in range(args.objects))
+    lines.append('int main(int argc, char **argv) {')
+    lines.append('  int r = argc;')
+    lines.extend('  r += %s(r);' % function_name(obj, 0)
+                 for obj in range(args.objects))
+    lines.append('  return r & 1;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def section_flags(pattern, obj):
+    if pattern == 'function' or (pattern == 'mixed' and obj % 2):
+        return ['-ffunction-sections', '-fdata-sections']
+    return []
+
+
+def generate(args):
+    """Write and compile the corpus into args.out_dir; return the manifest."""
+    src_dir = os.path.join(args.out_dir, 'src')
+    obj_dir = os.path.join(args.out_dir, 'obj')
+    for d in (src_dir, obj_dir):
+        if not os.path.isdir(d):
+            os.makedirs(d)
+    cflags = args.cflags.split() if args.cflags else DEFAULT_CFLAGS
+
+    tasks = []
+    for obj in range(args.objects + 1):
+        is_main = obj == args.objects
+        name = 'main' if is_main else 'obj%05d' % obj
+        src = os.path.join(src_dir, name + '.c')
+        with open(src, 'w') as f:
+            f.write(gen_main(args) if is_main else gen_object(obj, args))
+        out = os.path.join(obj_dir, name + '.o')
+        flags = [] if is_main else section_flags(args.sections, obj)
+        tasks.append([args.cc, '-c', src, '-o', out] + cflags + flags)
+
+    pool = ThreadPool(args.jobs)
+    try:
+        results = pool.map(subprocess.call, tasks)
+    finally:
+        pool.close()
+    for cmd, status in zip(tasks, results):
+        if status != 0:
+            sys.exit('error: %s failed' % ' '.join(cmd))
+
+    manifest = {
+        'version': 1,
+        'shape': {
+            'objects': args.objects, 'functions': args.functions,
+            'bbls': args.bbls, 'calls': args.calls,
+            'jump_tables': args.jump_tables,
+            'data_pointers': args.data_pointers,
+            'sections': args.sections, 'seed': args.seed,
+            'cflags': cflags,
+        },
+        'objects': [cmd[4] for cmd in tasks],
+    }
+    with open(os.path.join(args.out_dir, 'manifest.json'), 'w') as f:
+        json.dump(manifest, f, indent=2)
+    return manifest
+
+
+def add_shape_arguments(parser):
+    """The shape of the corpus (shared with benchmarks/ccr-link)."""
+    parser.add_argument('--objects', type=int, default=1000,
+                        help='objects (besides main.o)')
+    parser.add_argument('--functions', type=int, default=20,
+                        help='functions per object')
+    parser.add_argument('--bbls', type=int, default=8,
+                        help='basic blocks per function (about)')
+    parser.add_argument('--calls', type=int, default=2,
+                        help='calls into other objects per function')
+    parser.add_argument('--jump-tables', type=int, default=1,
+                        help='functions with a jump table per object')
+    parser.add_argument('--data-pointers', type=int, default=4,
+                        help='function pointers in the data of every object')
+    parser.add_argument('--sections', choices=SECTION_PATTERNS,
+                        default='mixed', help='the section pattern')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--cflags',
+                        help='the flags of every compilation (default: %s)'
+                        % ' '.join(DEFAULT_CFLAGS))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--cc', required=True, help='the CCR clang')
+    parser.add_argument('--jobs', type=int, default=cpu_count(),
+                        help='parallel compilations')
+    parser.add_argument('--out-dir', required=True,
+                        help='where the sources and the objects go')
+    add_shape_arguments(parser)
+    args = parser.parse_args()
+    if args.objects < 1 or args.functions < 1:
+        sys.exit('error: at least one object of one function is needed')
+
+    manifest = generate(args)
+    print('%d objects in %s' % (len(manifest['objects']), args.out_dir))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,372 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// https://developers.google.com/protocol-buffers/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Koo: Encode/decode benchmark of the CCR reordering information (the
+// ShuffleInfo.ReorderInfo messages of the .rand sections). It generates
+// messages of a given number of BBLs, with the fixups and the jump tables a
+// compiled object typically has, in the v1 submessages and in the v2 packed
+// columns, and times
+//
+//   - serialize:   SerializeToArray() (sizes included) into a reused buffer,
+//   - parse-heap:  parsing into a new heap-allocated message, destroyed after,
+//   - parse-arena: parsing into a message on a fresh google::protobuf::Arena
+//                  (as the assembler builds it), thrown away with the arena.
+//
+// Every line reports the wire size and the throughput per MB and per record
+// (a BBL or a fixup). shuffle-info-benchmark links the lite runtime that the
+// toolchain ships; shuffle-info-benchmark-full is the same benchmark over the
+// full runtime (see Makefile.am).
+//
+// Usage: shuffle-info-benchmark [--min-time=<seconds>] [<bbls>...]
+// (default: 1000 100000 1000000 10000000 BBLs; 10M BBLs takes a few GB)
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/stubs/common.h>
+#include "shuffleInfo.pb.h"
+
+using google::protobuf::Arena;
+using google::protobuf::io::CodedInputStream;
+using ShuffleInfo::ReorderInfo;
+
+namespace {
+
+#ifdef SHUFFLE_INFO_FULL_RUNTIME
+const char kRuntime[] = "full";
+#else
+const char kRuntime[] = "lite";
+#endif
+
+// The BBLs and the .text fixups of a synthetic object
+struct Fixup {
+  uint32_t offset;
+  uint32_t deref_sz;
+  bool is_rela;
+  uint32_t num_jt_entries;  // 0 unless a jump table
+  bool relaxable;           // A short branch
+};
+
+struct BasicBlock {
+  uint32_t size;
+  uint32_t type;  // 0 = MBB, 1 = end of a function, 2 = end of the object
+  bool fallthrough;
+  uint32_t num_fixups;
+  uint32_t padding;
+  uint32_t align_log2;
+  uint32_t hotness;
+  bool loop_header;
+};
+
+struct Object {
+  std::vector<BasicBlock> bbls;
+  std::vector<Fixup> fixups;
+};
+
+// Functions of about 8 BBLs, BBLs of about 20 bytes with 1.5 fixups, one in
+// five fixups a short branch and one jump table in 200 fixups
+Object Generate(size_t num_bbls) {
+  std::mt19937_64 rng(num_bbls);
+  std::uniform_int_distribution<uint32_t> percent(0, 99);
+  std::geometric_distribution<uint32_t> bbl_size(1.0 / 20);
+  std::poisson_distribution<uint32_t> num_fixups(1.5);
+
+  Object obj;
+  obj.bbls.resize(num_bbls);
+  uint32_t offset = 0;
+  for (size_t i = 0; i < num_bbls; i++) {
+    BasicBlock& bbl = obj.bbls[i];
+    bbl.size = 1 + bbl_size(rng);
+    bbl.type = i + 1 == num_bbls ? 2 : (percent(rng) < 12 ? 1 : 0);
+    bbl.fallthrough = bbl.type == 0 && percent(rng) < 60;
+    bbl.padding = bbl.type == 1 ? percent(rng) % 16 : 0;
+    bbl.size += bbl.padding;
+    bbl.align_log2 = bbl.type == 1 ? 4 : 0;
+    bbl.hotness = percent(rng) < 30 ? 1 + percent(rng) % 2 : 0;
+    bbl.loop_header = percent(rng) < 5;
+    bbl.num_fixups = 0;
+
+    uint32_t n = num_fixups(rng);
+    uint32_t at = offset;
+    for (uint32_t j = 0; j < n; j++) {
+      Fixup f;
+      f.relaxable = percent(rng) < 20;
+      f.deref_sz = f.relaxable ? 1 : 4;
+      if (at + f.deref_sz > offset + bbl.size - bbl.padding) break;
+      f.offset = at;
+      f.is_rela = f.relaxable || percent(rng) < 70;
+      f.num_jt_entries = percent(rng) < 1 && percent(rng) < 50
+                             ? 2 + percent(rng) % 30 : 0;
+      obj.fixups.push_back(f);
+      bbl.num_fixups++;
+      at += f.deref_sz + 1;
+    }
+    offset += bbl.size;
+  }
+  return obj;
+}
+
+void FillV1(const Object& obj, ReorderInfo* info) {
+  ReorderInfo::BinaryInfo* bin = info->mutable_bin();
+  bin->set_rand_obj_offset(0);
+  bin->set_main_addr_offset(0);
+  bin->set_obj_sz(0);
+  bin->set_src_type(0);
+  info->add_section_names(".text");
+
+  uint32_t obj_sz = 0;
+  info->mutable_layout()->Reserve(obj.bbls.size());
+  for (const BasicBlock& bbl : obj.bbls) {
+    ReorderInfo::LayoutInfo* layout = info->add_layout();
+    layout->set_bb_size(bbl.size);
+    layout->set_type(bbl.type);
+    layout->set_num_fixups(bbl.num_fixups);
+    layout->set_bb_fallthrough(bbl.fallthrough);
+    layout->set_section_idx(0);
+    if (bbl.hotness) layout->set_hotness(bbl.hotness);
+    if (bbl.padding) layout->set_padding_sz(bbl.padding);
+    if (bbl.align_log2) layout->set_align_log2(bbl.align_log2);
+    if (bbl.loop_header) layout->set_loop_header(true);
+    obj_sz += bbl.size;
+  }
+  bin->set_obj_sz(obj_sz);
+
+  ReorderInfo::FixupInfo* fixups = info->add_fixup();
+  fixups->mutable_text()->Reserve(obj.fixups.size());
+  for (const Fixup& f : obj.fixups) {
+    ReorderInfo::FixupInfo::FixupTuple* tuple = fixups->add_text();
+    tuple->set_offset(f.offset);
+    tuple->set_deref_sz(f.deref_sz);
+    tuple->set_is_rela(f.is_rela);
+    tuple->set_section_idx(0);
+    tuple->set_target(1);
+    if (f.num_jt_entries) {
+      tuple->set_num_jt_entries(f.num_jt_entries);
+      tuple->set_jt_entry_sz(4);
+    }
+    if (f.relaxable) {
+      tuple->set_relax_short_sz(2);
+      tuple->set_relax_long_form("\xe9\0\0\0\0", 5);
+      tuple->set_relax_fixup_offset(1);
+    }
+  }
+}
+
+// Packs the bits-wide values of get(i), i < n, into 64-bit words
+template <typename Fn>
+void PackBits(size_t n, int bits,
+              google::protobuf::RepeatedField<uint64_t>* out, Fn get) {
+  out->Reserve((n * bits + 63) / 64);
+  uint64_t word = 0;
+  int used = 0;
+  for (size_t i = 0; i < n; i++) {
+    word |= static_cast<uint64_t>(get(i)) << used;
+    used += bits;
+    if (used == 64) {
+      out->Add(word);
+      word = 0;
+      used = 0;
+    }
+  }
+  if (used) out->Add(word);
+}
+
+void FillV2(const Object& obj, ReorderInfo* info) {
+  ReorderInfo::BinaryInfo* bin = info->mutable_bin();
+  bin->set_rand_obj_offset(0);
+  bin->set_main_addr_offset(0);
+  bin->set_src_type(0);
+  bin->set_format_version(2);
+  info->add_section_names(".text");
+
+  const std::vector<BasicBlock>& bbls = obj.bbls;
+  const size_t n = bbls.size();
+  ReorderInfo::LayoutColumns* layout = info->mutable_layout_columns();
+  layout->mutable_bb_size()->Reserve(n);
+  layout->mutable_num_fixups()->Reserve(n);
+  layout->mutable_section_idx()->Reserve(n);
+  layout->mutable_padding_sz()->Reserve(n);
+  uint32_t obj_sz = 0;
+  for (const BasicBlock& bbl : bbls) {
+    layout->add_bb_size(bbl.size);
+    layout->add_num_fixups(bbl.num_fixups);
+    layout->add_section_idx(0);
+    layout->add_padding_sz(bbl.padding);
+    obj_sz += bbl.size;
+  }
+  bin->set_obj_sz(obj_sz);
+  PackBits(n, 2, layout->mutable_type_bits(),
+           [&](size_t i) { return bbls[i].type; });
+  PackBits(n, 1, layout->mutable_fallthrough_bits(),
+           [&](size_t i) { return bbls[i].fallthrough; });
+  PackBits(n, 2, layout->mutable_hotness_bits(),
+           [&](size_t i) { return bbls[i].hotness; });
+  PackBits(n, 4, layout->mutable_align_bits(),
+           [&](size_t i) { return bbls[i].align_log2; });
+  PackBits(n, 1, layout->mutable_loop_header_bits(),
+           [&](size_t i) { return bbls[i].loop_header; });
+
+  const std::vector<Fixup>& fixups = obj.fixups;
+  const size_t m = fixups.size();
+  ReorderInfo::FixupColumns* text = info->mutable_text_fixup_columns();
+  text->mutable_offset_delta()->Reserve(m);
+  text->mutable_deref_sz()->Reserve(m);
+  text->mutable_section_idx()->Reserve(m);
+  uint32_t prev = 0;
+  for (size_t i = 0; i < m; i++) {
+    const Fixup& f = fixups[i];
+    text->add_offset_delta(static_cast<int64_t>(f.offset) - prev);
+    prev = f.offset;
+    text->add_deref_sz(f.deref_sz);
+    text->add_section_idx(0);
+    if (f.num_jt_entries) {
+      text->add_jt_fixup_idx(i);
+      text->add_num_jt_entries(f.num_jt_entries);
+      text->add_jt_entry_sz(4);
+    }
+    if (f.relaxable) {
+      text->add_relax_fixup_idx(i);
+      text->add_relax_short_sz(2);
+      text->add_relax_long_form("\xe9\0\0\0\0", 5);
+      text->add_relax_fixup_offset(1);
+    }
+  }
+  PackBits(m, 1, text->mutable_is_rela_bits(),
+           [&](size_t i) { return fixups[i].is_rela; });
+  PackBits(m, 1, text->mutable_new_section_bits(), [](size_t) { return 0; });
+  PackBits(m, 2, text->mutable_target_bits(), [](size_t) { return 1; });
+}
+
+double min_time = 1.0;
+
+// The fastest of the runs of fn, repeated for min_time seconds (at least 3)
+template <typename Fn>
+double Time(Fn fn) {
+  typedef std::chrono::steady_clock Clock;
+  double best = 1e30, total = 0;
+  for (int runs = 0; runs < 3 || total < min_time; runs++) {
+    Clock::time_point start = Clock::now();
+    fn();
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    if (seconds < best) best = seconds;
+    total += seconds;
+  }
+  return best;
+}
+
+bool Parse(const std::string& wire, ReorderInfo* info) {
+  // As the linker and the randomizer read .rand: past the 64MB default
+  CodedInputStream input(reinterpret_cast<const uint8_t*>(wire.data()),
+                         wire.size());
+  input.SetTotalBytesLimit(INT_MAX, -1);
+  return info->ParseFromCodedStream(&input) && input.ConsumedEntireMessage();
+}
+
+void Report(const char* encoding, const Object& obj, size_t wire_size,
+            const char* op, double seconds) {
+  size_t records = obj.bbls.size() + obj.fixups.size();
+  double mb = wire_size / (1024.0 * 1024.0);
+  printf("%-4s %-2s %9zu %9zu %9.2f  %-11s %10.3f %9.1f %8.1f\n",
+         kRuntime, encoding, obj.bbls.size(), obj.fixups.size(), mb, op,
+         seconds * 1e3, mb / seconds, seconds * 1e9 / records);
+  fflush(stdout);
+}
+
+void Run(const char* encoding, const Object& obj,
+         void (*fill)(const Object&, ReorderInfo*)) {
+  std::string wire;
+  {
+    ReorderInfo info;
+    fill(obj, &info);
+    wire.resize(info.ByteSizeLong());
+    double seconds = Time([&] {
+      if (!info.SerializeToArray(&wire[0], wire.size())) abort();
+    });
+    Report(encoding, obj, wire.size(), "serialize", seconds);
+  }
+
+  double seconds = Time([&] {
+    std::unique_ptr<ReorderInfo> info(new ReorderInfo);
+    if (!Parse(wire, info.get())) abort();
+  });
+  Report(encoding, obj, wire.size(), "parse-heap", seconds);
+
+  seconds = Time([&] {
+    Arena arena;
+    if (!Parse(wire, Arena::CreateMessage<ReorderInfo>(&arena))) abort();
+  });
+  Report(encoding, obj, wire.size(), "parse-arena", seconds);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+  std::vector<size_t> sizes;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--min-time=", 11) == 0) {
+      min_time = atof(argv[i] + 11);
+      continue;
+    }
+    char* end;
+    unsigned long long n = strtoull(argv[i], &end, 10);
+    if (*end || n == 0) {
+      fprintf(stderr, "usage: %s [--min-time=<seconds>] [<bbls>...]\n",
+              argv[0]);
+      return 1;
+    }
+    sizes.push_back(n);
+  }
+  if (sizes.empty()) sizes = {1000, 100000, 1000000, 10000000};
+
+  printf("%-4s %-2s %9s %9s %9s  %-11s %10s %9s %8s\n", "rt", "v", "bbls",
+         "fixups", "wire_MB", "op", "ms", "MB/s", "ns/rec");
+  for (size_t n : sizes) {
+    Object obj = Generate(n);
+    Run("v1", obj, FillV1);
+    Run("v2", obj, FillV2);
+  }
+
+  google::protobuf::ShutdownProtobufLibrary();
+  return 0;
+}
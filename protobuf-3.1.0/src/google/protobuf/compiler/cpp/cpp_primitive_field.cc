@@ -79,6 +79,13 @@ int FixedSize(FieldDescriptor::Type type) {
   return -1;
 }
 
+// Packed uint32 fields are sized, written and read in bulk (see
+// CodedOutputStream::WriteVarint32Array()).
+bool IsPackedUInt32(const FieldDescriptor* descriptor) {
+  return descriptor->is_packed() &&
+         descriptor->type() == FieldDescriptor::TYPE_UINT32;
+}
+
 void SetPrimitiveVariables(const FieldDescriptor* descriptor,
                            std::map<string, string>* variables,
                            const Options& options) {
@@ -384,6 +391,11 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) const {
       "  output->WriteVarint32(_$name$_cached_byte_size_);\n"
       "}\n");
   }
+  if (IsPackedUInt32(descriptor_)) {
+    printer->Print(variables_,
+      "output->WriteVarint32Array(this->$name$().data(), this->$name$_size());\n");
+    return;
+  }
   printer->Print(variables_,
       "for (int i = 0; i < this->$name$_size(); i++) {\n");
   if (descriptor_->is_packed()) {
@@ -412,6 +424,12 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
       "    _$name$_cached_byte_size_, target);\n"
       "}\n");
   }
+  if (IsPackedUInt32(descriptor_)) {
+    printer->Print(variables_,
+      "target = ::google::protobuf::io::CodedOutputStream::\n"
+      "  WriteVarint32ArrayToArray(this->$name$().data(), this->$name$_size(), target);\n");
+    return;
+  }
   printer->Print(variables_,
       "for (int i = 0; i < this->$name$_size(); i++) {\n");
   if (descriptor_->is_packed()) {
@@ -434,7 +452,11 @@ GenerateByteSize(io::Printer* printer) const {
     "  unsigned int count = this->$name$_size();\n");
   printer->Indent();
   int fixed_size = FixedSize(descriptor_->type());
-  if (fixed_size == -1) {
+  if (IsPackedUInt32(descriptor_)) {
+    printer->Print(variables_,
+      "data_size = ::google::protobuf::io::CodedOutputStream::\n"
+      "  VarintSize32Array(this->$name$().data(), count);\n");
+  } else if (fixed_size == -1) {
     printer->Print(variables_,
       "for (unsigned int i = 0; i < count; i++) {\n"
       "  data_size += ::google::protobuf::internal::WireFormatLite::\n"
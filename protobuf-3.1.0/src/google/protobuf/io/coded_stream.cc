@@ -48,6 +48,10 @@
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/stl_util.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 
 namespace google {
 namespace protobuf {
@@ -451,6 +455,53 @@ int64 CodedInputStream::ReadVarint32Fallback(uint32 first_byte_or_zero) {
   }
 }
 
+int CodedInputStream::ReadPackedVarint32(uint32* values, int max_count) {
+  const uint8* ptr = buffer_;
+  int count = 0;
+  while (count < max_count && ptr < buffer_end_) {
+#ifdef __SSE2__
+    // Fast path:  Sixteen buffered bytes and room for sixteen values.  All
+    // the bytes before the first one with a continuation bit are values of
+    // their own; they are zero-extended at once (the stores past them are
+    // overwritten later or left beyond the returned count).
+    if (buffer_end_ - ptr >= 16 && max_count - count >= 16) {
+      const __m128i bytes =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+      const int continued = _mm_movemask_epi8(bytes);
+      const int run = continued ? __builtin_ctz(continued) : 16;
+      if (run > 0) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        __m128i* out = reinterpret_cast<__m128i*>(values + count);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+        ptr += run;
+        count += run;
+        continue;
+      }
+    }
+#endif
+    if (*ptr < 0x80) {
+      values[count++] = *ptr++;
+      continue;
+    }
+    // A multi-byte varint is only read here if it cannot cross the end of
+    // the buffer; otherwise (or if it is malformed) the caller falls back
+    // to ReadVarint32().
+    if (buffer_end_ - ptr < kMaxVarintBytes) break;
+    ::std::pair<bool, const uint8*> p =
+        ReadVarint32FromArray(*ptr, ptr, &values[count]);
+    if (!p.first) break;
+    ptr = p.second;
+    ++count;
+  }
+  buffer_ = ptr;
+  return count;
+}
+
 int CodedInputStream::ReadVarintSizeAsIntSlow() {
   // Directly invoke ReadVarint64Fallback, since we already tried to optimize
   // for one-byte varints.
@@ -794,6 +845,49 @@ void CodedOutputStream::WriteVarint32SlowPath(uint32 value) {
   WriteRaw(bytes, size);
 }
 
+void CodedOutputStream::WriteVarint32Array(const uint32* values, int count) {
+  while (count > 0) {
+    // Encode as many values as the buffer is guaranteed to hold
+    int n = std::min(count, buffer_size_ / kMaxVarint32Bytes);
+    if (n == 0) {
+      WriteVarint32(*values++);
+      --count;
+      continue;
+    }
+    uint8* end = WriteVarint32ArrayToArray(values, n, buffer_);
+    Advance(static_cast<int>(end - buffer_));
+    values += n;
+    count -= n;
+  }
+}
+
+uint8* CodedOutputStream::WriteVarint32ArrayToArray(const uint32* values,
+                                                    int count,
+                                                    uint8* target) {
+#ifdef __SSE2__
+  // Every four values below 0x80 are narrowed to one byte each at once
+  const __m128i high_bits = _mm_set1_epi32(~0x7F);
+  const __m128i zero = _mm_setzero_si128();
+  for (; count >= 4; values += 4, count -= 4) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, high_bits),
+                                          zero)) != 0xFFFF) {
+      for (int i = 0; i < 4; i++)
+        target = WriteVarint32ToArray(values[i], target);
+      continue;
+    }
+    const __m128i words = _mm_packs_epi32(v, v);
+    const int32 bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    memcpy(target, &bytes, 4);
+    target += 4;
+  }
+#endif
+  for (int i = 0; i < count; i++)
+    target = WriteVarint32ToArray(values[i], target);
+  return target;
+}
+
 void CodedOutputStream::WriteVarint64SlowPath(uint64 value) {
   uint8 bytes[kMaxVarintBytes];
   uint8* target = &bytes[0];
@@ -826,6 +920,40 @@ size_t CodedOutputStream::VarintSize32Fallback(uint32 value) {
   return static_cast<size_t>((log2value * 9 + 73) / 64);
 }
 
+size_t CodedOutputStream::VarintSize32Array(const uint32* values,
+                                            int count) {
+  size_t size = 0;
+#ifdef __SSE2__
+  // One byte per value, plus one per threshold (2^7, 2^14, 2^21, 2^28) it
+  // reaches; the unsigned comparisons are done as signed ones, biased
+  const __m128i bias = _mm_set1_epi32(static_cast<int32>(0x80000000u));
+  const __m128i t1 = _mm_set1_epi32(static_cast<int32>(0x80000000u + 0x7F));
+  const __m128i t2 = _mm_set1_epi32(static_cast<int32>(0x80000000u + 0x3FFF));
+  const __m128i t3 = _mm_set1_epi32(static_cast<int32>(0x80000000u + 0x1FFFFF));
+  const __m128i t4 = _mm_set1_epi32(static_cast<int32>(0x80000000u + 0xFFFFFFF));
+  __m128i extra = _mm_setzero_si128();
+  int vectorized = count & ~3;
+  for (int i = 0; i < vectorized; i += 4) {
+    const __m128i v = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), bias);
+    // Each comparison yields -1 per lane at or above the threshold
+    extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(v, t1));
+    extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(v, t2));
+    extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(v, t3));
+    extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(v, t4));
+  }
+  uint32 lanes[4];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), extra);
+  size = static_cast<size_t>(vectorized) + lanes[0] + lanes[1] + lanes[2] +
+         lanes[3];
+  values += vectorized;
+  count -= vectorized;
+#endif
+  for (int i = 0; i < count; i++)
+    size += VarintSize32(values[i]);
+  return size;
+}
+
 size_t CodedOutputStream::VarintSize64(uint64 value) {
   // This computes value == 0 ? 1 : floor(log2(value)) / 7 + 1
   // Use an explicit multiplication to implement the divide of
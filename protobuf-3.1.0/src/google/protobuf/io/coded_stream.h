@@ -238,6 +238,14 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Read an unsigned integer with Varint encoding.
   bool ReadVarint64(uint64* value);
 
+  // Decode consecutive varints (the payload of a packed uint32 field) from
+  // the current buffer into values[0, max_count), stopping at the end of the
+  // buffer or the current limit.  Returns the number of values read, which
+  // may be short of both if a varint crosses the buffer end or is malformed;
+  // ReadVarint32() reads (or rejects) that one.  Runs of one-byte varints are
+  // decoded sixteen at a time where SSE2 is available.
+  int ReadPackedVarint32(uint32* values, int max_count);
+
   // Reads a varint off the wire into an "int". This should be used for reading
   // sizes off the wire (sizes of strings, submessages, bytes fields, etc).
   //
@@ -778,6 +786,13 @@ class LIBPROTOBUF_EXPORT CodedOutputStream {
   void WriteVarint32(uint32 value);
   // Like WriteVarint32()  but writing directly to the target array.
   static uint8* WriteVarint32ToArray(uint32 value, uint8* target);
+  // Write values[0, count) as consecutive varints, i.e., the payload of a
+  // packed uint32 field.
+  void WriteVarint32Array(const uint32* values, int count);
+  // Like WriteVarint32Array()  but writing directly to the target array,
+  // which must hold VarintSize32Array(values, count) bytes.
+  static uint8* WriteVarint32ArrayToArray(const uint32* values, int count,
+                                          uint8* target);
   // Write an unsigned integer with Varint encoding.
   void WriteVarint64(uint64 value);
   // Like WriteVarint64()  but writing directly to the target array.
@@ -801,6 +816,8 @@ class LIBPROTOBUF_EXPORT CodedOutputStream {
 
   // Returns the number of bytes needed to encode the given value as a varint.
   static size_t VarintSize32(uint32 value);
+  // Returns the number of bytes needed to encode values[0, count) as varints.
+  static size_t VarintSize32Array(const uint32* values, int count);
   // Returns the number of bytes needed to encode the given value as a varint.
   static size_t VarintSize64(uint64 value);
 
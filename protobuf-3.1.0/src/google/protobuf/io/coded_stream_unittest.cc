@@ -547,6 +547,81 @@ TEST_F(CodedStreamTest, VarintSize64PowersOfTwo) {
   }
 }
 
+// -------------------------------------------------------------------
+// Packed varint32 arrays
+
+// Runs of one-byte values longer than a vector, broken up by values of every
+// size, so that both the bulk and the per-value paths are taken.
+static std::vector<uint32> MakePackedVarint32Values() {
+  std::vector<uint32> values;
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < i % 37; j++)
+      values.push_back((i * 31 + j) & 0x7F);
+    values.push_back(0x1u << (i % 32));
+    values.push_back(~0u >> (i % 32));
+  }
+  return values;
+}
+
+TEST_1D(CodedStreamTest, WriteVarint32Array, kBlockSizes) {
+  std::vector<uint32> values = MakePackedVarint32Values();
+  std::vector<uint8> expected(values.size() * 5);
+  uint8* end = &expected[0];
+  for (int i = 0; i < values.size(); i++)
+    end = CodedOutputStream::WriteVarint32ToArray(values[i], end);
+  const int size = end - &expected[0];
+
+  EXPECT_EQ(size, CodedOutputStream::VarintSize32Array(&values[0],
+                                                       values.size()));
+  EXPECT_EQ(buffer_ + size, CodedOutputStream::WriteVarint32ArrayToArray(
+                                &values[0], values.size(), buffer_));
+  EXPECT_EQ(0, memcmp(buffer_, &expected[0], size));
+
+  memset(buffer_, 0, size);
+  ArrayOutputStream output(buffer_, sizeof(buffer_), kBlockSizes_case);
+  {
+    CodedOutputStream coded_output(&output);
+    coded_output.WriteVarint32Array(&values[0], values.size());
+    EXPECT_FALSE(coded_output.HadError());
+    EXPECT_EQ(size, coded_output.ByteCount());
+  }
+  EXPECT_EQ(0, memcmp(buffer_, &expected[0], size));
+}
+
+TEST_1D(CodedStreamTest, ReadPackedVarint32, kBlockSizes) {
+  std::vector<uint32> values = MakePackedVarint32Values();
+  const int size = CodedOutputStream::WriteVarint32ArrayToArray(
+                       &values[0], values.size(), buffer_) - buffer_;
+
+  ArrayInputStream input(buffer_, size, kBlockSizes_case);
+  CodedInputStream coded_input(&input);
+  std::vector<uint32> read(values.size());
+  int count = 0;
+  while (count < read.size()) {
+    count += coded_input.ReadPackedVarint32(&read[count],
+                                            read.size() - count);
+    if (count < read.size()) {
+      ASSERT_TRUE(coded_input.ReadVarint32(&read[count]));
+      count++;
+    }
+  }
+  EXPECT_EQ(size, coded_input.CurrentPosition());
+  EXPECT_TRUE(values == read);
+}
+
+TEST_F(CodedStreamTest, ReadPackedVarint32StopsAtMalformed) {
+  // Twenty one-byte values, then an 11-byte varint
+  memset(buffer_, 0x01, 20);
+  memset(buffer_ + 20, 0xFF, 10);
+  buffer_[30] = 0x01;
+  ArrayInputStream input(buffer_, 31);
+  CodedInputStream coded_input(&input);
+  uint32 values[32];
+  EXPECT_EQ(20, coded_input.ReadPackedVarint32(values, 32));
+  EXPECT_EQ(20, coded_input.CurrentPosition());
+  EXPECT_FALSE(coded_input.ReadVarint32(&values[20]));
+}
+
 // -------------------------------------------------------------------
 // Fixed-size int tests
 
@@ -423,6 +423,40 @@ READ_REPEATED_PACKED_FIXED_SIZE_PRIMITIVE(double, TYPE_DOUBLE)
 
 #undef READ_REPEATED_PACKED_FIXED_SIZE_PRIMITIVE
 
+// Specialization of ReadPackedPrimitive for uint32, which decodes the buffered
+// part of the field in bulk.  Every value takes at least one byte, thus the
+// reservation is bounded by the bytes at hand, never by the declared length.
+template <>
+inline bool WireFormatLite::ReadPackedPrimitive<
+  uint32, WireFormatLite::TYPE_UINT32>(
+    io::CodedInputStream* input,
+    RepeatedField<uint32>* values) {
+  int length;
+  if (!input->ReadVarintSizeAsInt(&length)) return false;
+  io::CodedInputStream::Limit limit = input->PushLimit(length);
+  while (input->BytesUntilLimit() > 0) {
+    const void* data;
+    int buffered;
+    input->GetDirectBufferPointerInline(&data, &buffered);
+    if (buffered > 0) {
+      const int old_entries = values->size();
+      values->Reserve(old_entries + buffered);
+      values->Resize(old_entries + buffered, 0);
+      const int read = input->ReadPackedVarint32(
+          values->mutable_data() + old_entries, buffered);
+      values->Truncate(old_entries + read);
+    }
+    // A varint across the end of the buffer (or a malformed one)
+    if (input->BytesUntilLimit() > 0) {
+      uint32 value;
+      if (!input->ReadVarint32(&value)) return false;
+      values->Add(value);
+    }
+  }
+  input->PopLimit(limit);
+  return true;
+}
+
 template <typename CType, enum WireFormatLite::FieldType DeclaredType>
 bool WireFormatLite::ReadPackedPrimitiveNoInline(io::CodedInputStream* input,
                                                  RepeatedField<CType>* values) {
@@ -0,0 +1,70 @@
+// Koo: See shuffleInfoReader.h
+
+#include "shuffleInfoReader.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <climits>
+
+using ::google::protobuf::Arena;
+using ::google::protobuf::StringPiece;
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::internal::WireFormatLite;
+
+namespace ShuffleInfo {
+
+// The metadata of a large binary easily exceeds the default 64MB limit
+static void initStream(CodedInputStream *Input) {
+  Input->SetTotalBytesLimit(INT_MAX, -1);
+}
+
+ReorderInfo *ParseReorderInfo(const void *Data, size_t Size, Arena *Arena) {
+  if (Size > INT_MAX)
+    return NULL;
+  CodedInputStream Input(static_cast<const ::google::protobuf::uint8 *>(Data),
+                         static_cast<int>(Size));
+  initStream(&Input);
+  ReorderInfo *RI = Arena::CreateMessage<ReorderInfo>(Arena);
+  if (!RI->MergePartialFromCodedStream(&Input) || !Input.ConsumedEntireMessage())
+    return NULL;
+  return RI;
+}
+
+bool ReadSectionNames(const void *Data, size_t Size,
+                      std::vector<StringPiece> *Names) {
+  if (Size > INT_MAX)
+    return false;
+  CodedInputStream Input(static_cast<const ::google::protobuf::uint8 *>(Data),
+                         static_cast<int>(Size));
+  initStream(&Input);
+  for (;;) {
+    ::google::protobuf::uint32 Tag = Input.ReadTag();
+    if (Tag == 0)
+      return Input.ConsumedEntireMessage();
+    if (WireFormatLite::GetTagFieldNumber(Tag) !=
+            ReorderInfo::kSectionNamesFieldNumber ||
+        WireFormatLite::GetTagWireType(Tag) !=
+            WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!WireFormatLite::SkipField(&Input, Tag))
+        return false;
+      continue;
+    }
+
+    ::google::protobuf::uint32 Length;
+    const void *Bytes;
+    int Available;
+    if (!Input.ReadVarint32(&Length))
+      return false;
+    if (Length == 0) {
+      Names->push_back(StringPiece());
+      continue;
+    }
+    if (!Input.GetDirectBufferPointer(&Bytes, &Available) ||
+        Length > static_cast< ::google::protobuf::uint32>(Available))
+      return false;
+    Names->push_back(StringPiece(static_cast<const char *>(Bytes), Length));
+    if (!Input.Skip(Length))
+      return false;
+  }
+}
+
+} // namespace ShuffleInfo
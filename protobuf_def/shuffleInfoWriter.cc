@@ -0,0 +1,164 @@
+// Koo: See shuffleInfoWriter.h
+
+#include "shuffleInfoWriter.h"
+#include "shuffleInfo.pb.h"
+
+namespace ShuffleInfo {
+
+ReorderInfo_FixupInfo_FixupTuple *AddFixupTuple(ReorderInfo_FixupInfo *FI,
+                                                unsigned List) {
+  switch (List) {
+  case FL_Text:             return FI->add_text();
+  case FL_Rodata:           return FI->add_rodata();
+  case FL_Data:             return FI->add_data();
+  case FL_DataRel:          return FI->add_datarel();
+  case FL_InitArray:        return FI->add_initarray();
+  case FL_FiniArray:        return FI->add_finiarray();
+  case FL_TData:            return FI->add_tdata();
+  case FL_XRay:             return FI->add_xray();
+  case FL_PatchableEntries: return FI->add_patchable();
+  case FL_JumpTable:        return FI->add_jumptable();
+  case FL_Custom:           return FI->add_custom();
+  default:                  return NULL;
+  }
+}
+
+ReorderInfo_FixupColumns *MutableFixupColumns(ReorderInfo *RI, unsigned List) {
+  switch (List) {
+  case FL_Text:             return RI->mutable_text_fixup_columns();
+  case FL_Rodata:           return RI->mutable_rodata_fixup_columns();
+  case FL_Data:             return RI->mutable_data_fixup_columns();
+  case FL_DataRel:          return RI->mutable_datarel_fixup_columns();
+  case FL_InitArray:        return RI->mutable_initarray_fixup_columns();
+  case FL_FiniArray:        return RI->mutable_finiarray_fixup_columns();
+  case FL_TData:            return RI->mutable_tdata_fixup_columns();
+  case FL_XRay:             return RI->mutable_xray_fixup_columns();
+  case FL_PatchableEntries: return RI->mutable_patchable_fixup_columns();
+  case FL_JumpTable:        return RI->mutable_jumptable_fixup_columns();
+  case FL_Custom:           return RI->mutable_custom_fixup_columns();
+  default:                  return NULL;
+  }
+}
+
+void SetFixupTuple(ReorderInfo_FixupInfo_FixupTuple *T, const FixupRecord &F,
+                   uint64_t Offset) {
+  T->set_offset(Offset);
+  T->set_deref_sz(F.DerefSize);
+  T->set_is_rela(F.IsRela);
+  // Let the linker know if there are multiple sections of the list; c2c, c2d,
+  // d2c and d2d are told by the target field below
+  T->set_type(F.IsNewSection ? 4 : 0);
+
+  if (F.TargetKind)
+    T->set_target(F.TargetKind);
+  if (F.ReachLog2 > 0)
+    T->set_reach_log2(F.ReachLog2);
+  if (F.RefClass)
+    T->set_ref_class(F.RefClass);
+  if (F.Scope)
+    T->set_scope(F.Scope);
+  if (F.PairDelta > 0)
+    T->set_pair_delta(F.PairDelta);
+  if (F.RelocIdx > 0)
+    T->set_reloc_idx(F.RelocIdx);
+  if (F.GOTRelax)
+    T->set_got_relax(F.GOTRelax);
+
+  // The jump table information is of the fixups in .text only, for the JT
+  // entry update (pic/pie)
+  if (F.NumJTEntries > 0) {
+    T->set_num_jt_entries(F.NumJTEntries);
+    T->set_jt_entry_sz(F.JTEntrySize);
+    if (F.JTFunctionRelative)
+      T->set_jt_func_rel(true);
+  }
+
+  if (F.RelaxShortSize > 0) {
+    T->set_relax_short_sz(F.RelaxShortSize);
+    T->set_relax_long_form(F.RelaxLongForm, F.RelaxLongSize);
+    T->set_relax_fixup_offset(F.RelaxFixupOffset);
+  }
+  if (F.ShrinkLongSize > 0) {
+    T->set_shrink_long_sz(F.ShrinkLongSize);
+    T->set_shrink_short_form(F.ShrinkShortForm, F.ShrinkShortSize);
+  }
+}
+
+FixupColumnsWriter::FixupColumnsWriter(ReorderInfo_FixupColumns *Columns,
+                                       size_t NumFixups, bool RelocIndices)
+    : Columns(Columns), PrevOffset(0), Idx(0), ScopeIdx(0), GOTRelaxIdx(0),
+      RelocIndices(RelocIndices), PrevRelocIdx(0) {
+  Columns->mutable_offset_delta()->Reserve(NumFixups);
+  Columns->mutable_deref_sz()->Reserve(NumFixups);
+  Columns->mutable_section_idx()->Reserve(NumFixups);
+  if (RelocIndices)
+    Columns->mutable_reloc_delta()->Reserve(NumFixups);
+}
+
+void FixupColumnsWriter::Add(const FixupRecord &F) {
+  Columns->add_offset_delta((int64_t)F.Offset - PrevOffset);
+  Columns->add_deref_sz(F.DerefSize);
+  AppendBits(Columns->mutable_is_rela_bits(), Idx, F.IsRela, 1);
+  AppendBits(Columns->mutable_new_section_bits(), Idx, F.IsNewSection, 1);
+  AppendBits(Columns->mutable_target_bits(), Idx, F.TargetKind, 2);
+  AppendBits(Columns->mutable_ref_class_bits(), Idx, F.RefClass, 2);
+  // The scopes (.text only) are left out up to the last fixup that has one;
+  // the missing tail of the column reads as external
+  if (F.Scope) {
+    for (; ScopeIdx < Idx; ++ScopeIdx)
+      AppendBits(Columns->mutable_scope_bits(), ScopeIdx, 0, 2);
+    AppendBits(Columns->mutable_scope_bits(), ScopeIdx++, F.Scope, 2);
+  }
+  // So are the GOT relaxations, which only the GOTPCREL references have
+  if (F.GOTRelax) {
+    for (; GOTRelaxIdx < Idx; ++GOTRelaxIdx)
+      AppendBits(Columns->mutable_got_relax_bits(), GOTRelaxIdx, 0, 2);
+    AppendBits(Columns->mutable_got_relax_bits(), GOTRelaxIdx++, F.GOTRelax, 2);
+  }
+  Columns->add_section_idx(F.SectionIdx);
+
+  // The relocations of a section are numbered along its fixups, thus the
+  // deltas are mostly 1 (and 0 tells a resolved fixup)
+  if (RelocIndices) {
+    if (F.IsNewSection)
+      PrevRelocIdx = 0;
+    Columns->add_reloc_delta(F.RelocIdx ? F.RelocIdx - PrevRelocIdx : 0);
+    if (F.RelocIdx)
+      PrevRelocIdx = F.RelocIdx;
+  }
+
+  if (F.NumJTEntries > 0) {
+    AppendBits(Columns->mutable_jt_func_rel_bits(), Columns->jt_fixup_idx_size(),
+               F.JTFunctionRelative, 1);
+    Columns->add_jt_fixup_idx(Idx);
+    Columns->add_num_jt_entries(F.NumJTEntries);
+    Columns->add_jt_entry_sz(F.JTEntrySize);
+  }
+
+  if (F.ReachLog2 > 0) {
+    Columns->add_reach_fixup_idx(Idx);
+    Columns->add_reach_log2(F.ReachLog2);
+  }
+
+  if (F.PairDelta > 0) {
+    Columns->add_pair_fixup_idx(Idx);
+    Columns->add_pair_delta(F.PairDelta);
+  }
+
+  if (F.RelaxShortSize > 0) {
+    Columns->add_relax_fixup_idx(Idx);
+    Columns->add_relax_short_sz(F.RelaxShortSize);
+    Columns->add_relax_long_form(F.RelaxLongForm, F.RelaxLongSize);
+    Columns->add_relax_fixup_offset(F.RelaxFixupOffset);
+  }
+
+  if (F.ShrinkLongSize > 0) {
+    Columns->add_shrink_fixup_idx(Idx);
+    Columns->add_shrink_long_sz(F.ShrinkLongSize);
+    Columns->add_shrink_short_form(F.ShrinkShortForm, F.ShrinkShortSize);
+  }
+  PrevOffset = F.Offset;
+  Idx++;
+}
+
+} // namespace ShuffleInfo